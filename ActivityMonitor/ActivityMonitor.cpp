@@ -18,6 +18,7 @@
 **/
 
 #include "ActivityMonitor.h"
+#include "ThresholdTracker.h"
 
 #include "utils.h"
 
@@ -29,6 +30,7 @@
 
 #define ACTIVITY_MONITOR_EVT_ON_MEMORY_THRESHOLD "onMemoryThreshold"
 #define ACTIVITY_MONITOR_EVT_ON_CPU_THRESHOLD "onCPUThreshold"
+#define ACTIVITY_MONITOR_EVT_ON_ACTIVITY_SUMMARY "onActivitySummary"
 
 #define VERSION_TXT_FILE "/version.txt"
 
@@ -51,30 +53,23 @@ namespace WPEFramework
         {
             AppConfig()
             {
-                pid = memoryThresholdsMB = cpuThresholdPercent = cpuThresholdSeconds = 0;
-                state = STATE_NORMAL;
+                pid = memoryThresholdsMB = cpuThresholdPercent = cpuThresholdSeconds = memoryThresholdSeconds = 0;
+                hysteresisPercent = ThresholdPolicy().hysteresisPercent;
+                minEventIntervalSeconds = 0;
                 cpuUsage = 0;
-                memExceeded = cpuExceededPercent = 0;
-                eventSent = false;
             }
 
-            enum {
-                STATE_NORMAL,
-                STATE_EXCEEDED,
-                STATE_RECEDED,
-            };
-
             unsigned int pid;
             unsigned int memoryThresholdsMB;
             unsigned int cpuThresholdPercent;
             unsigned int cpuThresholdSeconds;
+            unsigned int memoryThresholdSeconds;
+            unsigned int hysteresisPercent;
+            unsigned int minEventIntervalSeconds;
 
-            int state;
             long long unsigned int cpuUsage;
-            std::chrono::system_clock::time_point cpuThreshold;
-            unsigned int memExceeded;
-            unsigned int cpuExceededPercent;
-            bool eventSent;
+            ThresholdTracker memory;
+            ThresholdTracker cpu;
         };
 
         struct MonitorParams
@@ -85,6 +80,8 @@ namespace WPEFramework
             long long unsigned int totalCpuUsage;
             std::chrono::system_clock::time_point lastMemCheck;
             std::chrono::system_clock::time_point lastCpuCheck;
+            double summaryIntervalSeconds;
+            std::chrono::system_clock::time_point lastSummary;
         };
 
         class MemoryInfo
@@ -222,6 +219,7 @@ namespace WPEFramework
 
             float memoryIntervalSeconds = 0;
             float cpuIntervalSeconds = 0;
+            float summaryIntervalSeconds = 0;
 
             try
             {
@@ -230,6 +228,15 @@ namespace WPEFramework
             }
             catch (...) {}
 
+            if (parameters.HasLabel("summaryIntervalSeconds"))
+            {
+                try
+                {
+                    summaryIntervalSeconds = std::stof(parameters["summaryIntervalSeconds"].String());
+                }
+                catch (...) {}
+            }
+
             if (0 == memoryIntervalSeconds && 0 == cpuIntervalSeconds)
             {
                 LOGWARN("Interval for both CPU and Memory usage monitoring can't be 0");
@@ -244,7 +251,9 @@ namespace WPEFramework
 
             m_monitorParams->lastMemCheck = std::chrono::system_clock::now();
             m_monitorParams->lastCpuCheck = std::chrono::system_clock::now();
+            m_monitorParams->lastSummary = std::chrono::system_clock::now();
 
+            m_monitorParams->summaryIntervalSeconds = summaryIntervalSeconds > 0 ? summaryIntervalSeconds : 0;
             m_monitorParams->memoryIntervalSeconds = memoryIntervalSeconds;
             m_monitorParams->cpuIntervalSeconds = cpuIntervalSeconds;
 
@@ -262,7 +271,31 @@ namespace WPEFramework
                     getNumberParameterObject(m, "memoryThresholdMB", conf.memoryThresholdsMB);
                     getNumberParameterObject(m, "cpuThresholdPercent", conf.cpuThresholdPercent);
                     getNumberParameterObject(m, "cpuThresholdSeconds", conf.cpuThresholdSeconds);
+                    if (m.HasLabel("memoryThresholdSeconds"))
+                        getNumberParameterObject(m, "memoryThresholdSeconds", conf.memoryThresholdSeconds);
+                    if (m.HasLabel("hysteresisPercent"))
+                        getNumberParameterObject(m, "hysteresisPercent", conf.hysteresisPercent);
+                    if (m.HasLabel("minEventIntervalSeconds"))
+                        getNumberParameterObject(m, "minEventIntervalSeconds", conf.minEventIntervalSeconds);
+
+                    // At 100 or more the usage could never recede
+                    if (conf.hysteresisPercent > 99)
+                    {
+                        LOGWARN("hysteresisPercent %u is out of range for %u, using 99", conf.hysteresisPercent, conf.pid);
+                        conf.hysteresisPercent = 99;
+                    }
+
+                    ThresholdPolicy policy;
+                    policy.hysteresisPercent = conf.hysteresisPercent;
+                    policy.minEventIntervalSeconds = conf.minEventIntervalSeconds;
 
+                    policy.threshold = conf.memoryThresholdsMB;
+                    policy.dwellSeconds = conf.memoryThresholdSeconds;
+                    conf.memory.setPolicy(policy);
+
+                    policy.threshold = conf.cpuThresholdPercent;
+                    policy.dwellSeconds = conf.cpuThresholdSeconds;
+                    conf.cpu.setPolicy(policy);
 
                     m_monitorParams->config.push_back(conf);
                 }
@@ -838,6 +871,11 @@ namespace WPEFramework
                 elapsed = std::chrono::system_clock::now() - m_monitorParams->lastCpuCheck;
                 bool cpuCheck = m_monitorParams->cpuIntervalSeconds > 0 && elapsed.count() > m_monitorParams->cpuIntervalSeconds  - 0.01;
 
+                elapsed = std::chrono::system_clock::now() - m_monitorParams->lastSummary;
+                bool summary = m_monitorParams->summaryIntervalSeconds > 0 && elapsed.count() > m_monitorParams->summaryIntervalSeconds - 0.01;
+
+                double now = std::chrono::duration<double>(std::chrono::steady_clock::now().time_since_epoch()).count();
+
                 std::vector<unsigned int> pids;
                 std::vector <std::string> cmds;
                 std::vector <unsigned int> memUsage;
@@ -873,37 +911,18 @@ namespace WPEFramework
                             LOGERR("Failed to determine memory usage for %u", pid);
                         }
 
-                        if (memoryUsed >= it->memoryThresholdsMB)
+                        ThresholdTracker::Event event = it->memory.sample(memoryUsed, now);
+                        if (ThresholdTracker::EVENT_NONE != event)
                         {
-                            if (0 == it->memExceeded)
-                            {
-                                it->memExceeded = memoryUsed;
+                            const char *threshold = ThresholdTracker::EVENT_EXCEEDED == event ? "exceeded" : "receded";
 
-                                JsonObject memResult;
-                                memResult["appPid"] = pid;
-                                memResult["threshold"] = "exceeded";
-                                memResult["memoryMB"] = memoryUsed;
-
-                                LOGWARN("MemoryThreshold event appPid = %u, threshold = exceeded, memoryMB = %u", pid, memoryUsed);
-                                onMemoryThresholdOccurred(memResult);
-                            }
-                        }
-                        else
-                        {
-                            if (0 != it->memExceeded && memoryUsed < it->memExceeded - it->memExceeded / 20)
-                            {
-                                it->memExceeded = 0;
-
-                                JsonObject memResult;
-                                memResult["appPid"] = pid;
-                                memResult["threshold"] = "receded";
-                                memResult["memoryMB"] = memoryUsed;
-
-                                LOGWARN("MemoryThreshold event appPid = %u, threshold = receded, memoryMB = %u", pid, memoryUsed);
-
-                                onMemoryThresholdOccurred(memResult);
-                            }
+                            JsonObject memResult;
+                            memResult["appPid"] = pid;
+                            memResult["threshold"] = threshold;
+                            memResult["memoryMB"] = memoryUsed;
 
+                            LOGWARN("MemoryThreshold event appPid = %u, threshold = %s, memoryMB = %u", pid, threshold, memoryUsed);
+                            onMemoryThresholdOccurred(memResult);
                         }
                     }
 
@@ -938,80 +957,21 @@ namespace WPEFramework
                                     percents = 100 * ( usage - it->cpuUsage) / (totalCpuUsage - m_monitorParams->totalCpuUsage);
                                 }
 
-                                if (percents >= it->cpuThresholdPercent)
-                                {
-                                    if (AppConfig::STATE_NORMAL == it->state)
-                                    {
-                                        it->state = AppConfig::STATE_EXCEEDED;
-                                        it->cpuThreshold = std::chrono::system_clock::now();
-                                        it->cpuExceededPercent =  percents;
-                                        it->eventSent = false;
-                                    }
-                                    else if (AppConfig::STATE_EXCEEDED == it->state)
-                                    {
-                                        std::chrono::duration<double> elapsed = std::chrono::system_clock::now() - it->cpuThreshold;
-
-                                        if (elapsed.count() >= it->cpuThresholdSeconds && !it->eventSent)
-                                        {
-                                            JsonObject cpuResult;
-                                            cpuResult["appPid"] = pid;
-                                            cpuResult["threshold"] = "exceeded";
-                                            cpuResult["cpuPercent"] = percents;
-
-                                            LOGWARN("CPUThreshold event appPid = %u, threshold = exceeded, cpuPercent = %u", pid, percents);
-
-                                            onCPUThresholdOccurred(cpuResult);
-
-                                            it->eventSent = true;
-                                        }
-                                    }
-                                    else if (AppConfig::STATE_RECEDED == it->state)
-                                    {
-                                        it->state = AppConfig::STATE_EXCEEDED;
-                                    }
-                                }
-                                else
+                                ThresholdTracker::Event event = it->cpu.sample(percents, now);
+                                if (ThresholdTracker::EVENT_NONE != event)
                                 {
-                                    if (AppConfig::STATE_EXCEEDED == it->state)
-                                    {
-
-                                        if (!it->eventSent)
-                                        {
-                                            it->state = AppConfig::STATE_NORMAL;
-                                        }
-                                        else if (percents < it->cpuExceededPercent - it->cpuExceededPercent / 20)
-                                        {
-                                            it->state = AppConfig::STATE_RECEDED;
-                                            it->cpuThreshold = std::chrono::system_clock::now();
-                                        }
-
-                                    }
-                                    else if (AppConfig::STATE_RECEDED == it->state)
-                                    {
-                                        if (percents < it->cpuExceededPercent - it->cpuExceededPercent / 20)
-                                        {
-                                            std::chrono::duration<double> elapsed = std::chrono::system_clock::now() - it->cpuThreshold;
-
-                                            if (elapsed.count() >= it->cpuThresholdSeconds)
-                                            {
-                                                JsonObject cpuResult;
-                                                cpuResult["type"] = "CPU";
-                                                cpuResult["appPid"] = pid;
-                                                cpuResult["threshold"] = "receded";
-                                                cpuResult["cpuPercent"] = percents;
-
-                                                LOGWARN("CPUThreshold event appPid = %u, threshold = receded, cpuPercent = %u", pid, percents);
-
-                                                onCPUThresholdOccurred(cpuResult);
-                                                it->state = AppConfig::STATE_NORMAL;
-                                            }
-                                        }
-                                        else
-                                        {
-                                            it->state = AppConfig::STATE_EXCEEDED;
-                                        }
-
-                                    }
+                                    const char *threshold = ThresholdTracker::EVENT_EXCEEDED == event ? "exceeded" : "receded";
+
+                                    JsonObject cpuResult;
+                                    if (ThresholdTracker::EVENT_RECEDED == event)
+                                        cpuResult["type"] = "CPU";
+                                    cpuResult["appPid"] = pid;
+                                    cpuResult["threshold"] = threshold;
+                                    cpuResult["cpuPercent"] = percents;
+
+                                    LOGWARN("CPUThreshold event appPid = %u, threshold = %s, cpuPercent = %u", pid, threshold, percents);
+
+                                    onCPUThresholdOccurred(cpuResult);
                                 }
                             }
                         }
@@ -1029,6 +989,13 @@ namespace WPEFramework
                     m_monitorParams->totalCpuUsage = totalCpuUsage;
                 }
 
+                if (summary)
+                {
+                    elapsed = std::chrono::system_clock::now() - m_monitorParams->lastSummary;
+                    sendSummary(elapsed.count());
+                    m_monitorParams->lastSummary = std::chrono::system_clock::now();
+                }
+
                 elapsed = std::chrono::system_clock::now() - m_monitorParams->lastMemCheck;
                 double sleepTime = m_monitorParams->memoryIntervalSeconds > 0 ? m_monitorParams->memoryIntervalSeconds - elapsed.count() : 10000;
 
@@ -1036,6 +1003,10 @@ namespace WPEFramework
                 if (m_monitorParams->cpuIntervalSeconds > 0 && m_monitorParams->cpuIntervalSeconds - elapsed.count() < sleepTime)
                     sleepTime = m_monitorParams->cpuIntervalSeconds - elapsed.count();
 
+                elapsed = std::chrono::system_clock::now() - m_monitorParams->lastSummary;
+                if (m_monitorParams->summaryIntervalSeconds > 0 && m_monitorParams->summaryIntervalSeconds - elapsed.count() < sleepTime)
+                    sleepTime = m_monitorParams->summaryIntervalSeconds - elapsed.count();
+
                 if (sleepTime < 0.01)
                 {
                     LOGERR("SleepTime is too low, using 0.01 seconds");
@@ -1049,6 +1020,41 @@ namespace WPEFramework
             }
         }
 
+        void ActivityMonitor::sendSummary(double intervalSeconds)
+        {
+            JsonArray apps;
+
+            for (std::list <AppConfig>::iterator it = m_monitorParams->config.begin(); it != m_monitorParams->config.end(); it++)
+            {
+                ThresholdTracker::Summary memory = it->memory.takeSummary();
+                ThresholdTracker::Summary cpu = it->cpu.takeSummary();
+
+                JsonObject app;
+                app["appPid"] = it->pid;
+                app["memoryMB"] = memory.last;
+                app["memoryPeakMB"] = memory.peak;
+                app["memoryExceeded"] = it->memory.exceeded();
+                app["memoryCrossings"] = memory.crossings;
+                app["memoryEvents"] = memory.events;
+                app["cpuPercent"] = cpu.last;
+                app["cpuPeakPercent"] = cpu.peak;
+                app["cpuExceeded"] = it->cpu.exceeded();
+                app["cpuCrossings"] = cpu.crossings;
+                app["cpuEvents"] = cpu.events;
+                app["heldEvents"] = memory.held + cpu.held;
+                apps.Add(app);
+
+                if (memory.crossings > memory.events || cpu.crossings > cpu.events)
+                    LOGINFO("Summary appPid = %u, memory crossings/events = %u/%u, cpu crossings/events = %u/%u",
+                        it->pid, memory.crossings, memory.events, cpu.crossings, cpu.events);
+            }
+
+            JsonObject result;
+            result["intervalSeconds"] = static_cast<unsigned int>(intervalSeconds + 0.5);
+            result["applications"] = apps;
+            onActivitySummary(result);
+        }
+
         void ActivityMonitor::onMemoryThresholdOccurred(const JsonObject& result)
         {
             sendNotify(ACTIVITY_MONITOR_EVT_ON_MEMORY_THRESHOLD, result);
@@ -1059,6 +1065,11 @@ namespace WPEFramework
             sendNotify(ACTIVITY_MONITOR_EVT_ON_CPU_THRESHOLD, result);
         }
 
+        void ActivityMonitor::onActivitySummary(const JsonObject& result)
+        {
+            sendNotify(ACTIVITY_MONITOR_EVT_ON_ACTIVITY_SUMMARY, result);
+        }
+
     } // namespace Plugin
 } // namespace WPEFramework
 
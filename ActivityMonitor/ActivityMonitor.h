@@ -63,6 +63,7 @@ namespace WPEFramework {
             //Begin events
             void onMemoryThresholdOccurred(const JsonObject& result);
             void onCPUThresholdOccurred(const JsonObject& result);
+            void onActivitySummary(const JsonObject& result);
             //End events
 
         public:
@@ -77,6 +78,7 @@ namespace WPEFramework {
             static void threadRun(ActivityMonitor *am);
             int threadStop();
             void monitoring();
+            void sendSummary(double intervalSeconds);
 
             std::thread m_monitor;
             std::mutex m_monitoringMutex;
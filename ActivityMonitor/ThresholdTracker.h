@@ -0,0 +1,205 @@
+/**
+* If not stated otherwise in this file or this component's LICENSE
+* file the following copyright and licenses apply:
+*
+* Copyright 2019 RDK Management
+*
+* Licensed under the Apache License, Version 2.0 (the "License");
+* you may not use this file except in compliance with the License.
+* You may obtain a copy of the License at
+*
+* http://www.apache.org/licenses/LICENSE-2.0
+*
+* Unless required by applicable law or agreed to in writing, software
+* distributed under the License is distributed on an "AS IS" BASIS,
+* WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+* See the License for the specific language governing permissions and
+* limitations under the License.
+**/
+
+#pragma once
+
+namespace WPEFramework {
+
+    namespace Plugin {
+
+        struct ThresholdPolicy
+        {
+            ThresholdPolicy()
+            {
+                threshold = 0;
+                hysteresisPercent = 5;
+                dwellSeconds = 0;
+                minEventIntervalSeconds = 0;
+            }
+
+            // Exceeded at this usage or above
+            unsigned int threshold;
+            // Receded once below the threshold less this percent of it, at most 99
+            unsigned int hysteresisPercent;
+            // For how long the usage has to stay exceeded, or receded, before the event
+            double dwellSeconds;
+            // Events of the application no closer together than this
+            double minEventIntervalSeconds;
+        };
+
+        // Tells when the usage of an application exceeded its threshold and when it receded,
+        // without an event for every sample of a usage hovering around the threshold.
+        class ThresholdTracker
+        {
+        public:
+            enum Event {
+                EVENT_NONE,
+                EVENT_EXCEEDED,
+                EVENT_RECEDED,
+            };
+
+            struct Summary
+            {
+                Summary()
+                {
+                    samples = crossings = events = held = 0;
+                    last = peak = 0;
+                }
+
+                unsigned int samples;
+                // Times the usage went over the threshold
+                unsigned int crossings;
+                unsigned int events;
+                // Samples an event was due at but held back by the minimum interval
+                unsigned int held;
+                unsigned int last;
+                unsigned int peak;
+            };
+
+            ThresholdTracker()
+            {
+                m_state = STATE_NORMAL;
+                m_since = 0;
+                m_lastEvent = 0;
+                m_eventSent = false;
+                m_above = false;
+            }
+
+            void setPolicy(const ThresholdPolicy& policy)
+            {
+                m_policy = policy;
+            }
+
+            const ThresholdPolicy& policy() const
+            {
+                return m_policy;
+            }
+
+            bool exceeded() const
+            {
+                return STATE_EXCEEDED == m_state || STATE_RECEDING == m_state;
+            }
+
+            // The usage at the time in seconds, returning the event to send if any
+            Event sample(unsigned int value, double now)
+            {
+                m_summary.samples++;
+                m_summary.last = value;
+                if (value > m_summary.peak)
+                    m_summary.peak = value;
+
+                bool above = value >= m_policy.threshold;
+                if (above && !m_above)
+                    m_summary.crossings++;
+                m_above = above;
+
+                switch (m_state)
+                {
+                case STATE_NORMAL:
+                    if (!above)
+                        return EVENT_NONE;
+                    m_state = STATE_EXCEEDING;
+                    m_since = now;
+                    // fall through
+                case STATE_EXCEEDING:
+                    if (!above)
+                    {
+                        m_state = STATE_NORMAL;
+                        return EVENT_NONE;
+                    }
+                    if (!due(now))
+                        return EVENT_NONE;
+                    m_state = STATE_EXCEEDED;
+                    return sent(EVENT_EXCEEDED, now);
+
+                case STATE_EXCEEDED:
+                    if (value >= recededBelow())
+                        return EVENT_NONE;
+                    m_state = STATE_RECEDING;
+                    m_since = now;
+                    // fall through
+                case STATE_RECEDING:
+                    if (value >= recededBelow())
+                    {
+                        m_state = STATE_EXCEEDED;
+                        return EVENT_NONE;
+                    }
+                    if (!due(now))
+                        return EVENT_NONE;
+                    m_state = STATE_NORMAL;
+                    return sent(EVENT_RECEDED, now);
+                }
+                return EVENT_NONE;
+            }
+
+            // The summary since the last one
+            Summary takeSummary()
+            {
+                Summary summary = m_summary;
+                m_summary = Summary();
+                m_summary.last = summary.last;
+                return summary;
+            }
+
+        private:
+            enum {
+                STATE_NORMAL,
+                STATE_EXCEEDING,
+                STATE_EXCEEDED,
+                STATE_RECEDING,
+            };
+
+            unsigned int recededBelow() const
+            {
+                if (m_policy.hysteresisPercent > 99)
+                    return m_policy.threshold - m_policy.threshold * 99 / 100;
+                return m_policy.threshold - m_policy.threshold * m_policy.hysteresisPercent / 100;
+            }
+
+            bool due(double now)
+            {
+                if (now - m_since < m_policy.dwellSeconds)
+                    return false;
+                if (m_eventSent && now - m_lastEvent < m_policy.minEventIntervalSeconds)
+                {
+                    m_summary.held++;
+                    return false;
+                }
+                return true;
+            }
+
+            Event sent(Event event, double now)
+            {
+                m_lastEvent = now;
+                m_eventSent = true;
+                m_summary.events++;
+                return event;
+            }
+
+            ThresholdPolicy m_policy;
+            int m_state;
+            double m_since;
+            double m_lastEvent;
+            bool m_eventSent;
+            bool m_above;
+            Summary m_summary;
+        };
+
+    } // namespace Plugin
+} // namespace WPEFramework
@@ -118,6 +118,98 @@ namespace WPEFramework
 
         Bluetooth* Bluetooth::_instance = nullptr;
         static Core::TimerType<DiscoveryTimer> _discoveryTimer(64 * 1024, "DiscoveryTimer");
+        static Core::TimerType<DiscoveryUpdateTimer> _discoveryUpdateTimer(64 * 1024, "DiscoveryUpdateTimer");
+
+        template <typename DEVICE>
+        static BluetoothDeviceRegistry::Device registryDevice(const DEVICE& property)
+        {
+            BluetoothDeviceRegistry::Device device;
+            device.deviceID = property.m_deviceHandle;
+            device.name = string(property.m_name);
+            device.deviceType = string(BTRMGR_GetDeviceTypeAsString(property.m_deviceType));
+            return device;
+        }
+
+        template <typename DEVICE>
+        static BluetoothDeviceRegistry::Device eventDevice(const DEVICE& property)
+        {
+            BluetoothDeviceRegistry::Device device = registryDevice(property);
+            device.rawDeviceType = property.m_ui32DevClassBtSpec;
+            device.lastConnected = property.m_isLastConnectedDevice ? true : false;
+            device.connected = property.m_isConnected ? true : false;
+            return device;
+        }
+
+        static bool loadDevices(BluetoothDeviceRegistry::List list, std::vector<BluetoothDeviceRegistry::Device>& devices)
+        {
+            BTRMGR_Result_t rc = BTRMGR_RESULT_GENERIC_FAILURE;
+            switch (list) {
+                case BluetoothDeviceRegistry::DISCOVERED:
+                {
+                    BTRMGR_DiscoveredDevicesList_t discoveredDevices;
+                    memset (&discoveredDevices, 0, sizeof(discoveredDevices));
+                    rc = BTRMGR_GetDiscoveredDevices(0, &discoveredDevices);
+                    if (BTRMGR_RESULT_SUCCESS != rc)
+                    {
+                        LOGERR("Failed to get the discovered devices");
+                        break;
+                    }
+                    LOGINFO ("Success....   Discovered %d Devices", discoveredDevices.m_numOfDevices);
+                    for (int i = 0; i < discoveredDevices.m_numOfDevices; i++)
+                    {
+                        BluetoothDeviceRegistry::Device device = registryDevice(discoveredDevices.m_deviceProperty[i]);
+                        device.connected = discoveredDevices.m_deviceProperty[i].m_isConnected ? true : false;
+                        device.paired = discoveredDevices.m_deviceProperty[i].m_isPairedDevice ? true : false;
+                        devices.push_back(device);
+                    }
+                    break;
+                }
+                case BluetoothDeviceRegistry::PAIRED:
+                {
+                    BTRMGR_PairedDevicesList_t pairedDevices;
+                    memset (&pairedDevices, 0, sizeof(pairedDevices));
+                    rc = BTRMGR_GetPairedDevices(0, &pairedDevices);
+                    if (BTRMGR_RESULT_SUCCESS != rc)
+                    {
+                        LOGERR("Failed to get the paired devices");
+                        break;
+                    }
+                    LOGINFO ("Success....   Paired %d Devices", pairedDevices.m_numOfDevices);
+                    for (int i = 0; i < pairedDevices.m_numOfDevices; i++)
+                    {
+                        BluetoothDeviceRegistry::Device device = registryDevice(pairedDevices.m_deviceProperty[i]);
+                        device.connected = pairedDevices.m_deviceProperty[i].m_isConnected ? true : false;
+                        device.paired = true;
+                        devices.push_back(device);
+                    }
+                    break;
+                }
+                case BluetoothDeviceRegistry::CONNECTED:
+                {
+                    BTRMGR_ConnectedDevicesList_t connectedDevices;
+                    memset (&connectedDevices, 0, sizeof(connectedDevices));
+                    rc = BTRMGR_GetConnectedDevices(0, &connectedDevices);
+                    if (BTRMGR_RESULT_SUCCESS != rc)
+                    {
+                        LOGERR("Failed to get the connected devices");
+                        break;
+                    }
+                    LOGINFO ("Success....   Connected %d Devices", connectedDevices.m_numOfDevices);
+                    for (int i = 0; i < connectedDevices.m_numOfDevices; i++)
+                    {
+                        BluetoothDeviceRegistry::Device device = registryDevice(connectedDevices.m_deviceProperty[i]);
+                        device.connected = true;
+                        device.paired = true;
+                        device.powerStatus = connectedDevices.m_deviceProperty[i].m_powerStatus;
+                        devices.push_back(device);
+                    }
+                    break;
+                }
+                default:
+                    break;
+            }
+            return BTRMGR_RESULT_SUCCESS == rc;
+        }
 
         BTRMGR_Result_t bluetoothSrv_EventCallback (BTRMGR_EventMessage_t eventMsg)
         {
@@ -135,6 +227,9 @@ namespace WPEFramework
         , m_apiVersionNumber(API_VERSION_NUMBER_MAJOR)
         , m_discoveryRunning(false)
         , m_discoveryTimer(this)
+        , m_deviceRegistry(loadDevices)
+        , m_discoveryUpdateWindow(0)
+        , m_discoveryUpdateTimer(this)
         {
             Bluetooth::_instance = this;
             registerMethod(METHOD_GET_API_VERSION_NUMBER, &Bluetooth::getApiVersionNumber, this);
@@ -177,9 +272,19 @@ namespace WPEFramework
         {
         }
 
+        const string Bluetooth::Initialize(PluginHost::IShell* service)
+        {
+            Config config;
+            config.FromString(service->ConfigLine());
+            m_discoveryUpdateWindow = config.DiscoveryUpdateWindow.Value();
+            LOGINFO("Discovery updates are coalesced over %u ms", m_discoveryUpdateWindow);
+            return AbstractPlugin::Initialize(service);
+        }
+
         void Bluetooth::Deinitialize(PluginHost::IShell* /* service */)
         {
             Bluetooth::_instance = nullptr;
+            _discoveryUpdateTimer.Revoke(m_discoveryUpdateTimer);
 
             BTRMGR_Result_t rc = BTRMGR_UnRegisterFromCallbacks(Utils::IARM::NAME);
             if (BTRMGR_RESULT_SUCCESS != rc)
@@ -349,85 +454,85 @@ namespace WPEFramework
             stopDeviceDiscovery();
         }
 
-        JsonArray Bluetooth::getDiscoveredDevices()
+        void Bluetooth::onDiscoveryUpdateTimer()
         {
-            JsonArray deviceArray;
-            BTRMGR_DiscoveredDevicesList_t discoveredDevices;
+            flushDiscoveryUpdates();
+        }
 
-            memset (&discoveredDevices, 0, sizeof(discoveredDevices));
-            BTRMGR_Result_t rc = BTRMGR_GetDiscoveredDevices(0, &discoveredDevices);
-            if (BTRMGR_RESULT_SUCCESS != rc)
-            {
-                LOGERR("Failed to get the discovered devices");
-            }
-            else
+        void Bluetooth::flushDiscoveryUpdates()
+        {
+            m_deviceRegistry.flushDiscoveryUpdates([this](const BluetoothDeviceRegistry::DiscoveryUpdate& update) {
+                notifyDiscoveryUpdate(update);
+            });
+        }
+
+        void Bluetooth::notifyDiscoveryUpdate(const BluetoothDeviceRegistry::DiscoveryUpdate& update)
+        {
+            JsonObject params;
+            params["deviceID"] = std::to_string(update.device.deviceID);
+            params["discoveryType"] = update.discovered ? "DISCOVERED":"LOST";
+            params["name"] = update.device.name;
+            params["deviceType"] = update.device.deviceType;
+            params["rawDeviceType"] = std::to_string(update.device.rawDeviceType);
+            params["lastConnectedState"] = update.device.lastConnected;
+            params["paired"] = update.device.paired;
+            sendNotify(C_STR(EVT_DEVICE_DISCOVERY_UPDATE), params);
+        }
+
+        JsonArray Bluetooth::getDiscoveredDevices(uint64_t& generation)
+        {
+            JsonArray deviceArray;
+            std::vector<BluetoothDeviceRegistry::Device> devices;
+            if (m_deviceRegistry.devices(BluetoothDeviceRegistry::DISCOVERED, devices, generation))
             {
-                int i = 0;
                 JsonObject deviceDetails;
-                LOGINFO ("Success....   Discovered %d Devices", discoveredDevices.m_numOfDevices);
-                for (; i < discoveredDevices.m_numOfDevices; i++)
+                for (const auto& device : devices)
                 {
-                    deviceDetails["deviceID"] = std::to_string(discoveredDevices.m_deviceProperty[i].m_deviceHandle);
-                    deviceDetails["name"] = string(discoveredDevices.m_deviceProperty[i].m_name);
-                    deviceDetails["deviceType"] = string(BTRMGR_GetDeviceTypeAsString(discoveredDevices.m_deviceProperty[i].m_deviceType));
-                    deviceDetails["connected"] = discoveredDevices.m_deviceProperty[i].m_isConnected?true:false;
-                    deviceDetails["paired"] = discoveredDevices.m_deviceProperty[i].m_isPairedDevice?true:false;
+                    deviceDetails["deviceID"] = std::to_string(device.deviceID);
+                    deviceDetails["name"] = device.name;
+                    deviceDetails["deviceType"] = device.deviceType;
+                    deviceDetails["connected"] = device.connected;
+                    deviceDetails["paired"] = device.paired;
                     deviceArray.Add(deviceDetails);
                 }
             }
             return deviceArray;
         }
 
-        JsonArray Bluetooth::getPairedDevices()
+        JsonArray Bluetooth::getPairedDevices(uint64_t& generation)
         {
             JsonArray deviceArray;
-            BTRMGR_PairedDevicesList_t pairedDevices;
-
-            memset (&pairedDevices, 0, sizeof(pairedDevices));
-            BTRMGR_Result_t rc = BTRMGR_GetPairedDevices(0, &pairedDevices);
-            if (BTRMGR_RESULT_SUCCESS != rc)
+            std::vector<BluetoothDeviceRegistry::Device> devices;
+            if (m_deviceRegistry.devices(BluetoothDeviceRegistry::PAIRED, devices, generation))
             {
-                LOGERR("Failed to get the paired devices");
-            }
-            else
-            {
-                int i = 0;
                 JsonObject deviceDetails;
-                LOGINFO ("Success....   Paired %d Devices", pairedDevices.m_numOfDevices);
-                for (; i < pairedDevices.m_numOfDevices; i++)
+                for (const auto& device : devices)
                 {
-                    deviceDetails["deviceID"] = std::to_string(pairedDevices.m_deviceProperty[i].m_deviceHandle);
-                    deviceDetails["name"] = string(pairedDevices.m_deviceProperty[i].m_name);
-                    deviceDetails["deviceType"] = string(BTRMGR_GetDeviceTypeAsString(pairedDevices.m_deviceProperty[i].m_deviceType));
-                    deviceDetails["connected"] = pairedDevices.m_deviceProperty[i].m_isConnected?true:false;
+                    deviceDetails["deviceID"] = std::to_string(device.deviceID);
+                    deviceDetails["name"] = device.name;
+                    deviceDetails["deviceType"] = device.deviceType;
+                    deviceDetails["connected"] = device.connected;
                     deviceArray.Add(deviceDetails);
                 }
             }
             return deviceArray;
         }
 
-        JsonArray Bluetooth::getConnectedDevices()
+        JsonArray Bluetooth::getConnectedDevices(uint64_t& generation)
         {
             JsonArray deviceArray;
-            BTRMGR_ConnectedDevicesList_t connectedDevices;
-
-            memset (&connectedDevices, 0, sizeof(connectedDevices));
-            BTRMGR_Result_t rc = BTRMGR_GetConnectedDevices(0, &connectedDevices);
-            if (BTRMGR_RESULT_SUCCESS != rc)
+            std::vector<BluetoothDeviceRegistry::Device> devices;
+            // BTRMgr reports no event when the power status of a connected
+            // device changes, so the list is read live every time
+            if (m_deviceRegistry.devices(BluetoothDeviceRegistry::CONNECTED, devices, generation, true))
             {
-                LOGERR("Failed to get the connected devices");
-            }
-            else
-            {
-                int i = 0;
                 JsonObject deviceDetails;
-                LOGINFO ("Success....   Connected %d Devices", connectedDevices.m_numOfDevices);
-                for (; i < connectedDevices.m_numOfDevices; i++)
+                for (const auto& device : devices)
                 {
-                    deviceDetails["deviceID"] = std::to_string(connectedDevices.m_deviceProperty[i].m_deviceHandle);
-                    deviceDetails["name"] = string(connectedDevices.m_deviceProperty[i].m_name);
-                    deviceDetails["deviceType"] = string(BTRMGR_GetDeviceTypeAsString(connectedDevices.m_deviceProperty[i].m_deviceType));
-                    deviceDetails["activeState"] = std::to_string(connectedDevices.m_deviceProperty[i].m_powerStatus);
+                    deviceDetails["deviceID"] = std::to_string(device.deviceID);
+                    deviceDetails["name"] = device.name;
+                    deviceDetails["deviceType"] = device.deviceType;
+                    deviceDetails["activeState"] = std::to_string(device.powerStatus);
                     deviceArray.Add(deviceDetails);
                 }
             }
@@ -541,6 +646,10 @@ namespace WPEFramework
             {
                 LOGERR("Failed to do setBluetoothEnabled");
             }
+            else
+            {
+                m_deviceRegistry.reset();
+            }
 
             return BTRMGR_RESULT_SUCCESS == rc;
         }
@@ -833,6 +942,9 @@ namespace WPEFramework
             switch (eventMsg.m_eventType) {
                 case BTRMGR_EVENT_DEVICE_DISCOVERY_COMPLETE:
                     LOGINFO ("Received %s Event from BTRMgr", C_STR(STATUS_DISCOVERY_COMPLETED));
+                    // the devices found go out before the completion
+                    _discoveryUpdateTimer.Revoke(m_discoveryUpdateTimer);
+                    flushDiscoveryUpdates();
                     params["newStatus"] = STATUS_DISCOVERY_COMPLETED;
                     eventId = EVT_STATUS_CHANGED;
 
@@ -846,6 +958,7 @@ namespace WPEFramework
 
                 case BTRMGR_EVENT_DEVICE_PAIRING_COMPLETE:
                     LOGINFO ("Received %s Event from BTRMgr", C_STR(STATUS_PAIRING_CHANGE));
+                    m_deviceRegistry.pairingChanged(eventDevice(eventMsg.m_discoveredDevice), true);
                     params["newStatus"] = STATUS_PAIRING_CHANGE;
                     params["deviceID"] = C_STR(std::to_string(eventMsg.m_discoveredDevice.m_deviceHandle));
                     params["name"] = string(eventMsg.m_discoveredDevice.m_name);
@@ -860,6 +973,7 @@ namespace WPEFramework
 
                 case BTRMGR_EVENT_DEVICE_UNPAIRING_COMPLETE:
                     LOGINFO ("Received %s Event from BTRMgr", C_STR(STATUS_PAIRING_CHANGE));
+                    m_deviceRegistry.pairingChanged(eventDevice(eventMsg.m_pairedDevice), false);
                     params["newStatus"] = STATUS_PAIRING_CHANGE;
                     params["deviceID"] = std::to_string(eventMsg.m_pairedDevice.m_deviceHandle);
                     params["name"] = string(eventMsg.m_pairedDevice.m_name);
@@ -874,6 +988,8 @@ namespace WPEFramework
 
                 case BTRMGR_EVENT_DEVICE_CONNECTION_COMPLETE:
                 case BTRMGR_EVENT_DEVICE_DISCONNECT_COMPLETE: /* Allow only AudioIn/Out & HID Connection Event propogation to XRE for now */
+                    m_deviceRegistry.connectionChanged(eventDevice(eventMsg.m_pairedDevice),
+                        eventMsg.m_eventType == BTRMGR_EVENT_DEVICE_CONNECTION_COMPLETE);
                     if ((eventMsg.m_pairedDevice.m_deviceType == BTRMGR_DEVICE_TYPE_WEARABLE_HEADSET)   ||
                         (eventMsg.m_pairedDevice.m_deviceType == BTRMGR_DEVICE_TYPE_HANDSFREE)          ||
                         (eventMsg.m_pairedDevice.m_deviceType == BTRMGR_DEVICE_TYPE_LOUDSPEAKER)        ||
@@ -901,6 +1017,10 @@ namespace WPEFramework
 
                 case BTRMGR_EVENT_DEVICE_DISCOVERY_STARTED:
                     LOGINFO ("Received %s Event from BTRMgr", C_STR(STATUS_DISCOVERY_STARTED));
+                    _discoveryUpdateTimer.Revoke(m_discoveryUpdateTimer);
+                    m_deviceRegistry.discoveryStarted([this](const BluetoothDeviceRegistry::DiscoveryUpdate& update) {
+                        notifyDiscoveryUpdate(update);
+                    });
                     params["newStatus"] = STATUS_DISCOVERY_STARTED;
                     eventId = EVT_STATUS_CHANGED;
                     break;
@@ -1105,16 +1225,24 @@ namespace WPEFramework
                     break;
 
                 case BTRMGR_EVENT_DEVICE_DISCOVERY_UPDATE:
-                    params["deviceID"] = std::to_string(eventMsg.m_discoveredDevice.m_deviceHandle);
-                    params["discoveryType"] = eventMsg.m_discoveredDevice.m_isDiscovered ? "DISCOVERED":"LOST";
-                    params["name"] = string(eventMsg.m_discoveredDevice.m_name);
-                    params["deviceType"] = BTRMGR_GetDeviceTypeAsString(eventMsg.m_discoveredDevice.m_deviceType);
-                    params["rawDeviceType"] = std::to_string(eventMsg.m_discoveredDevice.m_ui32DevClassBtSpec);
-                    params["lastConnectedState"] = eventMsg.m_discoveredDevice.m_isLastConnectedDevice? true:false;
-                    params["paired"] = eventMsg.m_discoveredDevice.m_isPairedDevice ? true:false;
-
-                    eventId = EVT_DEVICE_DISCOVERY_UPDATE;
+                {
+                    // BTRMgr repeats the update on every RSSI or name refresh, the
+                    // registry coalesces them and onDiscoveredDevice goes out when flushed
+                    BluetoothDeviceRegistry::Device device = eventDevice(eventMsg.m_discoveredDevice);
+                    device.paired = eventMsg.m_discoveredDevice.m_isPairedDevice ? true : false;
+                    if (m_deviceRegistry.discoveryUpdate(device, eventMsg.m_discoveredDevice.m_isDiscovered ? true : false))
+                    {
+                        if (0 == m_discoveryUpdateWindow)
+                        {
+                            flushDiscoveryUpdates();
+                        }
+                        else
+                        {
+                            _discoveryUpdateTimer.Schedule(Core::Time::Now().Add(m_discoveryUpdateWindow), m_discoveryUpdateTimer);
+                        }
+                    }
                     break;
+                }
 
                     // TODO: implement or delete these values from enum
                 case BTRMGR_EVENT_MAX:
@@ -1259,7 +1387,9 @@ namespace WPEFramework
         {
             LOGINFOMETHOD();
             UNUSED(parameters);
-            response["discoveredDevices"] = getDiscoveredDevices();
+            uint64_t generation = 0;
+            response["discoveredDevices"] = getDiscoveredDevices(generation);
+            response["generation"] = std::to_string(generation);
             returnResponse(true);
         }
 
@@ -1267,7 +1397,9 @@ namespace WPEFramework
         {
             LOGINFOMETHOD();
             UNUSED(parameters);
-            response["pairedDevices"] = getPairedDevices();
+            uint64_t generation = 0;
+            response["pairedDevices"] = getPairedDevices(generation);
+            response["generation"] = std::to_string(generation);
             returnResponse(true);
         }
 
@@ -1275,7 +1407,9 @@ namespace WPEFramework
         {
             LOGINFOMETHOD();
             UNUSED(parameters);
-            response["connectedDevices"] = getConnectedDevices();
+            uint64_t generation = 0;
+            response["connectedDevices"] = getConnectedDevices(generation);
+            response["generation"] = std::to_string(generation);
             returnResponse(true);
         }
 
@@ -1690,5 +1824,12 @@ namespace WPEFramework
             m_bt->onDiscoveryTimer();
             return(result);
         }
+
+        uint64_t DiscoveryUpdateTimer::Timed(const uint64_t scheduledTime)
+        {
+            uint64_t result = 0;
+            m_bt->onDiscoveryUpdateTimer();
+            return(result);
+        }
     } // Plugin
 } // WPEFramework
@@ -24,6 +24,7 @@
 #include "Module.h"
 #include "utils.h"
 #include "AbstractPlugin.h"
+#include "BluetoothDeviceRegistry.h"
 
 #include "btmgr.h" //TODO: can we move it to the module? Required by notifyEventWrapper()
 
@@ -66,8 +67,48 @@ namespace WPEFramework {
             Bluetooth* m_bt;
         };
 
+        class DiscoveryUpdateTimer
+        {
+        private:
+            DiscoveryUpdateTimer() = delete;
+            DiscoveryUpdateTimer& operator=(const DiscoveryUpdateTimer& RHS) = delete;
+
+        public:
+            DiscoveryUpdateTimer(Bluetooth* bt): m_bt(bt){}
+            DiscoveryUpdateTimer(const DiscoveryUpdateTimer& copy): m_bt(copy.m_bt){}
+            ~DiscoveryUpdateTimer() {}
+
+            inline bool operator==(const DiscoveryUpdateTimer& RHS) const
+            {
+                return(m_bt == RHS.m_bt);
+            }
+
+        public:
+            uint64_t Timed(const uint64_t scheduledTime);
+
+        private:
+            Bluetooth* m_bt;
+        };
+
         class Bluetooth : public AbstractPlugin {
         private:
+            class Config : public Core::JSON::Container {
+            private:
+                Config(const Config&) = delete;
+                Config& operator=(const Config&) = delete;
+
+            public:
+                Config()
+                    : Core::JSON::Container()
+                    , DiscoveryUpdateWindow(250)
+                {
+                    Add(_T("discoveryupdatewindow"), &DiscoveryUpdateWindow);
+                }
+
+            public:
+                // Milliseconds the onDiscoveredDevice events are held back and coalesced, 0 sends them at once
+                Core::JSON::DecUInt32 DiscoveryUpdateWindow;
+            };
 
             // We do not allow this plugin to be copied !!
             Bluetooth(const Bluetooth&) = delete;
@@ -108,9 +149,12 @@ namespace WPEFramework {
             void startDiscoveryTimer(int msec);
             void stopDiscoveryTimer();
             void onDiscoveryTimer();
-            JsonArray getDiscoveredDevices();
-            JsonArray getPairedDevices();
-            JsonArray getConnectedDevices();
+            void onDiscoveryUpdateTimer();
+            void flushDiscoveryUpdates();
+            void notifyDiscoveryUpdate(const BluetoothDeviceRegistry::DiscoveryUpdate& update);
+            JsonArray getDiscoveredDevices(uint64_t& generation);
+            JsonArray getPairedDevices(uint64_t& generation);
+            JsonArray getConnectedDevices(uint64_t& generation);
             bool setDeviceConnection(long long int deviceID, const string &enable, const string &deviceType = "UNKNOWN DEVICE");
             bool setAudioStream(long long int deviceID, const string &audioStreamName);
             bool setDevicePairing(long long int deviceID, bool pair);
@@ -174,6 +218,7 @@ namespace WPEFramework {
 
             Bluetooth();
             virtual ~Bluetooth();
+            virtual const string Initialize(PluginHost::IShell* service) override;
             virtual void Deinitialize(PluginHost::IShell* service) override;
             virtual string Information() const override;
 
@@ -223,6 +268,10 @@ namespace WPEFramework {
             bool m_discoveryRunning;
             DiscoveryTimer m_discoveryTimer;
             friend class DiscoveryTimer;
+            BluetoothDeviceRegistry m_deviceRegistry;
+            uint32_t m_discoveryUpdateWindow;
+            DiscoveryUpdateTimer m_discoveryUpdateTimer;
+            friend class DiscoveryUpdateTimer;
         };
 	} // Plugin
 } // WPEFramework
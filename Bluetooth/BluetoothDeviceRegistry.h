@@ -0,0 +1,408 @@
+/**
+* If not stated otherwise in this file or this component's LICENSE
+* file the following copyright and licenses apply:
+*
+* Copyright 2019 RDK Management
+*
+* Licensed under the Apache License, Version 2.0 (the "License");
+* you may not use this file except in compliance with the License.
+* You may obtain a copy of the License at
+*
+* http://www.apache.org/licenses/LICENSE-2.0
+*
+* Unless required by applicable law or agreed to in writing, software
+* distributed under the License is distributed on an "AS IS" BASIS,
+* WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+* See the License for the specific language governing permissions and
+* limitations under the License.
+**/
+
+#pragma once
+
+#include <stdint.h>
+#include <functional>
+#include <map>
+#include <mutex>
+#include <string>
+#include <vector>
+
+namespace WPEFramework {
+
+    namespace Plugin {
+
+        /* The discovered, paired and connected devices as last reported by
+         * BTRMgr. Each list is loaded with one BTRMGR_Get* call on first use
+         * and then kept current by the BTRMgr events, so the getters do not
+         * go to BTRMgr every time. The generation changes whenever any list
+         * does.
+         *
+         * Discovery updates are also coalesced here: BTRMgr repeats the
+         * update of a device on every RSSI or name refresh, the registry keeps
+         * the latest one per device until the plugin flushes them and drops
+         * those that do not change what was announced last. */
+        class BluetoothDeviceRegistry
+        {
+        public:
+            enum List
+            {
+                DISCOVERED = 0,
+                PAIRED,
+                CONNECTED,
+                LIST_COUNT
+            };
+
+            struct Device
+            {
+                Device()
+                    : deviceID(0)
+                    , rawDeviceType(0)
+                    , paired(false)
+                    , connected(false)
+                    , lastConnected(false)
+                    , powerStatus(0)
+                {
+                }
+
+                uint64_t deviceID;
+                std::string name;
+                std::string deviceType;
+                uint32_t rawDeviceType;
+                bool paired;
+                bool connected;
+                bool lastConnected;
+                /* Only reported by BTRMGR_GetConnectedDevices */
+                int powerStatus;
+            };
+
+            struct DiscoveryUpdate
+            {
+                Device device;
+                bool discovered;
+            };
+
+            typedef std::function<bool(List, std::vector<Device>&)> Loader;
+            typedef std::function<void(const DiscoveryUpdate&)> Notify;
+
+            explicit BluetoothDeviceRegistry(const Loader& loader)
+                : mLoader(loader)
+                , mSequence(0)
+                , mGeneration(1)
+            {
+                for (int list = 0; list < LIST_COUNT; list++)
+                {
+                    mLoaded[list] = false;
+                }
+            }
+
+            BluetoothDeviceRegistry(const BluetoothDeviceRegistry&) = delete;
+            BluetoothDeviceRegistry& operator=(const BluetoothDeviceRegistry&) = delete;
+
+            /* The devices of a list, loading it first if needed, or every
+             * time with reload for what no event reports, like the power
+             * status of the connected devices. False if it could not be
+             * loaded. */
+            bool devices(List list, std::vector<Device>& devices, uint64_t& generation, bool reload = false)
+            {
+                if ((reload || !isLoaded(list)) && !load(list))
+                {
+                    return false;
+                }
+
+                std::lock_guard<std::mutex> lock(mMutex);
+                devices.clear();
+                devices.reserve(mDevices[list].size());
+                for (const auto& it : mDevices[list])
+                {
+                    if (it.second.present)
+                    {
+                        devices.push_back(it.second.device);
+                    }
+                }
+                generation = mGeneration;
+                return true;
+            }
+
+            uint64_t generation()
+            {
+                std::lock_guard<std::mutex> lock(mMutex);
+                return mGeneration;
+            }
+
+            /* BTRMGR_EVENT_DEVICE_DISCOVERY_UPDATE. Returns true when this is
+             * the first update pending since the last flush, i.e. when the
+             * plugin has to schedule one. */
+            bool discoveryUpdate(const Device& device, bool discovered)
+            {
+                std::lock_guard<std::mutex> lock(mMutex);
+                set(DISCOVERED, device, discovered);
+
+                auto pending = mPending.find(device.deviceID);
+                if (pending == mPending.end())
+                {
+                    if (isAnnounced(device, discovered))
+                    {
+                        return false;
+                    }
+                    DiscoveryUpdate update;
+                    update.device = device;
+                    update.discovered = discovered;
+                    mPending.emplace(device.deviceID, update);
+                    return mPending.size() == 1;
+                }
+                pending->second.device = device;
+                pending->second.discovered = discovered;
+                return false;
+            }
+
+            /* Hands the discovery updates to notify: the latest per device,
+             * in device order, leaving out the devices whose latest update
+             * restores what was announced before. notify runs under the
+             * registry lock, so the flushes of the timer thread and of the
+             * event thread go out one after the other, in order; it must not
+             * call back into the registry. */
+            void flushDiscoveryUpdates(const Notify& notify)
+            {
+                std::lock_guard<std::mutex> lock(mMutex);
+                flush(notify);
+            }
+
+            std::vector<DiscoveryUpdate> takeDiscoveryUpdates()
+            {
+                std::vector<DiscoveryUpdate> updates;
+                flushDiscoveryUpdates([&updates](const DiscoveryUpdate& update) {
+                    updates.push_back(update);
+                });
+                return updates;
+            }
+
+            /* BTRMGR_EVENT_DEVICE_DISCOVERY_STARTED: BTRMgr starts a new
+             * discovered list, every device found is announced again. The
+             * updates of the previous scan are flushed first. */
+            void discoveryStarted(const Notify& notify = nullptr)
+            {
+                std::lock_guard<std::mutex> lock(mMutex);
+                if (notify)
+                {
+                    flush(notify);
+                }
+                mAnnounced.clear();
+                mPending.clear();
+                invalidate(DISCOVERED);
+            }
+
+            /* BTRMGR_EVENT_DEVICE_PAIRING_COMPLETE and _UNPAIRING_COMPLETE */
+            void pairingChanged(const Device& device, bool paired)
+            {
+                std::lock_guard<std::mutex> lock(mMutex);
+                Device changed(device);
+                changed.paired = paired;
+                set(PAIRED, changed, paired);
+                setFlags(DISCOVERED, changed);
+                if (!paired)
+                {
+                    set(CONNECTED, changed, false);
+                }
+            }
+
+            /* BTRMGR_EVENT_DEVICE_CONNECTION_COMPLETE and _DISCONNECT_COMPLETE.
+             * The events do not carry the power status of the device, the
+             * connected list is loaded again on next use. */
+            void connectionChanged(const Device& device, bool connected)
+            {
+                std::lock_guard<std::mutex> lock(mMutex);
+                Device changed(device);
+                changed.connected = connected;
+                changed.paired = true;
+                setFlags(PAIRED, changed);
+                setFlags(DISCOVERED, changed);
+                invalidate(CONNECTED);
+            }
+
+            /* Forgets everything, e.g. when the adapter is enabled or disabled */
+            void reset()
+            {
+                std::lock_guard<std::mutex> lock(mMutex);
+                for (int list = 0; list < LIST_COUNT; list++)
+                {
+                    invalidate(static_cast<List>(list));
+                }
+            }
+
+        private:
+            struct Record
+            {
+                Device device;
+                bool present;
+                /* Event sequence of the last change, 0 when loaded */
+                uint64_t sequence;
+            };
+
+            bool isLoaded(List list)
+            {
+                std::lock_guard<std::mutex> lock(mMutex);
+                return mLoaded[list];
+            }
+
+            /* Replaces the list with what BTRMgr returns. Devices changed by
+             * an event while BTRMgr was being asked are newer than its answer
+             * and are kept. */
+            bool load(List list)
+            {
+                uint64_t sequence;
+                {
+                    std::lock_guard<std::mutex> lock(mMutex);
+                    sequence = mSequence;
+                }
+
+                // The loader is an IARM call, do not hold the lock meanwhile.
+                std::vector<Device> loaded;
+                if (!mLoader || !mLoader(list, loaded))
+                {
+                    return false;
+                }
+
+                std::lock_guard<std::mutex> lock(mMutex);
+                std::map<uint64_t, Record> devices;
+                for (const auto& device : loaded)
+                {
+                    Record record;
+                    record.device = device;
+                    record.present = true;
+                    record.sequence = 0;
+                    devices[device.deviceID] = record;
+                }
+                for (const auto& it : mDevices[list])
+                {
+                    if (it.second.sequence > sequence)
+                    {
+                        devices[it.first] = it.second;
+                    }
+                }
+                // a reload that finds the same devices is no change
+                if (!mLoaded[list] || !sameRecords(mDevices[list], devices))
+                {
+                    mGeneration++;
+                }
+                mDevices[list].swap(devices);
+                mLoaded[list] = true;
+                return true;
+            }
+
+            void flush(const Notify& notify)
+            {
+                for (const auto& it : mPending)
+                {
+                    const DiscoveryUpdate& update = it.second;
+                    if (!isAnnounced(update.device, update.discovered))
+                    {
+                        mAnnounced[update.device.deviceID] = update;
+                        notify(update);
+                    }
+                }
+                mPending.clear();
+            }
+
+            /* Adds, updates or removes a device of a list. Removed devices
+             * are kept as tombstones until the list is loaded again. */
+            void set(List list, const Device& device, bool present)
+            {
+                auto it = mDevices[list].find(device.deviceID);
+                if (it != mDevices[list].end() && it->second.present == present &&
+                    (!present || sameDevice(it->second.device, device)))
+                {
+                    return;
+                }
+                if (!present && it == mDevices[list].end() && mLoaded[list])
+                {
+                    return;
+                }
+                Record& record = mDevices[list][device.deviceID];
+                record.device = device;
+                record.present = present;
+                record.sequence = ++mSequence;
+                mGeneration++;
+            }
+
+            /* Updates the paired and connected flags of a device already in a list */
+            void setFlags(List list, const Device& device)
+            {
+                auto it = mDevices[list].find(device.deviceID);
+                if (it == mDevices[list].end() || !it->second.present)
+                {
+                    return;
+                }
+                Device& current = it->second.device;
+                if (current.paired == device.paired && current.connected == device.connected)
+                {
+                    return;
+                }
+                current.paired = device.paired;
+                current.connected = device.connected;
+                it->second.sequence = ++mSequence;
+                mGeneration++;
+            }
+
+            void invalidate(List list)
+            {
+                if (mLoaded[list] || !mDevices[list].empty())
+                {
+                    mDevices[list].clear();
+                    mLoaded[list] = false;
+                    mGeneration++;
+                }
+            }
+
+            /* Whether the last announced update of the device says the same */
+            bool isAnnounced(const Device& device, bool discovered)
+            {
+                auto it = mAnnounced.find(device.deviceID);
+                if (it == mAnnounced.end())
+                {
+                    // a device lost before it was ever announced is not news
+                    return !discovered;
+                }
+                return it->second.discovered == discovered &&
+                    (!discovered || sameDiscoveryUpdate(it->second.device, device));
+            }
+
+            /* The fields of an onDiscoveredDevice event */
+            static bool sameDiscoveryUpdate(const Device& a, const Device& b)
+            {
+                return a.name == b.name && a.deviceType == b.deviceType && a.rawDeviceType == b.rawDeviceType &&
+                    a.lastConnected == b.lastConnected && a.paired == b.paired;
+            }
+
+            static bool sameDevice(const Device& a, const Device& b)
+            {
+                return sameDiscoveryUpdate(a, b) && a.connected == b.connected && a.powerStatus == b.powerStatus;
+            }
+
+            static bool sameRecords(const std::map<uint64_t, Record>& a, const std::map<uint64_t, Record>& b)
+            {
+                if (a.size() != b.size())
+                {
+                    return false;
+                }
+                for (auto ia = a.begin(), ib = b.begin(); ia != a.end(); ++ia, ++ib)
+                {
+                    if (ia->first != ib->first || ia->second.present != ib->second.present ||
+                        (ia->second.present && !sameDevice(ia->second.device, ib->second.device)))
+                    {
+                        return false;
+                    }
+                }
+                return true;
+            }
+
+            std::mutex mMutex;
+            Loader mLoader;
+            uint64_t mSequence;
+            uint64_t mGeneration;
+            bool mLoaded[LIST_COUNT];
+            std::map<uint64_t, Record> mDevices[LIST_COUNT];
+            std::map<uint64_t, DiscoveryUpdate> mPending;
+            std::map<uint64_t, DiscoveryUpdate> mAnnounced;
+        };
+
+    } // namespace Plugin
+} // namespace WPEFramework
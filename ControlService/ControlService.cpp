@@ -67,6 +67,9 @@ namespace WPEFramework {
         ControlService::ControlService()
             : AbstractPlugin()
             , m_apiVersionNumber((uint32_t)-1)   /* default max uint32_t so everything gets enabled */    //TODO(MROLLINS) Can't we access this from jsonrpc interface?
+            , m_statusCache(std::bind(&ControlService::fetchRf4ceNetworkStatus, this, std::placeholders::_1),
+                            std::bind(&ControlService::fetchControllerStatus, this, std::placeholders::_2),
+                            std::chrono::seconds(60))
         {
             LOGINFO("ctor");
             ControlService::_instance = this;
@@ -99,8 +102,12 @@ namespace WPEFramework {
 
         }
 
-        const string ControlService::Initialize(PluginHost::IShell* /* service */)
+        const string ControlService::Initialize(PluginHost::IShell* service)
         {
+            Config config;
+            config.FromString(service->ConfigLine());
+            m_statusCache.setMaxAge(std::chrono::seconds(config.StatusCacheMaxAge.Value()));
+
             InitializeIARM();
             // On success return empty, to indicate there is no error text.
             return (string());
@@ -109,6 +116,7 @@ namespace WPEFramework {
         void ControlService::Deinitialize(PluginHost::IShell* /* service */)
         {
             DeinitializeIARM();
+            m_statusCache.invalidate();
             ControlService::_instance = nullptr;
         }
 
@@ -197,6 +205,8 @@ namespace WPEFramework {
                          (eventId == CTRLM_RCU_IARM_EVENT_VALIDATION_END) ||
                          (eventId == CTRLM_RCU_IARM_EVENT_CONFIGURATION_COMPLETE))
                 {
+                    // The bound remotes are changing
+                    m_statusCache.invalidate();
                     pairingHandler(owner, eventId, data, len);
                 }
                 else
@@ -225,6 +235,12 @@ namespace WPEFramework {
                     return;
                 }
 
+                // The remote's last key time and link quality changed
+                if (keySrc == IARM_BUS_IRMGR_KEYSRC_RF)
+                {
+                    m_statusCache.invalidateController(remoteId);
+                }
+
                 if (len != sizeof(IARM_Bus_IRMgr_EventData_t)) {
                     LOGERR("ERROR - Got IARM_BUS_IRMGR_EVENT_IRKEY event with bad data length: %u, should be: %u!!",
                            len, sizeof(IARM_Bus_IRMgr_EventData_t));
@@ -261,6 +277,7 @@ namespace WPEFramework {
                     ctrlm_rcu_iarm_event_key_ghost_t *msg = (ctrlm_rcu_iarm_event_key_ghost_t*)data;
                     int remoteId = msg->controller_id;
                     int ghostCode = msg->ghost_code;
+                    m_statusCache.invalidateController(remoteId);
 
                     string source   = "RF";
                     string type     = "ghost";
@@ -321,6 +338,7 @@ namespace WPEFramework {
                     {
                         int remoteId = msg->controller_id;
                         int value = msg->battery_event;
+                        m_statusCache.invalidateController(remoteId);
 
                         string source   = "RF";
                         string type     = "battery";
@@ -359,6 +377,7 @@ namespace WPEFramework {
                     {
                         int remoteId = msg->controller_id;
                         int value = msg->reason;
+                        m_statusCache.invalidateController(remoteId);
 
                         string source   = "RF";
                         string type     = "remoteReboot";
@@ -450,6 +469,7 @@ namespace WPEFramework {
                    ctrlm_rcu_iarm_event_control_t *msg = (ctrlm_rcu_iarm_event_control_t*)data;
                    int remoteId     = msg->controller_id;
                    int value        = msg->event_value;
+                   m_statusCache.invalidateController(remoteId);
                    int spare_value  = msg->spare_value;
                    string source    = msg->event_source;
                    string type      = msg->event_type;
@@ -1141,25 +1161,25 @@ namespace WPEFramework {
         StatusCode ControlService::getSingleRemoteData(JsonObject& remoteInfo, int remoteId)
         {
             ctrlm_rcu_iarm_call_controller_status_t ctrlStatus;
-            ctrlm_network_id_t                      rf4ceId = CTRLM_MAIN_NETWORK_ID_INVALID;
+            ctrlm_main_iarm_call_network_status_t   netStatus;
 
             // Start by finding the network_id of the rf4ce network on this STB.
-            if (!getRf4ceNetworkId(rf4ceId))
+            if (!getRf4ceNetworkStatus(netStatus))
             {
                 LOGERR("ERROR - No RF4CE network_id found!!");
                 return STATUS_INVALID_STATE;
             }
             else
             {
-                LOGINFO("Found rf4ce network_id: %d.", (int)rf4ceId);
+                LOGINFO("Found rf4ce network_id: %d.", (int)netStatus.network_id);
             }
 
             memset((void*)&ctrlStatus, 0, sizeof(ctrlStatus));
             ctrlStatus.api_revision = CTRLM_RCU_IARM_BUS_API_REVISION;
-            ctrlStatus.network_id = rf4ceId;
+            ctrlStatus.network_id = netStatus.network_id;
             ctrlStatus.controller_id = remoteId;
 
-            if (!getRf4ceBindRemote(remoteInfo, ctrlStatus))
+            if (!m_statusCache.controller(remoteId, ctrlStatus) || !getRf4ceBindRemote(remoteInfo, ctrlStatus))
             {
                 LOGERR("ERROR - remoteInfo not found for remoteId %d!!", remoteId);
                 return STATUS_INVALID_ARGUMENT;
@@ -1818,6 +1838,11 @@ namespace WPEFramework {
         }
 
         bool ControlService::getRf4ceNetworkStatus(ctrlm_main_iarm_call_network_status_t&  netStatus)
+        {
+            return m_statusCache.network(netStatus);
+        }
+
+        bool ControlService::fetchRf4ceNetworkStatus(ctrlm_main_iarm_call_network_status_t&  netStatus)
         {
             ctrlm_network_id_t              rf4ceId;
             IARM_Result_t                   res;
@@ -1854,6 +1879,28 @@ namespace WPEFramework {
             return true;
         }
 
+        // ctrlStatus comes in with the network_id and controller_id to get the status of
+        bool ControlService::fetchControllerStatus(ctrlm_rcu_iarm_call_controller_status_t& ctrlStatus)
+        {
+            IARM_Result_t   res;
+
+            res = IARM_Bus_Call(CTRLM_MAIN_IARM_BUS_NAME, CTRLM_RCU_IARM_CALL_CONTROLLER_STATUS, (void*)&ctrlStatus, sizeof(ctrlStatus));
+            if (res != IARM_RESULT_SUCCESS)
+            {
+                LOGERR("ERROR - CONTROLLER_STATUS IARM_Bus_Call FAILED, res: %d, controller_id: %d",
+                       (int)res, (int)ctrlStatus.controller_id);
+                return false;
+            }
+            else if (ctrlStatus.result != CTRLM_IARM_CALL_RESULT_SUCCESS)
+            {
+                LOGERR("ERROR - CONTROLLER_STATUS FAILED, call_result: %d, controller_id: %d",
+                       (int)ctrlStatus.result, (int)ctrlStatus.controller_id);
+                return false;
+            }
+
+            return true;
+        }
+
         bool ControlService::getRf4ceStbData(JsonObject& stbData)
         {
             ctrlm_main_iarm_call_network_status_t   netStatus;
@@ -2126,7 +2173,8 @@ namespace WPEFramework {
                 ctrlStatus.network_id = netStatus.network_id;
                 ctrlStatus.controller_id = netStatus.status.rf4ce.controllers[i];
 
-                if (!getRf4ceBindRemote(m_remoteInfo[i], ctrlStatus))
+                if (!m_statusCache.controller(ctrlStatus.controller_id, ctrlStatus) ||
+                    !getRf4ceBindRemote(m_remoteInfo[i], ctrlStatus))
                 {
                     LOGERR("ERROR - controller_status for remoteId %d NOT found!", (int)ctrlStatus.controller_id);
                     return false;
@@ -2143,7 +2191,6 @@ namespace WPEFramework {
             ctrlm_main_iarm_call_network_status_t   netStatus;
             ctrlm_rcu_iarm_call_controller_status_t ctrlStatus;
             ctrlm_rcu_iarm_call_controller_status_t ctrlStatusLastPaired;
-            IARM_Result_t                           res;
             unsigned long                           pairingTime = 0;
 
             // Get the status of all the paired remotes on the rf4ce network.
@@ -2176,29 +2223,17 @@ namespace WPEFramework {
                 ctrlStatus.network_id = netStatus.network_id;
                 ctrlStatus.controller_id = netStatus.status.rf4ce.controllers[i];
 
-                res = IARM_Bus_Call(CTRLM_MAIN_IARM_BUS_NAME, CTRLM_RCU_IARM_CALL_CONTROLLER_STATUS, (void*)&ctrlStatus, sizeof(ctrlStatus));
-                if (res != IARM_RESULT_SUCCESS)
+                if (!m_statusCache.controller(ctrlStatus.controller_id, ctrlStatus))
                 {
-                    LOGERR("ERROR - CONTROLLER_STATUS IARM_Bus_Call FAILED, res: %d, controller_id: %d",
-                           (int)res, (int)ctrlStatus.controller_id);
                     return false;
                 }
                 else
                 {
-                    if (ctrlStatus.result != CTRLM_IARM_CALL_RESULT_SUCCESS)
+                    // Determine which controller_status has the most recent time_binding, and save it.
+                    if (pairingTime < ctrlStatus.status.time_binding)
                     {
-                        LOGERR("ERROR - CONTROLLER_STATUS FAILED, call_result: %d, controller_id: %d",
-                               (int)ctrlStatus.result, (int)ctrlStatus.controller_id);
-                        return false;
-                    }
-                    else
-                    {
-                        // Determine which controller_status has the most recent time_binding, and save it.
-                        if (pairingTime < ctrlStatus.status.time_binding)
-                        {
-                            pairingTime = ctrlStatus.status.time_binding;
-                            ctrlStatusLastPaired = ctrlStatus;
-                        }
+                        pairingTime = ctrlStatus.status.time_binding;
+                        ctrlStatusLastPaired = ctrlStatus;
                     }
                 }
             }
@@ -27,6 +27,7 @@
 #include "ctrlm_ipc.h"
 #include "ctrlm_ipc_rcu.h"
 #include "ctrlm_ipc_key_codes.h"
+#include "RemoteStatusCache.h"
 
 #include <mutex>
 
@@ -93,6 +94,24 @@ namespace WPEFramework {
             typedef Core::JSON::ArrayType<JsonObject> JObjectArray;
             typedef Core::JSON::Boolean JBool;
 
+            class Config : public Core::JSON::Container {
+            private:
+                Config(const Config&) = delete;
+                Config& operator=(const Config&) = delete;
+
+            public:
+                Config()
+                    : Core::JSON::Container()
+                    , StatusCacheMaxAge(60)
+                {
+                    Add(_T("statuscachemaxage"), &StatusCacheMaxAge);
+                }
+
+            public:
+                // Seconds a network or remote status got from ControlMgr is reused, 0 always asks again
+                Core::JSON::DecUInt32 StatusCacheMaxAge;
+            };
+
             // We do not allow this plugin to be copied !!
             ControlService(const ControlService&) = delete;
             ControlService& operator=(const ControlService&) = delete;
@@ -163,6 +182,8 @@ namespace WPEFramework {
 
             bool getRf4ceNetworkId(ctrlm_network_id_t& rf4ceId);
             bool getRf4ceNetworkStatus(ctrlm_main_iarm_call_network_status_t&  netStatus);
+            bool fetchRf4ceNetworkStatus(ctrlm_main_iarm_call_network_status_t&  netStatus);
+            bool fetchControllerStatus(ctrlm_rcu_iarm_call_controller_status_t& ctrlStatus);
 
             bool getRf4ceStbData(JsonObject& stbData);
             bool getRf4ceBindRemote(JsonObject& remoteInfo, ctrlm_rcu_iarm_call_controller_status_t& ctrlStatus);
@@ -174,6 +195,9 @@ namespace WPEFramework {
         private:
             uint32_t    m_apiVersionNumber;
 
+            // Network and remote status, dropped by the ControlMgr events that change them
+            RemoteStatusCache<ctrlm_main_iarm_call_network_status_t, ctrlm_rcu_iarm_call_controller_status_t> m_statusCache;
+
             JsonObject  m_remoteInfo[CTRLM_MAIN_MAX_BOUND_CONTROLLERS];
             int         m_numOfBindRemotes;
 
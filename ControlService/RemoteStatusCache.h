@@ -0,0 +1,188 @@
+/**
+* If not stated otherwise in this file or this component's LICENSE
+* file the following copyright and licenses apply:
+*
+* Copyright 2019 RDK Management
+*
+* Licensed under the Apache License, Version 2.0 (the "License");
+* you may not use this file except in compliance with the License.
+* You may obtain a copy of the License at
+*
+* http://www.apache.org/licenses/LICENSE-2.0
+*
+* Unless required by applicable law or agreed to in writing, software
+* distributed under the License is distributed on an "AS IS" BASIS,
+* WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+* See the License for the specific language governing permissions and
+* limitations under the License.
+**/
+
+#pragma once
+
+#include <stdint.h>
+#include <chrono>
+#include <functional>
+#include <map>
+#include <mutex>
+
+namespace WPEFramework {
+
+    namespace Plugin {
+
+        // Last RF4CE network status and controller status got from ControlMgr,
+        // so that getAllRemoteData and friends do not need a STATUS_GET, a
+        // NETWORK_STATUS_GET and a CONTROLLER_STATUS per bound remote on every
+        // call. Entries are dropped by the ControlMgr events that change them
+        // (pairing, battery, reboot, key presses of a remote) and expire after
+        // maxAge for the counters ControlMgr updates without an event.
+        template <typename NETWORK_STATUS, typename CONTROLLER_STATUS>
+        class RemoteStatusCache
+        {
+        public:
+            typedef std::function<bool(NETWORK_STATUS&)> NetworkFetcher;
+            typedef std::function<bool(int controllerId, CONTROLLER_STATUS&)> ControllerFetcher;
+            typedef std::chrono::steady_clock Clock;
+
+            struct Statistics
+            {
+                uint32_t hits;
+                uint32_t fetches;
+            };
+
+            RemoteStatusCache(const NetworkFetcher& networkFetcher, const ControllerFetcher& controllerFetcher,
+                              std::chrono::milliseconds maxAge)
+                : mNetworkFetcher(networkFetcher)
+                , mControllerFetcher(controllerFetcher)
+                , mMaxAge(maxAge)
+                , mEpoch(0)
+                , mNetworkValid(false)
+                , mStatistics()
+            {
+            }
+
+            RemoteStatusCache(const RemoteStatusCache&) = delete;
+            RemoteStatusCache& operator=(const RemoteStatusCache&) = delete;
+
+            void setMaxAge(std::chrono::milliseconds maxAge)
+            {
+                std::lock_guard<std::mutex> lock(mMutex);
+                mMaxAge = maxAge;
+            }
+
+            bool network(NETWORK_STATUS& status)
+            {
+                uint64_t epoch;
+                {
+                    std::lock_guard<std::mutex> lock(mMutex);
+                    if (mNetworkValid && isFresh(mNetworkTime))
+                    {
+                        status = mNetwork;
+                        mStatistics.hits++;
+                        return true;
+                    }
+                    epoch = mEpoch;
+                    mStatistics.fetches++;
+                }
+
+                // The fetchers do IARM calls, do not hold the lock meanwhile.
+                if (!mNetworkFetcher(status))
+                {
+                    return false;
+                }
+
+                std::lock_guard<std::mutex> lock(mMutex);
+                // Invalidated while fetching: the answer may predate the event
+                if (epoch == mEpoch)
+                {
+                    mNetwork = status;
+                    mNetworkTime = Clock::now();
+                    mNetworkValid = true;
+                }
+                return true;
+            }
+
+            bool controller(int controllerId, CONTROLLER_STATUS& status)
+            {
+                uint64_t epoch;
+                {
+                    std::lock_guard<std::mutex> lock(mMutex);
+                    auto it = mControllers.find(controllerId);
+                    if (it != mControllers.end() && isFresh(it->second.time))
+                    {
+                        status = it->second.status;
+                        mStatistics.hits++;
+                        return true;
+                    }
+                    epoch = mEpoch;
+                    mStatistics.fetches++;
+                }
+
+                // status comes in with what the fetcher needs to ask for the
+                // controller, e.g. the api revision and network id of the call
+                if (!mControllerFetcher(controllerId, status))
+                {
+                    return false;
+                }
+
+                std::lock_guard<std::mutex> lock(mMutex);
+                if (epoch == mEpoch)
+                {
+                    Entry& entry = mControllers[controllerId];
+                    entry.status = status;
+                    entry.time = Clock::now();
+                }
+                return true;
+            }
+
+            // A remote reported a change of its own status
+            void invalidateController(int controllerId)
+            {
+                std::lock_guard<std::mutex> lock(mMutex);
+                mControllers.erase(controllerId);
+                mEpoch++;
+            }
+
+            // Remotes were paired or unpaired
+            void invalidate()
+            {
+                std::lock_guard<std::mutex> lock(mMutex);
+                mControllers.clear();
+                mNetworkValid = false;
+                mEpoch++;
+            }
+
+            Statistics statistics()
+            {
+                std::lock_guard<std::mutex> lock(mMutex);
+                return mStatistics;
+            }
+
+        private:
+            struct Entry
+            {
+                CONTROLLER_STATUS status;
+                Clock::time_point time;
+            };
+
+            bool isFresh(const Clock::time_point& time) const
+            {
+                return (Clock::now() - time) < mMaxAge;
+            }
+
+            std::mutex mMutex;
+            NetworkFetcher mNetworkFetcher;
+            ControllerFetcher mControllerFetcher;
+            std::chrono::milliseconds mMaxAge;
+            /* Bumped by every invalidation, a fetch that overlaps one is not cached */
+            uint64_t mEpoch;
+
+            bool mNetworkValid;
+            NETWORK_STATUS mNetwork;
+            Clock::time_point mNetworkTime;
+            std::map<int, Entry> mControllers;
+
+            Statistics mStatistics;
+        };
+
+    } // namespace Plugin
+} // namespace WPEFramework
@@ -551,8 +551,15 @@ namespace WPEFramework
       {
          switch (event)
          {
-            case STB_EVENT_SEARCH_FAIL:
             case STB_EVENT_SEARCH_SUCCESS:
+            {
+               // The service lineup may have changed, cached schedules are reloaded on demand
+               DTV::instance()->_epgCache.Clear();
+               DTV::instance()->NotifySearchStatus();
+               break;
+            }
+
+            case STB_EVENT_SEARCH_FAIL:
             case UI_EVENT_UPDATE:
             {
                //STB_SPDebugWrite("DTV::DvbEventHandler: event=0x%08x\n", event);
@@ -560,6 +567,16 @@ namespace WPEFramework
                break;
             }
 
+            case APP_EVENT_SERVICE_EIT_SCHED_UPDATE:
+            {
+               // The event data is the handle of the service whose schedule has changed
+               if ((event_data != NULL) && (data_size == sizeof(void *)))
+               {
+                  DTV::instance()->LoadEpgSchedule(*(void **)event_data);
+               }
+               break;
+            }
+
             default:
             {
                //STB_SPDebugWrite("DTV::DvbEventHandler: Unhandled event=0x%08x\n", event);
@@ -20,6 +20,7 @@
 #pragma once
 
 #include "Module.h"
+#include "EpgCache.h"
 #include <interfaces/json/JsonData_DTV.h>
 
 extern "C"
@@ -132,6 +133,107 @@ namespace WPEFramework
                   Core::JSON::ArrayType<ServiceData> ServiceList;
             };
 
+            class ScheduleWindowParamsData: public Core::JSON::Container
+            {
+               private:
+                  ScheduleWindowParamsData(const ScheduleWindowParamsData&) = delete;
+                  ScheduleWindowParamsData& operator=(const ScheduleWindowParamsData&) = delete;
+
+               public:
+                  ScheduleWindowParamsData() : Core::JSON::Container(), Starttime(0), Endtime(0xffffffff),
+                     Offset(0), Count(0xffffffff)
+                  {
+                     Add(_T("services"), &Services);
+                     Add(_T("starttime"), &Starttime);
+                     Add(_T("endtime"), &Endtime);
+                     Add(_T("offset"), &Offset);
+                     Add(_T("count"), &Count);
+                  }
+
+                  ~ScheduleWindowParamsData()
+                  {
+                  }
+
+               public:
+                  Core::JSON::ArrayType<Core::JSON::String> Services; // Service URIs, all cached services when empty
+                  Core::JSON::DecUInt32 Starttime;
+                  Core::JSON::DecUInt32 Endtime;
+                  Core::JSON::DecUInt32 Offset;
+                  Core::JSON::DecUInt32 Count;
+            };
+
+            class ScheduleWindowEventData: public Core::JSON::Container
+            {
+               public:
+                  ScheduleWindowEventData() : Core::JSON::Container()
+                  {
+                     _Init();
+                  }
+
+                  ScheduleWindowEventData(const ScheduleWindowEventData& _other) : Core::JSON::Container(),
+                     Dvburi(_other.Dvburi), Name(_other.Name), Starttime(_other.Starttime),
+                     Duration(_other.Duration), Eventid(_other.Eventid), Shortdescription(_other.Shortdescription)
+                  {
+                     _Init();
+                  }
+
+                  ScheduleWindowEventData& operator=(const ScheduleWindowEventData& _rhs)
+                  {
+                     Dvburi = _rhs.Dvburi;
+                     Name = _rhs.Name;
+                     Starttime = _rhs.Starttime;
+                     Duration = _rhs.Duration;
+                     Eventid = _rhs.Eventid;
+                     Shortdescription = _rhs.Shortdescription;
+                     return (*this);
+                  }
+
+                  ~ScheduleWindowEventData()
+                  {
+                  }
+
+               private:
+                  void _Init()
+                  {
+                     Add(_T("dvburi"), &Dvburi);
+                     Add(_T("name"), &Name);
+                     Add(_T("starttime"), &Starttime);
+                     Add(_T("duration"), &Duration);
+                     Add(_T("eventid"), &Eventid);
+                     Add(_T("shortdescription"), &Shortdescription);
+                  }
+
+               public:
+                  Core::JSON::String Dvburi;
+                  Core::JSON::String Name;
+                  Core::JSON::DecUInt32 Starttime;
+                  Core::JSON::DecUInt32 Duration;
+                  Core::JSON::DecUInt16 Eventid;
+                  Core::JSON::String Shortdescription;
+            };
+
+            class ScheduleWindowData: public Core::JSON::Container
+            {
+               private:
+                  ScheduleWindowData(const ScheduleWindowData&) = delete;
+                  ScheduleWindowData& operator=(const ScheduleWindowData&) = delete;
+
+               public:
+                  ScheduleWindowData() : Core::JSON::Container(), Total(0)
+                  {
+                     Add(_T("total"), &Total);
+                     Add(_T("events"), &Events);
+                  }
+
+                  ~ScheduleWindowData()
+                  {
+                  }
+
+               public:
+                  Core::JSON::DecUInt32 Total;
+                  Core::JSON::ArrayType<ScheduleWindowEventData> Events;
+            };
+
          public:
             DTV() : _skipURL(0), _service(nullptr), _connectionId(0), _dtv(nullptr), _notification(this)
             {
@@ -192,6 +294,7 @@ namespace WPEFramework
             uint32_t GetServiceList(const string& tuner_type, Core::JSON::ArrayType<ServiceData>& response) const;
             uint32_t GetNowNextEvents(const string& service_uri, NowNextEventsData& response) const;
             uint32_t GetScheduleEvents(const string& index, Core::JSON::ArrayType<EiteventInfo>& response) const;
+            uint32_t GetScheduleWindow(const ScheduleWindowParamsData& params, ScheduleWindowData& response) const;
             uint32_t GetStatus(const string& index, StatusData& response) const;
 
             uint32_t AddLnb(const LnbsettingsInfo& lnb_settings, Core::JSON::Boolean& response);
@@ -218,6 +321,7 @@ namespace WPEFramework
             Core::IUnknown *_dtv;
             PluginHost::IShell *_service;
             Core::Sink<Notification> _notification;
+            mutable EpgCache _epgCache;
 
          private:
             static void DvbEventHandler(U32BIT event, void *event_data, U32BIT data_size);
@@ -241,6 +345,8 @@ namespace WPEFramework
             void* FindSatellite(const char *satellite_name) const;
 
             void ExtractDvbEventInfo(void *src_event, EiteventInfo& dest_event) const;
+            bool LoadEpgSchedule(void *service) const;
+            bool LoadEpgSchedule(EpgCache::ServiceKey key) const;
             void SetJsonString(U8BIT *src_string, Core::JSON::String& out_string, bool free_src = false) const;
       };
    }
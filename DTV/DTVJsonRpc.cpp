@@ -62,6 +62,7 @@ namespace WPEFramework
          JSONRPC::Register<FinishServiceSearchParamsData, Core::JSON::Boolean>(_T("finishServiceSearch"), &DTV::FinishServiceSearch, this);
          JSONRPC::Register<StartPlayingParamsData, Core::JSON::DecSInt32>(_T("startPlaying"), &DTV::StartPlaying, this);
          JSONRPC::Register<Core::JSON::DecSInt32, void>(_T("stopPlaying"), &DTV::StopPlaying, this);
+         JSONRPC::Register<ScheduleWindowParamsData, ScheduleWindowData>(_T("getScheduleWindow"), &DTV::GetScheduleWindow, this);
       }
 
       void DTV::UnregisterAll()
@@ -85,6 +86,7 @@ namespace WPEFramework
          JSONRPC::Unregister(_T("finishServiceSearch"));
          JSONRPC::Unregister(_T("startPlaying"));
          JSONRPC::Unregister(_T("stopPlaying"));
+         JSONRPC::Unregister(_T("getScheduleWindow"));
       }
 
       // API implementation
@@ -397,35 +399,22 @@ namespace WPEFramework
 
             if (num_args >= 3)
             {
-               void *service = ADB_FindServiceByIds(onet_id, trans_id, serv_id);
-               if (service != NULL)
+               EpgCache::ServiceKey key = EpgCache::Key(onet_id, trans_id, serv_id);
+               std::vector<EpgCache::Event> events;
+
+               if (_epgCache.Events(key, start_utc, end_utc, events) ||
+                  (LoadEpgSchedule(key) && _epgCache.Events(key, start_utc, end_utc, events)))
                {
-                  void **event_list;
-                  U16BIT num_events;
+                  EiteventInfo event;
 
-                  ADB_GetEventSchedule(FALSE, service, &event_list, &num_events);
-                  if (event_list != NULL)
+                  for (const EpgCache::Event& cached : events)
                   {
-                     U32BIT start_time;
-                     EiteventInfo event;
-
-                     for (U16BIT i = 0; i < num_events; i++)
-                     {
-                        start_time = STB_GCConvertToTimestamp(ADB_GetEventStartDateTime(event_list[i]));
-                        if ((start_time >= start_utc) && (start_time <= end_utc))
-                        {
-                           ExtractDvbEventInfo(event_list[i], event);
-                           response.Add(event);
-                        }
-                        else if (start_time > end_utc)
-                        {
-                           /* Events are provided in increasing date/time order so all events after
-                            * this will be outside of the requested window and don't need to be checked */
-                           break;
-                        }
-                     }
-
-                     ADB_ReleaseEventList(event_list, num_events);
+                     event.Name = cached.name;
+                     event.Shortdescription = cached.shortDescription;
+                     event.Starttime = cached.startTime;
+                     event.Duration = cached.duration;
+                     event.Eventid = cached.eventId;
+                     response.Add(event);
                   }
 
                   result = Core::ERROR_NONE;
@@ -436,6 +425,94 @@ namespace WPEFramework
          return (result);
       }
 
+      // Method: getScheduleWindow - get the schedule EIT events starting in the given time window
+      //                             for a list of services given as URIs, or for all services if
+      //                             the list is empty. Results are ordered by service and start time
+      //                             and can be paged with offset and count.
+      // Return codes:
+      //  - ERROR_NONE: Success
+      //  - ERROR_BAD_REQUEST: A service URI is malformed
+      uint32_t DTV::GetScheduleWindow(const ScheduleWindowParamsData& params, ScheduleWindowData& response) const
+      {
+         std::vector<EpgCache::ServiceKey> services;
+
+         SYSLOG(Logging::Notification, (_T("DTV::GetScheduleWindow: %u-%u offset %u count %u"),
+            params.Starttime.Value(), params.Endtime.Value(), params.Offset.Value(), params.Count.Value()));
+
+         if (params.Services.Length() != 0)
+         {
+            auto uris(params.Services.Elements());
+
+            while (uris.Next() == true)
+            {
+               U16BIT onet_id, trans_id, serv_id;
+
+               if (std::sscanf(uris.Current().Value().c_str(), "%hu.%hu.%hu", &onet_id, &trans_id, &serv_id) != 3)
+               {
+                  return (Core::ERROR_BAD_REQUEST);
+               }
+
+               EpgCache::ServiceKey key = EpgCache::Key(onet_id, trans_id, serv_id);
+               if (_epgCache.Contains(key) || LoadEpgSchedule(key))
+               {
+                  services.push_back(key);
+               }
+            }
+         }
+         else
+         {
+            U16BIT num_services;
+            void **slist;
+
+            ADB_GetServiceList(ADB_SERVICE_LIST_DIGITAL, &slist, &num_services);
+
+            if (slist != NULL)
+            {
+               U16BIT onet_id, trans_id, serv_id;
+
+               for (U16BIT index = 0; index < num_services; index++)
+               {
+                  ADB_GetServiceIds(slist[index], &onet_id, &trans_id, &serv_id);
+
+                  EpgCache::ServiceKey key = EpgCache::Key(onet_id, trans_id, serv_id);
+                  if (_epgCache.Contains(key) || LoadEpgSchedule(slist[index]))
+                  {
+                     services.push_back(key);
+                  }
+               }
+
+               ADB_ReleaseServiceList(slist, num_services);
+            }
+         }
+
+         std::vector<EpgCache::ServiceEvent> events;
+
+         if (services.empty() == false)
+         {
+            response.Total = _epgCache.Window(services, params.Starttime.Value(), params.Endtime.Value(),
+               params.Offset.Value(), params.Count.Value(), events);
+         }
+         else
+         {
+            response.Total = 0;
+         }
+
+         ScheduleWindowEventData event;
+
+         for (const EpgCache::ServiceEvent& cached : events)
+         {
+            event.Dvburi = EpgCache::Uri(cached.first);
+            event.Name = cached.second.name;
+            event.Shortdescription = cached.second.shortDescription;
+            event.Starttime = cached.second.startTime;
+            event.Duration = cached.second.duration;
+            event.Eventid = cached.second.eventId;
+            response.Events.Add(event);
+         }
+
+         return (Core::ERROR_NONE);
+      }
+
       // Property: status - get the status for the given decode path
       // Return codes:
       //  - ERROR_NONE: Success
@@ -1088,6 +1165,54 @@ namespace WPEFramework
          dest_event.Eventid = ADB_GetEventId(src_event);
       }
 
+      // Reads the EIT schedule of a service from the DVB database into the EPG cache
+      bool DTV::LoadEpgSchedule(void *service) const
+      {
+         U16BIT onet_id, trans_id, serv_id;
+         void **event_list;
+         U16BIT num_events = 0;
+         std::vector<EpgCache::Event> events;
+
+         if (service == NULL)
+         {
+            return (false);
+         }
+
+         ADB_GetServiceIds(service, &onet_id, &trans_id, &serv_id);
+         ADB_GetEventSchedule(FALSE, service, &event_list, &num_events);
+
+         if (event_list != NULL)
+         {
+            EiteventInfo event;
+
+            events.reserve(num_events);
+
+            for (U16BIT i = 0; i < num_events; i++)
+            {
+               ExtractDvbEventInfo(event_list[i], event);
+
+               EpgCache::Event cached;
+               cached.eventId = event.Eventid.Value();
+               cached.startTime = event.Starttime.Value();
+               cached.duration = event.Duration.Value();
+               cached.name = event.Name.Value();
+               cached.shortDescription = event.Shortdescription.Value();
+               events.push_back(std::move(cached));
+            }
+
+            ADB_ReleaseEventList(event_list, num_events);
+         }
+
+         _epgCache.Update(EpgCache::Key(onet_id, trans_id, serv_id), std::move(events));
+
+         return (true);
+      }
+
+      bool DTV::LoadEpgSchedule(EpgCache::ServiceKey key) const
+      {
+         return (LoadEpgSchedule(ADB_FindServiceByIds((key >> 32) & 0xffff, (key >> 16) & 0xffff, key & 0xffff)));
+      }
+
       void DTV::SetJsonString(U8BIT *src_string, Core::JSON::String& out_string, bool free_src) const
       {
          if (src_string != NULL)
@@ -0,0 +1,183 @@
+/*
+ * If not stated otherwise in this file or this component's LICENSE file the
+ * following copyright and licenses apply:
+ *
+ * Copyright 2020 RDK Management
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#pragma once
+
+#include <stdint.h>
+#include <algorithm>
+#include <map>
+#include <mutex>
+#include <string>
+#include <utility>
+#include <vector>
+
+namespace WPEFramework
+{
+   namespace Plugin
+   {
+      // Copy of the EIT schedule of each service, kept sorted by start time so a
+      // time window is found with two binary searches instead of walking and
+      // converting the whole DVB event list on every request.
+      class EpgCache
+      {
+         public:
+            struct Event
+            {
+               uint16_t eventId;
+               uint32_t startTime;
+               uint32_t duration;
+               std::string name;
+               std::string shortDescription;
+            };
+
+            typedef uint64_t ServiceKey;
+            typedef std::pair<ServiceKey, Event> ServiceEvent;
+
+         public:
+            EpgCache(const EpgCache&) = delete;
+            EpgCache& operator=(const EpgCache&) = delete;
+
+            EpgCache()
+            {
+            }
+
+            ~EpgCache()
+            {
+            }
+
+            static ServiceKey Key(uint16_t onet_id, uint16_t trans_id, uint16_t serv_id)
+            {
+               return ((static_cast<ServiceKey>(onet_id) << 32) | (static_cast<ServiceKey>(trans_id) << 16) | serv_id);
+            }
+
+            static std::string Uri(ServiceKey key)
+            {
+               return (std::to_string((key >> 32) & 0xffff) + "." + std::to_string((key >> 16) & 0xffff) +
+                  "." + std::to_string(key & 0xffff));
+            }
+
+            // Replaces the schedule of a service
+            void Update(ServiceKey service, std::vector<Event>&& events)
+            {
+               std::sort(events.begin(), events.end(), [](const Event& a, const Event& b) {
+                  return (a.startTime < b.startTime);
+               });
+
+               std::lock_guard<std::mutex> lock(_lock);
+               _schedules[service] = std::move(events);
+            }
+
+            void Remove(ServiceKey service)
+            {
+               std::lock_guard<std::mutex> lock(_lock);
+               _schedules.erase(service);
+            }
+
+            void Clear()
+            {
+               std::lock_guard<std::mutex> lock(_lock);
+               _schedules.clear();
+            }
+
+            bool Contains(ServiceKey service) const
+            {
+               std::lock_guard<std::mutex> lock(_lock);
+               return (_schedules.find(service) != _schedules.end());
+            }
+
+            // Events of a service starting within [start_utc, end_utc].
+            // Returns false if the service is not cached.
+            bool Events(ServiceKey service, uint32_t start_utc, uint32_t end_utc, std::vector<Event>& events) const
+            {
+               std::lock_guard<std::mutex> lock(_lock);
+
+               auto schedule = _schedules.find(service);
+               if (schedule == _schedules.end())
+               {
+                  return (false);
+               }
+
+               auto range = Range(schedule->second, start_utc, end_utc);
+               events.insert(events.end(), range.first, range.second);
+               return (true);
+            }
+
+            // Events starting within [start_utc, end_utc] across the given services
+            // (all cached services when empty), ordered by service and then start
+            // time. Only count events from offset are returned; the result is the
+            // total number of matching events.
+            uint32_t Window(const std::vector<ServiceKey>& services, uint32_t start_utc, uint32_t end_utc,
+               uint32_t offset, uint32_t count, std::vector<ServiceEvent>& events) const
+            {
+               uint32_t total = 0;
+
+               std::lock_guard<std::mutex> lock(_lock);
+
+               auto collect = [&](ServiceKey key, const std::vector<Event>& schedule) {
+                  auto range = Range(schedule, start_utc, end_utc);
+                  uint32_t matches = static_cast<uint32_t>(range.second - range.first);
+
+                  for (uint32_t index = (offset > total) ? (offset - total) : 0;
+                     (index < matches) && (events.size() < count); index++)
+                  {
+                     events.emplace_back(key, *(range.first + index));
+                  }
+                  total += matches;
+               };
+
+               if (services.empty())
+               {
+                  for (const auto& schedule : _schedules)
+                  {
+                     collect(schedule.first, schedule.second);
+                  }
+               }
+               else
+               {
+                  for (ServiceKey key : services)
+                  {
+                     auto schedule = _schedules.find(key);
+                     if (schedule != _schedules.end())
+                     {
+                        collect(key, schedule->second);
+                     }
+                  }
+               }
+
+               return (total);
+            }
+
+         private:
+            typedef std::vector<Event>::const_iterator Iterator;
+
+            static std::pair<Iterator, Iterator> Range(const std::vector<Event>& schedule, uint32_t start_utc, uint32_t end_utc)
+            {
+               Iterator first = std::lower_bound(schedule.begin(), schedule.end(), start_utc,
+                  [](const Event& event, uint32_t time) { return (event.startTime < time); });
+               Iterator last = std::upper_bound(first, schedule.end(), end_utc,
+                  [](uint32_t time, const Event& event) { return (time < event.startTime); });
+               return (std::make_pair(first, last));
+            }
+
+         private:
+            mutable std::mutex _lock;
+            std::map<ServiceKey, std::vector<Event>> _schedules;
+      };
+   }
+}
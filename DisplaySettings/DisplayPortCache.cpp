@@ -0,0 +1,92 @@
+/**
+* If not stated otherwise in this file or this component's LICENSE
+* file the following copyright and licenses apply:
+*
+* Copyright 2019 RDK Management
+*
+* Licensed under the Apache License, Version 2.0 (the "License");
+* you may not use this file except in compliance with the License.
+* You may obtain a copy of the License at
+*
+* http://www.apache.org/licenses/LICENSE-2.0
+*
+* Unless required by applicable law or agreed to in writing, software
+* distributed under the License is distributed on an "AS IS" BASIS,
+* WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+* See the License for the specific language governing permissions and
+* limitations under the License.
+**/
+
+#include "Module.h"
+#include "DisplayPortCache.h"
+#include "host.hpp"
+#include "exception.hpp"
+#include "videoOutputPort.hpp"
+#include "videoOutputPortConfig.hpp"
+#include "videoResolution.hpp"
+#include "audioOutputPort.hpp"
+#include "utils.h"
+
+namespace WPEFramework {
+    namespace Plugin {
+
+        bool loadVideoPortsState(VideoPortsState& state)
+        {
+            try
+            {
+                state.defaultPort = device::Host::getInstance().getDefaultVideoPortName();
+                device::List<device::VideoOutputPort> vPorts = device::Host::getInstance().getVideoOutputPorts();
+                for (size_t i = 0; i < vPorts.size(); i++)
+                {
+                    device::VideoOutputPort &vPort = vPorts.at(i);
+                    VideoPortState port;
+                    port.name = vPort.getName();
+                    port.displayConnected = vPort.isDisplayConnected();
+                    port.tvResolutions = 0;
+                    try
+                    {
+                        port.resolution = vPort.getResolution().getName();
+                        const device::List<device::VideoResolution> resolutions = device::VideoOutputPortConfig::getInstance().getPortType(vPort.getType().getId()).getSupportedResolutions();
+                        for (size_t j = 0; j < resolutions.size(); j++)
+                            vectorSet(port.supportedResolutions, resolutions.at(j).getName());
+                        vPort.getSupportedTvResolutions(&port.tvResolutions);
+                    }
+                    catch(const device::Exception& err)
+                    {
+                        LOG_DEVICE_EXCEPTION1(port.name);
+                    }
+                    state.ports.push_back(port);
+                }
+            }
+            catch(const device::Exception& err)
+            {
+                LOG_DEVICE_EXCEPTION0();
+                return false;
+            }
+            return true;
+        }
+
+        bool loadAudioPortsState(AudioPortsState& state)
+        {
+            try
+            {
+                device::List<device::AudioOutputPort> aPorts = device::Host::getInstance().getAudioOutputPorts();
+                for (size_t i = 0; i < aPorts.size(); i++)
+                {
+                    device::AudioOutputPort &aPort = aPorts.at(i);
+                    AudioPortState port;
+                    port.name = aPort.getName();
+                    port.connected = aPort.isConnected();
+                    state.ports.push_back(port);
+                }
+            }
+            catch(const device::Exception& err)
+            {
+                LOG_DEVICE_EXCEPTION0();
+                return false;
+            }
+            return true;
+        }
+
+    } // namespace Plugin
+} // namespace WPEFramework
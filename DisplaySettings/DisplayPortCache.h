@@ -0,0 +1,157 @@
+/**
+* If not stated otherwise in this file or this component's LICENSE
+* file the following copyright and licenses apply:
+*
+* Copyright 2019 RDK Management
+*
+* Licensed under the Apache License, Version 2.0 (the "License");
+* you may not use this file except in compliance with the License.
+* You may obtain a copy of the License at
+*
+* http://www.apache.org/licenses/LICENSE-2.0
+*
+* Unless required by applicable law or agreed to in writing, software
+* distributed under the License is distributed on an "AS IS" BASIS,
+* WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+* See the License for the specific language governing permissions and
+* limitations under the License.
+**/
+
+#pragma once
+
+#include <stdint.h>
+#include <strings.h>
+#include <algorithm>
+#include <functional>
+#include <mutex>
+#include <string>
+#include <vector>
+
+namespace WPEFramework {
+    namespace Plugin {
+
+        // Value read from the DS manager once and served from memory until an
+        // IARM event invalidates it. Every invalidation bumps a generation, so a
+        // load that raced with an event is returned but not kept.
+        template <typename T>
+        class CachedValue {
+        public:
+            typedef std::function<bool(T&)> Loader;
+
+            explicit CachedValue(const Loader& loader)
+                : m_loader(loader)
+                , m_value()
+                , m_valid(false)
+                , m_generation(0)
+            {
+            }
+
+            CachedValue(const CachedValue&) = delete;
+            CachedValue& operator=(const CachedValue&) = delete;
+
+            bool get(T& value)
+            {
+                uint32_t generation;
+                {
+                    std::lock_guard<std::mutex> lock(m_mutex);
+                    if (m_valid) {
+                        value = m_value;
+                        return true;
+                    }
+                    generation = m_generation;
+                }
+
+                // The loader does IPC, do not hold the lock meanwhile.
+                T fresh = T();
+                if (!m_loader(fresh)) {
+                    return false;
+                }
+
+                {
+                    std::lock_guard<std::mutex> lock(m_mutex);
+                    if (generation == m_generation) {
+                        m_value = fresh;
+                        m_valid = true;
+                    }
+                }
+                value = fresh;
+                return true;
+            }
+
+            void invalidate()
+            {
+                std::lock_guard<std::mutex> lock(m_mutex);
+                m_valid = false;
+                m_generation++;
+            }
+
+            bool isValid()
+            {
+                std::lock_guard<std::mutex> lock(m_mutex);
+                return m_valid;
+            }
+
+        private:
+            std::mutex m_mutex;
+            Loader m_loader;
+            T m_value;
+            bool m_valid;
+            uint32_t m_generation;
+        };
+
+        struct VideoPortState {
+            std::string name;
+            bool displayConnected;
+            std::string resolution;
+            std::vector<std::string> supportedResolutions;
+            int tvResolutions;
+        };
+
+        struct VideoPortsState {
+            std::string defaultPort;
+            std::vector<VideoPortState> ports;
+
+            const VideoPortState* find(const std::string& name) const
+            {
+                for (const auto& port : ports) {
+                    if (port.name == name) {
+                        return &port;
+                    }
+                }
+                return nullptr;
+            }
+
+            // The ports with a display connected, only the HDMI one when it has
+            void connectedDisplays(std::vector<std::string>& displays) const
+            {
+                for (const auto& port : ports) {
+                    if (!port.displayConnected) {
+                        continue;
+                    }
+                    if (strncasecmp(port.name.c_str(), "hdmi", 4) == 0) {
+                        displays.clear();
+                        displays.emplace_back(port.name);
+                        break;
+                    }
+                    if (std::find(displays.begin(), displays.end(), port.name) == displays.end()) {
+                        displays.emplace_back(port.name);
+                    }
+                }
+            }
+        };
+
+        struct AudioPortState {
+            std::string name;
+            bool connected;
+        };
+
+        struct AudioPortsState {
+            std::vector<AudioPortState> ports;
+        };
+
+        // The loaders of the caches, reading the ports from device::Host
+        bool loadVideoPortsState(VideoPortsState& state);
+        bool loadAudioPortsState(AudioPortsState& state);
+
+    } // namespace Plugin
+} // namespace WPEFramework
@@ -145,6 +145,9 @@ namespace WPEFramework {
 
         DisplaySettings::DisplaySettings()
             : AbstractPlugin(2)
+            , m_videoPortsCache(loadVideoPortsState)
+            , m_audioPortsCache(loadAudioPortsState)
+            , m_service(nullptr)
         {
             LOGINFO("ctor");
             DisplaySettings::_instance = this;
@@ -442,8 +445,14 @@ namespace WPEFramework {
             }
         }
 
-        const string DisplaySettings::Initialize(PluginHost::IShell* /* service */)
+        const string DisplaySettings::Initialize(PluginHost::IShell* service)
         {
+            m_service = service;
+            if (m_service != nullptr)
+            {
+                m_service->AddRef();
+            }
+
             InitializeIARM();
 
             if (IARM_BUS_PWRMGR_POWERSTATE_ON == getSystemPowerState())
@@ -459,7 +468,7 @@ namespace WPEFramework {
             return (string());
         }
 
-        void DisplaySettings::Deinitialize(PluginHost::IShell* /* service */)
+        void DisplaySettings::Deinitialize(PluginHost::IShell* service)
         {
 	   LOGINFO("Enetering DisplaySettings::Deinitialize");
 	   isCecArcRoutingThreadEnabled = false;
@@ -486,6 +495,12 @@ namespace WPEFramework {
             }
 
             DeinitializeIARM();
+            Utils::releaseJsonRpcLinks(service->Callsign());
+            if (m_service != nullptr)
+            {
+                m_service->Release();
+                m_service = nullptr;
+            }
             DisplaySettings::_instance = nullptr;
         }
 
@@ -593,6 +608,7 @@ namespace WPEFramework {
 
             if(DisplaySettings::_instance)
             {
+                DisplaySettings::_instance->m_videoPortsCache.invalidate();
                 DisplaySettings::_instance->resolutionChanged(dw, dh);
             }
         }
@@ -614,7 +630,10 @@ namespace WPEFramework {
                         dw = eventData->data.resn.width ;
                         dh = eventData->data.resn.height ;
                         if(DisplaySettings::_instance)
+                        {
+                            DisplaySettings::_instance->m_videoPortsCache.invalidate();
                             DisplaySettings::_instance->resolutionChanged(dw,dh);
+                        }
                     }
                     break;
                 case IARM_BUS_DSMGR_EVENT_ZOOM_SETTINGS:
@@ -671,7 +690,11 @@ namespace WPEFramework {
                     int hdmi_hotplug_event = eventData->data.hdmi_hpd.event;
                     LOGINFO("Received IARM_BUS_DSMGR_EVENT_HDMI_HOTPLUG  event data:%d ", hdmi_hotplug_event);
                     if(DisplaySettings::_instance)
+                    {
+                        DisplaySettings::_instance->m_videoPortsCache.invalidate();
+                        DisplaySettings::_instance->m_audioPortsCache.invalidate();
                         DisplaySettings::_instance->connectedVideoDisplaysUpdated(hdmi_hotplug_event);
+                    }
                 }
                 break;
                 //TODO(MROLLINS) localinput.cpp was also sending these and they were getting handled by services other then DisplaySettings.  Should DisplaySettings own these as well ?
@@ -700,6 +723,7 @@ namespace WPEFramework {
             bool isPortConnected = eventData->data.audio_out_connect.isPortConnected;
             LOGINFO("Received IARM_BUS_DSMGR_EVENT_AUDIO_OUT_HOTPLUG for audio port %d event data:%d ", iAudioPortType, isPortConnected);
             if(DisplaySettings::_instance) {
+                DisplaySettings::_instance->m_audioPortsCache.invalidate();
                 DisplaySettings::_instance->connectedAudioPortUpdated(iAudioPortType, isPortConnected);
             }
             else {
@@ -720,6 +744,8 @@ namespace WPEFramework {
 	                return;
             }
 
+		    DisplaySettings::_instance->m_audioPortsCache.invalidate();
+
 		    if(hdmiin_hotplug_port == HDMI_IN_ARC_PORT_ID) { //HDMI ARC/eARC Port Handling
 			bool arc_port_enabled =  false;
 
@@ -820,6 +846,8 @@ namespace WPEFramework {
                    IARM_Bus_DSMgr_EventData_t *eventData = (IARM_Bus_DSMgr_EventData_t *)data;
                    audioPortState = eventData->data.AudioPortStateInfo.audioPortState;
                    LOGINFO("Received IARM_BUS_DSMGR_EVENT_AUDIO_PORT_STATE. Audio Port Init State: %d \n", audioPortState);
+                   if(DisplaySettings::_instance)
+                       DisplaySettings::_instance->m_audioPortsCache.invalidate();
                    try
                    {   if( audioPortState == dsAUDIOPORT_STATE_INITIALIZED)
                        {
@@ -923,26 +951,20 @@ namespace WPEFramework {
         {   //sample servicemanager response: {"success":true,"connectedAudioPorts":["HDMI0"]}
             LOGINFOMETHOD();
             vector<string> connectedAudioPorts;
-            try
+            AudioPortsState state;
+            if (m_audioPortsCache.get(state))
             {
-                device::List<device::AudioOutputPort> aPorts = device::Host::getInstance().getAudioOutputPorts();
-                for (size_t i = 0; i < aPorts.size(); i++)
+                for (const auto& port : state.ports)
                 {
-                    device::AudioOutputPort &aPort = aPorts.at(i);
-                    if (aPort.isConnected())
+                    if (port.connected)
                     {
-                        string portName = aPort.getName();
-                        if((portName == "HDMI_ARC0") && (m_hdmiInAudioDeviceConnected != true)) {
+                        if((port.name == "HDMI_ARC0") && (m_hdmiInAudioDeviceConnected != true)) {
                             continue;
                         }
-                        vectorSet(connectedAudioPorts, portName);
+                        vectorSet(connectedAudioPorts, port.name);
                     }
                 }
             }
-            catch(const device::Exception& err)
-            {
-                LOG_DEVICE_EXCEPTION0();
-            }
             setResponseArray(response, "connectedAudioPorts", connectedAudioPorts);
             returnResponse(true);
         }
@@ -950,22 +972,17 @@ namespace WPEFramework {
         uint32_t DisplaySettings::getSupportedResolutions(const JsonObject& parameters, JsonObject& response)
         {   //sample servicemanager response:{"success":true,"supportedResolutions":["720p","1080i","1080p60"]}
             LOGINFOMETHOD();
-            std::string strVideoPort = device::Host::getInstance().getDefaultVideoPortName();
+            std::string strVideoPort = getDefaultVideoPortName();
             string videoDisplay = parameters.HasLabel("videoDisplay") ? parameters["videoDisplay"].String() : strVideoPort;
             vector<string> supportedResolutions;
-            try
+            VideoPortsState state;
+            if (m_videoPortsCache.get(state))
             {
-                device::VideoOutputPort &vPort = device::Host::getInstance().getVideoOutputPort(videoDisplay);
-                const device::List<device::VideoResolution> resolutions = device::VideoOutputPortConfig::getInstance().getPortType(vPort.getType().getId()).getSupportedResolutions();
-                for (size_t i = 0; i < resolutions.size(); i++) {
-                    const device::VideoResolution &resolution = resolutions.at(i);
-                    string supportedResolution = resolution.getName();
-                    vectorSet(supportedResolutions,supportedResolution);
-                }
-            }
-            catch(const device::Exception& err)
-            {
-                LOG_DEVICE_EXCEPTION1(videoDisplay);
+                const VideoPortState* port = state.find(videoDisplay);
+                if (port)
+                    supportedResolutions = port->supportedResolutions;
+                else
+                    LOGWARN("Unknown video display %s", videoDisplay.c_str());
             }
             setResponseArray(response, "supportedResolutions", supportedResolutions);
             returnResponse(true);
@@ -975,19 +992,11 @@ namespace WPEFramework {
         {   //sample servicemanager response: {"supportedVideoDisplays":["HDMI0"],"success":true}
             LOGINFOMETHOD();
             vector<string> supportedVideoDisplays;
-            try
+            VideoPortsState state;
+            if (m_videoPortsCache.get(state))
             {
-                device::List<device::VideoOutputPort> vPorts = device::Host::getInstance().getVideoOutputPorts();
-                for (size_t i = 0; i < vPorts.size(); i++)
-                {
-                    device::VideoOutputPort &vPort = vPorts.at(i);
-                    string videoDisplay = vPort.getName();
-                    vectorSet(supportedVideoDisplays, videoDisplay);
-                }
-            }
-            catch (const device::Exception& err)
-            {
-                LOG_DEVICE_EXCEPTION0();
+                for (const auto& port : state.ports)
+                    vectorSet(supportedVideoDisplays, port.name);
             }
             setResponseArray(response, "supportedVideoDisplays", supportedVideoDisplays);
             returnResponse(true);
@@ -996,14 +1005,16 @@ namespace WPEFramework {
         uint32_t DisplaySettings::getSupportedTvResolutions(const JsonObject& parameters, JsonObject& response)
         {   //sample servicemanager response:{"success":true,"supportedTvResolutions":["480i","480p","576i","720p","1080i","1080p"]}
             LOGINFOMETHOD();
-            std::string strVideoPort = device::Host::getInstance().getDefaultVideoPortName();
+            std::string strVideoPort = getDefaultVideoPortName();
             string videoDisplay = parameters.HasLabel("videoDisplay") ? parameters["videoDisplay"].String() : strVideoPort;
             vector<string> supportedTvResolutions;
-            try
+            VideoPortsState state;
+            const VideoPortState* port = nullptr;
+            if (m_videoPortsCache.get(state))
+                port = state.find(videoDisplay);
+            if (port)
             {
-                int tvResolutions = 0;
-                device::VideoOutputPort &vPort = device::Host::getInstance().getVideoOutputPort(videoDisplay);
-                vPort.getSupportedTvResolutions(&tvResolutions);
+                int tvResolutions = port->tvResolutions;
                 if(!tvResolutions)supportedTvResolutions.emplace_back("none");
                 if(tvResolutions & dsTV_RESOLUTION_480i)supportedTvResolutions.emplace_back("480i");
                 if(tvResolutions & dsTV_RESOLUTION_480p)supportedTvResolutions.emplace_back("480p");
@@ -1015,9 +1026,9 @@ namespace WPEFramework {
                 if(tvResolutions & dsTV_RESOLUTION_2160p30)supportedTvResolutions.emplace_back("2160p30");
                 if(tvResolutions & dsTV_RESOLUTION_2160p60)supportedTvResolutions.emplace_back("2160p60");
             }
-            catch(const device::Exception& err)
+            else
             {
-                LOG_DEVICE_EXCEPTION1(videoDisplay);
+                LOGWARN("Unknown video display %s", videoDisplay.c_str());
             }
             setResponseArray(response, "supportedTvResolutions", supportedTvResolutions);
             returnResponse(true);
@@ -1056,19 +1067,11 @@ namespace WPEFramework {
         {   //sample servicemanager response: {"success":true,"supportedAudioPorts":["HDMI0"]}
             LOGINFOMETHOD();
             vector<string> supportedAudioPorts;
-            try
-            {
-                device::List<device::AudioOutputPort> aPorts = device::Host::getInstance().getAudioOutputPorts();
-                for (size_t i = 0; i < aPorts.size(); i++)
-                {
-                    device::AudioOutputPort &vPort = aPorts.at(i);
-                    string portName  = vPort.getName();
-                    vectorSet(supportedAudioPorts,portName);
-                }
-            }
-            catch(const device::Exception& err)
+            AudioPortsState state;
+            if (m_audioPortsCache.get(state))
             {
-                LOG_DEVICE_EXCEPTION0();
+                for (const auto& port : state.ports)
+                    vectorSet(supportedAudioPorts, port.name);
             }
             setResponseArray(response, "supportedAudioPorts", supportedAudioPorts);
             returnResponse(true);
@@ -1105,7 +1108,7 @@ namespace WPEFramework {
 
                 if (Utils::String::stringContains(audioPort, "HDMI0"))
                 {
-                    std::string strVideoPort = device::Host::getInstance().getDefaultVideoPortName();
+                    std::string strVideoPort = getDefaultVideoPortName();
                     device::VideoOutputPort vPort = device::VideoOutputPortConfig::getInstance().getPort(strVideoPort.c_str());
                     int surroundMode = false;
                     try{
@@ -1213,18 +1216,18 @@ namespace WPEFramework {
         uint32_t DisplaySettings::getCurrentResolution(const JsonObject& parameters, JsonObject& response)
         {   //sample servicemanager response:{"success":true,"resolution":"720p"}
             LOGINFOMETHOD();
-            std::string strVideoPort = device::Host::getInstance().getDefaultVideoPortName();
+            std::string strVideoPort = getDefaultVideoPortName();
             string videoDisplay = parameters.HasLabel("videoDisplay") ? parameters["videoDisplay"].String() : strVideoPort;
-            bool success = true;
-            try
-            {
-                device::VideoOutputPort &vPort = device::Host::getInstance().getVideoOutputPort(videoDisplay);
-                response["resolution"] = vPort.getResolution().getName();
-            }
-            catch(const device::Exception& err)
+            bool success = false;
+            VideoPortsState state;
+            if (m_videoPortsCache.get(state))
             {
-                LOG_DEVICE_EXCEPTION1(videoDisplay);
-                success = false;
+                const VideoPortState* port = state.find(videoDisplay);
+                if (port && !port->resolution.empty())
+                {
+                    response["resolution"] = port->resolution;
+                    success = true;
+                }
             }
             returnResponse(success);
         }
@@ -1251,6 +1254,7 @@ namespace WPEFramework {
             {
                 device::VideoOutputPort &vPort = device::Host::getInstance().getVideoOutputPort(videoDisplay);
                 vPort.setResolution(resolution, persist, isIgnoreEdid);
+                m_videoPortsCache.invalidate();
             }
             catch (const device::Exception& err)
             {
@@ -1277,7 +1281,7 @@ namespace WPEFramework {
                 /* Check if HDMI is connected - Return (default) Stereo Mode if not connected */
                 if (audioPort.empty())
                 {
-                    std::string strVideoPort = device::Host::getInstance().getDefaultVideoPortName();
+                    std::string strVideoPort = getDefaultVideoPortName();
                     if (device::Host::getInstance().getVideoOutputPort(strVideoPort.c_str()).isDisplayConnected())
                     {
                         audioPort = "HDMI0";
@@ -1313,7 +1317,7 @@ namespace WPEFramework {
                         if (aPort.getStereoAuto() || mode == device::AudioStereoMode::kSurround)
                         {
                             LOGINFO("HDMI0 is in Auto Mode");
-                            std::string strVideoPort = device::Host::getInstance().getDefaultVideoPortName();
+                            std::string strVideoPort = getDefaultVideoPortName();
                             int surroundMode = device::Host::getInstance().getVideoOutputPort(strVideoPort.c_str()).getDisplay().getSurroundMode();
                             if ( surroundMode & dsSURROUNDMODE_DDPLUS)
                             {
@@ -1481,7 +1485,7 @@ namespace WPEFramework {
                             aPort.setStereoAuto(stereoAuto, persist);
                             if (stereoAuto)
                             {
-                                std::string strVideoPort = device::Host::getInstance().getDefaultVideoPortName();
+                                std::string strVideoPort = getDefaultVideoPortName();
                                 if (device::Host::getInstance().getVideoOutputPort(strVideoPort.c_str()).getDisplay().getSurroundMode())
                                     mode = device::AudioStereoMode::kSurround;
                                 else
@@ -1606,7 +1610,7 @@ namespace WPEFramework {
             try
             {
                 vector<uint8_t> edidVec2;
-                std::string strVideoPort = device::Host::getInstance().getDefaultVideoPortName();
+                std::string strVideoPort = getDefaultVideoPortName();
                 device::VideoOutputPort vPort = device::Host::getInstance().getVideoOutputPort(strVideoPort.c_str());
                 if (vPort.isDisplayConnected())
                 {
@@ -1668,7 +1672,7 @@ namespace WPEFramework {
         {   //sample servicemanager response:
             LOGINFOMETHOD();
 
-            std::string strVideoPort = device::Host::getInstance().getDefaultVideoPortName();
+            std::string strVideoPort = getDefaultVideoPortName();
             string videoDisplay = parameters.HasLabel("videoDisplay") ? parameters["videoDisplay"].String() : strVideoPort;
             bool active = true;
             try
@@ -1695,7 +1699,7 @@ namespace WPEFramework {
 
             try
             {
-                std::string strVideoPort = device::Host::getInstance().getDefaultVideoPortName();
+                std::string strVideoPort = getDefaultVideoPortName();
                 device::VideoOutputPort vPort = device::VideoOutputPortConfig::getInstance().getPort(strVideoPort.c_str());
                 if (vPort.isDisplayConnected())
                     vPort.getTVHDRCapabilities(&capabilities);
@@ -1900,7 +1904,7 @@ namespace WPEFramework {
             bool success = true;
             try
             {
-                std::string strVideoPort = device::Host::getInstance().getDefaultVideoPortName();
+                std::string strVideoPort = getDefaultVideoPortName();
                 device::VideoOutputPort vPort = device::Host::getInstance().getVideoOutputPort(strVideoPort.c_str());
                 if (vPort.isDisplayConnected())
                 {
@@ -3360,7 +3364,7 @@ namespace WPEFramework {
                 /* Check if HDMI is connected - Return (default) Stereo Mode if not connected */
                 if (audioPort.empty())
                 {
-                    std::string strVideoPort = device::Host::getInstance().getDefaultVideoPortName();
+                    std::string strVideoPort = getDefaultVideoPortName();
                     if (device::Host::getInstance().getVideoOutputPort(strVideoPort.c_str()).isDisplayConnected())
                     {
                         audioPort = "HDMI0";
@@ -3431,7 +3435,7 @@ namespace WPEFramework {
                 /* Check if HDMI is connected - Return (default) Stereo Mode if not connected */
                 if (audioPort.empty())
                 {
-                    std::string strVideoPort = device::Host::getInstance().getDefaultVideoPortName();
+                    std::string strVideoPort = getDefaultVideoPortName();
                     if (device::Host::getInstance().getVideoOutputPort(strVideoPort.c_str()).isDisplayConnected())
                         audioPort = "HDMI0";
                     else
@@ -3482,7 +3486,7 @@ namespace WPEFramework {
                 /* Check if HDMI is connected - Return (default) Stereo Mode if not connected */
                 if (audioPort.empty())
                 {
-                    std::string strVideoPort = device::Host::getInstance().getDefaultVideoPortName();
+                    std::string strVideoPort = getDefaultVideoPortName();
                     if (device::Host::getInstance().getVideoOutputPort(strVideoPort.c_str()).isDisplayConnected())
                     {
                         audioPort = "HDMI0";
@@ -3550,7 +3554,7 @@ namespace WPEFramework {
                 /* Check if HDMI is connected - Return (default) Stereo Mode if not connected */
                 if (audioPort.empty())
                 {
-                    std::string strVideoPort = device::Host::getInstance().getDefaultVideoPortName();
+                    std::string strVideoPort = getDefaultVideoPortName();
                     if (device::Host::getInstance().getVideoOutputPort(strVideoPort.c_str()).isDisplayConnected())
                     {
                         audioPort = "HDMI0";
@@ -3664,7 +3668,7 @@ namespace WPEFramework {
             bool success = false;
             try
             {
-		std::string strVideoPort = device::Host::getInstance().getDefaultVideoPortName();
+		std::string strVideoPort = getDefaultVideoPortName();
                 device::VideoOutputPort vPort = device::Host::getInstance().getVideoOutputPort(strVideoPort.c_str());
                 if (vPort.isDisplayConnected()) {
                    if(vPort.setForceHDRMode (mode) == true)
@@ -3687,7 +3691,7 @@ namespace WPEFramework {
         uint32_t DisplaySettings::getPreferredColorDepth(const JsonObject& parameters, JsonObject& response)
         {   //sample servicemanager response:{"colorDepth":"10 Bit","success":true}
             LOGINFOMETHOD();
-            std::string strVideoPort = device::Host::getInstance().getDefaultVideoPortName();
+            std::string strVideoPort = getDefaultVideoPortName();
             string videoDisplay = parameters.HasLabel("videoDisplay") ? parameters["videoDisplay"].String() : strVideoPort;
             bool persist = parameters.HasLabel("persist") ? parameters["persist"].Boolean() : true;
 
@@ -3766,7 +3770,7 @@ namespace WPEFramework {
         uint32_t DisplaySettings::getColorDepthCapabilities(const JsonObject& parameters, JsonObject& response)
         {   //sample servicemanager response:{"success":true,"capabilities":["8 Bit","10 Bit","12 Bit","Auto"]}
             LOGINFOMETHOD();
-            std::string strVideoPort = device::Host::getInstance().getDefaultVideoPortName();
+            std::string strVideoPort = getDefaultVideoPortName();
             string videoDisplay = parameters.HasLabel("videoDisplay") ? parameters["videoDisplay"].String() : strVideoPort;
             vector<string> colorDepthCapabilities;
             try
@@ -4002,6 +4006,7 @@ namespace WPEFramework {
                 device::AudioOutputPort aPort = device::Host::getInstance().getAudioOutputPort(audioPort);
                 //Save the user settings irrespective of actual call passed or failed.
                 aPort.setEnablePersist(pEnable);
+                m_audioPortsCache.invalidate();
                 dsError_t eRet = dsERR_GENERAL;
                 LOGWARN("Calling DisplaySettings::setEnableAudioPort audioPort:%s pEnable:%d \n", audioPort.c_str(), pEnable);
                 //if not HDMI_ARC port
@@ -4150,16 +4155,18 @@ namespace WPEFramework {
 
 
         // Thunder plugins communication
-        std::shared_ptr<WPEFramework::JSONRPC::LinkType<WPEFramework::Core::JSON::IElement>> DisplaySettings::getHdmiCecSinkPlugin()
+        std::shared_ptr<Utils::JSONRPCDirectLink> DisplaySettings::getHdmiCecSinkPlugin()
         {
-            Core::SystemInfo::SetEnvironment(_T("THUNDER_ACCESS"), (_T("127.0.0.1:9998")));
-            return make_shared<WPEFramework::JSONRPC::LinkType<WPEFramework::Core::JSON::IElement>>("org.rdk.HdmiCecSink.1", "");
+            string token;
+            Utils::SecurityToken::getSecurityToken(token);
+            return make_shared<Utils::JSONRPCDirectLink>(m_service, HDMICECSINK_CALLSIGN, token);
         }
 
-        std::shared_ptr<WPEFramework::JSONRPC::LinkType<WPEFramework::Core::JSON::IElement>> DisplaySettings::getSystemPlugin()
+        std::shared_ptr<Utils::JSONRPCDirectLink> DisplaySettings::getSystemPlugin()
         {
-            Core::SystemInfo::SetEnvironment(_T("THUNDER_ACCESS"), (_T("127.0.0.1:9998")));
-            return make_shared<WPEFramework::JSONRPC::LinkType<WPEFramework::Core::JSON::IElement>>("org.rdk.System.1", "");
+            string token;
+            Utils::SecurityToken::getSecurityToken(token);
+            return make_shared<Utils::JSONRPCDirectLink>(m_service, "org.rdk.System", token);
         }
 
         IARM_Bus_PWRMgr_PowerState_t DisplaySettings::getSystemPowerState()
@@ -4868,7 +4875,7 @@ namespace WPEFramework {
 			int capabilities = dsHDRSTANDARD_NONE;
             try
             {
-                std::string strVideoPort = device::Host::getInstance().getDefaultVideoPortName();
+                std::string strVideoPort = getDefaultVideoPortName();
                 device::VideoOutputPort vPort = device::Host::getInstance().getVideoOutputPort(strVideoPort.c_str());
                 if (vPort.isDisplayConnected()) {
                     vPort.getTVHDRCapabilities(&capabilities);
@@ -4894,7 +4901,7 @@ namespace WPEFramework {
             bool isConnectedDeviceRepeater = false;
             try
             {
-                std::string strVideoPort = device::Host::getInstance().getDefaultVideoPortName();
+                std::string strVideoPort = getDefaultVideoPortName();
                 device::VideoOutputPort vPort = device::Host::getInstance().getVideoOutputPort(strVideoPort.c_str());
                 if (vPort.isDisplayConnected()) {
                     isConnectedDeviceRepeater = vPort.getDisplay().isConnectedDeviceRepeater();
@@ -4919,7 +4926,7 @@ namespace WPEFramework {
 			bool success = true;
             try
             {
-                std::string strVideoPort = device::Host::getInstance().getDefaultVideoPortName();
+                std::string strVideoPort = getDefaultVideoPortName();
                 device::VideoOutputPort vPort = device::Host::getInstance().getVideoOutputPort(strVideoPort.c_str());
                 if (vPort.isDisplayConnected()) {
                     response["defaultResolution"] = vPort.getDefaultResolution().getName();
@@ -4979,17 +4986,16 @@ namespace WPEFramework {
             {
                 string resolution;
                 string display = connectedDisplays.at(i);
-                try
+                VideoPortsState state;
+                if (m_videoPortsCache.get(state))
                 {
-                    resolution = device::Host::getInstance().getVideoOutputPort(display).getResolution().getName();
-                }
-                catch(const device::Exception& err)
-                {
-                    LOG_DEVICE_EXCEPTION1(display);
+                    const VideoPortState* port = state.find(display);
+                    if (port)
+                        resolution = port->resolution;
                 }
                 if (!resolution.empty())
                 {
-                    std::string strVideoPort = device::Host::getInstance().getDefaultVideoPortName();
+                    std::string strVideoPort = getDefaultVideoPortName();
                     std::string videoPortName = strVideoPort.substr(0, strVideoPort.size()-1);
                     if (Utils::String::stringContains(display, videoPortName.c_str()))
                     {
@@ -5102,32 +5108,17 @@ namespace WPEFramework {
 
         void DisplaySettings::getConnectedVideoDisplaysHelper(vector<string>& connectedDisplays)
         {
-            try
-            {
-                device::List<device::VideoOutputPort> vPorts = device::Host::getInstance().getVideoOutputPorts();
-                for (size_t i = 0; i < vPorts.size(); i++)
-                {
-                    device::VideoOutputPort &vPort = vPorts.at(i);
-                    if (vPort.isDisplayConnected())
-                    {
-                        string displayName = vPort.getName();
-                        if (strncasecmp(displayName.c_str(), "hdmi", 4)==0)
-                        {
-                            connectedDisplays.clear();
-                            connectedDisplays.emplace_back(displayName);
-                            break;
-                        }
-                        else
-                        {
-                            vectorSet(connectedDisplays, displayName);
-                        }
-                    }
-                }
-            }
-            catch(const device::Exception& err)
-            {
-                LOG_DEVICE_EXCEPTION0();
-            }
+            VideoPortsState state;
+            if (m_videoPortsCache.get(state))
+                state.connectedDisplays(connectedDisplays);
+        }
+
+        string DisplaySettings::getDefaultVideoPortName()
+        {
+            VideoPortsState state;
+            if (m_videoPortsCache.get(state) && !state.defaultPort.empty())
+                return state.defaultPort;
+            return device::Host::getInstance().getDefaultVideoPortName();
         }
 
         bool DisplaySettings::checkPortName(std::string& name) const
@@ -5227,7 +5218,7 @@ namespace WPEFramework {
 
             try
             {
-                std::string strVideoPort = device::Host::getInstance().getDefaultVideoPortName();
+                std::string strVideoPort = getDefaultVideoPortName();
                 device::VideoOutputPort vPort = device::Host::getInstance().getVideoOutputPort(strVideoPort.c_str());
                 if (vPort.isDisplayConnected())
                 {
@@ -23,6 +23,7 @@
 #include <condition_variable>
 #include "Module.h"
 #include "utils.h"
+#include "UtilsJsonRpcDirectLink.h"
 #include "dsTypes.h"
 #include "tptimer.h"
 #include "AbstractPlugin.h"
@@ -30,6 +31,7 @@
 #include "libIBusDaemon.h"
 #include "irMgr.h"
 #include "pwrMgr.h"
+#include "DisplayPortCache.h"
 
 namespace WPEFramework {
 
@@ -197,6 +199,7 @@ namespace WPEFramework {
             static void audioPortStateEventHandler(const char *owner, IARM_EventId_t eventId, void *data, size_t len);
             static void dsSettingsChangeEventHandler(const char *owner, IARM_EventId_t eventId, void *data, size_t len);
             void getConnectedVideoDisplaysHelper(std::vector<string>& connectedDisplays);
+            string getDefaultVideoPortName();
 	    void audioFormatToString(dsAudioFormat_t audioFormat, JsonObject &response);
             const char *getVideoFormatTypeToString(dsHDRStandard_t format);
             dsHDRStandard_t getVideoFormatTypeFromString(const char *mode);
@@ -204,9 +207,9 @@ namespace WPEFramework {
             bool checkPortName(std::string& name) const;
             IARM_Bus_PWRMgr_PowerState_t getSystemPowerState();
 
-	    std::shared_ptr<WPEFramework::JSONRPC::LinkType<WPEFramework::Core::JSON::IElement>> getHdmiCecSinkPlugin();
+	    std::shared_ptr<Utils::JSONRPCDirectLink> getHdmiCecSinkPlugin();
 	    std::shared_ptr<WPEFramework::JSONRPC::LinkType<WPEFramework::Core::JSON::IElement> > m_client;
-	    std::shared_ptr<WPEFramework::JSONRPC::LinkType<WPEFramework::Core::JSON::IElement>> getSystemPlugin();
+	    std::shared_ptr<Utils::JSONRPCDirectLink> getSystemPlugin();
 	    uint32_t subscribeForHdmiCecSinkEvent(const char* eventName);
 	    bool setUpHdmiCecSinkArcRouting (bool arcEnable);
 	    bool requestShortAudioDescriptor();
@@ -251,6 +254,13 @@ namespace WPEFramework {
             int m_hdmiInAudioDevicePowerState;
             int m_currentArcRoutingState; 
 
+            // Port state read from the DS manager, invalidated by the hotplug,
+            // resolution and audio port IARM events.
+            CachedValue<VideoPortsState> m_videoPortsCache;
+            CachedValue<AudioPortsState> m_audioPortsCache;
+
+            PluginHost::IShell* m_service;
+
         public:
             static DisplaySettings* _instance;
 
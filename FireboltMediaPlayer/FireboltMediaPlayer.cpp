@@ -21,6 +21,13 @@
 #include "utils.h"
 #include "Module.h"
 
+namespace {
+    uint64_t NowMiliseconds()
+    {
+        return WPEFramework::Core::Time::Now().Ticks() / WPEFramework::Core::Time::TicksPerMillisecond;
+    }
+}
+
 namespace WPEFramework {
 
     namespace Plugin {
@@ -58,6 +65,9 @@ namespace WPEFramework {
         , _aampMediaPlayerConnectionId(0)
         , _aampMediaPlayer(nullptr)
         , _mediaStreams()
+        , _clockLock()
+        , _clocks()
+        , _progressLimiter()
         {
             RegisterAll();
         }
@@ -106,6 +116,10 @@ namespace WPEFramework {
             }
             _mediaStreams.clear();
 
+            _clockLock.Lock();
+            _clocks.clear();
+            _clockLock.Unlock();
+
             service->Unregister(&_notification);
 
             RPC::IRemoteConnection* connection(_service->RemoteConnection(_aampMediaPlayerConnectionId));
@@ -149,6 +163,8 @@ namespace WPEFramework {
             Register(_T("stop"), &FireboltMediaPlayer::stop, this);
             Register(_T("initConfig"), &FireboltMediaPlayer::initConfig, this);
             Register(_T("setDRMConfig"), &FireboltMediaPlayer::setDRMConfig, this);
+            Register(_T("setProgressInterval"), &FireboltMediaPlayer::setProgressInterval, this);
+            Register(_T("getPlaybackPosition"), &FireboltMediaPlayer::getPlaybackPosition, this);
         }
 
         void FireboltMediaPlayer::UnregisterAll()
@@ -162,6 +178,8 @@ namespace WPEFramework {
             Unregister(_T("stop"));
             Unregister(_T("initConfig"));
             Unregister(_T("setDRMConfig"));
+            Unregister(_T("setProgressInterval"));
+            Unregister(_T("getPlaybackPosition"));
         }
 
         uint32_t FireboltMediaPlayer::create(const JsonObject& parameters, JsonObject& response)
@@ -213,6 +231,11 @@ namespace WPEFramework {
                 {
                     delete _mediaStreams[id];
                     _mediaStreams.erase(id);
+
+                    _clockLock.Lock();
+                    _clocks.erase(id);
+                    _clockLock.Unlock();
+                    _progressLimiter.Forget(id);
                 }
                 returnResponse(true);
             }
@@ -360,8 +383,90 @@ namespace WPEFramework {
             returnResponse((*it).second->Stream()->InitDRMConfig(parametersWithoutIdStr) == Core::ERROR_NONE);
         }
 
+        uint32_t FireboltMediaPlayer::setProgressInterval(const JsonObject& parameters, JsonObject& response)
+        {
+            LOGINFOMETHOD();
+            const char *keyClient = "client";
+            const char *keyIntervalMs = "intervalMs";
+            returnIfStringParamNotFound(parameters, keyClient);
+            returnIfNumberParamNotFound(parameters, keyIntervalMs);
+
+            string client = parameters[keyClient].String();
+            int64_t intervalMs = parameters[keyIntervalMs].Number();
+            if (intervalMs < 0)
+            {
+                LOGERR("Argument \'%s\' is negative", keyIntervalMs);
+                returnResponse(false);
+            }
+
+            _progressLimiter.SetInterval(client, static_cast<uint32_t>(intervalMs));
+            returnResponse(true);
+        }
+
+        uint32_t FireboltMediaPlayer::getPlaybackPosition(const JsonObject& parameters, JsonObject& response)
+        {
+            const char *keyId = "id";
+            returnIfStringParamNotFound(parameters, keyId);
+            string id = parameters[keyId].String();
+
+            uint64_t now = NowMiliseconds();
+            _clockLock.Lock();
+            auto it = _clocks.find(id);
+            if (it == _clocks.end() || !it->second.IsValid())
+            {
+                _clockLock.Unlock();
+                LOGERR("No progress of instance '%s'", id.c_str());
+                returnResponse(false);
+            }
+            const PositionClock& clock = it->second;
+            response["positionMiliseconds"] = static_cast<int64_t>(clock.PositionMiliseconds(now));
+            response["durationMiliseconds"] = static_cast<int64_t>(clock.Last().durationMiliseconds);
+            response["playbackSpeed"] = static_cast<int>(clock.Last().playbackSpeed);
+            response["startMiliseconds"] = static_cast<int64_t>(clock.Last().startMiliseconds);
+            response["endMiliseconds"] = static_cast<int64_t>(clock.Last().endMiliseconds);
+            response["ageMiliseconds"] = static_cast<int64_t>(clock.AgeMiliseconds(now));
+            _clockLock.Unlock();
+
+            returnResponse(true);
+        }
+
+        void FireboltMediaPlayer::onPlaybackProgress(const string& id, const JsonObject& parameters)
+        {
+            PlaybackProgress progress;
+            progress.durationMiliseconds = parameters["durationMiliseconds"].Number();
+            progress.positionMiliseconds = parameters["positionMiliseconds"].Number();
+            progress.playbackSpeed = parameters["playbackSpeed"].Number();
+            progress.startMiliseconds = parameters["startMiliseconds"].Number();
+            progress.endMiliseconds = parameters["endMiliseconds"].Number();
+
+            uint64_t now = NowMiliseconds();
+            _clockLock.Lock();
+            _clocks[id].Update(progress, now);
+            _clockLock.Unlock();
+
+            JsonObject parametersJsonObjWithId;
+            parametersJsonObjWithId[id.c_str()] = parameters;
+
+            // Streams report progress from their own threads, a Prune of one stream would drop
+            // the clients another one has asked about but not pruned yet
+            _progressLock.Lock();
+            // Only to the clients due a progress event, see setProgressInterval
+            Notify(_T("playbackProgressUpdate"), parametersJsonObjWithId, [this, &id, now](const string& designator) -> bool {
+                return _progressLimiter.Admit(designator, id, now);
+            });
+            // The clients not asked about have unregistered
+            _progressLimiter.Prune();
+            _progressLock.Unlock();
+        }
+
         void FireboltMediaPlayer::onMediaStreamEvent(const string& id, const string &eventName, const string &parametersJson)
         {
+            if (eventName == _T("playbackProgressUpdate"))
+            {
+                onPlaybackProgress(id, JsonObject(parametersJson));
+                return;
+            }
+
             JsonObject parametersJsonObjWithId;
             parametersJsonObjWithId[id.c_str()] = JsonObject(parametersJson);
 
@@ -20,6 +20,7 @@
 #pragma once
 
 #include "Module.h"
+#include "PlaybackProgress.h"
 #include <interfaces/IMediaPlayer.h>
 
 namespace WPEFramework {
@@ -161,6 +162,8 @@ namespace WPEFramework {
             uint32_t stop(const JsonObject& parameters, JsonObject& response);
             uint32_t initConfig(const JsonObject& parameters, JsonObject& response);
             uint32_t setDRMConfig(const JsonObject& parameters, JsonObject& response);
+            uint32_t setProgressInterval(const JsonObject& parameters, JsonObject& response);
+            uint32_t getPlaybackPosition(const JsonObject& parameters, JsonObject& response);
 
             void onMediaStreamEvent(const string& id, const string &eventName, const string &parameters);
 
@@ -182,6 +185,8 @@ namespace WPEFramework {
             void RegisterAll();
             void UnregisterAll();
 
+            void onPlaybackProgress(const string& id, const JsonObject& parameters);
+
             private:
 
             PluginHost::IShell* _service;
@@ -193,6 +198,13 @@ namespace WPEFramework {
             Exchange::IMediaPlayer* _aampMediaPlayer;
             //* The current MediaStreamProxy instances by name. When their reference count reaches zero they are removed from this map.
             MediaStreams _mediaStreams;
+
+            //* The position of the streams, by name, from their last progress event.
+            Core::CriticalSection _clockLock;
+            std::map<string, PositionClock> _clocks;
+            //* Held across the delivery of a progress event and the Prune following it.
+            Core::CriticalSection _progressLock;
+            ProgressRateLimiter _progressLimiter;
         };
 
     } //namespace Plugin
@@ -0,0 +1,302 @@
+/**
+ * If not stated otherwise in this file or this component's LICENSE
+ * file the following copyright and licenses apply:
+ *
+ * Copyright 2020 RDK Management
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ **/
+
+#pragma once
+
+#include <stdint.h>
+
+#include <map>
+#include <mutex>
+#include <set>
+#include <string>
+
+namespace WPEFramework {
+    namespace Plugin {
+
+        /**
+         * @brief The playback progress of a stream, as AAMP reports it.
+         */
+        struct PlaybackProgress
+        {
+            double durationMiliseconds;
+            double positionMiliseconds;
+            float playbackSpeed;
+            double startMiliseconds;
+            double endMiliseconds;
+        };
+
+        /**
+         * @brief The progress waiting to be delivered, a newer one replacing it.
+         *
+         * Progress comes in faster than a slow client takes it, only the latest
+         * is worth delivering.
+         */
+        class LatestProgress
+        {
+        public:
+            LatestProgress()
+            : _pending(false)
+            , _coalesced(0)
+            {
+            }
+
+            LatestProgress(const LatestProgress&) = delete;
+            LatestProgress& operator=(const LatestProgress&) = delete;
+
+            /**
+             * @brief Keep the progress for delivery.
+             *
+             * @return Whether nothing was waiting already, so a delivery is to be scheduled.
+             */
+            bool Post(const PlaybackProgress& progress)
+            {
+                std::lock_guard<std::mutex> lock(_lock);
+                bool schedule = !_pending;
+                if (_pending)
+                {
+                    _coalesced++;
+                }
+                _progress = progress;
+                _pending = true;
+                return schedule;
+            }
+
+            /**
+             * @brief Take the progress waiting, if any.
+             */
+            bool Take(PlaybackProgress& progress)
+            {
+                std::lock_guard<std::mutex> lock(_lock);
+                if (!_pending)
+                {
+                    return false;
+                }
+                progress = _progress;
+                _pending = false;
+                return true;
+            }
+
+            /**
+             * @brief Number of progress updates replaced before their delivery.
+             */
+            uint32_t Coalesced() const
+            {
+                std::lock_guard<std::mutex> lock(_lock);
+                return _coalesced;
+            }
+
+        private:
+            mutable std::mutex _lock;
+            PlaybackProgress _progress;
+            bool _pending;
+            uint32_t _coalesced;
+        };
+
+        /**
+         * @brief The position of a stream at any time, from its last progress.
+         *
+         * The position moves on at the playback speed from the last progress,
+         * within the range the stream can be played in, so clients can read it
+         * rather than follow every progress event.
+         */
+        class PositionClock
+        {
+        public:
+            PositionClock()
+            : _valid(false)
+            , _updatedMs(0)
+            {
+            }
+
+            void Update(const PlaybackProgress& progress, uint64_t nowMs)
+            {
+                _progress = progress;
+                _updatedMs = nowMs;
+                _valid = true;
+            }
+
+            bool IsValid() const
+            {
+                return _valid;
+            }
+
+            const PlaybackProgress& Last() const
+            {
+                return _progress;
+            }
+
+            uint64_t AgeMiliseconds(uint64_t nowMs) const
+            {
+                return (nowMs > _updatedMs) ? (nowMs - _updatedMs) : 0;
+            }
+
+            double PositionMiliseconds(uint64_t nowMs) const
+            {
+                double position = _progress.positionMiliseconds + _progress.playbackSpeed * AgeMiliseconds(nowMs);
+                if (_progress.endMiliseconds > _progress.startMiliseconds)
+                {
+                    if (position > _progress.endMiliseconds)
+                    {
+                        position = _progress.endMiliseconds;
+                    }
+                    else if (position < _progress.startMiliseconds)
+                    {
+                        position = _progress.startMiliseconds;
+                    }
+                }
+                return position;
+            }
+
+        private:
+            bool _valid;
+            PlaybackProgress _progress;
+            uint64_t _updatedMs;
+        };
+
+        /**
+         * @brief Progress events per client at most every so often, for each stream.
+         *
+         * Clients are told apart by the id they registered for the events with.
+         * Clients without an interval get every progress event. The interval of
+         * a client goes once it is no longer registered, see Prune.
+         */
+        class ProgressRateLimiter
+        {
+        public:
+            ProgressRateLimiter() = default;
+            ProgressRateLimiter(const ProgressRateLimiter&) = delete;
+            ProgressRateLimiter& operator=(const ProgressRateLimiter&) = delete;
+
+            /**
+             * @brief Set the interval of a client, 0 for every progress event.
+             */
+            void SetInterval(const std::string& client, uint32_t intervalMs)
+            {
+                std::lock_guard<std::mutex> lock(_lock);
+                if (intervalMs == 0)
+                {
+                    _intervals.erase(client);
+                }
+                else
+                {
+                    _intervals[client] = intervalMs;
+                    _asked.insert(client);
+                }
+            }
+
+            uint32_t Interval(const std::string& client) const
+            {
+                std::lock_guard<std::mutex> lock(_lock);
+                auto it = _intervals.find(client);
+                return (it != _intervals.end()) ? it->second : 0;
+            }
+
+            /**
+             * @brief Whether the client is to get a progress event of the stream now.
+             */
+            bool Admit(const std::string& client, const std::string& stream, uint64_t nowMs)
+            {
+                std::lock_guard<std::mutex> lock(_lock);
+                auto interval = _intervals.find(client);
+                if (interval == _intervals.end())
+                {
+                    return true;
+                }
+                _asked.insert(client);
+
+                auto sent = _sent.find(std::make_pair(client, stream));
+                if (sent != _sent.end() && nowMs < sent->second + interval->second)
+                {
+                    return false;
+                }
+                _sent[std::make_pair(client, stream)] = nowMs;
+                return true;
+            }
+
+            /**
+             * @brief Forget a stream that went.
+             */
+            void Forget(const std::string& stream)
+            {
+                std::lock_guard<std::mutex> lock(_lock);
+                for (auto it = _sent.begin(); it != _sent.end();)
+                {
+                    if (it->first.second == stream)
+                    {
+                        it = _sent.erase(it);
+                    }
+                    else
+                    {
+                        ++it;
+                    }
+                }
+            }
+
+            /**
+             * @brief Forget the clients not asked about since the last time.
+             *
+             * Called after each progress event, every client registered for it
+             * has been asked about by then. A client setting its interval just
+             * before it registers keeps it until the next progress event.
+             * The clients asked about are not told apart by stream, so the
+             * caller does not deliver a progress event of another stream
+             * between the delivery and the Prune.
+             */
+            void Prune()
+            {
+                std::lock_guard<std::mutex> lock(_lock);
+                for (auto it = _intervals.begin(); it != _intervals.end();)
+                {
+                    if (_asked.find(it->first) == _asked.end())
+                    {
+                        ForgetClient(it->first);
+                        it = _intervals.erase(it);
+                    }
+                    else
+                    {
+                        ++it;
+                    }
+                }
+                _asked.clear();
+            }
+
+        private:
+            void ForgetClient(const std::string& client)
+            {
+                for (auto it = _sent.begin(); it != _sent.end();)
+                {
+                    if (it->first.first == client)
+                    {
+                        it = _sent.erase(it);
+                    }
+                    else
+                    {
+                        ++it;
+                    }
+                }
+            }
+
+            mutable std::mutex _lock;
+            std::set<std::string> _asked;
+            std::map<std::string, uint32_t> _intervals;
+            std::map<std::pair<std::string, std::string>, uint64_t> _sent;
+        };
+
+    } //namespace Plugin
+} //namespace WPEFramework
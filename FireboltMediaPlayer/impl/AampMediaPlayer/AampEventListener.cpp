@@ -28,16 +28,23 @@ namespace WPEFramework {
 
         AampEventListener::AampEventListener(AampMediaStream& parent)
         : _parent(parent)
+        , _progress()
+        , _progressJob(*this)
         {
         }
 
         AampEventListener::~AampEventListener()
         {
+            _progressJob.Revoke();
+            LOGINFO("Progress updates coalesced: %u", _progress.Coalesced());
         }
 
         void AampEventListener::Event(const AAMPEvent& event)
         {
-            LOGINFO("Event: handling event: %d", event.type);
+            if (event.type != AAMP_EVENT_PROGRESS)
+            {
+                LOGINFO("Event: handling event: %d", event.type);
+            }
             switch(event.type)
             {
             case AAMP_EVENT_TUNED:
@@ -80,12 +87,34 @@ namespace WPEFramework {
 
         void AampEventListener::HandlePlaybackProgressUpdateEvent(const AAMPEvent& event)
         {
+            PlaybackProgress progress;
+            progress.durationMiliseconds = event.data.progress.durationMiliseconds;
+            progress.positionMiliseconds = event.data.progress.positionMiliseconds;
+            progress.playbackSpeed = event.data.progress.playbackSpeed;
+            progress.startMiliseconds = event.data.progress.startMiliseconds;
+            progress.endMiliseconds = event.data.progress.endMiliseconds;
+
+            // A progress not sent yet is replaced rather than queued behind
+            if (_progress.Post(progress))
+            {
+                _progressJob.Submit();
+            }
+        }
+
+        void AampEventListener::Dispatch()
+        {
+            PlaybackProgress progress;
+            if (!_progress.Take(progress))
+            {
+                return;
+            }
+
             JsonObject parameters;
-            parameters[_T("durationMiliseconds")] = static_cast<int>(event.data.progress.durationMiliseconds);
-            parameters[_T("positionMiliseconds")] = static_cast<int>(event.data.progress.positionMiliseconds);
-            parameters[_T("playbackSpeed")] = static_cast<int>(event.data.progress.playbackSpeed);
-            parameters[_T("startMiliseconds")] = static_cast<int>(event.data.progress.startMiliseconds);
-            parameters[_T("endMiliseconds")] = static_cast<int>(event.data.progress.endMiliseconds);
+            parameters[_T("durationMiliseconds")] = static_cast<int>(progress.durationMiliseconds);
+            parameters[_T("positionMiliseconds")] = static_cast<int>(progress.positionMiliseconds);
+            parameters[_T("playbackSpeed")] = static_cast<int>(progress.playbackSpeed);
+            parameters[_T("startMiliseconds")] = static_cast<int>(progress.startMiliseconds);
+            parameters[_T("endMiliseconds")] = static_cast<int>(progress.endMiliseconds);
 
             string s;
             parameters.ToString(s);
@@ -20,6 +20,7 @@
 #pragma once
 
 #include "Module.h"
+#include "PlaybackProgress.h"
 
 #include <main_aamp.h>
 
@@ -40,6 +41,11 @@ namespace WPEFramework {
             void Event(const AAMPEvent& event) override;
 
         private:
+            friend Core::ThreadPool::JobType<AampEventListener&>;
+
+            // Sends the latest progress, off the AAMP thread
+            void Dispatch();
+
             void HandlePlaybackStartedEvent();
             void HandlePlaybackStateChangedEvent(const AAMPEvent& event);
             void HandlePlaybackProgressUpdateEvent(const AAMPEvent& event);
@@ -48,6 +54,8 @@ namespace WPEFramework {
             void HandlePlaybackFailed(const AAMPEvent& event);
 
             AampMediaStream& _parent;
+            LatestProgress _progress;
+            Core::WorkerPool::JobType<AampEventListener&> _progressJob;
         };
 
     }
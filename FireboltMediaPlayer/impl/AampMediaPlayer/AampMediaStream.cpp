@@ -545,8 +545,13 @@ namespace WPEFramework {
             _adminLock.Lock();
             _aampPlayer->Stop();
             _aampPlayer->RegisterEvents(nullptr);
+            _adminLock.Unlock();
+
+            // Waits for a progress being sent, which takes the lock
             delete _aampEventListener;
             _aampEventListener = nullptr;
+
+            _adminLock.Lock();
             delete _aampPlayer;
             _aampPlayer = nullptr;
             _adminLock.Unlock();
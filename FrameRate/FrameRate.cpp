@@ -34,6 +34,8 @@
 #define METHOD_GET_FRAME_MODE "getFrmMode"
 #define METHOD_GET_DISPLAY_FRAME_RATE "getDisplayFrameRate"
 #define METHOD_SET_DISPLAY_FRAME_RATE "setDisplayFrameRate"
+#define METHOD_UPDATE_FRAME_TIMES "updateFrameTimes"
+#define METHOD_GET_FRAME_TIME_STATS "getFrameTimeStats"
 
 // Events
 #define EVENT_FPS_UPDATE "onFpsEvent"
@@ -54,11 +56,35 @@ namespace WPEFramework
 
         FrameRate* FrameRate::_instance = nullptr;
 
+        static JsonObject frameTimesToJson(const FrameTimeStats::Summary& summary)
+        {
+            JsonObject result;
+            result["frames"] = summary.frames;
+            result["dropped"] = summary.dropped;
+            result["average"] = summary.averageFps;
+            result["low1"] = summary.low1Fps;
+            result["low01"] = summary.low01Fps;
+            result["minInterval"] = summary.minIntervalMs;
+            result["maxInterval"] = summary.maxIntervalMs;
+
+            JsonArray histogram;
+            for (const auto& bucket : summary.histogram)
+            {
+                JsonObject entry;
+                entry["upTo"] = bucket.first;
+                entry["count"] = bucket.second;
+                histogram.Add(entry);
+            }
+            result["histogram"] = histogram;
+            return result;
+        }
+
         FrameRate::FrameRate()
         : PluginHost::JSONRPC()
           , m_fpsCollectionFrequencyInMs(DEFAULT_FPS_COLLECTION_TIME_IN_MILLISECONDS)
           , m_minFpsValue(DEFAULT_MIN_FPS_VALUE), m_maxFpsValue(DEFAULT_MAX_FPS_VALUE)
           , m_totalFpsValues(0), m_numberOfFpsUpdates(0), m_fpsCollectionInProgress(false), m_lastFpsValue(-1)
+          , m_hasLastFrameTimes(false)
         {
             FrameRate::_instance = this;
 
@@ -76,6 +102,8 @@ namespace WPEFramework
             GetHandler(2)->Register<JsonObject, JsonObject>(METHOD_GET_FRAME_MODE, &FrameRate::getFrmMode, this);
             GetHandler(2)->Register<JsonObject, JsonObject>(METHOD_GET_DISPLAY_FRAME_RATE, &FrameRate::getDisplayFrameRate, this);
             GetHandler(2)->Register<JsonObject, JsonObject>(METHOD_SET_DISPLAY_FRAME_RATE, &FrameRate::setDisplayFrameRate, this);
+            GetHandler(2)->Register<JsonObject, JsonObject>(METHOD_UPDATE_FRAME_TIMES, &FrameRate::updateFrameTimesWrapper, this);
+            GetHandler(2)->Register<JsonObject, JsonObject>(METHOD_GET_FRAME_TIME_STATS, &FrameRate::getFrameTimeStatsWrapper, this);
 
             m_reportFpsTimer.connect( std::bind( &FrameRate::onReportFpsTimer, this ) );
         }
@@ -95,6 +123,8 @@ namespace WPEFramework
             GetHandler(2)->Unregister(METHOD_GET_FRAME_MODE);
             GetHandler(2)->Unregister(METHOD_GET_DISPLAY_FRAME_RATE);
             GetHandler(2)->Unregister(METHOD_SET_DISPLAY_FRAME_RATE);
+            GetHandler(2)->Unregister(METHOD_UPDATE_FRAME_TIMES);
+            GetHandler(2)->Unregister(METHOD_GET_FRAME_TIME_STATS);
         }
 
 	const string FrameRate::Initialize(PluginHost::IShell * /* service */)
@@ -203,6 +233,49 @@ namespace WPEFramework
             returnResponse(true);
         }
         
+        uint32_t FrameRate::updateFrameTimesWrapper(const JsonObject& parameters, JsonObject& response)
+        {
+            std::lock_guard<std::mutex> guard(m_callMutex);
+
+            // Not logged, the parameters are the timestamps of many frames
+            returnIfParamNotFound(parameters, "timestamps");
+
+            if (parameters.HasLabel("expectedFps"))
+            {
+                m_frameTimes.setExpectedFps(parameters["expectedFps"].Number());
+            }
+
+            // A batch at a time, so there is no call per frame
+            const JsonArray& timestamps = parameters["timestamps"].Array();
+            std::vector<uint64_t> values;
+            values.reserve(timestamps.Length());
+            for (uint16_t i = 0; i < timestamps.Length(); i++)
+            {
+                values.push_back((uint64_t)timestamps[i].Number());
+            }
+            response["frames"] = (uint32_t)m_frameTimes.addTimestamps(values.data(), values.size());
+
+            returnResponse(true);
+        }
+
+        uint32_t FrameRate::getFrameTimeStatsWrapper(const JsonObject& parameters, JsonObject& response)
+        {
+            std::lock_guard<std::mutex> guard(m_callMutex);
+
+            LOGINFOMETHOD();
+
+            FrameTimeStats::Summary current;
+            m_frameTimes.summary(current);
+            response["expectedFps"] = m_frameTimes.expectedFps();
+            response["current"] = frameTimesToJson(current);
+            if (m_hasLastFrameTimes)
+            {
+                response["last"] = frameTimesToJson(m_lastFrameTimes);
+            }
+
+            returnResponse(true);
+        }
+
 	uint32_t FrameRate::setFrmMode(const JsonObject& parameters, JsonObject& response)
         {
             std::lock_guard<std::mutex> guard(m_callMutex);
@@ -345,6 +418,8 @@ namespace WPEFramework
             m_maxFpsValue = DEFAULT_MAX_FPS_VALUE;
             m_totalFpsValues = 0;
             m_numberOfFpsUpdates = 0;
+            m_frameTimes.reset();
+            m_hasLastFrameTimes = false;
             m_fpsCollectionInProgress = true;
             int fpsCollectionFrequency = m_fpsCollectionFrequencyInMs;
             if (fpsCollectionFrequency < MINIMUM_FPS_COLLECTION_TIME_IN_MILLISECONDS)
@@ -381,8 +456,13 @@ namespace WPEFramework
                 averageFps = (m_totalFpsValues / m_numberOfFpsUpdates);
                 minFps = m_minFpsValue;
                 maxFps = m_maxFpsValue;
+                }
+                if (m_numberOfFpsUpdates > 0 || m_frameTimes.frames() > 0)
+                {
                 fpsCollectionUpdate(averageFps, minFps, maxFps);
                 }
+                nextFrameTimesWindow();
+                m_frameTimes.reset();
                 disableFpsCollection();
             }
             return true;
@@ -415,6 +495,12 @@ namespace WPEFramework
             params["average"] = averageFps;
             params["min"] = minFps;
             params["max"] = maxFps;
+            if (m_frameTimes.frames() > 0)
+            {
+                FrameTimeStats::Summary summary;
+                m_frameTimes.summary(summary);
+                params["frameTimes"] = frameTimesToJson(summary);
+            }
             
             sendNotify(EVENT_FPS_UPDATE, params);
 
@@ -435,6 +521,7 @@ namespace WPEFramework
                 maxFps = m_maxFpsValue;
             }
             fpsCollectionUpdate(averageFps, minFps, maxFps);
+            nextFrameTimesWindow();
             if (m_lastFpsValue >= 0)
             {
                 // store the last fps value just in case there are no updates
@@ -452,6 +539,19 @@ namespace WPEFramework
             }
         }
 
+        /**
+        * @brief Keeps the frame times of the window that ended for getFrameTimeStats and starts a new one.
+        */
+        void FrameRate::nextFrameTimesWindow()
+        {
+            if (m_frameTimes.frames() > 0)
+            {
+                m_frameTimes.summary(m_lastFrameTimes);
+                m_hasLastFrameTimes = true;
+            }
+            m_frameTimes.nextWindow();
+        }
+
 	void FrameRate::FrameRatePreChange(const char *owner, IARM_EventId_t eventId, void *data, size_t len)
         {
             if(FrameRate::_instance)
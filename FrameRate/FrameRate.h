@@ -24,6 +24,7 @@
 #include "Module.h"
 
 #include "tptimer.h"
+#include "FrameTimeStats.h"
 
 #include "libIARM.h"
 
@@ -47,6 +48,8 @@ namespace WPEFramework {
 	    uint32_t getFrmMode(const JsonObject& parameters, JsonObject& response);
 	    uint32_t getDisplayFrameRate(const JsonObject& parameters, JsonObject& response);
 	    uint32_t setDisplayFrameRate(const JsonObject& parameters, JsonObject& response);
+            uint32_t updateFrameTimesWrapper(const JsonObject& parameters, JsonObject& response);
+            uint32_t getFrameTimeStatsWrapper(const JsonObject& parameters, JsonObject& response);
 	    //End methods
             
             int getCollectionFrequency();
@@ -56,6 +59,7 @@ namespace WPEFramework {
             void updateFps(int newFpsValue);
 
             void fpsCollectionUpdate( int averageFps, int minFps, int maxFps );
+            void nextFrameTimesWindow();
             
             virtual void enableFpsCollection() {}
             virtual void disableFpsCollection() {}
@@ -98,6 +102,9 @@ namespace WPEFramework {
             //QTimer m_reportFpsTimer;
             TpTimer m_reportFpsTimer;
             int m_lastFpsValue;
+            FrameTimeStats m_frameTimes;
+            FrameTimeStats::Summary m_lastFrameTimes;
+            bool m_hasLastFrameTimes;
             
             std::mutex m_callMutex;
         };
@@ -0,0 +1,260 @@
+/**
+* If not stated otherwise in this file or this component's LICENSE
+* file the following copyright and licenses apply:
+*
+* Copyright 2020 RDK Management
+*
+* Licensed under the Apache License, Version 2.0 (the "License");
+* you may not use this file except in compliance with the License.
+* You may obtain a copy of the License at
+*
+* http://www.apache.org/licenses/LICENSE-2.0
+*
+* Unless required by applicable law or agreed to in writing, software
+* distributed under the License is distributed on an "AS IS" BASIS,
+* WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+* See the License for the specific language governing permissions and
+* limitations under the License.
+**/
+
+#pragma once
+
+#include <stdint.h>
+#include <cmath>
+#include <vector>
+
+namespace WPEFramework {
+
+    namespace Plugin {
+
+        /* Frame intervals of a collection window, in logarithmic buckets of
+         * 1/8 of an octave (about 9%) from 1 ms: bucket 0 holds intervals
+         * under 1 ms, bucket i intervals in [2^((i-1)/8), 2^(i/8)) ms and the
+         * last bucket everything from about 4 s. Recording is a few
+         * operations per frame, whatever the number of frames. */
+        struct FrameTimeHistogram
+        {
+            static const int STEPS_PER_OCTAVE = 8;
+            static const int BUCKETS = 1 + 12 * STEPS_PER_OCTAVE;
+
+            FrameTimeHistogram()
+            {
+                reset();
+            }
+
+            void reset()
+            {
+                count = 0;
+                sumUs = 0;
+                minUs = 0;
+                maxUs = 0;
+                for (int i = 0; i < BUCKETS; i++)
+                {
+                    buckets[i] = 0;
+                }
+            }
+
+            static int bucketOf(uint64_t us)
+            {
+                if (us < 1000)
+                {
+                    return 0;
+                }
+                int bucket = 1 + (int)(std::log2(us / 1000.0) * STEPS_PER_OCTAVE);
+                return (bucket < BUCKETS) ? bucket : BUCKETS - 1;
+            }
+
+            /* Bounds of a bucket; the last one is bounded by the largest interval */
+            double lowerUs(int bucket) const
+            {
+                return (bucket == 0) ? 0.0 : 1000.0 * std::exp2((double)(bucket - 1) / STEPS_PER_OCTAVE);
+            }
+
+            double upperUs(int bucket) const
+            {
+                return (bucket == BUCKETS - 1) ? (double)maxUs : 1000.0 * std::exp2((double)bucket / STEPS_PER_OCTAVE);
+            }
+
+            void record(uint64_t us)
+            {
+                if (count == 0 || us < minUs)
+                {
+                    minUs = us;
+                }
+                if (us > maxUs)
+                {
+                    maxUs = us;
+                }
+                count++;
+                sumUs += us;
+                buckets[bucketOf(us)]++;
+            }
+
+            /* The interval the given fraction of the frames is at least as
+             * long as, interpolated within its bucket and clamped to the
+             * intervals seen */
+            double slowestUs(double fraction) const
+            {
+                if (count == 0)
+                {
+                    return 0.0;
+                }
+                double rank = fraction * count;
+                if (rank < 1.0)
+                {
+                    rank = 1.0;
+                }
+                double seen = 0.0;
+                for (int i = BUCKETS - 1; i >= 0; i--)
+                {
+                    if (buckets[i] == 0)
+                    {
+                        continue;
+                    }
+                    if (seen + buckets[i] >= rank)
+                    {
+                        double position = (rank - seen) / buckets[i];
+                        double us = upperUs(i) - position * (upperUs(i) - lowerUs(i));
+                        if (us > maxUs)
+                        {
+                            us = maxUs;
+                        }
+                        if (us < minUs)
+                        {
+                            us = minUs;
+                        }
+                        return us;
+                    }
+                    seen += buckets[i];
+                }
+                return minUs;
+            }
+
+            uint32_t count;
+            uint64_t sumUs;
+            uint64_t minUs;
+            uint64_t maxUs;
+            uint32_t buckets[BUCKETS];
+        };
+
+        /* Frame pacing of a collection window, from the presentation
+         * timestamps of the frames, delivered in batches: the histogram of
+         * the frame intervals, the 1% and 0.1% lows (the frame rate the
+         * slowest 1% and 0.1% of the frames are at) and the frames dropped,
+         * counted as the refresh periods an interval spans beyond the first
+         * one. */
+        class FrameTimeStats
+        {
+        public:
+            struct Summary
+            {
+                uint32_t frames;
+                uint32_t dropped;
+                double averageFps;
+                double low1Fps;
+                double low01Fps;
+                double minIntervalMs;
+                double maxIntervalMs;
+                /* Upper bound in ms and count of the buckets with frames */
+                std::vector<std::pair<double, uint32_t>> histogram;
+            };
+
+            explicit FrameTimeStats(double expectedFps = 60.0)
+                : m_lastUs(0)
+                , m_dropped(0)
+            {
+                setExpectedFps(expectedFps);
+            }
+
+            /* The refresh rate frames are expected at, for the dropped frames */
+            void setExpectedFps(double fps)
+            {
+                m_expectedUs = (fps > 0.0) ? 1000000.0 / fps : 1000000.0 / 60.0;
+            }
+
+            double expectedFps() const
+            {
+                return 1000000.0 / m_expectedUs;
+            }
+
+            /* Timestamps in microseconds on a monotonic clock. A timestamp not
+             * after the previous one starts over, as after a pause. Returns
+             * the number of intervals recorded. */
+            size_t addTimestamps(const uint64_t* timestamps, size_t count)
+            {
+                size_t recorded = 0;
+                for (size_t i = 0; i < count; i++)
+                {
+                    uint64_t us = timestamps[i];
+                    if (m_lastUs != 0 && us > m_lastUs)
+                    {
+                        addInterval(us - m_lastUs);
+                        recorded++;
+                    }
+                    m_lastUs = us;
+                }
+                return recorded;
+            }
+
+            void addInterval(uint64_t us)
+            {
+                m_histogram.record(us);
+                uint64_t periods = (uint64_t)(us / m_expectedUs + 0.5);
+                if (periods > 1)
+                {
+                    m_dropped += (uint32_t)(periods - 1);
+                }
+            }
+
+            uint32_t frames() const
+            {
+                return m_histogram.count;
+            }
+
+            void summary(Summary& summary) const
+            {
+                summary.frames = m_histogram.count;
+                summary.dropped = m_dropped;
+                summary.averageFps = toFps(m_histogram.count ? (double)m_histogram.sumUs / m_histogram.count : 0.0);
+                summary.low1Fps = toFps(m_histogram.slowestUs(0.01));
+                summary.low01Fps = toFps(m_histogram.slowestUs(0.001));
+                summary.minIntervalMs = m_histogram.minUs / 1000.0;
+                summary.maxIntervalMs = m_histogram.maxUs / 1000.0;
+                summary.histogram.clear();
+                for (int i = 0; i < FrameTimeHistogram::BUCKETS; i++)
+                {
+                    if (m_histogram.buckets[i] > 0)
+                    {
+                        summary.histogram.push_back(std::make_pair(m_histogram.upperUs(i) / 1000.0, m_histogram.buckets[i]));
+                    }
+                }
+            }
+
+            /* A new window; the last timestamp is kept, the interval spanning
+             * the windows counts in the new one */
+            void nextWindow()
+            {
+                m_histogram.reset();
+                m_dropped = 0;
+            }
+
+            void reset()
+            {
+                nextWindow();
+                m_lastUs = 0;
+            }
+
+        private:
+            static double toFps(double us)
+            {
+                return (us > 0.0) ? 1000000.0 / us : 0.0;
+            }
+
+            FrameTimeHistogram m_histogram;
+            double m_expectedUs;
+            uint64_t m_lastUs;
+            uint32_t m_dropped;
+        };
+
+    } // namespace Plugin
+} // namespace WPEFramework
@@ -0,0 +1,146 @@
+/**
+* If not stated otherwise in this file or this component's LICENSE
+* file the following copyright and licenses apply:
+*
+* Copyright 2019 RDK Management
+*
+* Licensed under the Apache License, Version 2.0 (the "License");
+* you may not use this file except in compliance with the License.
+* You may obtain a copy of the License at
+*
+* http://www.apache.org/licenses/LICENSE-2.0
+*
+* Unless required by applicable law or agreed to in writing, software
+* distributed under the License is distributed on an "AS IS" BASIS,
+* WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+* See the License for the specific language governing permissions and
+* limitations under the License.
+**/
+
+#pragma once
+
+#include <stdint.h>
+#include <algorithm>
+#include <chrono>
+#include <mutex>
+
+namespace WPEFramework {
+
+    namespace Plugin {
+
+        /* Decides which logical addresses are pinged in a poll cycle.
+         * Addresses that answered (or sent us a message) are checked every
+         * base interval so a removal is noticed. Addresses that did not answer
+         * back off exponentially up to the max interval; a hotplug resets the
+         * schedule so the whole bus is pinged again right away. */
+        class CecPollScheduler {
+        public:
+            typedef std::chrono::steady_clock Clock;
+
+            static const int MAX_ADDRESSES = 15;
+
+            CecPollScheduler(uint32_t baseIntervalMs, uint32_t maxIntervalMs)
+                : m_baseIntervalMs(baseIntervalMs)
+                , m_maxIntervalMs(std::max(baseIntervalMs, maxIntervalMs))
+            {
+                reset();
+            }
+
+            CecPollScheduler(const CecPollScheduler&) = delete;
+            CecPollScheduler& operator=(const CecPollScheduler&) = delete;
+
+            /* Every address becomes due now. */
+            void reset()
+            {
+                std::lock_guard<std::mutex> lock(m_mutex);
+                Clock::time_point now = Clock::now();
+                for (int i = 0; i < MAX_ADDRESSES; i++) {
+                    m_intervalMs[i] = m_baseIntervalMs;
+                    m_next[i] = now;
+                }
+            }
+
+            /* The address acked a ping or sent a message. */
+            void onPresent(int address, Clock::time_point now = Clock::now())
+            {
+                if (!isValid(address))
+                    return;
+                std::lock_guard<std::mutex> lock(m_mutex);
+                m_intervalMs[address] = m_baseIntervalMs;
+                m_next[address] = now + std::chrono::milliseconds(m_baseIntervalMs);
+            }
+
+            /* The address did not ack a ping. */
+            void onAbsent(int address, Clock::time_point now = Clock::now())
+            {
+                if (!isValid(address))
+                    return;
+                std::lock_guard<std::mutex> lock(m_mutex);
+                m_next[address] = now + std::chrono::milliseconds(m_intervalMs[address]);
+                m_intervalMs[address] = std::min(m_intervalMs[address] * 2, m_maxIntervalMs);
+            }
+
+            bool isDue(int address, Clock::time_point now = Clock::now())
+            {
+                if (!isValid(address))
+                    return false;
+                std::lock_guard<std::mutex> lock(m_mutex);
+                return m_next[address] <= now;
+            }
+
+            /* One poll cycle: pings every due address other than self, in
+             * order, with ping(address) returning whether it was acked, and
+             * reschedules each address from the answer. */
+            template <typename PING>
+            void pingDue(int self, PING ping, Clock::time_point now = Clock::now())
+            {
+                for (int i = 0; i < MAX_ADDRESSES; i++) {
+                    if (i == self || !isDue(i, now))
+                        continue;
+                    if (ping(i))
+                        onPresent(i, now);
+                    else
+                        onAbsent(i, now);
+                }
+            }
+
+            /* Time until the next address other than skip is due, capped at
+             * the base interval. */
+            uint32_t timeToNextDueMs(int skip, Clock::time_point now = Clock::now())
+            {
+                std::lock_guard<std::mutex> lock(m_mutex);
+                uint32_t result = m_baseIntervalMs;
+                for (int i = 0; i < MAX_ADDRESSES; i++) {
+                    if (i == skip)
+                        continue;
+                    if (m_next[i] <= now)
+                        return 0;
+                    uint32_t remaining = std::chrono::duration_cast<std::chrono::milliseconds>(m_next[i] - now).count();
+                    result = std::min(result, remaining);
+                }
+                return result;
+            }
+
+            uint32_t intervalMs(int address)
+            {
+                if (!isValid(address))
+                    return 0;
+                std::lock_guard<std::mutex> lock(m_mutex);
+                return m_intervalMs[address];
+            }
+
+        private:
+            static bool isValid(int address)
+            {
+                return address >= 0 && address < MAX_ADDRESSES;
+            }
+
+            std::mutex m_mutex;
+            const uint32_t m_baseIntervalMs;
+            const uint32_t m_maxIntervalMs;
+            uint32_t m_intervalMs[MAX_ADDRESSES];
+            Clock::time_point m_next[MAX_ADDRESSES];
+        };
+
+    } // namespace Plugin
+} // namespace WPEFramework
@@ -67,6 +67,8 @@
 #define HDMICECSINK_REQUEST_MAX_RETRY 				3
 #define HDMICECSINK_REQUEST_MAX_WAIT_TIME_MS 		2000
 #define HDMICECSINK_PING_INTERVAL_MS 				10000
+#define HDMICECSINK_PING_MAX_INTERVAL_MS 			(8 * HDMICECSINK_PING_INTERVAL_MS)
+#define HDMICECSINK_PING_GAP_MS 					20
 #define HDMICECSINK_WAIT_FOR_HDMI_IN_MS 			1000
 #define HDMICECSINK_REQUEST_INTERVAL_TIME_MS 		200
 #define HDMICECSINK_NUMBER_TV_ADDR 					2
@@ -496,6 +498,7 @@ namespace WPEFramework
 
        HdmiCecSink::HdmiCecSink()
        : AbstractPlugin()
+       , m_pollScheduler(HDMICECSINK_PING_INTERVAL_MS, HDMICECSINK_PING_MAX_INTERVAL_MS)
        {
        	   int err;
            LOGWARN("Initlaizing HdmiCecSink");
@@ -861,6 +864,8 @@ namespace WPEFramework
                         }
 			CheckHdmiInState();
 
+          /* Something changed on the bus, ping every address again */
+          m_pollScheduler.reset();
           m_pollNextState = POLL_THREAD_STATE_PING;
           m_ThreadExitCV.notify_one();
           updateArcState();  
@@ -1936,8 +1941,6 @@ namespace WPEFramework
                  }
 	void HdmiCecSink::pingDevices(std::vector<int> &connected , std::vector<int> &disconnected)
         {
-        	int i;
-
 		if(!HdmiCecSink::_instance)
                 return;
                 if(!(_instance->smConnection))
@@ -1948,38 +1951,37 @@ namespace WPEFramework
 				return;
 			}
 			
-            for(i=0; i< LogicalAddress::UNREGISTERED; i++ ) {
-				if ( i != _instance->m_logicalAddressAllocated )
+			/* Devices that talked to us recently and addresses that keep
+			 * not answering are not due, the scheduler skips them to keep the line free */
+			_instance->m_pollScheduler.pingDue(_instance->m_logicalAddressAllocated, [&connected, &disconnected](int i) -> bool {
+				bool acked = true;
+				//LOGWARN("PING for  0x%x \r\n",i);
+				try {
+					_instance->smConnection->ping(LogicalAddress(_instance->m_logicalAddressAllocated), LogicalAddress(i), Throw_e());
+				}
+				catch(CECNoAckException &e)
 				{
-					//LOGWARN("PING for  0x%x \r\n",i);
-					try {
-						_instance->smConnection->ping(LogicalAddress(_instance->m_logicalAddressAllocated), LogicalAddress(i), Throw_e());
-					}
-					catch(CECNoAckException &e)
-					{
-						if ( _instance->deviceList[i].m_isDevicePresent ) {
-							disconnected.push_back(i);
-						}
-                                                //LOGWARN("Ping device: 0x%x caught %s \r\n", i, e.what());
-						usleep(50000);
-						continue;
+					if ( _instance->deviceList[i].m_isDevicePresent ) {
+						disconnected.push_back(i);
 					}
-					  catch(Exception &e)
-					  {
-						LOGWARN("Ping device: 0x%x caught %s \r\n", i, e.what());
-                                                usleep(50000);
-                                                continue;
-					  }
-					  
-					  /* If we get ACK, then the device is present in the network*/
-					  if ( !_instance->deviceList[i].m_isDevicePresent )
-					  {
-					  	connected.push_back(i);
-                                                //LOGWARN("Ping success, added device: 0x%x \r\n", i);
-					  }
-					  usleep(50000);      
+					//LOGWARN("Ping device: 0x%x caught %s \r\n", i, e.what());
+					acked = false;
+				}
+				catch(Exception &e)
+				{
+					LOGWARN("Ping device: 0x%x caught %s \r\n", i, e.what());
+					acked = false;
 				}
-           	}
+
+				/* If we get ACK, then the device is present in the network*/
+				if ( acked && !_instance->deviceList[i].m_isDevicePresent )
+				{
+					connected.push_back(i);
+					//LOGWARN("Ping success, added device: 0x%x \r\n", i);
+				}
+				usleep(HDMICECSINK_PING_GAP_MS * 1000);
+				return acked;
+			});
         }
 
 		int HdmiCecSink::requestType( const int logicalAddress ) {
@@ -2193,12 +2195,17 @@ namespace WPEFramework
 				return;
 			}
 			
+			/* Any message from the device proves it is there, no need to ping it */
+			_instance->m_pollScheduler.onPresent(logicalAddress);
+
 			if ( !HdmiCecSink::_instance->deviceList[logicalAddress].m_isDevicePresent )
 			 {
 			 	HdmiCecSink::_instance->deviceList[logicalAddress].m_isDevicePresent = true;
 				HdmiCecSink::_instance->deviceList[logicalAddress].m_logicalAddress = LogicalAddress(logicalAddress);
 				HdmiCecSink::_instance->m_numberOfDevices++;
+				/* Start the info requests right away instead of at the next poll */
 				HdmiCecSink::_instance->m_pollNextState = POLL_THREAD_STATE_INFO;
+				HdmiCecSink::_instance->m_ThreadExitCV.notify_one();
 
 				if(logicalAddress == 0x5)
 				{
@@ -2463,7 +2470,6 @@ namespace WPEFramework
         	int i;
 			std::vector <int> connected;
 			std::vector <int> disconnected;
-			int logicalAddressRequested = LogicalAddress::UNREGISTERED + TEST_ADD;
 			bool isExit = false;
 
 			if(!HdmiCecSink::_instance)
@@ -2513,6 +2519,7 @@ namespace WPEFramework
 						_instance->smConnection->sendTo(LogicalAddress(LogicalAddress::BROADCAST), 
 								MessageEncoder().encode(ReportPhysicalAddress(physical_addr, _instance->deviceList[_instance->m_logicalAddressAllocated].m_deviceType)), 100);
 
+						_instance->m_pollScheduler.reset();
 						_instance->m_sleepTime = 0;
 						_instance->m_pollThreadState = POLL_THREAD_STATE_PING;
 					}
@@ -2562,42 +2569,46 @@ namespace WPEFramework
 				case POLL_THREAD_STATE_INFO :
 				{
 					//LOGINFO("POLL_THREAD_STATE_INFO");
+					bool isPending = false;
 
-					if ( logicalAddressRequested == LogicalAddress::UNREGISTERED + TEST_ADD )
+					/* Requests to different devices are kept in flight together,
+					 * each device gets its next request as soon as the previous one is answered */
+					for(i=0;i<LogicalAddress::UNREGISTERED + TEST_ADD;i++)
 					{
-						for(i=0;i<LogicalAddress::UNREGISTERED + TEST_ADD;i++)
+						if( i == _instance->m_logicalAddressAllocated ||
+							!_instance->deviceList[i].m_isDevicePresent )
 						{
-							if( i != _instance->m_logicalAddressAllocated &&
-								_instance->deviceList[i].m_isDevicePresent &&
-								!_instance->deviceList[i].isAllUpdated() )
-							{
-								//LOGINFO("POLL_THREAD_STATE_INFO -> request for %d", i);
-								logicalAddressRequested = i;
-								_instance->request(logicalAddressRequested);
-								_instance->m_sleepTime = HDMICECSINK_REQUEST_INTERVAL_TIME_MS;
-								break;
-							}
+							continue;
 						}
 
-						if ( i ==  LogicalAddress::UNREGISTERED)
+						if ( _instance->deviceList[i].m_isRequested != CECDeviceParams::REQUEST_NONE &&
+							_instance->requestStatus(i) == CECDeviceParams::REQUEST_NOT_DONE )
 						{
-							/*So there is no update required, try to ping after some seconds*/
-							_instance->m_pollThreadState = POLL_THREAD_STATE_IDLE;		
-							_instance->m_sleepTime = 0;
-							//LOGINFO("POLL_THREAD_STATE_INFO -> state change to Ping", i);
+							isPending = true;
+							continue;
+						}
+
+						if ( !_instance->deviceList[i].isAllUpdated() )
+						{
+							//LOGINFO("POLL_THREAD_STATE_INFO -> request for %d", i);
+							_instance->request(i);
+							if ( _instance->deviceList[i].m_isRequested != CECDeviceParams::REQUEST_NONE )
+							{
+								isPending = true;
+							}
 						}
 					}
+
+					if ( isPending )
+					{
+						_instance->m_sleepTime = HDMICECSINK_REQUEST_INTERVAL_TIME_MS;
+					}
 					else
 					{
-						/*So there is request sent for logical address, so wait and check the status */
-						if ( _instance->requestStatus(logicalAddressRequested) == CECDeviceParams::REQUEST_DONE )
-						{
-							logicalAddressRequested = LogicalAddress::UNREGISTERED;
-						}
-						else
-						{
-							_instance->m_sleepTime = HDMICECSINK_REQUEST_INTERVAL_TIME_MS;							
-						}
+						/*So there is no update required, try to ping after some seconds*/
+						_instance->m_pollThreadState = POLL_THREAD_STATE_IDLE;
+						_instance->m_sleepTime = 0;
+						//LOGINFO("POLL_THREAD_STATE_INFO -> state change to Ping", i);
 					}
 				}
 				break;
@@ -2632,7 +2643,7 @@ namespace WPEFramework
 				case POLL_THREAD_STATE_IDLE :
 				{
 					//LOGINFO("POLL_THREAD_STATE_IDLE");
-					_instance->m_sleepTime = HDMICECSINK_PING_INTERVAL_MS;
+					_instance->m_sleepTime = _instance->m_pollScheduler.timeToNextDueMs(_instance->m_logicalAddressAllocated);
 					_instance->m_pollThreadState = POLL_THREAD_STATE_PING;
 				}
 				break;
@@ -2661,7 +2672,7 @@ namespace WPEFramework
 				std::unique_lock<std::mutex> lk(_instance->m_pollExitMutex);
 				if ( _instance->m_ThreadExitCV.wait_for(lk, std::chrono::milliseconds(_instance->m_sleepTime)) == std::cv_status::timeout )
 					continue;
-				else
+				else if ( _instance->m_pollThreadExit )
 					LOGINFO("Thread is going to Exit m_pollThreadExit %d\n", _instance->m_pollThreadExit );
 
 			}
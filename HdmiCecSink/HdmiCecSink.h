@@ -35,6 +35,7 @@
 #include "utils.h"
 #include "AbstractPlugin.h"
 #include "tptimer.h"
+#include "CecPollScheduler.h"
 #include <thread>
 #include <mutex>
 #include <condition_variable>
@@ -604,6 +605,7 @@ private:
 			uint32_t m_pollNextState;
 			bool m_pollThreadExit;
 			uint32_t m_sleepTime;
+			CecPollScheduler m_pollScheduler;
             std::mutex m_pollExitMutex;
             std::mutex m_enableMutex;
             /* Send Key event related */
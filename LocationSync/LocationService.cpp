@@ -299,6 +299,14 @@ namespace Plugin {
         { _TXT("ip-api.com"), []() -> Core::ProxyType<IGeography> { return (Core::ProxyType<IGeography>(Core::ProxyType<Plugin::IPAPI>::Create())); } }
     };
 
+    // A time to live of more than a day is waited for a day at a time, Dispatch waits again while it did not expire
+    static uint32_t RefreshWait(const uint64_t milliseconds)
+    {
+        static constexpr uint32_t MaxWait = 24 * 60 * 60 * 1000;
+
+        return (milliseconds < MaxWait ? static_cast<uint32_t>(milliseconds) : MaxWait);
+    }
+
     static DomainConstructor* FindDomain(const Core::URL& domain)
     {
         uint32_t index = 0;
@@ -320,6 +328,11 @@ namespace Plugin {
         , _remoteId()
         , _sourceNode()
         , _tryInterval(0)
+        , _retries(0)
+        , _maxRetries(0)
+        , _timeToLive(0)
+        , _refreshAt(0)
+        , _factory(nullptr)
         , _callback(callback)
         , _publicIPAddress()
         , _timeZone()
@@ -372,6 +385,8 @@ namespace Plugin {
 
                     // it runs till zero, so subtract by definition 1 :-)
                     _retries = (retries - 1);
+                    _maxRetries = retries;
+                    _refreshAt = 0;
                     _tryInterval = retryTimeSpan * 1000; // Move from seconds to mS.
                     _request->Host = hostName;
                     _request->Verb = Web::Request::HTTP_GET;
@@ -392,7 +407,8 @@ namespace Plugin {
                         _request->Query = info.Query().Value();
                     }
 
-                    _infoCarrier = constructor->factory();
+                    _factory = constructor->factory;
+                    _infoCarrier = _factory();
 
                     _activity.Submit();
 
@@ -406,6 +422,22 @@ namespace Plugin {
         return (result);
     }
 
+    void LocationService::Provisional(const string& publicIPAddress, const string& timeZone, const string& country, const string& region, const string& city)
+    {
+        _adminLock.Lock();
+
+        // Never over a result of this run
+        if (_state != LOADED) {
+            _publicIPAddress = publicIPAddress;
+            _timeZone = timeZone;
+            _country = country;
+            _region = region;
+            _city = city;
+        }
+
+        _adminLock.Unlock();
+    }
+
     void LocationService::Stop()
     {
         _adminLock.Lock();
@@ -532,6 +564,21 @@ namespace Plugin {
 
             _adminLock.Lock();
 
+            if (((_state == LOADED) || (_state == FAILED)) && (_refreshAt != 0) && (_factory != nullptr)) {
+                uint64_t now = Core::Time::Now().Ticks();
+
+                if (now >= _refreshAt) {
+                    // The result expired, probe again
+                    TRACE(Trace::Information, (_T("Location expired, probing again")));
+                    _refreshAt = 0;
+                    _state = ACTIVE;
+                    _retries = (_maxRetries - 1);
+                    _infoCarrier = _factory();
+                } else {
+                    result = RefreshWait((_refreshAt - now) / Core::Time::TicksPerMillisecond);
+                }
+            }
+
             if (_state == IPV4_INPROGRESS) {
                 _state = (_retries-- == 0 ? FAILED : ACTIVE);
             }
@@ -578,6 +625,12 @@ namespace Plugin {
                 _infoCarrier.Release();
             }
 
+            if (((_state == LOADED) || (_state == FAILED)) && (_refreshAt == 0) && (_timeToLive != 0)) {
+                const uint64_t timeToLive = static_cast<uint64_t>(_timeToLive) * 1000;
+                _refreshAt = Core::Time::Now().Ticks() + (timeToLive * Core::Time::TicksPerMillisecond);
+                result = RefreshWait(timeToLive);
+            }
+
             _adminLock.Unlock();
         }
 
@@ -68,6 +68,24 @@ namespace Plugin {
         uint32_t Probe(const string& remoteNode, const uint32_t retries, const uint32_t retryTimeSpan);
         void Stop();
 
+        // A result is probed again once it is older than the time to live (in seconds), zero never.
+        void TimeToLive(const uint32_t timeToLive)
+        {
+            _adminLock.Lock();
+            _timeToLive = timeToLive;
+            _adminLock.Unlock();
+        }
+        // Whether the last probe succeeded
+        bool Loaded()
+        {
+            _adminLock.Lock();
+            bool loaded = (_state == LOADED);
+            _adminLock.Unlock();
+            return (loaded);
+        }
+        // A previous result, reported until the probe replaces it
+        void Provisional(const string& publicIPAddress, const string& timeZone, const string& country, const string& region, const string& city);
+
         /*
         * ------------------------------------------------------------------------------------------------------------
         * ISubSystem::INetwork methods
@@ -122,6 +140,10 @@ namespace Plugin {
         Core::NodeId _sourceNode;
         uint32_t _tryInterval;
         uint32_t _retries;
+        uint32_t _maxRetries;
+        uint32_t _timeToLive; // Seconds
+        uint64_t _refreshAt;
+        Core::ProxyType<IGeography> (*_factory)();
         Core::IDispatch* _callback;
         string _publicIPAddress;
         string _timeZone;
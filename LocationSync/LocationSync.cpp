@@ -33,6 +33,9 @@ namespace Plugin {
     LocationSync::LocationSync()
         : _skipURL(0)
         , _source()
+        , _storePath()
+        , _published(false)
+        , _location()
         , _sink(this)
         , _service(nullptr)
     {
@@ -58,8 +61,12 @@ namespace Plugin {
             _skipURL = static_cast<uint16_t>(service->WebPrefix().length());
             _source = config.Source.Value();
             _service = service;
+            _storePath = service->PersistentPath() + _T("location.json");
 
-            _sink.Initialize(config.Source.Value(), config.Interval.Value(), config.Retries.Value());
+            // What the previous run found is published right away, the probe refreshes it in the background
+            Restore(config.MaxAge.Value());
+
+            _sink.Initialize(config.Source.Value(), config.Interval.Value(), config.Retries.Value(), config.TimeToLive.Value());
         } else {
             result = _T("URL for retrieving location is incorrect !!!");
         }
@@ -142,21 +149,92 @@ namespace Plugin {
     }
 
     void LocationSync::SyncedLocation()
+    {
+        bool loaded = _sink.Loaded();
+
+        Publish();
+
+        if (loaded == true) {
+            Store();
+        }
+    }
+
+    // The subsystems are set on the first result, even a failed one, so nothing waits for them forever.
+    // After that only changes are published.
+    void LocationSync::Publish()
     {
         PluginHost::ISubSystem* subSystem = _service->SubSystems();
 
         ASSERT(subSystem != nullptr);
 
         if (subSystem != nullptr) {
+            const string location = _sink.Network()->PublicIPAddress() + '\n' + _sink.Location()->TimeZone() + '\n' + _sink.Location()->Country() + '\n' + _sink.Location()->Region() + '\n' + _sink.Location()->City();
+            const bool changed = (location != _location);
 
-            subSystem->Set(PluginHost::ISubSystem::INTERNET, _sink.Network());
-            subSystem->Set(PluginHost::ISubSystem::LOCATION, _sink.Location());
+            if ((_published == false) || (changed == true)) {
+                subSystem->Set(PluginHost::ISubSystem::INTERNET, _sink.Network());
+                subSystem->Set(PluginHost::ISubSystem::LOCATION, _sink.Location());
+                _published = true;
+            }
             subSystem->Release();
 
-            if ((_sink.Location() != nullptr) && (_sink.Location()->TimeZone().empty() == false)) {
+            if ((changed == true) && (_sink.Location()->TimeZone().empty() == false)) {
                 Core::SystemInfo::SetEnvironment(_T("TZ"), _sink.Location()->TimeZone());
                 event_locationchange();
             }
+
+            _location = location;
+        }
+    }
+
+    // A stored location older than the maximum age (in seconds, zero for any age) is not published.
+    // The time of a device yet to set its clock is before any stored, that location is published.
+    void LocationSync::Restore(const uint32_t maxAge)
+    {
+        Core::File file(_storePath);
+
+        if (file.Open(true) == true) {
+            Persisted stored;
+            bool valid = stored.IElement::FromFile(file);
+            file.Close();
+
+            const uint64_t now = Core::Time::Now().Ticks() / (Core::Time::TicksPerMillisecond * 1000);
+
+            if ((valid == true) && (maxAge != 0) && (now > stored.Timestamp.Value()) && ((now - stored.Timestamp.Value()) > maxAge)) {
+                TRACE(Trace::Information, (_T("Stored location of %llu is too old"), static_cast<unsigned long long>(stored.Timestamp.Value())));
+                valid = false;
+            }
+
+            // A location of another source may not even have its time zone in the same format
+            if ((valid == true) && (stored.Source.Value() == _source) && (stored.TimeZone.Value().empty() == false)) {
+                TRACE(Trace::Information, (_T("Provisional location of %llu: %s"), static_cast<unsigned long long>(stored.Timestamp.Value()), stored.TimeZone.Value().c_str()));
+
+                _sink.Provisional(stored);
+                Publish();
+            }
+        }
+    }
+
+    void LocationSync::Store()
+    {
+        Persisted stored;
+        stored.PublicIp = _sink.Network()->PublicIPAddress();
+        stored.TimeZone = _sink.Location()->TimeZone();
+        stored.Region = _sink.Location()->Region();
+        stored.Country = _sink.Location()->Country();
+        stored.City = _sink.Location()->City();
+        stored.Source = _source;
+        stored.Timestamp = Core::Time::Now().Ticks() / (Core::Time::TicksPerMillisecond * 1000);
+
+        Core::Directory(_service->PersistentPath().c_str()).CreatePath();
+
+        Core::File file(_storePath);
+
+        if (file.Create() == true) {
+            stored.IElement::ToFile(file);
+            file.Close();
+        } else {
+            TRACE(Trace::Error, (_T("Could not store the location in %s"), _storePath.c_str()));
         }
     }
 
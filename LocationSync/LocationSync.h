@@ -61,6 +61,45 @@ namespace Plugin {
             Core::JSON::String City;
         };
 
+        // The last location probed, published provisionally at the next start
+        class Persisted : public Core::JSON::Container {
+        public:
+            Persisted(Persisted const& other) = delete;
+            Persisted& operator=(Persisted const& other) = delete;
+
+            Persisted()
+                : Core::JSON::Container()
+                , PublicIp()
+                , TimeZone()
+                , Region()
+                , Country()
+                , City()
+                , Source()
+                , Timestamp(0)
+            {
+                Add(_T("ip"), &PublicIp);
+                Add(_T("timezone"), &TimeZone);
+                Add(_T("region"), &Region);
+                Add(_T("country"), &Country);
+                Add(_T("city"), &City);
+                Add(_T("source"), &Source);
+                Add(_T("timestamp"), &Timestamp);
+            }
+
+            ~Persisted() override
+            {
+            }
+
+        public:
+            Core::JSON::String PublicIp;
+            Core::JSON::String TimeZone;
+            Core::JSON::String Region;
+            Core::JSON::String Country;
+            Core::JSON::String City;
+            Core::JSON::String Source;
+            Core::JSON::DecUInt64 Timestamp; // Seconds since the epoch
+        };
+
     private:
         class Notification : public Core::IDispatch {
         private:
@@ -90,12 +129,14 @@ namespace Plugin {
             }
 
         public:
-            inline void Initialize(const string& source, const uint16_t interval, const uint8_t retries)
+            inline void Initialize(const string& source, const uint16_t interval, const uint8_t retries, const uint32_t timeToLive)
             {
                 _source = source;
                 _interval = interval;
                 _retries = retries;
 
+                _locator->TimeToLive(timeToLive);
+
                 Probe();
             }
             inline void Deinitialize()
@@ -110,6 +151,15 @@ namespace Plugin {
                 return (Probe());
             }
 
+            inline void Provisional(const Persisted& stored)
+            {
+                _locator->Provisional(stored.PublicIp.Value(), stored.TimeZone.Value(), stored.Country.Value(), stored.Region.Value(), stored.City.Value());
+            }
+            inline bool Loaded()
+            {
+                return (_locator->Loaded());
+            }
+
             inline PluginHost::ISubSystem::ILocation* Location()
             {
                 return (_locator);
@@ -151,10 +201,14 @@ namespace Plugin {
                 : Interval(30)
                 , Retries(8)
                 , Source()
+                , TimeToLive(86400)
+                , MaxAge(2592000)
             {
                 Add(_T("interval"), &Interval);
                 Add(_T("retries"), &Retries);
                 Add(_T("source"), &Source);
+                Add(_T("ttl"), &TimeToLive);
+                Add(_T("maxage"), &MaxAge);
             }
             ~Config()
             {
@@ -164,6 +218,8 @@ namespace Plugin {
             Core::JSON::DecUInt16 Interval;
             Core::JSON::DecUInt8 Retries;
             Core::JSON::String Source;
+            Core::JSON::DecUInt32 TimeToLive;
+            Core::JSON::DecUInt32 MaxAge;
         };
 
     private:
@@ -201,10 +257,16 @@ namespace Plugin {
         void event_locationchange();
 
         void SyncedLocation();
+        void Restore(const uint32_t maxAge);
+        void Store();
+        void Publish();
 
     private:
         uint16_t _skipURL;
         string _source;
+        string _storePath;
+        bool _published;
+        string _location;
         Core::Sink<Notification> _sink;
         PluginHost::IShell* _service;
     };
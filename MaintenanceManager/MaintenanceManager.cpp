@@ -39,6 +39,7 @@
 
 #include "MaintenanceManager.h"
 #include "utils.h"
+#include "UtilsJsonRpcDirectLink.h"
 
 #if defined(USE_IARMBUS) || defined(USE_IARM_BUS)
 #include "libIARM.h"
@@ -171,14 +172,6 @@ namespace WPEFramework {
 
         cSettings MaintenanceManager::m_setting(MAINTENANCE_MGR_RECORD_FILE);
 
-        string task_names_foreground[]={
-            "/lib/rdk/RFCbase.sh",
-            "/lib/rdk/swupdate_utility.sh >> /opt/logs/swupdate.log",
-            "/lib/rdk/Start_uploadSTBLogs.sh"
-        };
-
-        vector<string> tasks;
-
         string script_names[]={
             "DCMscript_maintaince.sh",
             "RFCbase.sh",
@@ -186,6 +179,22 @@ namespace WPEFramework {
             "uploadSTBLogs.sh"
         };
 
+        /* scheduler task of each entry in script_names */
+        string task_names[]={
+            MAINT_TASK_DCM,
+            MAINT_TASK_RFC,
+            MAINT_TASK_SWUPDATE,
+            MAINT_TASK_LOGUPLOAD
+        };
+
+        /* status bits (success, complete) set when a task ends */
+        const std::map<string, std::pair<uint8_t, uint8_t>> task_status_bits={
+            { MAINT_TASK_DCM,       { DCM_SUCCESS,       DCM_COMPLETE } },
+            { MAINT_TASK_RFC,       { RFC_SUCCESS,       RFC_COMPLETE } },
+            { MAINT_TASK_SWUPDATE,  { DIFD_SUCCESS,      DIFD_COMPLETE } },
+            { MAINT_TASK_LOGUPLOAD, { LOGUPLOAD_SUCCESS, LOGUPLOAD_COMPLETE } }
+        };
+
         /**
          * Register MaintenanceManager module as wpeframework plugin
          */
@@ -206,30 +215,235 @@ namespace WPEFramework {
             registerMethod("startMaintenance", &MaintenanceManager::startMaintenance,this);
             registerMethod("stopMaintenance", &MaintenanceManager::stopMaintenance,this);
             registerMethod("getMaintenanceMode", &MaintenanceManager::getMaintenanceMode,this);
+            registerMethod("getMaintenanceTaskDurations", &MaintenanceManager::getMaintenanceTaskDurations,this);
 
 
-            MaintenanceManager::m_task_map["/lib/rdk/StartDCM_maintaince.sh"]=false;
-            MaintenanceManager::m_task_map[task_names_foreground[0].c_str()]=false;
-            MaintenanceManager::m_task_map[task_names_foreground[1].c_str()]=false;
-            MaintenanceManager::m_task_map[task_names_foreground[2].c_str()]=false;
-
+            MaintenanceManager::m_task_map[MAINT_TASK_DCM]=false;
+            MaintenanceManager::m_task_map[MAINT_TASK_RFC]=false;
+            MaintenanceManager::m_task_map[MAINT_TASK_SWUPDATE]=false;
+            MaintenanceManager::m_task_map[MAINT_TASK_LOGUPLOAD]=false;
 
+            m_scheduler.setMaxConcurrency(MAINT_DEFAULT_MAX_CONCURRENCY);
+            m_scheduler.setStateCallback([this](const string& name, MaintenanceTaskScheduler::TaskState state) {
+                onTaskStateChange(name, state);
+            });
          }
 
-        void MaintenanceManager::task_execution_thread(){
-            uint8_t i=0;
-            string cmd="";
-            bool internetConnectStatus=false;
+        bool MaintenanceManager::isTaskActive(const string& name)
+        {
+            std::lock_guard<std::mutex> lock(m_taskMapMutex);
+            auto task = m_task_map.find(name);
+            return (task != m_task_map.end()) && task->second;
+        }
+
+        void MaintenanceManager::setTaskActive(const string& name, bool active)
+        {
+            std::lock_guard<std::mutex> lock(m_taskMapMutex);
+            m_task_map[name] = active;
+        }
+
+        /* Clears the task, returning whether it was active, so that only one
+         * of its IARM event and its end in the scheduler accounts for it */
+        bool MaintenanceManager::takeTaskActive(const string& name)
+        {
+            std::lock_guard<std::mutex> lock(m_taskMapMutex);
+            auto task = m_task_map.find(name);
+            if ((task == m_task_map.end()) || !task->second) {
+                return false;
+            }
+            task->second = false;
+            return true;
+        }
+
+        /* Task graph of one maintenance cycle. RFC settings apply to the
+         * software update and the log upload, so both wait for RFC and may
+         * then run side by side. */
+        std::vector<MaintenanceTaskScheduler::Task> MaintenanceManager::buildTaskGraph(bool waitForDCM, bool skipFirmwareCheck)
+        {
+            std::vector<MaintenanceTaskScheduler::Task> graph;
+            MaintenanceTaskScheduler::Task task;
+
+            task.completesOnExit = false;
+
+            if (waitForDCM) {
+                /* started on bootup, we only wait for its event */
+                task.name = MAINT_TASK_DCM;
+                graph.push_back(task);
+            }
+
+            task = MaintenanceTaskScheduler::Task();
+            task.completesOnExit = false;
+            task.name = MAINT_TASK_RFC;
+            task.script = "/lib/rdk/RFCbase.sh";
+            task.timeoutMs = 30 * 60 * 1000;
+            if (waitForDCM) {
+                task.dependencies.push_back(MAINT_TASK_DCM);
+            }
+            graph.push_back(task);
+
+            if (!skipFirmwareCheck) {
+                task = MaintenanceTaskScheduler::Task();
+                task.completesOnExit = false;
+                task.name = MAINT_TASK_SWUPDATE;
+                task.script = "/lib/rdk/swupdate_utility.sh";
+                task.logFile = "/opt/logs/swupdate.log";
+                task.timeoutMs = 30 * 60 * 1000;
+                task.dependencies.push_back(MAINT_TASK_RFC);
+                graph.push_back(task);
+            }
+
+            task = MaintenanceTaskScheduler::Task();
+            task.completesOnExit = false;
+            task.name = MAINT_TASK_LOGUPLOAD;
+            task.script = "/lib/rdk/Start_uploadSTBLogs.sh";
+            task.timeoutMs = 30 * 60 * 1000;
+            task.niceness = 10;
+            task.ioClass = MaintenanceTaskScheduler::IO_CLASS_BEST_EFFORT;
+            task.ioLevel = 7;
+            task.dependencies.push_back(MAINT_TASK_RFC);
+            graph.push_back(task);
+
+            /* apply the plugin configuration */
+            for (auto& entry : graph) {
+                auto found = m_task_overrides.find(entry.name);
+                if (found == m_task_overrides.end()) {
+                    continue;
+                }
+                const MaintenanceTaskScheduler::Task& config = found->second;
+                if (!config.script.empty()) {
+                    entry.script = config.script;
+                    entry.logFile = config.logFile;
+                }
+                if (!config.dependencies.empty()) {
+                    entry.dependencies = config.dependencies;
+                }
+                if (0 != config.niceness) {
+                    entry.niceness = config.niceness;
+                }
+                if (0 != config.timeoutMs) {
+                    entry.timeoutMs = config.timeoutMs;
+                }
+            }
+
+            /* drop dependencies on tasks that are not part of this cycle */
+            for (auto& entry : graph) {
+                auto& deps = entry.dependencies;
+                deps.erase(std::remove_if(deps.begin(), deps.end(), [&graph](const string& dep) {
+                    return std::none_of(graph.begin(), graph.end(), [&dep](const MaintenanceTaskScheduler::Task& other) {
+                        return other.name == dep;
+                    });
+                }), deps.end());
+            }
+
+            return graph;
+        }
+
+        void MaintenanceManager::configureTasks(const Config& config)
+        {
+            m_scheduler.setMaxConcurrency(config.MaxConcurrency.Value());
+
+            m_task_overrides.clear();
+            auto index(config.Tasks.Elements());
+            while (index.Next()) {
+                const Config::TaskConfig& entry = index.Current();
+                MaintenanceTaskScheduler::Task task;
+                task.name = entry.Name.Value();
+                task.script = entry.Script.Value();
+                task.logFile = entry.LogFile.Value();
+                task.niceness = entry.Nice.Value();
+                task.timeoutMs = entry.Timeout.Value();
+                auto deps(entry.Dependencies.Elements());
+                while (deps.Next()) {
+                    task.dependencies.push_back(deps.Current().Value());
+                }
+                LOGINFO("Task %s configured: script '%s' timeout %u", task.name.c_str(), task.script.c_str(), task.timeoutMs);
+                m_task_overrides[task.name] = task;
+            }
+        }
+
+        void MaintenanceManager::onTaskStateChange(const string& name, MaintenanceTaskScheduler::TaskState state)
+        {
+            LOGINFO("Task %s is %s", name.c_str(), MaintenanceTaskScheduler::stateToString(state));
+
+            if (MaintenanceTaskScheduler::TASK_RUNNING == state) {
+                /* DCM is started on bootup, the others accept events from now on */
+                if (name != MAINT_TASK_DCM) {
+                    setTaskActive(name, true);
+                }
+                return;
+            }
+
+            /* The task ended without its IARM event (timeout or abort); account
+             * for it here so that the maintenance cycle can still complete */
+            auto bits = task_status_bits.find(name);
+            if ((bits != task_status_bits.end()) && takeTaskActive(name)) {
+                LOGWARN("Task %s ended without a completion event", name.c_str());
+                if (MaintenanceTaskScheduler::TASK_SUCCESS == state) {
+                    SET_STATUS(g_task_status, bits->second.first);
+                }
+                SET_STATUS(g_task_status, bits->second.second);
+            }
+        }
+
+        /* Sends the final status of the cycle once all tasks completed. Both the
+         * IARM handler and the task thread get here; only the first one reports */
+        void MaintenanceManager::reportMaintenanceCompletion()
+        {
+            Maint_notify_status_t notify_status=MAINTENANCE_STARTED;
+            time_t successfulTime;
+            string str_successfulTime="";
+
+            if ( (g_task_status & TASKS_COMPLETED ) != TASKS_COMPLETED ){
+                return;
+            }
+
+            m_statusMutex.lock();
+            if ( MAINTENANCE_STARTED != m_notify_status ){
+                m_statusMutex.unlock();
+                return;
+            }
+
+            if ( (g_task_status & ALL_TASKS_SUCCESS) == ALL_TASKS_SUCCESS ){ // all tasks success
+                LOGINFO("DBG:Maintenance Successfully Completed!!");
+                notify_status=MAINTENANCE_COMPLETE;
+                /*  we store the time in persistant location */
+                successfulTime=time(nullptr);
+                tm ltime=*localtime(&successfulTime);
+                time_t epoch_time=mktime(&ltime);
+                str_successfulTime=to_string(epoch_time);
+                LOGINFO("last succesful time is :%s", str_successfulTime.c_str());
+                /* Remove any old completion time */
+                m_setting.remove("LastSuccessfulCompletionTime");
+                m_setting.setValue("LastSuccessfulCompletionTime",str_successfulTime);
 
-            /* cleanup if not empty */
-            if(!tasks.empty()){
-                tasks.erase (tasks.begin(),tasks.end());
             }
+            /* Check other than all success case which means we have errors */
+            else if ((g_task_status & ALL_TASKS_SUCCESS)!= ALL_TASKS_SUCCESS) {
+                if ((g_task_status & MAINTENANCE_TASK_SKIPPED ) == MAINTENANCE_TASK_SKIPPED ){
+                    LOGINFO("DBG:There are Skipped Task. Maintenance Incomplete");
+                    notify_status=MAINTENANCE_INCOMPLETE;
+                }
+                else {
+                    LOGINFO("DBG:Maintenance Ended with Errors");
+                    notify_status=MAINTENANCE_ERROR;
+                }
+
+            }
+
+            m_notify_status=notify_status;
+            m_statusMutex.unlock();
+
+            onMaintenanceStatusChange(notify_status);
+        }
+
+        void MaintenanceManager::task_execution_thread(){
+            bool internetConnectStatus=false;
+            bool skipFirmwareCheck=false;
+            bool waitForDCM=false;
 
             /* Controlled by CFLAGS */
 #if defined(SUPPRESS_MAINTENANCE)
             bool activationStatus=false;
-            bool skipFirmwareCheck=false;
 
             /* Activation check */
             activationStatus = getActivatedStatus(skipFirmwareCheck);
@@ -249,67 +463,43 @@ namespace WPEFramework {
             MaintenanceManager::_instance->onMaintenanceStatusChange(MAINTENANCE_STARTED);
 #if defined(SUPPRESS_MAINTENANCE)
             /* decide which all tasks are needed based on the activation status */
-            if (activationStatus){
-                if(skipFirmwareCheck){
-                    /* set the task status of swupdate */
-                    SET_STATUS(g_task_status,DIFD_SUCCESS);
-                    SET_STATUS(g_task_status,DIFD_COMPLETE);
-
-                    /* Add tasks */
-                    tasks.push_back("/lib/rdk/RFCbase.sh");
-                    tasks.push_back("/lib/rdk/Start_uploadSTBLogs.sh");
-                }else{
-                    tasks.push_back("/lib/rdk/RFCbase.sh");
-                    tasks.push_back("/lib/rdk/swupdate_utility.sh >> /opt/logs/swupdate.log");
-                    tasks.push_back("/lib/rdk/Start_uploadSTBLogs.sh");
-                }
+            if (activationStatus && skipFirmwareCheck){
+                /* set the task status of swupdate */
+                SET_STATUS(g_task_status,DIFD_SUCCESS);
+                SET_STATUS(g_task_status,DIFD_COMPLETE);
             }
-#else
-            tasks.push_back("/lib/rdk/RFCbase.sh");
-            tasks.push_back("/lib/rdk/swupdate_utility.sh >> /opt/logs/swupdate.log");
-            tasks.push_back("/lib/rdk/Start_uploadSTBLogs.sh");
 #endif
-            std::unique_lock<std::mutex> lck(m_callMutex);
-
-            // Unsolicited part comes here
-            if (UNSOLICITED_MAINTENANCE == g_maintenance_type && internetConnectStatus){
-                LOGINFO("---------------UNSOLICITED_MAINTENANCE--------------");
-                for( i = 0; i < tasks.size(); i++) {
-                    LOGINFO("waiting to unlock.. [%d/%d]",i,tasks.size());
-                    task_thread.wait(lck);
-                    cmd = tasks[i];
-                    cmd += " &";
-                    cmd += "\0";
-                    m_task_map[tasks[i]] = true;
-
-                    if ( !m_abort_flag ){
-                        LOGINFO("Starting Script (USM) :  %s \n", cmd.c_str());
-                        system(cmd.c_str());
+            if (internetConnectStatus){
+                if (UNSOLICITED_MAINTENANCE == g_maintenance_type){
+                    LOGINFO("---------------UNSOLICITED_MAINTENANCE--------------");
+                    /* RFC waits for the DCM script started on bootup */
+                    bool dcmActive = isTaskActive(MAINT_TASK_DCM);
+                    waitForDCM = dcmActive && !CHECK_STATUS(g_task_status,DCM_COMPLETE);
+                    if (!dcmActive && !CHECK_STATUS(g_task_status,DCM_COMPLETE)){
+                        /* DCM did not start on bootup, no event will come */
+                        LOGINFO("DCM is not running, not waiting for it");
+                        SET_STATUS(g_task_status,DCM_COMPLETE);
                     }
                 }
-            }
-            /* Here in Solicited, we start with RFC so no
-             * need to wait for any DCM events */
-            else if( SOLICITED_MAINTENANCE == g_maintenance_type && internetConnectStatus){
-                LOGINFO("=============SOLICITED_MAINTENANCE===============");
-                cmd = tasks[0];
-                cmd += " &";
-                cmd += "\0";
-                m_task_map[tasks[0]] = true;
-                LOGINFO("Starting Script (SM) :  %s \n", cmd.c_str());
-                system(cmd.c_str());
-                cmd="";
-                for( i = 1; i < tasks.size(); i++){
-                    LOGINFO("Waiting to unlock.. [%d/%d]",i,tasks.size());
-                    task_thread.wait(lck);
-                    cmd = tasks[i];
-                    cmd += " &";
-                    cmd += "\0";
-                    m_task_map[tasks[i]]=true;
-                    if ( !m_abort_flag ){
-                        LOGINFO("Starting Script (SM) :  %s \n",cmd.c_str());
-                        system(cmd.c_str());
+                else {
+                    /* Here in Solicited, we start with RFC so no
+                     * need to wait for any DCM events */
+                    LOGINFO("=============SOLICITED_MAINTENANCE===============");
+                }
+
+                if (m_scheduler.setTasks(buildTaskGraph(waitForDCM, skipFirmwareCheck))){
+                    /* DCM may have finished while the graph was being built */
+                    if (waitForDCM && CHECK_STATUS(g_task_status,DCM_COMPLETE)){
+                        m_scheduler.complete(MAINT_TASK_DCM, CHECK_STATUS(g_task_status,DCM_SUCCESS));
                     }
+                    if (m_abort_flag){
+                        m_scheduler.abort(false);
+                    }
+                    m_scheduler.run();
+                    reportMaintenanceCompletion();
+                }
+                else {
+                    LOGERR("Invalid maintenance task configuration");
                 }
             }
             m_abort_flag=false;
@@ -358,28 +548,21 @@ namespace WPEFramework {
 
             Utils::SecurityToken::getSecurityToken(token);
 
-            Core::SystemInfo::SetEnvironment(_T("THUNDER_ACCESS"), _T(SERVER_DETAILS));
-            auto thunder_client = make_shared<WPEFramework::JSONRPC::LinkType<WPEFramework::Core::JSON::IElement> >(callsign.c_str(), "");
-            if (thunder_client != nullptr) {
-                uint32_t status = thunder_client->Invoke<JsonObject, JsonObject>(5000, "getActivationStatus", joGetParams, joGetResult);
-                LOGINFO("Invoke status : %d",status);
-                if (status > 0) {
-                    LOGINFO("%s call failed %d", callsign.c_str(), status);
-                    ret_status = "invalid";
-                    LOGINFO("Setting Default to [%s]",ret_status.c_str());
-                } else if (joGetResult.HasLabel("status")) {
-                    ret_status = joGetResult["status"].String();
-                    LOGINFO("Activation Value [%s]",ret_status.c_str());
-                }
-                else {
-                    LOGINFO("Failed to read the ActivationStatus");
-                    ret_status = "invalid";
-                }
-
-                return ret_status;
+            uint32_t status = Utils::jsonRpcLinkPool(m_callsign, token).Invoke(callsign, 5000, "getActivationStatus", joGetParams, joGetResult);
+            LOGINFO("Invoke status : %d",status);
+            if (status > 0) {
+                LOGINFO("%s call failed %d", callsign.c_str(), status);
+                ret_status = "invalid";
+                LOGINFO("Setting Default to [%s]",ret_status.c_str());
+            } else if (joGetResult.HasLabel("status")) {
+                ret_status = joGetResult["status"].String();
+                LOGINFO("Activation Value [%s]",ret_status.c_str());
+            }
+            else {
+                LOGINFO("Failed to read the ActivationStatus");
+                ret_status = "invalid";
             }
 
-            LOGINFO("thunder client failed");
             return ret_status;
         }
 
@@ -447,24 +630,16 @@ namespace WPEFramework {
 
             Utils::SecurityToken::getSecurityToken(token);
 
-            string query = "token=" + token;
-            Core::SystemInfo::SetEnvironment(_T("THUNDER_ACCESS"), _T(SERVER_DETAILS));
-            auto thunder_client = make_shared<WPEFramework::JSONRPC::LinkType<WPEFramework::Core::JSON::IElement> >(callsign.c_str(), "");
-            if (thunder_client != nullptr) {
-                uint32_t status = thunder_client->Invoke<JsonObject, JsonObject>(5000, "isConnectedToInternet", joGetParams, joGetResult);
-                if (status > 0) {
-                    LOGINFO("%s call failed %d", callsign.c_str(), status);
-                    return false;
-                } else if (joGetResult.HasLabel("connectedToInternet")) {
-                    LOGINFO("connectedToInternet status %s",(joGetResult["connectedToInternet"].Boolean())? "true":"false");
-                    return joGetResult["connectedToInternet"].Boolean();
-                } else {
-                    return false;
-                }
+            uint32_t status = Utils::jsonRpcLinkPool(m_callsign, token).Invoke(callsign, 5000, "isConnectedToInternet", joGetParams, joGetResult);
+            if (status > 0) {
+                LOGINFO("%s call failed %d", callsign.c_str(), status);
+                return false;
+            } else if (joGetResult.HasLabel("connectedToInternet")) {
+                LOGINFO("connectedToInternet status %s",(joGetResult["connectedToInternet"].Boolean())? "true":"false");
+                return joGetResult["connectedToInternet"].Boolean();
+            } else {
+                return false;
             }
-
-            LOGINFO("thunder client failed");
-            return false;
         }
 
         bool MaintenanceManager::isDeviceOnline()
@@ -497,8 +672,13 @@ namespace WPEFramework {
             MaintenanceManager::_instance = nullptr;
         }
 
-        const string MaintenanceManager::Initialize(PluginHost::IShell*)
+        const string MaintenanceManager::Initialize(PluginHost::IShell* service)
         {
+            Config config;
+            config.FromString(service->ConfigLine());
+            configureTasks(config);
+            m_callsign = service->Callsign();
+
 #if defined(USE_IARMBUS) || defined(USE_IARM_BUS)
             InitializeIARM();
 #endif /* defined(USE_IARMBUS) || defined(USE_IARM_BUS) */
@@ -506,11 +686,12 @@ namespace WPEFramework {
             return (string());
         }
 
-        void MaintenanceManager::Deinitialize(PluginHost::IShell*)
+        void MaintenanceManager::Deinitialize(PluginHost::IShell* service)
         {
 #if defined(USE_IARMBUS) || defined(USE_IARM_BUS)
             DeinitializeIARM();
 #endif /* defined(USE_IARMBUS) || defined(USE_IARM_BUS) */
+            Utils::releaseJsonRpcLinks(service->Callsign());
         }
 
 #if defined(USE_IARMBUS) || defined(USE_IARM_BUS)
@@ -567,7 +748,7 @@ namespace WPEFramework {
                 exec_status = system("/lib/rdk/StartDCM_maintaince.sh &");
                 if ( E_OK == exec_status ){
                     LOGINFO("DBG:Succesfully executed StartDCM_maintaince.sh \n");
-                    m_task_map["/lib/rdk/StartDCM_maintaince.sh"]=true;
+                    setTaskActive(MAINT_TASK_DCM, true);
                 }
                 else {
                     LOGINFO("DBG:Failed to execute StartDCM_maintaince.sh !! \n");
@@ -599,15 +780,8 @@ namespace WPEFramework {
 
         void MaintenanceManager::iarmEventHandler(const char *owner, IARM_EventId_t eventId, void *data, size_t len)
         {
-            Maint_notify_status_t notify_status=MAINTENANCE_STARTED;
             IARM_Bus_MaintMGR_EventData_t *module_event_data=(IARM_Bus_MaintMGR_EventData_t*)data;
             IARM_Maint_module_status_t module_status;
-            time_t successfulTime;
-            string str_successfulTime="";
-            auto task_status_DCM=m_task_map.find("/lib/rdk/StartDCM_maintaince.sh");
-            auto task_status_RFC=m_task_map.find(task_names_foreground[0].c_str());
-            auto task_status_FWDLD=m_task_map.find(task_names_foreground[1].c_str());
-            auto task_status_LOGUPLD=m_task_map.find(task_names_foreground[2].c_str());
 
             IARM_Bus_MaintMGR_EventId_t event = (IARM_Bus_MaintMGR_EventId_t)eventId;
             LOGINFO("Maintenance Event-ID = %d \n",event);
@@ -628,50 +802,47 @@ namespace WPEFramework {
                     LOGINFO("MaintMGR Status %s \n", status_string.c_str());
                     switch (module_status) {
                         case MAINT_RFC_COMPLETE :
-                            if(task_status_RFC->second != true) {
+                            if(!takeTaskActive(MAINT_TASK_RFC)) {
                                  LOGINFO("Ignoring Event RFC_COMPLETE");
                                  return;
                             }
                             else {
                                  SET_STATUS(g_task_status,RFC_SUCCESS);
                                  SET_STATUS(g_task_status,RFC_COMPLETE);
-                                 task_thread.notify_one();
-                                 m_task_map[task_names_foreground[0].c_str()]=false;
+                                 m_scheduler.complete(MAINT_TASK_RFC, true);
                             }
                             break;
                         case MAINT_DCM_COMPLETE :
-                            if(task_status_DCM->second != true) {
+                            if(!takeTaskActive(MAINT_TASK_DCM)) {
                                  LOGINFO("Ignoring Event DCM_COMPLETE");
                                  return;
                             }
                             else {
                                 SET_STATUS(g_task_status,DCM_SUCCESS);
                                 SET_STATUS(g_task_status,DCM_COMPLETE);
-                                task_thread.notify_one();
-                                m_task_map["/lib/rdk/StartDCM_maintaince.sh"]=false;
+                                m_scheduler.complete(MAINT_TASK_DCM, true);
                             }
                             break;
                         case MAINT_FWDOWNLOAD_COMPLETE :
-                            if(task_status_FWDLD->second != true) {
+                            if(!takeTaskActive(MAINT_TASK_SWUPDATE)) {
                                  LOGINFO("Ignoring Event MAINT_FWDOWNLOAD_COMPLETE");
                                  return;
                             }
                             else {
                                 SET_STATUS(g_task_status,DIFD_SUCCESS);
                                 SET_STATUS(g_task_status,DIFD_COMPLETE);
-                                task_thread.notify_one();
-                                m_task_map[task_names_foreground[1].c_str()]=false;
+                                m_scheduler.complete(MAINT_TASK_SWUPDATE, true);
                             }
                             break;
                        case MAINT_LOGUPLOAD_COMPLETE :
-                            if(task_status_LOGUPLD->second != true) {
+                            if(!takeTaskActive(MAINT_TASK_LOGUPLOAD)) {
                                  LOGINFO("Ignoring Event MAINT_LOGUPLOAD_COMPLETE");
                                  return;
                             }
                             else {
                                 SET_STATUS(g_task_status,LOGUPLOAD_SUCCESS);
                                 SET_STATUS(g_task_status,LOGUPLOAD_COMPLETE);
-                                m_task_map[task_names_foreground[2].c_str()]=false;
+                                m_scheduler.complete(MAINT_TASK_LOGUPLOAD, true);
                             }
 
                             break;
@@ -686,75 +857,72 @@ namespace WPEFramework {
                             SET_STATUS(g_task_status,TASK_SKIPPED);
                             /* we say FW update task complete */
                             SET_STATUS(g_task_status,DIFD_COMPLETE);
-                            task_thread.notify_one();
-                            m_task_map[task_names_foreground[1].c_str()]=false;
+                            setTaskActive(MAINT_TASK_SWUPDATE, false);
+                            m_scheduler.complete(MAINT_TASK_SWUPDATE, false);
                             LOGINFO("FW Download task aborted \n");
                             break;
                         case MAINT_DCM_ERROR:
-                            if(task_status_DCM->second != true) {
+                            if(!takeTaskActive(MAINT_TASK_DCM)) {
                                  LOGINFO("Ignoring Event DCM_ERROR");
                             }
                             else {
                                 SET_STATUS(g_task_status,DCM_COMPLETE);
-                                task_thread.notify_one();
+                                m_scheduler.complete(MAINT_TASK_DCM, false);
                                 LOGINFO("Error encountered in DCM script task \n");
-                                m_task_map["/lib/rdk/StartDCM_maintaince.sh"]=false;
                             }
                             break;
                         case MAINT_RFC_ERROR:
-                            if(task_status_RFC->second != true) {
+                            if(!takeTaskActive(MAINT_TASK_RFC)) {
                                  LOGINFO("Ignoring Event RFC_ERROR");
                                  return;
                             }
                             else {
                                  SET_STATUS(g_task_status,RFC_COMPLETE);
-                                 task_thread.notify_one();
+                                 m_scheduler.complete(MAINT_TASK_RFC, false);
                                  LOGINFO("Error encountered in RFC script task \n");
-                                 m_task_map[task_names_foreground[0].c_str()]=false;
                             }
 
                             break;
                         case MAINT_LOGUPLOAD_ERROR:
-                            if(task_status_LOGUPLD->second != true) {
+                            if(!takeTaskActive(MAINT_TASK_LOGUPLOAD)) {
                                   LOGINFO("Ignoring Event MAINT_LOGUPLOAD_ERROR");
                                   return;
                             }
                             else {
                                 SET_STATUS(g_task_status,LOGUPLOAD_COMPLETE);
+                                m_scheduler.complete(MAINT_TASK_LOGUPLOAD, false);
                                 LOGINFO("Error encountered in LOGUPLOAD script task \n");
-                                m_task_map[task_names_foreground[2].c_str()]=false;
                             }
 
                             break;
                        case MAINT_FWDOWNLOAD_ERROR:
-                            if(task_status_FWDLD->second != true) {
+                            if(!takeTaskActive(MAINT_TASK_SWUPDATE)) {
                                  LOGINFO("Ignoring Event MAINT_FWDOWNLOAD_ERROR");
                                  return;
                             }
                             else {
                                 SET_STATUS(g_task_status,DIFD_COMPLETE);
-                                task_thread.notify_one();
+                                m_scheduler.complete(MAINT_TASK_SWUPDATE, false);
                                 LOGINFO("Error encountered in SWUPDATE script task \n");
-                                m_task_map[task_names_foreground[1].c_str()]=false;
                             }
                             break;
                        case MAINT_DCM_INPROGRESS:
-                            m_task_map["/lib/rdk/StartDCM_maintaince.sh"]=true;
+                            setTaskActive(MAINT_TASK_DCM, true);
                             /*will be set to false once COMEPLETE/ERROR received for DCM*/
                             LOGINFO(" DCM already IN PROGRESS -> setting m_task_map of DCM to true \n");
                             break;
                        case MAINT_RFC_INPROGRESS:
-                            m_task_map[task_names_foreground[0].c_str()]=true;
+                            setTaskActive(MAINT_TASK_RFC, true);
                             /*will be set to false once COMEPLETE/ERROR received for RFC*/
                             LOGINFO(" RFC already IN PROGRESS -> setting m_task_map of RFC to true \n");
                             break;
                        case MAINT_FWDOWNLOAD_INPROGRESS:
-                            m_task_map[task_names_foreground[1].c_str()]=true;
+                            setTaskActive(MAINT_TASK_SWUPDATE, true);
                             /*will be set to false once COMEPLETE/ERROR received for FWDOWNLOAD*/
                             LOGINFO(" FWDOWNLOAD already IN PROGRESS -> setting m_task_map of FWDOWNLOAD to true \n");
                             break;
                        case MAINT_LOGUPLOAD_INPROGRESS:
-                            m_task_map[task_names_foreground[2].c_str()]=true;
+                            setTaskActive(MAINT_TASK_LOGUPLOAD, true);
                             /*will be set to false once COMEPLETE/ERROR received for LOGUPLOAD*/
                             LOGINFO(" LOGUPLOAD already IN PROGRESS -> setting m_task_map of LOGUPLOAD to true \n");
                             break;
@@ -769,39 +937,12 @@ namespace WPEFramework {
                 /* Send the updated status only if all task completes execution
                  * until that we say maintenance started */
                 if ( (g_task_status & TASKS_COMPLETED ) == TASKS_COMPLETED ){
-                    if ( (g_task_status & ALL_TASKS_SUCCESS) == ALL_TASKS_SUCCESS ){ // all tasks success
-                        LOGINFO("DBG:Maintenance Successfully Completed!!");
-                        notify_status=MAINTENANCE_COMPLETE;
-                        /*  we store the time in persistant location */
-                        successfulTime=time(nullptr);
-                        tm ltime=*localtime(&successfulTime);
-                        time_t epoch_time=mktime(&ltime);
-                        str_successfulTime=to_string(epoch_time);
-                        LOGINFO("last succesful time is :%s", str_successfulTime.c_str());
-                        /* Remove any old completion time */
-                        m_setting.remove("LastSuccessfulCompletionTime");
-                        m_setting.setValue("LastSuccessfulCompletionTime",str_successfulTime);
-
-                    }
-                    /* Check other than all success case which means we have errors */
-                    else if ((g_task_status & ALL_TASKS_SUCCESS)!= ALL_TASKS_SUCCESS) {
-                        if ((g_task_status & MAINTENANCE_TASK_SKIPPED ) == MAINTENANCE_TASK_SKIPPED ){
-                            LOGINFO("DBG:There are Skipped Task. Maintenance Incomplete");
-                            notify_status=MAINTENANCE_INCOMPLETE;
-                        }
-                        else {
-                            LOGINFO("DBG:Maintenance Ended with Errors");
-                            notify_status=MAINTENANCE_ERROR;
-                        }
-
-                    }
-
                     LOGINFO("ENDING MAINTENANCE CYCLE");
                     if(m_thread.joinable()){
                         m_thread.join();
                     }
 
-                    MaintenanceManager::_instance->onMaintenanceStatusChange(notify_status);
+                    reportMaintenanceCompletion();
                 }
                 else {
                     LOGINFO("Tasks are not completed!!!!");
@@ -821,6 +962,7 @@ namespace WPEFramework {
                 MaintenanceManager::_instance = nullptr;
             }
 
+            m_scheduler.abort(true);
             if(m_thread.joinable()){
                 m_thread.join();
             }
@@ -1143,15 +1285,10 @@ namespace WPEFramework {
                     // Set the condition flag m_abort_flag to true
                     m_abort_flag = true;
 
-                    auto task_status_DCM=m_task_map.find("/lib/rdk/StartDCM_maintaince.sh");
-                    auto task_status_RFC=m_task_map.find(task_names_foreground[0].c_str());
-                    auto task_status_FWDLD=m_task_map.find(task_names_foreground[1].c_str());
-                    auto task_status_LOGUPLD=m_task_map.find(task_names_foreground[2].c_str());
-
-                    task_status[0] = task_status_DCM->second;
-                    task_status[1] = task_status_RFC->second;
-                    task_status[2] = task_status_FWDLD->second;
-                    task_status[3] = task_status_LOGUPLD->second;
+                    task_status[0] = isTaskActive(MAINT_TASK_DCM);
+                    task_status[1] = isTaskActive(MAINT_TASK_RFC);
+                    task_status[2] = isTaskActive(MAINT_TASK_SWUPDATE);
+                    task_status[3] = isTaskActive(MAINT_TASK_LOGUPLOAD);
 
                     for (i=0;i<4;i++)
                         LOGINFO("task status [%d]  = %s ScriptName %s",i,(task_status[i])? "true":"false",script_names[i].c_str());
@@ -1159,7 +1296,10 @@ namespace WPEFramework {
                         if(task_status[i]){
                             record = i;
                             LOGINFO("Checking the Task PID\n");
-                            pid_num=getTaskPID(script_names[i].c_str());
+                            pid_num=m_scheduler.getPid(task_names[i]);
+                            if ( pid_num == -1 ){
+                                pid_num=getTaskPID(script_names[i].c_str());
+                            }
                             LOGINFO("PID of script_name [%d] = %s is %d \n", i,script_names[i].c_str(),pid_num);
                             if( pid_num != -1){
                                 /* send the signal to task to terminate */
@@ -1176,15 +1316,16 @@ namespace WPEFramework {
                             else {
                                 LOGINFO("Didnt find PID for %s\n",script_names[i].c_str());
                             }
-
-                            /* No need to loop again */
-                            break;
                         }
                         else{
                             LOGINFO("Task[%d] is false \n",i);
                         }
                     }
 
+                    /* Tasks run side by side: the scheduler settles every one still running,
+                     * including those waiting for an event, and starts no further ones */
+                    m_scheduler.abort(true);
+
                     /* if we still didnt get the pid but we still know which task is running */
                     if ( !task_incomplete ){
 
@@ -1217,6 +1358,34 @@ namespace WPEFramework {
             returnResponse(result);
         }
 
+        /*
+         * @brief This function returns the state and duration of each task of the
+         * current or previous maintenance activity.
+         * @param1[in]: {"jsonrpc":"2.0","id":"3","method":"org.rdk.MaintenanceManager.1.getMaintenanceTaskDurations",
+         *                  "params":{}}''
+         * @param2[out]:{"jsonrpc":"2.0","id":3,"result":{"tasks":[{"name":"rfc","state":"SUCCESS",
+         *                  "durationMs":5230,"exitCode":0}],"success":true}}
+         * @return: Core::<StatusCode>
+         */
+        uint32_t MaintenanceManager::getMaintenanceTaskDurations(const JsonObject& parameters,
+                JsonObject& response)
+        {
+            std::vector<MaintenanceTaskScheduler::TaskReport> reports;
+            JsonArray tasks;
+
+            m_scheduler.getReports(reports);
+            for (const auto& report : reports) {
+                JsonObject task;
+                task["name"] = report.name;
+                task["state"] = MaintenanceTaskScheduler::stateToString(report.state);
+                task["durationMs"] = report.durationMs;
+                task["exitCode"] = report.exitCode;
+                tasks.Add(task);
+            }
+            response["tasks"] = tasks;
+            returnResponse(true);
+        }
+
         bool MaintenanceManager::checkAbortFlag(){
             bool ret=false;
             RFC_ParamData_t param;
@@ -42,6 +42,7 @@
 #include "cTimer.h"
 #include "rfcapi.h"
 #include "cSettings.h"
+#include "MaintenanceTaskScheduler.h"
 
 /* MaintenanceManager Services Triggered Events. */
 #define EVT_ONMAINTMGRSAMPLEEVENT           "onSampleEvent"
@@ -71,6 +72,15 @@ typedef enum{
     UNSOLICITED_MAINTENANCE
 }Maintenance_Type_t;
 
+/* Maintenance task names, as used by the task scheduler */
+#define MAINT_TASK_DCM                  "dcm"
+#define MAINT_TASK_RFC                  "rfc"
+#define MAINT_TASK_SWUPDATE             "swupdate"
+#define MAINT_TASK_LOGUPLOAD            "logupload"
+
+/* Tasks that may run at the same time once their dependencies settled */
+#define MAINT_DEFAULT_MAX_CONCURRENCY   2
+
 #define FOREGROUND_MODE "FOREGROUND"
 #define BACKGROUND_MODE "BACKGROUND"
 
@@ -115,6 +125,75 @@ namespace WPEFramework {
 
         class MaintenanceManager : public AbstractPlugin {
             private:
+                class Config : public Core::JSON::Container {
+                    public:
+                        class TaskConfig : public Core::JSON::Container {
+                            public:
+                                TaskConfig()
+                                    : Core::JSON::Container()
+                                    , Name()
+                                    , Script()
+                                    , LogFile()
+                                    , Dependencies()
+                                    , Nice(0)
+                                    , Timeout(0)
+                                {
+                                    Add(_T("name"), &Name);
+                                    Add(_T("script"), &Script);
+                                    Add(_T("logfile"), &LogFile);
+                                    Add(_T("dependencies"), &Dependencies);
+                                    Add(_T("nice"), &Nice);
+                                    Add(_T("timeout"), &Timeout);
+                                }
+                                TaskConfig(const TaskConfig& copy)
+                                    : Core::JSON::Container()
+                                    , Name(copy.Name)
+                                    , Script(copy.Script)
+                                    , LogFile(copy.LogFile)
+                                    , Dependencies(copy.Dependencies)
+                                    , Nice(copy.Nice)
+                                    , Timeout(copy.Timeout)
+                                {
+                                    Add(_T("name"), &Name);
+                                    Add(_T("script"), &Script);
+                                    Add(_T("logfile"), &LogFile);
+                                    Add(_T("dependencies"), &Dependencies);
+                                    Add(_T("nice"), &Nice);
+                                    Add(_T("timeout"), &Timeout);
+                                }
+                                ~TaskConfig() override
+                                {
+                                }
+
+                            public:
+                                Core::JSON::String Name;
+                                Core::JSON::String Script;
+                                Core::JSON::String LogFile;
+                                Core::JSON::ArrayType<Core::JSON::String> Dependencies;
+                                Core::JSON::DecSInt8 Nice;
+                                Core::JSON::DecUInt32 Timeout;
+                        };
+
+                        Config(const Config&) = delete;
+                        Config& operator=(const Config&) = delete;
+
+                        Config()
+                            : Core::JSON::Container()
+                            , MaxConcurrency(MAINT_DEFAULT_MAX_CONCURRENCY)
+                            , Tasks()
+                        {
+                            Add(_T("maxconcurrency"), &MaxConcurrency);
+                            Add(_T("tasks"), &Tasks);
+                        }
+                        ~Config() override
+                        {
+                        }
+
+                    public:
+                        Core::JSON::DecUInt8 MaxConcurrency;
+                        Core::JSON::ArrayType<TaskConfig> Tasks;
+                };
+
                 typedef Core::JSON::String JString;
                 typedef Core::JSON::ArrayType<JString> JStringArray;
                 typedef Core::JSON::Boolean JBool;
@@ -135,15 +214,25 @@ namespace WPEFramework {
 
                 bool m_abort_flag;
 
+                /* Callsign of this plugin, its links to other plugins are pooled under it */
+                string m_callsign;
+
                 uint16_t g_task_status;
 
                 std::mutex  m_callMutex;
                 std::mutex  m_statusMutex;
-                std::condition_variable task_thread;
                 std::thread m_thread;
 
+                /* Guards m_task_map, which the IARM handler, the task threads and the API all use */
+                std::mutex  m_taskMapMutex;
                 std::map<string, bool> m_task_map;
 
+                MaintenanceTaskScheduler m_scheduler;
+                std::map<string, MaintenanceTaskScheduler::Task> m_task_overrides;
+
+                bool isTaskActive(const string& name);
+                void setTaskActive(const string& name, bool active);
+                bool takeTaskActive(const string& name);
                 bool isDeviceOnline();
                 void task_execution_thread();
                 void requestSystemReboot();
@@ -154,6 +243,10 @@ namespace WPEFramework {
                 bool getActivatedStatus(bool &skipFirmwareCheck);
                 const string checkActivatedStatus(void);
                 pid_t getTaskPID(const char*);
+                void configureTasks(const Config& config);
+                std::vector<MaintenanceTaskScheduler::Task> buildTaskGraph(bool waitForDCM, bool skipFirmwareCheck);
+                void onTaskStateChange(const string& name, MaintenanceTaskScheduler::TaskState state);
+                void reportMaintenanceCompletion();
 
                 string getLastRebootReason();
                 void iarmEventHandler(const char *owner, IARM_EventId_t eventId, void *data, size_t len);
@@ -201,6 +294,7 @@ namespace WPEFramework {
                 uint32_t startMaintenance(const JsonObject& parameters, JsonObject& response);
                 uint32_t stopMaintenance(const JsonObject& parameters, JsonObject& response);
                 uint32_t getMaintenanceMode(const JsonObject& parameters, JsonObject& response);
+                uint32_t getMaintenanceTaskDurations(const JsonObject& parameters, JsonObject& response);
         }; /* end of MaintenanceManager service class */
     } /* end of plugin */
 } /* end of wpeframework */
@@ -0,0 +1,546 @@
+/**
+* If not stated otherwise in this file or this component's LICENSE
+* file the following copyright and licenses apply:
+*
+* Copyright 2021 RDK Management
+*
+* Licensed under the Apache License, Version 2.0 (the "License");
+* you may not use this file except in compliance with the License.
+* You may obtain a copy of the License at
+*
+* http://www.apache.org/licenses/LICENSE-2.0
+*
+* Unless required by applicable law or agreed to in writing, software
+* distributed under the License is distributed on an "AS IS" BASIS,
+* WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+* See the License for the specific language governing permissions and
+* limitations under the License.
+**/
+
+#include <errno.h>
+#include <fcntl.h>
+#include <poll.h>
+#include <signal.h>
+#include <spawn.h>
+#include <unistd.h>
+#include <sys/eventfd.h>
+#include <sys/resource.h>
+#include <sys/syscall.h>
+#include <sys/wait.h>
+
+#include <algorithm>
+#include <set>
+#include <thread>
+
+#include "MaintenanceTaskScheduler.h"
+#include "utils.h"
+
+/* without a pidfd, running scripts are polled with waitpid at this interval */
+#define SCHEDULER_POLL_INTERVAL_MS      200
+
+#define IOPRIO_WHO_PROCESS              1
+#define IOPRIO_CLASS_SHIFT              13
+
+using namespace std;
+
+namespace WPEFramework {
+    namespace Plugin {
+
+        MaintenanceTaskScheduler::MaintenanceTaskScheduler()
+            : m_maxConcurrency(1)
+            , m_running(false)
+            , m_aborted(false)
+            , m_terminate(false)
+            , m_wakeFd(eventfd(0, EFD_CLOEXEC | EFD_NONBLOCK))
+        {
+            if (m_wakeFd < 0) {
+                LOGERR("eventfd failed with errno %d", errno);
+            }
+        }
+
+        MaintenanceTaskScheduler::~MaintenanceTaskScheduler()
+        {
+            for (auto& entry : m_entries) {
+                reap(entry);
+                if (entry.pidfd >= 0) {
+                    close(entry.pidfd);
+                }
+            }
+            if (m_wakeFd >= 0) {
+                close(m_wakeFd);
+            }
+        }
+
+        const char* MaintenanceTaskScheduler::stateToString(TaskState state)
+        {
+            switch (state) {
+                case TASK_PENDING:  return "PENDING";
+                case TASK_RUNNING:  return "RUNNING";
+                case TASK_SUCCESS:  return "SUCCESS";
+                case TASK_ERROR:    return "ERROR";
+                case TASK_TIMEDOUT: return "TIMEDOUT";
+                case TASK_SKIPPED:  return "SKIPPED";
+            }
+            return "UNKNOWN";
+        }
+
+        void MaintenanceTaskScheduler::setStateCallback(const StateCallback& callback)
+        {
+            std::lock_guard<std::mutex> guard(m_mutex);
+            m_callback = callback;
+        }
+
+        void MaintenanceTaskScheduler::setMaxConcurrency(uint8_t maxConcurrency)
+        {
+            std::lock_guard<std::mutex> guard(m_mutex);
+            m_maxConcurrency = (maxConcurrency > 0) ? maxConcurrency : 1;
+        }
+
+        bool MaintenanceTaskScheduler::setTasks(const vector<Task>& tasks)
+        {
+            std::lock_guard<std::mutex> guard(m_mutex);
+
+            if (m_running) {
+                LOGERR("Cannot change tasks while the scheduler is running");
+                return false;
+            }
+
+            set<string> names;
+            for (const auto& task : tasks) {
+                if (task.name.empty() || !names.insert(task.name).second) {
+                    LOGERR("Invalid or duplicate task name '%s'", task.name.c_str());
+                    return false;
+                }
+            }
+            for (const auto& task : tasks) {
+                for (const auto& dependency : task.dependencies) {
+                    if (names.find(dependency) == names.end()) {
+                        LOGERR("Task '%s' depends on unknown task '%s'", task.name.c_str(), dependency.c_str());
+                        return false;
+                    }
+                }
+            }
+
+            /* children of the previous run that outlived their task */
+            for (auto& entry : m_entries) {
+                reap(entry);
+                if (entry.pidfd >= 0) {
+                    close(entry.pidfd);
+                }
+            }
+
+            m_entries.clear();
+            for (const auto& task : tasks) {
+                Entry entry;
+                entry.task = task;
+                entry.state = TASK_PENDING;
+                entry.pid = -1;
+                entry.pidfd = -1;
+                entry.exitCode = -1;
+                entry.exited = false;
+                entry.reported = false;
+                entry.reportedSuccess = false;
+                m_entries.push_back(entry);
+            }
+
+            if (hasCycle()) {
+                LOGERR("Task graph has a dependency cycle");
+                m_entries.clear();
+                return false;
+            }
+
+            m_aborted = false;
+            m_terminate = false;
+            return true;
+        }
+
+        bool MaintenanceTaskScheduler::hasCycle() const
+        {
+            /* Kahn's algorithm; whatever cannot be ordered is part of a cycle */
+            set<string> done;
+            bool progress = true;
+            while (progress && done.size() < m_entries.size()) {
+                progress = false;
+                for (const auto& entry : m_entries) {
+                    if (done.count(entry.task.name)) {
+                        continue;
+                    }
+                    bool ready = true;
+                    for (const auto& dependency : entry.task.dependencies) {
+                        if (!done.count(dependency)) {
+                            ready = false;
+                            break;
+                        }
+                    }
+                    if (ready) {
+                        done.insert(entry.task.name);
+                        progress = true;
+                    }
+                }
+            }
+            return (done.size() != m_entries.size());
+        }
+
+        bool MaintenanceTaskScheduler::dependenciesSettled(const Entry& entry) const
+        {
+            for (const auto& dependency : entry.task.dependencies) {
+                for (const auto& other : m_entries) {
+                    if ((other.task.name == dependency) &&
+                        ((TASK_PENDING == other.state) || (TASK_RUNNING == other.state))) {
+                        return false;
+                    }
+                }
+            }
+            return true;
+        }
+
+        bool MaintenanceTaskScheduler::spawn(Entry& entry)
+        {
+            posix_spawn_file_actions_t actions;
+            posix_spawnattr_t attr;
+            sigset_t mask;
+            sigset_t defaults;
+            pid_t pid = -1;
+
+            posix_spawn_file_actions_init(&actions);
+            if (!entry.task.logFile.empty()) {
+                posix_spawn_file_actions_addopen(&actions, STDOUT_FILENO, entry.task.logFile.c_str(),
+                        O_WRONLY | O_CREAT | O_APPEND, 0644);
+                posix_spawn_file_actions_adddup2(&actions, STDOUT_FILENO, STDERR_FILENO);
+            }
+
+            /* scripts must not inherit the signal setup of the framework, and get
+             * their own process group so a timeout reaches their children too */
+            posix_spawnattr_init(&attr);
+            sigemptyset(&mask);
+            sigemptyset(&defaults);
+            sigaddset(&defaults, SIGPIPE);
+            sigaddset(&defaults, SIGCHLD);
+            sigaddset(&defaults, SIGHUP);
+            sigaddset(&defaults, SIGINT);
+            sigaddset(&defaults, SIGTERM);
+            sigaddset(&defaults, SIGUSR1);
+            sigaddset(&defaults, SIGUSR2);
+            posix_spawnattr_setsigmask(&attr, &mask);
+            posix_spawnattr_setsigdefault(&attr, &defaults);
+            posix_spawnattr_setpgroup(&attr, 0);
+            posix_spawnattr_setflags(&attr, POSIX_SPAWN_SETSIGMASK | POSIX_SPAWN_SETSIGDEF | POSIX_SPAWN_SETPGROUP);
+
+            char* const argv[] = {
+                const_cast<char*>("sh"),
+                const_cast<char*>(entry.task.script.c_str()),
+                nullptr
+            };
+            int ret = posix_spawn(&pid, "/bin/sh", &actions, &attr, argv, environ);
+
+            posix_spawnattr_destroy(&attr);
+            posix_spawn_file_actions_destroy(&actions);
+
+            if (0 != ret) {
+                LOGERR("Failed to start %s: error %d", entry.task.script.c_str(), ret);
+                return false;
+            }
+
+            if ((0 != entry.task.niceness) && (0 != setpriority(PRIO_PROCESS, pid, entry.task.niceness))) {
+                LOGWARN("setpriority(%d) failed for %s: errno %d", entry.task.niceness, entry.task.name.c_str(), errno);
+            }
+#ifdef SYS_ioprio_set
+            if (IO_CLASS_NONE != entry.task.ioClass) {
+                int ioprio = (static_cast<int>(entry.task.ioClass) << IOPRIO_CLASS_SHIFT) | (entry.task.ioLevel & 0x7);
+                if (0 != syscall(SYS_ioprio_set, IOPRIO_WHO_PROCESS, pid, ioprio)) {
+                    LOGWARN("ioprio_set failed for %s: errno %d", entry.task.name.c_str(), errno);
+                }
+            }
+#endif
+
+            entry.pid = pid;
+            entry.pidfd = -1;
+#ifdef SYS_pidfd_open
+            entry.pidfd = static_cast<int>(syscall(SYS_pidfd_open, pid, 0));
+#endif
+            LOGINFO("Started task %s (%s) pid %d", entry.task.name.c_str(), entry.task.script.c_str(), pid);
+            return true;
+        }
+
+        void MaintenanceTaskScheduler::reap(Entry& entry)
+        {
+            if ((entry.pid <= 0) || entry.exited) {
+                return;
+            }
+
+            int status = 0;
+            pid_t ret = waitpid(entry.pid, &status, WNOHANG);
+            if (ret == entry.pid) {
+                entry.exited = true;
+                if (WIFEXITED(status)) {
+                    entry.exitCode = WEXITSTATUS(status);
+                } else if (WIFSIGNALED(status)) {
+                    entry.exitCode = 128 + WTERMSIG(status);
+                }
+            } else if ((ret < 0) && (ECHILD == errno)) {
+                /* SIGCHLD is ignored by the process; the status is lost */
+                LOGWARN("Exit status of task %s is not available", entry.task.name.c_str());
+                entry.exited = true;
+                entry.exitCode = -1;
+            }
+
+            if (entry.exited && (entry.pidfd >= 0)) {
+                close(entry.pidfd);
+                entry.pidfd = -1;
+            }
+        }
+
+        void MaintenanceTaskScheduler::settle(Entry& entry, TaskState state, vector<pair<string, TaskState>>& changes)
+        {
+            entry.end = std::chrono::steady_clock::now();
+            if (TASK_PENDING == entry.state) {
+                entry.start = entry.end;
+            }
+            entry.state = state;
+            changes.push_back(make_pair(entry.task.name, state));
+            LOGINFO("Task %s finished with %s", entry.task.name.c_str(), stateToString(state));
+        }
+
+        void MaintenanceTaskScheduler::wake()
+        {
+            if (m_wakeFd >= 0) {
+                uint64_t one = 1;
+                if (write(m_wakeFd, &one, sizeof(one)) < 0) {
+                    LOGWARN("Failed to wake the scheduler: errno %d", errno);
+                }
+            }
+        }
+
+        void MaintenanceTaskScheduler::notify(const vector<pair<string, TaskState>>& changes)
+        {
+            StateCallback callback;
+            {
+                std::lock_guard<std::mutex> guard(m_mutex);
+                callback = m_callback;
+            }
+            if (callback) {
+                for (const auto& change : changes) {
+                    callback(change.first, change.second);
+                }
+            }
+        }
+
+        void MaintenanceTaskScheduler::run()
+        {
+            {
+                std::lock_guard<std::mutex> guard(m_mutex);
+                if (m_running) {
+                    LOGERR("Scheduler is already running");
+                    return;
+                }
+                m_running = true;
+            }
+
+            for (;;) {
+                vector<pair<string, TaskState>> changes;
+                vector<size_t> starting;
+                vector<struct pollfd> fds;
+                int timeout = -1;
+                bool finished = true;
+                {
+                    std::lock_guard<std::mutex> guard(m_mutex);
+                    auto now = std::chrono::steady_clock::now();
+                    uint8_t running = 0;
+
+                    for (auto& entry : m_entries) {
+                        reap(entry);
+                        if (TASK_RUNNING != entry.state) {
+                            continue;
+                        }
+
+                        bool hasScript = !entry.task.script.empty();
+                        if (m_terminate) {
+                            settle(entry, TASK_ERROR, changes);
+                        } else if (hasScript && entry.exited && entry.task.completesOnExit) {
+                            settle(entry, (0 == entry.exitCode) ? TASK_SUCCESS : TASK_ERROR, changes);
+                        } else if (!entry.task.completesOnExit && entry.reported) {
+                            settle(entry, entry.reportedSuccess ? TASK_SUCCESS : TASK_ERROR, changes);
+                        } else if ((entry.task.timeoutMs > 0) &&
+                                   (now - entry.start >= std::chrono::milliseconds(entry.task.timeoutMs))) {
+                            LOGWARN("Task %s timed out after %u ms", entry.task.name.c_str(), entry.task.timeoutMs);
+                            if (hasScript && !entry.exited) {
+                                kill(-entry.pid, SIGTERM);
+                            }
+                            settle(entry, TASK_TIMEDOUT, changes);
+                        } else {
+                            running++;
+                        }
+                    }
+
+                    for (auto& entry : m_entries) {
+                        if (TASK_PENDING != entry.state) {
+                            continue;
+                        }
+                        if (m_aborted) {
+                            settle(entry, TASK_SKIPPED, changes);
+                            continue;
+                        }
+                        if ((running >= m_maxConcurrency) || !dependenciesSettled(entry)) {
+                            continue;
+                        }
+
+                        entry.start = std::chrono::steady_clock::now();
+                        entry.state = TASK_RUNNING;
+                        changes.push_back(make_pair(entry.task.name, TASK_RUNNING));
+                        if (!entry.task.script.empty()) {
+                            starting.push_back(&entry - &m_entries[0]);
+                        }
+                        running++;
+                    }
+
+                    struct pollfd wakeFd = { m_wakeFd, POLLIN, 0 };
+                    fds.push_back(wakeFd);
+                    now = std::chrono::steady_clock::now();
+                    for (auto& entry : m_entries) {
+                        if (TASK_PENDING == entry.state) {
+                            finished = false;
+                        }
+                        if (TASK_RUNNING != entry.state) {
+                            continue;
+                        }
+                        finished = false;
+
+                        if ((entry.pid > 0) && !entry.exited) {
+                            if (entry.pidfd >= 0) {
+                                struct pollfd pidFd = { entry.pidfd, POLLIN, 0 };
+                                fds.push_back(pidFd);
+                            } else if ((timeout < 0) || (timeout > SCHEDULER_POLL_INTERVAL_MS)) {
+                                timeout = SCHEDULER_POLL_INTERVAL_MS;
+                            }
+                        }
+                        if (entry.task.timeoutMs > 0) {
+                            auto left = std::chrono::duration_cast<std::chrono::milliseconds>(
+                                    entry.start + std::chrono::milliseconds(entry.task.timeoutMs) - now).count();
+                            int remaining = static_cast<int>(std::max<int64_t>(left, 0));
+                            if ((timeout < 0) || (remaining < timeout)) {
+                                timeout = remaining;
+                            }
+                        }
+                    }
+
+                    if (finished) {
+                        m_running = false;
+                    }
+                }
+
+                /* the RUNNING callbacks go out before the scripts start, so the
+                 * owner is ready for completions reported by the scripts */
+                notify(changes);
+
+                if (!starting.empty()) {
+                    vector<pair<string, TaskState>> failures;
+                    {
+                        std::lock_guard<std::mutex> guard(m_mutex);
+                        for (auto index : starting) {
+                            Entry& entry = m_entries[index];
+                            if (TASK_RUNNING != entry.state) {
+                                continue;
+                            }
+                            entry.start = std::chrono::steady_clock::now();
+                            if (!spawn(entry)) {
+                                settle(entry, TASK_ERROR, failures);
+                            }
+                        }
+                    }
+                    notify(failures);
+                }
+
+                if (finished) {
+                    break;
+                }
+                if (!changes.empty()) {
+                    /* a settled task may have made others ready */
+                    continue;
+                }
+
+                if (poll(fds.data(), fds.size(), timeout) < 0 && (EINTR != errno)) {
+                    LOGERR("poll failed with errno %d", errno);
+                    std::this_thread::sleep_for(std::chrono::milliseconds(SCHEDULER_POLL_INTERVAL_MS));
+                }
+                if ((m_wakeFd >= 0) && (fds[0].revents & POLLIN)) {
+                    uint64_t value;
+                    if (read(m_wakeFd, &value, sizeof(value)) < 0) {
+                        LOGWARN("Failed to drain the wake event: errno %d", errno);
+                    }
+                }
+            }
+            LOGINFO("All maintenance tasks settled");
+        }
+
+        bool MaintenanceTaskScheduler::complete(const string& name, bool success)
+        {
+            std::lock_guard<std::mutex> guard(m_mutex);
+            for (auto& entry : m_entries) {
+                if (entry.task.name == name) {
+                    if ((TASK_PENDING != entry.state) && (TASK_RUNNING != entry.state)) {
+                        return false;
+                    }
+                    entry.reported = true;
+                    entry.reportedSuccess = success;
+                    wake();
+                    return true;
+                }
+            }
+            return false;
+        }
+
+        void MaintenanceTaskScheduler::abort(bool terminate)
+        {
+            std::lock_guard<std::mutex> guard(m_mutex);
+            m_aborted = true;
+            if (terminate) {
+                m_terminate = true;
+                for (auto& entry : m_entries) {
+                    if ((TASK_RUNNING == entry.state) && (entry.pid > 0) && !entry.exited) {
+                        kill(-entry.pid, SIGTERM);
+                    }
+                }
+            }
+            wake();
+        }
+
+        pid_t MaintenanceTaskScheduler::getPid(const string& name)
+        {
+            std::lock_guard<std::mutex> guard(m_mutex);
+            for (auto& entry : m_entries) {
+                if ((entry.task.name == name) && (TASK_RUNNING == entry.state) && !entry.exited) {
+                    return entry.pid;
+                }
+            }
+            return -1;
+        }
+
+        bool MaintenanceTaskScheduler::isRunning()
+        {
+            std::lock_guard<std::mutex> guard(m_mutex);
+            return m_running;
+        }
+
+        void MaintenanceTaskScheduler::getReports(vector<TaskReport>& reports)
+        {
+            std::lock_guard<std::mutex> guard(m_mutex);
+            auto now = std::chrono::steady_clock::now();
+
+            reports.clear();
+            for (const auto& entry : m_entries) {
+                TaskReport report;
+                report.name = entry.task.name;
+                report.state = entry.state;
+                report.pid = entry.pid;
+                report.exitCode = entry.exited ? entry.exitCode : -1;
+                report.durationMs = 0;
+                if (TASK_RUNNING == entry.state) {
+                    report.durationMs = std::chrono::duration_cast<std::chrono::milliseconds>(now - entry.start).count();
+                } else if ((TASK_PENDING != entry.state) && (entry.end > entry.start)) {
+                    report.durationMs = std::chrono::duration_cast<std::chrono::milliseconds>(entry.end - entry.start).count();
+                }
+                reports.push_back(report);
+            }
+        }
+    } /* namespace Plugin */
+} /* namespace WPEFramework */
@@ -0,0 +1,156 @@
+/**
+* If not stated otherwise in this file or this component's LICENSE
+* file the following copyright and licenses apply:
+*
+* Copyright 2021 RDK Management
+*
+* Licensed under the Apache License, Version 2.0 (the "License");
+* you may not use this file except in compliance with the License.
+* You may obtain a copy of the License at
+*
+* http://www.apache.org/licenses/LICENSE-2.0
+*
+* Unless required by applicable law or agreed to in writing, software
+* distributed under the License is distributed on an "AS IS" BASIS,
+* WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+* See the License for the specific language governing permissions and
+* limitations under the License.
+**/
+
+#ifndef MAINTENANCETASKSCHEDULER_H
+#define MAINTENANCETASKSCHEDULER_H
+
+#include <sys/types.h>
+#include <stdint.h>
+#include <string>
+#include <vector>
+#include <mutex>
+#include <chrono>
+#include <functional>
+
+namespace WPEFramework {
+    namespace Plugin {
+
+        /* Runs a small graph of maintenance tasks. A task becomes ready once all of
+         * its dependencies have settled (successfully or not, dependencies only
+         * order the tasks), and at most maxConcurrency tasks run at a time.
+         * Scripts are started with posix_spawn and tracked through a pidfd when
+         * the kernel supports it, otherwise through waitpid polling. */
+        class MaintenanceTaskScheduler {
+            public:
+                typedef enum {
+                    TASK_PENDING,
+                    TASK_RUNNING,
+                    TASK_SUCCESS,
+                    TASK_ERROR,
+                    TASK_TIMEDOUT,
+                    TASK_SKIPPED
+                } TaskState;
+
+                /* IO priority classes, see ioprio_set(2) */
+                typedef enum {
+                    IO_CLASS_NONE = 0,
+                    IO_CLASS_REALTIME = 1,
+                    IO_CLASS_BEST_EFFORT = 2,
+                    IO_CLASS_IDLE = 3
+                } IOClass;
+
+                struct Task {
+                    Task()
+                        : niceness(0), ioClass(IO_CLASS_NONE), ioLevel(4)
+                        , timeoutMs(0), completesOnExit(true) {}
+
+                    std::string name;
+                    /* script to run with /bin/sh; empty means the task is
+                     * started elsewhere and only reported through complete() */
+                    std::string script;
+                    /* stdout/stderr of the script are appended here when set */
+                    std::string logFile;
+                    std::vector<std::string> dependencies;
+                    int niceness;
+                    IOClass ioClass;
+                    int ioLevel;
+                    /* 0 disables the timeout */
+                    uint32_t timeoutMs;
+                    /* true: the exit status decides the outcome.
+                     * false: the outcome is reported through complete(); the
+                     * exit is only recorded, as scripts may hand the work over
+                     * to a background process. */
+                    bool completesOnExit;
+                };
+
+                struct TaskReport {
+                    std::string name;
+                    TaskState state;
+                    pid_t pid;
+                    int exitCode;
+                    uint64_t durationMs;
+                };
+
+                typedef std::function<void(const std::string& name, TaskState state)> StateCallback;
+
+                MaintenanceTaskScheduler();
+                ~MaintenanceTaskScheduler();
+
+                void setStateCallback(const StateCallback& callback);
+                void setMaxConcurrency(uint8_t maxConcurrency);
+
+                /* Replaces the task graph. Fails while a run is in progress or if a
+                 * dependency is unknown or cyclic. */
+                bool setTasks(const std::vector<Task>& tasks);
+
+                /* Blocks until every task has settled or the run was aborted. */
+                void run();
+
+                /* Reports the outcome of a task that does not complete on exit.
+                 * May be called before the task starts; the result is kept. */
+                bool complete(const std::string& name, bool success);
+
+                /* Stops starting new tasks; pending tasks are skipped. With
+                 * terminate, running scripts get SIGTERM as well. */
+                void abort(bool terminate);
+
+                pid_t getPid(const std::string& name);
+                void getReports(std::vector<TaskReport>& reports);
+                bool isRunning();
+
+                static const char* stateToString(TaskState state);
+
+            private:
+                struct Entry {
+                    Task task;
+                    TaskState state;
+                    pid_t pid;
+                    int pidfd;
+                    int exitCode;
+                    bool exited;
+                    bool reported;
+                    bool reportedSuccess;
+                    std::chrono::steady_clock::time_point start;
+                    std::chrono::steady_clock::time_point end;
+                };
+
+                MaintenanceTaskScheduler(const MaintenanceTaskScheduler&) = delete;
+                MaintenanceTaskScheduler& operator=(const MaintenanceTaskScheduler&) = delete;
+
+                bool spawn(Entry& entry);
+                bool dependenciesSettled(const Entry& entry) const;
+                bool hasCycle() const;
+                void reap(Entry& entry);
+                void settle(Entry& entry, TaskState state, std::vector<std::pair<std::string, TaskState>>& changes);
+                void wake();
+                void notify(const std::vector<std::pair<std::string, TaskState>>& changes);
+
+                std::mutex m_mutex;
+                std::vector<Entry> m_entries;
+                StateCallback m_callback;
+                uint8_t m_maxConcurrency;
+                bool m_running;
+                bool m_aborted;
+                bool m_terminate;
+                int m_wakeFd;
+        };
+    } /* end of plugin */
+} /* end of wpeframework */
+
+#endif //MAINTENANCETASKSCHEDULER_H
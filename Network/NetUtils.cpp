@@ -75,6 +75,19 @@ namespace WPEFramework {
             return (it != interface_descriptions.end()) ? it->second : empty;
         }
 
+        /*
+         * Keep a snapshot of the links, addresses and default routes up to date in the background
+         */
+        bool NetUtils::startNetlinkMonitor(NetlinkMonitor::ChangeCallback callback)
+        {
+            return m_netlinkMonitor.start(callback);
+        }
+
+        void NetUtils::stopNetlinkMonitor()
+        {
+            m_netlinkMonitor.stop();
+        }
+
         /*
          * Returns >= 0 on success
          * Blocking process so run in background thread
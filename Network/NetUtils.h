@@ -46,6 +46,10 @@ namespace WPEFramework {
             void InitialiseNetUtils();
             const std::string& getInterfaceDescription(const std::string name);
 
+            bool startNetlinkMonitor(NetlinkMonitor::ChangeCallback callback = nullptr);
+            void stopNetlinkMonitor();
+            NetlinkSnapshotPtr getNetlinkSnapshot() const { return m_netlinkMonitor.snapshot(); }
+
             static bool isIPV4(const std::string &address);
             static bool isIPV6(const std::string &address);
             static bool isIPV6LinkLocal(const std::string &address);
@@ -64,6 +68,7 @@ namespace WPEFramework {
             static unsigned int     m_counter;
             static std::mutex       m_counterProtect;
             std::map<std::string, std::string> interface_descriptions;
+            NetlinkMonitor      m_netlinkMonitor;
         };
     } // namespace Plugin
 } // namespace WPEFramework
@@ -0,0 +1,590 @@
+/**
+* If not stated otherwise in this file or this component's LICENSE
+* file the following copyright and licenses apply:
+*
+* Copyright 2020 RDK Management
+*
+* Licensed under the Apache License, Version 2.0 (the "License");
+* you may not use this file except in compliance with the License.
+* You may obtain a copy of the License at
+*
+* http://www.apache.org/licenses/LICENSE-2.0
+*
+* Unless required by applicable law or agreed to in writing, software
+* distributed under the License is distributed on an "AS IS" BASIS,
+* WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+* See the License for the specific language governing permissions and
+* limitations under the License.
+**/
+
+#include "NetUtilsIcmp.h"
+#include <arpa/inet.h>
+#include <errno.h>
+#include <linux/errqueue.h>
+#include <math.h>
+#include <netdb.h>
+#include <netinet/icmp6.h>
+#include <netinet/ip.h>
+#include <netinet/ip_icmp.h>
+#include <netinet/ip6.h>
+#include <poll.h>
+#include <string.h>
+#include <unistd.h>
+#include <atomic>
+#include "utils.h"
+
+#define ICMP_HEADER_SIZE        8
+#define UDP_HEADER_SIZE         8
+#define ICMP_MAX_PACKET_SIZE    1500
+
+namespace WPEFramework {
+    namespace Plugin {
+
+        static std::atomic<uint16_t> s_icmpInstance(0);
+
+        Icmp::Icmp() :
+            m_fd(-1),
+            m_raw(false),
+            m_udp(false),
+            m_ipv6(false),
+            m_targetLength(0),
+            m_id(0),
+            m_sequence(0)
+        {
+            memset(&m_target, 0, sizeof(m_target));
+        }
+
+        Icmp::~Icmp()
+        {
+            close();
+        }
+
+        bool Icmp::open(const std::string &endpoint, const std::string &interface, IcmpProbe probe)
+        {
+            struct addrinfo hints;
+            struct addrinfo *result = NULL;
+            char address[INET6_ADDRSTRLEN] = {0};
+
+            close();
+
+            memset(&hints, 0, sizeof(hints));
+            hints.ai_family = AF_UNSPEC;
+            hints.ai_socktype = SOCK_DGRAM;
+            hints.ai_flags = AI_ADDRCONFIG;
+            if ((getaddrinfo(endpoint.c_str(), NULL, &hints, &result) != 0) || (result == NULL))
+            {
+                // e.g. loopback only, where AI_ADDRCONFIG hides every address
+                hints.ai_flags = 0;
+                if ((getaddrinfo(endpoint.c_str(), NULL, &hints, &result) != 0) || (result == NULL))
+                {
+                    LOGERR("Failed to resolve '%s'", endpoint.c_str());
+                    m_error = "Bad Address";
+                    return false;
+                }
+            }
+
+            memcpy(&m_target, result->ai_addr, result->ai_addrlen);
+            m_targetLength = result->ai_addrlen;
+            m_ipv6 = (result->ai_family == AF_INET6);
+            freeaddrinfo(result);
+
+            if (m_ipv6)
+                inet_ntop(AF_INET6, &((struct sockaddr_in6 *)&m_target)->sin6_addr, address, sizeof(address));
+            else
+                inet_ntop(AF_INET, &((struct sockaddr_in *)&m_target)->sin_addr, address, sizeof(address));
+            m_address = address;
+
+            int family = m_ipv6 ? AF_INET6 : AF_INET;
+            int protocol = m_ipv6 ? (int)IPPROTO_ICMPV6 : (int)IPPROTO_ICMP;
+
+            m_udp = (probe == ICMP_PROBE_UDP);
+            if (m_udp)
+            {
+                m_fd = socket(family, SOCK_DGRAM | SOCK_CLOEXEC, IPPROTO_UDP);
+                m_raw = false;
+            }
+            else
+            {
+                // The kernel takes care of the echo identifier and of matching replies for datagram sockets
+                m_fd = socket(family, SOCK_DGRAM | SOCK_CLOEXEC, protocol);
+                m_raw = (m_fd == -1);
+                if (m_raw)
+                {
+                    m_fd = socket(family, SOCK_RAW | SOCK_CLOEXEC, protocol);
+                }
+            }
+            if (m_fd == -1)
+            {
+                LOGERR("Failed to create ICMP socket: %s", strerror(errno));
+                m_error = "Could not open ICMP socket";
+                return false;
+            }
+
+            if (m_raw)
+            {
+                m_id = (uint16_t)((getpid() << 8) ^ s_icmpInstance++);
+            }
+            else
+            {
+                // Time exceeded and unreachable errors are queued on the socket, with the probe they answer
+                int on = 1;
+                if (m_ipv6)
+                    setsockopt(m_fd, IPPROTO_IPV6, IPV6_RECVERR, &on, sizeof(on));
+                else
+                    setsockopt(m_fd, IPPROTO_IP, IP_RECVERR, &on, sizeof(on));
+            }
+
+            if (m_ipv6 && !interface.empty())
+            {
+                if (setsockopt(m_fd, SOL_SOCKET, SO_BINDTODEVICE, interface.c_str(), interface.length() + 1) == -1)
+                {
+                    LOGWARN("Failed to bind ICMP socket to %s: %s", interface.c_str(), strerror(errno));
+                }
+            }
+
+            LOGINFO("%s %s%s socket for %s (%s)", (m_raw ? "Raw" : "Datagram"), (m_udp ? "UDP" : "ICMP"), (m_ipv6 ? "v6" : ""),
+                    endpoint.c_str(), m_address.c_str());
+            return true;
+        }
+
+        void Icmp::close()
+        {
+            if (m_fd != -1)
+            {
+                ::close(m_fd);
+                m_fd = -1;
+            }
+            m_probes.clear();
+            m_error.clear();
+        }
+
+        bool Icmp::ping(int count, unsigned intervalMs, unsigned timeoutMs, IcmpPingStatistics &statistics)
+        {
+            memset(&statistics, 0, sizeof(statistics));
+            if (m_fd == -1)
+            {
+                m_error = "Could not open ICMP socket";
+                return false;
+            }
+            if (m_udp)
+            {
+                // Nothing answers UDP probes but errors
+                m_error = "Ping needs ICMP echo probes";
+                return false;
+            }
+
+            m_probes.clear();
+            for (int i = 0; i < count; i++)
+            {
+                if (_send(m_sequence++, 0, ICMP_PING_PAYLOAD_SIZE))
+                {
+                    statistics.transmitted++;
+                }
+                // Collect the replies already in while spacing the probes
+                if ((i + 1 < count) && (intervalMs > 0))
+                {
+                    _receive(Clock::now() + std::chrono::milliseconds(intervalMs), 0, false);
+                }
+            }
+            _receive(Clock::now() + std::chrono::milliseconds(timeoutMs), 0, true);
+
+            double sum = 0;
+            double sumSquares = 0;
+            for (const auto &it : m_probes)
+            {
+                const Probe &probe = it.second;
+                if (!probe.answered || !probe.reply)
+                {
+                    continue;
+                }
+                if ((statistics.received == 0) || (probe.trip < statistics.tripMin))
+                    statistics.tripMin = probe.trip;
+                if ((statistics.received == 0) || (probe.trip > statistics.tripMax))
+                    statistics.tripMax = probe.trip;
+                sum += probe.trip;
+                sumSquares += probe.trip * probe.trip;
+                statistics.received++;
+            }
+            if (statistics.received > 0)
+            {
+                // Same as the mdev of iputils ping
+                statistics.tripAvg = sum / statistics.received;
+                double variance = (sumSquares / statistics.received) - (statistics.tripAvg * statistics.tripAvg);
+                statistics.tripStdDev = (variance > 0) ? sqrt(variance) : 0;
+            }
+
+            return (statistics.transmitted > 0);
+        }
+
+        bool Icmp::traceroute(int maxHops, int queries, unsigned waitMs, int packetLength, std::vector<IcmpHop> &hops)
+        {
+            hops.clear();
+            if (m_fd == -1)
+            {
+                m_error = "Could not open ICMP socket";
+                return false;
+            }
+
+            // packetLength is the whole IP packet, as for the traceroute command
+            int payloadSize = packetLength - (m_ipv6 ? (int)sizeof(struct ip6_hdr) : (int)sizeof(struct ip))
+                    - (m_udp ? UDP_HEADER_SIZE : ICMP_HEADER_SIZE);
+            if (payloadSize < 0)
+                payloadSize = 0;
+
+            // Every hop is probed at once; the queries are spread a little, as routers rate limit their errors
+            m_probes.clear();
+            for (int query = 0; query < queries; query++)
+            {
+                for (int ttl = 1; ttl <= maxHops; ttl++)
+                {
+                    _send(m_sequence++, ttl, payloadSize);
+                }
+                if (query + 1 < queries)
+                {
+                    _receive(Clock::now() + std::chrono::milliseconds(ICMP_TRACE_QUERY_DELAY_MS), maxHops, false);
+                }
+            }
+            _receive(Clock::now() + std::chrono::milliseconds(waitMs), maxHops, true);
+
+            int lastTtl = _finalTtl();
+            if (lastTtl == 0)
+                lastTtl = maxHops;
+
+            hops.resize(lastTtl);
+            for (int ttl = 1; ttl <= lastTtl; ttl++)
+            {
+                hops[ttl - 1].ttl = ttl;
+            }
+            for (const auto &it : m_probes)
+            {
+                const Probe &probe = it.second;
+                if (probe.ttl <= lastTtl)
+                {
+                    IcmpHop &hop = hops[probe.ttl - 1];
+                    hop.addresses.push_back(probe.answered ? probe.from : std::string());
+                    hop.trips.push_back(probe.answered ? probe.trip : -1);
+                }
+            }
+
+            return true;
+        }
+
+        bool Icmp::_send(uint16_t sequence, int ttl, int payloadSize)
+        {
+            uint8_t packet[ICMP_MAX_PACKET_SIZE];
+            struct sockaddr_storage target;
+            int length = (m_udp ? 0 : ICMP_HEADER_SIZE) + payloadSize;
+
+            if (length > (int)sizeof(packet))
+                length = sizeof(packet);
+
+            // UDP probes are told apart by their destination port, which the errors quote
+            memcpy(&target, &m_target, sizeof(target));
+            if (m_udp)
+            {
+                uint16_t port = htons((uint16_t)(ICMP_TRACE_UDP_PORT + sequence));
+                if (m_ipv6)
+                    ((struct sockaddr_in6 *)&target)->sin6_port = port;
+                else
+                    ((struct sockaddr_in *)&target)->sin_port = port;
+                for (int i = 0; i < length; i++)
+                {
+                    packet[i] = (uint8_t)(0x40 + i);
+                }
+            }
+            else
+            {
+                memset(packet, 0, ICMP_HEADER_SIZE);
+                packet[0] = m_ipv6 ? ICMP6_ECHO_REQUEST : ICMP_ECHO;
+                // Identifier in network order, ignored (set by the kernel) for datagram sockets
+                packet[4] = (uint8_t)(m_id >> 8);
+                packet[5] = (uint8_t)(m_id & 0xff);
+                packet[6] = (uint8_t)(sequence >> 8);
+                packet[7] = (uint8_t)(sequence & 0xff);
+                for (int i = ICMP_HEADER_SIZE; i < length; i++)
+                {
+                    packet[i] = (uint8_t)i;
+                }
+                // The kernel computes the ICMPv6 checksum
+                if (!m_ipv6)
+                {
+                    uint16_t checksum = _checksum(packet, length);
+                    memcpy(&packet[2], &checksum, sizeof(checksum));
+                }
+            }
+
+            if (ttl > 0)
+            {
+                int result = m_ipv6 ? setsockopt(m_fd, IPPROTO_IPV6, IPV6_UNICAST_HOPS, &ttl, sizeof(ttl))
+                                    : setsockopt(m_fd, IPPROTO_IP, IP_TTL, &ttl, sizeof(ttl));
+                if (result == -1)
+                {
+                    LOGERR("Failed to set ICMP probe TTL %d: %s", ttl, strerror(errno));
+                    return false;
+                }
+            }
+
+            Probe &probe = m_probes[sequence];
+            probe.ttl = ttl;
+            probe.answered = false;
+            probe.reply = false;
+            probe.final = false;
+            probe.trip = 0;
+            probe.sent = Clock::now();
+            ssize_t sent = sendto(m_fd, packet, length, 0, (struct sockaddr *)&target, m_targetLength);
+            // A UDP socket reports the error of an earlier probe on the next send, it is in the error queue as well
+            if ((sent == -1) && m_udp && (errno != EAGAIN) && (errno != EINTR) && (errno != EMSGSIZE))
+            {
+                sent = sendto(m_fd, packet, length, 0, (struct sockaddr *)&target, m_targetLength);
+            }
+            if (sent != length)
+            {
+                LOGERR("Failed to send ICMP probe %u: %s", (unsigned)sequence, strerror(errno));
+                m_probes.erase(sequence);
+                return false;
+            }
+
+            return true;
+        }
+
+        /*
+         * Process the answers to the probes until the deadline
+         * If stopWhenAnswered is true, return as soon as every probe up to lastTtl is answered
+         */
+        void Icmp::_receive(Clock::time_point deadline, int lastTtl, bool stopWhenAnswered)
+        {
+            while (true)
+            {
+                if (stopWhenAnswered && _allAnswered(lastTtl))
+                    break;
+
+                auto left = std::chrono::duration_cast<std::chrono::milliseconds>(deadline - Clock::now()).count();
+                if (left <= 0)
+                    break;
+
+                struct pollfd pfd;
+                pfd.fd = m_fd;
+                pfd.events = POLLIN;
+                pfd.revents = 0;
+                int ready = poll(&pfd, 1, (int)left + 1);
+                if (ready < 0)
+                {
+                    if (errno == EINTR)
+                        continue;
+                    LOGERR("ICMP socket poll failed: %s", strerror(errno));
+                    break;
+                }
+                if (ready == 0)
+                    continue;
+
+                // Drain whatever is pending, errors first as they arrive before later replies
+                if (pfd.revents & POLLERR)
+                {
+                    while (_receiveError());
+                }
+                if (pfd.revents & POLLIN)
+                {
+                    while (_receiveOne());
+                }
+            }
+        }
+
+        /*
+         * Read one packet from the socket, false when there is none
+         */
+        bool Icmp::_receiveOne()
+        {
+            uint8_t packet[ICMP_MAX_PACKET_SIZE];
+            struct sockaddr_storage from;
+            socklen_t fromLength = sizeof(from);
+
+            ssize_t length = recvfrom(m_fd, packet, sizeof(packet), MSG_DONTWAIT, (struct sockaddr *)&from, &fromLength);
+            if (length <= 0)
+                return false;
+
+            const uint8_t *icmp = packet;
+            ssize_t icmpLength = length;
+            // Raw IPv4 sockets get the IP header too
+            if (m_raw && !m_ipv6)
+            {
+                if (length < (ssize_t)sizeof(struct ip))
+                    return true;
+                int headerLength = (packet[0] & 0x0f) * 4;
+                icmp += headerLength;
+                icmpLength -= headerLength;
+            }
+            if (icmpLength < ICMP_HEADER_SIZE)
+                return true;
+
+            uint8_t type = icmp[0];
+            uint8_t echoReply = m_ipv6 ? ICMP6_ECHO_REPLY : ICMP_ECHOREPLY;
+            if (type == echoReply)
+            {
+                uint16_t id = (uint16_t)((icmp[4] << 8) | icmp[5]);
+                if (!m_raw || (id == m_id))
+                {
+                    _answer((uint16_t)((icmp[6] << 8) | icmp[7]), (struct sockaddr *)&from, true, true);
+                }
+                return true;
+            }
+
+            // Raw sockets see the errors as packets, holding the header of the probe they answer
+            if (m_raw)
+            {
+                bool timeExceeded = m_ipv6 ? (type == ICMP6_TIME_EXCEEDED) : (type == ICMP_TIME_EXCEEDED);
+                bool unreachable = m_ipv6 ? (type == ICMP6_DST_UNREACH) : (type == ICMP_DEST_UNREACH);
+                if (!timeExceeded && !unreachable)
+                    return true;
+
+                const uint8_t *inner = icmp + ICMP_HEADER_SIZE;
+                ssize_t innerLength = icmpLength - ICMP_HEADER_SIZE;
+                int innerHeaderLength = m_ipv6 ? (int)sizeof(struct ip6_hdr) : ((innerLength > 0) ? (inner[0] & 0x0f) * 4 : 0);
+                if (innerLength < innerHeaderLength + ICMP_HEADER_SIZE)
+                    return true;
+
+                const uint8_t *probe = inner + innerHeaderLength;
+                uint8_t echoRequest = m_ipv6 ? ICMP6_ECHO_REQUEST : ICMP_ECHO;
+                uint16_t id = (uint16_t)((probe[4] << 8) | probe[5]);
+                if ((probe[0] == echoRequest) && (id == m_id))
+                {
+                    _answer((uint16_t)((probe[6] << 8) | probe[7]), (struct sockaddr *)&from, false, unreachable);
+                }
+            }
+            return true;
+        }
+
+        /*
+         * Read one error from the socket error queue (datagram sockets), false when there is none
+         */
+        bool Icmp::_receiveError()
+        {
+            uint8_t packet[ICMP_MAX_PACKET_SIZE];
+            uint8_t control[512];
+            struct sockaddr_storage target;
+            struct iovec iov;
+            struct msghdr msg;
+
+            iov.iov_base = packet;
+            iov.iov_len = sizeof(packet);
+            memset(&msg, 0, sizeof(msg));
+            msg.msg_name = &target;
+            msg.msg_namelen = sizeof(target);
+            msg.msg_iov = &iov;
+            msg.msg_iovlen = 1;
+            msg.msg_control = control;
+            msg.msg_controllen = sizeof(control);
+
+            // The data is the probe that caused the error, as much of it as the error quoted
+            ssize_t length = recvmsg(m_fd, &msg, MSG_ERRQUEUE | MSG_DONTWAIT);
+            if (length < 0)
+                return false;
+
+            // The name is the destination of the probe, its port tells which UDP probe it was
+            uint16_t sequence;
+            if (m_udp)
+            {
+                uint16_t port = m_ipv6 ? ((struct sockaddr_in6 *)&target)->sin6_port : ((struct sockaddr_in *)&target)->sin_port;
+                sequence = (uint16_t)(ntohs(port) - ICMP_TRACE_UDP_PORT);
+            }
+            else if (length < ICMP_HEADER_SIZE)
+            {
+                return true;
+            }
+            else
+            {
+                sequence = (uint16_t)((packet[6] << 8) | packet[7]);
+            }
+
+            for (struct cmsghdr *cmsg = CMSG_FIRSTHDR(&msg); cmsg != NULL; cmsg = CMSG_NXTHDR(&msg, cmsg))
+            {
+                bool recvErr = m_ipv6 ? ((cmsg->cmsg_level == IPPROTO_IPV6) && (cmsg->cmsg_type == IPV6_RECVERR))
+                                      : ((cmsg->cmsg_level == IPPROTO_IP) && (cmsg->cmsg_type == IP_RECVERR));
+                if (!recvErr)
+                    continue;
+
+                struct sock_extended_err *error = (struct sock_extended_err *)CMSG_DATA(cmsg);
+                if ((error->ee_origin != SO_EE_ORIGIN_ICMP) && (error->ee_origin != SO_EE_ORIGIN_ICMP6))
+                    continue;
+
+                bool timeExceeded = m_ipv6 ? (error->ee_type == ICMP6_TIME_EXCEEDED) : (error->ee_type == ICMP_TIME_EXCEEDED);
+                bool unreachable = m_ipv6 ? (error->ee_type == ICMP6_DST_UNREACH) : (error->ee_type == ICMP_DEST_UNREACH);
+                if (timeExceeded || unreachable)
+                {
+                    _answer(sequence, SO_EE_OFFENDER(error), false, unreachable);
+                }
+            }
+            return true;
+        }
+
+        void Icmp::_answer(uint16_t sequence, const struct sockaddr *from, bool reply, bool final)
+        {
+            auto it = m_probes.find(sequence);
+            if ((it == m_probes.end()) || it->second.answered)
+                return;
+
+            Probe &probe = it->second;
+            char address[INET6_ADDRSTRLEN] = {0};
+            if (from->sa_family == AF_INET6)
+                inet_ntop(AF_INET6, &((const struct sockaddr_in6 *)from)->sin6_addr, address, sizeof(address));
+            else if (from->sa_family == AF_INET)
+                inet_ntop(AF_INET, &((const struct sockaddr_in *)from)->sin_addr, address, sizeof(address));
+
+            probe.answered = true;
+            probe.reply = reply;
+            probe.final = final;
+            probe.from = address;
+            probe.trip = std::chrono::duration<double, std::milli>(Clock::now() - probe.sent).count();
+        }
+
+        /*
+         * Whether every probe that matters is answered: all of them for a ping, those up to the
+         * hop the endpoint answered from for a traceroute
+         */
+        bool Icmp::_allAnswered(int lastTtl) const
+        {
+            if (lastTtl > 0)
+            {
+                int finalTtl = _finalTtl();
+                if (finalTtl > 0)
+                    lastTtl = finalTtl;
+            }
+            for (const auto &it : m_probes)
+            {
+                if (!it.second.answered && ((lastTtl == 0) || (it.second.ttl <= lastTtl)))
+                    return false;
+            }
+            return true;
+        }
+
+        int Icmp::_finalTtl() const
+        {
+            int finalTtl = 0;
+            for (const auto &it : m_probes)
+            {
+                if (it.second.final && ((finalTtl == 0) || (it.second.ttl < finalTtl)))
+                    finalTtl = it.second.ttl;
+            }
+            return finalTtl;
+        }
+
+        uint16_t Icmp::_checksum(const uint8_t *data, int length)
+        {
+            uint32_t sum = 0;
+            for (int i = 0; i + 1 < length; i += 2)
+            {
+                uint16_t word;
+                memcpy(&word, data + i, sizeof(word));
+                sum += word;
+            }
+            if (length & 1)
+            {
+                uint16_t word = 0;
+                memcpy(&word, data + length - 1, 1);
+                sum += word;
+            }
+            while (sum >> 16)
+                sum = (sum & 0xffff) + (sum >> 16);
+            return (uint16_t)~sum;
+        }
+    } // namespace Plugin
+} // namespace WPEFramework
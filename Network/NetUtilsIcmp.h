@@ -0,0 +1,135 @@
+/**
+* If not stated otherwise in this file or this component's LICENSE
+* file the following copyright and licenses apply:
+*
+* Copyright 2020 RDK Management
+*
+* Licensed under the Apache License, Version 2.0 (the "License");
+* you may not use this file except in compliance with the License.
+* You may obtain a copy of the License at
+*
+* http://www.apache.org/licenses/LICENSE-2.0
+*
+* Unless required by applicable law or agreed to in writing, software
+* distributed under the License is distributed on an "AS IS" BASIS,
+* WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+* See the License for the specific language governing permissions and
+* limitations under the License.
+**/
+
+#pragma once
+
+#include <netinet/in.h>
+#include <stdint.h>
+#include <sys/socket.h>
+#include <chrono>
+#include <map>
+#include <string>
+#include <vector>
+
+namespace WPEFramework {
+    namespace Plugin {
+        /* Same as the ping command */
+        #define ICMP_PING_INTERVAL_MS       1000
+        #define ICMP_PING_TIMEOUT_MS        5000
+        #define ICMP_PING_PAYLOAD_SIZE      56
+        #define ICMP_TRACE_QUERY_DELAY_MS   50
+        /* First destination port of UDP traceroute probes, as for the traceroute command */
+        #define ICMP_TRACE_UDP_PORT         33434
+
+        enum IcmpProbe
+        {
+            /* ICMP echo requests */
+            ICMP_PROBE_ECHO,
+            /* UDP datagrams to unlikely ports, answered with ICMP errors only; traceroute only */
+            ICMP_PROBE_UDP
+        };
+
+        struct IcmpPingStatistics
+        {
+            int     transmitted;
+            int     received;
+            /* Round trip times in milliseconds, only valid when received > 0 */
+            double  tripMin;
+            double  tripAvg;
+            double  tripMax;
+            double  tripStdDev;
+        };
+
+        struct IcmpHop
+        {
+            int                         ttl;
+            /* One entry per query, empty address when there was no answer */
+            std::vector<std::string>    addresses;
+            std::vector<double>         trips;
+        };
+
+        /*
+         * In-process ICMP echo, used for ping and traceroute instead of running the ping and
+         * traceroute commands.
+         * An unprivileged ICMP datagram socket is used when the kernel allows it (see
+         * net.ipv4.ping_group_range), a raw socket otherwise. UDP probes use an unprivileged UDP
+         * socket, and read the ICMP errors from its error queue. All the probes of a request are
+         * sent without waiting for the answer to the previous one, and the round trip times are
+         * measured on the monotonic clock.
+         */
+        class Icmp
+        {
+            public:
+                Icmp();
+                virtual ~Icmp();
+
+                /* Resolves the endpoint (address or host name) and opens the socket for the probes. The
+                 * interface is only used for IPv6, e.g. for link local addresses. */
+                bool open(const std::string &endpoint, const std::string &interface = "", IcmpProbe probe = ICMP_PROBE_ECHO);
+                void close();
+
+                bool ping(int count, unsigned intervalMs, unsigned timeoutMs, IcmpPingStatistics &statistics);
+                /* Hops up to the one the endpoint answered from, or maxHops */
+                bool traceroute(int maxHops, int queries, unsigned waitMs, int packetLength, std::vector<IcmpHop> &hops);
+
+                const std::string& address() const { return m_address; }
+                const std::string& error() const { return m_error; }
+                bool isIPv6() const { return m_ipv6; }
+                bool isRaw() const { return m_raw; }
+                bool isUdp() const { return m_udp; }
+
+            private:
+                typedef std::chrono::steady_clock Clock;
+
+                struct Probe
+                {
+                    int                 ttl;
+                    Clock::time_point   sent;
+                    bool                answered;
+                    /* Echo reply from the endpoint */
+                    bool                reply;
+                    /* The endpoint answered, or it was reported unreachable */
+                    bool                final;
+                    double              trip;
+                    std::string         from;
+                };
+
+                bool _send(uint16_t sequence, int ttl, int payloadSize);
+                void _receive(Clock::time_point deadline, int lastTtl, bool stopWhenAnswered);
+                bool _receiveOne();
+                bool _receiveError();
+                void _answer(uint16_t sequence, const struct sockaddr *from, bool reply, bool final);
+                bool _allAnswered(int lastTtl) const;
+                int _finalTtl() const;
+                static uint16_t _checksum(const uint8_t *data, int length);
+
+                int                         m_fd;
+                bool                        m_raw;
+                bool                        m_udp;
+                bool                        m_ipv6;
+                struct sockaddr_storage     m_target;
+                socklen_t                   m_targetLength;
+                std::string                 m_address;
+                std::string                 m_error;
+                uint16_t                    m_id;
+                uint16_t                    m_sequence;
+                std::map<uint16_t, Probe>   m_probes;
+        };
+    } // namespace Plugin
+} // namespace WPEFramework
@@ -18,11 +18,17 @@
 **/
 
 #include "NetUtilsNetlink.h"
+#include <algorithm>
+#include <arpa/inet.h>
+#include <chrono>
 #include <fcntl.h>
 #include <linux/rtnetlink.h>
 #include <net/if.h>
+#include <poll.h>
 #include <string.h>
+#include <sys/eventfd.h>
 #include <sys/types.h>
+#include <unistd.h>
 
 namespace WPEFramework {
     namespace Plugin {
@@ -114,6 +120,54 @@ namespace WPEFramework {
             return false;
         }
 
+        /*
+         * Send a netlink request to dump all the links, addresses or routes (type RTM_GETLINK, RTM_GETADDR
+         * or RTM_GETROUTE) of a family, or of every family with AF_UNSPEC
+         * The replies end with a NLMSG_DONE message with the same sequence number
+         */
+        bool Netlink::sendDumpRequest(int type, int family, unsigned sequence)
+        {
+            struct messageBuffer {
+                struct nlmsghdr netlinkRequesthdr;
+                union {
+                    struct ifinfomsg link;
+                    struct ifaddrmsg address;
+                    struct rtmsg route;
+                } request;
+            } requestMessage;
+
+            std::lock_guard<std::mutex> lock(m_netlinkProtect);
+
+            memset(&requestMessage, 0, sizeof(struct messageBuffer));
+
+            requestMessage.netlinkRequesthdr.nlmsg_type = type;
+            requestMessage.netlinkRequesthdr.nlmsg_flags = NLM_F_REQUEST | NLM_F_DUMP;
+            requestMessage.netlinkRequesthdr.nlmsg_seq = sequence;
+            switch (type)
+            {
+                case RTM_GETLINK:
+                    requestMessage.netlinkRequesthdr.nlmsg_len = NLMSG_LENGTH(sizeof(struct ifinfomsg));
+                    requestMessage.request.link.ifi_family = family;
+                    break;
+                case RTM_GETADDR:
+                    requestMessage.netlinkRequesthdr.nlmsg_len = NLMSG_LENGTH(sizeof(struct ifaddrmsg));
+                    requestMessage.request.address.ifa_family = family;
+                    break;
+                default:
+                    requestMessage.netlinkRequesthdr.nlmsg_len = NLMSG_LENGTH(sizeof(struct rtmsg));
+                    requestMessage.request.route.rtm_family = family;
+                    break;
+            }
+
+            if (send(m_fdNetlink, &requestMessage, requestMessage.netlinkRequesthdr.nlmsg_len, 0) < 0)
+            {
+                LOGERR("Failed to send socket message: %s", strerror(errno));
+                return false;
+            }
+
+            return true;
+        }
+
         /*
          * DEBUG function to log netlink messages in buffer
          */
@@ -217,7 +271,9 @@ namespace WPEFramework {
 
             if ((replyLength = recvmsg(m_fdNetlink, &msg, 0)) < static_cast<int>(sizeof(struct nlmsghdr)))
             {
+                int error = errno; // e.g. ENOBUFS when events were dropped, the caller may want to know
                 LOGERR("Unable to read message");
+                errno = error;
                 replyLength = -1;
             }
 
@@ -373,5 +429,567 @@ namespace WPEFramework {
             return index > 0;
         }
 
+        /*
+         * Snapshot queries
+         */
+
+        const NetlinkLink* NetlinkSnapshot::link(const std::string &name) const
+        {
+            for (const auto &it : links)
+            {
+                if (it.second.name == name)
+                {
+                    return &it.second;
+                }
+            }
+            return nullptr;
+        }
+
+        bool NetlinkSnapshot::defaultRoute(bool ipv6, std::string &interface, std::string &gateway) const
+        {
+            const NetlinkRoute *best = nullptr;
+            const NetlinkLink *bestLink = nullptr;
+
+            for (const auto &route : defaultRoutes)
+            {
+                if (route.family != (ipv6 ? AF_INET6 : AF_INET))
+                {
+                    continue;
+                }
+                auto link = links.find(route.index);
+                if ((link == links.end()) || !(link->second.flags & IFF_UP))
+                {
+                    continue;
+                }
+                if ((best == nullptr) || (route.metric < best->metric))
+                {
+                    best = &route;
+                    bestLink = &link->second;
+                }
+            }
+
+            if (best == nullptr)
+            {
+                return false;
+            }
+
+            interface = bestLink->name;
+            gateway = best->gateway;
+            return true;
+        }
+
+        bool NetlinkSnapshot::address(const std::string &interface, bool ipv6, std::string &address) const
+        {
+            const NetlinkLink *netlinkLink = link(interface);
+            if (netlinkLink == nullptr)
+            {
+                return false;
+            }
+
+            for (const auto &it : addresses)
+            {
+                if ((it.index == netlinkLink->index) &&
+                    (it.family == (ipv6 ? AF_INET6 : AF_INET)) &&
+                    (it.scope == RT_SCOPE_UNIVERSE))
+                {
+                    address = it.address;
+                    return true;
+                }
+            }
+            return false;
+        }
+
+        /*
+         * Netlink monitor
+         */
+
+        NetlinkMonitor::NetlinkMonitor() :
+            m_running(false),
+            m_fdStop(-1),
+            m_sequence(0)
+        {
+            m_working.generation = 0;
+        }
+
+        NetlinkMonitor::~NetlinkMonitor()
+        {
+            stop();
+        }
+
+        bool NetlinkMonitor::start(ChangeCallback callback)
+        {
+            if (m_thread.joinable())
+            {
+                LOGWARN("Netlink monitor already running");
+                return false;
+            }
+
+            m_fdStop = eventfd(0, EFD_CLOEXEC);
+            if (m_fdStop == -1)
+            {
+                LOGERR("Failed to create Netlink monitor event: %s", strerror(errno));
+                return false;
+            }
+
+            m_callback = callback;
+            m_running = true;
+            m_thread = std::thread(&NetlinkMonitor::_monitor, this);
+            return true;
+        }
+
+        void NetlinkMonitor::stop()
+        {
+            if (!m_thread.joinable())
+            {
+                return;
+            }
+
+            uint64_t value = 1;
+            m_running = false;
+            if (write(m_fdStop, &value, sizeof(value)) != sizeof(value))
+            {
+                LOGWARN("Failed to signal Netlink monitor: %s", strerror(errno));
+            }
+            m_thread.join();
+
+            close(m_fdStop);
+            m_fdStop = -1;
+            m_callback = nullptr;
+            std::atomic_store(&m_snapshot, NetlinkSnapshotPtr());
+        }
+
+        void NetlinkMonitor::_monitor()
+        {
+            typedef std::chrono::steady_clock Clock;
+
+            Netlink netlink;
+            std::vector<char> buffer(NETLINK_MONITOR_BUFFER_SIZE);
+            bool resync = true;
+            bool pending = false;
+            Clock::time_point publishAt;
+
+            /* Connected here, netlink sockets are bound per thread */
+            if (!netlink.connect(RTMGRP_LINK | RTMGRP_IPV4_IFADDR | RTMGRP_IPV6_IFADDR | RTMGRP_IPV4_ROUTE | RTMGRP_IPV6_ROUTE))
+            {
+                LOGERR("Netlink monitor not started");
+                return;
+            }
+
+            while (m_running)
+            {
+                if (resync)
+                {
+                    if (!_dump(netlink, buffer.data(), buffer.size()))
+                    {
+                        /* Try again later, unless asked to stop */
+                        _waitForData(m_fdStop, 1000);
+                        continue;
+                    }
+                    resync = false;
+                    pending = true;
+                    publishAt = Clock::now();
+                }
+
+                int timeout = -1;
+                if (pending)
+                {
+                    timeout = std::max(0, (int)std::chrono::duration_cast<std::chrono::milliseconds>(publishAt - Clock::now()).count());
+                }
+
+                struct pollfd fds[2];
+                fds[0].fd = netlink.sockfd();
+                fds[0].events = POLLIN;
+                fds[0].revents = 0;
+                fds[1].fd = m_fdStop;
+                fds[1].events = POLLIN;
+                fds[1].revents = 0;
+
+                if (poll(fds, 2, timeout) < 0)
+                {
+                    if (errno != EINTR)
+                    {
+                        LOGERR("Netlink monitor poll failed: %s", strerror(errno));
+                        break;
+                    }
+                    continue;
+                }
+
+                if (fds[1].revents)
+                {
+                    break;
+                }
+
+                if (fds[0].revents)
+                {
+                    bool done = false;
+                    int length = netlink.read(buffer.data(), buffer.size());
+                    if (length > 0)
+                    {
+                        if (_apply(buffer.data(), length, 0, done) && !pending)
+                        {
+                            pending = true;
+                            publishAt = Clock::now() + std::chrono::milliseconds(NETLINK_COALESCE_MS);
+                        }
+                    }
+                    else if (errno == ENOBUFS)
+                    {
+                        /* Messages were dropped, the working state can't be trusted any more */
+                        LOGWARN("Netlink monitor overflow, dumping the state again");
+                        resync = true;
+                    }
+                }
+
+                if (pending && (Clock::now() >= publishAt))
+                {
+                    _publish();
+                    pending = false;
+                }
+            }
+
+            if (m_running)
+            {
+                /* Stopped on an error; nothing keeps the snapshot current any more, so drop it and
+                 * let the getters fall back to their other sources */
+                LOGWARN("Netlink monitor stopped, dropping the snapshot");
+                NetlinkSnapshotPtr previous = std::atomic_exchange(&m_snapshot, NetlinkSnapshotPtr());
+                if (previous && m_callback)
+                {
+                    m_callback(previous, NetlinkSnapshotPtr());
+                }
+            }
+        }
+
+        /*
+         * Rebuild the working state from a dump of the links, the addresses and the routes
+         */
+        bool NetlinkMonitor::_dump(Netlink &netlink, char *buffer, int size)
+        {
+            static const int types[] = { RTM_GETLINK, RTM_GETADDR, RTM_GETROUTE };
+
+            m_working.links.clear();
+            m_working.addresses.clear();
+            m_working.defaultRoutes.clear();
+
+            for (int type : types)
+            {
+                bool done = false;
+                unsigned sequence = ++m_sequence;
+
+                if (!netlink.sendDumpRequest(type, AF_UNSPEC, sequence))
+                {
+                    return false;
+                }
+
+                while (!done)
+                {
+                    if (!m_running)
+                    {
+                        return false;
+                    }
+                    if (!_waitForData(netlink.sockfd(), NETLINK_MESSAGE_TIMEOUT_MS))
+                    {
+                        LOGERR("Netlink dump %d timed out", type);
+                        return false;
+                    }
+                    int length = netlink.read(buffer, size);
+                    if (length < 0)
+                    {
+                        return false;
+                    }
+                    _apply(buffer, length, sequence, done);
+                }
+            }
+
+            return true;
+        }
+
+        bool NetlinkMonitor::_waitForData(int fd, int ms)
+        {
+            struct pollfd pfd;
+            pfd.fd = fd;
+            pfd.events = POLLIN;
+            pfd.revents = 0;
+            return (poll(&pfd, 1, ms) > 0) && (pfd.revents & POLLIN);
+        }
+
+        /*
+         * Apply the messages in the buffer to the working state, returns true if it changed
+         * 'done' is set when the end of the dump with the given sequence number is reached
+         */
+        bool NetlinkMonitor::_apply(const char *buffer, int length, unsigned sequence, bool &done)
+        {
+            struct nlmsghdr *nlhdr;
+            bool changed = false;
+
+            for (nlhdr = (struct nlmsghdr *)buffer;
+                 NLMSG_OK(nlhdr, length);
+                 nlhdr = NLMSG_NEXT(nlhdr, length))
+            {
+                switch (nlhdr->nlmsg_type)
+                {
+                    case NLMSG_DONE:
+                        if (sequence && (nlhdr->nlmsg_seq == sequence))
+                            done = true;
+                        break;
+                    case NLMSG_ERROR:
+                        if (sequence && (nlhdr->nlmsg_seq == sequence))
+                        {
+                            LOGWARN("Netlink dump %u failed", sequence);
+                            done = true;
+                        }
+                        break;
+                    case RTM_NEWLINK:
+                    case RTM_DELLINK:
+                        changed |= _applyLink(nlhdr);
+                        break;
+                    case RTM_NEWADDR:
+                    case RTM_DELADDR:
+                        changed |= _applyAddress(nlhdr);
+                        break;
+                    case RTM_NEWROUTE:
+                    case RTM_DELROUTE:
+                        changed |= _applyRoute(nlhdr);
+                        break;
+                    default:
+                        break;
+                }
+            }
+
+            return changed;
+        }
+
+        bool NetlinkMonitor::_applyLink(struct nlmsghdr *nlhdr)
+        {
+            struct ifinfomsg *ifinfo = (struct ifinfomsg *)NLMSG_DATA(nlhdr);
+            struct rtattr *attribute;
+            int attrLength = nlhdr->nlmsg_len - NLMSG_LENGTH(sizeof(struct ifinfomsg));
+            unsigned index = ifinfo->ifi_index;
+
+            if (ifinfo->ifi_family == AF_BRIDGE)
+            {
+                // bridge port messages, not the link itself
+                return false;
+            }
+
+            if (nlhdr->nlmsg_type == RTM_DELLINK)
+            {
+                size_t addresses = m_working.addresses.size();
+                size_t routes = m_working.defaultRoutes.size();
+
+                m_working.addresses.erase(std::remove_if(m_working.addresses.begin(), m_working.addresses.end(),
+                            [index](const NetlinkAddress &address) { return address.index == index; }), m_working.addresses.end());
+                m_working.defaultRoutes.erase(std::remove_if(m_working.defaultRoutes.begin(), m_working.defaultRoutes.end(),
+                            [index](const NetlinkRoute &route) { return route.index == index; }), m_working.defaultRoutes.end());
+
+                return (m_working.links.erase(index) > 0) ||
+                       (addresses != m_working.addresses.size()) ||
+                       (routes != m_working.defaultRoutes.size());
+            }
+
+            auto it = m_working.links.find(index);
+            NetlinkLink link;
+            if (it != m_working.links.end())
+            {
+                link = it->second;
+            }
+            else
+            {
+                link.index = index;
+                link.flags = 0;
+            }
+            unsigned flags = ifinfo->ifi_flags;
+            std::string name = link.name;
+            std::string macAddress = link.macAddress;
+
+            for (attribute = IFLA_RTA(ifinfo);
+                    RTA_OK(attribute, attrLength);
+                    attribute = RTA_NEXT(attribute, attrLength))
+            {
+                if (attribute->rta_type == IFLA_IFNAME)
+                {
+                    name = (const char *)RTA_DATA(attribute);
+                }
+                else if (attribute->rta_type == IFLA_ADDRESS)
+                {
+                    const unsigned char *bytes = (const unsigned char *)RTA_DATA(attribute);
+                    char hex[4];
+                    macAddress.clear();
+                    for (unsigned i = 0; i < RTA_PAYLOAD(attribute); i++)
+                    {
+                        snprintf(hex, sizeof(hex), i ? ":%02x" : "%02x", bytes[i]);
+                        macAddress += hex;
+                    }
+                }
+            }
+
+            if ((it != m_working.links.end()) && (name == link.name) && (macAddress == link.macAddress) && (flags == link.flags))
+            {
+                return false;
+            }
+
+            link.name = name;
+            link.macAddress = macAddress;
+            link.flags = flags;
+            m_working.links[index] = link;
+            return true;
+        }
+
+        bool NetlinkMonitor::_applyAddress(struct nlmsghdr *nlhdr)
+        {
+            struct ifaddrmsg *ifaddr = (struct ifaddrmsg *)NLMSG_DATA(nlhdr);
+            struct rtattr *attribute;
+            int attrLength = nlhdr->nlmsg_len - NLMSG_LENGTH(sizeof(struct ifaddrmsg));
+            char ipAddress[INET6_ADDRSTRLEN];
+            std::string local;
+            std::string address;
+
+            if ((ifaddr->ifa_family != AF_INET) && (ifaddr->ifa_family != AF_INET6))
+            {
+                return false;
+            }
+
+            for (attribute = IFA_RTA(ifaddr);
+                    RTA_OK(attribute, attrLength);
+                    attribute = RTA_NEXT(attribute, attrLength))
+            {
+                if ((attribute->rta_type == IFA_LOCAL) || (attribute->rta_type == IFA_ADDRESS))
+                {
+                    inet_ntop(ifaddr->ifa_family, RTA_DATA(attribute), ipAddress, INET6_ADDRSTRLEN);
+                    (attribute->rta_type == IFA_LOCAL ? local : address) = ipAddress;
+                }
+            }
+
+            // IFA_ADDRESS is the peer address on point to point links, IFA_LOCAL the address of the interface
+            if (!local.empty())
+            {
+                address = local;
+            }
+            if (address.empty())
+            {
+                return false;
+            }
+
+            auto it = std::find_if(m_working.addresses.begin(), m_working.addresses.end(), [&](const NetlinkAddress &entry) {
+                return (entry.index == ifaddr->ifa_index) && (entry.family == ifaddr->ifa_family) && (entry.address == address);
+            });
+
+            if (nlhdr->nlmsg_type == RTM_DELADDR)
+            {
+                if (it == m_working.addresses.end())
+                {
+                    return false;
+                }
+                m_working.addresses.erase(it);
+                return true;
+            }
+
+            if (it != m_working.addresses.end())
+            {
+                if ((it->prefixLength == ifaddr->ifa_prefixlen) && (it->scope == ifaddr->ifa_scope))
+                {
+                    return false;
+                }
+                it->prefixLength = ifaddr->ifa_prefixlen;
+                it->scope = ifaddr->ifa_scope;
+                return true;
+            }
+
+            NetlinkAddress entry;
+            entry.index = ifaddr->ifa_index;
+            entry.family = ifaddr->ifa_family;
+            entry.address = address;
+            entry.prefixLength = ifaddr->ifa_prefixlen;
+            entry.scope = ifaddr->ifa_scope;
+            m_working.addresses.push_back(entry);
+            return true;
+        }
+
+        /*
+         * Only the default routes of the main table are kept
+         */
+        bool NetlinkMonitor::_applyRoute(struct nlmsghdr *nlhdr)
+        {
+            struct rtmsg *routeMsg = (struct rtmsg *)NLMSG_DATA(nlhdr);
+            struct rtattr *attribute;
+            int attrLength = nlhdr->nlmsg_len - NLMSG_LENGTH(sizeof(struct rtmsg));
+            char ipAddress[INET6_ADDRSTRLEN];
+            unsigned table = routeMsg->rtm_table;
+            NetlinkRoute route;
+
+            if (((routeMsg->rtm_family != AF_INET) && (routeMsg->rtm_family != AF_INET6)) ||
+                (routeMsg->rtm_dst_len != 0) ||
+                (routeMsg->rtm_type != RTN_UNICAST))
+            {
+                return false;
+            }
+
+            route.index = 0;
+            route.family = routeMsg->rtm_family;
+            route.metric = 0;
+
+            for (attribute = RTM_RTA(routeMsg);
+                    RTA_OK(attribute, attrLength);
+                    attribute = RTA_NEXT(attribute, attrLength))
+            {
+                if (attribute->rta_type == RTA_OIF)
+                {
+                    route.index = *(unsigned *)RTA_DATA(attribute);
+                }
+                else if (attribute->rta_type == RTA_GATEWAY)
+                {
+                    inet_ntop(routeMsg->rtm_family, RTA_DATA(attribute), ipAddress, INET6_ADDRSTRLEN);
+                    route.gateway = ipAddress;
+                }
+                else if (attribute->rta_type == RTA_PRIORITY)
+                {
+                    route.metric = *(unsigned *)RTA_DATA(attribute);
+                }
+                else if (attribute->rta_type == RTA_TABLE)
+                {
+                    table = *(unsigned *)RTA_DATA(attribute);
+                }
+            }
+
+            if ((table != RT_TABLE_MAIN) || (route.index == 0))
+            {
+                return false;
+            }
+
+            auto it = std::find_if(m_working.defaultRoutes.begin(), m_working.defaultRoutes.end(), [&route](const NetlinkRoute &entry) {
+                return (entry.index == route.index) && (entry.family == route.family) &&
+                       (entry.gateway == route.gateway) && (entry.metric == route.metric);
+            });
+
+            if (nlhdr->nlmsg_type == RTM_DELROUTE)
+            {
+                if (it == m_working.defaultRoutes.end())
+                {
+                    return false;
+                }
+                m_working.defaultRoutes.erase(it);
+                return true;
+            }
+
+            if (it != m_working.defaultRoutes.end())
+            {
+                return false;
+            }
+            m_working.defaultRoutes.push_back(route);
+            return true;
+        }
+
+        void NetlinkMonitor::_publish()
+        {
+            m_working.generation++;
+
+            NetlinkSnapshotPtr current = std::make_shared<const NetlinkSnapshot>(m_working);
+            NetlinkSnapshotPtr previous = std::atomic_exchange(&m_snapshot, current);
+
+            if (m_callback)
+            {
+                m_callback(previous, current);
+            }
+        }
+
     } // namespace Plugin
 } // namespace WPEFramework
@@ -19,15 +19,23 @@
 
 #pragma once
 
+#include <linux/netlink.h>
+#include <atomic>
+#include <functional>
+#include <map>
+#include <memory>
 #include <string>
 #include <thread>
 #include <mutex>
+#include <vector>
 #include "utils.h"
 
 namespace WPEFramework {
     namespace Plugin {
         #define NETLINK_MESSAGE_BUFFER_SIZE     8192
         #define NETLINK_MESSAGE_TIMEOUT_MS      500
+        #define NETLINK_MONITOR_BUFFER_SIZE     32768
+        #define NETLINK_COALESCE_MS             100
 
         typedef std::vector<std::string> stringList;
         typedef std::vector<unsigned> indexList;
@@ -45,6 +53,7 @@ namespace WPEFramework {
                 bool connect(int groups = 0);
                 int read(char *buffer, int size);
                 bool getDefaultInterfaces(indexList &interfaceIndex, stringList &gatewayAddress, bool ipv6 = false);
+                bool sendDumpRequest(int type, int family, unsigned sequence);
                 int sockfd() { return m_fdNetlink;}
 
                 void displayMessages(const char* msgBuffer, int msgLength);
@@ -60,5 +69,92 @@ namespace WPEFramework {
                 bool _getRoutesInformation(indexList &defaultInterfaceIndex, stringList &gatewayAddress);
                 bool _parseRoute(void *msg, unsigned &index, std::string &destination, std::string &gateway);
         };
+
+        struct NetlinkLink
+        {
+            unsigned            index;
+            std::string         name;
+            std::string         macAddress;
+            unsigned            flags;
+        };
+
+        struct NetlinkAddress
+        {
+            unsigned            index;
+            int                 family;
+            std::string         address;
+            unsigned            prefixLength;
+            unsigned            scope;
+        };
+
+        struct NetlinkRoute
+        {
+            unsigned            index;
+            int                 family;
+            std::string         gateway;
+            unsigned            metric;
+        };
+
+        /*
+         * Links, addresses and default routes (main table) as last reported by netlink.
+         * A published snapshot is never modified, so it can be read without locking.
+         */
+        struct NetlinkSnapshot
+        {
+            unsigned long                   generation;
+            std::map<unsigned, NetlinkLink> links;
+            std::vector<NetlinkAddress>     addresses;
+            std::vector<NetlinkRoute>       defaultRoutes;
+
+            const NetlinkLink* link(const std::string &name) const;
+            /* Lowest metric default route of the family on an interface that is up */
+            bool defaultRoute(bool ipv6, std::string &interface, std::string &gateway) const;
+            /* First global scope address of the family on the interface */
+            bool address(const std::string &interface, bool ipv6, std::string &address) const;
+        };
+
+        typedef std::shared_ptr<const NetlinkSnapshot> NetlinkSnapshotPtr;
+
+        /*
+         * Keeps a NetlinkSnapshot up to date from the RTM_NEWLINK/ADDR/ROUTE (and DEL) messages of a
+         * netlink socket, in a thread of its own. The state is dumped once when the monitor starts,
+         * and again if the socket overflowed. Changes arriving together (e.g. an interface coming up
+         * with its addresses and routes) are published as one snapshot, NETLINK_COALESCE_MS after the
+         * first of them, and reported once to the change callback. If the monitor stops on an error,
+         * the snapshot is dropped and the callback gets an empty current snapshot.
+         */
+        class NetlinkMonitor
+        {
+            public:
+                typedef std::function<void(const NetlinkSnapshotPtr &previous, const NetlinkSnapshotPtr &current)> ChangeCallback;
+
+                NetlinkMonitor();
+                virtual ~NetlinkMonitor();
+
+                bool start(ChangeCallback callback = nullptr);
+                void stop();
+
+                /* Latest published snapshot, empty until the first dump completed */
+                NetlinkSnapshotPtr snapshot() const { return std::atomic_load(&m_snapshot); }
+
+            private:
+                void _monitor();
+                bool _dump(Netlink &netlink, char *buffer, int size);
+                bool _waitForData(int fd, int ms);
+                bool _apply(const char *buffer, int length, unsigned sequence, bool &done);
+                bool _applyLink(struct nlmsghdr *nlhdr);
+                bool _applyAddress(struct nlmsghdr *nlhdr);
+                bool _applyRoute(struct nlmsghdr *nlhdr);
+                void _publish();
+
+                std::thread             m_thread;
+                std::atomic_bool        m_running;
+                int                     m_fdStop;
+                ChangeCallback          m_callback;
+                NetlinkSnapshotPtr      m_snapshot;
+                /* Only used by the monitor thread */
+                NetlinkSnapshot         m_working;
+                unsigned                m_sequence;
+        };
     } // namespace Plugin
 } // namespace WPEFramework
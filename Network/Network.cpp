@@ -20,6 +20,9 @@
 #include "Network.h"
 #include <net/if.h>
 #include <arpa/inet.h>
+#include <algorithm>
+#include <map>
+#include <set>
 #include "utils.h"
 
 using namespace std;
@@ -225,6 +228,10 @@ namespace WPEFramework
         const string Network::Initialize(PluginHost::IShell* /* service */)
         {
             string msg;
+
+            // Interfaces, addresses and default routes are answered from the netlink snapshot when there is one
+            m_netUtils.startNetlinkMonitor(std::bind(&Network::onNetlinkSnapshotChanged, this, std::placeholders::_1, std::placeholders::_2));
+
             if (Utils::IARM::init())
             {
                 IARM_Result_t res;
@@ -275,6 +282,7 @@ namespace WPEFramework
             {
                 m_registrationThread.join();
             }
+            m_netUtils.stopNetlinkMonitor();
 
             if (Utils::IARM::isConnected())
             {
@@ -416,7 +424,35 @@ namespace WPEFramework
 
             if(m_isPluginReady)
             {
-                if (IARM_RESULT_SUCCESS == IARM_Bus_Call(IARM_BUS_NM_SRV_MGR_NAME, IARM_BUS_NETSRVMGR_API_getInterfaceList, (void*)&list, sizeof(list)))
+                NetlinkSnapshotPtr snapshot = m_netUtils.getNetlinkSnapshot();
+                if (snapshot)
+                {
+                    JsonArray networkInterfaces;
+
+                    for (const auto& it : snapshot->links)
+                    {
+                        const NetlinkLink& link = it.second;
+                        if (link.flags & IFF_LOOPBACK)
+                            continue;
+
+                        JsonObject interface;
+                        string iface = m_netUtils.getInterfaceDescription(link.name);
+#ifdef NET_DEFINED_INTERFACES_ONLY
+                        if (iface == "")
+                            continue;                    // Skip unrecognised interfaces...
+#endif
+                        interface["interface"] = iface;
+                        interface["macAddress"] = link.macAddress;
+                        interface["enabled"] = ((link.flags & IFF_UP) != 0);
+                        interface["connected"] = ((link.flags & IFF_RUNNING) != 0);
+
+                        networkInterfaces.Add(interface);
+                    }
+
+                    response["interfaces"] = networkInterfaces;
+                    result = true;
+                }
+                else if (IARM_RESULT_SUCCESS == IARM_Bus_Call(IARM_BUS_NM_SRV_MGR_NAME, IARM_BUS_NETSRVMGR_API_getInterfaceList, (void*)&list, sizeof(list)))
                 {
                     JsonArray networkInterfaces;
 
@@ -522,6 +558,7 @@ namespace WPEFramework
 
             if(m_isPluginReady)
             {
+                // Still NetSrvMgr's choice of address (IPv4 first), which the snapshot can't tell
                 if (IARM_RESULT_SUCCESS == IARM_Bus_Call(IARM_BUS_NM_SRV_MGR_NAME, IARM_BUS_NETSRVMGR_API_getSTBip, (void*)&param, sizeof(param)))
                 {
                     response["ip"] = string(param.activeIfaceIpaddr, MAX_IP_ADDRESS_LEN - 1);
@@ -555,7 +592,15 @@ namespace WPEFramework
                     getStringParameter("family", ipfamily);
                     strncpy(param.ipfamily,ipfamily.c_str(),MAX_IP_FAMILY_SIZE);
 
-                    if (IARM_RESULT_SUCCESS == IARM_Bus_Call(IARM_BUS_NM_SRV_MGR_NAME, IARM_BUS_NETSRVMGR_API_getSTBip_family, (void*)&param, sizeof(param)))
+                    NetlinkSnapshotPtr snapshot = m_netUtils.getNetlinkSnapshot();
+                    bool knownFamily = (strcasecmp(ipfamily.c_str(), "IPV4") == 0) || (strcasecmp(ipfamily.c_str(), "IPV6") == 0);
+                    string ip;
+                    if (knownFamily && _getDefaultInterfaceAddress(snapshot, strcasecmp(ipfamily.c_str(), "IPV6") == 0, ip))
+                    {
+                        response["ip"] = ip;
+                        result = true;
+                    }
+                    else if (IARM_RESULT_SUCCESS == IARM_Bus_Call(IARM_BUS_NM_SRV_MGR_NAME, IARM_BUS_NETSRVMGR_API_getSTBip_family, (void*)&param, sizeof(param)))
                     {
                         response["ip"] = string(param.activeIfaceIpaddr, MAX_IP_ADDRESS_LEN - 1);
                         result = true;
@@ -1293,6 +1338,90 @@ namespace WPEFramework
             sendNotify("onDefaultInterfaceChanged", params);
         }
 
+        void Network::onNetlinkSnapshotChanged(const NetlinkSnapshotPtr& previous, const NetlinkSnapshotPtr& current)
+        {
+            if (!current)
+            {
+                LOGWARN("Netlink snapshot dropped, answering from NetSrvMgr again");
+                return;
+            }
+
+            auto defaultInterface = [](const NetlinkSnapshotPtr& snapshot) {
+                string interface, gateway;
+                if (snapshot && !snapshot->defaultRoute(true, interface, gateway))
+                    snapshot->defaultRoute(false, interface, gateway);
+                return interface;
+            };
+
+            // The link state and the addresses of an interface, to tell which ones changed
+            auto interfaceState = [](const NetlinkSnapshotPtr& snapshot, const NetlinkLink& link) {
+                string state = link.macAddress + " " + std::to_string(link.flags);
+                std::vector<string> addresses;
+                for (const auto& address : snapshot->addresses)
+                {
+                    if (address.index == link.index)
+                        addresses.push_back(address.address + "/" + std::to_string(address.prefixLength));
+                }
+                std::sort(addresses.begin(), addresses.end());
+                for (const auto& address : addresses)
+                    state += " " + address;
+                return state;
+            };
+
+            std::map<string, string> oldStates;
+            std::map<string, string> newStates;
+            if (previous)
+            {
+                for (const auto& it : previous->links)
+                    oldStates[it.second.name] = interfaceState(previous, it.second);
+            }
+            for (const auto& it : current->links)
+                newStates[it.second.name] = interfaceState(current, it.second);
+
+            JsonArray interfaces;
+            std::set<string> names;
+            for (const auto& it : oldStates)
+                names.insert(it.first);
+            for (const auto& it : newStates)
+                names.insert(it.first);
+            for (const auto& name : names)
+            {
+                auto oldState = oldStates.find(name);
+                auto newState = newStates.find(name);
+                if ((oldState != oldStates.end()) && (newState != newStates.end()) && (oldState->second == newState->second))
+                    continue;
+
+                const NetlinkLink* link = current->link(name);
+                if (!link && previous)
+                    link = previous->link(name);
+                if (link && (link->flags & IFF_LOOPBACK))
+                    continue;
+
+                string iface = m_netUtils.getInterfaceDescription(name);
+#ifdef NET_DEFINED_INTERFACES_ONLY
+                if (iface == "")
+                    continue;                    // Skip unrecognised interfaces...
+#endif
+                interfaces.Add(iface.empty() ? name : iface);
+            }
+
+            string oldInterface = defaultInterface(previous);
+            string newInterface = defaultInterface(current);
+
+            LOGINFO("Netlink snapshot %lu: %zu interfaces, %zu addresses, default interface '%s'%s", current->generation,
+                    current->links.size(), current->addresses.size(), newInterface.c_str(),
+                    (previous && (oldInterface != newInterface)) ? " (changed)" : "");
+
+            if ((interfaces.Length() == 0) && previous && (oldInterface == newInterface))
+                return;
+
+            // One event per coalesced snapshot; the NetSrvMgr events are still sent as before
+            JsonObject params;
+            params["interfaces"] = interfaces;
+            params["defaultInterface"] = m_netUtils.getInterfaceDescription(newInterface);
+            sendNotify("onNetworkStateChanged", params);
+        }
+
         void Network::eventHandler(const char *owner, IARM_EventId_t eventId, void *data, size_t len)
         {
             if (Network::_instance)
@@ -1378,7 +1507,12 @@ namespace WPEFramework
 
             if(m_isPluginReady)
             {
-                if (m_isHybridDevice == "hybrid")
+                NetlinkSnapshotPtr snapshot = m_netUtils.getNetlinkSnapshot();
+                if (snapshot && (snapshot->defaultRoute(true, interface, gateway) || snapshot->defaultRoute(false, interface, gateway)))
+                {
+                    result = true;
+                }
+                else if (m_isHybridDevice == "hybrid")
                 {
                     LOGINFO("Identified as hybrid device type");
                     if (m_defaultInterface.length() == 0)
@@ -1470,5 +1604,16 @@ namespace WPEFramework
             return result;
         }
 
+        /*
+         * Address of the interface of the default route of the family, from the netlink snapshot
+         */
+        bool Network::_getDefaultInterfaceAddress(const NetlinkSnapshotPtr& snapshot, bool ipv6, string& address)
+        {
+            string interface;
+            string gateway;
+
+            return snapshot && snapshot->defaultRoute(ipv6, interface, gateway) && snapshot->address(interface, ipv6, address);
+        }
+
     } // namespace Plugin
 } // namespace WPEFramework
@@ -89,6 +89,7 @@ namespace WPEFramework {
             void onInterfaceConnectionStatusChanged(std::string interface, bool connected);
             void onInterfaceIPAddressChanged(std::string interface, std::string ipv6Addr, std::string ipv4Addr, bool acquired);
             void onDefaultInterfaceChanged(std::string oldInterface, std::string newInterface);
+            void onNetlinkSnapshotChanged(const NetlinkSnapshotPtr& previous, const NetlinkSnapshotPtr& current);
 
             static void eventHandler(const char *owner, IARM_EventId_t eventId, void *data, size_t len);
             void iarmEventHandler(const char *owner, IARM_EventId_t eventId, void *data, size_t len);
@@ -97,6 +98,7 @@ namespace WPEFramework {
             bool isValidCIDRv4(std::string interface);
             // Internal methods
             bool _getDefaultInterface(std::string& interface, std::string& gateway);
+            bool _getDefaultInterfaceAddress(const NetlinkSnapshotPtr& snapshot, bool ipv6, std::string& address);
 
             void retryIarmEventRegistration();
             void threadEventRegistration();
@@ -18,14 +18,10 @@
 **/
 
 #include "Network.h"
+#include "NetUtilsIcmp.h"
 #include <fcntl.h>
 #include <string.h>
 
-//e.g. traceroute -w 3 -m 6 -q 3 192.168.1.100 52
-#define CMD_TRACEROUTE "traceroute -w %d -m %d -q %d %s %d 2>&1"
-//e.g. traceroute6 -i eth0 -w 3 -m 6 -q 3 fe80::5a19:f8ff:fe37:7a3d 52
-#define CMD_TRACEROUTE6 "traceroute6 -i %s -w %d -m %d -q %d %s %d 2>&1"
-
 #define DEFAULT_PACKET_LENGTH   52
 #define DEFAULT_WAIT            3
 #define DEFAULT_MAX_HOPS        6
@@ -58,15 +54,13 @@ namespace WPEFramework {
 
         bool Network::_doTrace(std::string &endpoint, int packets, JsonObject &response)
         {
-            std::string output = "";
+            JsonArray list;
             std::string error = "";
             std::string interface = "";
             std::string gateway;
             int wait = DEFAULT_WAIT;
             int maxHops = DEFAULT_MAX_HOPS;
             int packetLen = DEFAULT_PACKET_LENGTH;
-            char command[MAX_COMMAND_LENGTH];
-            bool result = false;
 
             if (packets <= 0)
             {
@@ -89,54 +83,52 @@ namespace WPEFramework {
             }
             else
             {
-                if (NetUtils::isIPV6(endpoint))
-                {
-                    snprintf(command, MAX_COMMAND_LENGTH, CMD_TRACEROUTE6,
-                            interface.c_str(),
-                            wait,
-                            maxHops,
-                            packets,
-                            endpoint.c_str(),
-                            packetLen);
-                }
-                else
+                // Traced in process with UDP probes, as traceroute sends by default; laid out the way it prints them
+                Icmp icmp;
+                std::vector<IcmpHop> hops;
+                if (!icmp.open(endpoint, interface, ICMP_PROBE_UDP))
                 {
-                    snprintf(command, MAX_COMMAND_LENGTH, CMD_TRACEROUTE,
-                            wait,
-                            maxHops,
-                            packets,
-                            endpoint.c_str(),
-                            packetLen);
+                    error = icmp.error();
                 }
-
-                if (NetUtils::execCmd(command, output, &result) < 0)
-                {
-                    error = "Failed to execute traceroute command";
-                }
-                else if (!result) // check the command return status
+                else if (!icmp.traceroute(maxHops, packets, wait * 1000, packetLen, hops))
                 {
                     error = "Failed to execute traceroute";
                 }
-            }
-
-            if (error.empty())
-            {
-                // We return the entire output of the trace command but since this contains newlines it is not valid as
-                // a json value so we will parse the output into an array of strings, one element for each line.
-                JsonArray list;
-                if (!output.empty())
+                else
                 {
-                    std::string::size_type last = 0;
-                    std::string::size_type next = output.find('\n');
-                    while (next != std::string::npos)
+                    char line[MAX_COMMAND_LENGTH];
+                    snprintf(line, sizeof(line), "traceroute to %s (%s), %d hops max, %d byte packets",
+                            endpoint.c_str(), icmp.address().c_str(), maxHops, packetLen);
+                    list.Add(std::string(line));
+
+                    for (const auto &hop : hops)
                     {
-                        list.Add(output.substr(last, next - last));
-                        last = next + 1;
-                        next = output.find('\n', last);
+                        std::string text;
+                        std::string last;
+                        snprintf(line, sizeof(line), "%2d ", hop.ttl);
+                        text = line;
+                        for (size_t i = 0; i < hop.addresses.size(); i++)
+                        {
+                            if (hop.addresses[i].empty())
+                            {
+                                text += " *";
+                                continue;
+                            }
+                            if (hop.addresses[i] != last)
+                            {
+                                text += " " + hop.addresses[i] + " ";
+                                last = hop.addresses[i];
+                            }
+                            snprintf(line, sizeof(line), " %.3f ms", hop.trips[i]);
+                            text += line;
+                        }
+                        list.Add(text);
                     }
-                    list.Add(output.substr(last));
                 }
+            }
 
+            if (error.empty())
+            {
                 response["target"] = endpoint;
                 response["results"] = list;
                 response["error"] = "";
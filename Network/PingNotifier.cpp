@@ -18,6 +18,7 @@
 **/
 
 #include "Network.h"
+#include "NetUtilsIcmp.h"
 
 using namespace std;
 
@@ -34,9 +35,6 @@ namespace WPEFramework
             JsonObject pingResult;
             string interface = "";
             string gateway;
-            bool result = false;
-            string outputFile;
-            FILE *fp = NULL;
 
             pingResult["target"] = endPoint;
 
@@ -68,126 +66,45 @@ namespace WPEFramework
                 return pingResult;
             }
 
-            char cmd [1000] = {0x0};
-            if (NetUtils::isIPV6(endPoint))
+            // Ping in process, rather than running ping/ping6 and parsing their output
+            Icmp icmp;
+            IcmpPingStatistics statistics;
+            if (!icmp.open(endPoint, interface))
             {
-                snprintf(cmd, sizeof(cmd), "ping6 -I %s -c %d -W 5 '%s' 2>&1",
-                        interface.c_str(), packets, endPoint.c_str());
-            }
-            else
-            {
-                snprintf(cmd, sizeof(cmd), "ping -c %d -W 5 '%s' 2>&1",
-                        packets, endPoint.c_str());
-            }
-
-            LOGWARN("ping command: %s", cmd);
-
-            // Run the command and dump the output to /tmp/pingoutput
-            if (NetUtils::execCmd(cmd, outputFile, &result, "pingoutput") < 0)
-            {
-                LOGERR("%s: SERVICEMANAGER_FILE_ERROR: Can't open pipe for command '%s' for read mode: %s"
-                        , __FUNCTION__, cmd, strerror(errno));
-
+                LOGERR("%s: Can't ping '%s': %s", __FUNCTION__, endPoint.c_str(), icmp.error().c_str());
                 pingResult["success"] = false;
-                pingResult["error"] = "Could not run command";
+                pingResult["error"] = icmp.error();
             }
-            else if (!result) // check the command return status
+            else if (!icmp.ping(packets, ICMP_PING_INTERVAL_MS, ICMP_PING_TIMEOUT_MS, statistics))
             {
                 pingResult["success"] = false;
                 pingResult["error"] = "Could not ping endpoint";
             }
-            else if ((fp = fopen(outputFile.c_str(), "r")) == NULL)
-            {
-                pingResult["success"] = false;
-                pingResult["error"] = "Could not read ping result";
-            }
             else
             {
-                pingResult["success"] = true;
-                pingResult["error"] = "";
+                char trip[32];
 
-                char linearray[1000]={0x0};
-                while(fgets(linearray, sizeof(linearray), fp) != NULL)
+                LOGINFO("ping %s (%s): %d packets transmitted, %d received", endPoint.c_str(), icmp.address().c_str(),
+                        statistics.transmitted, statistics.received);
+
+                // No reply at all is a failure, as the exit status of ping was
+                pingResult["success"] = (statistics.received > 0);
+                pingResult["error"] = (statistics.received > 0) ? "" : "Could not ping endpoint";
+                pingResult["packetsTransmitted"] = statistics.transmitted;
+                pingResult["packetsReceived"] = statistics.received;
+                pingResult["packetLoss"] = std::to_string(((statistics.transmitted - statistics.received) * 100) / statistics.transmitted);
+
+                if (statistics.received > 0)
                 {
-                    // remove newline from linearray
-                    linearray[strcspn(linearray, "\n")] = '\0';
-                    string line(linearray);
-                    LOGINFO("ping result: %s", line.c_str());
-
-                    if( line.find( "packet" ) != string::npos )
-                    {
-                        //Example: 10 packets transmitted, 10 packets received, 0% packet loss
-
-                        stringstream ss( line );
-                        int transCount;
-                        ss >> transCount;
-                        pingResult["packetsTransmitted"] = transCount;
-
-                        string token;
-                        getline( ss, token, ',' );
-                        getline( ss, token, ',' );
-                        stringstream ss2( token );
-                        int rxCount;
-                        ss2 >> rxCount;
-                        pingResult["packetsReceived"] = rxCount;
-
-                        getline( ss, token, ',' );
-                        string prefix = token.substr(0, token.find("%"));
-                        //double lossFloat = ::atof(prefix.c_str());
-                        //pingResult["packetLoss"] = lossFloat;
-                        pingResult["packetLoss"] = prefix.c_str();
-
-                    }
-                    else if( line.find( "min/avg/max" ) != string::npos )
-                    {
-                        //Example: round-trip min/avg/max = 17.038/18.310/20.197 ms
-
-                        stringstream ss( line );
-                        string fullpath;
-                        getline( ss, fullpath, '=' );
-                        getline( ss, fullpath, '=' );
-
-                        string prefix;
-                        int index = fullpath.find("/");
-                        if (index >= 0)
-                        {
-                            prefix = fullpath.substr(0, fullpath.find("/"));
-                            pingResult["tripMin"] = prefix.c_str();
-                        }
-
-                        index = fullpath.find("/");
-                        if (index >= 0)
-                        {
-                            fullpath = fullpath.substr(index + 1, fullpath.length());
-                            prefix = fullpath.substr(0, fullpath.find("/"));
-                            pingResult["tripAvg"] = prefix.c_str();
-                        }
-
-                        index = fullpath.find("/");
-                        if (index >= 0)
-                        {
-                            fullpath = fullpath.substr(index + 1, fullpath.length());
-                            prefix = fullpath.substr(0, fullpath.find("/"));
-                            pingResult["tripMax"] = prefix.c_str();
-                        }
-
-                        index = fullpath.find("/");
-                        if (index >= 0)
-                        {
-                            fullpath = fullpath.substr(index + 1, fullpath.length());
-                            pingResult["tripStdDev"] = fullpath.c_str();
-                        }
-                    }
-                    else if( line.find( "bad" ) != string::npos )
-                    {
-                        pingResult["success"] = false;
-                        pingResult["error"] = "Bad Address";
-                    }
+                    snprintf(trip, sizeof(trip), "%.3f", statistics.tripMin);
+                    pingResult["tripMin"] = trip;
+                    snprintf(trip, sizeof(trip), "%.3f", statistics.tripAvg);
+                    pingResult["tripAvg"] = trip;
+                    snprintf(trip, sizeof(trip), "%.3f", statistics.tripMax);
+                    pingResult["tripMax"] = trip;
+                    snprintf(trip, sizeof(trip), "%.3f", statistics.tripStdDev);
+                    pingResult["tripStdDev"] = trip;
                 }
-                fclose(fp);
-
-                // clear up
-                remove(outputFile.c_str());
             }
 
             pingResult["guid"] = guid;
@@ -0,0 +1,228 @@
+#pragma once
+
+#include <stdint.h>
+
+#include <algorithm>
+#include <atomic>
+#include <functional>
+#include <list>
+#include <map>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+
+namespace WPEFramework
+{
+
+namespace Plugin
+{
+
+/**
+ * @brief The containers Dobby runs, by id and by descriptor
+ *
+ * Kept up to date from the Dobby state events and the containers the plugin
+ * starts, so finding the descriptor of a container does not take a
+ * listContainers() round trip. The first lookup, and a lookup of a container
+ * that is not known, take the list from Dobby again, in case an event was
+ * missed.
+ */
+class ContainerRegistry
+{
+public:
+    typedef std::list<std::pair<int32_t, std::string>> Containers;
+    typedef std::function<Containers()> Lister;
+
+    struct Statistics
+    {
+        uint32_t lookups;
+        uint32_t syncs;
+    };
+
+    explicit ContainerRegistry(const Lister& lister)
+        : mLister(lister)
+        , mSynced(false)
+        , mStatistics({0, 0})
+    {
+    }
+
+    ContainerRegistry(const ContainerRegistry&) = delete;
+    ContainerRegistry& operator=(const ContainerRegistry&) = delete;
+
+    /**
+     * @brief The descriptor of a container
+     *
+     * @param containerId   The container ID, or its descriptor as a string
+     *
+     * @return The descriptor, -1 when Dobby does not know the container
+     */
+    int32_t find(const std::string& containerId)
+    {
+        std::unique_lock<std::mutex> lock(mMutex);
+        mStatistics.lookups++;
+
+        int32_t descriptor = -1;
+        if (mSynced && lookup(containerId, descriptor))
+        {
+            return descriptor;
+        }
+
+        // One list at a time, a lookup that waited for another one uses its result
+        uint32_t syncs = mStatistics.syncs;
+        lock.unlock();
+        std::lock_guard<std::mutex> syncLock(mSyncMutex);
+        lock.lock();
+        if (mSynced && (mStatistics.syncs != syncs))
+        {
+            lookup(containerId, descriptor);
+            return descriptor;
+        }
+
+        // Not under the lock: the events must not wait for Dobby
+        lock.unlock();
+        Containers containers = mLister();
+        lock.lock();
+
+        mStatistics.syncs++;
+        mById.clear();
+        mByDescriptor.clear();
+        for (const auto& container : containers)
+        {
+            add(container.first, container.second);
+        }
+        mSynced = true;
+
+        lookup(containerId, descriptor);
+        return descriptor;
+    }
+
+    /**
+     * @brief A container started, from its event or from starting it
+     */
+    void started(int32_t descriptor, const std::string& containerId)
+    {
+        std::lock_guard<std::mutex> lock(mMutex);
+        add(descriptor, containerId);
+    }
+
+    /**
+     * @brief A container stopped
+     */
+    void stopped(int32_t descriptor)
+    {
+        std::lock_guard<std::mutex> lock(mMutex);
+        auto it = mByDescriptor.find(descriptor);
+        if (it != mByDescriptor.end())
+        {
+            auto id = mById.find(it->second);
+            if (id != mById.end() && id->second == descriptor)
+            {
+                mById.erase(id);
+            }
+            mByDescriptor.erase(it);
+        }
+    }
+
+    /**
+     * @brief Forget everything, the next lookup asks Dobby again (e.g. after Dobby failed on a descriptor)
+     */
+    void invalidate()
+    {
+        std::lock_guard<std::mutex> lock(mMutex);
+        mSynced = false;
+    }
+
+    size_t size()
+    {
+        std::lock_guard<std::mutex> lock(mMutex);
+        return mByDescriptor.size();
+    }
+
+    Statistics statistics()
+    {
+        std::lock_guard<std::mutex> lock(mMutex);
+        return mStatistics;
+    }
+
+private:
+    void add(int32_t descriptor, const std::string& containerId)
+    {
+        // A descriptor is not reused while its container runs, but an id is once the container stopped
+        auto previous = mByDescriptor.find(descriptor);
+        if (previous != mByDescriptor.end() && previous->second != containerId)
+        {
+            mById.erase(previous->second);
+        }
+        mByDescriptor[descriptor] = containerId;
+        mById[containerId] = descriptor;
+    }
+
+    bool lookup(const std::string& containerId, int32_t& descriptor) const
+    {
+        auto it = mById.find(containerId);
+        if (it != mById.end())
+        {
+            descriptor = it->second;
+            return true;
+        }
+        for (const auto& entry : mByDescriptor)
+        {
+            if (containerId == std::to_string(entry.first))
+            {
+                descriptor = entry.first;
+                return true;
+            }
+        }
+        return false;
+    }
+
+    Lister mLister;
+    std::mutex mSyncMutex;
+    std::mutex mMutex;
+    bool mSynced;
+    std::map<std::string, int32_t> mById;
+    std::map<int32_t, std::string> mByDescriptor;
+    Statistics mStatistics;
+};
+
+/**
+ * @brief Runs an operation for every item of a batch, on up to concurrency threads at once
+ *
+ * Each Dobby call waits for its D-Bus reply, so the operations of a batch overlap
+ * rather than queue. Returns once every operation completed.
+ */
+inline void runBatch(size_t count, size_t concurrency, const std::function<void(size_t index)>& operation)
+{
+    size_t threads = std::min(count, std::max<size_t>(concurrency, 1));
+    if (threads <= 1)
+    {
+        for (size_t i = 0; i < count; i++)
+        {
+            operation(i);
+        }
+        return;
+    }
+
+    std::atomic<size_t> next(0);
+    auto worker = [&]() {
+        size_t index;
+        while ((index = next++) < count)
+        {
+            operation(index);
+        }
+    };
+
+    std::vector<std::thread> workers;
+    for (size_t i = 1; i < threads; i++)
+    {
+        workers.emplace_back(worker);
+    }
+    worker();
+    for (auto& thread : workers)
+    {
+        thread.join();
+    }
+}
+
+} // namespace Plugin
+} // namespace WPEFramework
@@ -15,8 +15,12 @@ namespace WPEJ = WPEFramework::Core::JSON;
 
 SERVICE_REGISTRATION(OCIContainer, 1, 0);
 
+// Dobby calls in flight at once for the batch methods
+static const size_t BATCH_CONCURRENCY = 4;
+
 OCIContainer::OCIContainer()
     : PluginHost::JSONRPC()
+    , mRegistry([this]() { return mDobbyProxy->listContainers(); })
 {
     Register("listContainers", &OCIContainer::listContainers, this);
     Register("getContainerState", &OCIContainer::getContainerState, this);
@@ -27,6 +31,10 @@ OCIContainer::OCIContainer()
     Register("pauseContainer", &OCIContainer::pauseContainer, this);
     Register("resumeContainer", &OCIContainer::resumeContainer, this);
     Register("executeCommand", &OCIContainer::executeCommand, this);
+    Register("startContainers", &OCIContainer::startContainers, this);
+    Register("stopContainers", &OCIContainer::stopContainers, this);
+    Register("pauseContainers", &OCIContainer::pauseContainers, this);
+    Register("resumeContainers", &OCIContainer::resumeContainers, this);
 }
 
 OCIContainer::~OCIContainer()
@@ -70,6 +78,10 @@ void OCIContainer::Deinitialize(PluginHost::IShell *service)
     Unregister("pauseContainer");
     Unregister("resumeContainer");
     Unregister("executeCommand");
+    Unregister("startContainers");
+    Unregister("stopContainers");
+    Unregister("pauseContainers");
+    Unregister("resumeContainers");
 }
 
 string OCIContainer::Information() const
@@ -234,29 +246,7 @@ uint32_t OCIContainer::startContainer(const JsonObject &parameters, JsonObject &
     std::string command = parameters["command"].String();
     std::string westerosSocket = parameters["westerosSocket"].String();
 
-    // Can be used to pass file descriptors to container construction.
-    // Currently unsupported, see DobbyProxy::startContainerFromBundle().
-    std::list<int> emptyList;
-
-    int descriptor;
-    // If no additional arguments, start the container
-    if ((command == "null" || command.empty()) && (westerosSocket == "null" || westerosSocket.empty()))
-    {
-        descriptor = mDobbyProxy->startContainerFromBundle(id, bundlePath, emptyList);
-    }
-    else
-    {
-        // Dobby expects empty strings if values not set
-        if (command == "null" || command.empty())
-        {
-            command = "";
-        }
-        if (westerosSocket == "null" || westerosSocket.empty())
-        {
-            westerosSocket = "";
-        }
-        descriptor = mDobbyProxy->startContainerFromBundle(id, bundlePath, emptyList, command, westerosSocket);
-    }
+    int descriptor = StartContainerFromBundle(id, bundlePath, command, westerosSocket);
 
     // startContainer returns -1 on failure
     if (descriptor <= 0)
@@ -329,6 +319,8 @@ uint32_t OCIContainer::startContainerFromDobbySpec(const JsonObject &parameters,
         returnResponse(false);
     }
 
+    mRegistry.started(descriptor, id);
+
     response["descriptor"] = descriptor;
     returnResponse(true);
 }
@@ -365,6 +357,8 @@ uint32_t OCIContainer::stopContainer(const JsonObject &parameters, JsonObject &r
 
     if (!stoppedSuccessfully)
     {
+        // The descriptor may be stale, look it up from Dobby next time
+        mRegistry.invalidate();
         LOGERR("Failed to stop container - internal Dobby error.");
         returnResponse(false);
     }
@@ -398,6 +392,8 @@ uint32_t OCIContainer::pauseContainer(const JsonObject &parameters, JsonObject &
 
     if (!pausedSuccessfully)
     {
+        // The descriptor may be stale, look it up from Dobby next time
+        mRegistry.invalidate();
         LOGERR("Failed to pause container - internal Dobby error.");
         returnResponse(false);
     }
@@ -431,6 +427,8 @@ uint32_t OCIContainer::resumeContainer(const JsonObject &parameters, JsonObject
 
     if (!resumedSuccessfully)
     {
+        // The descriptor may be stale, look it up from Dobby next time
+        mRegistry.invalidate();
         LOGERR("Failed to resume container - internal Dobby error.");
         returnResponse(false);
     }
@@ -470,6 +468,8 @@ uint32_t OCIContainer::executeCommand(const JsonObject &parameters, JsonObject &
 
     if (!executedSuccessfully)
     {
+        // The descriptor may be stale, look it up from Dobby next time
+        mRegistry.invalidate();
         LOGERR("Failed to execute command in container - internal Dobby error.");
         returnResponse(false);
     }
@@ -477,6 +477,120 @@ uint32_t OCIContainer::executeCommand(const JsonObject &parameters, JsonObject &
     returnResponse(true);
 }
 
+/**
+ * @brief Starts containers from OCI bundles, several at once
+ *
+ * @param[in]  parameters   Must include 'containers', an array of objects with the
+ *                          'containerId', 'bundlePath' and optionally 'command' and
+ *                          'westerosSocket' of startContainer.
+ * @param[out] response     The 'containerId', 'success' and 'descriptor' of each container,
+ *                          in the order given.
+ *
+ * @return                  A code indicating success, of every container.
+ */
+uint32_t OCIContainer::startContainers(const JsonObject &parameters, JsonObject &response)
+{
+    LOGINFO("Start containers from OCI bundles");
+
+    returnIfParamNotFound(parameters, "containers");
+    JsonArray containers = parameters["containers"].Array();
+
+    // Taken out of the JSON first, the starts run on other threads
+    std::vector<std::vector<std::string>> requests;
+    for (uint16_t i = 0; i < containers.Length(); i++)
+    {
+        JsonObject container = containers[i].Object();
+        if (!container.HasLabel("containerId") || !container.HasLabel("bundlePath"))
+        {
+            LOGERR("Container %u has no containerId or bundlePath", i);
+            returnResponse(false);
+        }
+        requests.push_back({ container["containerId"].String(), container["bundlePath"].String(),
+                             container["command"].String(), container["westerosSocket"].String() });
+    }
+
+    std::vector<int> descriptors(requests.size(), -1);
+    runBatch(requests.size(), BATCH_CONCURRENCY, [&](size_t index) {
+        const std::vector<std::string>& request = requests[index];
+        descriptors[index] = StartContainerFromBundle(request[0], request[1], request[2], request[3]);
+    });
+
+    bool success = true;
+    JsonArray results;
+    for (size_t i = 0; i < requests.size(); i++)
+    {
+        JsonObject result;
+        result["containerId"] = requests[i][0];
+        result["success"] = (descriptors[i] > 0);
+        if (descriptors[i] > 0)
+        {
+            result["descriptor"] = descriptors[i];
+        }
+        else
+        {
+            LOGERR("Failed to start container %s - internal Dobby error.", requests[i][0].c_str());
+            success = false;
+        }
+        results.Add(result);
+    }
+
+    response["results"] = results;
+    returnResponse(success);
+}
+
+/**
+ * @brief Stop running containers, several at once
+ *
+ * @param[in]  parameters   Must include 'containerIds', an array of the containers to stop,
+ *                          and optionally 'force'.
+ * @param[out] response     The 'containerId' and 'success' of each container, in the order given.
+ *
+ * @return                  A code indicating success, of every container.
+ */
+uint32_t OCIContainer::stopContainers(const JsonObject &parameters, JsonObject &response)
+{
+    LOGINFO("Stop containers");
+
+    bool forceStop = parameters["force"].Boolean();
+    return ForEachContainer(parameters, response, [this, forceStop](int cd) {
+        return mDobbyProxy->stopContainer(cd, forceStop);
+    });
+}
+
+/**
+ * @brief Pause running containers, several at once
+ *
+ * @param[in]  parameters   Must include 'containerIds', an array of the containers to pause.
+ * @param[out] response     The 'containerId' and 'success' of each container, in the order given.
+ *
+ * @return                  A code indicating success, of every container.
+ */
+uint32_t OCIContainer::pauseContainers(const JsonObject &parameters, JsonObject &response)
+{
+    LOGINFO("Pause containers");
+
+    return ForEachContainer(parameters, response, [this](int cd) {
+        return mDobbyProxy->pauseContainer(cd);
+    });
+}
+
+/**
+ * @brief Resume paused containers, several at once
+ *
+ * @param[in]  parameters   Must include 'containerIds', an array of the containers to resume.
+ * @param[out] response     The 'containerId' and 'success' of each container, in the order given.
+ *
+ * @return                  A code indicating success, of every container.
+ */
+uint32_t OCIContainer::resumeContainers(const JsonObject &parameters, JsonObject &response)
+{
+    LOGINFO("Resume containers");
+
+    return ForEachContainer(parameters, response, [this](int cd) {
+        return mDobbyProxy->resumeContainer(cd);
+    });
+}
+
 
 /**
  * @brief Send an event notifying that a container has started.
@@ -523,21 +637,108 @@ void OCIContainer::onContainerStopped(int32_t descriptor, const std::string& nam
  */
 const int OCIContainer::GetContainerDescriptorFromId(const std::string& containerId)
 {
-    const std::list<std::pair<int32_t, std::string>> containers = mDobbyProxy->listContainers();
+    // Asks Dobby only for a container the events did not tell about
+    int descriptor = mRegistry.find(containerId);
 
-    for (const std::pair<int32_t, std::string>& container : containers)
+    if (descriptor < 0)
     {
-        char strDescriptor[32];
-        sprintf(strDescriptor, "%d", container.first);
+        LOGERR("Failed to find container %s", containerId.c_str());
+    }
+    return descriptor;
+}
 
-        if ((containerId == strDescriptor) || (containerId == container.second))
+/**
+ * @brief Starts a container from an OCI bundle
+ *
+ * @param id             Container ID
+ * @param bundlePath     Path to the OCI bundle
+ * @param command        Command to run in the container, empty or "null" for the bundle's
+ * @param westerosSocket Westeros socket to mount in the container, empty or "null" for none
+ *
+ * @return Dobby descriptor of the started container, -1 on failure
+ */
+int OCIContainer::StartContainerFromBundle(const std::string& id, const std::string& bundlePath, std::string command, std::string westerosSocket)
+{
+    // Can be used to pass file descriptors to container construction.
+    // Currently unsupported, see DobbyProxy::startContainerFromBundle().
+    std::list<int> emptyList;
+
+    int descriptor;
+    // If no additional arguments, start the container
+    if ((command == "null" || command.empty()) && (westerosSocket == "null" || westerosSocket.empty()))
+    {
+        descriptor = mDobbyProxy->startContainerFromBundle(id, bundlePath, emptyList);
+    }
+    else
+    {
+        // Dobby expects empty strings if values not set
+        if (command == "null" || command.empty())
+        {
+            command = "";
+        }
+        if (westerosSocket == "null" || westerosSocket.empty())
+        {
+            westerosSocket = "";
+        }
+        descriptor = mDobbyProxy->startContainerFromBundle(id, bundlePath, emptyList, command, westerosSocket);
+    }
+
+    if (descriptor > 0)
+    {
+        mRegistry.started(descriptor, id);
+    }
+    return descriptor;
+}
+
+/**
+ * @brief Runs a Dobby operation on each of the 'containerIds', several at once
+ *
+ * @param[in]  parameters   Must include 'containerIds'.
+ * @param[out] response     The 'containerId' and 'success' of each container, in the order given.
+ * @param      operation    The operation, on the descriptor of a container.
+ *
+ * @return                  A code indicating success, of every container.
+ */
+uint32_t OCIContainer::ForEachContainer(const JsonObject &parameters, JsonObject &response, const std::function<bool(int descriptor)>& operation)
+{
+    returnIfParamNotFound(parameters, "containerIds");
+    JsonArray containerIds = parameters["containerIds"].Array();
+
+    std::vector<std::string> ids;
+    for (uint16_t i = 0; i < containerIds.Length(); i++)
+    {
+        ids.push_back(containerIds[i].String());
+    }
+
+    std::vector<char> succeeded(ids.size(), 0);
+    runBatch(ids.size(), BATCH_CONCURRENCY, [&](size_t index) {
+        int cd = GetContainerDescriptorFromId(ids[index]);
+        succeeded[index] = (cd >= 0) && operation(cd);
+    });
+
+    bool success = true;
+    JsonArray results;
+    for (size_t i = 0; i < ids.size(); i++)
+    {
+        JsonObject result;
+        result["containerId"] = ids[i];
+        result["success"] = (succeeded[i] != 0);
+        if (!succeeded[i])
         {
-            return container.first;
+            LOGERR("Failed on container %s - internal Dobby error.", ids[i].c_str());
+            success = false;
         }
+        results.Add(result);
+    }
+
+    if (!success)
+    {
+        // A descriptor may be stale, look them up from Dobby next time
+        mRegistry.invalidate();
     }
 
-    LOGERR("Failed to find container %s", containerId.c_str());
-    return -1;
+    response["results"] = results;
+    returnResponse(success);
 }
 
 /**
@@ -559,10 +760,12 @@ const void OCIContainer::stateListener(int32_t descriptor, const std::string& na
 
     if (state == IDobbyProxyEvents::ContainerState::Running)
     {
+        __this->mRegistry.started(descriptor, name);
         __this->onContainerStarted(descriptor, name);
     }
     else if (state == IDobbyProxyEvents::ContainerState::Stopped)
     {
+        __this->mRegistry.stopped(descriptor);
         __this->onContainerStopped(descriptor, name);
     }
     else
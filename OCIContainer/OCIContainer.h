@@ -2,10 +2,12 @@
 
 #include "Module.h"
 #include "utils.h"
+#include "ContainerRegistry.h"
 
 #include <Dobby/DobbyProtocol.h>
 #include <Dobby/Public/Dobby/IDobbyProxy.h>
 
+#include <functional>
 #include <vector>
 #include <map>
 
@@ -44,6 +46,10 @@ public:
     uint32_t pauseContainer(const JsonObject &parameters, JsonObject &response);
     uint32_t resumeContainer(const JsonObject &parameters, JsonObject &response);
     uint32_t executeCommand(const JsonObject &parameters, JsonObject &response);
+    uint32_t startContainers(const JsonObject &parameters, JsonObject &response);
+    uint32_t stopContainers(const JsonObject &parameters, JsonObject &response);
+    uint32_t pauseContainers(const JsonObject &parameters, JsonObject &response);
+    uint32_t resumeContainers(const JsonObject &parameters, JsonObject &response);
     //End methods
 
     //Begin events
@@ -68,7 +74,10 @@ private:
     int mEventListenerId; // Dobby event listener ID
     std::shared_ptr<IDobbyProxy> mDobbyProxy; // DobbyProxy instance
     std::shared_ptr<AI_IPC::IIpcService> mIpcService; // Ipc Service instance
+    ContainerRegistry mRegistry; // Descriptors of the running containers
     const int GetContainerDescriptorFromId(const std::string& containerId);
+    int StartContainerFromBundle(const std::string& id, const std::string& bundlePath, std::string command, std::string westerosSocket);
+    uint32_t ForEachContainer(const JsonObject &parameters, JsonObject &response, const std::function<bool(int descriptor)>& operation);
     static const void stateListener(int32_t descriptor, const std::string& name, IDobbyProxyEvents::ContainerState state, const void* _this);
 };
 } // namespace Plugin
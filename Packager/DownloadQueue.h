@@ -0,0 +1,522 @@
+/*
+ * If not stated otherwise in this file or this component's LICENSE file the
+ * following copyright and licenses apply:
+ *
+ * Copyright 2020 RDK Management
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#pragma once
+
+#include <curl/curl.h>
+#include <openssl/evp.h>
+
+#include <dirent.h>
+#include <limits.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#include <utime.h>
+
+#include <algorithm>
+#include <condition_variable>
+#include <functional>
+#include <list>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+
+namespace WPEFramework {
+namespace Plugin {
+
+    // Downloads packages on a few threads at once into a content addressed
+    // cache: a package is stored once, as sha256-<digest>.ipk, whatever the
+    // name or version it is asked for under, and only when it matches the
+    // digests the feed gives for it. For feeds with only an MD5 sum,
+    // md5-<digest>.ipk links to it. Cached packages are verified again
+    // before they are handed out.
+    //
+    // The cache is kept under a size limit by removing the packages used
+    // least recently, but for the ones handed out and not released yet.
+    class DownloadQueue {
+    public:
+        struct Request {
+            std::string Url;
+            // Expected digests in hex, empty when the feed does not give them
+            std::string Sha256;
+            std::string Md5;
+        };
+
+        struct Statistics {
+            uint32_t Downloads;
+            uint32_t CacheHits;
+            uint32_t Shared; // Requests served by a download already queued
+            uint32_t Failures;
+            uint32_t Evictions;
+            uint64_t Bytes;
+        };
+
+        // Called on the download threads. The path is the package in the
+        // cache, empty when the download or its verification failed. It is
+        // kept until it is released.
+        typedef std::function<void(uint32_t id, uint8_t percent)> ProgressHandler;
+        typedef std::function<void(uint32_t id, const std::string& path)> CompletionHandler;
+
+        DownloadQueue(const DownloadQueue&) = delete;
+        DownloadQueue& operator=(const DownloadQueue&) = delete;
+
+        // A limit of 0 keeps the cache unbounded
+        DownloadQueue(const std::string& directory, uint8_t concurrency, uint64_t limit,
+                      const ProgressHandler& progress, const CompletionHandler& completion)
+            : _directory(directory)
+            , _limit(limit)
+            , _progress(progress)
+            , _completion(completion)
+            , _stopping(false)
+            , _statistics({ 0, 0, 0, 0, 0, 0 })
+        {
+            if (_directory.empty() == false && _directory.back() != '/') {
+                _directory += '/';
+            }
+            ::mkdir(_directory.c_str(), 0755);
+
+            // Left over by downloads the process did not get to finish
+            DIR* directoryStream = ::opendir(_directory.c_str());
+            if (directoryStream != nullptr) {
+                struct dirent* entry;
+                while ((entry = ::readdir(directoryStream)) != nullptr) {
+                    if (strncmp(entry->d_name, "download-", 9) == 0) {
+                        ::unlink((_directory + entry->d_name).c_str());
+                    }
+                }
+                ::closedir(directoryStream);
+            }
+            {
+                std::lock_guard<std::mutex> lock(_lock);
+                TrimLocked();
+            }
+
+            curl_global_init(CURL_GLOBAL_DEFAULT);
+            for (uint8_t i = 0; i < std::max<uint8_t>(concurrency, 1); i++) {
+                _threads.emplace_back(&DownloadQueue::Worker, this);
+            }
+        }
+
+        // Downloads in progress are aborted, their completions not called
+        ~DownloadQueue()
+        {
+            {
+                std::lock_guard<std::mutex> lock(_lock);
+                _stopping = true;
+            }
+            _condition.notify_all();
+            for (auto& thread : _threads) {
+                thread.join();
+            }
+            curl_global_cleanup();
+        }
+
+        const std::string& Directory() const
+        {
+            return _directory;
+        }
+
+        // Requests for the same package (by digest, or by URL without one)
+        // share a single download
+        void Submit(uint32_t id, const Request& request)
+        {
+            std::string key = Key(request);
+            {
+                std::lock_guard<std::mutex> lock(_lock);
+                auto active = _active.find(key);
+                if (active != _active.end()) {
+                    active->second->Ids.push_back(id);
+                    _statistics.Shared++;
+                    return;
+                }
+                std::shared_ptr<Job> job(new Job());
+                job->Key = key;
+                job->Request = request;
+                job->Request.Sha256 = Lower(request.Sha256);
+                job->Request.Md5 = Lower(request.Md5);
+                job->Ids.push_back(id);
+                _active[key] = job;
+                _pending.push_back(job);
+            }
+            _condition.notify_one();
+        }
+
+        // The verified package in the cache, empty when it is not there
+        std::string Cached(const Request& request) const
+        {
+            std::string sha256 = Lower(request.Sha256);
+            std::string md5 = Lower(request.Md5);
+            std::string path;
+            if (sha256.empty() == false) {
+                path = _directory + "sha256-" + sha256 + ".ipk";
+            } else if (md5.empty() == false) {
+                char resolved[PATH_MAX];
+                if (::realpath((_directory + "md5-" + md5 + ".ipk").c_str(), resolved) != nullptr) {
+                    path = resolved;
+                }
+            }
+
+            struct stat info;
+            if (path.empty() == true || ::stat(path.c_str(), &info) != 0 || S_ISREG(info.st_mode) == false) {
+                return std::string();
+            }
+
+            std::string actualSha256, actualMd5;
+            if (Digest(path, actualSha256, actualMd5) == false
+                || path.compare(path.rfind('/') + 1, std::string::npos, "sha256-" + actualSha256 + ".ipk") != 0
+                || (md5.empty() == false && md5 != actualMd5)) {
+                ::unlink(path.c_str());
+                return std::string();
+            }
+            return path;
+        }
+
+        // Hands back a path given to the completion. Once no request holds it
+        // any more the package is removed when asked to, e.g. after it was
+        // installed, or left to the size limit.
+        void Release(const std::string& path, bool remove)
+        {
+            std::lock_guard<std::mutex> lock(_lock);
+            auto held = _held.find(path);
+            if (held != _held.end() && --(held->second) == 0) {
+                _held.erase(held);
+            }
+            if (remove == true && _held.find(path) == _held.end()) {
+                EraseLocked(path.substr(path.rfind('/') + 1));
+            }
+            TrimLocked();
+        }
+
+        Statistics Stats() const
+        {
+            std::lock_guard<std::mutex> lock(_lock);
+            return _statistics;
+        }
+
+    private:
+        struct Job {
+            std::string Key;
+            DownloadQueue::Request Request;
+            std::vector<uint32_t> Ids;
+        };
+
+        struct Transfer {
+            DownloadQueue* Parent;
+            Job* Download;
+            FILE* File;
+            EVP_MD_CTX* Sha256;
+            EVP_MD_CTX* Md5;
+            uint64_t Bytes;
+            int Percent;
+        };
+
+        static std::string Key(const Request& request)
+        {
+            if (request.Sha256.empty() == false) {
+                return "sha256:" + Lower(request.Sha256);
+            } else if (request.Md5.empty() == false) {
+                return "md5:" + Lower(request.Md5);
+            }
+            return "url:" + request.Url;
+        }
+
+        static std::string Lower(std::string text)
+        {
+            std::transform(text.begin(), text.end(), text.begin(), ::tolower);
+            return text;
+        }
+
+        static std::string Hex(EVP_MD_CTX* context)
+        {
+            static const char digits[] = "0123456789abcdef";
+            unsigned char digest[EVP_MAX_MD_SIZE];
+            unsigned int length = 0;
+            EVP_DigestFinal_ex(context, digest, &length);
+            std::string hex;
+            for (unsigned int i = 0; i < length; i++) {
+                hex += digits[digest[i] >> 4];
+                hex += digits[digest[i] & 0x0F];
+            }
+            return hex;
+        }
+
+        static bool Digest(const std::string& path, std::string& sha256, std::string& md5)
+        {
+            FILE* file = fopen(path.c_str(), "rb");
+            if (file == nullptr) {
+                return false;
+            }
+            EVP_MD_CTX* sha256Context = EVP_MD_CTX_new();
+            EVP_MD_CTX* md5Context = EVP_MD_CTX_new();
+            EVP_DigestInit_ex(sha256Context, EVP_sha256(), nullptr);
+            EVP_DigestInit_ex(md5Context, EVP_md5(), nullptr);
+
+            char buffer[64 * 1024];
+            size_t read;
+            while ((read = fread(buffer, 1, sizeof(buffer), file)) > 0) {
+                EVP_DigestUpdate(sha256Context, buffer, read);
+                EVP_DigestUpdate(md5Context, buffer, read);
+            }
+            bool result = (ferror(file) == 0);
+            fclose(file);
+
+            sha256 = Hex(sha256Context);
+            md5 = Hex(md5Context);
+            EVP_MD_CTX_free(sha256Context);
+            EVP_MD_CTX_free(md5Context);
+            return result;
+        }
+
+        static size_t Write(char* data, size_t size, size_t count, void* user)
+        {
+            Transfer* transfer = static_cast<Transfer*>(user);
+            size_t length = size * count;
+            EVP_DigestUpdate(transfer->Sha256, data, length);
+            EVP_DigestUpdate(transfer->Md5, data, length);
+            transfer->Bytes += length;
+            return fwrite(data, 1, length, transfer->File);
+        }
+
+        static int Progress(void* user, curl_off_t total, curl_off_t now, curl_off_t, curl_off_t)
+        {
+            Transfer* transfer = static_cast<Transfer*>(user);
+            if (total > 0) {
+                int percent = static_cast<int>((now * 100) / total);
+                if (percent != transfer->Percent) {
+                    transfer->Percent = percent;
+                    transfer->Parent->Report(*transfer->Download, static_cast<uint8_t>(percent));
+                }
+            }
+            std::lock_guard<std::mutex> lock(transfer->Parent->_lock);
+            return (transfer->Parent->_stopping == true) ? 1 : 0;
+        }
+
+        // Removes a package from the cache, with the md5 links to it
+        void EraseLocked(const std::string& name)
+        {
+            if (::unlink((_directory + name).c_str()) != 0) {
+                return;
+            }
+            DIR* directory = ::opendir(_directory.c_str());
+            if (directory == nullptr) {
+                return;
+            }
+            struct dirent* entry;
+            char target[PATH_MAX];
+            while ((entry = ::readdir(directory)) != nullptr) {
+                if (strncmp(entry->d_name, "md5-", 4) == 0) {
+                    std::string link = _directory + entry->d_name;
+                    ssize_t length = ::readlink(link.c_str(), target, sizeof(target));
+                    if (length > 0 && name.compare(0, std::string::npos, target, length) == 0) {
+                        ::unlink(link.c_str());
+                    }
+                }
+            }
+            ::closedir(directory);
+        }
+
+        // Removes the packages not held, least recently used first, until the
+        // cache is under its limit
+        void TrimLocked()
+        {
+            if (_limit == 0) {
+                return;
+            }
+            struct Package {
+                std::string Name;
+                uint64_t Size;
+                time_t Used;
+            };
+            std::vector<Package> packages;
+            uint64_t total = 0;
+            DIR* directory = ::opendir(_directory.c_str());
+            if (directory == nullptr) {
+                return;
+            }
+            struct dirent* entry;
+            while ((entry = ::readdir(directory)) != nullptr) {
+                struct stat info;
+                if (strncmp(entry->d_name, "sha256-", 7) == 0
+                    && ::lstat((_directory + entry->d_name).c_str(), &info) == 0 && S_ISREG(info.st_mode) == true) {
+                    packages.push_back({ entry->d_name, static_cast<uint64_t>(info.st_size), info.st_mtime });
+                    total += info.st_size;
+                }
+            }
+            ::closedir(directory);
+
+            std::sort(packages.begin(), packages.end(), [](const Package& a, const Package& b) { return a.Used < b.Used; });
+            for (const Package& package : packages) {
+                if (total <= _limit) {
+                    break;
+                }
+                if (_held.find(_directory + package.Name) == _held.end()) {
+                    EraseLocked(package.Name);
+                    total -= package.Size;
+                    _statistics.Evictions++;
+                }
+            }
+        }
+
+        void Report(const Job& job, uint8_t percent)
+        {
+            std::vector<uint32_t> ids;
+            {
+                std::lock_guard<std::mutex> lock(_lock);
+                ids = job.Ids;
+            }
+            for (uint32_t id : ids) {
+                _progress(id, percent);
+            }
+        }
+
+        // The package in the cache, empty on failure
+        std::string Fetch(Job& job)
+        {
+            std::string temporary = _directory + "download-XXXXXX";
+            int fd = ::mkstemp(&temporary[0]);
+            if (fd < 0) {
+                return std::string();
+            }
+
+            Transfer transfer = { this, &job, fdopen(fd, "wb"), EVP_MD_CTX_new(), EVP_MD_CTX_new(), 0, -1 };
+            EVP_DigestInit_ex(transfer.Sha256, EVP_sha256(), nullptr);
+            EVP_DigestInit_ex(transfer.Md5, EVP_md5(), nullptr);
+
+            CURL* curl = curl_easy_init();
+            curl_easy_setopt(curl, CURLOPT_URL, job.Request.Url.c_str());
+            curl_easy_setopt(curl, CURLOPT_WRITEFUNCTION, &DownloadQueue::Write);
+            curl_easy_setopt(curl, CURLOPT_WRITEDATA, &transfer);
+            curl_easy_setopt(curl, CURLOPT_XFERINFOFUNCTION, &DownloadQueue::Progress);
+            curl_easy_setopt(curl, CURLOPT_XFERINFODATA, &transfer);
+            curl_easy_setopt(curl, CURLOPT_NOPROGRESS, 0L);
+            curl_easy_setopt(curl, CURLOPT_FAILONERROR, 1L);
+            curl_easy_setopt(curl, CURLOPT_FOLLOWLOCATION, 1L);
+            curl_easy_setopt(curl, CURLOPT_NOSIGNAL, 1L);
+            curl_easy_setopt(curl, CURLOPT_CONNECTTIMEOUT, 30L);
+            // Give up on a download that stalls for a minute
+            curl_easy_setopt(curl, CURLOPT_LOW_SPEED_LIMIT, 1L);
+            curl_easy_setopt(curl, CURLOPT_LOW_SPEED_TIME, 60L);
+            CURLcode code = curl_easy_perform(curl);
+            curl_easy_cleanup(curl);
+
+            bool written = (fclose(transfer.File) == 0);
+            std::string sha256 = Hex(transfer.Sha256);
+            std::string md5 = Hex(transfer.Md5);
+            EVP_MD_CTX_free(transfer.Sha256);
+            EVP_MD_CTX_free(transfer.Md5);
+
+            if (code != CURLE_OK || written == false
+                || (job.Request.Sha256.empty() == false && job.Request.Sha256 != sha256)
+                || (job.Request.Md5.empty() == false && job.Request.Md5 != md5)) {
+                ::unlink(temporary.c_str());
+                return std::string();
+            }
+
+            std::string name = "sha256-" + sha256 + ".ipk";
+            std::string path = _directory + name;
+            ::chmod(temporary.c_str(), 0644);
+            if (::rename(temporary.c_str(), path.c_str()) != 0) {
+                ::unlink(temporary.c_str());
+                return std::string();
+            }
+            std::string link = _directory + "md5-" + md5 + ".ipk";
+            ::unlink(link.c_str());
+            if (::symlink(name.c_str(), link.c_str()) != 0) {
+                // Failing that, a feed with only MD5 sums downloads the package again
+                ::unlink(link.c_str());
+            }
+
+            std::lock_guard<std::mutex> lock(_lock);
+            _statistics.Downloads++;
+            _statistics.Bytes += transfer.Bytes;
+            return path;
+        }
+
+        void Worker()
+        {
+            std::unique_lock<std::mutex> lock(_lock);
+            while (true) {
+                _condition.wait(lock, [this]() { return _stopping == true || _pending.empty() == false; });
+                if (_stopping == true) {
+                    break;
+                }
+                std::shared_ptr<Job> job = _pending.front();
+                _pending.pop_front();
+                lock.unlock();
+
+                std::string path = Cached(job->Request);
+                bool hit = (path.empty() == false);
+                if (hit == true) {
+                    // The modification time orders the packages for the size limit
+                    ::utime(path.c_str(), nullptr);
+                } else {
+                    path = Fetch(*job);
+                }
+
+                lock.lock();
+                if (_stopping == true) {
+                    break;
+                }
+                // Not held until now, the limit might have taken it already
+                if (path.empty() == false && ::access(path.c_str(), R_OK) != 0) {
+                    path.clear();
+                    hit = false;
+                }
+                if (hit == true) {
+                    _statistics.CacheHits++;
+                } else if (path.empty() == true) {
+                    _statistics.Failures++;
+                }
+                // Asked for again from now on, it is a cache hit
+                _active.erase(job->Key);
+                std::vector<uint32_t> ids = job->Ids;
+                if (path.empty() == false) {
+                    _held[path] += static_cast<uint32_t>(ids.size());
+                    TrimLocked();
+                }
+                lock.unlock();
+
+                for (uint32_t id : ids) {
+                    _completion(id, path);
+                }
+                lock.lock();
+            }
+        }
+
+        std::string _directory;
+        uint64_t _limit;
+        ProgressHandler _progress;
+        CompletionHandler _completion;
+        mutable std::mutex _lock;
+        std::condition_variable _condition;
+        bool _stopping;
+        std::list<std::shared_ptr<Job>> _pending;
+        std::map<std::string, std::shared_ptr<Job>> _active;
+        std::map<std::string, uint32_t> _held; // Paths handed out, by the requests holding them
+        Statistics _statistics;
+        std::vector<std::thread> _threads;
+    };
+
+}  // namespace Plugin
+}  // namespace WPEFramework
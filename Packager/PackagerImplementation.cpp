@@ -26,6 +26,9 @@
 #endif
 #include <opkg_download.h>
 #include <pkg.h>
+#include <pkg_hash.h>
+
+#include <unistd.h>
 
 namespace WPEFramework {
 namespace Plugin {
@@ -102,14 +105,31 @@ namespace Plugin {
              _volatileCache = config.MakeCacheVolatile.Value();
          }
 
+        if ((config.Downloads.IsSet() == true) && (config.Downloads.Value() > 0)) {
+            _downloadThreads = config.Downloads.Value();
+        }
+
+        if (config.CacheSize.IsSet() == true) {
+            _cacheSize = config.CacheSize.Value();
+        }
+
+        // Packages are downloaded into a cache of their own, cleared on exit with a volatile cache
+        string contentPath = Core::Directory::Normalize(_volatileCache == true ? _tempPath : _cachePath) + _T("content/");
+
         if (Core::File(_configFile).Exists() == false) {
             result = Core::ERROR_GENERAL;
         } else if (Core::Directory(_tempPath.c_str()).CreatePath() == false) {
             result = Core::ERROR_GENERAL;
         } else if (Core::Directory(_cachePath.c_str()).CreatePath() == false) {
             result = Core::ERROR_GENERAL;
+        } else if (Core::Directory(contentPath.c_str()).CreatePath() == false) {
+            result = Core::ERROR_GENERAL;
         } else {
-            /* See Install() for explanation why it's not done here.
+            _downloads.reset(new DownloadQueue(contentPath, _downloadThreads, static_cast<uint64_t>(_cacheSize) * 1024 * 1024,
+                [this](uint32_t id, uint8_t percent) { DownloadProgress(id, percent); },
+                [this](uint32_t id, const string& path) { DownloadCompleted(id, path); }));
+
+            /* See ReinitOPKG() for explanation why it's not done here.
             if (InitOPKG() == false) {
                 result = Core::ERROR_GENERAL;
             }
@@ -121,6 +141,8 @@ namespace Plugin {
 
     PackagerImplementation::~PackagerImplementation()
     {
+        // Before the queue the downloads report on goes
+        _downloads.reset();
         FreeOPKG();
         _servicePI->Release();
         _servicePI = nullptr;
@@ -132,9 +154,9 @@ namespace Plugin {
         _adminLock.Lock();
         notification->AddRef();
         _notifications.push_back(notification);
-        if (_inProgress.Install != nullptr) {
-            ASSERT(_inProgress.Package != nullptr);
-            notification->StateChange(_inProgress.Package, _inProgress.Install);
+        for (const InstallationData& item : _queue) {
+            ASSERT(item.Package != nullptr && item.Install != nullptr);
+            notification->StateChange(item.Package, item.Install);
         }
         _adminLock.Unlock();
     }
@@ -145,8 +167,8 @@ namespace Plugin {
         _adminLock.Lock();
         auto item = std::find(_notifications.begin(), _notifications.end(), notification);
         ASSERT(item != _notifications.end());
-        _notifications.erase(item);
         (*item)->Release();
+        _notifications.erase(item);
         _adminLock.Unlock();
     }
 
@@ -162,31 +184,31 @@ namespace Plugin {
 
     uint32_t PackagerImplementation::DoWork(const string* name, const string* version, const string* arch)
     {
-        uint32_t result = Core::ERROR_INPROGRESS;
+        uint32_t result = Core::ERROR_NONE;
 
         _adminLock.Lock();
-        if (_inProgress.Install == nullptr && _isSyncing == false) {
-            ASSERT(_inProgress.Package == nullptr);
-            result = Core::ERROR_NONE;
-            // OPKG bug: it marks it checked dependency for a package as cyclic dependency handling fix
-            // but since in our case it's not an process which dies when done, this info survives and makes the
-            // deps check to be skipped on subsequent calls. This is why hash_deinit() is called below
-            // and needs to be initialized here agian.
-            if (_opkgInitialized == true)  // it was initialized
-                FreeOPKG();
-            _opkgInitialized = InitOPKG();
-
-            if (_opkgInitialized) {
-                if (name && version && arch) {
-                    _inProgress.Package = Core::Service<PackageInfo>::Create<PackageInfo>(*name, *version, *arch);
-                    _inProgress.Install = Core::Service<InstallInfo>::Create<InstallInfo>();
-                } else {
-                    _isSyncing = true;
-                }
-                _worker.Run();
-            } else {
+        if (name && version && arch) {
+            // Installs queue up, their downloads run alongside each other. A package is queued once.
+            auto queued = std::find_if(_queue.begin(), _queue.end(), [name](const InstallationData& item) {
+                return item.Package->Name() == *name;
+            });
+            if (_downloads == nullptr) {
                 result = Core::ERROR_GENERAL;
+            } else if (queued != _queue.end()) {
+                result = Core::ERROR_INPROGRESS;
+            } else {
+                _queue.emplace_back();
+                InstallationData& item = _queue.back();
+                item.Id = _nextId++;
+                item.Package = Core::Service<PackageInfo>::Create<PackageInfo>(*name, *version, *arch);
+                item.Install = Core::Service<InstallInfo>::Create<InstallInfo>();
+                _worker.Run();
             }
+        } else if (_isSyncing == true || _queue.empty() == false) {
+            result = Core::ERROR_INPROGRESS;
+        } else {
+            _isSyncing = true;
+            _worker.Run();
         }
         _adminLock.Unlock();
 
@@ -194,29 +216,194 @@ namespace Plugin {
 
     }
 
+    void PackagerImplementation::ProcessQueue()
+    {
+        _adminLock.Lock();
+        _queue.remove_if([](const InstallationData& item) { return item.Current == Step::DONE; });
+
+        bool isSyncing = _isSyncing;
+        std::vector<InstallationData*> queued;
+        InstallationData* next = nullptr;
+        for (InstallationData& item : _queue) {
+            if (item.Current == Step::QUEUED) {
+                queued.push_back(&item);
+            } else if (item.Current == Step::DOWNLOADED && next == nullptr) {
+                next = &item;
+            }
+        }
+        if (isSyncing == false && queued.empty() == true && next == nullptr) {
+            // Under the lock the queue changes with, so the next Run() is not missed
+            _worker.Block();
+        }
+        // Synchronizing and looking up the packages queued go first
+        _inProgress = (isSyncing == false && queued.empty() == true) ? next : nullptr;
+        _adminLock.Unlock();
+
+        // After this point locking is not needed but for the queue items downloading, only this thread
+        // moves an item on from DOWNLOADED and removes it.
+        if (isSyncing == true) {
+            if (ReinitOPKG() == true) {
+                BlockingSetupLocalRepoNoLock(RepoSyncMode::FORCED);
+            } else {
+                NotifyRepoSynced(Core::ERROR_GENERAL);
+            }
+        } else if (queued.empty() == false) {
+            BlockingResolveNoLock(queued);
+        } else if (_inProgress != nullptr) {
+            if (ReinitOPKG() == true) {
+                BlockingInstallUntilCompletionNoLock();
+            } else {
+                next->Install->SetError(Core::ERROR_GENERAL);
+                NotifyStateChange();
+            }
+
+            // Installed, the package is not kept; failing, it is for another try, within the cache size
+            if (next->LocalFile.empty() == false) {
+                _downloads->Release(next->LocalFile, next->Install->ErrorCode() == 0);
+            }
+
+            _adminLock.Lock();
+            _inProgress = nullptr;
+            _queue.remove_if([next](const InstallationData& item) { return &item == next; });
+            _adminLock.Unlock();
+        }
+    }
+
+    void PackagerImplementation::BlockingResolveNoLock(const std::vector<InstallationData*>& queued)
+    {
+        // One read of the feeds for all the packages queued in the meantime
+        bool initialized = ReinitOPKG();
+        if (initialized == true) {
+            BlockingSetupLocalRepoNoLock(RepoSyncMode::SETUP);
+        }
+
+        for (InstallationData* item : queued) {
+            DownloadQueue::Request request;
+            string fileName;
+            bool download = (initialized == true) && (ResolveNoLock(item->Package->Name(), request, fileName) == true);
+
+            _adminLock.Lock();
+            if (initialized == false) {
+                item->Install->SetError(Core::ERROR_GENERAL);
+                item->Current = Step::DONE;
+                NotifyStateChange(*item);
+            } else if (download == true) {
+                item->FileName = fileName;
+                item->Current = Step::DOWNLOADING;
+                item->Install->SetState(Exchange::IPackager::DOWNLOADING);
+                NotifyStateChange(*item);
+            } else {
+                // A URL, a file or a package without checksums in the feed, opkg gets it when installing
+                item->Current = Step::DOWNLOADED;
+            }
+            _adminLock.Unlock();
+
+            if (download == true) {
+                _downloads->Submit(item->Id, request);
+            }
+        }
+    }
+
+    bool PackagerImplementation::ResolveNoLock(const string& name, DownloadQueue::Request& request, string& fileName) const
+    {
+        pkg_t* pkg = pkg_hash_fetch_best_installation_candidate_by_name(name.c_str());
+        if (pkg == nullptr || pkg->src == nullptr || pkg->src->value == nullptr || pkg->filename == nullptr) {
+            return false;
+        }
+
+        request.Url = string(pkg->src->value) + _T("/") + pkg->filename;
+#if defined (HAVE_SHA256)
+        if (pkg->sha256sum != nullptr) {
+            request.Sha256 = pkg->sha256sum;
+        }
+#endif
+        if (pkg->md5sum != nullptr) {
+            request.Md5 = pkg->md5sum;
+        }
+        fileName = pkg->filename;
+
+        // Downloaded here it is only checked against the feed index, signed when signatures are checked;
+        // without checksums there opkg downloads it, checking its signature
+        return (_skipSignatureChecking == true) || (request.Sha256.empty() == false) || (request.Md5.empty() == false);
+    }
+
+    PackagerImplementation::InstallationData* PackagerImplementation::Find(uint32_t id)
+    {
+        for (InstallationData& item : _queue) {
+            if (item.Id == id) {
+                return &item;
+            }
+        }
+        return nullptr;
+    }
+
+    void PackagerImplementation::DownloadProgress(uint32_t id, uint8_t percent)
+    {
+        _adminLock.Lock();
+        InstallationData* item = Find(id);
+        if (item != nullptr && item->Current == Step::DOWNLOADING) {
+            item->Install->SetProgress(percent);
+            NotifyStateChange(*item);
+        }
+        _adminLock.Unlock();
+    }
+
+    void PackagerImplementation::DownloadCompleted(uint32_t id, const string& path)
+    {
+        _adminLock.Lock();
+        InstallationData* item = Find(id);
+        if (item != nullptr && item->Current == Step::DOWNLOADING) {
+            if (path.empty() == true) {
+                // E.g. a feed behind the proxy, certificates or authentication of opkg.conf, which opkg
+                // downloads from when installing
+                TRACE_L1("Failed to download %s, opkg downloads it", item->Package->Name().c_str());
+                item->Current = Step::DOWNLOADED;
+                item->Install->SetProgress(0);
+            } else {
+                item->LocalFile = path;
+                item->Current = Step::DOWNLOADED;
+                item->Install->SetProgress(100);
+                item->Install->SetState(Exchange::IPackager::DOWNLOADED);
+            }
+            NotifyStateChange(*item);
+            _worker.Run();
+        }
+        _adminLock.Unlock();
+    }
+
     void PackagerImplementation::BlockingInstallUntilCompletionNoLock() {
-        ASSERT(_inProgress.Install != nullptr && _inProgress.Package != nullptr);
+        ASSERT(_inProgress != nullptr && _inProgress->Install != nullptr && _inProgress->Package != nullptr);
+
+        // A package downloaded into the cache is installed from there, under its name in the feed
+        string target = _inProgress->Package->Name();
+        string staged;
+        if (_inProgress->LocalFile.empty() == false) {
+            staged = _downloads->Directory() + _T("staging/") + _inProgress->FileName;
+            Core::Directory(Core::File::PathName(staged).c_str()).CreatePath();
+            ::unlink(staged.c_str());
+            target = (::link(_inProgress->LocalFile.c_str(), staged.c_str()) == 0) ? staged : _inProgress->LocalFile;
+        }
 
 #if defined (DO_NOT_USE_DEPRECATED_API)
         opkg_cmd_t* command = opkg_cmd_find("install");
         if (command) {
-            _inProgress.Install->SetState(Exchange::IPackager::INSTALLING);
+            _inProgress->Install->SetState(Exchange::IPackager::INSTALLING);
             NotifyStateChange();
             opkg_config->pfm = command->pfm;
-            std::unique_ptr<char[]> targetCopy(new char [_inProgress.Package->Name().length() + 1]);
-            std::copy_n(_inProgress.Package->Name().begin(), _inProgress.Package->Name().length(), targetCopy.get());
-            (targetCopy.get())[_inProgress.Package->Name().length()] = 0;
+            std::unique_ptr<char[]> targetCopy(new char [target.length() + 1]);
+            std::copy_n(target.begin(), target.length(), targetCopy.get());
+            (targetCopy.get())[target.length()] = 0;
             const char* argv[1];
             argv[0] = targetCopy.get();
             if (opkg_cmd_exec(command, 1, argv) == 0) {
-                _inProgress.Install->SetProgress(100);
-                _inProgress.Install->SetState(Exchange::IPackager::INSTALLED);
+                _inProgress->Install->SetProgress(100);
+                _inProgress->Install->SetState(Exchange::IPackager::INSTALLED);
             } else {
-                _inProgress.Install->SetError(Core::ERROR_GENERAL);
+                _inProgress->Install->SetError(Core::ERROR_GENERAL);
             }
             NotifyStateChange();
         } else {
-            _inProgress.Install->SetError(Core::ERROR_GENERAL);
+            _inProgress->Install->SetError(Core::ERROR_GENERAL);
             NotifyStateChange();
         }
 #else
@@ -224,10 +411,10 @@ namespace Plugin {
         opkg_package_callback_t checkUpgrade = [](pkg* pkg, void* user_data) {
             PackagerImplementation* self = static_cast<PackagerImplementation*>(user_data);
             if (self->_isUpgrade == false) {
-                self->_isUpgrade = self->_inProgress.Package->Name() == pkg->name;
-                if (self->_isUpgrade && self->_inProgress.Package->Version().empty() == false) {
+                self->_isUpgrade = self->_inProgress->Package->Name() == pkg->name;
+                if (self->_isUpgrade && self->_inProgress->Package->Version().empty() == false) {
                     self->_isUpgrade = opkg_compare_versions(pkg->version,
-                                                             self->_inProgress.Package->Version().c_str()) < 0;
+                                                             self->_inProgress->Package->Version().c_str()) < 0;
                 }
             }
         };
@@ -235,17 +422,22 @@ namespace Plugin {
 
         typedef int (*InstallFunction)(const char *, opkg_progress_callback_t, void *);
         InstallFunction installFunction = opkg_install_package;
-        if (_isUpgrade) {
+        // Installing a newer package file upgrades as well
+        if (_isUpgrade && _inProgress->LocalFile.empty() == true) {
             installFunction = opkg_upgrade_package;
         }
         _isUpgrade = false;
 
-        if (installFunction(_inProgress.Package->Name().c_str(), PackagerImplementation::InstallationProgessNoLock,
+        if (installFunction(target.c_str(), PackagerImplementation::InstallationProgessNoLock,
                             this) != 0) {
-            _inProgress.Install->SetError(Core::ERROR_GENERAL);
+            _inProgress->Install->SetError(Core::ERROR_GENERAL);
             NotifyStateChange();
         }
 #endif
+
+        if (staged.empty() == false) {
+            ::unlink(staged.c_str());
+        }
     }
 
 #if !defined (DO_NOT_USE_DEPRECATED_API)
@@ -253,23 +445,23 @@ namespace Plugin {
                                                                         void* data)
     {
         PackagerImplementation* self = static_cast<PackagerImplementation*>(data);
-        self->_inProgress.Install->SetProgress(progress->percentage);
+        self->_inProgress->Install->SetProgress(progress->percentage);
         if (progress->action == OPKG_INSTALL &&
-            self->_inProgress.Install->State() == Exchange::IPackager::DOWNLOADING) {
-            self->_inProgress.Install->SetState(Exchange::IPackager::DOWNLOADED);
+            self->_inProgress->Install->State() == Exchange::IPackager::DOWNLOADING) {
+            self->_inProgress->Install->SetState(Exchange::IPackager::DOWNLOADED);
             self->NotifyStateChange();
         }
         bool stateChanged = false;
         switch (progress->action) {
             case OPKG_DOWNLOAD:
-                if (self->_inProgress.Install->State() != Exchange::IPackager::DOWNLOADING) {
-                    self->_inProgress.Install->SetState(Exchange::IPackager::DOWNLOADING);
+                if (self->_inProgress->Install->State() != Exchange::IPackager::DOWNLOADING) {
+                    self->_inProgress->Install->SetState(Exchange::IPackager::DOWNLOADING);
                     stateChanged = true;
                 }
                 break;
             case OPKG_INSTALL:
-                if (self->_inProgress.Install->State() != Exchange::IPackager::INSTALLING) {
-                    self->_inProgress.Install->SetState(Exchange::IPackager::INSTALLING);
+                if (self->_inProgress->Install->State() != Exchange::IPackager::INSTALLING) {
+                    self->_inProgress->Install->SetState(Exchange::IPackager::INSTALLING);
                     stateChanged = true;
                 }
                 break;
@@ -278,10 +470,10 @@ namespace Plugin {
         if (stateChanged == true)
             self->NotifyStateChange();
         if (progress->percentage == 100) {
-            self->_inProgress.Install->SetState(Exchange::IPackager::INSTALLED);
+            self->_inProgress->Install->SetState(Exchange::IPackager::INSTALLED);
             self->NotifyStateChange();
-            self->_inProgress.Install->SetAppName(progress->pkg->local_filename);
-            string mfilename = self->GetMetadataFile(self->_inProgress.Install->AppName());
+            self->_inProgress->Install->SetAppName(progress->pkg->local_filename);
+            string mfilename = self->GetMetadataFile(self->_inProgress->Install->AppName());
             string callsign = self->GetCallsign(mfilename);
             if(!callsign.empty()) {
                 self->DeactivatePlugin(callsign);
@@ -363,11 +555,17 @@ namespace Plugin {
     }
 
     void PackagerImplementation::NotifyStateChange()
+    {
+        ASSERT(_inProgress != nullptr);
+        NotifyStateChange(*_inProgress);
+    }
+
+    void PackagerImplementation::NotifyStateChange(const InstallationData& item)
     {
         _adminLock.Lock();
-        TRACE_L1("State for %s changed to %d (%d %%, %d)", _inProgress.Package->Name().c_str(), _inProgress.Install->State(), _inProgress.Install->Progress(), _inProgress.Install->ErrorCode());
+        TRACE_L1("State for %s changed to %d (%d %%, %d)", item.Package->Name().c_str(), item.Install->State(), item.Install->Progress(), item.Install->ErrorCode());
         for (auto* notification : _notifications) {
-            notification->StateChange(_inProgress.Package, _inProgress.Install);
+            notification->StateChange(item.Package, item.Install);
         }
         _adminLock.Unlock();
     }
@@ -382,6 +580,18 @@ namespace Plugin {
         _adminLock.Unlock();
     }
 
+    bool PackagerImplementation::ReinitOPKG()
+    {
+        // OPKG bug: it marks it checked dependency for a package as cyclic dependency handling fix
+        // but since in our case it's not an process which dies when done, this info survives and makes the
+        // deps check to be skipped on subsequent calls. This is why hash_deinit() is called below
+        // and needs to be initialized here agian.
+        if (_opkgInitialized == true)  // it was initialized
+            FreeOPKG();
+        _opkgInitialized = InitOPKG();
+        return _opkgInitialized;
+    }
+
     bool PackagerImplementation::InitOPKG()
     {
         UpdateConfig();
@@ -20,9 +20,11 @@
 #pragma once
 
 #include "Module.h"
+#include "DownloadQueue.h"
 #include <interfaces/IPackager.h>
 
 #include <list>
+#include <memory>
 #include <string>
 
 // Forward declarations so we do not need to include the OPKG headers here.
@@ -48,6 +50,8 @@ namespace Plugin {
                 , NoDeps()
                 , NoSignatureCheck()
                 , AlwaysUpdateFirst()
+                , Downloads(3)                  // Packages downloaded at once
+                , CacheSize(50)                 // MB of downloaded packages kept, 0 for no limit
             {
                 Add(_T("config"), &ConfigFile);
                 Add(_T("temppath"), &TempDir);
@@ -57,6 +61,8 @@ namespace Plugin {
                 Add(_T("nodeps"), &NoDeps);
                 Add(_T("nosignaturecheck"), &NoSignatureCheck);
                 Add(_T("alwaysupdatefirst"), &AlwaysUpdateFirst);
+                Add(_T("downloads"), &Downloads);
+                Add(_T("cachesize"), &CacheSize);
             }
 
             ~Config() override
@@ -74,6 +80,8 @@ namespace Plugin {
             Core::JSON::Boolean NoDeps;
             Core::JSON::Boolean NoSignatureCheck;
             Core::JSON::Boolean AlwaysUpdateFirst;
+            Core::JSON::DecUInt8 Downloads;
+            Core::JSON::DecUInt32 CacheSize;
         };
 
         PackagerImplementation()
@@ -87,10 +95,14 @@ namespace Plugin {
             , _alwaysUpdateFirst(false)
             , _volatileCache(false)
             , _opkgInitialized(false)
+            , _downloadThreads(3)
+            , _cacheSize(50)
+            , _nextId(1)
+            , _servicePI(nullptr)
+            , _inProgress(nullptr)
             , _worker(this)
             , _isUpgrade(false)
             , _isSyncing(false)
-            , _servicePI(nullptr)
         {
         }
 
@@ -225,6 +237,13 @@ namespace Plugin {
             string _appname;
         };
 
+        enum class Step {
+            QUEUED,         // Waiting for its package to be looked up in the feeds
+            DOWNLOADING,    // Being downloaded into the content cache
+            DOWNLOADED,     // Waiting to be installed, from the cache or by opkg itself
+            DONE            // Failed, to be removed from the queue
+        };
+
         struct InstallationData {
             InstallationData(const InstallationData& other) = delete;
             InstallationData& operator=(const InstallationData& other) = delete;
@@ -239,6 +258,10 @@ namespace Plugin {
             }
             PackageInfo* Package = nullptr;
             InstallInfo* Install = nullptr;
+            uint32_t Id = 0;
+            Step Current = Step::QUEUED;
+            string FileName;    // Of the package in the feed
+            string LocalFile;   // The package in the content cache, empty to have opkg download it
         };
 
         class InstallThread : public Core::Thread {
@@ -251,28 +274,9 @@ namespace Plugin {
             InstallThread(const InstallThread&) = delete;
 
             uint32_t Worker() override {
+                // Blocks the thread once there is nothing left to do
                 while(IsRunning() == true) {
-                    _parent->_adminLock.Lock(); // The parent may have lock when this starts so wait for it to release.
-                    bool isInstall = _parent->_inProgress.Install != nullptr;
-                    ASSERT(isInstall != true || _parent->_inProgress.Package != nullptr);
-                    _parent->_adminLock.Unlock();
-
-                    // After this point locking is not needed because API running on other threads only read if in
-                    // progress is filled in.
-                    _parent->BlockingSetupLocalRepoNoLock(isInstall == true ? RepoSyncMode::SETUP : RepoSyncMode::FORCED);
-                    if (isInstall)
-                        _parent->BlockingInstallUntilCompletionNoLock();
-
-                    if (isInstall) {
-                        _parent->_adminLock.Lock();
-                        _parent->_inProgress.Install->Release();
-                        _parent->_inProgress.Package->Release();
-                        _parent->_inProgress.Install = nullptr;
-                        _parent->_inProgress.Package = nullptr;
-                        _parent->_adminLock.Unlock();
-                    }
-
-                    Block();
+                    _parent->ProcessQueue();
                 }
 
                 return Core::infinite;
@@ -296,9 +300,17 @@ namespace Plugin {
         string GetCallsign(const string& mfilename);
         void DeactivatePlugin(const string& callsign);
         void NotifyStateChange();
+        void NotifyStateChange(const InstallationData& item);
         void NotifyRepoSynced(uint32_t status);
+        void ProcessQueue();
+        void BlockingResolveNoLock(const std::vector<InstallationData*>& queued);
+        bool ResolveNoLock(const string& name, DownloadQueue::Request& request, string& fileName) const;
         void BlockingInstallUntilCompletionNoLock();
         void BlockingSetupLocalRepoNoLock(RepoSyncMode mode);
+        InstallationData* Find(uint32_t id);
+        void DownloadProgress(uint32_t id, uint8_t percent);
+        void DownloadCompleted(uint32_t id, const string& path);
+        bool ReinitOPKG();
         bool InitOPKG();
         void FreeOPKG();
 
@@ -312,9 +324,14 @@ namespace Plugin {
         bool _alwaysUpdateFirst;
         bool _volatileCache;
         bool _opkgInitialized;
+        uint8_t _downloadThreads;
+        uint32_t _cacheSize;
+        uint32_t _nextId;
         PluginHost::IShell* _servicePI;
         std::vector<Exchange::IPackager::INotification*> _notifications;
-        InstallationData _inProgress;
+        std::list<InstallationData> _queue;     // In the order Install() was called
+        InstallationData* _inProgress;          // The one being installed, in the queue
+        std::unique_ptr<DownloadQueue> _downloads;
         InstallThread _worker;
         bool _isUpgrade;
         bool _isSyncing;
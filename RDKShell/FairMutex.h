@@ -0,0 +1,138 @@
+/**
+* If not stated otherwise in this file or this component's LICENSE
+* file the following copyright and licenses apply:
+*
+* Copyright 2020 RDK Management
+*
+* Licensed under the Apache License, Version 2.0 (the "License");
+* you may not use this file except in compliance with the License.
+* You may obtain a copy of the License at
+*
+* http://www.apache.org/licenses/LICENSE-2.0
+*
+* Unless required by applicable law or agreed to in writing, software
+* distributed under the License is distributed on an "AS IS" BASIS,
+* WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+* See the License for the specific language governing permissions and
+* limitations under the License.
+**/
+
+#pragma once
+
+#include <chrono>
+#include <condition_variable>
+#include <deque>
+#include <mutex>
+
+namespace WPEFramework {
+
+    namespace Plugin {
+
+        /* Mutex handed over in arrival order. Waiters sleep on their own
+         * condition and unlock passes ownership straight to the oldest one,
+         * so a thread that relocks right away, like the render loop between
+         * frames, cannot starve the others and nobody spins for the lock.
+         * Meets the TimedLockable requirements. */
+        class FairMutex
+        {
+        public:
+            FairMutex()
+                : mLocked(false)
+            {
+            }
+
+            FairMutex(const FairMutex&) = delete;
+            FairMutex& operator=(const FairMutex&) = delete;
+
+            void lock()
+            {
+                std::unique_lock<std::mutex> guard(mMutex);
+                if (!mLocked)
+                {
+                    mLocked = true;
+                    return;
+                }
+                Waiter waiter;
+                mWaiters.push_back(&waiter);
+                waiter.condition.wait(guard, [&waiter] () { return waiter.granted; });
+            }
+
+            bool try_lock()
+            {
+                std::lock_guard<std::mutex> guard(mMutex);
+                if (mLocked)
+                {
+                    return false;
+                }
+                mLocked = true;
+                return true;
+            }
+
+            /* Waits in line for up to timeout; a waiter that gives up leaves
+             * the line without affecting the order of the others. */
+            template <typename Rep, typename Period>
+            bool try_lock_for(const std::chrono::duration<Rep, Period>& timeout)
+            {
+                return try_lock_until(std::chrono::steady_clock::now() + timeout);
+            }
+
+            template <typename Clock, typename Duration>
+            bool try_lock_until(const std::chrono::time_point<Clock, Duration>& deadline)
+            {
+                std::unique_lock<std::mutex> guard(mMutex);
+                if (!mLocked)
+                {
+                    mLocked = true;
+                    return true;
+                }
+                Waiter waiter;
+                mWaiters.push_back(&waiter);
+                if (!waiter.condition.wait_until(guard, deadline, [&waiter] () { return waiter.granted; }))
+                {
+                    for (auto it = mWaiters.begin(); it != mWaiters.end(); ++it)
+                    {
+                        if (*it == &waiter)
+                        {
+                            mWaiters.erase(it);
+                            break;
+                        }
+                    }
+                    return false;
+                }
+                return true;
+            }
+
+            void unlock()
+            {
+                std::lock_guard<std::mutex> guard(mMutex);
+                if (mWaiters.empty())
+                {
+                    mLocked = false;
+                    return;
+                }
+                // stays locked, now on behalf of the oldest waiter
+                Waiter* next = mWaiters.front();
+                mWaiters.pop_front();
+                next->granted = true;
+                next->condition.notify_one();
+            }
+
+        private:
+            struct Waiter
+            {
+                Waiter()
+                    : granted(false)
+                {
+                }
+
+                std::condition_variable condition;
+                bool granted;
+            };
+
+            std::mutex mMutex;
+            bool mLocked;
+            std::deque<Waiter*> mWaiters;
+        };
+
+    } // namespace Plugin
+} // namespace WPEFramework
@@ -0,0 +1,350 @@
+/**
+* If not stated otherwise in this file or this component's LICENSE
+* file the following copyright and licenses apply:
+*
+* Copyright 2020 RDK Management
+*
+* Licensed under the Apache License, Version 2.0 (the "License");
+* you may not use this file except in compliance with the License.
+* You may obtain a copy of the License at
+*
+* http://www.apache.org/licenses/LICENSE-2.0
+*
+* Unless required by applicable law or agreed to in writing, software
+* distributed under the License is distributed on an "AS IS" BASIS,
+* WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+* See the License for the specific language governing permissions and
+* limitations under the License.
+**/
+
+#pragma once
+
+#include <stdint.h>
+#include <atomic>
+#include <chrono>
+#include <functional>
+#include <mutex>
+#include <ostream>
+#include <string>
+#include <thread>
+#include <vector>
+
+namespace WPEFramework {
+
+    namespace Plugin {
+
+        /* Latency distribution in power of two millisecond buckets: bucket 0
+         * holds samples under 1 ms, bucket i samples in [2^(i-1), 2^i) ms and
+         * the last bucket everything above. */
+        struct LatencyHistogram
+        {
+            static const int BUCKETS = 20;
+
+            LatencyHistogram()
+            {
+                reset();
+            }
+
+            void reset()
+            {
+                count = 0;
+                sumUs = 0;
+                minUs = 0;
+                maxUs = 0;
+                for (int i = 0; i < BUCKETS; i++)
+                {
+                    buckets[i] = 0;
+                }
+            }
+
+            static int bucketOf(uint64_t us)
+            {
+                uint64_t ms = us / 1000;
+                int bucket = 0;
+                while (ms > 0 && bucket < BUCKETS - 1)
+                {
+                    ms >>= 1;
+                    bucket++;
+                }
+                return bucket;
+            }
+
+            void record(uint64_t us)
+            {
+                if (count == 0 || us < minUs)
+                {
+                    minUs = us;
+                }
+                if (us > maxUs)
+                {
+                    maxUs = us;
+                }
+                count++;
+                sumUs += us;
+                buckets[bucketOf(us)]++;
+            }
+
+            /* Upper bound of the bucket holding the given percentile, clamped
+             * to the largest sample */
+            uint64_t percentileUs(double percentile) const
+            {
+                if (count == 0)
+                {
+                    return 0;
+                }
+                uint64_t rank = (uint64_t)(percentile / 100.0 * count + 0.5);
+                if (rank < 1)
+                {
+                    rank = 1;
+                }
+                uint64_t seen = 0;
+                for (int i = 0; i < BUCKETS; i++)
+                {
+                    seen += buckets[i];
+                    if (seen >= rank)
+                    {
+                        uint64_t upperUs = (uint64_t(1) << i) * 1000;
+                        return (i == BUCKETS - 1 || upperUs > maxUs) ? maxUs : upperUs;
+                    }
+                }
+                return maxUs;
+            }
+
+            uint32_t count;
+            uint64_t sumUs;
+            uint64_t minUs;
+            uint64_t maxUs;
+            uint32_t buckets[BUCKETS];
+        };
+
+        /* Durations of the phases of launch, suspend, resume and destroy,
+         * kept as one histogram per application type and phase in memory
+         * allocated up front. Optionally the last phases are also kept in a
+         * ring that can be written out in the Chrome trace event format.
+         * Nothing is measured while disabled, the callers only test a flag. */
+        class LaunchMetrics
+        {
+        public:
+            enum Phase
+            {
+                LOCK,
+                LOOKUP,
+                CLONE,
+                CREATE_DISPLAY,
+                CONFIGURE,
+                ACTIVATE,
+                BOUNDS,
+                STATE,
+                URL,
+                FIRST_FRAME,
+                LAUNCH,
+                SUSPEND,
+                RESUME,
+                DESTROY,
+                PHASE_COUNT
+            };
+
+            /* Types beyond this are counted together as "other" */
+            static const int MAX_TYPES = 16;
+
+            struct TypeMetrics
+            {
+                std::string type;
+                LatencyHistogram phases[PHASE_COUNT];
+            };
+
+            LaunchMetrics()
+                : mEnabled(false)
+                , mTypeCount(0)
+                , mTraceNext(0)
+                , mTraceSize(0)
+            {
+            }
+
+            LaunchMetrics(const LaunchMetrics&) = delete;
+            LaunchMetrics& operator=(const LaunchMetrics&) = delete;
+
+            static const char* phaseName(Phase phase)
+            {
+                static const char* const names[PHASE_COUNT] = {
+                    "lock", "lookup", "clone", "createDisplay", "configure", "activate", "bounds",
+                    "state", "url", "firstFrame", "launch", "suspend", "resume", "destroy"
+                };
+                return (phase < PHASE_COUNT) ? names[phase] : "unknown";
+            }
+
+            /* Monotonic time in microseconds */
+            static uint64_t now()
+            {
+                return std::chrono::duration_cast<std::chrono::microseconds>(
+                    std::chrono::steady_clock::now().time_since_epoch()).count();
+            }
+
+            bool enabled() const
+            {
+                return mEnabled.load(std::memory_order_relaxed);
+            }
+
+            void enable(bool enable)
+            {
+                mEnabled.store(enable, std::memory_order_relaxed);
+            }
+
+            /* Keeps the last capacity phases for writeChromeTrace, 0 disables */
+            void enableTrace(size_t capacity)
+            {
+                std::lock_guard<std::mutex> lock(mMutex);
+                mTrace.assign(capacity, TraceEvent());
+                mTraceNext = 0;
+                mTraceSize = 0;
+            }
+
+            bool traceEnabled()
+            {
+                std::lock_guard<std::mutex> lock(mMutex);
+                return !mTrace.empty();
+            }
+
+            void record(const std::string& type, Phase phase, uint64_t startUs, uint64_t endUs, const std::string& callsign)
+            {
+                if (!enabled() || phase >= PHASE_COUNT)
+                {
+                    return;
+                }
+                uint64_t durationUs = (endUs > startUs) ? (endUs - startUs) : 0;
+
+                std::lock_guard<std::mutex> lock(mMutex);
+                int index = typeIndex(type);
+                mTypes[index].phases[phase].record(durationUs);
+
+                if (!mTrace.empty())
+                {
+                    TraceEvent& event = mTrace[mTraceNext];
+                    event.phase = phase;
+                    event.type = index;
+                    event.callsign = callsign;
+                    event.startUs = startUs;
+                    event.durationUs = durationUs;
+                    event.thread = std::hash<std::thread::id>()(std::this_thread::get_id()) & 0xffff;
+                    mTraceNext = (mTraceNext + 1) % mTrace.size();
+                    if (mTraceSize < mTrace.size())
+                    {
+                        mTraceSize++;
+                    }
+                }
+            }
+
+            void reset()
+            {
+                std::lock_guard<std::mutex> lock(mMutex);
+                for (int i = 0; i < mTypeCount; i++)
+                {
+                    for (int phase = 0; phase < PHASE_COUNT; phase++)
+                    {
+                        mTypes[i].phases[phase].reset();
+                    }
+                }
+                mTraceNext = 0;
+                mTraceSize = 0;
+            }
+
+            std::vector<TypeMetrics> snapshot()
+            {
+                std::lock_guard<std::mutex> lock(mMutex);
+                return std::vector<TypeMetrics>(mTypes, mTypes + mTypeCount);
+            }
+
+            /* Writes the traced phases, oldest first, as complete ("X") events */
+            void writeChromeTrace(std::ostream& out)
+            {
+                std::lock_guard<std::mutex> lock(mMutex);
+                out << "{\"displayTimeUnit\":\"ms\",\"traceEvents\":[";
+                size_t first = (mTraceSize < mTrace.size()) ? 0 : mTraceNext;
+                for (size_t i = 0; i < mTraceSize; i++)
+                {
+                    const TraceEvent& event = mTrace[(first + i) % mTrace.size()];
+                    if (i > 0)
+                    {
+                        out << ",";
+                    }
+                    out << "{\"name\":\"" << phaseName(event.phase) << "\",\"cat\":\"";
+                    writeEscaped(out, mTypes[event.type].type);
+                    out << "\",\"ph\":\"X\",\"ts\":" << event.startUs << ",\"dur\":" << event.durationUs
+                        << ",\"pid\":1,\"tid\":" << event.thread << ",\"args\":{\"callsign\":\"";
+                    writeEscaped(out, event.callsign);
+                    out << "\"}}";
+                }
+                out << "]}";
+            }
+
+        private:
+            struct TraceEvent
+            {
+                TraceEvent()
+                    : phase(LOCK), type(0), startUs(0), durationUs(0), thread(0)
+                {
+                }
+
+                Phase phase;
+                int type;
+                std::string callsign;
+                uint64_t startUs;
+                uint64_t durationUs;
+                uint32_t thread;
+            };
+
+            int typeIndex(const std::string& type)
+            {
+                const std::string& name = type.empty() ? unknownType() : type;
+                for (int i = 0; i < mTypeCount; i++)
+                {
+                    if (mTypes[i].type == name)
+                    {
+                        return i;
+                    }
+                }
+                if (mTypeCount < MAX_TYPES - 1)
+                {
+                    mTypes[mTypeCount].type = name;
+                    return mTypeCount++;
+                }
+                if (mTypeCount == MAX_TYPES - 1)
+                {
+                    mTypes[mTypeCount].type = "other";
+                    mTypeCount++;
+                }
+                return MAX_TYPES - 1;
+            }
+
+            static const std::string& unknownType()
+            {
+                static const std::string name("unknown");
+                return name;
+            }
+
+            static void writeEscaped(std::ostream& out, const std::string& value)
+            {
+                for (char c : value)
+                {
+                    if (c == '"' || c == '\\')
+                    {
+                        out << '\\' << c;
+                    }
+                    else if ((unsigned char)c >= 0x20)
+                    {
+                        out << c;
+                    }
+                }
+            }
+
+            std::atomic<bool> mEnabled;
+            std::mutex mMutex;
+            TypeMetrics mTypes[MAX_TYPES];
+            int mTypeCount;
+            std::vector<TraceEvent> mTrace;
+            size_t mTraceNext;
+            size_t mTraceSize;
+        };
+
+    } // namespace Plugin
+} // namespace WPEFramework
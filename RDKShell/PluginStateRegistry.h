@@ -0,0 +1,204 @@
+/**
+* If not stated otherwise in this file or this component's LICENSE
+* file the following copyright and licenses apply:
+*
+* Copyright 2020 RDK Management
+*
+* Licensed under the Apache License, Version 2.0 (the "License");
+* you may not use this file except in compliance with the License.
+* You may obtain a copy of the License at
+*
+* http://www.apache.org/licenses/LICENSE-2.0
+*
+* Unless required by applicable law or agreed to in writing, software
+* distributed under the License is distributed on an "AS IS" BASIS,
+* WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+* See the License for the specific language governing permissions and
+* limitations under the License.
+**/
+
+#pragma once
+
+#include <stdint.h>
+#include <functional>
+#include <mutex>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+namespace WPEFramework {
+
+    namespace Plugin {
+
+        /* State and config of every plugin known to the framework, keyed by
+         * callsign. It is filled from one Controller "status" call and then
+         * kept current by the plugin state change notifications, so a lookup
+         * does not need a round trip to the Controller. */
+        class PluginStateRegistry
+        {
+        public:
+            enum State
+            {
+                UNKNOWN,
+                DEACTIVATED,
+                DEACTIVATION,
+                ACTIVATION,
+                ACTIVATED,
+                PRECONDITION
+            };
+
+            struct Entry
+            {
+                std::string callsign;
+                State state;
+                std::string className;
+                /* Empty for plugins that do not create a display */
+                std::string clientIdentifier;
+            };
+
+            typedef std::function<bool(std::vector<Entry>&)> Loader;
+
+            explicit PluginStateRegistry(const Loader& loader)
+                : mLoader(loader)
+                , mLoaded(false)
+                , mSequence(0)
+            {
+            }
+
+            PluginStateRegistry(const PluginStateRegistry&) = delete;
+            PluginStateRegistry& operator=(const PluginStateRegistry&) = delete;
+
+            /* Plugins counted as running by getState and friends */
+            static bool isRunning(State state)
+            {
+                return (state != UNKNOWN) && (state != DEACTIVATED) && (state != DEACTIVATION) && (state != PRECONDITION);
+            }
+
+            /* Replaces the registry content with a fresh Controller status.
+             * Entries changed by a notification while the status was being
+             * fetched are newer than the status and are kept. */
+            bool refresh()
+            {
+                uint64_t sequence;
+                {
+                    std::lock_guard<std::mutex> lock(mMutex);
+                    sequence = mSequence;
+                }
+
+                // The loader does a JSON-RPC call, do not hold the lock meanwhile.
+                std::vector<Entry> entries;
+                if (!mLoader || !mLoader(entries))
+                {
+                    return false;
+                }
+
+                std::lock_guard<std::mutex> lock(mMutex);
+                for (auto& entry : entries)
+                {
+                    if (entry.state == UNKNOWN)
+                    {
+                        continue;
+                    }
+                    auto it = mEntries.find(entry.callsign);
+                    if (it == mEntries.end())
+                    {
+                        Record record;
+                        record.entry = std::move(entry);
+                        record.sequence = 0;
+                        mEntries.emplace(record.entry.callsign, std::move(record));
+                    }
+                    else if (it->second.sequence <= sequence)
+                    {
+                        it->second.entry = std::move(entry);
+                    }
+                }
+                mLoaded = true;
+                return true;
+            }
+
+            void update(const std::string& callsign, State state, const std::string& className, const std::string& clientIdentifier)
+            {
+                std::lock_guard<std::mutex> lock(mMutex);
+                Record& record = mEntries[callsign];
+                record.entry.callsign = callsign;
+                record.entry.state = state;
+                record.entry.className = className;
+                record.entry.clientIdentifier = clientIdentifier;
+                record.sequence = ++mSequence;
+            }
+
+            /* The plugin was destroyed. The entry stays as a tombstone so an
+             * older status fetched by a concurrent refresh does not bring it
+             * back. */
+            void remove(const std::string& callsign)
+            {
+                update(callsign, UNKNOWN, "", "");
+            }
+
+            bool find(const std::string& callsign, Entry& entry)
+            {
+                ensureLoaded();
+                std::lock_guard<std::mutex> lock(mMutex);
+                auto it = mEntries.find(callsign);
+                if (it == mEntries.end() || it->second.entry.state == UNKNOWN)
+                {
+                    return false;
+                }
+                entry = it->second.entry;
+                return true;
+            }
+
+            bool contains(const std::string& callsign)
+            {
+                Entry entry;
+                return find(callsign, entry);
+            }
+
+            std::vector<Entry> snapshot()
+            {
+                ensureLoaded();
+                std::vector<Entry> entries;
+                std::lock_guard<std::mutex> lock(mMutex);
+                entries.reserve(mEntries.size());
+                for (const auto& it : mEntries)
+                {
+                    if (it.second.entry.state != UNKNOWN)
+                    {
+                        entries.push_back(it.second.entry);
+                    }
+                }
+                return entries;
+            }
+
+            bool isLoaded()
+            {
+                std::lock_guard<std::mutex> lock(mMutex);
+                return mLoaded;
+            }
+
+        private:
+            struct Record
+            {
+                Entry entry;
+                uint64_t sequence;
+            };
+
+            /* The first lookup loads the Controller status; a failed load is
+             * retried by the next lookup. */
+            void ensureLoaded()
+            {
+                if (!isLoaded())
+                {
+                    refresh();
+                }
+            }
+
+            std::mutex mMutex;
+            Loader mLoader;
+            bool mLoaded;
+            uint64_t mSequence;
+            std::unordered_map<std::string, Record> mEntries;
+        };
+
+    } // namespace Plugin
+} // namespace WPEFramework
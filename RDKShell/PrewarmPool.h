@@ -0,0 +1,273 @@
+/**
+* If not stated otherwise in this file or this component's LICENSE
+* file the following copyright and licenses apply:
+*
+* Copyright 2020 RDK Management
+*
+* Licensed under the Apache License, Version 2.0 (the "License");
+* you may not use this file except in compliance with the License.
+* You may obtain a copy of the License at
+*
+* http://www.apache.org/licenses/LICENSE-2.0
+*
+* Unless required by applicable law or agreed to in writing, software
+* distributed under the License is distributed on an "AS IS" BASIS,
+* WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+* See the License for the specific language governing permissions and
+* limitations under the License.
+**/
+
+#pragma once
+
+#include <stdint.h>
+#include <chrono>
+#include <condition_variable>
+#include <mutex>
+#include <string>
+#include <vector>
+
+namespace WPEFramework {
+
+    namespace Plugin {
+
+        /* Application slots kept cloned, activated and suspended, with their
+         * display already created, so a launch of the slot callsign only has
+         * to resume the instance and point it to its url. A worker thread
+         * warms the slots; a slot whose plugin is deactivated, e.g. after the
+         * claimed application was destroyed, is warmed again after a delay. */
+        class PrewarmPool
+        {
+        public:
+            typedef std::chrono::steady_clock Clock;
+
+            enum State
+            {
+                IDLE,
+                WARMING,
+                WARM,
+                CLAIMED,
+                EVICTING
+            };
+
+            /* Warming is given up after this many failures in a row */
+            static const uint32_t MAX_ATTEMPTS = 3;
+
+            explicit PrewarmPool(uint32_t rewarmDelayMs)
+                : mRewarmDelayMs(rewarmDelayMs)
+                , mStopped(false)
+            {
+            }
+
+            PrewarmPool(const PrewarmPool&) = delete;
+            PrewarmPool& operator=(const PrewarmPool&) = delete;
+
+            void add(const std::string& callsign, const std::string& type, uint32_t delayMs = 0)
+            {
+                std::lock_guard<std::mutex> lock(mMutex);
+                if (findSlot(callsign) == nullptr)
+                {
+                    Slot slot;
+                    slot.callsign = callsign;
+                    slot.type = type;
+                    slot.state = IDLE;
+                    slot.readyAt = Clock::now() + std::chrono::milliseconds(delayMs);
+                    slot.failures = 0;
+                    mSlots.push_back(slot);
+                }
+                mCondition.notify_all();
+            }
+
+            void setRewarmDelay(uint32_t rewarmDelayMs)
+            {
+                std::lock_guard<std::mutex> lock(mMutex);
+                mRewarmDelayMs = rewarmDelayMs;
+            }
+
+            bool empty()
+            {
+                std::lock_guard<std::mutex> lock(mMutex);
+                return mSlots.empty();
+            }
+
+            /* Worker side: blocks until a slot is due for warming and marks
+             * it as warming. Returns false once the pool is stopped. */
+            bool nextToWarm(std::string& callsign, std::string& type)
+            {
+                std::unique_lock<std::mutex> lock(mMutex);
+                while (!mStopped)
+                {
+                    Clock::time_point now = Clock::now();
+                    Clock::time_point wakeup = Clock::time_point::max();
+                    for (auto& slot : mSlots)
+                    {
+                        if (slot.state != IDLE || slot.failures >= MAX_ATTEMPTS)
+                        {
+                            continue;
+                        }
+                        if (slot.readyAt <= now)
+                        {
+                            slot.state = WARMING;
+                            callsign = slot.callsign;
+                            type = slot.type;
+                            return true;
+                        }
+                        if (slot.readyAt < wakeup)
+                        {
+                            wakeup = slot.readyAt;
+                        }
+                    }
+                    if (wakeup == Clock::time_point::max())
+                    {
+                        mCondition.wait(lock);
+                    }
+                    else
+                    {
+                        mCondition.wait_until(lock, wakeup);
+                    }
+                }
+                return false;
+            }
+
+            void warmed(const std::string& callsign, bool success)
+            {
+                std::lock_guard<std::mutex> lock(mMutex);
+                Slot* slot = findSlot(callsign);
+                if (slot != nullptr && slot->state == WARMING)
+                {
+                    if (success)
+                    {
+                        slot->state = WARM;
+                        slot->failures = 0;
+                    }
+                    else
+                    {
+                        slot->state = IDLE;
+                        slot->failures++;
+                        slot->readyAt = Clock::now() + std::chrono::milliseconds(mRewarmDelayMs);
+                    }
+                }
+                mCondition.notify_all();
+            }
+
+            /* Launch side: takes the warm instance of callsign if there is
+             * one. A slot being warmed is waited for up to waitMs, so the
+             * launch does not race the worker activating the same plugin. */
+            bool claim(const std::string& callsign, const std::string& type, uint32_t waitMs)
+            {
+                std::unique_lock<std::mutex> lock(mMutex);
+                Slot* slot = findSlot(callsign);
+                if (slot == nullptr || (!type.empty() && type != slot->type))
+                {
+                    return false;
+                }
+                mCondition.wait_for(lock, std::chrono::milliseconds(waitMs), [this, &callsign] () {
+                    Slot* current = findSlot(callsign);
+                    return mStopped || current->state != WARMING;
+                });
+                slot = findSlot(callsign);
+                if (slot->state != WARM)
+                {
+                    return false;
+                }
+                slot->state = CLAIMED;
+                return true;
+            }
+
+            /* Launch side, for a launch configuring the instance differently:
+             * takes the warm instance of callsign out of the pool so the
+             * launch deactivates it first. The deactivation does not warm the
+             * slot again, the launch marks it claimed once done with evicted. */
+            bool evict(const std::string& callsign, uint32_t waitMs)
+            {
+                std::unique_lock<std::mutex> lock(mMutex);
+                if (findSlot(callsign) == nullptr)
+                {
+                    return false;
+                }
+                mCondition.wait_for(lock, std::chrono::milliseconds(waitMs), [this, &callsign] () {
+                    Slot* current = findSlot(callsign);
+                    return mStopped || current->state != WARMING;
+                });
+                Slot* slot = findSlot(callsign);
+                if (slot->state != WARM)
+                {
+                    return false;
+                }
+                slot->state = EVICTING;
+                return true;
+            }
+
+            void evicted(const std::string& callsign)
+            {
+                std::lock_guard<std::mutex> lock(mMutex);
+                Slot* slot = findSlot(callsign);
+                if (slot != nullptr && slot->state == EVICTING)
+                {
+                    slot->state = CLAIMED;
+                }
+            }
+
+            /* The slot plugin was deactivated; warm it again later */
+            void released(const std::string& callsign)
+            {
+                std::lock_guard<std::mutex> lock(mMutex);
+                Slot* slot = findSlot(callsign);
+                if (slot != nullptr && (slot->state == WARM || slot->state == CLAIMED))
+                {
+                    slot->state = IDLE;
+                    slot->readyAt = Clock::now() + std::chrono::milliseconds(mRewarmDelayMs);
+                    mCondition.notify_all();
+                }
+            }
+
+            State state(const std::string& callsign)
+            {
+                std::lock_guard<std::mutex> lock(mMutex);
+                Slot* slot = findSlot(callsign);
+                return (slot != nullptr) ? slot->state : IDLE;
+            }
+
+            void start()
+            {
+                std::lock_guard<std::mutex> lock(mMutex);
+                mStopped = false;
+            }
+
+            void stop()
+            {
+                std::lock_guard<std::mutex> lock(mMutex);
+                mStopped = true;
+                mCondition.notify_all();
+            }
+
+        private:
+            struct Slot
+            {
+                std::string callsign;
+                std::string type;
+                State state;
+                Clock::time_point readyAt;
+                uint32_t failures;
+            };
+
+            Slot* findSlot(const std::string& callsign)
+            {
+                for (auto& slot : mSlots)
+                {
+                    if (slot.callsign == callsign)
+                    {
+                        return &slot;
+                    }
+                }
+                return nullptr;
+            }
+
+            std::mutex mMutex;
+            std::condition_variable mCondition;
+            std::vector<Slot> mSlots;
+            uint32_t mRewarmDelayMs;
+            bool mStopped;
+        };
+
+    } // namespace Plugin
+} // namespace WPEFramework
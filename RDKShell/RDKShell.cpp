@@ -36,6 +36,11 @@
 #include <rdkshell/eastereggs.h>
 #include <rdkshell/linuxkeys.h>
 #include "base64.h"
+#include "UtilsJsonRpcDirectLink.h"
+#include "PluginStateRegistry.h"
+#include "PrewarmPool.h"
+#include "LaunchMetrics.h"
+#include "FairMutex.h"
 
 #ifdef RDKSHELL_READ_MAC_ON_STARTUP
 #include "FactoryProtectHal.h"
@@ -127,6 +132,7 @@ const string WPEFramework::Plugin::RDKShell::RDKSHELL_METHOD_GET_CURSOR_SIZE = "
 const string WPEFramework::Plugin::RDKShell::RDKSHELL_METHOD_SET_CURSOR_SIZE = "setCursorSize";
 const string WPEFramework::Plugin::RDKShell::RDKSHELL_METHOD_GET_FRAME_RATE = "getFrameRate";
 const string WPEFramework::Plugin::RDKShell::RDKSHELL_METHOD_SET_FRAME_RATE = "setFrameRate";
+const string WPEFramework::Plugin::RDKShell::RDKSHELL_METHOD_GET_LAUNCH_METRICS = "getLaunchMetrics";
 
 const string WPEFramework::Plugin::RDKShell::RDKSHELL_EVENT_ON_USER_INACTIVITY = "onUserInactivity";
 const string WPEFramework::Plugin::RDKShell::RDKSHELL_EVENT_ON_APP_LAUNCHED = "onApplicationLaunched";
@@ -180,7 +186,11 @@ bool needsScreenshot = false;
 #define RDKSHELL_POWER_TIME_WAIT 2.5
 #define THUNDER_ACCESS_DEFAULT_VALUE "127.0.0.1:9998"
 #define RDKSHELL_WILLDESTROY_EVENT_WAITTIME 1
-#define RDKSHELL_TRY_LOCK_WAIT_TIME_IN_MS 250
+#define RDKSHELL_LOCK_WAIT_WARNING_TIME_IN_MS 250
+#define RDKSHELL_PREWARM_START_DELAY_IN_MS 10000
+#define RDKSHELL_PREWARM_REWARM_DELAY_IN_MS 30000
+#define RDKSHELL_PREWARM_CLAIM_WAIT_TIME_IN_MS 5000
+#define RDKSHELL_LAUNCH_TRACE_CAPACITY 4096
 
 static std::string gThunderAccessValue = THUNDER_ACCESS_DEFAULT_VALUE;
 static uint32_t gWillDestroyEventWaitTime = RDKSHELL_WILLDESTROY_EVENT_WAITTIME;
@@ -224,115 +234,18 @@ namespace WPEFramework {
     namespace Plugin {
 
 
-        struct JSONRPCDirectLink
+        // calls into other plugins with the RDKShell security token
+        struct JSONRPCDirectLink : public Utils::JSONRPCDirectLink
         {
-        private:
-          uint32_t mId { 0 };
-          std::string mCallSign { };
-          PluginHost::IDispatcher * dispatcher_ {nullptr};
-
-          Core::ProxyType<Core::JSONRPC::Message> Message() const
-          {
-            return (Core::ProxyType<Core::JSONRPC::Message>(PluginHost::IFactories::Instance().JSONRPC()));
-          }
-
-          template <typename PARAMETERS>
-          bool ToMessage(PARAMETERS& parameters, Core::ProxyType<Core::JSONRPC::Message>& message) const
-          {
-            return ToMessage((Core::JSON::IElement*)(&parameters), message);
-          }
-          bool ToMessage(Core::JSON::IElement* parameters, Core::ProxyType<Core::JSONRPC::Message>& message) const
-          {
-            if (!parameters->IsSet())
-              return true;
-            string values;
-            if (!parameters->ToString(values))
-            {
-              std::cout << "Failed to convert params to string\n";
-              return false;
-            }
-            if (values.empty() != true)
-            {
-              message->Parameters = values;
-            }
-            return true;
-          }
-          template <typename RESPONSE>
-          bool FromMessage(RESPONSE& response, const Core::ProxyType<Core::JSONRPC::Message>& message, bool isResponseString=false) const
-          {
-            return FromMessage((Core::JSON::IElement*)(&response), message, isResponseString);
-          }
-          bool FromMessage(Core::JSON::IElement* response, const Core::ProxyType<Core::JSONRPC::Message>& message, bool isResponseString=false) const
-          {
-            Core::OptionalType<Core::JSON::Error> error;
-            if ( !isResponseString && !response->FromString(message->Result.Value(), error) )
-            {
-              std::cout << "Failed to parse response!!! Error: '" <<  error.Value().Message() << "'\n";
-              return false;
-            }
-            return true;
-          }
-
-        public:
           JSONRPCDirectLink(PluginHost::IShell* service, std::string callsign)
-            : mCallSign(callsign)
+            : Utils::JSONRPCDirectLink(service, callsign, sThunderSecurityToken)
           {
-            if (service)
-              dispatcher_ = service->QueryInterfaceByCallsign<PluginHost::IDispatcher>(mCallSign);
           }
-      
+
           JSONRPCDirectLink(PluginHost::IShell* service)
             : JSONRPCDirectLink(service, "Controller")
           {
           }
-          ~JSONRPCDirectLink()
-          {
-            if (dispatcher_)
-              dispatcher_->Release();
-          }
-
-          template <typename PARAMETERS>
-          uint32_t Get(const uint32_t waitTime, const string& method, PARAMETERS& respObject)
-          {
-            JsonObject empty;
-            return Invoke(waitTime, method, empty, respObject);
-          }
-
-          template <typename PARAMETERS>
-          uint32_t Set(const uint32_t waitTime, const string& method, const PARAMETERS& sendObject)
-          {
-            JsonObject empty;
-            return Invoke(waitTime, method, sendObject, empty);
-          }
-
-          template <typename PARAMETERS, typename RESPONSE>
-          uint32_t Invoke(const uint32_t waitTime, const string& method, const PARAMETERS& parameters, RESPONSE& response, bool isResponseString=false)
-          {
-            if (dispatcher_ == nullptr) {
-              std::cout << "No JSON RPC dispatcher for " << mCallSign << '\n';
-              return Core::ERROR_GENERAL;
-            }
-
-            auto message = Message();
-
-            message->JSONRPC = Core::JSONRPC::Message::DefaultVersion;
-            message->Id = Core::JSON::DecUInt32(++mId);
-            message->Designator = Core::JSON::String(mCallSign + ".1." + method);
-
-            ToMessage(parameters, message);
-
-            const uint32_t channelId = ~0;
-            auto resp =  dispatcher_->Invoke(sThunderSecurityToken, channelId, *message);
-            if (resp->Error.IsSet()) {
-              std::cout << "Call failed: " << message->Designator.Value() << " error: " <<  resp->Error.Text.Value() << "\n";
-              return resp->Error.Code;
-            }
-
-            if (!FromMessage(response, resp, isResponseString))
-              return Core::ERROR_GENERAL;
-
-            return Core::ERROR_NONE;
-          }
         };
 
         class StateControlNotification: public PluginHost::IStateControl::INotification
@@ -414,7 +327,7 @@ namespace WPEFramework {
         SERVICE_REGISTRATION(RDKShell, 1, 0);
 
         RDKShell* RDKShell::_instance = nullptr;
-        std::mutex gRdkShellMutex;
+        FairMutex gRdkShellMutex;
         std::mutex gPluginDataMutex;
         std::mutex gLaunchDestroyMutex;
         std::mutex gDestroyMutex;
@@ -425,6 +338,12 @@ namespace WPEFramework {
 
         static std::thread shellThread;
 
+        static PrewarmPool gPrewarmPool(RDKSHELL_PREWARM_REWARM_DELAY_IN_MS);
+        static std::thread gPrewarmThread;
+
+        static LaunchMetrics gLaunchMetrics;
+        static std::string gLaunchTraceFile;
+
         struct CreateDisplayRequest
         {
             CreateDisplayRequest(std::string client, std::string displayName, uint32_t displayWidth=0, uint32_t displayHeight=0, bool virtualDisplayEnabled=false, uint32_t virtualWidth=0, uint32_t virtualHeight=0, bool topmost = false, bool focus = false): mClient(client), mDisplayName(displayName), mDisplayWidth(displayWidth), mDisplayHeight(displayHeight), mVirtualDisplayEnabled(virtualDisplayEnabled), mVirtualWidth(virtualWidth),mVirtualHeight(virtualHeight), mTopmost(topmost), mFocus(focus), mResult(false) , mAutoDestroy(true)
@@ -519,21 +438,13 @@ namespace WPEFramework {
 
         void lockRdkShellMutex()
         {
-            bool lockAcquired = false;
             double startTime = RdkShell::milliseconds();
-            while (!lockAcquired && (RdkShell::milliseconds() - startTime) < RDKSHELL_TRY_LOCK_WAIT_TIME_IN_MS)
+            gRdkShellMutex.lock();
+            double waitTime = RdkShell::milliseconds() - startTime;
+            if (waitTime >= RDKSHELL_LOCK_WAIT_WARNING_TIME_IN_MS)
             {
-                lockAcquired = gRdkShellMutex.try_lock();
+                std::cout << "waited " << waitTime << " ms for lock\n";
             }
-            if (!lockAcquired)
-            {
-                std::cout << "unable to get lock for defaulting to normal lock\n";
-                gRdkShellMutex.lock();
-            }
-            /*else
-            {
-                std::cout << "lock was acquired via try\n";
-            }*/
         }
 
         static bool isClientExists(std::string client)
@@ -566,43 +477,447 @@ namespace WPEFramework {
             return exist;
         }
        
+        static std::string defaultDisplayName(const std::string& callsign, const std::string& type)
+        {
+            if (gRdkShellSurfaceModeEnabled)
+            {
+                return "rdkshell_display";
+            }
+
+            // Ensure cloned plugin displays are in a sub-dir based on
+            // plugin classname
+            if (type.empty())
+            {
+                return "wst-" + callsign;
+            }
+
+            string xdgDir;
+            Core::SystemInfo::GetEnvironment(_T("XDG_RUNTIME_DIR"), xdgDir);
+            string displaySubdir = xdgDir + "/" + type;
+            Core::Directory(displaySubdir.c_str()).CreatePath();
+
+            // don't add XDG_RUNTIME_DIR to display name
+            return type + "/" + "wst-" + callsign;
+        }
+
+        // The configuration a launch puts on top of the one of the plugin: the overrides passed, the
+        // client identifier and what the type needs at launch (Netflix and Cobalt suspend settings, the
+        // Dobby/out-of-process RFCs). Applied by both launch and prewarmApplication, so that a prewarmed
+        // instance runs with the configuration a launch would have given it.
+        static void applyLaunchConfiguration(JsonObject& configSet, const string& type, const string& configuration, const string& displayName, bool suspend)
+        {
+            if (!configuration.empty())
+            {
+                JsonObject configurationOverrides;
+                configurationOverrides.FromString(configuration);
+                JsonObject::Iterator configurationIterator = configurationOverrides.Variants();
+                while (configurationIterator.Next())
+                {
+                    configSet[configurationIterator.Label()] = configurationIterator.Current();
+                }
+            }
+            configSet["clientidentifier"] = displayName;
+            if (!type.empty() && type == "Netflix")
+            {
+                std::cout << "setting launchtosuspend for Netflix: " << suspend << std::endl;
+                configSet["launchtosuspend"] = suspend;
+
+#ifdef RFC_ENABLED
+                RFC_ParamData_t param;
+                if (Utils::getRFCConfig("Device.DeviceInfo.X_RDKCENTRAL-COM_RFC.Feature.Dobby.Netflix.Enable", param))
+                {
+                    JsonObject root;
+                    if (strncasecmp(param.value, "true", 4) == 0)
+                    {
+                        std::cout << "dobby rfc true - launching netflix in container mode " << std::endl;
+                        root = configSet["root"].Object();
+                        root["mode"] = JsonValue("Container");
+                    }
+                    else
+                    {
+                        std::cout << "dobby rfc false - launching netflix in local mode " << std::endl;
+                        root = configSet["root"].Object();
+                        root["mode"] = JsonValue("Local");
+                    }
+                    configSet["root"] = root;
+                }
+                else
+                {
+                    std::cout << "reading netflix dobby rfc failed " << std::endl;
+                }
+#else
+                std::cout << "rfc is disabled and unable to check for netflix container mode " << std::endl;
+#endif
+            }
+
+            if (!type.empty() && type == "Cobalt")
+            {
+                if (configuration.find("\"preload\"") == std::string::npos)
+                {
+                    // Enable preload for l2s
+                    bool preload = suspend;
+                    std::cout << "setting Cobalt preload: " << preload << "\n";
+                    configSet["preload"] = JsonValue(preload);
+                }
+
+#ifdef RFC_ENABLED
+                RFC_ParamData_t param;
+                if (Utils::getRFCConfig("Device.DeviceInfo.X_RDKCENTRAL-COM_RFC.Feature.Dobby.Cobalt.Enable", param))
+                {
+                    JsonObject root;
+                    if (strncasecmp(param.value, "true", 4) == 0)
+                    {
+                        std::cout << "dobby rfc true - launching cobalt in container mode " << std::endl;
+                        root = configSet["root"].Object();
+                        root["mode"] = JsonValue("Container");
+                    }
+                    else
+                    {
+                        std::cout << "dobby rfc false - launching cobalt in local mode " << std::endl;
+                        root = configSet["root"].Object();
+                        root["outofprocess"] = JsonValue(true);
+                    }
+                    configSet["root"] = root;
+                }
+                else
+                {
+                    std::cout << "reading cobalt dobby rfc failed " << std::endl;
+                }
+#else
+                std::cout << "rfc is disabled and unable to check for cobalt container mode " << std::endl;
+#endif
+            }
+
+            // One RFC controls all WPE-based apps
+            if (!type.empty() && (type == "HtmlApp" || type == "LightningApp"))
+            {
+#ifdef RFC_ENABLED
+                RFC_ParamData_t param;
+                if (Utils::getRFCConfig("Device.DeviceInfo.X_RDKCENTRAL-COM_RFC.Feature.Dobby.WPE.Enable", param))
+                {
+                    JsonObject root;
+                    if (strncasecmp(param.value, "true", 4) == 0)
+                    {
+                        std::cout << "dobby WPE rfc true - launching " << type << " in container mode " << std::endl;
+                        root = configSet["root"].Object();
+                        root["mode"] = JsonValue("Container");
+                    }
+                    else
+                    {
+                        std::cout << "dobby WPE rfc false - launching " << type << " in out-of-process mode " << std::endl;
+                        root = configSet["root"].Object();
+                        root["outofprocess"] = JsonValue(true);
+                    }
+                    configSet["root"] = root;
+                }
+                else
+                {
+                    std::cout << "reading dobby WPE rfc failed - launching " << type << " in default mode" << std::endl;
+                }
+#else
+                std::cout << "rfc is disabled and unable to check for " << type << " container mode " << std::endl;
+#endif
+            }
+
+            if (!type.empty() && type == "SearchAndDiscoveryApp" )
+            {
+#ifdef RFC_ENABLED
+                RFC_ParamData_t param;
+                if (Utils::getRFCConfig("Device.DeviceInfo.X_RDKCENTRAL-COM_RFC.Feature.Dobby.SAD.Enable", param))
+                {
+                    JsonObject root;
+                    if (strncasecmp(param.value, "true", 4) == 0)
+                    {
+                        std::cout << "dobby SAD rfc true - launching " << type << " in container mode " << std::endl;
+                        root = configSet["root"].Object();
+                        root["mode"] = JsonValue("Container");
+                    }
+                    else
+                    {
+                        std::cout << "dobby SAD rfc false - launching " << type << " in out-of-process mode " << std::endl;
+                        root = configSet["root"].Object();
+                        root["outofprocess"] = JsonValue(true);
+                    }
+                    configSet["root"] = root;
+                }
+                else
+                {
+                    std::cout << "reading dobby SAD rfc failed - launching " << type << " in default mode" << std::endl;
+                }
+#else
+                std::cout << "rfc is disabled and unable to check for " << type << " container mode " << std::endl;
+#endif
+            }
+        }
+
+        // Whether the launch configuration of the type depends on the suspend parameter of the launch
+        static bool launchConfigurationDependsOnSuspend(const string& type)
+        {
+            return (type == "Netflix") || (type == "Cobalt");
+        }
+
+        static PluginStateRegistry::State toRegistryState(PluginHost::IShell::state state)
+        {
+            switch (state)
+            {
+                case PluginHost::IShell::DEACTIVATED: return PluginStateRegistry::DEACTIVATED;
+                case PluginHost::IShell::DEACTIVATION: return PluginStateRegistry::DEACTIVATION;
+                case PluginHost::IShell::ACTIVATION: return PluginStateRegistry::ACTIVATION;
+                case PluginHost::IShell::ACTIVATED: return PluginStateRegistry::ACTIVATED;
+                case PluginHost::IShell::PRECONDITION: return PluginStateRegistry::PRECONDITION;
+                default: return PluginStateRegistry::UNKNOWN;
+            }
+        }
+
+        static PluginStateRegistry::State toRegistryState(PluginHost::MetaData::Service::state state)
+        {
+            switch (state)
+            {
+                case PluginHost::MetaData::Service::state::DEACTIVATED: return PluginStateRegistry::DEACTIVATED;
+                case PluginHost::MetaData::Service::state::DEACTIVATION: return PluginStateRegistry::DEACTIVATION;
+                case PluginHost::MetaData::Service::state::ACTIVATION: return PluginStateRegistry::ACTIVATION;
+                case PluginHost::MetaData::Service::state::PRECONDITION: return PluginStateRegistry::PRECONDITION;
+                case PluginHost::MetaData::Service::state::DESTROYED: return PluginStateRegistry::UNKNOWN;
+                // SUSPENDED and RESUMED plugins are activated
+                default: return PluginStateRegistry::ACTIVATED;
+            }
+        }
+
+        static std::string clientIdentifierFromConfig(const std::string& configLine)
+        {
+            if (configLine.empty())
+            {
+                return "";
+            }
+            JsonObject serviceConfig = JsonObject(configLine.c_str());
+            if (!serviceConfig.HasLabel("clientidentifier"))
+            {
+                return "";
+            }
+            return serviceConfig["clientidentifier"].String();
+        }
+
+        static bool loadPluginStates(std::vector<PluginStateRegistry::Entry>& entries)
+        {
+            Core::JSON::ArrayType<PluginHost::MetaData::Service> availablePluginResult;
+            uint32_t status = getThunderControllerClient()->Get<Core::JSON::ArrayType<PluginHost::MetaData::Service>>(RDKSHELL_THUNDER_TIMEOUT, "status", availablePluginResult);
+            if (status > 0)
+            {
+                std::cout << "plugin status failed: " << status << std::endl;
+                return false;
+            }
+
+            for (uint16_t i = 0; i < availablePluginResult.Length(); i++)
+            {
+                PluginHost::MetaData::Service service = availablePluginResult[i];
+                PluginStateRegistry::Entry entry;
+                entry.callsign = service.Callsign.Value();
+                entry.callsign.erase(std::remove(entry.callsign.begin(),entry.callsign.end(),'\"'),entry.callsign.end());
+                if (entry.callsign.empty())
+                {
+                    continue;
+                }
+                entry.state = toRegistryState(service.JSONState.Value());
+                entry.className = service.ClassName.Value();
+                std::string configLine;
+                service.Configuration.ToString(configLine);
+                entry.clientIdentifier = clientIdentifierFromConfig(configLine);
+                entries.push_back(entry);
+            }
+            return true;
+        }
+
+        static PluginStateRegistry gPluginStates(loadPluginStates);
+
+        static std::string applicationType(const std::string& callsign)
+        {
+            PluginStateRegistry::Entry pluginEntry;
+            if (gPluginStates.find(callsign, pluginEntry) && !pluginEntry.className.empty())
+            {
+                return pluginEntry.className;
+            }
+            return callsign;
+        }
+
+        // records the duration of an API call when launch metrics are enabled
+        class LaunchMetricsScope
+        {
+        public:
+            LaunchMetricsScope(LaunchMetrics::Phase phase, const std::string& callsign)
+                : mPhase(phase)
+                , mCallsign(callsign)
+                , mStartTime(0)
+            {
+                if (gLaunchMetrics.enabled())
+                {
+                    // resolved up front, a destroyed plugin is no longer known
+                    mType = applicationType(callsign);
+                    mStartTime = LaunchMetrics::now();
+                }
+            }
+
+            ~LaunchMetricsScope()
+            {
+                if (mStartTime != 0)
+                {
+                    gLaunchMetrics.record(mType, mPhase, mStartTime, LaunchMetrics::now(), mCallsign);
+                }
+            }
+
+        private:
+            LaunchMetrics::Phase mPhase;
+            std::string mCallsign;
+            std::string mType;
+            uint64_t mStartTime;
+        };
+
+        // time spent in each launch stage, reported with onApplicationLaunched
+        struct LaunchTiming
+        {
+            std::string type;
+            uint64_t startTime;
+            uint64_t stageStartTime;
+            bool launchDone;
+            bool firstFrameSeen;
+            JsonObject stages;
+        };
+        std::map<std::string, LaunchTiming> gLaunchTimings;
+        std::mutex gLaunchTimingMutex;
+
+        static std::string launchTimingKey(const std::string& client)
+        {
+            std::string key = client;
+            std::transform(key.begin(), key.end(), key.begin(), ::tolower);
+            return key;
+        }
+
+        static void startLaunchTiming(const std::string& client, const std::string& type)
+        {
+            LaunchTiming timing;
+            timing.type = type.empty() ? applicationType(client) : type;
+            timing.startTime = LaunchMetrics::now();
+            timing.stageStartTime = timing.startTime;
+            timing.launchDone = false;
+            timing.firstFrameSeen = false;
+            gLaunchTimingMutex.lock();
+            gLaunchTimings[launchTimingKey(client)] = timing;
+            gLaunchTimingMutex.unlock();
+        }
+
+        static void launchStageCompleted(const std::string& client, LaunchMetrics::Phase stage)
+        {
+            uint64_t now = LaunchMetrics::now();
+            gLaunchTimingMutex.lock();
+            auto timingIt = gLaunchTimings.find(launchTimingKey(client));
+            if (timingIt != gLaunchTimings.end())
+            {
+                LaunchTiming& timing = timingIt->second;
+                const char* stageName = LaunchMetrics::phaseName(stage);
+                int previous = timing.stages.HasLabel(stageName) ? timing.stages[stageName].Number() : 0;
+                timing.stages[stageName] = previous + (int)((now - timing.stageStartTime) / 1000);
+                gLaunchMetrics.record(timing.type, stage, timing.stageStartTime, now, client);
+                timing.stageStartTime = now;
+            }
+            gLaunchTimingMutex.unlock();
+        }
+
+        static void setLaunchTimingValue(const std::string& client, const char* label, const JsonValue& value)
+        {
+            gLaunchTimingMutex.lock();
+            auto timingIt = gLaunchTimings.find(launchTimingKey(client));
+            if (timingIt != gLaunchTimings.end())
+            {
+                timingIt->second.stages[label] = value;
+            }
+            gLaunchTimingMutex.unlock();
+        }
+
+        // the launch call returned; the timing is kept for the first frame, unless the
+        // application was launched suspended and has none to show
+        static void finishLaunchTiming(const std::string& client, bool success, bool firstFrameExpected = true)
+        {
+            uint64_t now = LaunchMetrics::now();
+            gLaunchTimingMutex.lock();
+            auto timingIt = gLaunchTimings.find(launchTimingKey(client));
+            if (timingIt != gLaunchTimings.end())
+            {
+                LaunchTiming& timing = timingIt->second;
+                if (success)
+                {
+                    gLaunchMetrics.record(timing.type, LaunchMetrics::LAUNCH, timing.startTime, now, client);
+                }
+                timing.launchDone = true;
+                if (!success || timing.firstFrameSeen || !firstFrameExpected)
+                {
+                    gLaunchTimings.erase(timingIt);
+                }
+            }
+            gLaunchTimingMutex.unlock();
+        }
+
+        static bool takeLaunchTiming(const std::string& client, JsonObject& stages)
+        {
+            bool found = false;
+            uint64_t now = LaunchMetrics::now();
+            gLaunchTimingMutex.lock();
+            auto timingIt = gLaunchTimings.find(launchTimingKey(client));
+            if (timingIt != gLaunchTimings.end() && !timingIt->second.firstFrameSeen)
+            {
+                LaunchTiming& timing = timingIt->second;
+                gLaunchMetrics.record(timing.type, LaunchMetrics::FIRST_FRAME, timing.startTime, now, client);
+                stages = timing.stages;
+                stages["total"] = (int)((now - timing.startTime) / 1000);
+                timing.firstFrameSeen = true;
+                if (timing.launchDone)
+                {
+                    gLaunchTimings.erase(timingIt);
+                }
+                found = true;
+            }
+            gLaunchTimingMutex.unlock();
+            return found;
+        }
+
+        static bool writeLaunchTrace(const std::string& fileName)
+        {
+            std::ofstream traceFile(fileName.c_str(), std::ofstream::out | std::ofstream::trunc);
+            if (!traceFile.is_open())
+            {
+                std::cout << "unable to open launch trace file " << fileName << std::endl;
+                return false;
+            }
+            gLaunchMetrics.writeChromeTrace(traceFile);
+            return traceFile.good();
+        }
+
         static void updateSurfaceClientIdentifiers( void)
         {
           uint32_t status = 0;
           auto thunderController = getThunderControllerClient();
           WPEFramework::Core::JSON::String configString;
-          Core::JSON::ArrayType<PluginHost::MetaData::Service> availablePluginResult;
-          status = thunderController->Get<Core::JSON::ArrayType<PluginHost::MetaData::Service>>(RDKSHELL_THUNDER_TIMEOUT, "status", availablePluginResult);
-          if(status > 0)
-	  {
+          std::vector<PluginStateRegistry::Entry> plugins = gPluginStates.snapshot();
+          if (!gPluginStates.isLoaded())
+          {
             std::cout<<"pluginfo status falied"<<std::endl;
-	  }
-	  else
+            return;
+          }
+          for (const auto& plugin : plugins)
           {
-           for (uint16_t i = 0; i < availablePluginResult.Length(); i++)
-           {
-            PluginHost::MetaData::Service service = availablePluginResult[i];
-	    std::string configLine;
-	    service.Configuration.ToString(configLine);
-	    JsonObject serviceConfig = JsonObject(configLine.c_str());
-	    if (serviceConfig.HasLabel("clientidentifier"))
-	    { 
-	     JsonObject configSet;
-             std::string method = "configuration@";
-             std::string pluginName = service.Callsign.Value();
-             method=method.append(pluginName);
-             status = thunderController->Get<WPEFramework::Core::JSON::String>(RDKSHELL_THUNDER_TIMEOUT, method.c_str(), configString);
-             configSet.FromString(configString.Value());
-             configSet["clientidentifier"] = RDKSHELL_SURFACECLIENT_DISPLAYNAME;
-             status = thunderController->Set<JsonObject>(RDKSHELL_THUNDER_TIMEOUT, method.c_str(), configSet);
-             if(status > 0)
-             {
+            if (!plugin.clientIdentifier.empty())
+            {
+              JsonObject configSet;
+              std::string method = "configuration@" + plugin.callsign;
+              status = thunderController->Get<WPEFramework::Core::JSON::String>(RDKSHELL_THUNDER_TIMEOUT, method.c_str(), configString);
+              configSet.FromString(configString.Value());
+              configSet["clientidentifier"] = RDKSHELL_SURFACECLIENT_DISPLAYNAME;
+              status = thunderController->Set<JsonObject>(RDKSHELL_THUNDER_TIMEOUT, method.c_str(), configSet);
+              if(status > 0)
+              {
                 std::cout<<"clientidentifier config set failed"<<std::endl;
-	     }
+              }
             }
-	   }
-	  }
-       }
+          }
+        }
 
         void RDKShell::MonitorClients::StateChange(PluginHost::IShell* service)
         {
@@ -621,6 +936,15 @@ namespace WPEFramework {
                 }
                 gExitReasonMutex.unlock();
 
+                if (currentState == PluginHost::IShell::DESTROYED)
+                {
+                    gPluginStates.remove(service->Callsign());
+                }
+                else
+                {
+                    gPluginStates.update(service->Callsign(), toRegistryState(currentState), service->ClassName(), clientIdentifierFromConfig(service->ConfigLine()));
+                }
+
                 if (currentState == PluginHost::IShell::ACTIVATION)
                 {
                    std::string configLine = service->ConfigLine();
@@ -753,6 +1077,8 @@ namespace WPEFramework {
                         gRdkShellMutex.unlock();
                     }
                     
+                    gPrewarmPool.released(service->Callsign());
+
                     gPluginDataMutex.lock();
                     std::map<std::string, PluginData>::iterator pluginToRemove = gActivePluginsData.find(service->Callsign());
                     if (pluginToRemove != gActivePluginsData.end())
@@ -865,6 +1191,7 @@ namespace WPEFramework {
             registerMethod(RDKSHELL_METHOD_GET_EASTER_EGGS, &RDKShell::getEasterEggsWrapper, this);
 	          registerMethod(RDKSHELL_METHOD_GET_FRAME_RATE, &RDKShell::getFrameRateWrapper, this);
             registerMethod(RDKSHELL_METHOD_SET_FRAME_RATE, &RDKShell::setFrameRateWrapper, this);
+            registerMethod(RDKSHELL_METHOD_GET_LAUNCH_METRICS, &RDKShell::getLaunchMetricsWrapper, this);
       	    m_timer.connect(std::bind(&RDKShell::onTimer, this));
         }
 
@@ -979,6 +1306,21 @@ namespace WPEFramework {
                 waitForPersistentStore = false;
             }
 
+            char* launchMetricsValue = getenv("RDKSHELL_LAUNCH_METRICS");
+            if ((NULL != launchMetricsValue) && ((strcmp(launchMetricsValue, "1") == 0) || (strcmp(launchMetricsValue, "true") == 0)))
+            {
+                std::cout << "launch metrics enabled\n";
+                gLaunchMetrics.enable(true);
+            }
+            char* launchTraceFile = getenv("RDKSHELL_LAUNCH_TRACE_FILE");
+            if ((NULL != launchTraceFile) && (strlen(launchTraceFile) > 0))
+            {
+                std::cout << "launch trace file: " << launchTraceFile << std::endl;
+                gLaunchTraceFile = launchTraceFile;
+                gLaunchMetrics.enableTrace(RDKSHELL_LAUNCH_TRACE_CAPACITY);
+                gLaunchMetrics.enable(true);
+            }
+
             char* blockResidentApp = getenv("RDKSHELL_BLOCK_RESIDENTAPP_FACTORYMODE");
             if (NULL != blockResidentApp)
             {
@@ -1084,23 +1426,10 @@ namespace WPEFramework {
                   {
                       if (!sPersistentStoreFirstActivated)
                       {
-                          Core::JSON::ArrayType<PluginHost::MetaData::Service> joResult;
-                          auto thunderController = getThunderControllerClient();
-                          int32_t status = thunderController->Get<Core::JSON::ArrayType<PluginHost::MetaData::Service>>(RDKSHELL_THUNDER_TIMEOUT, "status", joResult);
-                          JsonArray stateArray;
-                          for (uint16_t i = 0; i < joResult.Length(); i++)
+                          PluginStateRegistry::Entry persistentStore;
+                          if (gPluginStates.find(PERSISTENT_STORE_CALLSIGN, persistentStore) && (persistentStore.state == PluginStateRegistry::ACTIVATED))
                           {
-                              PluginHost::MetaData::Service service = joResult[i];
-                              std::string callsign;
-                              service.Callsign.ToString(callsign);
-                              if (callsign.find(PERSISTENT_STORE_CALLSIGN) != std::string::npos)
-                              {
-                                if (service.JSONState == PluginHost::MetaData::Service::state::ACTIVATED)
-                                {
-                                  sPersistentStoreFirstActivated = true;
-                                }
-                                break;
-                              } 
+                              sPersistentStoreFirstActivated = true;
                           }
                       }
                       sPersistentStorePreLaunchChecked = true;
@@ -1190,6 +1519,19 @@ namespace WPEFramework {
             }
             loadStartupConfig();
             invokeStartupThunderApis();
+            loadPrewarmConfig();
+            if (!gPrewarmPool.empty())
+            {
+                gPrewarmPool.start();
+                gPrewarmThread = std::thread([this]() {
+                    std::string callsign;
+                    std::string type;
+                    while (gPrewarmPool.nextToWarm(callsign, type))
+                    {
+                        gPrewarmPool.warmed(callsign, prewarmApplication(callsign, type));
+                    }
+                });
+            }
             char* willDestroyWaitTimeValue = getenv("RDKSHELL_WILLDESTROY_EVENT_WAITTIME");
             if (NULL != willDestroyWaitTimeValue)
             {
@@ -1346,9 +1688,171 @@ namespace WPEFramework {
             gStartupConfigs.clear();
         }
 
+        // RDKSHELL_PREWARM_CONFIG names a json file such as
+        // {"startDelay": 10, "rewarmDelay": 30, "rdkshellPrewarm": [{"callsign": "LightningApp-1", "type": "LightningApp"}]}
+        // with the delays in seconds. A slot is warmed with the launch configuration of its type, as a
+        // launch without configuration or displayName sets it; launches that pass either, and Netflix or
+        // Cobalt launches with suspend, do not take the slot and go through the whole launch.
+        void RDKShell::loadPrewarmConfig()
+        {
+            const char* prewarmConfigFileName = getenv("RDKSHELL_PREWARM_CONFIG");
+            if (!prewarmConfigFileName)
+            {
+                return;
+            }
+            std::ifstream prewarmConfigFile(prewarmConfigFileName, std::ifstream::binary);
+            if (!prewarmConfigFile.is_open())
+            {
+                std::cout << "RDKShell prewarm config file read error : [unable to open/read file (" <<  prewarmConfigFileName << ")]\n";
+                return;
+            }
+            std::stringstream strStream;
+            strStream << prewarmConfigFile.rdbuf();
+            prewarmConfigFile.close();
+
+            JsonObject prewarmConfigData;
+            if (!prewarmConfigData.FromString(strStream.str()))
+            {
+                std::cout << "RDKShell prewarm config file read error : [json format is incorrect (" <<  prewarmConfigFileName << ")]\n";
+                return;
+            }
+
+            uint32_t startDelay = RDKSHELL_PREWARM_START_DELAY_IN_MS;
+            if (prewarmConfigData.HasLabel("startDelay"))
+            {
+                startDelay = prewarmConfigData["startDelay"].Number() * 1000;
+            }
+            if (prewarmConfigData.HasLabel("rewarmDelay"))
+            {
+                gPrewarmPool.setRewarmDelay(prewarmConfigData["rewarmDelay"].Number() * 1000);
+            }
+            if (!prewarmConfigData.HasLabel("rdkshellPrewarm") || (prewarmConfigData["rdkshellPrewarm"].Content() != JsonValue::type::ARRAY))
+            {
+                std::cout << "RDKShell prewarm config has no rdkshellPrewarm list\n";
+                return;
+            }
+
+            const JsonArray& jsonValue = prewarmConfigData["rdkshellPrewarm"].Array();
+            for (int k = 0; k < jsonValue.Length(); k++)
+            {
+                if (!(jsonValue[k].Content() == JsonValue::type::OBJECT))
+                {
+                    std::cout << "one of rdkshell prewarm config entry is of wrong format" << std::endl;
+                    continue;
+                }
+                const JsonObject& configEntry = jsonValue[k].Object();
+                if (!(configEntry.HasLabel("callsign") && configEntry.HasLabel("type")))
+                {
+                    std::cout << "one of rdkshell prewarm config entry is not having callsign/type parameter" << std::endl;
+                    continue;
+                }
+                std::string callsign = configEntry["callsign"].String();
+                std::string type = configEntry["type"].String();
+                std::cout << "prewarming " << type << " as " << callsign << std::endl;
+                gPrewarmPool.add(callsign, type, startDelay);
+            }
+        }
+
+        bool RDKShell::prewarmApplication(const std::string& callsign, const std::string& type)
+        {
+            double startTime = RdkShell::milliseconds();
+            std::cout << "prewarming application " << callsign << " of type " << type << std::endl;
+            auto thunderController = std::unique_ptr<JSONRPCDirectLink>(new JSONRPCDirectLink(mCurrentService));
+
+            PluginStateRegistry::Entry pluginEntry;
+            if (gPluginStates.find(callsign, pluginEntry))
+            {
+                if (PluginStateRegistry::isRunning(pluginEntry.state))
+                {
+                    // launched before the slot was warmed, it is not idle
+                    std::cout << callsign << " is already running, not prewarming it" << std::endl;
+                    return false;
+                }
+            }
+            else
+            {
+                PluginStateRegistry::Entry typeEntry;
+                if (!gPluginStates.find(type, typeEntry))
+                {
+                    std::cout << "unable to prewarm " << callsign << ", type " << type << " not found" << std::endl;
+                    return false;
+                }
+                JsonObject cloneParams;
+                cloneParams.Set("callsign", type);
+                cloneParams.Set("newcallsign", callsign.c_str());
+                JsonObject cloneResult;
+                uint32_t status = thunderController->Invoke(RDKSHELL_THUNDER_TIMEOUT, "clone", cloneParams, cloneResult, true);
+                if (status > 0)
+                {
+                    std::cout << "prewarm clone of " << type << " failed with status " << status << std::endl;
+                    return false;
+                }
+                gPluginStates.update(callsign, PluginStateRegistry::DEACTIVATED, typeEntry.className, typeEntry.clientIdentifier);
+            }
+
+            std::string displayName = defaultDisplayName(callsign, type);
+            if (!isClientExists(callsign))
+            {
+                std::shared_ptr<CreateDisplayRequest> request = std::make_shared<CreateDisplayRequest>(callsign, displayName);
+                lockRdkShellMutex();
+                gCreateDisplayRequests.push_back(request);
+                gRdkShellMutex.unlock();
+                sem_wait(&request->mSemaphore);
+            }
+
+            string method = "configuration@" + callsign;
+            WPEFramework::Core::JSON::String configString;
+            uint32_t status = thunderController->Get<WPEFramework::Core::JSON::String>(RDKSHELL_THUNDER_TIMEOUT, method.c_str(), configString);
+            if (status == 0)
+            {
+                // as a launch without configuration, suspend or displayName would configure it
+                JsonObject configSet;
+                configSet.FromString(configString.Value());
+                applyLaunchConfiguration(configSet, type, "", displayName, false);
+                status = thunderController->Set<JsonObject>(RDKSHELL_THUNDER_TIMEOUT, method.c_str(), configSet);
+            }
+            if (status > 0)
+            {
+                std::cout << "prewarm configuration of " << callsign << " failed with status " << status << std::endl;
+                return false;
+            }
+
+            JsonObject activateParams;
+            activateParams.Set("callsign", callsign.c_str());
+            JsonObject activateResult;
+            status = thunderController->Invoke(RDKSHELL_THUNDER_TIMEOUT, "activate", activateParams, activateResult);
+            if (status > 0)
+            {
+                std::cout << "prewarm activation of " << callsign << " failed with status " << status << std::endl;
+                return false;
+            }
+
+            WPEFramework::Core::JSON::String stateString;
+            stateString = "suspended";
+            status = JSONRPCDirectLink(mCurrentService, callsign).Set<WPEFramework::Core::JSON::String>(RDKSHELL_THUNDER_TIMEOUT, "state", stateString);
+            if (status > 0)
+            {
+                std::cout << "unable to suspend prewarmed " << callsign << ", status " << status << std::endl;
+            }
+            setVisibility(callsign, false);
+
+            std::cout << "prewarmed " << callsign << " in " << (RdkShell::milliseconds() - startTime) << " milliseconds" << std::endl;
+            return true;
+        }
+
         void RDKShell::Deinitialize(PluginHost::IShell* service)
         {
             LOGINFO("Deinitialize");
+            // a slot being warmed waits for the render thread to create its display
+            gPrewarmPool.stop();
+            if (gPrewarmThread.joinable())
+            {
+                gPrewarmThread.join();
+            }
+            if (!gLaunchTraceFile.empty())
+            {
+                writeLaunchTrace(gLaunchTraceFile);
+            }
             gRdkShellMutex.lock();
             sRunning = false;
             gRdkShellMutex.unlock();
@@ -1369,6 +1873,7 @@ namespace WPEFramework {
             mEventListener = nullptr;
             mEnableUserInactivityNotification = false;
             gActivePluginsData.clear();
+            Utils::releaseJsonRpcLinks(service->Callsign());
             gRdkShellMutex.lock();
             for (int i=0; i<gCreateDisplayRequests.size(); i++)
             {
@@ -1442,6 +1947,14 @@ namespace WPEFramework {
           std::cout << "RDKShell onApplicationLaunched event received ..." << client << std::endl;
           JsonObject params;
           params["client"] = client;
+          JsonObject timing;
+          if (takeLaunchTiming(client, timing))
+          {
+              std::string timingString;
+              timing.ToString(timingString);
+              std::cout << "launch timing of " << client << ": " << timingString << std::endl;
+              params["timing"] = timing;
+          }
           mShell.notify(RDKSHELL_EVENT_ON_APP_LAUNCHED, params);
         }
 
@@ -3058,6 +3571,7 @@ namespace WPEFramework {
                 {
                     type = parameters["type"].String();
                 }
+                startLaunchTiming(callsign, type);
                 string version = "0.0";
                 string uri;
                 int32_t x = 0;
@@ -3067,31 +3581,10 @@ namespace WPEFramework {
                 bool suspend = false;
                 bool visible = true;
                 bool focused = true;
-                string configuration;
-                string behind;
-
-                // Ensure cloned plugin displays are in a sub-dir based on
-                // plugin classname
-                string displayName;
-                if (type.empty())
-                {
-                    displayName = "wst-" + callsign;
-                }
-                else
-                {
-                    string xdgDir;
-                    Core::SystemInfo::GetEnvironment(_T("XDG_RUNTIME_DIR"), xdgDir);
-                    string displaySubdir = xdgDir + "/" + type;
-                    Core::Directory(displaySubdir.c_str()).CreatePath();
-
-                    // don't add XDG_RUNTIME_DIR to display name
-                    displayName = type + "/" + "wst-" + callsign;
-                }
+                string configuration;
+                string behind;
 
-                if (gRdkShellSurfaceModeEnabled)
-                {
-                    displayName = "rdkshell_display";
-                }
+                string displayName = defaultDisplayName(callsign, type);
                 bool scaleToFit = false;
                 bool setSuspendResumeStateOnLaunch = true;
                 bool holePunch = true;
@@ -3163,6 +3656,34 @@ namespace WPEFramework {
                   autoDestroy = parameters["autodestroy"].Boolean();
                 }
 
+                // a prewarmed instance already has its display, configuration and activation done, so it
+                // is only taken by a launch that would configure it the same way
+                bool prewarmed = false;
+                if (configuration.empty() && !parameters.HasLabel("displayName") && (!suspend || !launchConfigurationDependsOnSuspend(type)))
+                {
+                    prewarmed = gPrewarmPool.claim(callsign, type, RDKSHELL_PREWARM_CLAIM_WAIT_TIME_IN_MS);
+                    if (prewarmed)
+                    {
+                        std::cout << "launching prewarmed instance of " << callsign << std::endl;
+                        setLaunchTimingValue(callsign, "prewarmed", true);
+                    }
+                }
+                if (!prewarmed && gPrewarmPool.evict(callsign, RDKSHELL_PREWARM_CLAIM_WAIT_TIME_IN_MS))
+                {
+                    // the configuration of a running plugin is not read again, the prewarmed instance is
+                    // deactivated so the launch configures and activates it as any other
+                    std::cout << "deactivating prewarmed instance of " << callsign << " before launching it" << std::endl;
+                    JsonObject deactivateParams;
+                    deactivateParams.Set("callsign", callsign.c_str());
+                    JsonObject deactivateResult;
+                    uint32_t deactivateStatus = JSONRPCDirectLink(mCurrentService).Invoke(RDKSHELL_THUNDER_TIMEOUT, "deactivate", deactivateParams, deactivateResult);
+                    if (deactivateStatus > 0)
+                    {
+                        std::cout << "unable to deactivate prewarmed " << callsign << ", status " << deactivateStatus << std::endl;
+                    }
+                    gPrewarmPool.evicted(callsign);
+                }
+
                 //check to see if plugin already exists
                 bool newPluginFound = false;
                 bool originalPluginFound = false;
@@ -3182,39 +3703,27 @@ namespace WPEFramework {
                 }
                 auto thunderController = std::unique_ptr<JSONRPCDirectLink>(new JSONRPCDirectLink(mCurrentService));
                 //auto thunderController = getThunderControllerClient();
+                PluginStateRegistry::Entry typeEntry;
                 if ((false == newPluginFound) && (false == originalPluginFound))
                 {
-                    Core::JSON::ArrayType<PluginHost::MetaData::Service> availablePluginResult;
-                    uint32_t status = thunderController->Get<Core::JSON::ArrayType<PluginHost::MetaData::Service>>(RDKSHELL_THUNDER_TIMEOUT, "status", availablePluginResult);
-
-                    std::cout << "status status: " << status << std::endl;
-                    if (status > 0)
-                    {
-                        std::cout << "trying status one more time...\n";
-                        status = thunderController->Get<Core::JSON::ArrayType<PluginHost::MetaData::Service>>(RDKSHELL_THUNDER_TIMEOUT, "status", availablePluginResult);
-                        std::cout << "status status: " << status << std::endl;
-                    }
-
-                    for (uint16_t i = 0; i < availablePluginResult.Length(); i++)
+                    newPluginFound = gPluginStates.contains(callsign);
+                    originalPluginFound = !newPluginFound && gPluginStates.find(type, typeEntry);
+                    if (!newPluginFound && !originalPluginFound)
                     {
-                        PluginHost::MetaData::Service service = availablePluginResult[i];
-                        std::string pluginName = service.Callsign.Value();
-                        pluginName.erase(std::remove(pluginName.begin(),pluginName.end(),'\"'),pluginName.end());
-                        if (!pluginName.empty() && pluginName == callsign)
-                        {
-                            newPluginFound = true;
-                            break;
-                        }
-                        else if (!pluginName.empty() && pluginName == type)
-                        {
-                            originalPluginFound = true;
-                        }
+                        // not seen through the notifications, it may have been added since the last status
+                        std::cout << "plugin not registered, refreshing status\n";
+                        gPluginStates.refresh();
+                        newPluginFound = gPluginStates.contains(callsign);
+                        originalPluginFound = !newPluginFound && gPluginStates.find(type, typeEntry);
                     }
-                    pluginsFound = availablePluginResult.Length();
                 }
 
+                launchStageCompleted(callsign, LaunchMetrics::LOOKUP);
+
                 if (!newPluginFound && !originalPluginFound)
                 {
+                    finishLaunchTiming(callsign, false);
+                    pluginsFound = gPluginStates.snapshot().size();
                     std::cout << "number of types found: " << pluginsFound << std::endl;
                     response["message"] = "failed to launch application.  type not found";
                     gLaunchMutex.lock();
@@ -3246,30 +3755,25 @@ namespace WPEFramework {
                         status = thunderController->Invoke(RDKSHELL_THUNDER_TIMEOUT, "clone", joParams2, joResult, true);
                         std::cout << "clone status: " << status << std::endl;
                     }
+                    if (status == 0)
+                    {
+                        // a clone is not activated yet, so no notification tells about it
+                        if (typeEntry.callsign.empty())
+                        {
+                            gPluginStates.find(type, typeEntry);
+                        }
+                        gPluginStates.update(callsign, PluginStateRegistry::DEACTIVATED, typeEntry.className, typeEntry.clientIdentifier);
+                    }
+                    launchStageCompleted(callsign, LaunchMetrics::CLONE);
 
                     string strParams;
                     string strResult;
                     joParams.ToString(strParams);
                     joResult.ToString(strResult);
                     launchType = RDKShellLaunchType::CREATE;
-                    {
-                        bool lockAcquired = false;
-                        double startTime = RdkShell::milliseconds();
-                        while (!lockAcquired && (RdkShell::milliseconds() - startTime) < RDKSHELL_TRY_LOCK_WAIT_TIME_IN_MS)
-                        {
-                            lockAcquired = gRdkShellMutex.try_lock();
-                        }
-                        if (!lockAcquired)
-                        {
-                            std::cout << "unable to get lock for create display, defaulting to normal lock\n";
-                            gRdkShellMutex.lock();
-                        }
-                        else
-                        {
-                            std::cout << "lock was acquired via try for create display\n";
-                        }
-                    }
+                    lockRdkShellMutex();
                     gRdkShellMutex.unlock();
+                    launchStageCompleted(callsign, LaunchMetrics::LOCK);
                     if (!isClientExists(callsign))
                     {
                         std::shared_ptr<CreateDisplayRequest> request = std::make_shared<CreateDisplayRequest>(callsign, displayName, width, height);
@@ -3279,204 +3783,53 @@ namespace WPEFramework {
                         gRdkShellMutex.unlock();
                         sem_wait(&request->mSemaphore);
                     }
+                    launchStageCompleted(callsign, LaunchMetrics::CREATE_DISPLAY);
                 }
 
-                WPEFramework::Core::JSON::String configString;
-
                 uint32_t status = 0;
-                string method = "configuration@" + callsign;
                 Core::JSON::ArrayType<PluginHost::MetaData::Service> joResult;
-                status = thunderController->Get<WPEFramework::Core::JSON::String>(RDKSHELL_THUNDER_TIMEOUT, method.c_str(), configString);
-
-                std::cout << "config status: " << status << std::endl;
-                if (status > 0)
+                if (!prewarmed)
                 {
-                    std::cout << "trying status one more time...\n";
+                    WPEFramework::Core::JSON::String configString;
+                    string method = "configuration@" + callsign;
                     status = thunderController->Get<WPEFramework::Core::JSON::String>(RDKSHELL_THUNDER_TIMEOUT, method.c_str(), configString);
-                    std::cout << "config status: " << status << std::endl;
-                }
-
-                JsonObject configSet;
-                configSet.FromString(configString.Value());
-
-                if (!configuration.empty())
-                {
-                    JsonObject configurationOverrides;
-                    configurationOverrides.FromString(configuration);
-                    JsonObject::Iterator configurationIterator = configurationOverrides.Variants();
-                    while (configurationIterator.Next())
-                    {
-                        configSet[configurationIterator.Label()] = configurationIterator.Current();
-                    }
-                }
-                configSet["clientidentifier"] = displayName;
-                if (!type.empty() && type == "Netflix")
-                {
-                    std::cout << "setting launchtosuspend for Netflix: " << suspend << std::endl;
-                    configSet["launchtosuspend"] = suspend;
-                    if (!newPluginFound && !suspend)
-                    {
-                        setSuspendResumeStateOnLaunch = false;
-                    }
-
-#ifdef RFC_ENABLED
-                    RFC_ParamData_t param;
-                    if (Utils::getRFCConfig("Device.DeviceInfo.X_RDKCENTRAL-COM_RFC.Feature.Dobby.Netflix.Enable", param))
-                    {
-                        JsonObject root;
-                        if (strncasecmp(param.value, "true", 4) == 0)
-                        {
-                            std::cout << "dobby rfc true - launching netflix in container mode " << std::endl;
-                            root = configSet["root"].Object();
-                            root["mode"] = JsonValue("Container");
-                        }
-                        else
-                        {
-                            std::cout << "dobby rfc false - launching netflix in local mode " << std::endl;
-                            root = configSet["root"].Object();
-                            root["mode"] = JsonValue("Local");
-                        }
-                        configSet["root"] = root;
-                    }
-                    else
-                    {
-                        std::cout << "reading netflix dobby rfc failed " << std::endl;
-                    }
-#else
-                    std::cout << "rfc is disabled and unable to check for netflix container mode " << std::endl;
-#endif
-                }
 
-                if (!type.empty() && type == "Cobalt")
-                {
-                    if (configuration.find("\"preload\"") == std::string::npos)
+                    std::cout << "config status: " << status << std::endl;
+                    if (status > 0)
                     {
-                        // Enable preload for l2s
-                        bool preload = suspend;
-                        std::cout << "setting Cobalt preload: " << preload << "\n";
-                        configSet["preload"] = JsonValue(preload);
+                        std::cout << "trying status one more time...\n";
+                        status = thunderController->Get<WPEFramework::Core::JSON::String>(RDKSHELL_THUNDER_TIMEOUT, method.c_str(), configString);
+                        std::cout << "config status: " << status << std::endl;
                     }
 
-#ifdef RFC_ENABLED
-                    RFC_ParamData_t param;
-                    if (Utils::getRFCConfig("Device.DeviceInfo.X_RDKCENTRAL-COM_RFC.Feature.Dobby.Cobalt.Enable", param))
+                    JsonObject configSet;
+                    configSet.FromString(configString.Value());
+                    applyLaunchConfiguration(configSet, type, configuration, displayName, suspend);
+                    if (!type.empty() && type == "Netflix" && !newPluginFound && !suspend)
                     {
-                        JsonObject root;
-                        if (strncasecmp(param.value, "true", 4) == 0)
-                        {
-                            std::cout << "dobby rfc true - launching cobalt in container mode " << std::endl;
-                            root = configSet["root"].Object();
-                            root["mode"] = JsonValue("Container");
-                        }
-                        else
-                        {
-                            std::cout << "dobby rfc false - launching cobalt in local mode " << std::endl;
-                            root = configSet["root"].Object();
-                            root["outofprocess"] = JsonValue(true);
-                        }
-                        configSet["root"] = root;
-                    }
-                    else
-                    {
-                        std::cout << "reading cobalt dobby rfc failed " << std::endl;
+                        setSuspendResumeStateOnLaunch = false;
                     }
-#else
-                    std::cout << "rfc is disabled and unable to check for cobalt container mode " << std::endl;
-#endif
-                }
 
-                // One RFC controls all WPE-based apps
-                if (!type.empty() && (type == "HtmlApp" || type == "LightningApp"))
-                {
-#ifdef RFC_ENABLED
-                    RFC_ParamData_t param;
-                    if (Utils::getRFCConfig("Device.DeviceInfo.X_RDKCENTRAL-COM_RFC.Feature.Dobby.WPE.Enable", param))
-                    {
-                        JsonObject root;
-                        if (strncasecmp(param.value, "true", 4) == 0)
-                        {
-                            std::cout << "dobby WPE rfc true - launching " << type << " in container mode " << std::endl;
-                            root = configSet["root"].Object();
-                            root["mode"] = JsonValue("Container");
-                        }
-                        else
-                        {
-                            std::cout << "dobby WPE rfc false - launching " << type << " in out-of-process mode " << std::endl;
-                            root = configSet["root"].Object();
-                            root["outofprocess"] = JsonValue(true);
-                        }
-                        configSet["root"] = root;
-                    }
-                    else
-                    {
-                        std::cout << "reading dobby WPE rfc failed - launching " << type << " in default mode" << std::endl;
-                    }
-#else
-                    std::cout << "rfc is disabled and unable to check for " << type << " container mode " << std::endl;
-#endif
-                }
+                    status = thunderController->Set<JsonObject>(RDKSHELL_THUNDER_TIMEOUT, method.c_str(), configSet);
 
-                if (!type.empty() && type == "SearchAndDiscoveryApp" )
-                {
-#ifdef RFC_ENABLED
-                    RFC_ParamData_t param;
-                    if (Utils::getRFCConfig("Device.DeviceInfo.X_RDKCENTRAL-COM_RFC.Feature.Dobby.SAD.Enable", param))
-                    {
-                        JsonObject root;
-                        if (strncasecmp(param.value, "true", 4) == 0)
-                        {
-                            std::cout << "dobby SAD rfc true - launching " << type << " in container mode " << std::endl;
-                            root = configSet["root"].Object();
-                            root["mode"] = JsonValue("Container");
-                        }
-                        else
-                        {
-                            std::cout << "dobby SAD rfc false - launching " << type << " in out-of-process mode " << std::endl;
-                            root = configSet["root"].Object();
-                            root["outofprocess"] = JsonValue(true);
-                        }
-                        configSet["root"] = root;
-                    }
-                    else
+                    std::cout << "set status: " << status << std::endl;
+                    if (status > 0)
                     {
-                        std::cout << "reading dobby SAD rfc failed - launching " << type << " in default mode" << std::endl;
+                        std::cout << "trying status one more time...\n";
+                        status = thunderController->Set<JsonObject>(RDKSHELL_THUNDER_TIMEOUT, method.c_str(), configSet);
+                        std::cout << "set status: " << status << std::endl;
                     }
-#else
-                    std::cout << "rfc is disabled and unable to check for " << type << " container mode " << std::endl;
-#endif
-                }
-
-                status = thunderController->Set<JsonObject>(RDKSHELL_THUNDER_TIMEOUT, method.c_str(), configSet);
-
-                std::cout << "set status: " << status << std::endl;
-                if (status > 0)
-                {
-                    std::cout << "trying status one more time...\n";
-                    status = thunderController->Set<JsonObject>(RDKSHELL_THUNDER_TIMEOUT, method.c_str(), configSet);
-                    std::cout << "set status: " << status << std::endl;
+                    launchStageCompleted(callsign, LaunchMetrics::CONFIGURE);
                 }
 
                 if (launchType == RDKShellLaunchType::UNKNOWN)
                 {
                     status = 0;
-                    string statusMethod = "status@"+callsign;
-                    Core::JSON::ArrayType<PluginHost::MetaData::Service> serviceResults;
-                    status = thunderController->Get<Core::JSON::ArrayType<PluginHost::MetaData::Service> >(RDKSHELL_THUNDER_TIMEOUT, statusMethod.c_str(),serviceResults);
-
-                    std::cout << "get status: " << status << std::endl;
-                    if (status > 0)
-                    {
-                        std::cout << "trying status one more time...\n";
-                        status = thunderController->Get<Core::JSON::ArrayType<PluginHost::MetaData::Service> >(RDKSHELL_THUNDER_TIMEOUT, statusMethod.c_str(),serviceResults);
-                        std::cout << "get status: " << status << std::endl;
-                    }
-
-                    if (status == 0 && serviceResults.Length() > 0)
+                    PluginStateRegistry::Entry pluginEntry;
+                    if (gPluginStates.find(callsign, pluginEntry))
                     {
-                        PluginHost::MetaData::Service service = serviceResults[0];
-                        if (service.JSONState == PluginHost::MetaData::Service::state::DEACTIVATED ||
-                            service.JSONState == PluginHost::MetaData::Service::state::DEACTIVATION ||
-                            service.JSONState == PluginHost::MetaData::Service::state::PRECONDITION)
+                        std::cout << "plugin state: " << pluginEntry.state << std::endl;
+                        if (!PluginStateRegistry::isRunning(pluginEntry.state))
                         {
                             launchType = RDKShellLaunchType::ACTIVATE;
                             JsonObject activateParams;
@@ -3528,6 +3881,8 @@ namespace WPEFramework {
                     }
                 }
 
+                launchStageCompleted(callsign, LaunchMetrics::ACTIVATE);
+
                 bool deferLaunch = false;
                 if (status > 0)
                 {
@@ -3540,23 +3895,8 @@ namespace WPEFramework {
                     uint32_t tempY = 0;
                     uint32_t screenWidth = 0;
                     uint32_t screenHeight = 0;
-                    {
-                        bool lockAcquired = false;
-                        double startTime = RdkShell::milliseconds();
-                        while (!lockAcquired && (RdkShell::milliseconds() - startTime) < RDKSHELL_TRY_LOCK_WAIT_TIME_IN_MS)
-                        {
-                            lockAcquired = gRdkShellMutex.try_lock();
-                        }
-                        if (!lockAcquired)
-                        {
-                            std::cout << "unable to get lock for get bounds, defaulting to normal lock\n";
-                            gRdkShellMutex.lock();
-                        }
-                        else
-                        {
-                            std::cout << "lock was acquired via try for get bounds\n";
-                        }
-                    }
+                    lockRdkShellMutex();
+                    launchStageCompleted(callsign, LaunchMetrics::LOCK);
                     CompositorController::getBounds(callsign, tempX, tempY, screenWidth, screenHeight);
                     gRdkShellMutex.unlock();
                     width = screenWidth;
@@ -3577,27 +3917,13 @@ namespace WPEFramework {
                     {
                         height = parameters["h"].Number();
                     }
-                    {
-                        bool lockAcquired = false;
-                        double startTime = RdkShell::milliseconds();
-                        while (!lockAcquired && (RdkShell::milliseconds() - startTime) < RDKSHELL_TRY_LOCK_WAIT_TIME_IN_MS)
-                        {
-                            lockAcquired = gRdkShellMutex.try_lock();
-                        }
-                        if (!lockAcquired)
-                        {
-                            std::cout << "unable to get lock for set bounds, defaulting to normal lock\n";
-                            gRdkShellMutex.lock();
-                        }
-                        else
-                        {
-                            std::cout << "lock was acquired via try for set bounds\n";
-                        }
-                    }
+                    lockRdkShellMutex();
+                    launchStageCompleted(callsign, LaunchMetrics::LOCK);
                     std::cout << "setting the desired bounds\n";
                     CompositorController::setBounds(callsign, 0, 0, 1, 1); //forcing a compositor resize flush
                     CompositorController::setBounds(callsign, x, y, width, height);
                     gRdkShellMutex.unlock();
+                    launchStageCompleted(callsign, LaunchMetrics::BOUNDS);
 
                     if (scaleToFit)
                     {
@@ -3693,6 +4019,8 @@ namespace WPEFramework {
                         }
                     }
 
+                    launchStageCompleted(callsign, LaunchMetrics::STATE);
+
                     setVisibility(callsign, visible);
                     setHolePunch(callsign, holePunch);
                     if (!visible)
@@ -3716,6 +4044,7 @@ namespace WPEFramework {
                         {
                             std::cout << "failed to set url to " << uri << " with status code " << status << std::endl;
                         }
+                        launchStageCompleted(callsign, LaunchMetrics::URL);
                     }
                 }
 
@@ -3745,6 +4074,7 @@ namespace WPEFramework {
                             break;
                     }
                     std::cout << "Application:" << callsign << " took " << (RdkShell::seconds() - launchStartTime)*1000 << " milliseconds to launch " << std::endl;
+                    finishLaunchTiming(callsign, true, !(setSuspendResumeStateOnLaunch && suspend));
                     gLaunchMutex.lock();
                     gLaunchCount = 0;
                     gLaunchMutex.unlock();
@@ -3762,6 +4092,7 @@ namespace WPEFramework {
             }
             if (!result) 
             {
+                finishLaunchTiming(appCallsign, false);
                 response["message"] = "failed to launch application";
             }
             gLaunchMutex.lock();
@@ -3788,6 +4119,7 @@ namespace WPEFramework {
             {
                 uint32_t status;
                 const string callsign = parameters["callsign"].String();
+                LaunchMetricsScope metricsScope(LaunchMetrics::SUSPEND, callsign);
                 std::cout << "about to suspend " << callsign << std::endl;
 		string client;
                 if (parameters.HasLabel("client"))
@@ -3859,6 +4191,7 @@ namespace WPEFramework {
             if (result)
             {
                 const string callsign = parameters["callsign"].String();
+                LaunchMetricsScope metricsScope(LaunchMetrics::DESTROY, callsign);
                 bool isApplicationBeingLaunched = false;
 		gLaunchDestroyMutex.lock();
                 if (gLaunchApplications.find(callsign) != gLaunchApplications.end())
@@ -4057,6 +4390,7 @@ namespace WPEFramework {
             if (result)
             {
                 const string client = parameters["client"].String();
+                LaunchMetricsScope metricsScope(LaunchMetrics::SUSPEND, client);
 
                 std::string mimeType;
                 if (!getMimeType(client, mimeType))
@@ -4124,6 +4458,7 @@ namespace WPEFramework {
             if (result)
             {
                 const string client = parameters["client"].String();
+                LaunchMetricsScope metricsScope(LaunchMetrics::RESUME, client);
 
                 std::string mimeType;
                 if (!getMimeType(client, mimeType))
@@ -4184,27 +4519,12 @@ namespace WPEFramework {
             LOGINFOMETHOD();
             bool result = true;
 
-            string method = "status";
-            Core::JSON::ArrayType<PluginHost::MetaData::Service> joResult;
-            auto thunderController = getThunderControllerClient();
-            uint32_t status = thunderController->Get<Core::JSON::ArrayType<PluginHost::MetaData::Service>>(RDKSHELL_THUNDER_TIMEOUT, method.c_str(), joResult);
-
             JsonArray availableTypes;
-            for (uint16_t i = 0; i < joResult.Length(); i++)
+            for (const auto& plugin : gPluginStates.snapshot())
             {
-                PluginHost::MetaData::Service service = joResult[i];
-                std::string configLine;
-                service.Configuration.ToString(configLine);
-                if (!configLine.empty())
+                if (!plugin.clientIdentifier.empty())
                 {
-                    JsonObject serviceConfig = JsonObject(configLine.c_str());
-                    if (serviceConfig.HasLabel("clientidentifier"))
-                    {
-                        std::string typeName;
-                        service.Callsign.ToString(typeName);
-                        typeName.erase(std::remove(typeName.begin(),typeName.end(),'\"'),typeName.end());
-                        availableTypes.Add(typeName);
-                    }
+                    availableTypes.Add(plugin.callsign);
                 }
             }
             response["types"] = availableTypes;
@@ -4323,66 +4643,46 @@ namespace WPEFramework {
             LOGINFOMETHOD();
             bool result = true;
 
-            string method = "status";
-            Core::JSON::ArrayType<PluginHost::MetaData::Service> joResult;
-            auto thunderController = getThunderControllerClient();
-            uint32_t status = thunderController->Get<Core::JSON::ArrayType<PluginHost::MetaData::Service>>(RDKSHELL_THUNDER_TIMEOUT, method.c_str(), joResult);
-
-
             JsonArray stateArray;
-            for (uint16_t i = 0; i < joResult.Length(); i++)
+            for (const auto& plugin : gPluginStates.snapshot())
             {
-                PluginHost::MetaData::Service service = joResult[i];
-                if (service.JSONState != PluginHost::MetaData::Service::state::DEACTIVATED &&
-                    service.JSONState != PluginHost::MetaData::Service::state::DEACTIVATION &&
-                    service.JSONState != PluginHost::MetaData::Service::state::PRECONDITION)
+                if (PluginStateRegistry::isRunning(plugin.state) && !plugin.clientIdentifier.empty())
                 {
-                    std::string configLine;
-                    service.Configuration.ToString(configLine);
-                    if (!configLine.empty())
-                    {
-                        JsonObject serviceConfig = JsonObject(configLine.c_str());
-                        if (serviceConfig.HasLabel("clientidentifier"))
-                        {
-                            std::string callsign;
-                            service.Callsign.ToString(callsign);
-                            callsign.erase(std::remove(callsign.begin(),callsign.end(),'\"'),callsign.end());
-
-                            WPEFramework::Core::JSON::String stateString;
-                            const string callsignWithVersion = callsign + ".1";
-                            auto thunderPlugin = getThunderControllerClient(callsignWithVersion);
-                            uint32_t stateStatus = thunderPlugin->Get<WPEFramework::Core::JSON::String>(RDKSHELL_THUNDER_TIMEOUT, "state", stateString);
+                    const std::string& callsign = plugin.callsign;
 
-                            if (stateStatus == 0)
-                            {
-                                WPEFramework::Core::JSON::String urlString;
-                                uint32_t urlStatus = thunderPlugin->Get<WPEFramework::Core::JSON::String>(RDKSHELL_THUNDER_TIMEOUT, "url",urlString);
+                    WPEFramework::Core::JSON::String stateString;
+                    const string callsignWithVersion = callsign + ".1";
+                    auto thunderPlugin = getThunderControllerClient(callsignWithVersion);
+                    uint32_t stateStatus = thunderPlugin->Get<WPEFramework::Core::JSON::String>(RDKSHELL_THUNDER_TIMEOUT, "state", stateString);
 
-                                JsonObject typeObject;
-                                typeObject["callsign"] = callsign;
-                                typeObject["state"] = stateString.Value();
-                                if (urlStatus == 0)
-                                {
-                                    typeObject["uri"] = urlString.Value();
-                                }
-                                else
-                                {
-                                    typeObject["uri"] = "";
-                                }
-                                gExitReasonMutex.lock();
-                                if (gApplicationsExitReason.find(callsign) != gApplicationsExitReason.end())
-                                {
-                                    typeObject["lastExitReason"] = (int)gApplicationsExitReason[callsign];
-                                }
-                                else
-                                {
-                                    typeObject["lastExitReason"] = (int)AppLastExitReason::UNDEFINED;
-                                }
-                                gExitReasonMutex.unlock();
+                    if (stateStatus == 0)
+                    {
+                        WPEFramework::Core::JSON::String urlString;
+                        uint32_t urlStatus = thunderPlugin->Get<WPEFramework::Core::JSON::String>(RDKSHELL_THUNDER_TIMEOUT, "url",urlString);
 
-                                stateArray.Add(typeObject);
-                            }
+                        JsonObject typeObject;
+                        typeObject["callsign"] = callsign;
+                        typeObject["state"] = stateString.Value();
+                        if (urlStatus == 0)
+                        {
+                            typeObject["uri"] = urlString.Value();
+                        }
+                        else
+                        {
+                            typeObject["uri"] = "";
+                        }
+                        gExitReasonMutex.lock();
+                        if (gApplicationsExitReason.find(callsign) != gApplicationsExitReason.end())
+                        {
+                            typeObject["lastExitReason"] = (int)gApplicationsExitReason[callsign];
+                        }
+                        else
+                        {
+                            typeObject["lastExitReason"] = (int)AppLastExitReason::UNDEFINED;
                         }
+                        gExitReasonMutex.unlock();
+
+                        stateArray.Add(typeObject);
                     }
                 }
             }
@@ -4416,48 +4716,17 @@ namespace WPEFramework {
 
             JsonArray memoryInfo;
 
-            string method = "status";
-            Core::JSON::ArrayType<PluginHost::MetaData::Service> joResult;
-            auto thunderController = getThunderControllerClient();
-            uint32_t status = thunderController->Get<Core::JSON::ArrayType<PluginHost::MetaData::Service>>(RDKSHELL_THUNDER_TIMEOUT, method.c_str(), joResult);
-
-            /*std::cout << "DEACTIVATED: " << PluginHost::MetaData::Service::state::DEACTIVATED << std::endl;
-                    std::cout << "DEACTIVATION: " << PluginHost::MetaData::Service::state::DEACTIVATION << std::endl;
-                    std::cout << "ACTIVATED: " << PluginHost::MetaData::Service::state::ACTIVATED << std::endl;
-                    std::cout << "ACTIVATION: " << PluginHost::MetaData::Service::state::ACTIVATION << std::endl;
-                    std::cout << "DESTROYED: " << PluginHost::MetaData::Service::state::DESTROYED << std::endl;
-                    std::cout << "PRECONDITION: " << PluginHost::MetaData::Service::state::PRECONDITION << std::endl;
-                    std::cout << "SUSPENDED: " << PluginHost::MetaData::Service::state::SUSPENDED << std::endl;
-                    std::cout << "RESUMED: " << PluginHost::MetaData::Service::state::RESUMED << std::endl;*/
-
-            JsonArray stateArray;
-            for (uint16_t i = 0; i < joResult.Length(); i++)
+            for (const auto& plugin : gPluginStates.snapshot())
             {
-                PluginHost::MetaData::Service service = joResult[i];
-                if (service.JSONState != PluginHost::MetaData::Service::state::DEACTIVATED &&
-                    service.JSONState != PluginHost::MetaData::Service::state::DEACTIVATION &&
-                    service.JSONState != PluginHost::MetaData::Service::state::PRECONDITION)
+                if (PluginStateRegistry::isRunning(plugin.state) && !plugin.clientIdentifier.empty())
                 {
-                    std::string configLine;
-                    service.Configuration.ToString(configLine);
-                    if (!configLine.empty())
-                    {
-                        JsonObject serviceConfig = JsonObject(configLine.c_str());
-                        if (serviceConfig.HasLabel("clientidentifier"))
-                        {
-                            std::string callsign;
-                            service.Callsign.ToString(callsign);
-                            callsign.erase(std::remove(callsign.begin(),callsign.end(),'\"'),callsign.end());
-
-                            WPEFramework::Core::JSON::String stateString;
-                            const string callsignWithVersion = callsign + ".1";
-                            uint32_t stateStatus = getThunderControllerClient(callsignWithVersion)->Get<WPEFramework::Core::JSON::String>(RDKSHELL_THUNDER_TIMEOUT, "state", stateString);
+                    WPEFramework::Core::JSON::String stateString;
+                    const string callsignWithVersion = plugin.callsign + ".1";
+                    uint32_t stateStatus = getThunderControllerClient(callsignWithVersion)->Get<WPEFramework::Core::JSON::String>(RDKSHELL_THUNDER_TIMEOUT, "state", stateString);
 
-                            if (stateStatus == 0)
-                            {
-                                result = pluginMemoryUsage(callsign, memoryInfo);
-                            }
-                        }
+                    if (stateStatus == 0)
+                    {
+                        result = pluginMemoryUsage(plugin.callsign, memoryInfo);
                     }
                 }
             }
@@ -5405,6 +5674,65 @@ namespace WPEFramework {
             returnResponse(result);
         }
 
+        uint32_t RDKShell::getLaunchMetricsWrapper(const JsonObject& parameters, JsonObject& response)
+        {
+            LOGINFOMETHOD();
+            bool result = true;
+            response["enabled"] = gLaunchMetrics.enabled();
+
+            JsonArray types;
+            std::vector<LaunchMetrics::TypeMetrics> metrics = gLaunchMetrics.snapshot();
+            for (const auto& typeMetrics : metrics)
+            {
+                JsonObject phases;
+                for (int phase = 0; phase < LaunchMetrics::PHASE_COUNT; phase++)
+                {
+                    const LatencyHistogram& histogram = typeMetrics.phases[phase];
+                    if (histogram.count == 0)
+                    {
+                        continue;
+                    }
+                    JsonObject phaseMetrics;
+                    phaseMetrics["count"] = histogram.count;
+                    phaseMetrics["mean"] = (double)histogram.sumUs / histogram.count / 1000.0;
+                    phaseMetrics["min"] = histogram.minUs / 1000.0;
+                    phaseMetrics["max"] = histogram.maxUs / 1000.0;
+                    phaseMetrics["p50"] = histogram.percentileUs(50) / 1000.0;
+                    phaseMetrics["p90"] = histogram.percentileUs(90) / 1000.0;
+                    phaseMetrics["p99"] = histogram.percentileUs(99) / 1000.0;
+                    phases[LaunchMetrics::phaseName((LaunchMetrics::Phase)phase)] = phaseMetrics;
+                }
+                JsonObject typeObject;
+                typeObject["type"] = typeMetrics.type;
+                typeObject["phases"] = phases;
+                types.Add(typeObject);
+            }
+            response["types"] = types;
+
+            if (parameters.HasLabel("dumpTrace") && parameters["dumpTrace"].Boolean())
+            {
+                if (gLaunchTraceFile.empty())
+                {
+                    response["message"] = "launch trace is not enabled";
+                    result = false;
+                }
+                else if (!writeLaunchTrace(gLaunchTraceFile))
+                {
+                    response["message"] = "failed to write launch trace";
+                    result = false;
+                }
+                else
+                {
+                    response["traceFile"] = gLaunchTraceFile;
+                }
+            }
+            if (parameters.HasLabel("reset") && parameters["reset"].Boolean())
+            {
+                gLaunchMetrics.reset();
+            }
+            returnResponse(result);
+        }
+
         // Registered methods end
 
         // Events begin
@@ -6034,23 +6362,7 @@ namespace WPEFramework {
         bool RDKShell::setVisibility(const string& client, const bool visible)
         {
             bool ret = false;
-            {
-                bool lockAcquired = false;
-                double startTime = RdkShell::milliseconds();
-                while (!lockAcquired && (RdkShell::milliseconds() - startTime) < RDKSHELL_TRY_LOCK_WAIT_TIME_IN_MS)
-                {
-                    lockAcquired = gRdkShellMutex.try_lock();
-                }
-                if (!lockAcquired)
-                {
-                    std::cout << "unable to get lock for visibility, defaulting to normal lock\n";
-                    gRdkShellMutex.lock();
-                }
-                else
-                {
-                    std::cout << "lock was acquired via try for visibility\n";
-                }
-            }
+            lockRdkShellMutex();
             ret = CompositorController::setVisibility(client, visible);
             gRdkShellMutex.unlock();
             
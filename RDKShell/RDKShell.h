@@ -135,6 +135,7 @@ namespace WPEFramework {
             static const string RDKSHELL_METHOD_GET_EASTER_EGGS;
             static const string RDKSHELL_METHOD_GET_FRAME_RATE;
             static const string RDKSHELL_METHOD_SET_FRAME_RATE;
+            static const string RDKSHELL_METHOD_GET_LAUNCH_METRICS;
 
             // events
             static const string RDKSHELL_EVENT_ON_USER_INACTIVITY;
@@ -247,6 +248,7 @@ namespace WPEFramework {
             uint32_t getEasterEggsWrapper(const JsonObject& parameters, JsonObject& response);
 	          uint32_t getFrameRateWrapper(const JsonObject& parameters, JsonObject& response);
             uint32_t setFrameRateWrapper(const JsonObject& parameters, JsonObject& response);
+            uint32_t getLaunchMetricsWrapper(const JsonObject& parameters, JsonObject& response);
 
         private/*internal methods*/:
             RDKShell(const RDKShell&) = delete;
@@ -307,6 +309,8 @@ namespace WPEFramework {
             bool getVirtualDisplayEnabled(const std::string& client, bool &enabled);
             void loadStartupConfig();
             void invokeStartupThunderApis();
+            void loadPrewarmConfig();
+            bool prewarmApplication(const std::string& callsign, const std::string& type);
             int32_t subscribeForSystemEvent(std::string event);
             void onTimer();
 
@@ -56,6 +56,15 @@ namespace WPEFramework {
             ctrlm_network_id_t              rf4ceId = CTRLM_MAIN_NETWORK_ID_INVALID;
             IARM_Result_t                   res;
 
+            {
+                // Already resolved for the RIB transaction of this thread
+                std::lock_guard<std::mutex> guard(m_ribMutex);
+                if (m_transactionOpen && (m_transactionThread == std::this_thread::get_id()))
+                {
+                    return m_transactionNetworkId;
+                }
+            }
+
             memset((void*)&status, 0, sizeof(status));
             status.api_revision = CTRLM_MAIN_IARM_BUS_API_REVISION;
             res = IARM_Bus_Call(CTRLM_MAIN_IARM_BUS_NAME, CTRLM_MAIN_IARM_CALL_STATUS_GET, (void*)&status, sizeof(status));
@@ -86,6 +95,98 @@ namespace WPEFramework {
             return rf4ceId;
         }
 
+        bool RemoteActionMappingHelper::beginRibTransaction()
+        {
+            // Resolve the network once, for all the entries of the transaction
+            ctrlm_network_id_t rf4ceId = getRf4ceNetworkID();
+            if (rf4ceId == CTRLM_MAIN_NETWORK_ID_INVALID)
+            {
+                LOGERR("FAILURE - No RF4CE network_id found! Cannot begin RIB transaction!");
+                return false;
+            }
+
+            m_transactionMutex.lock();
+            std::lock_guard<std::mutex> guard(m_ribMutex);
+            m_transactionOpen = true;
+            m_transactionThread = std::this_thread::get_id();
+            m_transactionNetworkId = rf4ceId;
+            m_ribTransaction.clear();
+            return true;
+        }
+
+        bool RemoteActionMappingHelper::commitRibTransaction()
+        {
+            bool success;
+            size_t queued;
+            int written = 0;
+
+            {
+                std::lock_guard<std::mutex> guard(m_ribMutex);
+                if (!m_transactionOpen || (m_transactionThread != std::this_thread::get_id()))
+                {
+                    LOGERR("LOGIC ERROR - no RIB transaction open on this thread!!");
+                    return false;
+                }
+                m_transactionOpen = false;
+
+                queued = m_ribTransaction.size();
+                success = m_ribTransaction.commit(m_ribShadow,
+                    [this](ctrlm_rcu_iarm_call_rib_request_t& ribRequest) { return writeRib(ribRequest); }, &written);
+            }
+            m_transactionMutex.unlock();
+
+            LOGWARN("RIB transaction: %d entries queued, %d written, %s.", (int)queued, written, (success ? "success" : "FAILURE"));
+            return success;
+        }
+
+        void RemoteActionMappingHelper::forgetRibShadow(int deviceID)
+        {
+            std::lock_guard<std::mutex> guard(m_ribMutex);
+            m_ribShadow.forget(deviceID);
+        }
+
+        bool RemoteActionMappingHelper::setRib(ctrlm_rcu_iarm_call_rib_request_t& ribRequest)
+        {
+            std::lock_guard<std::mutex> guard(m_ribMutex);
+            if (m_transactionOpen && (m_transactionThread == std::this_thread::get_id()))
+            {
+                m_ribTransaction.set(ribRequest);
+                return true;
+            }
+
+            if (writeRib(ribRequest))
+            {
+                m_ribShadow.store(ribRequest);
+                return true;
+            }
+            m_ribShadow.erase(ribRequest);
+            return false;
+        }
+
+        bool RemoteActionMappingHelper::writeRib(ctrlm_rcu_iarm_call_rib_request_t& ribRequest)
+        {
+            IARM_Result_t res;
+
+            res = IARM_Bus_Call(CTRLM_MAIN_IARM_BUS_NAME, CTRLM_RCU_IARM_CALL_RIB_REQUEST_SET, (void *)&ribRequest, sizeof(ribRequest));
+            if (res != IARM_RESULT_SUCCESS)
+            {
+                LOGERR("FAILURE in bus call RIB_REQUEST_SET! return value: %d.\n", res);
+                return false;
+            }
+
+            LOGWARN("Set RIB IR-RF DB Request: controller_id: %u, network_id: 0x%02X, "
+                    "attribute_id: 0x%02X, attribute_index: 0x%02X, result: %u, length: %u, data[0]: 0x%02X.",
+                    ribRequest.controller_id, ribRequest.network_id, (unsigned char)ribRequest.attribute_id,
+                    ribRequest.attribute_index, ribRequest.result, ribRequest.length, (unsigned char)ribRequest.data[0]);
+            if (ribRequest.result != CTRLM_IARM_CALL_RESULT_SUCCESS)
+            {
+                LOGERR("FAILURE result in SET ribRequest! result: %d.\n", ribRequest.result);
+                return false;
+            }
+
+            return true;
+        }
+
         bool RemoteActionMappingHelper::getRf4ceBindRemotes(rf4ceBindRemotes_t* bindRemotes)
         {
             ctrlm_main_iarm_call_network_status_t   netStatus;
@@ -314,6 +415,12 @@ namespace WPEFramework {
 
                     remoteType = std::string(ctrlStatus.status.type);
 
+                    {
+                        // A remote paired again starts with a fresh RIB
+                        std::lock_guard<std::mutex> guard(m_ribMutex);
+                        m_ribShadow.binding(deviceID, (unsigned long)ctrlStatus.status.time_binding);
+                    }
+
                     // Set the booleans concerning 5-digit codes.
                     bFiveDigitCodeSet = (ctrlStatus.status.ir_db_state == CTRLM_RCU_IR_DB_STATE_TV_CODE) ||
                                         (ctrlStatus.status.ir_db_state == CTRLM_RCU_IR_DB_STATE_AVR_CODE) ||
@@ -338,7 +445,6 @@ namespace WPEFramework {
             UNUSED(keymapType);
             ctrlm_rcu_iarm_call_rib_request_t   ribRequest;
             ctrlm_network_id_t                  rf4ceId;
-            IARM_Result_t                       res;
             int             deviceType = -1;    // 0 is TV, 1 is AVR, -1 is none.
             int             dataSize = 0;
             unsigned char*  data = NULL;
@@ -646,30 +752,13 @@ namespace WPEFramework {
                     (unsigned char)ribRequest.data[12], (unsigned char)ribRequest.data[13], (unsigned char)ribRequest.data[14], (unsigned char)ribRequest.data[15],
                     (unsigned char)ribRequest.data[16], (unsigned char)ribRequest.data[17], (unsigned char)ribRequest.data[18], (unsigned char)ribRequest.data[19]);
 
-            // Do the direct write to the IR-RF DB RIB entry.
-            res = IARM_Bus_Call(CTRLM_MAIN_IARM_BUS_NAME, CTRLM_RCU_IARM_CALL_RIB_REQUEST_SET, (void *)&ribRequest, sizeof(ribRequest));
-            if (res == IARM_RESULT_SUCCESS)
+            // Write the IR-RF DB RIB entry, or queue it within a RIB transaction.
+            if (!setRib(ribRequest))
             {
-                LOGWARN("Set RIB IR-RF DB Request: controller_id: %u, network_id: 0x%02X, "
-                        "attribute_id: 0x%02X, attribute_index: 0x%02X, result: %u, length: %u, data[0]: 0x%02X.",
-                        ribRequest.controller_id, ribRequest.network_id, (unsigned char)ribRequest.attribute_id,
-                        ribRequest.attribute_index, ribRequest.result, ribRequest.length, (unsigned char)ribRequest.data[0]);
-                if (ribRequest.result == CTRLM_IARM_CALL_RESULT_SUCCESS)
-                {
-                    LOGWARN("%s: map set for keyName: 0x%02X, rfKeyCode: 0x%02X, %s IrCode size: %d.\n", __FUNCTION__,
-                               actionMap.keyName, actionMap.rfKeyCode, ((deviceType == 1) ? "AVR" : "TV"), dataSize);
-                }
-                else
-                {
-                    LOGERR("FAILURE result in SET ribRequest! result: %d.\n", ribRequest.result);
-                    return false;
-                }
-            }
-            else
-            {
-                LOGERR("FAILURE in bus call RIB_REQUEST_SET! return value: %d.\n", res);
                 return false;
             }
+            LOGWARN("%s: map set for keyName: 0x%02X, rfKeyCode: 0x%02X, %s IrCode size: %d.\n", __FUNCTION__,
+                       actionMap.keyName, actionMap.rfKeyCode, ((deviceType == 1) ? "AVR" : "TV"), dataSize);
 
             return true;
         }   // end of setKeyActionMap()
@@ -834,7 +923,6 @@ namespace WPEFramework {
             UNUSED(keymapType);
             ctrlm_rcu_iarm_call_rib_request_t   ribRequest;
             ctrlm_network_id_t                  rf4ceId;
-            IARM_Result_t                       res;
             int             rfKey = lookupRFKey(keyName);
             unsigned char   flags = MSO_RIB_IRRFDB_PERMANENT_BIT | MSO_RIB_IRRFDB_DEFAULT_BIT;
 
@@ -860,29 +948,12 @@ namespace WPEFramework {
             ribRequest.length           = 1 + 2 + CONTROLMGR_MAX_IR_DATA_SIZE;
             ribRequest.data[0]          = flags;
 
-            // Direct write to the RIB IRRFDB entry for this RF key.
-            res = IARM_Bus_Call(CTRLM_MAIN_IARM_BUS_NAME, CTRLM_RCU_IARM_CALL_RIB_REQUEST_SET, (void *)&ribRequest, sizeof(ribRequest));
-            if (res == IARM_RESULT_SUCCESS)
+            // Write the RIB IRRFDB entry for this RF key, or queue it within a RIB transaction.
+            if (!setRib(ribRequest))
             {
-                LOGWARN("Wrote RIB IR-RF Database: controller_id: %u, network_id: 0x%02X, "
-                        "attribute_id: 0x%02X, attribute_index: 0x%02X, result: %u, length: %u, data[0]: 0x%02X.",
-                        ribRequest.controller_id, ribRequest.network_id, (unsigned char)ribRequest.attribute_id,
-                        ribRequest.attribute_index, ribRequest.result, ribRequest.length, (unsigned char)ribRequest.data[0]);
-                if (ribRequest.result == CTRLM_IARM_CALL_RESULT_SUCCESS)
-                {
-                    LOGWARN("Successfully cleared RIB IRRFDB entry for RF key 0x%02X.\n", (unsigned)rfKey);
-                }
-                else
-                {
-                    LOGERR("FAILURE result in SET ribRequest! status: %d.\n", ribRequest.result);
-                    return false;
-                }
-            }
-            else
-            {
-                LOGERR("FAILURE in bus call RIB_REQUEST_SET! return value: %d.\n", res);
                 return false;
             }
+            LOGWARN("Successfully cleared RIB IRRFDB entry for RF key 0x%02X.\n", (unsigned)rfKey);
 
             // If we are clearing a power entry, clear the corresponding separate "device" power entry, too.
             if ((rfKey == MSO_RFKEY_PWR_TOGGLE) ||
@@ -1023,7 +1094,6 @@ namespace WPEFramework {
             UNUSED(keymapType);
             ctrlm_rcu_iarm_call_rib_request_t   ribRequest;
             ctrlm_network_id_t                  rf4ceId;
-            IARM_Result_t                       res;
             int             dataSize = irData.size();
             unsigned char*  data = irData.data();
             unsigned char   flags = MSO_RIB_IRRFDB_PERMANENT_BIT | MSO_RIB_IRRFDB_IRSPECIFIED_BIT;
@@ -1143,30 +1213,13 @@ namespace WPEFramework {
             bytePtr++;
             memcpy(bytePtr, data, dataSize);
 
-            // Do the direct write to the IR-RF DB RIB entry.
-            res = IARM_Bus_Call(CTRLM_MAIN_IARM_BUS_NAME, CTRLM_RCU_IARM_CALL_RIB_REQUEST_SET, (void *)&ribRequest, sizeof(ribRequest));
-            if (res == IARM_RESULT_SUCCESS)
+            // Write the IR-RF DB RIB entry, or queue it within a RIB transaction.
+            if (!setRib(ribRequest))
             {
-                LOGWARN("Set RIB IR-RF DB Request: controller_id: %u, network_id: 0x%02X, "
-                        "attribute_id: 0x%02X, attribute_index: 0x%02X, result: %u, length: %u, data[0]: 0x%02X.",
-                        ribRequest.controller_id, ribRequest.network_id, (unsigned char)ribRequest.attribute_id,
-                        ribRequest.attribute_index, ribRequest.result, ribRequest.length, (unsigned char)ribRequest.data[0]);
-                if (ribRequest.result == CTRLM_IARM_CALL_RESULT_SUCCESS)
-                {
-                    LOGWARN("separate map set for rfKeyCode: 0x%02X, IrCode size: %d.\n",
-                            (unsigned)rfKeyCode, dataSize);
-                }
-                else
-                {
-                    LOGERR("FAILURE result in SET ribRequest! result: %d.\n", ribRequest.result);
-                    return false;
-                }
-            }
-            else
-            {
-                LOGERR("FAILURE in bus call RIB_REQUEST_SET! return value: %d.\n", res);
                 return false;
             }
+            LOGWARN("separate map set for rfKeyCode: 0x%02X, IrCode size: %d.\n",
+                    (unsigned)rfKeyCode, dataSize);
 
             return true;
         }   // end of setRIBDevicePower()
@@ -1176,7 +1229,6 @@ namespace WPEFramework {
             UNUSED(keymapType);
             ctrlm_rcu_iarm_call_rib_request_t   ribRequest;
             ctrlm_network_id_t                  rf4ceId;
-            IARM_Result_t                       res;
             unsigned char   flags = MSO_RIB_IRRFDB_PERMANENT_BIT | MSO_RIB_IRRFDB_DEFAULT_BIT;
 
             if ((deviceID < 1) || (rfKeyCode <= 0))
@@ -1212,29 +1264,12 @@ namespace WPEFramework {
             ribRequest.length           = 1 + 2 + CONTROLMGR_MAX_IR_DATA_SIZE;
             ribRequest.data[0]          = flags;
 
-            // Direct write to the RIB IRRFDB entry for this RF key.
-            res = IARM_Bus_Call(CTRLM_MAIN_IARM_BUS_NAME, CTRLM_RCU_IARM_CALL_RIB_REQUEST_SET, (void *)&ribRequest, sizeof(ribRequest));
-            if (res == IARM_RESULT_SUCCESS)
+            // Write the RIB IRRFDB entry for this RF key, or queue it within a RIB transaction.
+            if (!setRib(ribRequest))
             {
-                LOGWARN("Wrote RIB IR-RF Database: controller_id: %u, network_id: 0x%02X, "
-                        "attribute_id: 0x%02X, attribute_index: 0x%02X, result: %u, length: %u, data[0]: 0x%02X.",
-                        ribRequest.controller_id, ribRequest.network_id, (unsigned char)ribRequest.attribute_id,
-                        ribRequest.attribute_index, ribRequest.result, ribRequest.length, (unsigned char)ribRequest.data[0]);
-                if (ribRequest.result == CTRLM_IARM_CALL_RESULT_SUCCESS)
-                {
-                    LOGWARN("Successfully cleared separate power slot for rfKeyCode 0x%02X.\n", (unsigned)rfKeyCode);
-                }
-                else
-                {
-                    LOGERR("FAILURE result in SET ribRequest! status: %d.\n", ribRequest.result);
-                    return false;
-                }
-            }
-            else
-            {
-                LOGERR("FAILURE in bus call RIB_REQUEST_SET! return value: %d.\n", res);
                 return false;
             }
+            LOGWARN("Successfully cleared separate power slot for rfKeyCode 0x%02X.\n", (unsigned)rfKeyCode);
 
             return true;
         }   // end of clearRIBDevicePower
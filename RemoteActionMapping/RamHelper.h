@@ -25,10 +25,13 @@
 #include "ctrlm_ipc.h"
 #include "ctrlm_ipc_rcu.h"
 
+#include <mutex>
 #include <string>
+#include <thread>
 #include <vector>
 
 #include "comcastIrKeyCodes.h"
+#include "RibTransaction.h"
 
 typedef std::vector<unsigned char>  byte_vector_t;
 typedef std::vector<int>            int_vector_t;
@@ -298,11 +301,31 @@ namespace WPEFramework {
             bool setDevicePower(int deviceID, int keymapType, keyActionMap& actionMap);
             bool clearDevicePower(int deviceID, int keymapType, int rfKeyCode);
 
+            // Between these, the IRRFDB writes of setKeyActionMap, clearKeyActionMap and the device power
+            // methods of this thread are queued, and written once each on commit.  Their return values
+            // then only tell whether the entry could be built.
+            bool beginRibTransaction(void);
+            bool commitRibTransaction(void);
+            // The controller changed its own RIB, what was written to it is no longer known
+            void forgetRibShadow(int deviceID);
+
         private:
             ctrlm_network_id_t getRf4ceNetworkID(void);
+            bool setRib(ctrlm_rcu_iarm_call_rib_request_t& ribRequest);
+            bool writeRib(ctrlm_rcu_iarm_call_rib_request_t& ribRequest);
             bool getRf4ceBindRemotes(rf4ceBindRemotes_t* bindRemotes);
             bool setRIBDevicePower(int deviceID, int keymapType, int rfKeyCode, byte_vector_t& irData);
             bool clearRIBDevicePower(int deviceID, int keymapType, int rfKeyCode);
+
+            // Held from beginRibTransaction() to commitRibTransaction(), one transaction at a time
+            std::mutex          m_transactionMutex;
+            // Guards the members below
+            std::mutex          m_ribMutex;
+            bool                m_transactionOpen = false;
+            std::thread::id     m_transactionThread;
+            ctrlm_network_id_t  m_transactionNetworkId = CTRLM_MAIN_NETWORK_ID_INVALID;
+            RibTransaction<ctrlm_rcu_iarm_call_rib_request_t>   m_ribTransaction;
+            RibShadow<ctrlm_rcu_iarm_call_rib_request_t>        m_ribShadow;
         };
 
     } // namespace Plugin
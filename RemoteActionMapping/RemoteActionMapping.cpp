@@ -180,6 +180,12 @@ namespace WPEFramework {
                             LOGINFO("RIB Access Event: network_id: %u, controller_id: %d, identifier: 0x%02X, index: 0x%02X, access_type: %s.",
                                     networkId, remoteId, attrId, index, ((accessType > 1) ? "INVALID" : ((accessType == 0) ? "READ" : "WRITE")));
 
+                            if (accessType == CTRLM_ACCESS_TYPE_WRITE)
+                            {
+                                // The remote changed its RIB, don't trust what we last wrote there
+                                m_helper.forgetRibShadow(remoteId);
+                            }
+
                             std::lock_guard<std::mutex> guard(m_stateMutex);
 
                             if (m_ramsOperatingMode == RAMS_OP_MODE_IRRF_DATABASE)
@@ -1413,6 +1419,13 @@ namespace WPEFramework {
                 }
             }
 
+            // Queue the writes of all the keys, so each RIB entry is written once, and only if it changed.
+            if (!m_helper.beginRibTransaction())
+            {
+                LOGERR("ERROR - can't begin RIB transaction for deviceID: %d.", deviceID);
+                return false;
+            }
+
             // For every one of the original 7 keys, either set the RIB entry from the ActionMap, or clear the RIB entry.
             // Use any power-related actionMaps that we got to independently set or clear the separate power RIB entries.
             for (int i = 0; i < supported_ked_keynames_size; i++)
@@ -1517,6 +1530,12 @@ namespace WPEFramework {
                 }
             }
 
+            if (!m_helper.commitRibTransaction())
+            {
+                LOGERR("ERROR - RIB transaction failure for deviceID: %d.", deviceID);
+                success = false;
+            }
+
             if (success)
             {
                 {
@@ -1555,6 +1574,13 @@ namespace WPEFramework {
                 return result;
             }
 
+            // Queue the clears of all the keys, so each RIB entry is written once, and only if it changed.
+            if (!m_helper.beginRibTransaction())
+            {
+                LOGERR("ERROR - can't begin RIB transaction for deviceID: %d.", deviceID);
+                return result;
+            }
+
             for (int i = 0; i < numNames; i++)
             {
                 rfKeyCode = m_helper.lookupRFKey(keyNames[i]);
@@ -1571,6 +1597,13 @@ namespace WPEFramework {
                 }
             }
 
+            // Written even after a failure above, as the per key clears were
+            if (!m_helper.commitRibTransaction())
+            {
+                LOGERR("ERROR - RIB transaction failure for deviceID: %d.", deviceID);
+                result = false;
+            }
+
             if (result)
             {
                 // Set up state machine
@@ -0,0 +1,179 @@
+/**
+* If not stated otherwise in this file or this component's LICENSE
+* file the following copyright and licenses apply:
+*
+* Copyright 2019 RDK Management
+*
+* Licensed under the Apache License, Version 2.0 (the "License");
+* you may not use this file except in compliance with the License.
+* You may obtain a copy of the License at
+*
+* http://www.apache.org/licenses/LICENSE-2.0
+*
+* Unless required by applicable law or agreed to in writing, software
+* distributed under the License is distributed on an "AS IS" BASIS,
+* WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+* See the License for the specific language governing permissions and
+* limitations under the License.
+**/
+
+#pragma once
+
+#include <string.h>
+#include <functional>
+#include <map>
+#include <tuple>
+#include <utility>
+#include <vector>
+
+namespace WPEFramework {
+
+    namespace Plugin {
+
+        // RIB entries as last written to ControlMgr, per controller, so that writing
+        // the same key map again does not repeat the RIB_REQUEST_SET of every key.
+        // Only controllers whose binding time is known are tracked: a remote that is
+        // paired again starts with a fresh RIB, and its entries are forgotten.
+        template <typename RIB_REQUEST>
+        class RibShadow
+        {
+        public:
+            void binding(int controllerId, unsigned long timeBinding)
+            {
+                auto it = m_controllers.find(controllerId);
+                if ((it == m_controllers.end()) || (it->second.timeBinding != timeBinding))
+                {
+                    Controller& controller = m_controllers[controllerId];
+                    controller.timeBinding = timeBinding;
+                    controller.entries.clear();
+                }
+            }
+
+            void forget(int controllerId)
+            {
+                m_controllers.erase(controllerId);
+            }
+
+            bool matches(const RIB_REQUEST& request) const
+            {
+                auto controller = m_controllers.find(request.controller_id);
+                if (controller == m_controllers.end())
+                {
+                    return false;
+                }
+                auto entry = controller->second.entries.find(std::make_pair((int)request.attribute_id, (int)request.attribute_index));
+                return (entry != controller->second.entries.end()) &&
+                       (entry->second.size() == (size_t)request.length) &&
+                       (memcmp(entry->second.data(), request.data, request.length) == 0);
+            }
+
+            void store(const RIB_REQUEST& request)
+            {
+                auto controller = m_controllers.find(request.controller_id);
+                if (controller != m_controllers.end())
+                {
+                    const unsigned char* data = (const unsigned char*)request.data;
+                    controller->second.entries[std::make_pair((int)request.attribute_id, (int)request.attribute_index)] =
+                        std::vector<unsigned char>(data, data + request.length);
+                }
+            }
+
+            // A write that failed leaves the entry unknown
+            void erase(const RIB_REQUEST& request)
+            {
+                auto controller = m_controllers.find(request.controller_id);
+                if (controller != m_controllers.end())
+                {
+                    controller->second.entries.erase(std::make_pair((int)request.attribute_id, (int)request.attribute_index));
+                }
+            }
+
+        private:
+            struct Controller
+            {
+                unsigned long timeBinding;
+                std::map<std::pair<int, int>, std::vector<unsigned char>> entries;
+            };
+
+            std::map<int, Controller> m_controllers;
+        };
+
+        // RIB_REQUEST_SETs queued while a whole key map is written. ControlMgr has no
+        // call that sets several entries at once, so the commit still does one call per
+        // entry, but an entry written twice (e.g. a power slot cleared and then set
+        // again) is only written with its last value, and entries the shadow says
+        // ControlMgr already holds are not written at all.
+        template <typename RIB_REQUEST>
+        class RibTransaction
+        {
+        public:
+            typedef std::function<bool(RIB_REQUEST&)> Writer;
+
+            void set(const RIB_REQUEST& request)
+            {
+                Key key(request.controller_id, request.attribute_id, request.attribute_index);
+                auto it = m_index.find(key);
+                if (it != m_index.end())
+                {
+                    m_requests[it->second] = request;
+                }
+                else
+                {
+                    m_index[key] = m_requests.size();
+                    m_requests.push_back(request);
+                }
+            }
+
+            size_t size() const
+            {
+                return m_requests.size();
+            }
+
+            void clear()
+            {
+                m_requests.clear();
+                m_index.clear();
+            }
+
+            // Writes the queued entries in the order they were first queued. Goes on
+            // after a failed write, like the per key calls did, and returns false if any
+            // failed. Leaves the transaction empty.
+            bool commit(RibShadow<RIB_REQUEST>& shadow, const Writer& writer, int* written = NULL)
+            {
+                bool success = true;
+                int count = 0;
+                for (auto& request : m_requests)
+                {
+                    if (shadow.matches(request))
+                    {
+                        continue;
+                    }
+                    count++;
+                    if (writer(request))
+                    {
+                        shadow.store(request);
+                    }
+                    else
+                    {
+                        shadow.erase(request);
+                        success = false;
+                    }
+                }
+                clear();
+                if (written != NULL)
+                {
+                    *written = count;
+                }
+                return success;
+            }
+
+        private:
+            typedef std::tuple<int, int, int> Key;
+
+            std::vector<RIB_REQUEST> m_requests;
+            std::map<Key, size_t> m_index;
+        };
+
+    } // namespace Plugin
+
+} // namespace WPEFramework
@@ -3,7 +3,9 @@
 #include <gst/app/gstappsrc.h>
 
 #include <cmath>
-#define AUDIO_GST_FRAGMENT_MAX_SIZE     (128 * 1024)
+#define AUDIO_POOL_BLOCK_SIZE           (16 * 1024)
+#define AUDIO_POOL_MAX_BLOCKS           64
+#define AUDIO_QUEUE_SIZE                1024
 #define PLAYBACK_STARTED "PLAYBACK_STARTED"
 #define PLAYBACK_FINISHED "PLAYBACK_FINISHED"
 #define PLAYBACK_PAUSED "PLAYBACK_PAUSED"
@@ -34,7 +36,8 @@ AudioPlayer::AudioPlayer(AudioType audioType,SourceType sourceType,PlayMode play
         m_running = true;
         appsrc_firstpacket = true;
         webClient = NULL;
-        bufferQueue = new BufferQueue(1000);
+        bufferPool = new BufferPool(AUDIO_POOL_BLOCK_SIZE, AUDIO_POOL_MAX_BLOCKS);
+        bufferQueue = new BufferQueue(AUDIO_QUEUE_SIZE);
         m_thread= new std::thread(&AudioPlayer::PushDataAppSrc, this);
     }
 
@@ -79,6 +82,11 @@ AudioPlayer::~AudioPlayer()
     }  
     gst_element_set_state (m_pipeline, GST_STATE_NULL);
     gst_object_unref (m_pipeline);  
+    if(sourceType == DATA || sourceType == WEBSOCKET)
+    {
+        // Blocks still referenced by GStreamer keep the pool alive
+        bufferPool->unref();
+    }
 }
 
 void AudioPlayer::Init(SAPEventCallback *callback)
@@ -397,7 +405,6 @@ gboolean AudioPlayer::PushDataAppSrc()
                  }
              }
         }
-        size_t maxBytes = AUDIO_GST_FRAGMENT_MAX_SIZE;
         //package should be played as soon as it arrived
         //GstClockTime pts = 0;
         //GstClockTime dts = 0;
@@ -406,47 +413,30 @@ gboolean AudioPlayer::PushDataAppSrc()
 	{
             continue;		
 	}
-        int length = buffer->getLength();
-        char *ptr = buffer->getBuffer();
-
-        while(length != 0)
-        {               
-            int lenToSend = length;
-        
-            if(lenToSend > maxBytes)
-            {
-                lenToSend = maxBytes;
-            }
-     
-            GstBuffer *gbuffer = gst_buffer_new_and_alloc((guint)lenToSend);
-            GstMapInfo map;
-            gst_buffer_map(gbuffer, &map, GST_MAP_WRITE);
-            memcpy(map.data,ptr,lenToSend);
-            gst_buffer_unmap(gbuffer, &map);
-            //GST_BUFFER_PTS(gbuffer) = pts;
-            //GST_BUFFER_DTS(gbuffer) = dts;
-            //GstFlowReturn ret = gst_app_src_push_buffer(GST_APP_SRC(player->m_source), gbuffer);
-            GstFlowReturn ret;
-            g_signal_emit_by_name (m_source, "push-buffer", gbuffer, &ret);
-
-            gst_buffer_unref (gbuffer);
-
-            if (ret != GST_FLOW_OK)
-            {
-	        SAPLOG_WARNING("SAP: appsrc not accepting buffer\n");
-            }
-            if(appsrc_firstpacket)
-            {
-                appsrc_firstpacket = false;
-                m_callback->onSAPEvent(getObjectIdentifier(),PLAYBACK_STARTED);
-                setPrimaryVolume(m_primVolume);
-                setVolume(m_thisVolume);
-            }
-            ptr = lenToSend + (char *)ptr;
-            length -= lenToSend;
+
+        // Hand the pool block itself to GStreamer, it goes back to the pool
+        // when the last reference to the GstBuffer is dropped
+        GstBuffer *gbuffer = gst_buffer_new_wrapped_full(GST_MEMORY_FLAG_READONLY, buffer->getBuffer(),
+                                 buffer->getCapacity(), 0, buffer->getLength(), buffer, releaseBuffer);
+        //GST_BUFFER_PTS(gbuffer) = pts;
+        //GST_BUFFER_DTS(gbuffer) = dts;
+        //GstFlowReturn ret = gst_app_src_push_buffer(GST_APP_SRC(player->m_source), gbuffer);
+        GstFlowReturn ret;
+        g_signal_emit_by_name (m_source, "push-buffer", gbuffer, &ret);
+
+        gst_buffer_unref (gbuffer);
+
+        if (ret != GST_FLOW_OK)
+        {
+	    SAPLOG_WARNING("SAP: appsrc not accepting buffer\n");
+        }
+        if(appsrc_firstpacket)
+        {
+            appsrc_firstpacket = false;
+            m_callback->onSAPEvent(getObjectIdentifier(),PLAYBACK_STARTED);
+            setPrimaryVolume(m_primVolume);
+            setVolume(m_thisVolume);
         }
-        buffer->deleteBuffer();
-	delete buffer;        
     }
    
 }
@@ -465,13 +455,30 @@ void AudioPlayer::wsConnectionStatus(WSStatus status)
     } 
 }
 
+void AudioPlayer::releaseBuffer(gpointer data)
+{
+    static_cast<Buffer*>(data)->release();
+}
+
 void AudioPlayer::push_data(const void *ptr,int length)
 {
-    if(!bufferQueue->isFull())
+    const char *data = static_cast<const char*>(ptr);
+    while(length > 0)
     {
-	Buffer *buffer = new Buffer();
-        buffer->fillBuffer(ptr,length);
-        bufferQueue->add(buffer);
+        if(bufferQueue->isFull())
+        {
+            SAPLOG_WARNING("SAP: buffer queue full, dropping %d bytes\n",length);
+            break;
+        }
+        Buffer *buffer = bufferPool->acquire();
+        buffer->fillBuffer(data,length);
+        data += buffer->getLength();
+        length -= buffer->getLength();
+        if(!bufferQueue->add(buffer))
+        {
+            buffer->release();
+            break;
+        }
     }
 }
 
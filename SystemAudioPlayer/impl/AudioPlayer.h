@@ -98,6 +98,7 @@ class AudioPlayer
     };
 #endif
     WebSocketClient *webClient;
+    BufferPool *bufferPool;
     BufferQueue *bufferQueue;
     GstElement  *m_source;
     AudioType audioType;
@@ -121,6 +122,7 @@ class AudioPlayer
     void setPrimaryVolume( int Vol);
     bool waitForStatus(GstState expected_state, uint32_t timeout_ms);
     GstCaps * getPCMAudioCaps( const std::string format, int rate, int channels, const std::string layout);
+    static void releaseBuffer(gpointer data);
 
     public:
     AudioPlayer() {}
@@ -3,9 +3,9 @@
 
 void Buffer::fillBuffer(const void *ptr,int len)
 {
-    this->length = len;
-    buff = new char[length];
+    this->length = (len < capacity) ? len : capacity;
     std::memcpy(buff,ptr,length);
+    pool->m_copiedBytes += length;
 }
 
 int Buffer::getLength()
@@ -13,112 +13,217 @@ int Buffer::getLength()
     return length;
 }
 
+int Buffer::getCapacity()
+{
+    return capacity;
+}
+
 char* Buffer::getBuffer()
 {
     return buff;
 }
 
-void Buffer::deleteBuffer()
-{  
-    SAPLOG_TRACE("SAP: delete Buffer..."); 
-    if(buff != NULL)
+void Buffer::release()
+{
+    pool->release(this);
+}
+
+BufferPool::BufferPool(int blockSize, int maxPooled)
+    : m_blockSize(blockSize)
+    , m_maxPooled(maxPooled)
+    , m_refs(1)
+    , m_allocations(0)
+    , m_copiedBytes(0)
+{
+    m_free.reserve(maxPooled);
+}
+
+BufferPool::~BufferPool()
+{
+    SAPLOG_INFO("SAP: buffer pool allocated %llu blocks, copied %llu bytes\n",
+        (unsigned long long)m_allocations, (unsigned long long)m_copiedBytes);
+    for (Buffer *buffer : m_free)
+    {
+        delete[] buffer->buff;
+        delete buffer;
+    }
+}
+
+Buffer* BufferPool::acquire()
+{
+    Buffer *buffer = NULL;
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        if (!m_free.empty())
+        {
+            buffer = m_free.back();
+            m_free.pop_back();
+        }
+    }
+
+    if (buffer == NULL)
+    {
+        buffer = new Buffer();
+        buffer->buff = new char[m_blockSize];
+        buffer->capacity = m_blockSize;
+        buffer->pool = this;
+        m_allocations++;
+    }
+    buffer->length = 0;
+    ref();
+    return buffer;
+}
+
+void BufferPool::release(Buffer *buffer)
+{
+    bool pooled = false;
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        if ((int)m_free.size() < m_maxPooled)
+        {
+            m_free.push_back(buffer);
+            pooled = true;
+        }
+    }
+
+    if (!pooled)
+    {
+        delete[] buffer->buff;
+        delete buffer;
+    }
+    unref();
+}
+
+void BufferPool::ref()
+{
+    m_refs++;
+}
+
+void BufferPool::unref()
+{
+    if (--m_refs == 0)
     {
-       delete[] buff;
-       buff = NULL;
+        delete this;
     }
 }
 
+int BufferPool::blockSize()
+{
+    return m_blockSize;
+}
+
+uint64_t BufferPool::allocations()
+{
+    return m_allocations;
+}
+
+uint64_t BufferPool::copiedBytes()
+{
+    return m_copiedBytes;
+}
+
 BufferQueue::BufferQueue(int size)
+    : m_head(0)
+    , m_tail(0)
+    , m_discardBefore(0)
+    , m_waiting(false)
+    , m_exit(false)
 {
-    pthread_mutex_init(&m_mutex, NULL);
-    sem_init(&m_sem_full,0,0);
-    sem_init(&m_sem_empty,0,size);
+    size_t capacity = 1;
+    while (capacity < (size_t)size)
+    {
+        capacity <<= 1;
+    }
+    m_ring.resize(capacity, NULL);
+    m_mask = capacity - 1;
 }
 
 BufferQueue::~BufferQueue()
 {
-    pthread_mutex_destroy(&m_mutex);
-    sem_destroy(&m_sem_empty);
-    sem_destroy(&m_sem_full);
+    // The consumer is gone, release whatever it did not get to
+    size_t tail = m_tail.load();
+    for (size_t head = m_head.load(); head != tail; head++)
+    {
+        m_ring[head & m_mask]->release();
+    }
 }
+
 void BufferQueue::preDelete()
 {
     clear();
-    sem_post(&m_sem_full);           
+    m_exit = true;
+    std::lock_guard<std::mutex> lock(m_mutex);
+    m_cond.notify_one();
 }
 
-void BufferQueue::add(Buffer *data)
+bool BufferQueue::add(Buffer *data)
 {
-    sem_wait(&m_sem_empty);
-    pthread_mutex_lock(&m_mutex);
-    m_buffer.push(data);
-    sem_post(&m_sem_full);
-    pthread_mutex_unlock(&m_mutex);
+    size_t tail = m_tail.load(std::memory_order_relaxed);
+    if (tail - m_head.load(std::memory_order_acquire) > m_mask)
+    {
+        return false;
+    }
+
+    m_ring[tail & m_mask] = data;
+    m_tail.store(tail + 1);
+
+    if (m_waiting.load())
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        m_cond.notify_one();
+    }
+    return true;
 }
 
 int BufferQueue::count()
 {
-    int count;
-    pthread_mutex_lock(&m_mutex);
-    //count = m_buffer.size();
-    sem_getvalue(&m_sem_full,&count); 
-    pthread_mutex_unlock(&m_mutex);
-    return count;
+    size_t head = m_head.load();
+    size_t discard = m_discardBefore.load();
+    size_t tail = m_tail.load();
+    if (discard > head)
+    {
+        head = discard;
+    }
+    return (tail > head) ? (int)(tail - head) : 0;
 }
 
 void BufferQueue::clear()
 {
-    Buffer *item;
-    int value;
-    pthread_mutex_lock(&m_mutex);
-    while(!m_buffer.empty())
-    {
-        item = m_buffer.front();
-        m_buffer.pop();
-        item->deleteBuffer();
-	delete item;
-        sem_getvalue(&m_sem_full,&value);
-        if(value != 0)
-            sem_wait(&m_sem_full);
-        sem_post(&m_sem_empty);
-    }
-    pthread_mutex_unlock(&m_mutex);
+    // The consumer releases the dropped items as it reaches them
+    m_discardBefore.store(m_tail.load());
 }
 
 bool BufferQueue::isFull()
 {
-    int value;
-    sem_getvalue(&m_sem_empty,&value);
-    if(value == 0)
-    {
-       return true;
-    }
-    return false;
+    return (m_tail.load() - m_head.load()) > m_mask;
 }
 
 bool BufferQueue::isEmpty()
 {
-    pthread_mutex_lock(&m_mutex);
-    if(m_buffer.empty())
-    {
-       pthread_mutex_unlock(&m_mutex);
-       return true;
-    }  
-    pthread_mutex_unlock(&m_mutex);
-    return false;
+    return count() == 0;
 }
 
 Buffer* BufferQueue::remove()
 {
-    Buffer *item = NULL;
-    sem_wait(&m_sem_full);
-    pthread_mutex_lock(&m_mutex);
-    if(!m_buffer.empty())
+    while (!m_exit)
     {
-        item = m_buffer.front();
-        m_buffer.pop();
-        sem_post(&m_sem_empty);
+        size_t head = m_head.load(std::memory_order_relaxed);
+        if (head != m_tail.load(std::memory_order_acquire))
+        {
+            Buffer *item = m_ring[head & m_mask];
+            m_head.store(head + 1, std::memory_order_release);
+            if (head < m_discardBefore.load())
+            {
+                item->release();
+                continue;
+            }
+            return item;
+        }
+
+        std::unique_lock<std::mutex> lock(m_mutex);
+        m_waiting = true;
+        m_cond.wait(lock, [this, head] () { return m_exit || (m_tail.load() != head); });
+        m_waiting = false;
     }
-    pthread_mutex_unlock(&m_mutex);
-    return item;
+    return NULL;
 }
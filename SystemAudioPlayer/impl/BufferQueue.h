@@ -1,45 +1,91 @@
 #ifndef BUFFERQUEUE_H_
 #define BUFFERQUEUE_H_
 
-#include <pthread.h>
-#include <semaphore.h>
+#include <stdint.h>
 #include <stdlib.h>
-#include <cstring>
-#include <queue>
-#include <stdio.h>
-#include <unistd.h>
+#include <atomic>
+#include <condition_variable>
+#include <mutex>
+#include <vector>
 #include "logger.h"
 
+class BufferPool;
+
+// Fixed size block handed out by a BufferPool. The same memory is wrapped into
+// the GstBuffer pushed to appsrc and goes back to the pool once GStreamer is
+// done with it, so audio data is copied once, from the source into the block.
 struct Buffer
 {
-    Buffer()
-    {
-    }
     void fillBuffer(const void *ptr,int len);
     int getLength();
-    char *getBuffer();   
-    void deleteBuffer();
+    int getCapacity();
+    char *getBuffer();
+    // Returns the block to its pool
+    void release();
+
     char *buff;
     int length;
+    int capacity;
+    BufferPool *pool;
 };
 
+// Keeps up to maxPooled released blocks around for reuse. The pool is
+// reference counted: every block handed out holds a reference, so blocks that
+// are still owned by GStreamer can be released after the player is gone.
+class BufferPool
+{
+    public:
+    BufferPool(int blockSize, int maxPooled);
+    Buffer* acquire();
+    void ref();
+    void unref();
+    int blockSize();
+    uint64_t allocations();
+    uint64_t copiedBytes();
+
+    private:
+    friend struct Buffer;
+    ~BufferPool();
+    void release(Buffer *buffer);
+
+    std::mutex m_mutex;
+    std::vector<Buffer*> m_free;
+    int m_blockSize;
+    int m_maxPooled;
+    std::atomic<int> m_refs;
+    std::atomic<uint64_t> m_allocations;
+    std::atomic<uint64_t> m_copiedBytes;
+};
+
+// Lock-free single producer / single consumer ring between the thread feeding
+// data (WebSocket or PlayBuffer) and the thread pushing it to appsrc. Only an
+// empty queue makes the consumer block, on a condition variable the producer
+// signals when it sees the consumer waiting.
 class BufferQueue
 {
     public:
-    void add(Buffer* item);
-    Buffer* remove();
     BufferQueue(int);
+    // Producer side; false when the queue is full
+    bool add(Buffer* item);
+    // Consumer side; blocks until an item is available or preDelete()
+    Buffer* remove();
     bool isEmpty();
     bool isFull();
+    // Drops the queued items, may be called from any thread
     void clear();
     void preDelete();
     int count();
     ~BufferQueue();
 
     private:
-    std::queue<Buffer*> m_buffer;
-    pthread_mutex_t m_mutex;
-    sem_t m_sem_full;
-    sem_t m_sem_empty;
+    std::vector<Buffer*> m_ring;
+    size_t m_mask;
+    std::atomic<size_t> m_head;
+    std::atomic<size_t> m_tail;
+    std::atomic<size_t> m_discardBefore;
+    std::atomic<bool> m_waiting;
+    std::atomic<bool> m_exit;
+    std::mutex m_mutex;
+    std::condition_variable m_cond;
 };
 #endif
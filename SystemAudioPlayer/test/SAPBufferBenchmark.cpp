@@ -0,0 +1,137 @@
+/*
+ * If not stated otherwise in this file or this component's LICENSE file the
+ * following copyright and licenses apply:
+ *
+ * Copyright 2020 RDK Management
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+// Feeds a fake PCM source through the buffer pool and queue used between the
+// WebSocket/PlayBuffer thread and the appsrc thread, and reports the copies,
+// allocations and CPU time spent per second of audio. The consumer releases
+// every block right away, the way GStreamer does once the sink is done.
+//
+// Usage: SystemAudioPlayerBufferBenchmark [seconds of audio] [chunk bytes]
+
+#include "BufferQueue.h"
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <sys/resource.h>
+
+#include <atomic>
+#include <chrono>
+#include <thread>
+#include <vector>
+
+#define PCM_RATE          44100
+#define PCM_CHANNELS      2
+#define PCM_SAMPLE_BYTES  2
+#define POOL_BLOCK_SIZE   (16 * 1024)
+#define POOL_MAX_BLOCKS   64
+#define QUEUE_SIZE        1024
+
+static double cpuSeconds()
+{
+    struct rusage usage;
+    getrusage(RUSAGE_SELF, &usage);
+    return usage.ru_utime.tv_sec + usage.ru_stime.tv_sec +
+        (usage.ru_utime.tv_usec + usage.ru_stime.tv_usec) / 1000000.0;
+}
+
+int main(int argc, char *argv[])
+{
+    int seconds = (argc > 1) ? atoi(argv[1]) : 600;
+    int chunkBytes = (argc > 2) ? atoi(argv[2]) : (PCM_RATE * PCM_CHANNELS * PCM_SAMPLE_BYTES / 50); // 20ms
+
+    if (seconds <= 0 || chunkBytes <= 0)
+    {
+        printf("Usage: %s [seconds of audio] [chunk bytes]\n", argv[0]);
+        return 1;
+    }
+
+    // Fake PCM source: a ramp, the content does not matter
+    std::vector<char> chunk(chunkBytes);
+    for (int i = 0; i < chunkBytes; i++)
+    {
+        chunk[i] = (char)i;
+    }
+
+    uint64_t totalBytes = (uint64_t)seconds * PCM_RATE * PCM_CHANNELS * PCM_SAMPLE_BYTES;
+    std::atomic<uint64_t> consumedBytes(0);
+    uint64_t droppedBytes = 0;
+
+    BufferPool *pool = new BufferPool(POOL_BLOCK_SIZE, POOL_MAX_BLOCKS);
+    BufferQueue *queue = new BufferQueue(QUEUE_SIZE);
+
+    double cpuStart = cpuSeconds();
+    auto wallStart = std::chrono::steady_clock::now();
+
+    std::thread consumer([&] () {
+        Buffer *buffer;
+        while ((buffer = queue->remove()) != NULL)
+        {
+            consumedBytes += buffer->getLength();
+            buffer->release();
+        }
+    });
+
+    for (uint64_t produced = 0; produced < totalBytes; )
+    {
+        int length = (int)std::min<uint64_t>(chunkBytes, totalBytes - produced);
+        const char *data = chunk.data();
+        produced += length;
+
+        // Same loop as AudioPlayer::push_data, except that the producer waits
+        // instead of dropping data. A live source never runs ahead of playback
+        // by more than a few blocks, so the backlog is kept within the pool size.
+        while (length > 0)
+        {
+            if (queue->count() >= POOL_MAX_BLOCKS)
+            {
+                std::this_thread::yield();
+                continue;
+            }
+            Buffer *buffer = pool->acquire();
+            buffer->fillBuffer(data, length);
+            data += buffer->getLength();
+            length -= buffer->getLength();
+            if (!queue->add(buffer))
+            {
+                droppedBytes += buffer->getLength();
+                buffer->release();
+            }
+        }
+    }
+
+    while (consumedBytes + droppedBytes < totalBytes)
+    {
+        std::this_thread::yield();
+    }
+    queue->preDelete();
+    consumer.join();
+
+    double cpu = cpuSeconds() - cpuStart;
+    double wall = std::chrono::duration<double>(std::chrono::steady_clock::now() - wallStart).count();
+
+    printf("audio:        %d s in %d byte chunks (%llu bytes)\n", seconds, chunkBytes, (unsigned long long)totalBytes);
+    printf("consumed:     %llu bytes, dropped %llu bytes\n", (unsigned long long)consumedBytes.load(), (unsigned long long)droppedBytes);
+    printf("copies:       %.2f bytes copied per byte of audio\n", (double)pool->copiedBytes() / totalBytes);
+    printf("allocations:  %llu blocks of %d bytes\n", (unsigned long long)pool->allocations(), pool->blockSize());
+    printf("cpu:          %.3f ms per second of audio (%.3f s cpu, %.3f s wall)\n", cpu * 1000.0 / seconds, cpu, wall);
+
+    delete queue;
+    pool->unref();
+    return 0;
+}
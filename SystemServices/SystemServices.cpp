@@ -41,6 +41,7 @@
 #include "StateObserverHelper.h"
 #include "utils.h"
 #include "uploadlogs.h"
+#include "UtilsJsonRpcDirectLink.h"
 
 #if defined(USE_IARMBUS) || defined(USE_IARM_BUS)
 #include "libIARM.h"
@@ -438,11 +439,12 @@ namespace WPEFramework {
             return (string());
         }
 
-        void SystemServices::Deinitialize(PluginHost::IShell*)
+        void SystemServices::Deinitialize(PluginHost::IShell* service)
         {
 #if defined(USE_IARMBUS) || defined(USE_IARM_BUS)
             DeinitializeIARM();
 #endif /* defined(USE_IARMBUS) || defined(USE_IARM_BUS) */
+            Utils::releaseJsonRpcLinks(service->Callsign());
             SystemServices::_instance = nullptr;
             m_shellService->Release();
             m_shellService = nullptr;
@@ -3750,6 +3752,7 @@ namespace WPEFramework {
         /***
          * @brief : upload STB logs to the specified URL.
          * @param1[in] : url::String
+         * @param2[in] : incremental::Boolean, only what was appended since the last upload
          */
         uint32_t SystemServices::uploadLogs(const JsonObject& parameters, JsonObject& response)
         {
@@ -3759,7 +3762,9 @@ namespace WPEFramework {
 
             string url;
             getStringParameter("url", url);
-            auto err = UploadLogs::upload(url);
+            bool incremental = false;
+            getDefaultBoolParameter("incremental", incremental, false);
+            auto err = UploadLogs::upload(url, incremental);
             if (err != UploadLogs::OK)
                 response["error"] = UploadLogs::errToText(err);
             else
@@ -3984,7 +3989,7 @@ namespace WPEFramework {
 
           const string query = parameters.HasLabel("query") ? parameters["query"].String() : "";
 
-          response.Load(query);
+          response.Load(m_shellService, query);
 
           return Core::ERROR_NONE;
         }
@@ -20,6 +20,7 @@
 #pragma once
 
 #include "../Module.h"
+#include "UtilsJsonRpcDirectLink.h"
 
 namespace WPEFramework {
 namespace Plugin {
@@ -28,6 +29,11 @@ class PlatformCapsData {
 public:
   typedef std::tuple <string, string, string> BrowserInfo;
 
+public:
+  explicit PlatformCapsData(PluginHost::IShell *service)
+      : jsonRpc(service) {
+  }
+
 public:
   /**
    * Things ported from the XRE Receiver onConnect
@@ -62,11 +68,12 @@ public:
 private:
   class JsonRpc {
   private:
-    typedef WPEFramework::JSONRPC::LinkType<WPEFramework::Core::JSON::IElement> Client;
-    typedef WPEFramework::Core::ProxyType<Client> ClientProxy;
+    typedef std::shared_ptr<Utils::JSONRPCDirectLink> ClientProxy;
 
   public:
-    JsonRpc() = default;
+    explicit JsonRpc(PluginHost::IShell *service)
+        : service(service) {
+    }
     JsonRpc(const JsonRpc &) = delete;
     JsonRpc &operator=(const JsonRpc &) = delete;
 
@@ -79,6 +86,7 @@ private:
     ClientProxy getClient(const string &callsign);
 
   private:
+    PluginHost::IShell *service;
     std::map <string, ClientProxy> clients;
   };
 
@@ -23,7 +23,6 @@
 
 #include <securityagent/SecurityTokenUtil.h>
 
-#define SERVER_DETAILS "127.0.0.1:9998"
 #define MAX_LENGTH 1024
 
 namespace {
@@ -59,13 +58,13 @@ namespace Plugin {
  */
  
 string PlatformCapsData::GetModel() {
-  return jsonRpc.invoke(_T("org.rdk.System.1"),
+  return jsonRpc.invoke(_T("org.rdk.System"),
                         _T("getDeviceInfo"), 5000)
       .Get(_T("model_number")).String();
 }
 
 string PlatformCapsData::GetDeviceType() {
-  auto hex = jsonRpc.invoke(_T("org.rdk.AuthService.1"),
+  auto hex = jsonRpc.invoke(_T("org.rdk.AuthService"),
                             _T("getDeviceInfo"), 10000)
       .Get(_T("deviceInfo")).String();
   auto deviceInfo = stringFromHex(hex);
@@ -76,7 +75,7 @@ string PlatformCapsData::GetDeviceType() {
 }
 
 string PlatformCapsData::GetHDRCapability() {
-  JsonArray hdrCaps = jsonRpc.invoke(_T("org.rdk.DisplaySettings.1"),
+  JsonArray hdrCaps = jsonRpc.invoke(_T("org.rdk.DisplaySettings"),
                                      _T("getSettopHDRSupport"), 3000)
       .Get(_T("standards")).Array();
 
@@ -93,38 +92,38 @@ string PlatformCapsData::GetHDRCapability() {
 }
 
 string PlatformCapsData::GetAccountId() {
-  return jsonRpc.invoke(_T("org.rdk.AuthService.1"),
+  return jsonRpc.invoke(_T("org.rdk.AuthService"),
                         _T("getAlternateIds"), 3000)
       .Get(_T("alternateIds")).Object().Get(_T("_xbo_account_id")).String();
 }
 
 string PlatformCapsData::GetX1DeviceId() {
-  return jsonRpc.invoke(_T("org.rdk.AuthService.1"),
+  return jsonRpc.invoke(_T("org.rdk.AuthService"),
                         _T("getXDeviceId"), 3000)
       .Get(_T("xDeviceId")).String();
 }
 
 bool PlatformCapsData::XCALSessionTokenAvailable() {
-  string tkn = jsonRpc.invoke(_T("org.rdk.AuthService.1"),
+  string tkn = jsonRpc.invoke(_T("org.rdk.AuthService"),
                               _T("getSessionToken"), 10000)
       .Get(_T("token")).String();
   return (!tkn.empty());
 }
 
 string PlatformCapsData::GetExperience() {
-  return jsonRpc.invoke(_T("org.rdk.AuthService.1"),
+  return jsonRpc.invoke(_T("org.rdk.AuthService"),
                         _T("getExperience"), 3000)
       .Get(_T("experience")).String();
 }
 
 string PlatformCapsData::GetDdeviceMACAddress() {
-  return jsonRpc.invoke(_T("org.rdk.System.1"),
+  return jsonRpc.invoke(_T("org.rdk.System"),
                         _T("getDeviceInfo"), 5000)
       .Get(_T("estb_mac")).String();
 }
 
 string PlatformCapsData::GetPublicIP() {
-  return jsonRpc.invoke(_T("org.rdk.Network.1"),
+  return jsonRpc.invoke(_T("org.rdk.Network"),
                         _T("getPublicIP"), 5000)
       .Get(_T("public_ip")).String();
 }
@@ -149,7 +148,7 @@ bool PlatformCapsData::JsonRpc::activate(const string &callsign,
   JsonObject params, result;
   params["callsign"] = callsign;
 
-  auto err = getClient(_T(""))->Invoke<JsonObject, JsonObject>(
+  auto err = getClient(_T("Controller"))->Invoke<JsonObject, JsonObject>(
       waitTime, _T("activate"), params, result);
 
   if (err != Core::ERROR_NONE) {
@@ -162,26 +161,21 @@ bool PlatformCapsData::JsonRpc::activate(const string &callsign,
 
 PlatformCapsData::JsonRpc::ClientProxy PlatformCapsData::JsonRpc::getClient(
     const string &callsign) {
-  auto retval = clients.emplace(std::piecewise_construct,
-                                std::make_tuple(callsign),
-                                std::make_tuple());
+  auto it = clients.find(callsign);
 
-  if (retval.second == true) {
-    static auto token = securityToken();
-    auto query = ("token=" + token);
-
-    Core::SystemInfo::SetEnvironment(
-        _T("THUNDER_ACCESS"), (_T(SERVER_DETAILS)));
-
-    retval.first->second =
-        ClientProxy::Create(callsign, nullptr, false, query);
-
-    if (!callsign.empty()) {
+  if (it == clients.end()) {
+    // activated first, so the link can find the plugin in process
+    if (callsign != _T("Controller")) {
       activate(callsign, 3000);
     }
+
+    static auto token = securityToken();
+
+    it = clients.emplace(callsign, std::make_shared<Utils::JSONRPCDirectLink>(
+        service, callsign, token)).first;
   }
 
-  return retval.first->second;
+  return it->second;
 }
 
 } // namespace Plugin
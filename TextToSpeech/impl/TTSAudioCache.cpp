@@ -0,0 +1,437 @@
+/*
+ * If not stated otherwise in this file or this component's LICENSE file the
+ * following copyright and licenses apply:
+ *
+ * Copyright 2020 RDK Management
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "TTSAudioCache.h"
+#include "logger.h"
+
+#include <curl/curl.h>
+#include <dirent.h>
+#include <stdio.h>
+#include <sys/stat.h>
+
+#include <algorithm>
+#include <fstream>
+
+#define TTS_CACHE_FILE_SUFFIX ".tts"
+#define TTS_FETCH_CONNECT_TIMEOUT_S 5
+#define TTS_FETCH_TIMEOUT_S 10
+
+#define TTS_PCM_RATE 22050
+#define TTS_PCM_FRAME_BYTES 2
+
+namespace TTS {
+
+size_t id3TagSize(const AudioData &audio) {
+    if(audio.size() < 10 || audio[0] != 'I' || audio[1] != 'D' || audio[2] != '3')
+        return 0;
+    // syncsafe size, without the header and the optional footer
+    size_t size = ((audio[6] & 0x7f) << 21) | ((audio[7] & 0x7f) << 14) | ((audio[8] & 0x7f) << 7) | (audio[9] & 0x7f);
+    size += (audio[5] & 0x10) ? 20 : 10;
+    return std::min(size, audio.size());
+}
+
+uint64_t audioDuration(const AudioData &audio, bool pcm) {
+    if(pcm)
+        return (uint64_t)(audio.size() / TTS_PCM_FRAME_BYTES) * 1000000000ULL / TTS_PCM_RATE;
+
+    static const uint16_t bitrates[2][3][15] = {
+        { // MPEG 1: layer I, II, III
+            { 0, 32, 64, 96, 128, 160, 192, 224, 256, 288, 320, 352, 384, 416, 448 },
+            { 0, 32, 48, 56, 64, 80, 96, 112, 128, 160, 192, 224, 256, 320, 384 },
+            { 0, 32, 40, 48, 56, 64, 80, 96, 112, 128, 160, 192, 224, 256, 320 } },
+        { // MPEG 2 and 2.5
+            { 0, 32, 48, 56, 64, 80, 96, 112, 128, 144, 160, 176, 192, 224, 256 },
+            { 0, 8, 16, 24, 32, 40, 48, 56, 64, 80, 96, 112, 128, 144, 160 },
+            { 0, 8, 16, 24, 32, 40, 48, 56, 64, 80, 96, 112, 128, 144, 160 } }
+    };
+    static const uint32_t sampleRates[3] = { 44100, 48000, 32000 };
+
+    uint64_t duration = 0;
+    size_t pos = id3TagSize(audio);
+    while(pos + 4 <= audio.size()) {
+        const uint8_t *h = &audio[pos];
+        uint8_t version = (h[1] >> 3) & 3;  // 3: MPEG 1, 2: MPEG 2, 0: MPEG 2.5
+        uint8_t layer = 4 - ((h[1] >> 1) & 3); // 1..3, 4 is reserved
+        uint8_t bitrateIndex = h[2] >> 4;
+        uint8_t sampleRateIndex = (h[2] >> 2) & 3;
+        if(h[0] != 0xff || (h[1] & 0xe0) != 0xe0 || version == 1 || layer == 4 ||
+                bitrateIndex == 0 || bitrateIndex == 15 || sampleRateIndex == 3) {
+            pos++;
+            continue;
+        }
+
+        bool mpeg1 = (version == 3);
+        uint32_t bitrate = bitrates[mpeg1 ? 0 : 1][layer - 1][bitrateIndex] * 1000;
+        uint32_t sampleRate = sampleRates[sampleRateIndex] >> (mpeg1 ? 0 : (version == 2 ? 1 : 2));
+        uint32_t padding = (h[2] >> 1) & 1;
+        uint32_t samples;
+        size_t length;
+        if(layer == 1) {
+            samples = 384;
+            length = (12 * bitrate / sampleRate + padding) * 4;
+        } else {
+            samples = (layer == 3 && !mpeg1) ? 576 : 1152;
+            length = (samples / 8) * bitrate / sampleRate + padding;
+        }
+        duration += (uint64_t)samples * 1000000000ULL / sampleRate;
+        pos += length;
+    }
+    return duration;
+}
+
+TTSAudioCache::TTSAudioCache(size_t maxMemoryBytes, const std::string &diskDirectory, size_t maxDiskBytes, const Fetcher &fetcher) :
+    m_maxMemoryBytes(maxMemoryBytes),
+    m_memoryBytes(0),
+    m_diskDirectory(diskDirectory),
+    m_maxDiskBytes(diskDirectory.empty() ? 0 : maxDiskBytes),
+    m_diskBytes(0),
+    m_fetcher(fetcher ? fetcher : Fetcher(httpGet)),
+    m_statistics(),
+    m_runThread(true),
+    m_prefetchThread(NULL) {
+
+    if(!m_diskDirectory.empty() && m_diskDirectory.back() != '/')
+        m_diskDirectory.append("/");
+    if(m_maxDiskBytes > 0)
+        loadDiskIndex();
+
+    m_prefetchThread = new std::thread(&TTSAudioCache::prefetchThread, this);
+}
+
+TTSAudioCache::~TTSAudioCache() {
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        m_runThread = false;
+        m_pending.clear();
+    }
+    m_condition.notify_all();
+
+    if(m_prefetchThread) {
+        m_prefetchThread->join();
+        delete m_prefetchThread;
+        m_prefetchThread = NULL;
+    }
+}
+
+bool TTSAudioCache::get(const std::string &url, AudioData &audio, bool persist) {
+    std::unique_lock<std::mutex> lock(m_mutex);
+    auto pending = findPending(url);
+    if(pending != m_pending.end())
+        m_pending.erase(pending);
+
+    // Already on its way, fetching it again would only take longer
+    m_condition.wait(lock, [this, &url] () { return m_inFlight.find(url) == m_inFlight.end(); });
+
+    if(lookup(url, audio))
+        return true;
+
+    m_inFlight.insert(url);
+    bool loaded = load(url, audio, lock, false, persist);
+    m_inFlight.erase(url);
+    lock.unlock();
+    m_condition.notify_all();
+    return loaded;
+}
+
+void TTSAudioCache::prefetch(const std::string &url, bool persist) {
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        if(m_index.find(url) != m_index.end() || m_inFlight.find(url) != m_inFlight.end() ||
+                findPending(url) != m_pending.end())
+            return;
+        Request request;
+        request.url = url;
+        request.persist = persist;
+        m_pending.push_back(request);
+    }
+    m_condition.notify_all();
+}
+
+void TTSAudioCache::cancelPrefetch() {
+    std::lock_guard<std::mutex> lock(m_mutex);
+    m_pending.clear();
+}
+
+void TTSAudioCache::clear() {
+    std::lock_guard<std::mutex> lock(m_mutex);
+    m_pending.clear();
+    m_entries.clear();
+    m_index.clear();
+    m_memoryBytes = 0;
+
+    for(auto it = m_diskEntries.begin(); it != m_diskEntries.end(); ++it)
+        remove((m_diskDirectory + it->first).c_str());
+    m_diskEntries.clear();
+    m_diskBytes = 0;
+}
+
+TTSAudioCache::Statistics TTSAudioCache::statistics() {
+    std::lock_guard<std::mutex> lock(m_mutex);
+    Statistics result = m_statistics;
+    result.memoryBytes = m_memoryBytes;
+    result.diskBytes = m_diskBytes;
+    return result;
+}
+
+static size_t writeCallback(void *data, size_t size, size_t nmemb, void *userp) {
+    AudioData *audio = static_cast<AudioData*>(userp);
+    const uint8_t *bytes = static_cast<const uint8_t*>(data);
+    audio->insert(audio->end(), bytes, bytes + size * nmemb);
+    return size * nmemb;
+}
+
+bool TTSAudioCache::httpGet(const std::string &url, AudioData &audio) {
+    CURL *curl = curl_easy_init();
+    if(!curl) {
+        TTSLOG_ERROR("curl_easy_init failed");
+        return false;
+    }
+
+    audio.clear();
+    curl_easy_setopt(curl, CURLOPT_URL, url.c_str());
+    curl_easy_setopt(curl, CURLOPT_WRITEFUNCTION, writeCallback);
+    curl_easy_setopt(curl, CURLOPT_WRITEDATA, &audio);
+    curl_easy_setopt(curl, CURLOPT_FAILONERROR, 1L);
+    curl_easy_setopt(curl, CURLOPT_NOSIGNAL, 1L);
+    curl_easy_setopt(curl, CURLOPT_CONNECTTIMEOUT, (long)TTS_FETCH_CONNECT_TIMEOUT_S);
+    curl_easy_setopt(curl, CURLOPT_TIMEOUT, (long)TTS_FETCH_TIMEOUT_S);
+
+    CURLcode res = curl_easy_perform(curl);
+    curl_easy_cleanup(curl);
+
+    if(res != CURLE_OK) {
+        TTSLOG_ERROR("Fetching speech audio failed: %s", curl_easy_strerror(res));
+        return false;
+    }
+    return !audio.empty();
+}
+
+// Called with m_mutex held
+bool TTSAudioCache::lookup(const std::string &url, AudioData &audio) {
+    auto it = m_index.find(url);
+    if(it == m_index.end())
+        return false;
+
+    m_entries.splice(m_entries.begin(), m_entries, it->second);
+    audio = it->second->audio;
+    m_statistics.memoryHits++;
+    return true;
+}
+
+// Called with m_mutex held and url in flight. Reads url from disk or fetches
+// it, with the lock released for the I/O; only a fetched clip is written to
+// disk, one read from there is already. Without persist the disk is left out.
+bool TTSAudioCache::load(const std::string &url, AudioData &audio, std::unique_lock<std::mutex> &lock, bool prefetching, bool persist) {
+    std::string name = persist ? diskPath(url) : std::string();
+    bool onDisk = persist && findDiskEntry(name) != m_diskEntries.end();
+
+    lock.unlock();
+    bool read = onDisk && readFromDisk(name, url, audio);
+    lock.lock();
+
+    if(read) {
+        auto it = findDiskEntry(name);
+        if(it != m_diskEntries.end())
+            m_diskEntries.splice(m_diskEntries.begin(), m_diskEntries, it);
+        if(!prefetching)
+            m_statistics.diskHits++;
+        storeInMemory(url, audio);
+        return true;
+    }
+
+    if(!prefetching)
+        m_statistics.misses++;
+    lock.unlock();
+    bool fetched = m_fetcher(url, audio);
+    size_t size = (fetched && persist) ? writeToDisk(name, url, audio) : 0;
+    lock.lock();
+
+    if(!fetched) {
+        m_statistics.fetchErrors++;
+        return false;
+    }
+    if(prefetching)
+        m_statistics.prefetches++;
+    storeInMemory(url, audio);
+
+    if(size > 0) {
+        std::vector<std::string> evicted = addDiskEntry(name, size);
+        lock.unlock();
+        for(auto it = evicted.begin(); it != evicted.end(); ++it)
+            remove((m_diskDirectory + *it).c_str());
+        lock.lock();
+    }
+    return true;
+}
+
+// Called with m_mutex held
+void TTSAudioCache::storeInMemory(const std::string &url, const AudioData &audio) {
+    if(audio.size() > m_maxMemoryBytes || m_index.find(url) != m_index.end())
+        return;
+
+    Entry entry;
+    entry.url = url;
+    entry.audio = audio;
+    m_entries.push_front(entry);
+    m_index[url] = m_entries.begin();
+    m_memoryBytes += audio.size();
+
+    while(m_memoryBytes > m_maxMemoryBytes) {
+        m_memoryBytes -= m_entries.back().audio.size();
+        m_index.erase(m_entries.back().url);
+        m_entries.pop_back();
+    }
+}
+
+std::string TTSAudioCache::diskPath(const std::string &url) {
+    char name[32];
+    snprintf(name, sizeof(name), "%016zx" TTS_CACHE_FILE_SUFFIX, std::hash<std::string>()(url));
+    return name;
+}
+
+// Called with m_mutex held
+std::deque<TTSAudioCache::Request>::iterator TTSAudioCache::findPending(const std::string &url) {
+    return std::find_if(m_pending.begin(), m_pending.end(),
+            [&url] (const Request &request) { return request.url == url; });
+}
+
+// Called with m_mutex held
+std::list<std::pair<std::string, size_t>>::iterator TTSAudioCache::findDiskEntry(const std::string &name) {
+    return std::find_if(m_diskEntries.begin(), m_diskEntries.end(),
+            [&name] (const std::pair<std::string, size_t> &entry) { return entry.first == name; });
+}
+
+// Called with m_mutex held. Returns the files evicted to make room, for the
+// caller to remove once the lock is released.
+std::vector<std::string> TTSAudioCache::addDiskEntry(const std::string &name, size_t size) {
+    std::vector<std::string> evicted;
+    auto it = findDiskEntry(name);
+    if(it != m_diskEntries.end()) {
+        m_diskBytes -= it->second;
+        m_diskEntries.erase(it);
+    }
+
+    m_diskEntries.push_front(std::make_pair(name, size));
+    m_diskBytes += size;
+    while(m_diskBytes > m_maxDiskBytes) {
+        evicted.push_back(m_diskEntries.back().first);
+        m_diskBytes -= m_diskEntries.back().second;
+        m_diskEntries.pop_back();
+    }
+    return evicted;
+}
+
+// A cache file holds the URL on the first line, so that a hash collision is
+// a miss, followed by the audio
+bool TTSAudioCache::readFromDisk(const std::string &name, const std::string &url, AudioData &audio) {
+    std::ifstream file(m_diskDirectory + name, std::ios::binary);
+    std::string storedUrl;
+    if(!file || !std::getline(file, storedUrl) || storedUrl != url)
+        return false;
+
+    audio.assign(std::istreambuf_iterator<char>(file), std::istreambuf_iterator<char>());
+    return !audio.empty();
+}
+
+// Returns the size taken on disk, 0 if not written
+size_t TTSAudioCache::writeToDisk(const std::string &name, const std::string &url, const AudioData &audio) {
+    size_t size = url.size() + 1 + audio.size();
+    if(m_maxDiskBytes == 0 || size > m_maxDiskBytes)
+        return 0;
+
+    // Written aside and renamed, a reader never sees a partial file
+    std::string path = m_diskDirectory + name;
+    std::string tmpPath = path + ".tmp";
+    {
+        std::ofstream file(tmpPath, std::ios::binary | std::ios::trunc);
+        file << url << '\n';
+        file.write(reinterpret_cast<const char*>(audio.data()), audio.size());
+        if(!file) {
+            TTSLOG_WARNING("Failed to write %s", tmpPath.c_str());
+            remove(tmpPath.c_str());
+            return 0;
+        }
+    }
+    if(rename(tmpPath.c_str(), path.c_str()) != 0) {
+        remove(tmpPath.c_str());
+        return 0;
+    }
+    return size;
+}
+
+// Picks up the files of a previous run, most recently written first
+void TTSAudioCache::loadDiskIndex() {
+    mkdir(m_diskDirectory.c_str(), 0755);
+    DIR *dir = opendir(m_diskDirectory.c_str());
+    if(!dir) {
+        TTSLOG_WARNING("Audio cache directory %s not accessible, disk cache disabled", m_diskDirectory.c_str());
+        m_maxDiskBytes = 0;
+        return;
+    }
+
+    std::vector<std::pair<time_t, std::pair<std::string, size_t>>> files;
+    struct dirent *entry;
+    while((entry = readdir(dir)) != NULL) {
+        std::string name = entry->d_name;
+        std::string suffix = TTS_CACHE_FILE_SUFFIX;
+        if(name.size() <= suffix.size() || name.compare(name.size() - suffix.size(), suffix.size(), suffix) != 0)
+            continue;
+        struct stat st;
+        if(stat((m_diskDirectory + name).c_str(), &st) == 0)
+            files.push_back(std::make_pair(st.st_mtime, std::make_pair(name, (size_t)st.st_size)));
+    }
+    closedir(dir);
+
+    std::sort(files.begin(), files.end(),
+            [] (const std::pair<time_t, std::pair<std::string, size_t>> &a, const std::pair<time_t, std::pair<std::string, size_t>> &b) {
+                return a.first > b.first;
+            });
+    for(auto it = files.begin(); it != files.end(); ++it) {
+        if(m_diskBytes + it->second.second > m_maxDiskBytes) {
+            remove((m_diskDirectory + it->second.first).c_str());
+            continue;
+        }
+        m_diskEntries.push_back(it->second);
+        m_diskBytes += it->second.second;
+    }
+    TTSLOG_INFO("Audio cache: %zu files, %zu bytes on disk", m_diskEntries.size(), m_diskBytes);
+}
+
+void TTSAudioCache::prefetchThread() {
+    std::unique_lock<std::mutex> lock(m_mutex);
+    while(m_runThread) {
+        m_condition.wait(lock, [this] () { return !m_runThread || !m_pending.empty(); });
+        if(!m_runThread)
+            break;
+
+        Request request = m_pending.front();
+        m_pending.pop_front();
+        const std::string &url = request.url;
+        if(m_index.find(url) != m_index.end() || m_inFlight.find(url) != m_inFlight.end())
+            continue;
+
+        AudioData audio;
+        m_inFlight.insert(url);
+        load(url, audio, lock, true, request.persist);
+        m_inFlight.erase(url);
+        m_condition.notify_all();
+    }
+}
+
+} // namespace TTS
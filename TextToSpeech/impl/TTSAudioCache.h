@@ -0,0 +1,135 @@
+/*
+ * If not stated otherwise in this file or this component's LICENSE file the
+ * following copyright and licenses apply:
+ *
+ * Copyright 2020 RDK Management
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#ifndef _TTS_AUDIO_CACHE_H_
+#define _TTS_AUDIO_CACHE_H_
+
+#include <stdint.h>
+
+#include <condition_variable>
+#include <deque>
+#include <functional>
+#include <list>
+#include <map>
+#include <mutex>
+#include <set>
+#include <string>
+#include <thread>
+#include <vector>
+
+namespace TTS {
+
+typedef std::vector<uint8_t> AudioData;
+
+// Play time of a clip in nanoseconds: raw S16LE mono at 22050 Hz when pcm,
+// else MP3, summed over its frame headers
+uint64_t audioDuration(const AudioData &audio, bool pcm);
+
+// Size of the ID3v2 tag leading an MP3 clip, 0 if there is none
+size_t id3TagSize(const AudioData &audio);
+
+// Audio of synthesized speech, as returned by the TTS endpoint (MP3 or raw
+// PCM), keyed by the request URL, which carries the endpoint, voice,
+// language, rate and text. Recently used entries are kept in memory up to
+// maxMemoryBytes and, when a directory is given, on disk up to maxDiskBytes,
+// so they survive a restart. Audio asked for without persist, e.g. of secure
+// speeches whose URL carries text not to be written out, is only kept in
+// memory. A prefetch thread fetches the speeches queued behind the one
+// playing, so that they can start without a network stall.
+class TTSAudioCache {
+public:
+    typedef std::function<bool(const std::string &url, AudioData &audio)> Fetcher;
+
+    struct Statistics {
+        uint32_t memoryHits;
+        uint32_t diskHits;
+        uint32_t misses;
+        uint32_t prefetches;
+        uint32_t fetchErrors;
+        size_t memoryBytes;
+        size_t diskBytes;
+    };
+
+    TTSAudioCache(size_t maxMemoryBytes, const std::string &diskDirectory = "", size_t maxDiskBytes = 0,
+            const Fetcher &fetcher = Fetcher());
+    ~TTSAudioCache();
+
+    // Audio for url, from the cache, from a prefetch in flight or fetched
+    // now. False if it could not be fetched.
+    bool get(const std::string &url, AudioData &audio, bool persist = true);
+
+    // Fetches url in the background unless it is cached or already pending
+    void prefetch(const std::string &url, bool persist = true);
+
+    // Drops the pending prefetches, e.g. when the speech queue is flushed
+    void cancelPrefetch();
+
+    void clear();
+    Statistics statistics();
+
+    // Plain HTTP(S) GET of url with libcurl
+    static bool httpGet(const std::string &url, AudioData &audio);
+
+private:
+    struct Entry {
+        std::string url;
+        AudioData audio;
+    };
+
+    struct Request {
+        std::string url;
+        bool persist;
+    };
+
+    bool lookup(const std::string &url, AudioData &audio);
+    bool load(const std::string &url, AudioData &audio, std::unique_lock<std::mutex> &lock, bool prefetching, bool persist);
+    std::deque<Request>::iterator findPending(const std::string &url);
+    void storeInMemory(const std::string &url, const AudioData &audio);
+    std::list<std::pair<std::string, size_t>>::iterator findDiskEntry(const std::string &name);
+    std::vector<std::string> addDiskEntry(const std::string &name, size_t size);
+    bool readFromDisk(const std::string &name, const std::string &url, AudioData &audio);
+    size_t writeToDisk(const std::string &name, const std::string &url, const AudioData &audio);
+    void loadDiskIndex();
+    std::string diskPath(const std::string &url);
+    void prefetchThread();
+
+    size_t m_maxMemoryBytes;
+    size_t m_memoryBytes;
+    std::list<Entry> m_entries; // most recently used first
+    std::map<std::string, std::list<Entry>::iterator> m_index;
+
+    std::string m_diskDirectory;
+    size_t m_maxDiskBytes;
+    size_t m_diskBytes;
+    std::list<std::pair<std::string, size_t>> m_diskEntries; // file name and size, most recently used first
+
+    Fetcher m_fetcher;
+    Statistics m_statistics;
+
+    std::mutex m_mutex;
+    std::condition_variable m_condition;
+    std::deque<Request> m_pending;
+    std::set<std::string> m_inFlight;
+    bool m_runThread;
+    std::thread *m_prefetchThread;
+};
+
+} // namespace TTS
+
+#endif
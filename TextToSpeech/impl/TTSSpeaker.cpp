@@ -171,6 +171,11 @@ TTSSpeaker::TTSSpeaker(TTSConfiguration &config) :
     m_currentSpeech(NULL),
     m_isSpeaking(false),
     m_isPaused(false),
+    m_audioCache(NULL),
+    m_prefetchCount(INT_FROM_ENV("TTS_PREFETCH_COUNT", TTS_PREFETCH_COUNT)),
+    m_gapless(false),
+    m_pushedEnd(0),
+    m_queueGeneration(0),
     m_pipeline(NULL),
     m_source(NULL),
     m_audioSink(NULL),
@@ -198,6 +203,19 @@ TTSSpeaker::TTSSpeaker(TTSConfiguration &config) :
         setenv("GST_REGISTRY_UPDATE", "no", 0);
         setenv("GST_REGISTRY_FORK", "no", 0);
 
+        const char *cacheSize = getenv("TTS_AUDIO_CACHE_SIZE_KB");
+        size_t cacheSizeKB = cacheSize ? atoi(cacheSize) : TTS_AUDIO_CACHE_SIZE_KB;
+        if(cacheSizeKB > 0) {
+            const char *cacheDir = getenv("TTS_AUDIO_CACHE_DIR");
+            m_audioCache = new TTSAudioCache(cacheSizeKB * 1024, cacheDir ? cacheDir : "",
+                    INT_FROM_ENV("TTS_AUDIO_CACHE_DISK_SIZE_KB", TTS_AUDIO_CACHE_DISK_SIZE_KB) * 1024);
+
+            // Needs the whole clip up front, which only the cache provides.
+            // Opt-in until the persistent pipeline is validated on devices.
+            const char *gapless = getenv("TTS_GAPLESS_PLAYBACK");
+            m_gapless = gapless && atoi(gapless) != 0;
+        }
+
         m_main_loop_thread = g_thread_new("BusWatch", (void* (*)(void*)) event_loop, this);
         m_gstThread = new std::thread(GStreamerThreadFunc, this);
 
@@ -225,6 +243,9 @@ TTSSpeaker::~TTSSpeaker() {
     if(g_main_loop_is_running(m_main_loop))
         g_main_loop_quit(m_main_loop);
     g_thread_join(m_main_loop_thread);
+
+    delete m_audioCache;
+    m_audioCache = NULL;
 }
 
 void TTSSpeaker::ensurePipeline(bool flag) {
@@ -243,6 +264,7 @@ int TTSSpeaker::speak(TTSSpeakerClient *client, uint32_t id, std::string text, b
 
     SpeechData data(client, id, text, secure);
     queueData(data);
+    prefetchQueued();
 
     return 0;
 }
@@ -296,8 +318,9 @@ bool TTSSpeaker::cancelSpeech(uint32_t id) {
 
 bool TTSSpeaker::reset() {
     TTSLOG_VERBOSE("Resetting Speaker");
-    cancelSpeech();
+    // Queue first, so that the speaker does not move on to what is flushed
     flushQueue();
+    cancelSpeech();
 
     return true;
 }
@@ -353,6 +376,9 @@ void TTSSpeaker::queueData(SpeechData data) {
 void TTSSpeaker::flushQueue() {
     std::lock_guard<std::mutex> lock(m_queueMutex);
     m_queue.clear();
+    m_queueGeneration++;
+    if(m_audioCache)
+        m_audioCache->cancelPrefetch();
 }
 
 SpeechData TTSSpeaker::dequeueData() {
@@ -364,6 +390,195 @@ SpeechData TTSSpeaker::dequeueData() {
     return d;
 }
 
+void TTSSpeaker::prefetchQueued() {
+    if(!m_audioCache)
+        return;
+
+    std::lock_guard<std::mutex> lock(m_queueMutex);
+    uint8_t count = 0;
+    for(auto it = m_queue.begin(); it != m_queue.end() && count < m_prefetchCount; ++it, ++count) {
+        std::string url = constructURL(*it->client->configuration(), *it);
+        if(!url.empty())
+            m_audioCache->prefetch(url, !it->secure);
+    }
+}
+
+void TTSSpeaker::pushAudio(AudioData &audio, bool endOfStream) {
+    // appsrc takes the cached copy as is, freed once played
+    AudioData *data = new AudioData();
+    data->swap(audio);
+    GstBuffer *buffer = gst_buffer_new_wrapped_full(GST_MEMORY_FLAG_READONLY, data->data(), data->size(), 0, data->size(),
+            data, [] (gpointer p) { delete static_cast<AudioData*>(p); });
+
+    GstFlowReturn ret = GST_FLOW_OK;
+    g_signal_emit_by_name(m_source, "push-buffer", buffer, &ret);
+    gst_buffer_unref(buffer);
+    if(ret != GST_FLOW_OK)
+        TTSLOG_WARNING("push-buffer returned %s", gst_flow_get_name(ret));
+    if(endOfStream)
+        g_signal_emit_by_name(m_source, "end-of-stream", &ret);
+}
+
+bool TTSSpeaker::pushClip(std::list<Clip> &clips) {
+    Clip clip;
+    {
+        std::lock_guard<std::mutex> lock(m_queueMutex);
+        if(m_queue.empty())
+            return false;
+        clip.data = m_queue.front();
+        clip.generation = m_queueGeneration;
+        m_queue.pop_front();
+    }
+    prefetchQueued();
+
+    AudioData audio;
+    std::string url = constructURL(*clip.data.client->configuration(), clip.data);
+    if(url.empty() || !m_audioCache->get(url, audio, !clip.data.secure)) {
+        TTSLOG_ERROR("Failed to fetch audio for speech %d", clip.data.id);
+        clip.data.client->networkerror(clip.data.id);
+        return true;
+    }
+
+    // A tag in the middle of the stream would be taken for audio
+    if(!m_pcmAudioEnabled)
+        audio.erase(audio.begin(), audio.begin() + id3TagSize(audio));
+
+    clip.start = m_pushedEnd;
+    clip.end = m_pushedEnd + audioDuration(audio, m_pcmAudioEnabled);
+    clip.started = false;
+    m_pushedEnd = clip.end;
+    clips.push_back(clip);
+
+    // appsrc drops what is pushed before it is started
+    GstState state = GST_STATE_NULL;
+    gst_element_get_state(m_pipeline, &state, NULL, 0);
+    if(state < GST_STATE_PAUSED)
+        gst_element_set_state(m_pipeline, GST_STATE_PLAYING);
+    pushAudio(audio, false);
+
+    TTSLOG_VERBOSE("Queued clip ( %d, \"%s\") at %" GST_TIME_FORMAT " - %" GST_TIME_FORMAT,
+            clip.data.id, clip.data.text.c_str(), GST_TIME_ARGS(clip.start), GST_TIME_ARGS(clip.end));
+    return true;
+}
+
+void TTSSpeaker::speakGapless() {
+    std::list<Clip> clips;
+    gint64 lastPosition = -1;
+    auto lastProgress = std::chrono::steady_clock::now();
+    const gint64 tolerance = TTS_GAPLESS_END_TOLERANCE_MS * GST_MSECOND;
+
+    while(m_runThread && m_pipeline && !m_pipelineError && !m_flushed) {
+        // Keep the next speech in the stream behind the one playing
+        if(clips.empty() || (clips.size() == 1 && clips.front().started)) {
+            bool pushed = pushClip(clips);
+            if(clips.empty()) {
+                if(pushed)
+                    continue;
+                break;
+            }
+        }
+
+        gint64 position = -1;
+        if(!gst_element_query_position(m_pipeline, GST_FORMAT_TIME, &position))
+            position = -1;
+        auto now = std::chrono::steady_clock::now();
+        if(position != lastPosition || m_isPaused) {
+            lastPosition = position;
+            lastProgress = now;
+        }
+
+        Clip &clip = clips.front();
+        if(!clip.started && position > clip.start) {
+            clip.started = true;
+            g_object_set(G_OBJECT(m_audioVolume), "volume", (double) (clip.data.client->configuration()->volume() / MAX_VOLUME), NULL);
+            setSpeakingState(true, clip.data.client);
+            {
+                std::lock_guard<std::mutex> lock(m_stateMutex);
+                m_currentSpeech = &clip.data;
+            }
+#if defined(PLATFORM_AMLOGIC)
+            setMixGain(MIXGAIN_PRIM,-12);
+#endif
+            TTSLOG_VERBOSE("Speaking.... ( %d, \"%s\")", clip.data.id, clip.data.text.c_str());
+            clip.data.client->willSpeak(clip.data.id, clip.data.text);
+            clip.data.client->started(clip.data.id, clip.data.text);
+            continue;
+        }
+
+        if(clip.started) {
+            // A sink that stops reporting progress short of the end has played it all
+            bool stalled = (now - lastProgress) > std::chrono::milliseconds(TTS_GAPLESS_STALL_MS);
+            if(position >= clip.end - tolerance || stalled) {
+                if(position < clip.end - tolerance)
+                    TTSLOG_WARNING("Position stalled at %" GST_TIME_FORMAT ", ending speech %d", GST_TIME_ARGS(position), clip.data.id);
+                {
+                    std::lock_guard<std::mutex> lock(m_stateMutex);
+                    m_currentSpeech = NULL;
+                }
+                setSpeakingState(false);
+                clip.data.client->spoke(clip.data.id, clip.data.text);
+                clips.pop_front();
+                lastProgress = now;
+                continue;
+            }
+        } else if((now - lastProgress) > std::chrono::milliseconds(TTS_GAPLESS_START_TIMEOUT_MS)) {
+            TTSLOG_ERROR("Timed out waiting for speech %d to start", clip.data.id);
+            m_pipelineError = true;
+            break;
+        }
+
+        // A flush also drops what was pushed and has not started yet
+        uint32_t generation = clips.back().generation;
+        std::unique_lock<std::mutex> mlock(m_queueMutex);
+        m_condition.wait_for(mlock, std::chrono::milliseconds(TTS_GAPLESS_POLL_MS),
+                [this, generation] () { return m_flushed || m_pipelineError || !m_runThread || m_queueGeneration != generation; });
+        if(m_queueGeneration != generation)
+            m_flushed = true;
+    }
+
+    if(clips.empty() && m_pipeline && !m_pipelineError && !m_flushed) {
+        // Nothing left to say: let the tail play out, then stop the stream
+        // so that the next speech starts from 0 on a pipeline that is ready
+        std::this_thread::sleep_for(std::chrono::milliseconds(TTS_GAPLESS_END_TOLERANCE_MS));
+#if defined(PLATFORM_AMLOGIC)
+        setMixGain(MIXGAIN_PRIM,0);
+#endif
+        gst_element_set_state(m_pipeline, GST_STATE_READY);
+        m_pushedEnd = 0;
+        return;
+    }
+
+    // Interrupted: the speech playing, or failing to, gets the error and the
+    // ones behind it go back to the queue unless it was flushed meanwhile
+    std::list<SpeechData> requeue;
+    for(auto it = clips.begin(); it != clips.end(); ++it) {
+        if(it->started || (it == clips.begin() && !m_flushed)) {
+            if(m_flushed)
+                it->data.client->interrupted(it->data.id);
+            else if(m_networkError)
+                it->data.client->networkerror(it->data.id);
+            else
+                it->data.client->playbackerror(it->data.id);
+        } else {
+            requeue.push_back(it->data);
+        }
+    }
+    {
+        std::lock_guard<std::mutex> lock(m_queueMutex);
+        if(!clips.empty() && clips.back().generation == m_queueGeneration)
+            m_queue.splice(m_queue.begin(), requeue);
+    }
+#if defined(PLATFORM_AMLOGIC)
+    setMixGain(MIXGAIN_PRIM,0);
+#endif
+    {
+        std::lock_guard<std::mutex> lock(m_stateMutex);
+        m_currentSpeech = NULL;
+    }
+    setSpeakingState(false);
+    resetPipeline();
+}
+
 bool TTSSpeaker::waitForStatus(GstState expected_state, uint32_t timeout_ms) {
     // wait for the pipeline to get to pause so we know we have the audio device
     if(m_pipeline) {
@@ -490,7 +705,7 @@ void TTSSpeaker::createPipeline() {
 
     // create soc specific elements
 #if defined(PLATFORM_BROADCOM)
-    m_source = gst_element_factory_make("souphttpsrc", NULL);
+    m_source = gst_element_factory_make(m_audioCache ? "appsrc" : "souphttpsrc", NULL);
     m_audioSink = gst_element_factory_make("brcmpcmsink", NULL);
     m_audioVolume = m_audioSink;
 #elif defined(PLATFORM_AMLOGIC)
@@ -504,7 +719,7 @@ void TTSSpeaker::createPipeline() {
     GstElement *convert = gst_element_factory_make("audioconvert", NULL);
     GstElement *resample = gst_element_factory_make("audioresample", NULL);
     GstElement *audiofilter = gst_element_factory_make("capsfilter", NULL);
-    m_source = gst_element_factory_make("souphttpsrc", NULL);
+    m_source = gst_element_factory_make(m_audioCache ? "appsrc" : "souphttpsrc", NULL);
     m_audioVolume = gst_element_factory_make("volume", NULL);
     m_audioSink = gst_element_factory_make("rtkaudiosink", NULL);
     g_object_set(G_OBJECT(decodebin), "audio-tunnel-mode",  FALSE, NULL);
@@ -539,15 +754,16 @@ void TTSSpeaker::createPipeline() {
 #if defined(PLATFORM_AMLOGIC)
         if(m_pcmAudioEnabled) {
             //Raw PCM audio does not work with souphhtpsrc on Amlogic alsaasink
-            m_source = gst_element_factory_make("httpsrc", NULL);
+            m_source = gst_element_factory_make(m_audioCache ? "appsrc" : "httpsrc", NULL);
             g_object_set(G_OBJECT(m_audioSink), "tts-mode", TRUE, NULL);
         }
         else {
-            m_source = gst_element_factory_make("souphttpsrc", NULL);
+            m_source = gst_element_factory_make(m_audioCache ? "appsrc" : "souphttpsrc", NULL);
         }
 #endif
 
-        g_object_set(G_OBJECT(m_source), "location", tts_url.c_str(), NULL);
+        if(!m_audioCache)
+            g_object_set(G_OBJECT(m_source), "location", tts_url.c_str(), NULL);
     }
 
     // set the TTS volume to max.
@@ -650,6 +866,7 @@ void TTSSpeaker::resetPipeline() {
     m_networkError = false;
     m_isPaused = false;
     m_isEOS = false;
+    m_pushedEnd = 0;
 
     if(!m_pipeline) {
         // If pipe line is NULL, create one
@@ -857,10 +1074,28 @@ void TTSSpeaker::speakText(TTSConfiguration config, SpeechData &data) {
     if(m_pipeline && !m_pipelineError && !m_flushed) {
         m_currentSpeech = &data;
 
-        g_object_set(G_OBJECT(m_source), "location", constructURL(config, data).c_str(), NULL);
+        std::string url = constructURL(config, data);
+        AudioData audio;
+        if(m_audioCache) {
+            if(!m_audioCache->get(url, audio, !data.secure)) {
+                TTSLOG_ERROR("Failed to fetch audio for speech %d", data.id);
+                m_networkError = true;
+                m_currentSpeech = NULL;
+                return;
+            }
+            if(m_flushed) {
+                m_currentSpeech = NULL;
+                return;
+            }
+        } else {
+            g_object_set(G_OBJECT(m_source), "location", url.c_str(), NULL);
+        }
         // PCM Sink seems to be accepting volume change before PLAYING state
         g_object_set(G_OBJECT(m_audioVolume), "volume", (double) (data.client->configuration()->volume() / MAX_VOLUME), NULL);
         gst_element_set_state(m_pipeline, GST_STATE_PLAYING);
+        // appsrc is started by now and queues the audio until it prerolls
+        if(m_audioCache)
+            pushAudio(audio);
 #if defined(PLATFORM_AMLOGIC)
         //-12db is almost 25%
         setMixGain(MIXGAIN_PRIM,-12);
@@ -936,8 +1171,15 @@ void TTSSpeaker::GStreamerThreadFunc(void *ctx) {
             continue;
         }
 
+        if(speaker->m_gapless) {
+            speaker->speakGapless();
+            continue;
+        }
+
         TTSLOG_INFO("Got text input, list size=%d", speaker->m_queue.size());
         SpeechData data = speaker->dequeueData();
+        // Fetch what comes next while this one plays
+        speaker->prefetchQueued();
 
         speaker->setSpeakingState(true, data.client);
         // Inform the client before speaking
@@ -1056,7 +1298,8 @@ bool TTSSpeaker::handleMessage(GstMessage *message) {
 #endif
                             m_clientSpeaking->resumed(m_currentSpeech->id);
                             m_condition.notify_one();
-                        } else {
+                        } else if(!m_gapless) {
+                            // in gapless mode the position tells when a speech starts
                             m_clientSpeaking->started(m_currentSpeech->id, m_currentSpeech->text);
                         }
                     }
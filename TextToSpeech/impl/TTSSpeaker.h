@@ -32,6 +32,7 @@
 #include <condition_variable>
 
 #include "TTSCommon.h"
+#include "TTSAudioCache.h"
 
 #if defined(PLATFORM_AMLOGIC)
 #include "audio_if.h"
@@ -48,6 +49,19 @@ namespace TTS {
 #define LOOPBACK_ENDPOINT "http://127.0.0.1:50050/"
 #define LOCALHOST_ENDPOINT "http://localhost:50050/"
 
+// Audio cache, can be overridden from the environment (TTS_AUDIO_CACHE_*,
+// TTS_PREFETCH_COUNT). A memory size of 0 streams every speech from the
+// endpoint, as souphttpsrc did; off until validated on devices.
+#define TTS_AUDIO_CACHE_SIZE_KB 0
+#define TTS_AUDIO_CACHE_DISK_SIZE_KB 4096
+#define TTS_PREFETCH_COUNT 2
+
+// Gapless playback, with the audio cache on and TTS_GAPLESS_PLAYBACK=1
+#define TTS_GAPLESS_END_TOLERANCE_MS 60
+#define TTS_GAPLESS_STALL_MS 1000
+#define TTS_GAPLESS_START_TIMEOUT_MS 10000
+#define TTS_GAPLESS_POLL_MS 20
+
 // --- //
 
 class TTSConfiguration {
@@ -158,6 +172,29 @@ private:
     void flushQueue();
     SpeechData dequeueData();
 
+    // Audio of the speeches, fetched ahead for the queued ones
+    TTSAudioCache *m_audioCache;
+    uint8_t m_prefetchCount;
+    void prefetchQueued();
+    void pushAudio(AudioData &audio, bool endOfStream = true);
+
+    // Gapless playback: the pipeline keeps playing while speeches are
+    // queued and the next one is pushed as soon as the current one starts.
+    // Each speech is a clip of the stream, it starts and ends where the
+    // playback position crosses its boundaries.
+    struct Clip {
+        SpeechData data;
+        gint64 start;
+        gint64 end;
+        bool started;
+        uint32_t generation;
+    };
+    bool m_gapless;
+    gint64 m_pushedEnd;
+    uint32_t m_queueGeneration; // bumped when the queue is flushed
+    void speakGapless();
+    bool pushClip(std::list<Clip> &clips);
+
     // Private functions
     inline void setSpeakingState(bool state, TTSSpeakerClient *client=NULL);
 
@@ -0,0 +1,203 @@
+/*
+ * If not stated otherwise in this file or this component's LICENSE file the
+ * following copyright and licenses apply:
+ *
+ * Copyright 2020 RDK Management
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+// Plays a queue of speeches into a synchronised fake sink, once the way
+// TTSSpeaker used to (pipeline cycled through NULL and an EOS per speech) and
+// once gapless (pipeline kept playing, the next speech pushed as soon as the
+// current one starts). Reports the latency from request to first audio
+// sample of an idle speaker and the silence between queued speeches.
+//
+// Usage: TTSPlaybackBenchmark [speeches] [speech ms]
+
+#include "TTSAudioCache.h"
+
+#include <gst/gst.h>
+
+#include <stdio.h>
+#include <stdlib.h>
+
+#include <chrono>
+#include <condition_variable>
+#include <mutex>
+#include <vector>
+
+using namespace TTS;
+
+typedef std::chrono::steady_clock Clock;
+
+#define PCM_RATE 22050
+#define PCM_FRAME_BYTES 2
+
+struct Player {
+    GstElement *pipeline;
+    GstElement *source;
+    std::mutex mutex;
+    std::condition_variable condition;
+    gint64 waitFor;     // stream time of the first sample waited for, -1 for none
+    bool gotSample;
+    Clock::time_point firstSample;
+};
+
+static void onHandoff(GstElement*, GstBuffer *buffer, GstPad*, gpointer data) {
+    Player *player = static_cast<Player*>(data);
+    GstClockTime pts = GST_BUFFER_PTS(buffer);
+    GstClockTime duration = GST_BUFFER_DURATION(buffer);
+    std::lock_guard<std::mutex> lock(player->mutex);
+    if(player->waitFor >= 0 && !player->gotSample && GST_CLOCK_TIME_IS_VALID(pts) &&
+            (gint64)(pts + (GST_CLOCK_TIME_IS_VALID(duration) ? duration : 0)) > player->waitFor) {
+        player->gotSample = true;
+        player->firstSample = Clock::now();
+        player->condition.notify_all();
+    }
+}
+
+static void expectSample(Player &player, gint64 at) {
+    std::lock_guard<std::mutex> lock(player.mutex);
+    player.waitFor = at;
+    player.gotSample = false;
+}
+
+static Clock::time_point waitSample(Player &player) {
+    std::unique_lock<std::mutex> lock(player.mutex);
+    player.condition.wait(lock, [&player] () { return player.gotSample; });
+    return player.firstSample;
+}
+
+static void push(Player &player, const AudioData &audio) {
+    GstBuffer *buffer = gst_buffer_new_allocate(NULL, audio.size(), NULL);
+    gst_buffer_fill(buffer, 0, audio.data(), audio.size());
+    GstFlowReturn ret;
+    g_signal_emit_by_name(player.source, "push-buffer", buffer, &ret);
+    gst_buffer_unref(buffer);
+}
+
+static bool createPlayer(Player &player) {
+    GError *error = NULL;
+    player.pipeline = gst_parse_launch(
+            "appsrc name=source ! rawaudioparse use-sink-caps=false format=pcm pcm-format=s16le sample-rate=22050 num-channels=1 "
+            "! audioconvert ! fakesink name=sink sync=true signal-handoffs=true", &error);
+    if(!player.pipeline) {
+        printf("Failed to create pipeline: %s\n", error ? error->message : "");
+        if(error)
+            g_error_free(error);
+        return false;
+    }
+    player.source = gst_bin_get_by_name(GST_BIN(player.pipeline), "source");
+    GstElement *sink = gst_bin_get_by_name(GST_BIN(player.pipeline), "sink");
+    g_signal_connect(sink, "handoff", G_CALLBACK(onHandoff), &player);
+    gst_object_unref(sink);
+    player.waitFor = -1;
+    player.gotSample = false;
+    return true;
+}
+
+static void destroyPlayer(Player &player) {
+    gst_element_set_state(player.pipeline, GST_STATE_NULL);
+    gst_object_unref(player.source);
+    gst_object_unref(player.pipeline);
+}
+
+static double ms(Clock::duration d) {
+    return std::chrono::duration<double, std::milli>(d).count();
+}
+
+// Before: location set, NULL -> PLAYING, wait for EOS, back to NULL
+static void runCycled(const AudioData &speech, int count, double &startMs, double &gapMs) {
+    Player player;
+    if(!createPlayer(player))
+        exit(1);
+
+    uint64_t durationNs = audioDuration(speech, true);
+    GstBus *bus = gst_element_get_bus(player.pipeline);
+    Clock::time_point previous;
+    gapMs = 0;
+    for(int i = 0; i < count; i++) {
+        Clock::time_point request = Clock::now();
+        expectSample(player, 0);
+        gst_element_set_state(player.pipeline, GST_STATE_PLAYING);
+        push(player, speech);
+        GstFlowReturn ret;
+        g_signal_emit_by_name(player.source, "end-of-stream", &ret);
+
+        Clock::time_point first = waitSample(player);
+        if(i == 0)
+            startMs = ms(first - request);
+        else
+            gapMs += ms(first - previous) - durationNs / 1e6;
+        previous = first;
+
+        GstMessage *message = gst_bus_timed_pop_filtered(bus, GST_CLOCK_TIME_NONE,
+                (GstMessageType)(GST_MESSAGE_EOS | GST_MESSAGE_ERROR));
+        gst_message_unref(message);
+        gst_element_set_state(player.pipeline, GST_STATE_NULL);
+        gst_element_get_state(player.pipeline, NULL, NULL, GST_CLOCK_TIME_NONE);
+    }
+    gapMs /= (count - 1);
+    gst_object_unref(bus);
+    destroyPlayer(player);
+}
+
+// Now: READY while idle, then one stream the speeches are appended to
+static void runGapless(const AudioData &speech, int count, double &startMs, double &gapMs) {
+    Player player;
+    if(!createPlayer(player))
+        exit(1);
+    gst_element_set_state(player.pipeline, GST_STATE_READY);
+    gst_element_get_state(player.pipeline, NULL, NULL, GST_CLOCK_TIME_NONE);
+
+    uint64_t durationNs = audioDuration(speech, true);
+    Clock::time_point request = Clock::now();
+    expectSample(player, 0);
+    gst_element_set_state(player.pipeline, GST_STATE_PLAYING);
+    push(player, speech);
+
+    Clock::time_point previous = waitSample(player);
+    startMs = ms(previous - request);
+    gapMs = 0;
+    for(int i = 1; i < count; i++) {
+        expectSample(player, i * durationNs);
+        push(player, speech);
+        Clock::time_point first = waitSample(player);
+        gapMs += ms(first - previous) - durationNs / 1e6;
+        previous = first;
+    }
+    gapMs /= (count - 1);
+    destroyPlayer(player);
+}
+
+int main(int argc, char *argv[]) {
+    int count = (argc > 1) ? atoi(argv[1]) : 10;
+    int speechMs = (argc > 2) ? atoi(argv[2]) : 500;
+    if(count < 2 || speechMs <= 0) {
+        printf("Usage: %s [speeches >= 2] [speech ms]\n", argv[0]);
+        return 1;
+    }
+
+    gst_init(&argc, &argv);
+
+    AudioData speech((size_t)PCM_RATE * speechMs / 1000 * PCM_FRAME_BYTES, 0);
+    double cycledStart, cycledGap, gaplessStart, gaplessGap;
+    runCycled(speech, count, cycledStart, cycledGap);
+    runGapless(speech, count, gaplessStart, gaplessGap);
+
+    printf("%d speeches of %d ms into a synchronised fakesink\n", count, speechMs);
+    printf("  cycled pipeline:  request to first sample %.2f ms, silence between speeches %.2f ms\n", cycledStart, cycledGap);
+    printf("  gapless pipeline: request to first sample %.2f ms, silence between speeches %.2f ms\n", gaplessStart, gaplessGap);
+    return 0;
+}
@@ -48,6 +48,7 @@ namespace {
         {"getQuirks", &WifiManager::getQuirks},
         {"getCurrentState", &WifiManager::getCurrentState},
         {"startScan", &WifiManager::startScan},
+        {"getAvailableSSIDs", &WifiManager::getAvailableSSIDs},
         {"getConnectedSSID", &WifiManager::getConnectedSSID},
         {"getPairedSSID", &WifiManager::getPairedSSID},
         {"getPairedSSIDInfo", &WifiManager::getPairedSSIDInfo},
@@ -156,6 +157,16 @@ namespace WPEFramework
             return result;
         }
 
+        uint32_t WifiManager::getAvailableSSIDs(const JsonObject &parameters, JsonObject &response) const
+        {
+            LOGINFOMETHOD();
+
+            uint32_t const result = wifiScan.getAvailableSSIDs(parameters, response);
+
+            LOGTRACEMETHODFIN();
+            return result;
+        }
+
         uint32_t WifiManager::getConnectedSSID(const JsonObject &parameters, JsonObject &response) const
         {
             LOGINFOMETHOD();
@@ -364,6 +375,11 @@ namespace WPEFramework
             sendNotify("onAvailableSSIDs", ssids);
         }
 
+        void WifiManager::onAvailableSSIDsChanged(JsonObject const& changes)
+        {
+            sendNotify("onAvailableSSIDsChanged", changes);
+        }
+
         /**
         * \brief Get the current WifiManager instance
         *
@@ -76,6 +76,7 @@ namespace WPEFramework {
             virtual uint32_t setSignalThresholdChangeEnabled(const JsonObject& parameters, JsonObject& response) override;
             virtual uint32_t isSignalThresholdChangeEnabled(const JsonObject& parameters, JsonObject& response) const;
             virtual uint32_t getSupportedSecurityModes(const JsonObject& parameters, JsonObject& response) override;
+            virtual uint32_t getAvailableSSIDs(const JsonObject& parameters, JsonObject& response) const override;
             //End methods
 
             //Begin events
@@ -84,6 +85,7 @@ namespace WPEFramework {
             virtual void onSSIDsChanged() override;
             virtual void onWifiSignalThresholdChanged(float signalStrength, const std::string &strength) override;
             virtual void onAvailableSSIDs(JsonObject const& ssids) override;
+            virtual void onAvailableSSIDsChanged(JsonObject const& changes) override;
             //End events
 
             //Build QueryInterface implementation, specifying all possible interfaces to be returned.
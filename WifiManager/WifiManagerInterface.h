@@ -48,6 +48,7 @@ namespace WPEFramework {
             virtual uint32_t setSignalThresholdChangeEnabled(const JsonObject& parameters, JsonObject& response) = 0;
             virtual uint32_t isSignalThresholdChangeEnabled(const JsonObject& parameters, JsonObject& response) const = 0;
             virtual uint32_t getSupportedSecurityModes(const JsonObject& parameters, JsonObject& response) = 0;
+            virtual uint32_t getAvailableSSIDs(const JsonObject& parameters, JsonObject& response) const = 0;
             //End methods
 
             //Begin events
@@ -56,6 +57,7 @@ namespace WPEFramework {
             virtual void onSSIDsChanged() = 0;
             virtual void onWifiSignalThresholdChanged(float signalStrength, const std::string &strength) = 0;
             virtual void onAvailableSSIDs(JsonObject const& ssids) = 0;
+            virtual void onAvailableSSIDsChanged(JsonObject const& changes) = 0;
             //End events
         };
 
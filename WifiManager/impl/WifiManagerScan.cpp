@@ -32,7 +32,6 @@
 
 // std
 #include <sstream>
-#include <regex>
 
 using namespace WPEFramework;
 using namespace WPEFramework::Plugin;
@@ -43,19 +42,60 @@ namespace WPEJ = WPEFramework::Core::JSON;
 namespace
 {
     // Commonly used strings to avoid typos
+    char const* const g_added = "added";
+    char const* const g_bssid = "bssid";
+    char const* const g_changed = "changed";
     char const* const g_error = "error";
     char const* const g_ssid = "ssid";
     char const* const g_incremental = "incremental";
     char const* const g_frequency = "frequency";
     char const* const g_getAvailableSSIDs = "getAvailableSSIDs";
     char const* const g_getAvailableSSIDsWithName = "getAvailableSSIDsWithName";
+    char const* const g_minSignalStrength = "minSignalStrength";
     char const* const g_moreData = "moreData";
+    char const* const g_removed = "removed";
+    char const* const g_security = "security";
+    char const* const g_signalStrength = "signalStrength";
     char const* const g_ssids = "ssids";
     char const* const g_SSID_name = "SSID_name";
     char const* const g_timeout = "timeout";
+
+    WifiNetwork networkFromJson(const JsonObject& object)
+    {
+        WifiNetwork network;
+        if (object.HasLabel(g_bssid))
+            network.bssid = object[g_bssid].String();
+        network.ssid = object[g_ssid].String();
+        network.security = static_cast<int>(object[g_security].Number());
+        network.signalStrength = object[g_signalStrength].String();
+        network.frequency = object[g_frequency].String();
+        return network;
+    }
+
+    JsonObject networkToJson(const WifiNetwork& network)
+    {
+        JsonObject object;
+        if (!network.bssid.empty())
+            object[g_bssid] = network.bssid;
+        object[g_ssid] = network.ssid;
+        object[g_security] = network.security;
+        object[g_signalStrength] = network.signalStrength;
+        object[g_frequency] = network.frequency;
+        return object;
+    }
+
+    JsonArray networksToJson(const std::vector<WifiNetwork>& networks)
+    {
+        JsonArray array;
+        for (const auto& network : networks)
+            array.Add(networkToJson(network));
+        return array;
+    }
 }
 
-WifiManagerScan::Filter WifiManagerScan::filter = {};
+std::mutex WifiManagerScan::tableMutex;
+WifiScanFilter WifiManagerScan::filter;
+WifiScanTable WifiManagerScan::table;
 
 /**
  * \brief Register event handlers.
@@ -85,6 +125,9 @@ void WifiManagerScan::Deinitialize(PluginHost::IShell* service)
     IARM_Result_t res;
     IARM_CHECK(IARM_Bus_UnRegisterEventHandler(IARM_BUS_NM_SRV_MGR_NAME, IARM_BUS_WIFI_MGR_EVENT_onAvailableSSIDs));
     IARM_CHECK(IARM_Bus_UnRegisterEventHandler(IARM_BUS_NM_SRV_MGR_NAME, IARM_BUS_WIFI_MGR_EVENT_onAvailableSSIDsIncr));
+
+    std::lock_guard<std::mutex> lock(tableMutex);
+    table.clear();
 }
 
 /**
@@ -104,23 +147,15 @@ uint32_t WifiManagerScan::startScan(const JsonObject &parameters, JsonObject &re
     returnIfBooleanParamNotFound(parameters, g_incremental);
     const bool incremental = parameters[g_incremental].Boolean();
 
-    filter = {};
-
-    if (parameters.HasLabel(g_ssid)) {
-        std::string ssid;
-        getStringParameter(g_ssid, ssid);
-        if (ssid.length()) {
-            filter.onSsid = true;
-            filter.ssid = ssid;
-        }
+    WifiScanFilter scanFilter;
+    if (!parseFilter(parameters, scanFilter)) {
+        LOGERR("Incorrect regex: %s", parameters[g_ssid].String().c_str());
     }
-    if (parameters.HasLabel(g_frequency)) {
-        std::string frequency;
-        getStringParameter(g_frequency, frequency);
-        if (frequency.length()) {
-            filter.onFrequency = true;
-            filter.frequency = frequency;
-        }
+
+    {
+        std::lock_guard<std::mutex> lock(tableMutex);
+        filter = scanFilter;
+        table.beginScan();
     }
 
     if (incremental)
@@ -229,9 +264,69 @@ uint32_t WifiManagerScan::stopScan(const JsonObject& parameters, JsonObject& res
                     reinterpret_cast<void*>(&param),
                     sizeof(IARM_Bus_WiFiSrvMgr_Param_t)) );
 
+    {
+        // The networks the stopped scan did not get to are not gone
+        std::lock_guard<std::mutex> lock(tableMutex);
+        table.abortScan();
+    }
+
     returnResponse(res == IARM_RESULT_SUCCESS);
 }
 
+/**
+ * \brief Get the networks seen by the scans, without scanning.
+ *
+ * \param parameters        Optionally includes 'ssid' (a string literal or regular expression), 'frequency'
+ *                          and 'minSignalStrength' (dBm).
+ * \param[out] response     'ssids', strongest first, and 'success'.
+ * \return                  A code indicating success.
+ *
+ */
+uint32_t WifiManagerScan::getAvailableSSIDs(const JsonObject& parameters, JsonObject& response) const
+{
+    LOGINFOMETHOD();
+
+    WifiScanFilter queryFilter;
+    if (!parseFilter(parameters, queryFilter)) {
+        response[g_error] = "Incorrect regex";
+        returnResponse(false);
+    }
+
+    std::vector<WifiNetwork> networks;
+    {
+        std::lock_guard<std::mutex> lock(tableMutex);
+        WifiScanTable::Delta expired;
+        table.expire(expired);
+        table.query(queryFilter, networks);
+    }
+
+    response[g_ssids] = networksToJson(networks);
+    returnResponse(true);
+}
+
+/**
+ * \brief Build a filter from the 'ssid', 'frequency' and 'minSignalStrength' parameters.
+ *
+ * \return false if 'ssid' is not a valid regular expression.
+ *
+ */
+bool WifiManagerScan::parseFilter(const JsonObject& parameters, WifiScanFilter& filter)
+{
+    bool valid = true;
+
+    if (parameters.HasLabel(g_ssid)) {
+        valid = filter.setSsid(parameters[g_ssid].String());
+    }
+    if (parameters.HasLabel(g_frequency)) {
+        filter.setFrequency(parameters[g_frequency].String());
+    }
+    if (parameters.HasLabel(g_minSignalStrength)) {
+        filter.setMinSignal(static_cast<double>(parameters[g_minSignalStrength].Number()));
+    }
+
+    return valid;
+}
+
 /**
  * \brief Handle events from the IARM bus relating to wireless scanning.
  *
@@ -265,48 +360,36 @@ void WifiManagerScan::iarmEventHandler(char const* owner, IARM_EventId_t eventId
             return;
         }
 
+        // Merge the batch into the table, and publish it filtered as it came
         JsonArray ssids = eventDocument[g_getAvailableSSIDs].Array();
-        applyFilter(ssids, filter);
-
-        JsonObject params;
-        params[g_ssids] = ssids;
-        params[g_moreData] = eventData->data.wifiSSIDList.more_data;
-        WifiManager::getInstance().onAvailableSSIDs(params);
-    }
-}
-
-void WifiManagerScan::applyFilter(JsonArray &ssids, const WifiManagerScan::Filter &filter) {
-    JsonArray result;
-    std::regex re;
-    std::smatch m;
-    if(filter.onSsid)
-    {
-        try
-        {
-            re = std::regex(filter.ssid);
-        }
-        catch(const std::regex_error &e)
+        const bool moreData = eventData->data.wifiSSIDList.more_data;
+        std::vector<WifiNetwork> batch;
+        JsonArray filtered;
+        WifiScanTable::Delta delta;
         {
-           LOGERR("Incorrect regex: %s", e.what());
+            std::lock_guard<std::mutex> lock(tableMutex);
+            for (int i = 0; i < ssids.Length(); i++) {
+                JsonObject object = ssids[i].Object();
+                batch.push_back(networkFromJson(object));
+                if (filter.matches(batch.back()))
+                    filtered.Add(object);
+            }
+            table.merge(batch, delta);
+            if (!moreData)
+                table.endScan(delta);
         }
-    }
 
-    for(int i=0; i<ssids.Length(); i++) {
-        JsonObject object = ssids[i].Object();
-        if(filter.onSsid) {
-            std::string str = object[g_ssid].String();
+        JsonObject params;
+        params[g_ssids] = filtered;
+        params[g_moreData] = moreData;
+        WifiManager::getInstance().onAvailableSSIDs(params);
 
-            if(!std::regex_match(str, m, re)){
-                LOGINFO("SSID filter out %s ~= %s", str.c_str(), filter.ssid.c_str());
-                continue;
-            }
+        if (!delta.empty()) {
+            JsonObject changes;
+            changes[g_added] = networksToJson(delta.added);
+            changes[g_changed] = networksToJson(delta.changed);
+            changes[g_removed] = networksToJson(delta.removed);
+            WifiManager::getInstance().onAvailableSSIDsChanged(changes);
         }
-        if(filter.onFrequency && object[g_frequency].String() != filter.frequency) {
-            LOGINFO("Frequency filter out %s != %s", object[g_frequency].String().c_str(), filter.frequency.c_str());
-            continue;
-        }
-
-        result.Add(object);
     }
-    ssids = result;
 }
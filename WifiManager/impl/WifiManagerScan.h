@@ -20,7 +20,9 @@
 #pragma once
 
 #include "../Module.h"
+#include "WifiScanTable.h"
 
+#include <mutex>
 #include <string>
 
 // Forward declaration
@@ -44,6 +46,7 @@ namespace WPEFramework {
 
             uint32_t startScan(const JsonObject& parameters, JsonObject& response) const;
             uint32_t stopScan(const JsonObject& parameters, JsonObject& response);
+            uint32_t getAvailableSSIDs(const JsonObject& parameters, JsonObject& response) const;
 
         private:
             uint32_t getAvailableSSIDsAsync(const JsonObject& parameters, JsonObject& response) const;
@@ -51,15 +54,13 @@ namespace WPEFramework {
 
             static void iarmEventHandler(char const* owner, IARM_EventId_t eventId, void* data, size_t len);
 
-            struct Filter {
-                bool onSsid = false;
-                std::string ssid;
-                bool onFrequency = false;
-                std::string frequency;
-            };
+            static bool parseFilter(const JsonObject& parameters, WifiScanFilter& filter);
 
-            static void applyFilter(JsonArray &object, const WifiManagerScan::Filter &filter);
-            static Filter filter;
+            // The filter of the last scan started, and the networks seen by the scans.
+            // Written on the IARM event thread, read by the JSON-RPC methods.
+            static std::mutex tableMutex;
+            static WifiScanFilter filter;
+            static WifiScanTable table;
         };
     } // namespace Plugin
 } // namespace WPEFramework
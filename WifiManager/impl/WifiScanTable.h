@@ -0,0 +1,257 @@
+/**
+* If not stated otherwise in this file or this component's LICENSE
+* file the following copyright and licenses apply:
+*
+* Copyright 2020 RDK Management
+*
+* Licensed under the Apache License, Version 2.0 (the "License");
+* you may not use this file except in compliance with the License.
+* You may obtain a copy of the License at
+*
+* http://www.apache.org/licenses/LICENSE-2.0
+*
+* Unless required by applicable law or agreed to in writing, software
+* distributed under the License is distributed on an "AS IS" BASIS,
+* WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+* See the License for the specific language governing permissions and
+* limitations under the License.
+**/
+
+#pragma once
+
+#include <stdlib.h>
+
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <regex>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+namespace WPEFramework {
+    namespace Plugin {
+        /**
+         * A wireless network as reported in the 'getAvailableSSIDs' list of the scan events.
+         * The strings are kept as reported, since that is how they are published.
+         */
+        struct WifiNetwork {
+            std::string bssid;          // Not in every list, the SSID, frequency and security then identify the network
+            std::string ssid;
+            int security = 0;
+            std::string signalStrength; // dBm, e.g. "-27.000000"
+            std::string frequency;      // GHz, e.g. "2.442000"
+
+            double signal() const { return atof(signalStrength.c_str()); }
+        };
+
+        /**
+         * The SSID / frequency / signal strength filter of a scan, compiled once rather than for every result.
+         */
+        class WifiScanFilter {
+        public:
+            // The SSID is matched as a whole against the regular expression. An invalid expression matches
+            // nothing, as it did when it was compiled for each event.
+            bool setSsid(const std::string& pattern)
+            {
+                onSsid = !pattern.empty();
+                valid = true;
+                if (onSsid) {
+                    try {
+                        re = std::regex(pattern);
+                    } catch (const std::regex_error&) {
+                        valid = false;
+                    }
+                }
+                return valid;
+            }
+
+            void setFrequency(const std::string& value)
+            {
+                onFrequency = !value.empty();
+                frequency = value;
+            }
+
+            void setMinSignal(double dBm)
+            {
+                onSignal = true;
+                minSignal = dBm;
+            }
+
+            bool matches(const WifiNetwork& network) const
+            {
+                if (onSsid && (!valid || !std::regex_match(network.ssid, re)))
+                    return false;
+                if (onFrequency && (network.frequency != frequency))
+                    return false;
+                if (onSignal && (network.signal() < minSignal))
+                    return false;
+                return true;
+            }
+
+        private:
+            bool onSsid = false;
+            bool valid = true;
+            std::regex re;
+            bool onFrequency = false;
+            std::string frequency;
+            bool onSignal = false;
+            double minSignal = 0;
+        };
+
+        /**
+         * The networks seen by the scans, keyed by BSSID.
+         *
+         * The batches of a scan (one for a full scan, several for an incremental one) are merged into the
+         * table, which reports what was added, what changed and, once the scan is complete, what was not
+         * seen again. A signal strength change smaller than the hysteresis is not reported, otherwise
+         * every network would change on every scan. Networks not seen for maxAge are aged out even when
+         * no scan completes, e.g. when incremental scans are stopped early.
+         */
+        class WifiScanTable {
+        public:
+            typedef std::chrono::steady_clock Clock;
+
+            struct Delta {
+                std::vector<WifiNetwork> added;
+                std::vector<WifiNetwork> changed;
+                std::vector<WifiNetwork> removed;
+
+                bool empty() const { return added.empty() && changed.empty() && removed.empty(); }
+            };
+
+            explicit WifiScanTable(double signalHysteresis = 5.0, Clock::duration maxAge = std::chrono::seconds(120))
+                : m_signalHysteresis(signalHysteresis)
+                , m_maxAge(maxAge)
+                , m_scan(0)
+                , m_scanning(false)
+            {
+            }
+
+            // Batches received without a scan having been started begin one
+            void beginScan()
+            {
+                m_scan++;
+                m_scanning = true;
+            }
+
+            // A stopped scan is incomplete, so nothing is removed
+            void abortScan()
+            {
+                m_scanning = false;
+            }
+
+            void merge(const std::vector<WifiNetwork>& batch, Delta& delta, Clock::time_point now = Clock::now())
+            {
+                if (!m_scanning)
+                    beginScan();
+
+                for (const auto& network : batch) {
+                    auto it = m_entries.find(key(network));
+                    if (it == m_entries.end()) {
+                        Entry entry;
+                        entry.network = network;
+                        entry.reportedSignal = network.signal();
+                        entry.seen = now;
+                        entry.scan = m_scan;
+                        m_entries.emplace(key(network), entry);
+                        delta.added.push_back(network);
+                        continue;
+                    }
+
+                    Entry& entry = it->second;
+                    bool changed = (entry.network.ssid != network.ssid) ||
+                                   (entry.network.security != network.security) ||
+                                   (entry.network.frequency != network.frequency) ||
+                                   (std::fabs(network.signal() - entry.reportedSignal) >= m_signalHysteresis);
+                    entry.network = network;
+                    entry.seen = now;
+                    entry.scan = m_scan;
+                    if (changed) {
+                        entry.reportedSignal = network.signal();
+                        delta.changed.push_back(network);
+                    }
+                }
+
+                expire(delta, now);
+            }
+
+            // Networks that the completed scan did not see are gone
+            void endScan(Delta& delta)
+            {
+                if (!m_scanning)
+                    return;
+                m_scanning = false;
+                for (auto it = m_entries.begin(); it != m_entries.end();) {
+                    if (it->second.scan != m_scan) {
+                        delta.removed.push_back(it->second.network);
+                        it = m_entries.erase(it);
+                    } else {
+                        ++it;
+                    }
+                }
+            }
+
+            void expire(Delta& delta, Clock::time_point now = Clock::now())
+            {
+                for (auto it = m_entries.begin(); it != m_entries.end();) {
+                    if (now - it->second.seen > m_maxAge) {
+                        delta.removed.push_back(it->second.network);
+                        it = m_entries.erase(it);
+                    } else {
+                        ++it;
+                    }
+                }
+            }
+
+            // The networks matching the filter, strongest first
+            size_t query(const WifiScanFilter& filter, std::vector<WifiNetwork>& networks) const
+            {
+                networks.clear();
+                for (const auto& it : m_entries) {
+                    if (filter.matches(it.second.network))
+                        networks.push_back(it.second.network);
+                }
+                std::sort(networks.begin(), networks.end(), [](const WifiNetwork& a, const WifiNetwork& b) {
+                    double signalA = a.signal();
+                    double signalB = b.signal();
+                    if (signalA != signalB)
+                        return signalA > signalB;
+                    if (a.ssid != b.ssid)
+                        return a.ssid < b.ssid;
+                    return a.bssid < b.bssid;
+                });
+                return networks.size();
+            }
+
+            size_t size() const { return m_entries.size(); }
+
+            void clear()
+            {
+                m_entries.clear();
+                m_scanning = false;
+            }
+
+        private:
+            struct Entry {
+                WifiNetwork network;
+                double reportedSignal;
+                Clock::time_point seen;
+                unsigned long scan;
+            };
+
+            static std::string key(const WifiNetwork& network)
+            {
+                if (!network.bssid.empty())
+                    return network.bssid;
+                return network.ssid + '\n' + network.frequency + '\n' + std::to_string(network.security);
+            }
+
+            double m_signalHysteresis;
+            Clock::duration m_maxAge;
+            unsigned long m_scan;
+            bool m_scanning;
+            std::unordered_map<std::string, Entry> m_entries;
+        };
+    } // namespace Plugin
+} // namespace WPEFramework
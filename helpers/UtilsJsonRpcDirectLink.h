@@ -0,0 +1,263 @@
+/**
+* If not stated otherwise in this file or this component's LICENSE
+* file the following copyright and licenses apply:
+*
+* Copyright 2020 RDK Management
+*
+* Licensed under the Apache License, Version 2.0 (the "License");
+* you may not use this file except in compliance with the License.
+* You may obtain a copy of the License at
+*
+* http://www.apache.org/licenses/LICENSE-2.0
+*
+* Unless required by applicable law or agreed to in writing, software
+* distributed under the License is distributed on an "AS IS" BASIS,
+* WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+* See the License for the specific language governing permissions and
+* limitations under the License.
+**/
+
+#pragma once
+
+#include <iostream>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <string>
+
+#include <core/core.h>
+#include <plugins/plugins.h>
+
+#include "UtilsLinkPool.h"
+
+namespace Utils
+{
+    typedef LinkPool<WPEFramework::JSONRPC::LinkType<WPEFramework::Core::JSON::IElement>> JsonRpcLinkPool;
+
+    // WebSocket links of a plugin to the other plugins, by the callsign of
+    // the plugin. This header is built into every plugin library and the
+    // statics of its inline functions end up shared by all of them in the
+    // process, so the pools of all plugins are kept here side by side and a
+    // plugin only uses and drops its own. A pool takes the security token
+    // of the first call of its plugin passing one.
+    inline JsonRpcLinkPool& jsonRpcLinkPool(const std::string& owner, const std::string& token = "")
+    {
+        struct Owned
+        {
+            Owned()
+                : pool(
+                      [this](const std::string& designator) {
+                          std::string linkQuery;
+                          {
+                              std::lock_guard<std::mutex> lock(queryMutex);
+                              linkQuery = query;
+                          }
+                          WPEFramework::Core::SystemInfo::SetEnvironment(_T("THUNDER_ACCESS"), _T("127.0.0.1:9998"));
+                          return std::make_shared<WPEFramework::JSONRPC::LinkType<WPEFramework::Core::JSON::IElement>>(designator, "", false, linkQuery);
+                      },
+                      [](uint32_t status) {
+                          return (status == WPEFramework::Core::ERROR_ASYNC_FAILED) || (status == WPEFramework::Core::ERROR_TIMEDOUT)
+                              || (status == WPEFramework::Core::ERROR_CONNECTION_CLOSED) || (status == WPEFramework::Core::ERROR_UNAVAILABLE);
+                      },
+                      WPEFramework::Core::ERROR_UNAVAILABLE)
+            {
+            }
+
+            std::mutex queryMutex;
+            std::string query;
+            JsonRpcLinkPool pool;
+        };
+
+        static std::mutex poolsMutex;
+        // Never erased, the links of a plugin may still refer to its pool
+        static std::map<std::string, std::unique_ptr<Owned>> pools;
+
+        Owned* owned;
+        {
+            std::lock_guard<std::mutex> lock(poolsMutex);
+            std::unique_ptr<Owned>& entry = pools[owner];
+            if (!entry)
+            {
+                entry.reset(new Owned());
+            }
+            owned = entry.get();
+        }
+        if (!token.empty())
+        {
+            std::lock_guard<std::mutex> lock(owned->queryMutex);
+            if (owned->query.empty())
+            {
+                owned->query = "token=" + token;
+            }
+        }
+        return owned->pool;
+    }
+
+    // Logs the call statistics of the pooled links of a plugin and drops
+    // them. For the Deinitialize of the plugin, so none outlives it; the
+    // links of the other plugins are left alone.
+    inline void releaseJsonRpcLinks(const std::string& owner)
+    {
+        JsonRpcLinkPool& pool = jsonRpcLinkPool(owner);
+        for (const auto& statistics : pool.GetStatistics())
+        {
+            std::cout << "Link " << owner << " to " << statistics.designator << ": " << statistics.calls << " calls, "
+                      << statistics.failures << " failures, " << statistics.connects << " connects, average "
+                      << ((statistics.calls > 0) ? statistics.totalUs / statistics.calls : 0) << "us, max "
+                      << statistics.maxUs << "us\n";
+        }
+        pool.Clear();
+    }
+
+    // JSON-RPC client for another plugin, with the Get/Set/Invoke of
+    // JSONRPC::LinkType. When the plugin is resolved in this process the
+    // request is handed straight to its IDispatcher, without the WebSocket
+    // round trip through the Thunder server. If it is not, e.g. because it is
+    // not activated yet, the call goes over the LINK of the plugin in pool.
+    template <typename LINK>
+    class JSONRPCDirectLinkType
+    {
+    public:
+        JSONRPCDirectLinkType(WPEFramework::PluginHost::IShell* service, const std::string& callsign, const std::string& token, LinkPool<LINK>& pool)
+            : mId(0)
+            , mCallSign(callsign)
+            , mToken(token)
+            , mDispatcher(nullptr)
+            , mPool(pool)
+        {
+            if (service != nullptr)
+            {
+                mDispatcher = service->QueryInterfaceByCallsign<WPEFramework::PluginHost::IDispatcher>(mCallSign);
+            }
+        }
+
+        ~JSONRPCDirectLinkType()
+        {
+            if (mDispatcher != nullptr)
+            {
+                mDispatcher->Release();
+            }
+        }
+
+        JSONRPCDirectLinkType(const JSONRPCDirectLinkType&) = delete;
+        JSONRPCDirectLinkType& operator=(const JSONRPCDirectLinkType&) = delete;
+
+        // Whether calls are dispatched in process
+        bool IsDirect() const
+        {
+            return mDispatcher != nullptr;
+        }
+
+        template <typename RESPONSE>
+        uint32_t Get(const uint32_t waitTime, const std::string& method, RESPONSE& response)
+        {
+            JsonObject empty;
+            return Invoke(waitTime, method, empty, response);
+        }
+
+        template <typename PARAMETERS>
+        uint32_t Set(const uint32_t waitTime, const std::string& method, const PARAMETERS& parameters)
+        {
+            JsonObject empty;
+            return Invoke(waitTime, method, parameters, empty);
+        }
+
+        // isResponseString skips parsing the result, for methods like the
+        // Controller clone that return a plain string
+        template <typename PARAMETERS, typename RESPONSE>
+        uint32_t Invoke(const uint32_t waitTime, const std::string& method, const PARAMETERS& parameters, RESPONSE& response, bool isResponseString = false)
+        {
+            if (mDispatcher == nullptr)
+            {
+                if (isResponseString)
+                {
+                    WPEFramework::Core::JSON::String result;
+                    return mPool.Invoke(mCallSign + ".1", waitTime, method, parameters, result);
+                }
+                return mPool.Invoke(mCallSign + ".1", waitTime, method, parameters, response);
+            }
+
+            auto message = Message();
+            message->JSONRPC = WPEFramework::Core::JSONRPC::Message::DefaultVersion;
+            message->Id = WPEFramework::Core::JSON::DecUInt32(++mId);
+            message->Designator = WPEFramework::Core::JSON::String(mCallSign + ".1." + method);
+
+            if (!ToMessage((WPEFramework::Core::JSON::IElement*)(&parameters), message))
+            {
+                return WPEFramework::Core::ERROR_GENERAL;
+            }
+
+            const uint32_t channelId = ~0;
+            auto resp = mDispatcher->Invoke(mToken, channelId, *message);
+            if (resp->Error.IsSet())
+            {
+                std::cout << "Call failed: " << message->Designator.Value() << " error: " << resp->Error.Text.Value() << "\n";
+                return resp->Error.Code;
+            }
+
+            if (!isResponseString && !FromMessage((WPEFramework::Core::JSON::IElement*)(&response), resp))
+            {
+                return WPEFramework::Core::ERROR_GENERAL;
+            }
+            return WPEFramework::Core::ERROR_NONE;
+        }
+
+    private:
+        WPEFramework::Core::ProxyType<WPEFramework::Core::JSONRPC::Message> Message() const
+        {
+            return (WPEFramework::Core::ProxyType<WPEFramework::Core::JSONRPC::Message>(WPEFramework::PluginHost::IFactories::Instance().JSONRPC()));
+        }
+
+        bool ToMessage(const WPEFramework::Core::JSON::IElement* parameters, WPEFramework::Core::ProxyType<WPEFramework::Core::JSONRPC::Message>& message) const
+        {
+            if (!parameters->IsSet())
+            {
+                return true;
+            }
+            std::string values;
+            if (!parameters->ToString(values))
+            {
+                std::cout << "Failed to convert params to string\n";
+                return false;
+            }
+            if (!values.empty())
+            {
+                message->Parameters = values;
+            }
+            return true;
+        }
+
+        bool FromMessage(WPEFramework::Core::JSON::IElement* response, const WPEFramework::Core::ProxyType<WPEFramework::Core::JSONRPC::Message>& message) const
+        {
+            WPEFramework::Core::OptionalType<WPEFramework::Core::JSON::Error> error;
+            if (!response->FromString(message->Result.Value(), error))
+            {
+                std::cout << "Failed to parse response!!! Error: '" << error.Value().Message() << "'\n";
+                return false;
+            }
+            return true;
+        }
+
+        uint32_t mId;
+        std::string mCallSign;
+        std::string mToken;
+        WPEFramework::PluginHost::IDispatcher* mDispatcher;
+        LinkPool<LINK>& mPool;
+    };
+
+    // Falls back on the WebSocket links of the plugin of service, see
+    // jsonRpcLinkPool
+    class JSONRPCDirectLink : public JSONRPCDirectLinkType<WPEFramework::JSONRPC::LinkType<WPEFramework::Core::JSON::IElement>>
+    {
+    public:
+        JSONRPCDirectLink(WPEFramework::PluginHost::IShell* service, const std::string& callsign, const std::string& token = "")
+            : JSONRPCDirectLinkType(service, callsign, token, jsonRpcLinkPool((service != nullptr) ? service->Callsign() : std::string(), token))
+        {
+        }
+
+        JSONRPCDirectLink(WPEFramework::PluginHost::IShell* service)
+            : JSONRPCDirectLink(service, "Controller")
+        {
+        }
+    };
+}
@@ -0,0 +1,176 @@
+/**
+* If not stated otherwise in this file or this component's LICENSE
+* file the following copyright and licenses apply:
+*
+* Copyright 2020 RDK Management
+*
+* Licensed under the Apache License, Version 2.0 (the "License");
+* you may not use this file except in compliance with the License.
+* You may obtain a copy of the License at
+*
+* http://www.apache.org/licenses/LICENSE-2.0
+*
+* Unless required by applicable law or agreed to in writing, software
+* distributed under the License is distributed on an "AS IS" BASIS,
+* WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+* See the License for the specific language governing permissions and
+* limitations under the License.
+**/
+
+#pragma once
+
+#include <stdint.h>
+#include <algorithm>
+#include <chrono>
+#include <functional>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <vector>
+
+namespace Utils
+{
+    // Links to other plugins kept open and shared, one per designator
+    // ("callsign.version"), instead of a new connection and handshake for
+    // every call. Concurrent calls share the link, which matches responses
+    // to requests by id. A call failing on the link itself drops it; the next
+    // call reconnects, after a backoff that doubles with every failure in a
+    // row so an absent plugin is not hammered.
+    template <typename LINK>
+    class LinkPool
+    {
+    public:
+        typedef std::chrono::steady_clock Clock;
+        typedef std::function<std::shared_ptr<LINK>(const std::string& designator)> Factory;
+        // Whether a call status means the link is broken, not the call
+        typedef std::function<bool(uint32_t status)> LinkFailure;
+
+        struct Statistics
+        {
+            std::string designator;
+            uint32_t calls;
+            uint32_t failures;
+            uint32_t connects;
+            uint64_t totalUs;
+            uint64_t maxUs;
+        };
+
+        LinkPool(const Factory& factory, const LinkFailure& linkFailure, uint32_t unavailableStatus, uint32_t minBackoffMs = 100, uint32_t maxBackoffMs = 10000)
+            : mFactory(factory)
+            , mLinkFailure(linkFailure)
+            , mUnavailableStatus(unavailableStatus)
+            , mMinBackoffMs(minBackoffMs)
+            , mMaxBackoffMs(maxBackoffMs)
+        {
+        }
+
+        LinkPool(const LinkPool&) = delete;
+        LinkPool& operator=(const LinkPool&) = delete;
+
+        // The open link for designator, connecting if there is none. Null
+        // while backing off after a failure.
+        std::shared_ptr<LINK> Get(const std::string& designator)
+        {
+            std::lock_guard<std::mutex> lock(mMutex);
+            Entry& entry = mEntries[designator];
+            if (!entry.link && (Clock::now() >= entry.retryAt))
+            {
+                entry.link = mFactory(designator);
+                entry.statistics.connects++;
+            }
+            return entry.link;
+        }
+
+        template <typename PARAMETERS, typename RESPONSE>
+        uint32_t Invoke(const std::string& designator, const uint32_t waitTime, const std::string& method, const PARAMETERS& parameters, RESPONSE& response)
+        {
+            std::shared_ptr<LINK> link = Get(designator);
+            if (!link)
+            {
+                Completed(designator, link, mUnavailableStatus, 0);
+                return mUnavailableStatus;
+            }
+
+            Clock::time_point start = Clock::now();
+            uint32_t status = link->template Invoke<PARAMETERS, RESPONSE>(waitTime, method, parameters, response);
+            uint64_t durationUs = std::chrono::duration_cast<std::chrono::microseconds>(Clock::now() - start).count();
+            Completed(designator, link, status, durationUs);
+            return status;
+        }
+
+        // Drops all links, e.g. when the plugin using the pool goes away
+        void Clear()
+        {
+            std::lock_guard<std::mutex> lock(mMutex);
+            mEntries.clear();
+        }
+
+        std::vector<Statistics> GetStatistics()
+        {
+            std::vector<Statistics> result;
+            std::lock_guard<std::mutex> lock(mMutex);
+            for (const auto& entry : mEntries)
+            {
+                result.push_back(entry.second.statistics);
+                result.back().designator = entry.first;
+            }
+            return result;
+        }
+
+    private:
+        struct Entry
+        {
+            Entry()
+                : backoffMs(0)
+            {
+                statistics.calls = 0;
+                statistics.failures = 0;
+                statistics.connects = 0;
+                statistics.totalUs = 0;
+                statistics.maxUs = 0;
+            }
+
+            std::shared_ptr<LINK> link;
+            Clock::time_point retryAt;
+            uint32_t backoffMs;
+            Statistics statistics;
+        };
+
+        void Completed(const std::string& designator, const std::shared_ptr<LINK>& link, uint32_t status, uint64_t durationUs)
+        {
+            std::lock_guard<std::mutex> lock(mMutex);
+            Entry& entry = mEntries[designator];
+            entry.statistics.calls++;
+            entry.statistics.totalUs += durationUs;
+            entry.statistics.maxUs = std::max(entry.statistics.maxUs, durationUs);
+            if (!link)
+            {
+                entry.statistics.failures++;
+            }
+            else if (mLinkFailure(status))
+            {
+                entry.statistics.failures++;
+                // a concurrent call may have replaced the link already
+                if (entry.link == link)
+                {
+                    entry.link.reset();
+                    entry.backoffMs = (entry.backoffMs == 0) ? mMinBackoffMs : std::min(entry.backoffMs * 2, mMaxBackoffMs);
+                    entry.retryAt = Clock::now() + std::chrono::milliseconds(entry.backoffMs);
+                }
+            }
+            else if (entry.link == link)
+            {
+                entry.backoffMs = 0;
+            }
+        }
+
+        std::mutex mMutex;
+        Factory mFactory;
+        LinkFailure mLinkFailure;
+        uint32_t mUnavailableStatus;
+        uint32_t mMinBackoffMs;
+        uint32_t mMaxBackoffMs;
+        std::map<std::string, Entry> mEntries;
+    };
+}
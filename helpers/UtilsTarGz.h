@@ -0,0 +1,491 @@
+/**
+* If not stated otherwise in this file or this component's LICENSE
+* file the following copyright and licenses apply:
+*
+* Copyright 2020 RDK Management
+*
+* Licensed under the Apache License, Version 2.0 (the "License");
+* you may not use this file except in compliance with the License.
+* You may obtain a copy of the License at
+*
+* http://www.apache.org/licenses/LICENSE-2.0
+*
+* Unless required by applicable law or agreed to in writing, software
+* distributed under the License is distributed on an "AS IS" BASIS,
+* WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+* See the License for the specific language governing permissions and
+* limitations under the License.
+**/
+
+#pragma once
+
+#include <dirent.h>
+#include <errno.h>
+#include <fcntl.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <string.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#include <zlib.h>
+#include <algorithm>
+#include <fstream>
+#include <map>
+#include <sstream>
+#include <string>
+#include <vector>
+
+namespace Utils
+{
+namespace TarGz
+{
+    // How much of a file has been archived. The file is known by its inode,
+    // so a file that was replaced or truncated (rotated) since is archived
+    // from the start again.
+    struct Offset
+    {
+        uint64_t inode;
+        uint64_t size;
+    };
+
+    // By path relative to the archived directory
+    typedef std::map<std::string, Offset> Offsets;
+
+    // One "<inode> <size> <path>" line per file
+    inline bool loadOffsets(const std::string& path, Offsets& offsets)
+    {
+        offsets.clear();
+        std::ifstream file(path);
+        if (!file.is_open())
+            return false;
+
+        std::string line;
+        while (std::getline(file, line))
+        {
+            std::istringstream fields(line);
+            Offset offset;
+            std::string name;
+            if ((fields >> offset.inode >> offset.size) && (fields.get() == ' ') && std::getline(fields, name) && !name.empty())
+                offsets[name] = offset;
+        }
+        return true;
+    }
+
+    // Written aside and renamed, so an interrupted save leaves the previous offsets
+    inline bool saveOffsets(const std::string& path, const Offsets& offsets)
+    {
+        std::string tmp = path + ".tmp";
+        {
+            std::ofstream file(tmp, std::ios::trunc);
+            if (!file.is_open())
+                return false;
+            for (const auto& it : offsets)
+                file << it.second.inode << ' ' << it.second.size << ' ' << it.first << '\n';
+            file.flush();
+            if (!file.good())
+                return false;
+        }
+        return (rename(tmp.c_str(), path.c_str()) == 0);
+    }
+
+    // A .tgz of the regular files under a directory, produced as it is read:
+    // the files are read, put in tar blocks and compressed a buffer at a time,
+    // so neither the archive nor a file is ever held in memory or written out.
+    // read() has the shape of a curl read callback.
+    //
+    // The sizes of the files are taken when the writer is opened; what is
+    // appended to a file while it is archived is left for the next archive,
+    // and a file that shrinks meanwhile is padded with zeros.
+    //
+    // Given the offsets of a previous archive, only what was appended to the
+    // files since is archived, under the same names, and the files with
+    // nothing new are left out.
+    class Writer
+    {
+    public:
+        explicit Writer(size_t bufferSize = 64 * 1024, int level = Z_DEFAULT_COMPRESSION)
+            : mBuffer(std::max<size_t>(bufferSize / BLOCK, 2) * BLOCK)
+            , mLevel(level)
+            , mOpen(false)
+            , mFailed(false)
+            , mFinished(false)
+            , mInputDone(false)
+            , mInLength(0)
+            , mNext(0)
+            , mFd(-1)
+            , mHeaderPosition(0)
+            , mPosition(0)
+            , mRemaining(0)
+            , mZeros(0)
+            , mTrailer(false)
+            , mBytesIn(0)
+            , mBytesOut(0)
+        {
+            memset(&mStream, 0, sizeof(mStream));
+        }
+
+        Writer(const Writer&) = delete;
+        Writer& operator=(const Writer&) = delete;
+
+        ~Writer()
+        {
+            close();
+        }
+
+        // Lists the files to archive; the names in the archive are
+        // "./<path relative to directory>", as with "tar -C directory ./"
+        bool open(const std::string& directory, const Offsets* since = nullptr)
+        {
+            close();
+            mFailed = mFinished = mInputDone = mTrailer = false;
+            mEntries.clear();
+            mOffsets.clear();
+            mError.clear();
+            mInLength = mNext = 0;
+            mHeader.clear();
+            mHeaderPosition = 0;
+            mPosition = mRemaining = mZeros = 0;
+            mBytesIn = mBytesOut = 0;
+
+            // deflate with a gzip header and trailer
+            if (deflateInit2(&mStream, mLevel, Z_DEFLATED, 15 + 16, 8, Z_DEFAULT_STRATEGY) != Z_OK)
+                return fail("deflateInit2 failed");
+            mOpen = true;
+
+            std::string root = directory;
+            while ((root.size() > 1) && (root.back() == '/'))
+                root.pop_back();
+            if (!list(root, std::string()))
+                return false;
+            std::sort(mEntries.begin(), mEntries.end(), [](const Entry& a, const Entry& b) {
+                return a.name < b.name;
+            });
+
+            for (auto it = mEntries.begin(); it != mEntries.end();)
+            {
+                Offset& offset = mOffsets[it->name];
+                offset.inode = it->inode;
+                offset.size = it->size;
+
+                if (since != nullptr)
+                {
+                    auto previous = since->find(it->name);
+                    if ((previous != since->end()) && (previous->second.inode == it->inode) && (previous->second.size <= it->size))
+                    {
+                        it->start = previous->second.size;
+                        it->size -= it->start;
+                        if (it->size == 0)
+                        {
+                            it = mEntries.erase(it);
+                            continue;
+                        }
+                    }
+                }
+                ++it;
+            }
+            return true;
+        }
+
+        // The next bytes of the archive, 0 once it is complete or on failure
+        size_t read(char* data, size_t size)
+        {
+            if (!mOpen || mFailed || mFinished || (size == 0))
+                return 0;
+
+            mStream.next_out = reinterpret_cast<Bytef*>(data);
+            mStream.avail_out = static_cast<uInt>(std::min<size_t>(size, UINT32_MAX));
+            uInt requested = mStream.avail_out;
+
+            while ((mStream.avail_out > 0) && !mFinished)
+            {
+                if ((mStream.avail_in == 0) && !mInputDone)
+                {
+                    if (!fill())
+                        return 0;
+                    mStream.next_in = reinterpret_cast<Bytef*>(mBuffer.data());
+                    mStream.avail_in = static_cast<uInt>(mInLength);
+                }
+
+                int flush = (mInputDone && (mStream.avail_in == 0)) ? Z_FINISH : Z_NO_FLUSH;
+                int ret = deflate(&mStream, flush);
+                if (ret == Z_STREAM_END)
+                    mFinished = true;
+                else if ((ret != Z_OK) && (ret != Z_BUF_ERROR))
+                {
+                    fail("deflate failed");
+                    return 0;
+                }
+            }
+
+            size_t length = requested - mStream.avail_out;
+            mBytesOut += length;
+            return length;
+        }
+
+        void close()
+        {
+            if (mFd >= 0)
+            {
+                ::close(mFd);
+                mFd = -1;
+            }
+            if (mOpen)
+            {
+                deflateEnd(&mStream);
+                memset(&mStream, 0, sizeof(mStream));
+                mOpen = false;
+            }
+        }
+
+        bool failed() const { return mFailed; }
+        bool finished() const { return mFinished; }
+        const std::string& error() const { return mError; }
+
+        // The files to archive
+        size_t files() const { return mEntries.size(); }
+        // Of the files, and of the archive read so far
+        uint64_t bytesIn() const { return mBytesIn; }
+        uint64_t bytesOut() const { return mBytesOut; }
+
+        // What the archive holds, to be saved once it was delivered and
+        // given to the next writer
+        const Offsets& offsets() const { return mOffsets; }
+
+    private:
+        static const size_t BLOCK = 512;
+
+        struct Entry
+        {
+            std::string name;
+            std::string path;
+            uint64_t inode;
+            mode_t mode;
+            time_t mtime;
+            uint64_t start;
+            uint64_t size;
+        };
+
+        bool fail(const std::string& error)
+        {
+            mFailed = true;
+            mError = error;
+            return false;
+        }
+
+        bool list(const std::string& directory, const std::string& relative)
+        {
+            std::string path = relative.empty() ? directory : (directory + "/" + relative);
+            DIR* dir = opendir(path.c_str());
+            if (dir == nullptr)
+                return fail("can't open " + path + ": " + strerror(errno));
+
+            struct dirent* entry;
+            std::vector<std::string> subdirectories;
+            while ((entry = readdir(dir)) != nullptr)
+            {
+                if ((strcmp(entry->d_name, ".") == 0) || (strcmp(entry->d_name, "..") == 0))
+                    continue;
+
+                std::string name = relative.empty() ? entry->d_name : (relative + "/" + entry->d_name);
+                std::string file = directory + "/" + name;
+                struct stat st;
+                if (lstat(file.c_str(), &st) != 0)
+                    continue;
+
+                if (S_ISDIR(st.st_mode))
+                    subdirectories.push_back(name);
+                else if (S_ISREG(st.st_mode))
+                {
+                    Entry e;
+                    e.name = name;
+                    e.path = file;
+                    e.inode = st.st_ino;
+                    e.mode = st.st_mode & 07777;
+                    e.mtime = st.st_mtime;
+                    e.start = 0;
+                    e.size = st.st_size;
+                    mEntries.push_back(e);
+                }
+            }
+            closedir(dir);
+
+            for (const auto& subdirectory : subdirectories)
+            {
+                if (!list(directory, subdirectory))
+                    return false;
+            }
+            return true;
+        }
+
+        // Zero padded octal digits and a NUL, or as GNU tar does for values
+        // too large for them, base-256 big-endian after a 0x80 byte
+        static void octal(char* field, size_t length, uint64_t value)
+        {
+            if ((length - 1) * 3 >= 64 || value < (1ULL << ((length - 1) * 3)))
+            {
+                field[length - 1] = '\0';
+                for (size_t i = length - 1; i > 0; i--)
+                {
+                    field[i - 1] = static_cast<char>('0' + (value & 7));
+                    value >>= 3;
+                }
+                return;
+            }
+
+            for (size_t i = length; i > 1; i--)
+            {
+                field[i - 1] = static_cast<char>(value & 0xff);
+                value >>= 8;
+            }
+            field[0] = static_cast<char>(0x80);
+        }
+
+        // A GNU tar header, preceded by a long name entry when the name does
+        // not fit in the header
+        static std::string header(const std::string& name, char type, mode_t mode, uint64_t size, time_t mtime)
+        {
+            std::string result;
+            if (name.size() >= 100)
+                result = header("././@LongLink", 'L', 0644, name.size() + 1, 0) + padded(name + '\0');
+
+            char block[BLOCK];
+            memset(block, 0, sizeof(block));
+            memcpy(block, name.c_str(), std::min<size_t>(name.size(), 99));
+            octal(block + 100, 8, mode);
+            octal(block + 108, 8, 0);
+            octal(block + 116, 8, 0);
+            octal(block + 124, 12, size);
+            octal(block + 136, 12, static_cast<uint64_t>(mtime));
+            block[156] = type;
+            memcpy(block + 257, "ustar  ", 8);
+
+            memset(block + 148, ' ', 8);
+            unsigned checksum = 0;
+            for (size_t i = 0; i < BLOCK; i++)
+                checksum += static_cast<unsigned char>(block[i]);
+            octal(block + 148, 7, checksum);
+
+            result.append(block, BLOCK);
+            return result;
+        }
+
+        static std::string padded(const std::string& data)
+        {
+            std::string result = data;
+            result.resize(((data.size() + BLOCK - 1) / BLOCK) * BLOCK, '\0');
+            return result;
+        }
+
+        // The next buffer of tar
+        bool fill()
+        {
+            mInLength = 0;
+            while ((mInLength < mBuffer.size()) && !mInputDone)
+            {
+                size_t space = mBuffer.size() - mInLength;
+                char* out = mBuffer.data() + mInLength;
+
+                if (mHeaderPosition < mHeader.size())
+                {
+                    size_t length = std::min(space, mHeader.size() - mHeaderPosition);
+                    memcpy(out, mHeader.data() + mHeaderPosition, length);
+                    mHeaderPosition += length;
+                    mInLength += length;
+                }
+                else if (mRemaining > 0)
+                {
+                    size_t length = static_cast<size_t>(std::min<uint64_t>(space, mRemaining));
+                    ssize_t count = pread(mFd, out, length, static_cast<off_t>(mPosition));
+                    if (count < 0)
+                    {
+                        if (errno == EINTR)
+                            continue;
+                        return fail("can't read " + mEntries[mNext - 1].path + ": " + strerror(errno));
+                    }
+                    if (count == 0)
+                    {
+                        // Shrank: the size in the header still has to be honoured
+                        mZeros += mRemaining;
+                        mRemaining = 0;
+                        continue;
+                    }
+                    mPosition += count;
+                    mRemaining -= count;
+                    mInLength += count;
+                    mBytesIn += count;
+                }
+                else if (mZeros > 0)
+                {
+                    size_t length = static_cast<size_t>(std::min<uint64_t>(space, mZeros));
+                    memset(out, 0, length);
+                    mZeros -= length;
+                    mInLength += length;
+                }
+                else
+                {
+                    if (mFd >= 0)
+                    {
+                        ::close(mFd);
+                        mFd = -1;
+                    }
+                    if (mTrailer)
+                        mInputDone = true;
+                    else if (mNext < mEntries.size())
+                        start(mNext++);
+                    else
+                    {
+                        // End of archive: two zero blocks
+                        mZeros = 2 * BLOCK;
+                        mTrailer = true;
+                    }
+                }
+            }
+            return true;
+        }
+
+        void start(size_t index)
+        {
+            Entry& entry = mEntries[index];
+            mFd = ::open(entry.path.c_str(), O_RDONLY | O_CLOEXEC);
+            if (mFd < 0)
+            {
+                // Removed since it was listed
+                mOffsets.erase(entry.name);
+                mHeader.clear();
+                mHeaderPosition = 0;
+                return;
+            }
+
+            mHeader = header("./" + entry.name, '0', entry.mode, entry.size, entry.mtime);
+            mHeaderPosition = 0;
+            mPosition = entry.start;
+            mRemaining = entry.size;
+            mZeros = (BLOCK - (entry.size % BLOCK)) % BLOCK;
+        }
+
+        std::vector<char> mBuffer;
+        int mLevel;
+        z_stream mStream;
+        bool mOpen;
+        bool mFailed;
+        bool mFinished;
+        bool mInputDone;
+        size_t mInLength;
+        std::vector<Entry> mEntries;
+        Offsets mOffsets;
+        std::string mError;
+
+        size_t mNext;
+        int mFd;
+        std::string mHeader;
+        size_t mHeaderPosition;
+        uint64_t mPosition;
+        uint64_t mRemaining;
+        uint64_t mZeros;
+        bool mTrailer;
+
+        uint64_t mBytesIn;
+        uint64_t mBytesOut;
+    };
+} // namespace TarGz
+} // namespace Utils
@@ -20,10 +20,15 @@
 #include "uploadlogs.h"
 
 #include <curl/curl.h>
+#include <errno.h>
+#include <stdio.h>
+#include <string.h>
 #include <sstream>
 #include <map>
+#include <vector>
 
 #include "SystemServicesHelper.h"
+#include "UtilsTarGz.h"
 #include "utils.h"
 
 #define TR181_MTLS_LOGUPLOAD "Device.DeviceInfo.X_RDKCENTRAL-COM_RFC.Feature.MTLS.mTlsLogUpload.Enable"
@@ -38,6 +43,11 @@ namespace UploadLogs
 namespace
 {
     const string DEFAULT_SSR_URL = "https://ssr.ccp.xcal.tv/cgi-bin/rdkb_snmp.cgi";
+    const char* LOGS_DIR = "/opt/logs";
+    // What the last successful upload held, outside of the logs
+    const char* OFFSETS_FILE = "/opt/.uploadlogs_offsets";
+    // Largest archive made into a temporary file, for an upload URL wanting its size
+    const curl_off_t SPOOL_MAX_BYTES = 64 * 1024 * 1024;
 
     err_t getFilename(string& filename)
     {
@@ -110,49 +120,63 @@ namespace
         return ret;
     }
 
-    err_t archiveLogs(const string& filename, string& path)
+    err_t archiveLogs(Utils::TarGz::Writer& archive, bool incremental)
     {
         err_t ret = OK;
 
-        string tmp = "/tmp/" + filename;
-        string cmd = "tar -C /opt/logs -zcf " + tmp + " ./";
+        Utils::TarGz::Offsets since;
+        if (incremental && !Utils::TarGz::loadOffsets(OFFSETS_FILE, since))
+            LOGINFO("no offsets in %s, uploading everything", OFFSETS_FILE);
 
-        Utils::cRunScript(C_STR(cmd));
-        if (!Utils::fileExists(C_STR(tmp)))
+        if (!archive.open(LOGS_DIR, incremental ? &since : nullptr))
+        {
+            LOGERR("archive failed: %s", C_STR(archive.error()));
             ret = TarFail;
+        }
         else
-            path = tmp;
+            LOGINFO("%zu files to archive", archive.files());
 
         return ret;
     }
 
-    size_t uploadRead(void *data, size_t size, size_t nitems, void *userdata)
+    size_t uploadRead(char *data, size_t size, size_t nitems, void *userdata)
     {
-        return fread(data, size, nitems, (FILE *)userdata);
+        Utils::TarGz::Writer *archive = (Utils::TarGz::Writer *)userdata;
+        size_t len = archive->read(data, size * nitems);
+        if (archive->failed())
+        {
+            LOGERR("archive failed: %s", C_STR(archive->error()));
+            return CURL_READFUNC_ABORT;
+        }
+        return len;
     }
 
-    err_t uploadLogs(const string& path, const string& uploadUrl)
+    size_t spoolRead(char *data, size_t size, size_t nitems, void *userdata)
     {
-        err_t ret = OK;
+        return fread(data, size, nitems, (FILE *)userdata);
+    }
 
+    // A size of -1 sends the data with chunked transfer encoding
+    CURLcode put(const string& uploadUrl, curl_read_callback read, void *data, curl_off_t size, long& http_code)
+    {
         CURL *curl;
-        CURLcode res;
-        long http_code = 0;
-        FILE *fd;
-        struct stat file_info;
-        stat(C_STR(path), &file_info);
-        fd = fopen(C_STR(path), "rb");
+        CURLcode res = CURLE_FAILED_INIT;
+        http_code = 0;
 
         curl = curl_easy_init();
         if (curl)
         {
-            curl_easy_setopt(curl, CURLOPT_READFUNCTION, uploadRead);
+            curl_easy_setopt(curl, CURLOPT_READFUNCTION, read);
             curl_easy_setopt(curl, CURLOPT_UPLOAD, 1L);
             curl_easy_setopt(curl, CURLOPT_PUT, 1L);
             curl_easy_setopt(curl, CURLOPT_URL, C_STR(uploadUrl));
-            curl_easy_setopt(curl, CURLOPT_READDATA, fd);
-            curl_easy_setopt(curl, CURLOPT_INFILESIZE_LARGE, (curl_off_t)file_info.st_size);
-            curl_easy_setopt(curl, CURLOPT_TIMEOUT, 120L);
+            curl_easy_setopt(curl, CURLOPT_READDATA, data);
+            if (size >= 0)
+                curl_easy_setopt(curl, CURLOPT_INFILESIZE_LARGE, size);
+            // The archive streams in as it is read, a large one takes a while:
+            // give up on a stalled upload rather than on a slow one
+            curl_easy_setopt(curl, CURLOPT_LOW_SPEED_LIMIT, 1024L);
+            curl_easy_setopt(curl, CURLOPT_LOW_SPEED_TIME, 60L);
             curl_easy_setopt(curl, CURLOPT_CONNECTTIMEOUT, 60L);
 
             LOGINFO("curl request to: %s", C_STR(uploadUrl));
@@ -165,17 +189,99 @@ namespace
 
             curl_easy_cleanup(curl);
         }
-        fclose(fd);
 
-        if (res != CURLE_OK || http_code != 200)
+        return res;
+    }
+
+    // Length Required, or Not Implemented for the Transfer-Encoding header,
+    // as signed object store URLs answer a PUT without Content-Length
+    bool chunkedRefused(CURLcode res, long http_code)
+    {
+        return (res == CURLE_OK) && ((http_code == 411) || (http_code == 501));
+    }
+
+    // The whole archive in an unnamed temporary file, to know its size
+    err_t spoolLogs(Utils::TarGz::Writer& archive, FILE *spool, curl_off_t& size)
+    {
+        std::vector<char> buffer(64 * 1024);
+        size = 0;
+
+        size_t len;
+        while ((len = archive.read(buffer.data(), buffer.size())) > 0)
+        {
+            if (size + (curl_off_t)len > SPOOL_MAX_BYTES)
+            {
+                LOGERR("archive larger than %lld bytes, not uploading it", (long long)SPOOL_MAX_BYTES);
+                return UploadFail;
+            }
+            if (fwrite(buffer.data(), 1, len, spool) != len)
+            {
+                LOGERR("can't spool archive: %s", strerror(errno));
+                return TarFail;
+            }
+            size += len;
+        }
+        if (archive.failed())
+        {
+            LOGERR("archive failed: %s", C_STR(archive.error()));
+            return TarFail;
+        }
+        if ((fflush(spool) != 0) || (fseek(spool, 0, SEEK_SET) != 0))
+        {
+            LOGERR("can't spool archive: %s", strerror(errno));
+            return TarFail;
+        }
+        return OK;
+    }
+
+    // The archive is made while it is sent, so its size is not known upfront
+    // and it goes out with chunked transfer encoding. An upload URL refusing
+    // that gets the archive again, made into a temporary file first.
+    err_t uploadLogs(Utils::TarGz::Writer& archive, const string& uploadUrl, bool incremental)
+    {
+        err_t ret = OK;
+
+        long http_code = 0;
+        CURLcode res = put(uploadUrl, uploadRead, (void *)&archive, -1, http_code);
+
+        if (!archive.failed() && chunkedRefused(res, http_code))
+        {
+            LOGWARN("chunked upload refused, uploading the archive with its size");
+            FILE *spool = tmpfile();
+            curl_off_t size = 0;
+            if (spool == nullptr)
+            {
+                LOGERR("can't create spool file: %s", strerror(errno));
+                ret = UploadFail;
+            }
+            else
+            {
+                // The archive is made again, from the logs as they are now
+                ret = archiveLogs(archive, incremental);
+                if (ret == OK)
+                    ret = spoolLogs(archive, spool, size);
+                if (ret == OK)
+                    res = put(uploadUrl, spoolRead, (void *)spool, size, http_code);
+                fclose(spool);
+            }
+            if (ret != OK)
+                return ret;
+        }
+
+        if (archive.failed())
+            ret = TarFail;
+        else if (res != CURLE_OK || http_code != 200)
             ret = UploadFail;
+        else
+            LOGINFO("uploaded %llu bytes of logs in %llu bytes",
+                (unsigned long long)archive.bytesIn(), (unsigned long long)archive.bytesOut());
 
         return ret;
     }
 } // namespace
 
 // similar to /lib/rdk/UploadLogsNow.sh
-err_t upload(const std::string& ssrUrl)
+err_t upload(const std::string& ssrUrl, bool incremental)
 {
     err_t ret = OK;
 
@@ -199,21 +305,18 @@ err_t upload(const std::string& ssrUrl)
         ret = acquireUploadUrl(ssr, filename, uploadUrl);
     }
 
-    string path;
+    Utils::TarGz::Writer archive;
     if (ret == OK)
     {
         LOGINFO("uploadUrl: %s", C_STR(uploadUrl));
-        ret = archiveLogs(filename, path);
+        ret = archiveLogs(archive, incremental);
     }
 
     if (ret == OK)
-    {
-        LOGINFO("path: %s", C_STR(path));
-        ret = uploadLogs(path, uploadUrl);
+        ret = uploadLogs(archive, uploadUrl, incremental);
 
-        int removeStatus = remove(C_STR(path));
-        LOGINFO("remove %s exit code %d", C_STR(path), removeStatus);
-    }
+    if (ret == OK && !Utils::TarGz::saveOffsets(OFFSETS_FILE, archive.offsets()))
+        LOGWARN("can't save offsets to %s", OFFSETS_FILE);
 
     return ret;
 }
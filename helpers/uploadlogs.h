@@ -29,7 +29,8 @@ namespace Plugin
 namespace UploadLogs
 {
     enum err_t { OK = 0, BadUrl, FilenameFail, SsrFail, TarFail, UploadFail, };
-    err_t upload(const std::string& ssrUrl = std::string());
+    // Incremental uploads only hold what was appended to the logs since the last successful upload
+    err_t upload(const std::string& ssrUrl = std::string(), bool incremental = false);
     int32_t LogUploadBeforeDeepSleep(void);
     std::string errToText(err_t err);
 } // namespace UploadLogs
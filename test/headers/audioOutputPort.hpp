@@ -0,0 +1,29 @@
+#pragma once
+
+#include <string>
+
+namespace device {
+
+class AudioOutputPortImpl {
+public:
+    virtual ~AudioOutputPortImpl() = default;
+
+    virtual std::string getName() const = 0;
+    virtual bool isConnected() const = 0;
+};
+
+class AudioOutputPort {
+public:
+    AudioOutputPortImpl* impl;
+
+    std::string getName() const
+    {
+        return impl->getName();
+    }
+    bool isConnected() const
+    {
+        return impl->isConnected();
+    }
+};
+
+}
@@ -0,0 +1,41 @@
+#pragma once
+
+#include <condition_variable>
+#include <mutex>
+
+typedef int gboolean;
+typedef struct _GMainContext GMainContext;
+typedef struct _GMainLoop GMainLoop;
+
+struct _GMainLoop {
+    std::mutex lock;
+    std::condition_variable condition;
+    bool quit;
+};
+
+inline void gst_init(int* argc, char** argv[]) {}
+
+inline GMainLoop* g_main_loop_new(GMainContext* context, gboolean isRunning)
+{
+    GMainLoop* loop = new GMainLoop();
+    loop->quit = false;
+    return loop;
+}
+
+inline void g_main_loop_run(GMainLoop* loop)
+{
+    std::unique_lock<std::mutex> lock(loop->lock);
+    loop->condition.wait(lock, [loop]() { return loop->quit; });
+}
+
+inline void g_main_loop_quit(GMainLoop* loop)
+{
+    std::lock_guard<std::mutex> lock(loop->lock);
+    loop->quit = true;
+    loop->condition.notify_all();
+}
+
+inline void g_main_loop_unref(GMainLoop* loop)
+{
+    delete loop;
+}
@@ -1,11 +1,13 @@
 #pragma once
 
-#include <vector>
+#include <functional>
+#include <string>
 
-namespace device {
+#include "audioOutputPort.hpp"
+#include "list.hpp"
+#include "videoOutputPort.hpp"
 
-template <class T>
-using List = std::vector<T>;
+namespace device {
 
 class VideoDevice {
 public:
@@ -22,6 +24,9 @@ public:
     virtual ~HostImpl() = default;
 
     virtual List<std::reference_wrapper<VideoDevice>> getVideoDevices() = 0;
+    virtual std::string getDefaultVideoPortName() = 0;
+    virtual List<VideoOutputPort> getVideoOutputPorts() = 0;
+    virtual List<AudioOutputPort> getAudioOutputPorts() = 0;
 };
 
 class Host {
@@ -38,6 +43,18 @@ public:
     {
         return impl->getVideoDevices();
     }
+    std::string getDefaultVideoPortName()
+    {
+        return impl->getDefaultVideoPortName();
+    }
+    List<VideoOutputPort> getVideoOutputPorts()
+    {
+        return impl->getVideoOutputPorts();
+    }
+    List<AudioOutputPort> getAudioOutputPorts()
+    {
+        return impl->getAudioOutputPorts();
+    }
 };
 
 }
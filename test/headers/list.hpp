@@ -0,0 +1,10 @@
+#pragma once
+
+#include <vector>
+
+namespace device {
+
+template <class T>
+using List = std::vector<T>;
+
+}
@@ -0,0 +1,171 @@
+#pragma once
+
+#include <cstdint>
+
+#define MAX_ERROR_DESCRIPTION_LENGTH 128
+
+typedef enum {
+    AAMP_EVENT_TUNED = 1,
+    AAMP_EVENT_TUNE_FAILED,
+    AAMP_EVENT_SPEED_CHANGED,
+    AAMP_EVENT_PROGRESS = 5,
+    AAMP_EVENT_STATE_CHANGED = 14,
+    AAMP_EVENT_BUFFERING_CHANGED = 26,
+} AAMPEventType;
+
+typedef enum {
+    eSTATE_IDLE,
+    eSTATE_INITIALIZING,
+    eSTATE_INITIALIZED,
+    eSTATE_PREPARING,
+    eSTATE_PREPARED,
+    eSTATE_BUFFERING,
+    eSTATE_PAUSED,
+    eSTATE_SEEKING,
+    eSTATE_PLAYING,
+    eSTATE_STOPPING,
+    eSTATE_STOPPED,
+    eSTATE_COMPLETE,
+    eSTATE_ERROR,
+    eSTATE_RELEASED,
+} PrivAAMPState;
+
+enum DRMSystems {
+    eDRM_NONE,
+    eDRM_WideVine,
+    eDRM_PlayReady,
+    eDRM_CONSEC_agnostic,
+    eDRM_Adobe_Access,
+    eDRM_Vanilla_AES,
+    eDRM_ClearKey,
+};
+
+enum LangCodePreference {
+    ISO639_NO_LANGCODE_PREFERENCE,
+    ISO639_PREFER_3_CHAR_BIBLIOGRAPHIC_LANGCODE,
+    ISO639_PREFER_3_CHAR_TERMINOLOGY_LANGCODE,
+    ISO639_PREFER_2_CHAR_LANGCODE,
+};
+
+struct AAMPEvent {
+    AAMPEventType type;
+    union {
+        struct {
+            double durationMiliseconds;
+            double positionMiliseconds;
+            float playbackSpeed;
+            double startMiliseconds;
+            double endMiliseconds;
+            long long videoPTS;
+        } progress;
+        struct {
+            PrivAAMPState state;
+        } stateChanged;
+        struct {
+            bool buffering;
+        } bufferingChanged;
+        struct {
+            float rate;
+        } speedChanged;
+        struct {
+            int code;
+            char description[MAX_ERROR_DESCRIPTION_LENGTH];
+            bool shouldRetry;
+        } mediaError;
+    } data;
+};
+
+class AAMPEventListener {
+public:
+    virtual ~AAMPEventListener() = default;
+
+    virtual void Event(const AAMPEvent& event) = 0;
+};
+
+// Plays nothing, the tests send the events of the player to its listener
+class PlayerInstanceAAMP {
+public:
+    ~PlayerInstanceAAMP()
+    {
+        RegisterEvents(nullptr);
+    }
+
+    // The listener of the player registered last, for the tests
+    static AAMPEventListener*& listener()
+    {
+        static AAMPEventListener* instance = nullptr;
+        return instance;
+    }
+
+    void RegisterEvents(AAMPEventListener* eventListener)
+    {
+        if ((eventListener != nullptr) || (listener() == _listener)) {
+            listener() = eventListener;
+        }
+        _listener = eventListener;
+    }
+
+    void Tune(const char* mainManifestUrl, bool autoPlay) {}
+    void Stop() {}
+    void Seek(double secondsRelativeToTuneTime) {}
+    void SetRate(float rate) {}
+    void SetReportInterval(int reportIntervalMS) {}
+    void SetLanguageFormat(LangCodePreference preferredFormat, bool useRole) {}
+    void EnableVideoRectangle(bool rectProperty) {}
+    void SetLicenseServerURL(const char* url, DRMSystems type) {}
+    void SetPreferredDRM(DRMSystems drmType) {}
+
+    void SetInitialBitrate(int bitrate) {}
+    void SetInitialBitrate4K(int bitrate4K) {}
+    void SetNetworkTimeout(double timeout) {}
+    void SetManifestTimeout(double timeout) {}
+    void SetPlaylistTimeout(double timeout) {}
+    void SetDownloadBufferSize(int bufferSize) {}
+    void SetMinimumBitrate(int bitrate) {}
+    void SetMaximumBitrate(int bitrate) {}
+    void SetPreferredLanguages(const char* languageList) {}
+    void SetStereoOnlyPlayback(bool bValue) {}
+    void SetLiveOffset(int liveoffset) {}
+    void SetBulkTimedMetaReport(bool value) {}
+    void SetNetworkProxy(const char* proxy) {}
+    void SetLicenseReqProxy(const char* licenseProxy) {}
+    void SetDownloadStallTimeout(int stallTimeout) {}
+    void SetDownloadStartTimeout(int startTimeout) {}
+    void SetPreferredSubtitleLanguage(const char* language) {}
+    void SetParallelPlaylistDL(bool bValue) {}
+    void SetParallelPlaylistRefresh(bool bValue) {}
+    void SetAvgBWForABR(bool useAvgBW) {}
+    void SetPreCacheTimeWindow(int nTimeWindow) {}
+    void SetRetuneForUnpairedDiscontinuity(bool bValue) {}
+    void SetSegmentDecryptFailCount(int value) {}
+    void SetInitialBufferDuration(int durationSec) {}
+    void SetMatchingBaseUrlConfig(bool bValue) {}
+    void SetInitFragTimeoutRetryCount(int count) {}
+    void SetNativeCCRendering(bool enable) {}
+    void SetSessionToken(const char* sessionToken) {}
+    void SetRetuneForGSTInternalError(bool bValue) {}
+    void SetReportVideoPTS(bool enabled) {}
+    void SetPropagateUriParameters(bool bValue) {}
+    void EnableSeekableRange(bool bValue) {}
+    void SetMaxPlaylistCacheSize(int cacheSize) {}
+    void SetLicenseCaching(bool setLicenseCaching) {}
+    void PersistBitRateOverSeek(bool value) {}
+    void SetSslVerifyPeerConfig(bool bValue) {}
+    void SetPausedBehavior(int behavior) {}
+    void SetOutputResolutionCheck(bool bValue) {}
+    void SetPreferredRenditions(const char* renditionList) {}
+    void SetPreferredCodec(const char* codecList) {}
+    void SetAsyncTuneConfig(bool bValue) {}
+    void SetWesterosSinkConfig(bool bValue) {}
+    void SetNewABRConfig(bool bValue) {}
+    void SetRampDownLimit(int limit) {}
+    void SetInitRampdownLimit(int limit) {}
+    void SetSegmentInjectFailCount(int value) {}
+    void SetNewAdBreakerConfig(bool bValue) {}
+    void SetCEAFormat(int format) {}
+    void SetTuneEventConfig(int tuneEventType) {}
+    void SetUseAbsoluteTimeline(bool configState) {}
+
+private:
+    AAMPEventListener* _listener = nullptr;
+};
@@ -0,0 +1,210 @@
+#pragma once
+
+#include <stdlib.h>
+#include <string.h>
+#include <unistd.h>
+
+#include <functional>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <vector>
+
+typedef struct pkg_src {
+    char* name;
+    char* value;
+} pkg_src_t;
+
+typedef struct pkg {
+    char* name;
+    char* version;
+    char* filename;
+    char* local_filename;
+    char* md5sum;
+    char* sha256sum;
+    pkg_src_t* src;
+} pkg_t;
+
+typedef struct opkg_conf {
+    char* conf_file;
+    char* tmp_dir;
+    char* cache_dir;
+    char* lists_dir;
+    char* signature_type;
+    int host_cache_dir;
+    int verbosity;
+    int nodeps;
+    int volatile_cache;
+    int check_pkg_signature;
+} opkg_conf_t;
+
+typedef enum {
+    OPKG_INSTALL,
+    OPKG_REMOVE,
+    OPKG_DOWNLOAD,
+} opkg_action_t;
+
+typedef struct _opkg_progress_data_t {
+    int percentage;
+    int action;
+    pkg_t* pkg;
+} opkg_progress_data_t;
+
+typedef void (*opkg_progress_callback_t)(const opkg_progress_data_t* progress, void* user_data);
+typedef void (*opkg_package_callback_t)(pkg_t* pkg, void* user_data);
+
+// Has no packages of its own, the tests give the feed and look at what was installed
+class OpkgStub {
+public:
+    struct Package {
+        std::string Name;
+        std::string Version;
+        std::string Source;     // The URL of the feed
+        std::string FileName;
+        std::string Md5;
+    };
+
+    struct Installation {
+        std::string Target;
+        bool Exists;            // Whether the target was a file when it was installed
+    };
+
+    static OpkgStub& instance()
+    {
+        static OpkgStub stub;
+        return stub;
+    }
+
+    void reset()
+    {
+        std::lock_guard<std::mutex> guard(lock);
+        feed.clear();
+        installations.clear();
+        failing.clear();
+        updates = 0;
+        initializationFails = false;
+        onInstall = nullptr;
+    }
+
+    void add(const Package& package)
+    {
+        std::lock_guard<std::mutex> guard(lock);
+        std::unique_ptr<Entry>& entry = feed[package.Name];
+        entry.reset(new Entry(package));
+    }
+
+    std::vector<Installation> installed()
+    {
+        std::lock_guard<std::mutex> guard(lock);
+        return installations;
+    }
+
+    std::mutex lock;
+    std::vector<std::string> failing;   // Names of the packages not installing
+    int updates = 0;
+    bool initializationFails = false;
+    // Called with the target of each install, before it is done
+    std::function<void(const std::string&)> onInstall;
+
+    opkg_conf_t config = {};
+
+    pkg_t* find(const std::string& name)
+    {
+        std::lock_guard<std::mutex> guard(lock);
+        auto entry = feed.find(name);
+        return (entry != feed.end()) ? &entry->second->pkg : nullptr;
+    }
+
+    int install(const char* target, opkg_progress_callback_t callback, void* data)
+    {
+        std::function<void(const std::string&)> hook;
+        bool fails;
+        {
+            std::lock_guard<std::mutex> guard(lock);
+            installations.push_back({ target, access(target, R_OK) == 0 });
+            hook = onInstall;
+            fails = false;
+            for (const std::string& name : failing) {
+                fails = fails || (std::string(target).find(name) != std::string::npos);
+            }
+        }
+        if (hook) {
+            hook(target);
+        }
+        if (fails) {
+            return -1;
+        }
+        static char localFilename[] = "/tmp/opkgstub/app/app.ipk";
+        static pkg_t package = { nullptr, nullptr, nullptr, localFilename, nullptr, nullptr, nullptr };
+        opkg_progress_data_t progress = { 100, OPKG_INSTALL, &package };
+        callback(&progress, data);
+        return 0;
+    }
+
+private:
+    struct Entry {
+        explicit Entry(const Package& package)
+            : description(package)
+            , src({ nullptr, &description.Source[0] })
+        {
+            pkg.name = &description.Name[0];
+            pkg.version = &description.Version[0];
+            pkg.filename = &description.FileName[0];
+            pkg.local_filename = nullptr;
+            pkg.md5sum = description.Md5.empty() ? nullptr : &description.Md5[0];
+            pkg.sha256sum = nullptr;
+            pkg.src = &src;
+        }
+
+        Package description;
+        pkg_src_t src;
+        pkg_t pkg;
+    };
+
+    std::map<std::string, std::unique_ptr<Entry>> feed;
+    std::vector<Installation> installations;
+};
+
+static opkg_conf_t* const opkg_config = &OpkgStub::instance().config;
+
+inline int opkg_new()
+{
+    std::lock_guard<std::mutex> guard(OpkgStub::instance().lock);
+    return OpkgStub::instance().initializationFails ? -1 : 0;
+}
+
+inline void opkg_conf_deinit() {}
+inline void opkg_download_cleanup() {}
+
+inline int opkg_update_package_lists(opkg_progress_callback_t, void*)
+{
+    std::lock_guard<std::mutex> guard(OpkgStub::instance().lock);
+    OpkgStub::instance().updates++;
+    return 0;
+}
+
+inline pkg_t* pkg_hash_fetch_best_installation_candidate_by_name(const char* name)
+{
+    return OpkgStub::instance().find(name);
+}
+
+inline int opkg_list_upgradable_packages(opkg_package_callback_t, void*)
+{
+    return 0;
+}
+
+inline int opkg_compare_versions(const char* first, const char* second)
+{
+    return strcmp(first, second);
+}
+
+inline int opkg_install_package(const char* name, opkg_progress_callback_t callback, void* data)
+{
+    return OpkgStub::instance().install(name, callback, data);
+}
+
+inline int opkg_upgrade_package(const char* name, opkg_progress_callback_t callback, void* data)
+{
+    return OpkgStub::instance().install(name, callback, data);
+}
@@ -0,0 +1,24 @@
+#pragma once
+
+#define MAX_PARAM_LEN (2 * 1024)
+
+typedef enum {
+    WDMP_STRING = 0,
+    WDMP_INT,
+    WDMP_UINT,
+    WDMP_BOOLEAN,
+    WDMP_DATETIME,
+    WDMP_BASE64,
+    WDMP_LONG,
+    WDMP_ULONG,
+    WDMP_FLOAT,
+    WDMP_DOUBLE,
+    WDMP_BYTE,
+    WDMP_NONE,
+} DATA_TYPE;
+
+typedef struct _RFC_Param_t {
+    char name[MAX_PARAM_LEN];
+    char value[MAX_PARAM_LEN];
+    DATA_TYPE type;
+} RFC_ParamData_t;
@@ -0,0 +1,47 @@
+#pragma once
+
+#include <string>
+
+#include "videoOutputPortType.hpp"
+#include "videoResolution.hpp"
+
+namespace device {
+
+class VideoOutputPortImpl {
+public:
+    virtual ~VideoOutputPortImpl() = default;
+
+    virtual std::string getName() const = 0;
+    virtual bool isDisplayConnected() const = 0;
+    virtual VideoResolution getResolution() const = 0;
+    virtual VideoOutputPortType getType() const = 0;
+    virtual void getSupportedTvResolutions(int* tvResolutions) const = 0;
+};
+
+class VideoOutputPort {
+public:
+    VideoOutputPortImpl* impl;
+
+    std::string getName() const
+    {
+        return impl->getName();
+    }
+    bool isDisplayConnected() const
+    {
+        return impl->isDisplayConnected();
+    }
+    VideoResolution getResolution() const
+    {
+        return impl->getResolution();
+    }
+    VideoOutputPortType getType() const
+    {
+        return impl->getType();
+    }
+    void getSupportedTvResolutions(int* tvResolutions) const
+    {
+        impl->getSupportedTvResolutions(tvResolutions);
+    }
+};
+
+}
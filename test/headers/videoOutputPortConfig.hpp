@@ -0,0 +1,30 @@
+#pragma once
+
+#include "videoOutputPortType.hpp"
+
+namespace device {
+
+class VideoOutputPortConfigImpl {
+public:
+    virtual ~VideoOutputPortConfigImpl() = default;
+
+    virtual VideoOutputPortType getPortType(int id) = 0;
+};
+
+class VideoOutputPortConfig {
+public:
+    static VideoOutputPortConfig& getInstance()
+    {
+        static VideoOutputPortConfig instance;
+        return instance;
+    }
+
+    VideoOutputPortConfigImpl* impl;
+
+    VideoOutputPortType getPortType(int id)
+    {
+        return impl->getPortType(id);
+    }
+};
+
+}
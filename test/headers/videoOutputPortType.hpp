@@ -0,0 +1,30 @@
+#pragma once
+
+#include "list.hpp"
+#include "videoResolution.hpp"
+
+namespace device {
+
+class VideoOutputPortType {
+public:
+    VideoOutputPortType(int id = 0, const List<VideoResolution>& resolutions = List<VideoResolution>())
+        : _id(id)
+        , _resolutions(resolutions)
+    {
+    }
+
+    int getId() const
+    {
+        return _id;
+    }
+    const List<VideoResolution> getSupportedResolutions() const
+    {
+        return _resolutions;
+    }
+
+private:
+    int _id;
+    List<VideoResolution> _resolutions;
+};
+
+}
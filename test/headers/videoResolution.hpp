@@ -0,0 +1,23 @@
+#pragma once
+
+#include <string>
+
+namespace device {
+
+class VideoResolution {
+public:
+    VideoResolution(const std::string& name = "")
+        : _name(name)
+    {
+    }
+
+    const std::string& getName() const
+    {
+        return _name;
+    }
+
+private:
+    std::string _name;
+};
+
+}
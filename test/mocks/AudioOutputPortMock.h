@@ -0,0 +1,13 @@
+#pragma once
+
+#include <gmock/gmock.h>
+
+#include "audioOutputPort.hpp"
+
+class AudioOutputPortImplMock : public device::AudioOutputPortImpl {
+public:
+    virtual ~AudioOutputPortImplMock() = default;
+
+    MOCK_METHOD(std::string, getName, (), (const, override));
+    MOCK_METHOD(bool, isConnected, (), (const, override));
+};
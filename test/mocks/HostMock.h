@@ -9,4 +9,7 @@ public:
     virtual ~HostImplMock() = default;
 
     MOCK_METHOD(device::List<std::reference_wrapper<device::VideoDevice>>, getVideoDevices, (), (override));
+    MOCK_METHOD(std::string, getDefaultVideoPortName, (), (override));
+    MOCK_METHOD(device::List<device::VideoOutputPort>, getVideoOutputPorts, (), (override));
+    MOCK_METHOD(device::List<device::AudioOutputPort>, getAudioOutputPorts, (), (override));
 };
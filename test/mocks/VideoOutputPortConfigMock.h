@@ -0,0 +1,12 @@
+#pragma once
+
+#include <gmock/gmock.h>
+
+#include "videoOutputPortConfig.hpp"
+
+class VideoOutputPortConfigImplMock : public device::VideoOutputPortConfigImpl {
+public:
+    virtual ~VideoOutputPortConfigImplMock() = default;
+
+    MOCK_METHOD(device::VideoOutputPortType, getPortType, (int id), (override));
+};
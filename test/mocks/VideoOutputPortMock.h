@@ -0,0 +1,16 @@
+#pragma once
+
+#include <gmock/gmock.h>
+
+#include "videoOutputPort.hpp"
+
+class VideoOutputPortImplMock : public device::VideoOutputPortImpl {
+public:
+    virtual ~VideoOutputPortImplMock() = default;
+
+    MOCK_METHOD(std::string, getName, (), (const, override));
+    MOCK_METHOD(bool, isDisplayConnected, (), (const, override));
+    MOCK_METHOD(device::VideoResolution, getResolution, (), (const, override));
+    MOCK_METHOD(device::VideoOutputPortType, getType, (), (const, override));
+    MOCK_METHOD(void, getSupportedTvResolutions, (int* tvResolutions), (const, override));
+};
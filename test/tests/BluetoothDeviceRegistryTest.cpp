@@ -0,0 +1,329 @@
+/*
+ * If not stated otherwise in this file or this component's LICENSE file the
+ * following copyright and licenses apply:
+ *
+ * Copyright 2022 RDK Management
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include <gtest/gtest.h>
+
+#include <chrono>
+#include <functional>
+#include <iostream>
+#include <map>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "BluetoothDeviceRegistry.h"
+
+using WPEFramework::Plugin::BluetoothDeviceRegistry;
+
+namespace {
+typedef BluetoothDeviceRegistry::Device Device;
+
+Device device(uint64_t id, const std::string& name, bool paired = false, bool connected = false)
+{
+    Device device;
+    device.deviceID = id;
+    device.name = name;
+    device.deviceType = "HEADPHONES";
+    device.rawDeviceType = 2360344;
+    device.paired = paired;
+    device.connected = connected;
+    return device;
+}
+
+// Stands in for BTRMgr: the lists the BTRMGR_Get* calls return, how often
+// they were called, and a hook run while a call is in progress.
+struct MockBtrMgr {
+    MockBtrMgr()
+        : fail(false)
+    {
+    }
+
+    bool get(BluetoothDeviceRegistry::List list, std::vector<Device>& result)
+    {
+        calls[list]++;
+        if (during) {
+            during();
+        }
+        if (fail) {
+            return false;
+        }
+        for (const auto& it : devices[list]) {
+            result.push_back(it.second);
+        }
+        return true;
+    }
+
+    std::map<uint64_t, Device> devices[BluetoothDeviceRegistry::LIST_COUNT];
+    int calls[BluetoothDeviceRegistry::LIST_COUNT] = { 0, 0, 0 };
+    bool fail;
+    std::function<void()> during;
+};
+
+std::vector<Device> list(BluetoothDeviceRegistry& registry, BluetoothDeviceRegistry::List which)
+{
+    std::vector<Device> devices;
+    uint64_t generation;
+    EXPECT_TRUE(registry.devices(which, devices, generation));
+    return devices;
+}
+}
+
+class BluetoothDeviceRegistryTest : public ::testing::Test {
+protected:
+    MockBtrMgr btrMgr;
+    BluetoothDeviceRegistry registry;
+
+    BluetoothDeviceRegistryTest()
+        : registry([this](BluetoothDeviceRegistry::List list, std::vector<Device>& devices) {
+            return btrMgr.get(list, devices);
+        })
+    {
+    }
+};
+
+TEST_F(BluetoothDeviceRegistryTest, ListsAreLoadedOnceThenKeptByEvents)
+{
+    btrMgr.devices[BluetoothDeviceRegistry::DISCOVERED][1] = device(1, "Speaker");
+
+    EXPECT_EQ(1u, list(registry, BluetoothDeviceRegistry::DISCOVERED).size());
+    registry.discoveryUpdate(device(2, "Headset"), true);
+    registry.discoveryUpdate(device(1, "Speaker"), false);
+
+    std::vector<Device> devices = list(registry, BluetoothDeviceRegistry::DISCOVERED);
+    ASSERT_EQ(1u, devices.size());
+    EXPECT_EQ(2u, devices[0].deviceID);
+    EXPECT_EQ("Headset", devices[0].name);
+    EXPECT_EQ(1, btrMgr.calls[BluetoothDeviceRegistry::DISCOVERED]);
+
+    // a failed load is retried by the next call
+    btrMgr.fail = true;
+    std::vector<Device> paired;
+    uint64_t generation;
+    EXPECT_FALSE(registry.devices(BluetoothDeviceRegistry::PAIRED, paired, generation));
+    btrMgr.fail = false;
+    EXPECT_TRUE(list(registry, BluetoothDeviceRegistry::PAIRED).empty());
+    EXPECT_EQ(2, btrMgr.calls[BluetoothDeviceRegistry::PAIRED]);
+}
+
+TEST_F(BluetoothDeviceRegistryTest, GenerationChangesWithTheLists)
+{
+    std::vector<Device> devices;
+    uint64_t loaded, same, changed;
+    registry.devices(BluetoothDeviceRegistry::DISCOVERED, devices, loaded);
+
+    registry.discoveryUpdate(device(1, "Speaker"), true);
+    registry.devices(BluetoothDeviceRegistry::DISCOVERED, devices, changed);
+    EXPECT_NE(loaded, changed);
+
+    // the same update again is no change
+    registry.discoveryUpdate(device(1, "Speaker"), true);
+    registry.devices(BluetoothDeviceRegistry::DISCOVERED, devices, same);
+    EXPECT_EQ(changed, same);
+
+    registry.discoveryUpdate(device(1, "Kitchen Speaker"), true);
+    EXPECT_NE(same, registry.generation());
+}
+
+TEST_F(BluetoothDeviceRegistryTest, PairingAndConnectionEvents)
+{
+    btrMgr.devices[BluetoothDeviceRegistry::DISCOVERED][1] = device(1, "Speaker");
+    Device connected = device(3, "Soundbar", true, true);
+    connected.powerStatus = 1;
+    btrMgr.devices[BluetoothDeviceRegistry::CONNECTED][3] = connected;
+    list(registry, BluetoothDeviceRegistry::DISCOVERED);
+    list(registry, BluetoothDeviceRegistry::PAIRED);
+    list(registry, BluetoothDeviceRegistry::CONNECTED);
+
+    registry.pairingChanged(device(1, "Speaker"), true);
+    std::vector<Device> paired = list(registry, BluetoothDeviceRegistry::PAIRED);
+    ASSERT_EQ(1u, paired.size());
+    EXPECT_TRUE(paired[0].paired);
+    EXPECT_TRUE(list(registry, BluetoothDeviceRegistry::DISCOVERED)[0].paired);
+
+    // connection events update the flags and reload the connected list,
+    // since they do not carry the power status
+    btrMgr.devices[BluetoothDeviceRegistry::CONNECTED][1] = device(1, "Speaker", true, true);
+    registry.connectionChanged(device(1, "Speaker", true), true);
+    EXPECT_TRUE(list(registry, BluetoothDeviceRegistry::PAIRED)[0].connected);
+    EXPECT_TRUE(list(registry, BluetoothDeviceRegistry::DISCOVERED)[0].connected);
+    EXPECT_EQ(2u, list(registry, BluetoothDeviceRegistry::CONNECTED).size());
+    EXPECT_EQ(2, btrMgr.calls[BluetoothDeviceRegistry::CONNECTED]);
+
+    registry.pairingChanged(device(1, "Speaker"), false);
+    EXPECT_TRUE(list(registry, BluetoothDeviceRegistry::PAIRED).empty());
+    EXPECT_FALSE(list(registry, BluetoothDeviceRegistry::DISCOVERED)[0].paired);
+
+    registry.reset();
+    list(registry, BluetoothDeviceRegistry::PAIRED);
+    EXPECT_EQ(2, btrMgr.calls[BluetoothDeviceRegistry::PAIRED]);
+}
+
+TEST_F(BluetoothDeviceRegistryTest, EventsDuringALoadAreKept)
+{
+    btrMgr.devices[BluetoothDeviceRegistry::DISCOVERED][1] = device(1, "Speaker");
+    btrMgr.devices[BluetoothDeviceRegistry::DISCOVERED][2] = device(2, "Headset");
+    // BTRMgr answers with its list from before these events
+    btrMgr.during = [this]() {
+        btrMgr.during = nullptr;
+        registry.discoveryUpdate(device(2, "Headset"), false);
+        registry.discoveryUpdate(device(3, "Keyboard"), true);
+    };
+
+    std::vector<Device> devices = list(registry, BluetoothDeviceRegistry::DISCOVERED);
+    ASSERT_EQ(2u, devices.size());
+    EXPECT_EQ(1u, devices[0].deviceID);
+    EXPECT_EQ(3u, devices[1].deviceID);
+}
+
+TEST_F(BluetoothDeviceRegistryTest, DiscoveryUpdatesAreCoalesced)
+{
+    // one flush is scheduled per window
+    EXPECT_TRUE(registry.discoveryUpdate(device(1, "Speaker"), true));
+    EXPECT_FALSE(registry.discoveryUpdate(device(1, "Speaker"), true));
+    EXPECT_FALSE(registry.discoveryUpdate(device(2, "Headset"), true));
+    EXPECT_FALSE(registry.discoveryUpdate(device(1, "Kitchen Speaker"), true));
+
+    std::vector<BluetoothDeviceRegistry::DiscoveryUpdate> updates = registry.takeDiscoveryUpdates();
+    ASSERT_EQ(2u, updates.size());
+    EXPECT_EQ("Kitchen Speaker", updates[0].device.name);
+    EXPECT_TRUE(updates[0].discovered);
+    EXPECT_EQ("Headset", updates[1].device.name);
+
+    // repeats of what was announced do not even schedule a flush
+    EXPECT_FALSE(registry.discoveryUpdate(device(2, "Headset"), true));
+    EXPECT_TRUE(registry.takeDiscoveryUpdates().empty());
+
+    // found and lost within a window, or back to what was announced: nothing to say
+    EXPECT_TRUE(registry.discoveryUpdate(device(3, "Mouse"), true));
+    registry.discoveryUpdate(device(3, "Mouse"), false);
+    registry.discoveryUpdate(device(2, "Headset"), false);
+    registry.discoveryUpdate(device(2, "Headset"), true);
+    EXPECT_TRUE(registry.takeDiscoveryUpdates().empty());
+    EXPECT_FALSE(registry.discoveryUpdate(device(4, "Gamepad"), false));
+
+    registry.discoveryUpdate(device(2, "Headset"), false);
+    updates = registry.takeDiscoveryUpdates();
+    ASSERT_EQ(1u, updates.size());
+    EXPECT_FALSE(updates[0].discovered);
+
+    // a new scan announces every device again
+    registry.discoveryStarted();
+    EXPECT_TRUE(registry.discoveryUpdate(device(1, "Kitchen Speaker"), true));
+    EXPECT_EQ(1u, registry.takeDiscoveryUpdates().size());
+}
+
+TEST_F(BluetoothDeviceRegistryTest, DiscoveryBurst)
+{
+    // A scan as BTRMgr reports it: 20 devices, each refreshed 50 times with
+    // a new RSSI, a few renamed once their name is resolved, a few lost.
+    // The plugin flushes every 10 callbacks, standing in for the window.
+    const int kDevices = 20;
+    const int kRefreshes = 50;
+    int callbacks = 0;
+    int flushes = 0;
+    std::map<uint64_t, BluetoothDeviceRegistry::DiscoveryUpdate> announced;
+    int notifications = 0;
+
+    // loaded before the scan, from then on kept by the events only
+    EXPECT_TRUE(list(registry, BluetoothDeviceRegistry::DISCOVERED).empty());
+
+    auto flush = [&]() {
+        for (const auto& update : registry.takeDiscoveryUpdates()) {
+            announced[update.device.deviceID] = update;
+            notifications++;
+        }
+        flushes++;
+    };
+
+    for (int refresh = 0; refresh < kRefreshes; refresh++) {
+        for (int id = 1; id <= kDevices; id++) {
+            std::string name = (id % 5 == 0 && refresh < 10) ? std::to_string(id) : "Device " + std::to_string(id);
+            bool lost = (id % 7 == 0) && refresh == kRefreshes - 1;
+            registry.discoveryUpdate(device(id, name), !lost);
+            if (++callbacks % 10 == 0) {
+                flush();
+            }
+        }
+    }
+    flush();
+
+    // every device announced with its final state
+    ASSERT_EQ((size_t)kDevices, announced.size());
+    for (const auto& it : announced) {
+        EXPECT_EQ("Device " + std::to_string(it.first), it.second.device.name);
+        EXPECT_EQ(it.first % 7 != 0, it.second.discovered);
+    }
+    EXPECT_EQ((size_t)(kDevices - 2), list(registry, BluetoothDeviceRegistry::DISCOVERED).size());
+    EXPECT_EQ(1, btrMgr.calls[BluetoothDeviceRegistry::DISCOVERED]);
+
+    std::cout << callbacks << " BTRMgr callbacks, " << notifications << " onDiscoveredDevice events" << std::endl;
+    EXPECT_LT(notifications, kDevices * 2);
+}
+
+TEST_F(BluetoothDeviceRegistryTest, ConnectedListReadLive)
+{
+    Device connected = device(3, "Soundbar", true, true);
+    connected.powerStatus = 0;
+    btrMgr.devices[BluetoothDeviceRegistry::CONNECTED][3] = connected;
+
+    std::vector<Device> devices;
+    uint64_t first, same, changed;
+    EXPECT_TRUE(registry.devices(BluetoothDeviceRegistry::CONNECTED, devices, first, true));
+    EXPECT_TRUE(registry.devices(BluetoothDeviceRegistry::CONNECTED, devices, same, true));
+    EXPECT_EQ(first, same);
+
+    // the device went to low power while connected, without an event
+    btrMgr.devices[BluetoothDeviceRegistry::CONNECTED][3].powerStatus = 1;
+    EXPECT_TRUE(registry.devices(BluetoothDeviceRegistry::CONNECTED, devices, changed, true));
+    ASSERT_EQ(1u, devices.size());
+    EXPECT_EQ(1, devices[0].powerStatus);
+    EXPECT_NE(same, changed);
+    EXPECT_EQ(3, btrMgr.calls[BluetoothDeviceRegistry::CONNECTED]);
+}
+
+TEST_F(BluetoothDeviceRegistryTest, FlushesDoNotInterleave)
+{
+    std::vector<std::string> notified;
+    std::mutex lock;
+    auto notify = [&](const BluetoothDeviceRegistry::DiscoveryUpdate& update) {
+        std::this_thread::sleep_for(std::chrono::milliseconds(1));
+        std::lock_guard<std::mutex> guard(lock);
+        notified.push_back(update.device.name);
+    };
+
+    for (int id = 1; id <= 20; id++) {
+        registry.discoveryUpdate(device(id, "First " + std::to_string(id)), true);
+    }
+    // the timer thread flushes while a new scan starts on the event thread
+    std::thread timer([&]() { registry.flushDiscoveryUpdates(notify); });
+    std::this_thread::sleep_for(std::chrono::milliseconds(5));
+    registry.discoveryStarted(notify);
+    for (int id = 1; id <= 20; id++) {
+        registry.discoveryUpdate(device(id, "Second " + std::to_string(id)), true);
+    }
+    registry.flushDiscoveryUpdates(notify);
+    timer.join();
+
+    // each device once per scan, every update of the first scan before the second
+    ASSERT_EQ(40u, notified.size());
+    for (size_t i = 0; i < notified.size(); i++) {
+        EXPECT_EQ(i < 20 ? "First" : "Second", notified[i].substr(0, notified[i].find(' ')));
+    }
+}
@@ -0,0 +1,162 @@
+/*
+ * If not stated otherwise in this file or this component's LICENSE file the
+ * following copyright and licenses apply:
+ *
+ * Copyright 2022 RDK Management
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include <gtest/gtest.h>
+
+#include <set>
+
+#include "CecPollScheduler.h"
+
+using namespace WPEFramework;
+
+namespace {
+const uint32_t kBaseMs = 10000;
+const uint32_t kMaxMs = 80000;
+const int kTv = 0;
+
+// Loopback bus: acks pings for the attached addresses and counts the pings
+// that went out. The poll cycle is the scheduler's, as in HdmiCecSink::pingDevices.
+class SimulatedCecBus {
+public:
+    explicit SimulatedCecBus(Plugin::CecPollScheduler& scheduler)
+        : _scheduler(scheduler)
+        , _pings(0)
+    {
+    }
+
+    void attach(int address) { _attached.insert(address); }
+    void detach(int address) { _attached.erase(address); }
+
+    // Pretends the device sent a message; the plugin calls addDevice for it.
+    void message(int address, Plugin::CecPollScheduler::Clock::time_point now)
+    {
+        _scheduler.onPresent(address, now);
+        _discovered.insert(address);
+    }
+
+    void poll(Plugin::CecPollScheduler::Clock::time_point now)
+    {
+        _scheduler.pingDue(kTv, [this](int address) -> bool {
+            _pings++;
+            if (_attached.count(address) == 0) {
+                _discovered.erase(address);
+                return false;
+            }
+            _discovered.insert(address);
+            return true;
+        }, now);
+    }
+
+    bool discovered(int address) const { return _discovered.count(address) != 0; }
+    uint32_t pings() const { return _pings; }
+
+private:
+    Plugin::CecPollScheduler& _scheduler;
+    std::set<int> _attached;
+    std::set<int> _discovered;
+    uint32_t _pings;
+};
+}
+
+TEST(CecPollSchedulerTest, firstCyclePingsEveryAddress)
+{
+    Plugin::CecPollScheduler scheduler(kBaseMs, kMaxMs);
+    SimulatedCecBus bus(scheduler);
+    bus.attach(4);
+
+    bus.poll(Plugin::CecPollScheduler::Clock::now());
+
+    EXPECT_EQ(14u, bus.pings());
+    EXPECT_TRUE(bus.discovered(4));
+}
+
+TEST(CecPollSchedulerTest, absentAddressesBackOff)
+{
+    Plugin::CecPollScheduler scheduler(kBaseMs, kMaxMs);
+    SimulatedCecBus bus(scheduler);
+    bus.attach(4);
+
+    auto now = Plugin::CecPollScheduler::Clock::now();
+    const uint32_t cycles = 60;
+    for (uint32_t cycle = 0; cycle < cycles; cycle++) {
+        bus.poll(now + std::chrono::milliseconds(cycle * kBaseMs));
+    }
+
+    EXPECT_EQ(kBaseMs, scheduler.intervalMs(4));
+    EXPECT_EQ(kMaxMs, scheduler.intervalMs(3));
+    // Fixed interval polling would have sent 14 pings every cycle.
+    EXPECT_LT(bus.pings(), (cycles * 14) / 4);
+}
+
+TEST(CecPollSchedulerTest, talkingDeviceIsNotPinged)
+{
+    Plugin::CecPollScheduler scheduler(kBaseMs, kMaxMs);
+    SimulatedCecBus bus(scheduler);
+    bus.attach(4);
+
+    auto now = Plugin::CecPollScheduler::Clock::now();
+    bus.poll(now);
+    uint32_t pings = bus.pings();
+
+    bus.message(4, now + std::chrono::milliseconds(kBaseMs - 1));
+    EXPECT_FALSE(scheduler.isDue(4, now + std::chrono::milliseconds(kBaseMs)));
+    bus.poll(now + std::chrono::milliseconds(kBaseMs));
+
+    // Only the absent addresses got their first backoff ping.
+    EXPECT_EQ(pings + 13, bus.pings());
+}
+
+TEST(CecPollSchedulerTest, resetFindsNewDeviceImmediately)
+{
+    Plugin::CecPollScheduler scheduler(kBaseMs, kMaxMs);
+    SimulatedCecBus bus(scheduler);
+
+    auto now = Plugin::CecPollScheduler::Clock::now();
+    for (uint32_t cycle = 0; cycle < 20; cycle++) {
+        bus.poll(now + std::chrono::milliseconds(cycle * kBaseMs));
+    }
+    EXPECT_EQ(kMaxMs, scheduler.intervalMs(4));
+
+    // Hotplug: without the reset the device would wait for the backoff.
+    bus.attach(4);
+    scheduler.reset();
+    bus.poll(Plugin::CecPollScheduler::Clock::now());
+
+    EXPECT_TRUE(bus.discovered(4));
+    EXPECT_EQ(kBaseMs, scheduler.intervalMs(4));
+}
+
+TEST(CecPollSchedulerTest, timeToNextDue)
+{
+    Plugin::CecPollScheduler scheduler(kBaseMs, kMaxMs);
+    auto now = Plugin::CecPollScheduler::Clock::now();
+
+    EXPECT_EQ(0u, scheduler.timeToNextDueMs(kTv, now));
+
+    for (int i = 1; i < Plugin::CecPollScheduler::MAX_ADDRESSES; i++) {
+        scheduler.onPresent(i, now);
+    }
+    EXPECT_EQ(kBaseMs, scheduler.timeToNextDueMs(kTv, now));
+
+    scheduler.onPresent(kTv, now);
+    scheduler.onPresent(5, now - std::chrono::milliseconds(4000));
+    EXPECT_EQ(6000u, scheduler.timeToNextDueMs(kTv, now));
+
+    EXPECT_FALSE(scheduler.isDue(Plugin::CecPollScheduler::MAX_ADDRESSES, now));
+}
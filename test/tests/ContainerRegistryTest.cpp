@@ -0,0 +1,176 @@
+/*
+ * If not stated otherwise in this file or this component's LICENSE file the
+ * following copyright and licenses apply:
+ *
+ * Copyright 2022 RDK Management
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include <gmock/gmock.h>
+#include <gtest/gtest.h>
+
+#include <atomic>
+#include <chrono>
+#include <thread>
+
+#include "ContainerRegistry.h"
+
+using namespace WPEFramework;
+using ::testing::_;
+using ::testing::Invoke;
+using ::testing::Return;
+
+namespace {
+// The calls of IDobbyProxy the plugin makes for an operation on a container
+class DobbyProxyMock {
+public:
+    MOCK_METHOD((std::list<std::pair<int32_t, std::string>>), listContainers, (), (const));
+    MOCK_METHOD(bool, stopContainer, (int32_t descriptor, bool withPrejudice), (const));
+    MOCK_METHOD(bool, pauseContainer, (int32_t descriptor), (const));
+};
+
+const std::list<std::pair<int32_t, std::string>> running = {
+    { 11, "com.example.one" },
+    { 12, "com.example.two" },
+    { 13, "com.example.three" },
+};
+}
+
+class ContainerRegistryTest : public ::testing::Test {
+protected:
+    DobbyProxyMock proxy;
+    Plugin::ContainerRegistry registry;
+
+    ContainerRegistryTest()
+        : registry([this]() { return proxy.listContainers(); })
+    {
+    }
+
+    // As OCIContainer::stopContainer
+    bool stop(const std::string& containerId)
+    {
+        int cd = registry.find(containerId);
+        return (cd >= 0) && proxy.stopContainer(cd, false);
+    }
+};
+
+TEST_F(ContainerRegistryTest, OneListForManyOperations)
+{
+    EXPECT_CALL(proxy, listContainers())
+        .Times(1)
+        .WillOnce(Return(running));
+    EXPECT_CALL(proxy, stopContainer(_, false))
+        .Times(30)
+        .WillRepeatedly(Return(true));
+
+    for (int i = 0; i < 10; i++) {
+        EXPECT_TRUE(stop("com.example.one"));
+        EXPECT_TRUE(stop("com.example.two"));
+        // By descriptor as well
+        EXPECT_TRUE(stop("13"));
+    }
+
+    EXPECT_EQ(30u, registry.statistics().lookups);
+    EXPECT_EQ(1u, registry.statistics().syncs);
+}
+
+TEST_F(ContainerRegistryTest, EventsKeepTheRegistry)
+{
+    EXPECT_CALL(proxy, listContainers())
+        .Times(1)
+        .WillOnce(Return(running));
+    EXPECT_EQ(11, registry.find("com.example.one"));
+
+    // Started and stopped after the list, told by the events
+    registry.started(14, "com.example.four");
+    EXPECT_EQ(14, registry.find("com.example.four"));
+    registry.stopped(11);
+    EXPECT_EQ(3u, registry.size());
+
+    // An id started again has a new descriptor
+    registry.started(15, "com.example.one");
+    EXPECT_EQ(15, registry.find("com.example.one"));
+    EXPECT_EQ(1u, registry.statistics().syncs);
+}
+
+TEST_F(ContainerRegistryTest, UnknownContainerAsksDobby)
+{
+    EXPECT_CALL(proxy, listContainers())
+        .Times(3)
+        .WillOnce(Return(running))
+        .WillOnce(Return(running))
+        .WillOnce(Return(std::list<std::pair<int32_t, std::string>>()));
+
+    EXPECT_EQ(-1, registry.find("com.example.missing"));
+    EXPECT_EQ(-1, registry.find("com.example.missing"));
+    EXPECT_EQ(12, registry.find("com.example.two"));
+
+    // Invalidated, as after Dobby failed on a descriptor
+    registry.invalidate();
+    EXPECT_EQ(-1, registry.find("com.example.two"));
+    EXPECT_EQ(0u, registry.size());
+}
+
+TEST_F(ContainerRegistryTest, BatchRunsConcurrently)
+{
+    std::list<std::pair<int32_t, std::string>> many;
+    std::vector<std::string> ids;
+    for (int i = 0; i < 16; i++) {
+        ids.push_back("com.example." + std::to_string(i));
+        many.push_back(std::make_pair(100 + i, ids.back()));
+    }
+
+    std::atomic<int> inFlight(0);
+    std::atomic<int> mostInFlight(0);
+    EXPECT_CALL(proxy, listContainers())
+        .Times(1)
+        .WillOnce(Return(many));
+    EXPECT_CALL(proxy, pauseContainer(_))
+        .Times(16)
+        .WillRepeatedly(Invoke([&](int32_t descriptor) {
+            // A D-Bus round trip
+            int now = ++inFlight;
+            int most = mostInFlight;
+            while (now > most && !mostInFlight.compare_exchange_weak(most, now)) {
+            }
+            std::this_thread::sleep_for(std::chrono::milliseconds(20));
+            --inFlight;
+            return descriptor != 105;
+        }));
+
+    std::vector<char> succeeded(ids.size(), 0);
+    auto start = std::chrono::steady_clock::now();
+    Plugin::runBatch(ids.size(), 4, [&](size_t index) {
+        int cd = registry.find(ids[index]);
+        succeeded[index] = (cd >= 0) && proxy.pauseContainer(cd);
+    });
+    auto elapsed = std::chrono::duration_cast<std::chrono::milliseconds>(std::chrono::steady_clock::now() - start).count();
+
+    for (size_t i = 0; i < ids.size(); i++) {
+        EXPECT_EQ(i != 5, succeeded[i] != 0) << ids[i];
+    }
+    EXPECT_EQ(4, mostInFlight);
+    EXPECT_LT(elapsed, 16 * 20);
+    EXPECT_EQ(1u, registry.statistics().syncs);
+}
+
+TEST_F(ContainerRegistryTest, BatchOfNoneOrOne)
+{
+    int calls = 0;
+    Plugin::runBatch(0, 4, [&](size_t) { calls++; });
+    EXPECT_EQ(0, calls);
+    Plugin::runBatch(1, 4, [&](size_t index) { calls++; EXPECT_EQ(0u, index); });
+    Plugin::runBatch(3, 0, [&](size_t) { calls++; });
+    EXPECT_EQ(4, calls);
+}
@@ -0,0 +1,190 @@
+/*
+ * If not stated otherwise in this file or this component's LICENSE file the
+ * following copyright and licenses apply:
+ *
+ * Copyright 2022 RDK Management
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include <gtest/gtest.h>
+
+#include "DisplayPortCache.h"
+
+#include "AudioOutputPortMock.h"
+#include "HostMock.h"
+#include "VideoOutputPortConfigMock.h"
+#include "VideoOutputPortMock.h"
+#include "exception.hpp"
+
+using namespace WPEFramework;
+
+using ::testing::NiceMock;
+using ::testing::Return;
+using ::testing::Throw;
+
+TEST(DisplayPortCacheTest, loadsOnceUntilInvalidated)
+{
+    int loads = 0;
+    Plugin::CachedValue<Plugin::AudioPortsState> cache([&](Plugin::AudioPortsState& state) {
+        loads++;
+        state.ports.push_back({ "HDMI0", loads > 1 });
+        return true;
+    });
+
+    Plugin::AudioPortsState state;
+    EXPECT_FALSE(cache.isValid());
+    for (int i = 0; i < 10; i++) {
+        EXPECT_TRUE(cache.get(state));
+    }
+    EXPECT_EQ(1, loads);
+    ASSERT_EQ(1u, state.ports.size());
+    EXPECT_FALSE(state.ports[0].connected);
+
+    cache.invalidate();
+    EXPECT_FALSE(cache.isValid());
+    EXPECT_TRUE(cache.get(state));
+    EXPECT_TRUE(cache.get(state));
+    EXPECT_EQ(2, loads);
+    EXPECT_TRUE(state.ports[0].connected);
+}
+
+TEST(DisplayPortCacheTest, failedLoadIsNotCached)
+{
+    int loads = 0;
+    Plugin::CachedValue<Plugin::VideoPortsState> cache([&](Plugin::VideoPortsState& state) {
+        loads++;
+        if (loads == 1) {
+            return false;
+        }
+        state.defaultPort = "HDMI0";
+        return true;
+    });
+
+    Plugin::VideoPortsState state;
+    EXPECT_FALSE(cache.get(state));
+    EXPECT_TRUE(cache.get(state));
+    EXPECT_TRUE(cache.get(state));
+    EXPECT_EQ(2, loads);
+    EXPECT_EQ("HDMI0", state.defaultPort);
+    EXPECT_EQ(nullptr, state.find("HDMI0"));
+}
+
+TEST(DisplayPortCacheTest, loadRacingInvalidateIsNotKept)
+{
+    int loads = 0;
+    Plugin::CachedValue<Plugin::AudioPortsState>* self = nullptr;
+    Plugin::CachedValue<Plugin::AudioPortsState> cache([&](Plugin::AudioPortsState&) {
+        loads++;
+        if (loads == 1) {
+            self->invalidate();
+        }
+        return true;
+    });
+    self = &cache;
+
+    Plugin::AudioPortsState state;
+    EXPECT_TRUE(cache.get(state));
+    EXPECT_FALSE(cache.isValid());
+    EXPECT_TRUE(cache.get(state));
+    EXPECT_TRUE(cache.isValid());
+    EXPECT_EQ(2, loads);
+}
+
+class DisplayPortCacheHostTestFixture : public ::testing::Test {
+protected:
+    HostImplMock hostImplMock;
+    VideoOutputPortConfigImplMock videoOutputPortConfigImplMock;
+    NiceMock<VideoOutputPortImplMock> hdmiImplMock;
+    NiceMock<AudioOutputPortImplMock> speakerImplMock;
+    device::VideoOutputPort hdmi;
+    device::AudioOutputPort speaker;
+
+    virtual void SetUp()
+    {
+        device::Host::getInstance().impl = &hostImplMock;
+        device::VideoOutputPortConfig::getInstance().impl = &videoOutputPortConfigImplMock;
+        hdmi.impl = &hdmiImplMock;
+        speaker.impl = &speakerImplMock;
+
+        ON_CALL(hdmiImplMock, getName()).WillByDefault(Return("HDMI0"));
+        ON_CALL(hdmiImplMock, isDisplayConnected()).WillByDefault(Return(true));
+        ON_CALL(hdmiImplMock, getResolution()).WillByDefault(Return(device::VideoResolution("1080p60")));
+        ON_CALL(speakerImplMock, getName()).WillByDefault(Return("SPEAKER0"));
+        ON_CALL(speakerImplMock, isConnected()).WillByDefault(Return(true));
+        EXPECT_CALL(videoOutputPortConfigImplMock, getPortType(::testing::_))
+            .Times(::testing::AnyNumber())
+            .WillRepeatedly(Return(device::VideoOutputPortType(0, { device::VideoResolution("720p"), device::VideoResolution("1080p60") })));
+    }
+
+    virtual void TearDown()
+    {
+        device::Host::getInstance().impl = nullptr;
+        device::VideoOutputPortConfig::getInstance().impl = nullptr;
+    }
+};
+
+TEST_F(DisplayPortCacheHostTestFixture, hostIsAskedOnceUntilInvalidated)
+{
+    EXPECT_CALL(hostImplMock, getDefaultVideoPortName())
+        .Times(2)
+        .WillRepeatedly(Return("HDMI0"));
+    EXPECT_CALL(hostImplMock, getVideoOutputPorts())
+        .Times(2)
+        .WillRepeatedly(Return(device::List<device::VideoOutputPort>({ hdmi })));
+
+    Plugin::CachedValue<Plugin::VideoPortsState> cache(Plugin::loadVideoPortsState);
+
+    // getConnectedVideoDisplays then getCurrentResolution, as a UI polling them does
+    for (int i = 0; i < 10; i++) {
+        Plugin::VideoPortsState state;
+        ASSERT_TRUE(cache.get(state));
+        std::vector<std::string> displays;
+        state.connectedDisplays(displays);
+        EXPECT_EQ(std::vector<std::string>({ "HDMI0" }), displays);
+
+        ASSERT_TRUE(cache.get(state));
+        const Plugin::VideoPortState* port = state.find(state.defaultPort);
+        ASSERT_NE(nullptr, port);
+        EXPECT_EQ("1080p60", port->resolution);
+        EXPECT_EQ(std::vector<std::string>({ "720p", "1080p60" }), port->supportedResolutions);
+    }
+
+    // The resolution changed event
+    ON_CALL(hdmiImplMock, getResolution()).WillByDefault(Return(device::VideoResolution("720p")));
+    cache.invalidate();
+    for (int i = 0; i < 10; i++) {
+        Plugin::VideoPortsState state;
+        ASSERT_TRUE(cache.get(state));
+        ASSERT_NE(nullptr, state.find("HDMI0"));
+        EXPECT_EQ("720p", state.find("HDMI0")->resolution);
+    }
+}
+
+TEST_F(DisplayPortCacheHostTestFixture, hostExceptionIsNotCached)
+{
+    EXPECT_CALL(hostImplMock, getAudioOutputPorts())
+        .Times(2)
+        .WillOnce(Throw(device::Exception("Not ready")))
+        .WillOnce(Return(device::List<device::AudioOutputPort>({ speaker })));
+
+    Plugin::CachedValue<Plugin::AudioPortsState> cache(Plugin::loadAudioPortsState);
+    Plugin::AudioPortsState state;
+    EXPECT_FALSE(cache.get(state));
+    for (int i = 0; i < 10; i++) {
+        ASSERT_TRUE(cache.get(state));
+        ASSERT_EQ(1u, state.ports.size());
+        EXPECT_EQ("SPEAKER0", state.ports[0].name);
+        EXPECT_TRUE(state.ports[0].connected);
+    }
+}
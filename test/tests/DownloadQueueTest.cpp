@@ -0,0 +1,257 @@
+/*
+ * If not stated otherwise in this file or this component's LICENSE file the
+ * following copyright and licenses apply:
+ *
+ * Copyright 2022 RDK Management
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include <gtest/gtest.h>
+
+#include <utime.h>
+
+#include <chrono>
+#include <condition_variable>
+#include <fstream>
+#include <map>
+#include <mutex>
+
+#include "DownloadQueue.h"
+
+using namespace WPEFramework;
+
+namespace {
+// Not the digest of any package of the tests
+const char* otherSha256 = "6d9e6b5b7d1a26b6a8cd36c8c0e8a7d7f1b2c8b4ad8d8c30ee6d5a8a6e43c9a1";
+
+std::string digest(const std::string& path, const EVP_MD* type)
+{
+    std::ifstream file(path, std::ios::binary);
+    std::string content((std::istreambuf_iterator<char>(file)), std::istreambuf_iterator<char>());
+    unsigned char value[EVP_MAX_MD_SIZE];
+    unsigned int length = 0;
+    EVP_Digest(content.data(), content.size(), value, &length, type, nullptr);
+    std::string hex;
+    char byte[3];
+    for (unsigned int i = 0; i < length; i++) {
+        snprintf(byte, sizeof(byte), "%02x", value[i]);
+        hex += byte;
+    }
+    return hex;
+}
+}
+
+class DownloadQueueTest : public ::testing::Test {
+protected:
+    std::string feed;
+    std::string cache;
+    std::mutex lock;
+    std::condition_variable condition;
+    std::map<uint32_t, std::string> completed;
+    std::map<uint32_t, uint8_t> progress;
+
+    DownloadQueueTest()
+    {
+        char feedTemplate[] = "/tmp/feedXXXXXX";
+        char cacheTemplate[] = "/tmp/cacheXXXXXX";
+        feed = std::string(mkdtemp(feedTemplate)) + "/";
+        cache = std::string(mkdtemp(cacheTemplate)) + "/";
+    }
+
+    ~DownloadQueueTest() override
+    {
+        std::system(("rm -rf " + feed + " " + cache).c_str());
+    }
+
+    // A package of the local feed, its request by file:// URL
+    Plugin::DownloadQueue::Request package(const std::string& name, size_t size, char fill)
+    {
+        std::ofstream(feed + name, std::ios::binary) << std::string(size, fill);
+        Plugin::DownloadQueue::Request request;
+        request.Url = "file://" + feed + name;
+        request.Sha256 = digest(feed + name, EVP_sha256());
+        request.Md5 = digest(feed + name, EVP_md5());
+        return request;
+    }
+
+    std::unique_ptr<Plugin::DownloadQueue> queue(uint8_t concurrency, uint64_t limit = 0)
+    {
+        return std::unique_ptr<Plugin::DownloadQueue>(new Plugin::DownloadQueue(cache, concurrency, limit,
+            [this](uint32_t id, uint8_t percent) {
+                std::lock_guard<std::mutex> guard(lock);
+                progress[id] = percent;
+            },
+            [this](uint32_t id, const std::string& path) {
+                std::lock_guard<std::mutex> guard(lock);
+                completed[id] = path;
+                condition.notify_all();
+            }));
+    }
+
+    bool waitFor(size_t count)
+    {
+        std::unique_lock<std::mutex> guard(lock);
+        return condition.wait_for(guard, std::chrono::seconds(10), [&]() { return completed.size() >= count; });
+    }
+
+    // Used that many seconds ago, for the order the limit removes the packages in
+    void age(const std::string& path, time_t seconds)
+    {
+        struct utimbuf times;
+        times.actime = times.modtime = time(nullptr) - seconds;
+        ASSERT_EQ(0, utime(path.c_str(), &times));
+    }
+
+    bool exists(const std::string& path)
+    {
+        struct stat info;
+        return lstat(path.c_str(), &info) == 0;
+    }
+};
+
+TEST_F(DownloadQueueTest, DownloadsIntoTheContentCache)
+{
+    auto downloads = queue(3);
+    std::vector<Plugin::DownloadQueue::Request> requests;
+    for (int i = 0; i < 6; i++) {
+        requests.push_back(package("package" + std::to_string(i) + "_1.0_arm.ipk", 200000 + i, 'a' + i));
+        downloads->Submit(i, requests.back());
+    }
+    ASSERT_TRUE(waitFor(6));
+
+    for (int i = 0; i < 6; i++) {
+        EXPECT_EQ(cache + "sha256-" + requests[i].Sha256 + ".ipk", completed[i]);
+        EXPECT_EQ(requests[i].Sha256, digest(completed[i], EVP_sha256()));
+        EXPECT_EQ(100, progress[i]);
+    }
+    EXPECT_EQ(6u, downloads->Stats().Downloads);
+    EXPECT_EQ(6u * 200000 + 15, downloads->Stats().Bytes);
+}
+
+TEST_F(DownloadQueueTest, SamePackageIsStoredOnce)
+{
+    // Two versions with the same content, and a package asked for twice
+    Plugin::DownloadQueue::Request first = package("app_1.0_arm.ipk", 100000, 'x');
+    Plugin::DownloadQueue::Request second = package("app_1.1_arm.ipk", 100000, 'x');
+    ASSERT_EQ(first.Sha256, second.Sha256);
+
+    auto downloads = queue(2);
+    downloads->Submit(1, first);
+    downloads->Submit(2, second);
+    ASSERT_TRUE(waitFor(2));
+    EXPECT_EQ(completed[1], completed[2]);
+    Plugin::DownloadQueue::Statistics stats = downloads->Stats();
+    // The second shares the first download, or finds it in the cache when that completed already
+    EXPECT_EQ(1u, stats.Downloads);
+    EXPECT_EQ(1u, stats.Shared + stats.CacheHits);
+
+    // Cached now, by SHA-256 or by MD5 only
+    Plugin::DownloadQueue::Request md5Only = first;
+    md5Only.Sha256.clear();
+    EXPECT_EQ(completed[1], downloads->Cached(first));
+    EXPECT_EQ(completed[1], downloads->Cached(md5Only));
+    downloads->Submit(3, md5Only);
+    ASSERT_TRUE(waitFor(3));
+    EXPECT_EQ(completed[1], completed[3]);
+    EXPECT_EQ(1u, downloads->Stats().Downloads);
+}
+
+TEST_F(DownloadQueueTest, VerificationFailures)
+{
+    auto downloads = queue(2);
+
+    Plugin::DownloadQueue::Request wrong = package("wrong_1.0_arm.ipk", 5000, 'w');
+    wrong.Sha256 = otherSha256;
+    downloads->Submit(1, wrong);
+
+    Plugin::DownloadQueue::Request missing;
+    missing.Url = "file://" + feed + "missing_1.0_arm.ipk";
+    downloads->Submit(2, missing);
+
+    ASSERT_TRUE(waitFor(2));
+    EXPECT_TRUE(completed[1].empty());
+    EXPECT_TRUE(completed[2].empty());
+    EXPECT_EQ(2u, downloads->Stats().Failures);
+
+    // Nothing is left behind in the cache
+    EXPECT_EQ(0, std::system(("test -z \"$(ls -A " + cache + ")\"").c_str()));
+
+    // A cached package that changed is not handed out
+    Plugin::DownloadQueue::Request good = package("good_1.0_arm.ipk", 5000, 'g');
+    downloads->Submit(3, good);
+    ASSERT_TRUE(waitFor(3));
+    ASSERT_FALSE(completed[3].empty());
+    std::ofstream(completed[3], std::ios::binary | std::ios::app) << "tampered";
+    EXPECT_TRUE(downloads->Cached(good).empty());
+}
+
+TEST_F(DownloadQueueTest, LimitRemovesTheLeastRecentlyUsed)
+{
+    // Room for two of the packages
+    auto downloads = queue(1, 250000);
+    Plugin::DownloadQueue::Request first = package("first_1.0_arm.ipk", 100000, '1');
+    Plugin::DownloadQueue::Request second = package("second_1.0_arm.ipk", 100000, '2');
+    Plugin::DownloadQueue::Request third = package("third_1.0_arm.ipk", 100000, '3');
+
+    downloads->Submit(1, first);
+    downloads->Submit(2, second);
+    ASSERT_TRUE(waitFor(2));
+    downloads->Release(completed[1], false);
+    downloads->Release(completed[2], false);
+    age(completed[1], 200);
+    age(completed[2], 300);
+
+    // Used again, the first is the more recent one
+    downloads->Submit(3, first);
+    ASSERT_TRUE(waitFor(3));
+    EXPECT_EQ(1u, downloads->Stats().CacheHits);
+    downloads->Release(completed[3], false);
+
+    downloads->Submit(4, third);
+    ASSERT_TRUE(waitFor(4));
+    EXPECT_EQ(1u, downloads->Stats().Evictions);
+    EXPECT_FALSE(exists(completed[2]));
+    EXPECT_FALSE(exists(cache + "md5-" + second.Md5 + ".ipk"));
+    EXPECT_EQ(completed[1], downloads->Cached(first));
+    EXPECT_EQ(completed[4], downloads->Cached(third));
+}
+
+TEST_F(DownloadQueueTest, HeldPackagesAreKept)
+{
+    auto downloads = queue(2, 1);
+    Plugin::DownloadQueue::Request first = package("first_1.0_arm.ipk", 5000, '1');
+    Plugin::DownloadQueue::Request second = package("second_1.0_arm.ipk", 5000, '2');
+    downloads->Submit(1, first);
+    downloads->Submit(2, second);
+    ASSERT_TRUE(waitFor(2));
+
+    // Over the limit, but not released yet
+    EXPECT_TRUE(exists(completed[1]));
+    EXPECT_TRUE(exists(completed[2]));
+    EXPECT_EQ(0u, downloads->Stats().Evictions);
+
+    downloads->Release(completed[1], false);
+    EXPECT_FALSE(exists(completed[1]));
+    EXPECT_EQ(1u, downloads->Stats().Evictions);
+
+    // Removed when released as installed, whatever the limit
+    auto unbounded = queue(1);
+    Plugin::DownloadQueue::Request third = package("third_1.0_arm.ipk", 5000, '3');
+    unbounded->Submit(3, third);
+    ASSERT_TRUE(waitFor(3));
+    unbounded->Release(completed[3], true);
+    EXPECT_FALSE(exists(completed[3]));
+    EXPECT_FALSE(exists(cache + "md5-" + third.Md5 + ".ipk"));
+    EXPECT_TRUE(exists(completed[2]));
+}
@@ -0,0 +1,159 @@
+/*
+ * If not stated otherwise in this file or this component's LICENSE file the
+ * following copyright and licenses apply:
+ *
+ * Copyright 2022 RDK Management
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include <gtest/gtest.h>
+
+#include <chrono>
+
+#include "EpgCache.h"
+
+using namespace WPEFramework;
+
+namespace {
+const uint32_t kEpoch = 1587562065;
+const uint32_t kSlot = 30 * 60;
+const uint32_t kDay = 24 * 60 * 60;
+
+// Half hour events for the given number of days, handed over in reverse
+// order to check the cache sorts them.
+std::vector<Plugin::EpgCache::Event> schedule(uint32_t days)
+{
+    std::vector<Plugin::EpgCache::Event> events;
+    for (uint32_t slot = (days * kDay) / kSlot; slot > 0; slot--) {
+        Plugin::EpgCache::Event event;
+        event.eventId = static_cast<uint16_t>(slot);
+        event.startTime = kEpoch + (slot - 1) * kSlot;
+        event.duration = kSlot;
+        event.name = "Event " + std::to_string(slot);
+        event.shortDescription = "Synthetic event";
+        events.push_back(event);
+    }
+    return events;
+}
+}
+
+TEST(EpgCacheTest, uri)
+{
+    Plugin::EpgCache::ServiceKey key = Plugin::EpgCache::Key(9018, 4161, 1001);
+    EXPECT_EQ("9018.4161.1001", Plugin::EpgCache::Uri(key));
+    EXPECT_NE(key, Plugin::EpgCache::Key(9018, 1001, 4161));
+}
+
+TEST(EpgCacheTest, events)
+{
+    Plugin::EpgCache cache;
+    Plugin::EpgCache::ServiceKey key = Plugin::EpgCache::Key(1, 2, 3);
+    std::vector<Plugin::EpgCache::Event> events;
+
+    EXPECT_FALSE(cache.Contains(key));
+    EXPECT_FALSE(cache.Events(key, 0, 0xffffffff, events));
+
+    cache.Update(key, schedule(1));
+    EXPECT_TRUE(cache.Contains(key));
+
+    EXPECT_TRUE(cache.Events(key, 0, 0xffffffff, events));
+    ASSERT_EQ(48u, events.size());
+    EXPECT_EQ(kEpoch, events.front().startTime);
+    EXPECT_EQ(kEpoch + 47 * kSlot, events.back().startTime);
+
+    // Both ends of the window are inclusive.
+    events.clear();
+    EXPECT_TRUE(cache.Events(key, kEpoch + kSlot, kEpoch + 3 * kSlot, events));
+    ASSERT_EQ(3u, events.size());
+    EXPECT_EQ(2u, events.front().eventId);
+
+    events.clear();
+    EXPECT_TRUE(cache.Events(key, kEpoch + kDay, 0xffffffff, events));
+    EXPECT_TRUE(events.empty());
+
+    cache.Remove(key);
+    EXPECT_FALSE(cache.Contains(key));
+}
+
+TEST(EpgCacheTest, windowPaging)
+{
+    Plugin::EpgCache cache;
+    std::vector<Plugin::EpgCache::ServiceKey> services;
+    for (uint16_t id = 1; id <= 3; id++) {
+        services.push_back(Plugin::EpgCache::Key(1, 1, id));
+        cache.Update(services.back(), schedule(1));
+    }
+
+    // Four events per service start within the first two hours.
+    uint32_t end = kEpoch + 2 * 60 * 60 - 1;
+    std::vector<Plugin::EpgCache::ServiceEvent> page;
+
+    EXPECT_EQ(12u, cache.Window(services, kEpoch, end, 0, 5, page));
+    ASSERT_EQ(5u, page.size());
+    EXPECT_EQ(services[0], page[0].first);
+    EXPECT_EQ(services[1], page[4].first);
+    EXPECT_EQ(kEpoch, page[4].second.startTime);
+
+    page.clear();
+    EXPECT_EQ(12u, cache.Window(services, kEpoch, end, 10, 5, page));
+    ASSERT_EQ(2u, page.size());
+    EXPECT_EQ(services[2], page[0].first);
+    EXPECT_EQ(kEpoch + 2 * kSlot, page[0].second.startTime);
+
+    page.clear();
+    EXPECT_EQ(12u, cache.Window(std::vector<Plugin::EpgCache::ServiceKey>(), kEpoch, end, 12, 5, page));
+    EXPECT_TRUE(page.empty());
+
+    // Unknown services are skipped.
+    page.clear();
+    std::vector<Plugin::EpgCache::ServiceKey> unknown(1, Plugin::EpgCache::Key(9, 9, 9));
+    EXPECT_EQ(0u, cache.Window(unknown, kEpoch, end, 0, 5, page));
+}
+
+TEST(EpgCacheTest, benchmark500Services7Days)
+{
+    const uint16_t kServices = 500;
+
+    Plugin::EpgCache cache;
+    std::vector<Plugin::EpgCache::ServiceKey> services;
+
+    auto start = std::chrono::steady_clock::now();
+    for (uint16_t id = 1; id <= kServices; id++) {
+        services.push_back(Plugin::EpgCache::Key(9018, 4161, id));
+        cache.Update(services.back(), schedule(7));
+    }
+    auto populated = std::chrono::steady_clock::now();
+
+    // A guide page: 3 hours of 10 channels, scrolled through the week.
+    const uint32_t kQueries = 1000;
+    uint32_t matched = 0;
+    for (uint32_t query = 0; query < kQueries; query++) {
+        uint32_t from = kEpoch + (query % (7 * 8)) * 3 * 60 * 60;
+        std::vector<Plugin::EpgCache::ServiceKey> page(services.begin() + (query % 49) * 10,
+            services.begin() + (query % 49) * 10 + 10);
+        std::vector<Plugin::EpgCache::ServiceEvent> events;
+        matched += cache.Window(page, from, from + 3 * 60 * 60 - 1, 0, 0xffffffff, events);
+    }
+    auto queried = std::chrono::steady_clock::now();
+
+    EXPECT_EQ(kQueries * 10 * 6, matched);
+
+    std::vector<Plugin::EpgCache::ServiceEvent> events;
+    EXPECT_EQ(kServices * 6u, cache.Window(std::vector<Plugin::EpgCache::ServiceKey>(),
+                                  kEpoch, kEpoch + 3 * 60 * 60 - 1, 0, 50, events));
+    EXPECT_EQ(50u, events.size());
+
+    RecordProperty("populateMs", static_cast<int>(std::chrono::duration_cast<std::chrono::milliseconds>(populated - start).count()));
+    RecordProperty("queryUs", static_cast<int>(std::chrono::duration_cast<std::chrono::microseconds>(queried - populated).count() / kQueries));
+}
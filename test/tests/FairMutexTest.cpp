@@ -0,0 +1,189 @@
+/*
+ * If not stated otherwise in this file or this component's LICENSE file the
+ * following copyright and licenses apply:
+ *
+ * Copyright 2022 RDK Management
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include <gtest/gtest.h>
+
+#include <time.h>
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <iostream>
+#include <thread>
+#include <vector>
+
+#include "FairMutex.h"
+
+using namespace WPEFramework;
+
+namespace {
+typedef Plugin::FairMutex Mutex;
+typedef std::chrono::steady_clock Clock;
+
+const int kApiThreads = 8;
+const std::chrono::microseconds kFrame(16667);
+const std::chrono::microseconds kDraw(8000);
+const std::chrono::milliseconds kRunTime(500);
+const std::chrono::milliseconds kSpinTime(250);
+
+struct Result {
+    double cpuMs;
+    int frames;
+    int calls;
+    long maxWaitUs;
+};
+
+double processCpuMs()
+{
+    timespec ts;
+    clock_gettime(CLOCK_PROCESS_CPUTIME_ID, &ts);
+    return ts.tv_sec * 1000.0 + ts.tv_nsec / 1000000.0;
+}
+
+// What lockRdkShellMutex did before: spin on try_lock, then block.
+void spinLock(std::mutex& mutex)
+{
+    auto start = Clock::now();
+    while (Clock::now() - start < kSpinTime) {
+        if (mutex.try_lock())
+            return;
+    }
+    mutex.lock();
+}
+
+// 8 API threads take the lock for a short call while a 60 fps render loop
+// holds it for half of every frame, as RDKShell's render thread does.
+template <typename MutexType, typename LockFunction>
+Result runContention(MutexType& mutex, LockFunction apiLock)
+{
+    std::atomic<bool> running(true);
+    std::atomic<int> calls(0);
+    std::atomic<long> maxWaitUs(0);
+    int frames = 0;
+    double cpuStart = processCpuMs();
+
+    std::vector<std::thread> apiThreads;
+    for (int i = 0; i < kApiThreads; i++) {
+        apiThreads.emplace_back([&]() {
+            while (running) {
+                auto start = Clock::now();
+                apiLock(mutex);
+                long waitUs = std::chrono::duration_cast<std::chrono::microseconds>(Clock::now() - start).count();
+                std::this_thread::sleep_for(std::chrono::microseconds(100));
+                mutex.unlock();
+                calls++;
+                long previous = maxWaitUs;
+                while (waitUs > previous && !maxWaitUs.compare_exchange_weak(previous, waitUs)) {
+                }
+                std::this_thread::sleep_for(std::chrono::milliseconds(2));
+            }
+        });
+    }
+
+    auto end = Clock::now() + kRunTime;
+    while (Clock::now() < end) {
+        auto frameStart = Clock::now();
+        mutex.lock();
+        std::this_thread::sleep_for(kDraw);
+        mutex.unlock();
+        frames++;
+        std::this_thread::sleep_until(frameStart + kFrame);
+    }
+    running = false;
+    for (auto& thread : apiThreads)
+        thread.join();
+
+    Result result;
+    result.cpuMs = processCpuMs() - cpuStart;
+    result.frames = frames;
+    result.calls = calls;
+    result.maxWaitUs = maxWaitUs;
+    return result;
+}
+}
+
+TEST(FairMutexTest, WaitersAreServedInArrivalOrder)
+{
+    Mutex mutex;
+    mutex.lock();
+    EXPECT_FALSE(mutex.try_lock());
+
+    std::vector<int> order;
+    std::vector<std::thread> threads;
+    for (int i = 0; i < 4; i++) {
+        threads.emplace_back([&mutex, &order, i]() {
+            mutex.lock();
+            order.push_back(i);
+            mutex.unlock();
+        });
+        // let the thread queue up before the next one arrives
+        std::this_thread::sleep_for(std::chrono::milliseconds(20));
+    }
+    mutex.unlock();
+    for (auto& thread : threads)
+        thread.join();
+
+    EXPECT_EQ(std::vector<int>({ 0, 1, 2, 3 }), order);
+    EXPECT_TRUE(mutex.try_lock());
+    mutex.unlock();
+}
+
+TEST(FairMutexTest, TimedWaiterLeavesTheLine)
+{
+    Mutex mutex;
+    mutex.lock();
+
+    bool timedOut = false;
+    std::thread timed([&]() { timedOut = !mutex.try_lock_for(std::chrono::milliseconds(30)); });
+    std::this_thread::sleep_for(std::chrono::milliseconds(10));
+    std::atomic<bool> acquired(false);
+    std::thread waiting([&]() {
+        mutex.lock();
+        acquired = true;
+        mutex.unlock();
+    });
+    timed.join();
+    EXPECT_TRUE(timedOut);
+    EXPECT_FALSE(acquired);
+
+    mutex.unlock();
+    waiting.join();
+    EXPECT_TRUE(acquired);
+    EXPECT_TRUE(mutex.try_lock_for(std::chrono::milliseconds(0)));
+    mutex.unlock();
+}
+
+TEST(FairMutexTest, ContentionWithRenderLoop)
+{
+    std::mutex spinMutex;
+    Result spin = runContention(spinMutex, spinLock);
+
+    Mutex fairMutex;
+    Result fair = runContention(fairMutex, [](Mutex& mutex) { mutex.lock(); });
+
+    std::cout << kApiThreads << " api threads against 60 fps for " << kRunTime.count() << "ms:" << std::endl
+              << "  try_lock spin: cpu " << spin.cpuMs << "ms, frames " << spin.frames << ", calls " << spin.calls
+              << ", max wait " << spin.maxWaitUs << "us" << std::endl
+              << "  fair mutex:    cpu " << fair.cpuMs << "ms, frames " << fair.frames << ", calls " << fair.calls
+              << ", max wait " << fair.maxWaitUs << "us" << std::endl;
+
+    EXPECT_LT(fair.cpuMs, spin.cpuMs);
+    EXPECT_GE(fair.frames, 25);
+    EXPECT_GT(fair.calls, 0);
+}
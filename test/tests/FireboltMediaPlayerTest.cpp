@@ -0,0 +1,225 @@
+#include <gtest/gtest.h>
+
+#include <chrono>
+#include <condition_variable>
+#include <map>
+#include <thread>
+#include <vector>
+
+#include "AampMediaStream.h"
+#include "FireboltMediaPlayer.h"
+
+#include "FactoriesImplementation.h"
+#include "ServiceMock.h"
+#include "source/WorkerPoolImplementation.h"
+
+using namespace WPEFramework;
+
+namespace {
+const string progressEvent = _T("playbackProgressUpdate");
+const string streamId = _T("main");
+
+AAMPEvent progress(double positionMiliseconds)
+{
+    AAMPEvent event = {};
+    event.type = AAMP_EVENT_PROGRESS;
+    event.data.progress.durationMiliseconds = 600000;
+    event.data.progress.positionMiliseconds = positionMiliseconds;
+    event.data.progress.playbackSpeed = 1;
+    event.data.progress.startMiliseconds = 0;
+    event.data.progress.endMiliseconds = 600000;
+    return event;
+}
+}
+
+class FireboltMediaPlayerTestFixture : public ::testing::Test {
+protected:
+    Core::ProxyType<WorkerPoolImplementation> workerPool;
+    Core::ProxyType<Plugin::FireboltMediaPlayer> plugin;
+    Core::JSONRPC::Handler& handler;
+    Core::JSONRPC::Connection connection;
+    Core::JSONRPC::Message message;
+    ServiceMock service;
+    FactoriesImplementation factoriesImplementation;
+    PluginHost::IDispatcher* dispatcher;
+    string response;
+
+    // The positions of the progress events each channel got
+    std::mutex lock;
+    std::condition_variable condition;
+    std::map<uint32_t, std::vector<int>> positions;
+    std::chrono::milliseconds deliveryTime;
+
+    FireboltMediaPlayerTestFixture()
+        : workerPool(Core::ProxyType<WorkerPoolImplementation>::Create(
+            2, Core::Thread::DefaultStackSize(), 16))
+        , plugin(Core::ProxyType<Plugin::FireboltMediaPlayer>::Create())
+        , handler(*plugin)
+        , connection(1, 0)
+        , dispatcher(nullptr)
+        , deliveryTime(0)
+    {
+        PluginHost::IFactories::Assign(&factoriesImplementation);
+    }
+    virtual ~FireboltMediaPlayerTestFixture()
+    {
+        PluginHost::IFactories::Assign(nullptr);
+    }
+
+    virtual void SetUp()
+    {
+        Core::IWorkerPool::Assign(&(*workerPool));
+        workerPool->Run();
+
+        EXPECT_CALL(service, Submit(::testing::_, ::testing::_))
+            .Times(::testing::AnyNumber())
+            .WillRepeatedly(::testing::Invoke(
+                [&](const uint32_t channel, const Core::ProxyType<Core::JSON::IElement>& json) {
+                    string text;
+                    EXPECT_TRUE(json->ToString(text));
+                    JsonObject notification(text);
+                    string method = notification["method"].String();
+                    EXPECT_EQ(string("." + progressEvent), method.substr(method.rfind('.')));
+                    int position = notification["params"].Object()[streamId.c_str()].Object()["positionMiliseconds"].Number();
+
+                    // The client taking its time
+                    std::this_thread::sleep_for(deliveryTime);
+                    std::lock_guard<std::mutex> guard(lock);
+                    positions[channel].push_back(position);
+                    condition.notify_all();
+                    return Core::ERROR_NONE;
+                }));
+
+        dispatcher = static_cast<PluginHost::IDispatcher*>(
+            plugin->QueryInterface(PluginHost::IDispatcher::ID));
+        ASSERT_TRUE(dispatcher != nullptr);
+        dispatcher->Activate(&service);
+    }
+
+    virtual void TearDown()
+    {
+        if (dispatcher != nullptr) {
+            dispatcher->Deactivate();
+            dispatcher->Release();
+        }
+        plugin.Release();
+
+        Core::IWorkerPool::Assign(nullptr);
+        workerPool.Release();
+    }
+
+    size_t received(uint32_t channel)
+    {
+        std::lock_guard<std::mutex> guard(lock);
+        return positions[channel].size();
+    }
+
+    bool waitFor(uint32_t channel, int position)
+    {
+        std::unique_lock<std::mutex> guard(lock);
+        return condition.wait_for(guard, std::chrono::seconds(5), [&]() {
+            return !positions[channel].empty() && positions[channel].back() == position;
+        });
+    }
+};
+
+TEST_F(FireboltMediaPlayerTestFixture, SlowClientGetsTheLatestProgress)
+{
+    deliveryTime = std::chrono::milliseconds(20);
+    handler.Subscribe(1, progressEvent, _T("client.events.1"), message);
+
+    Exchange::IMediaPlayer::IMediaStream* stream = Core::Service<Plugin::AampMediaStream>::Create<Exchange::IMediaPlayer::IMediaStream>();
+    Plugin::FireboltMediaPlayer::MediaStreamProxy proxy(*plugin, streamId, stream);
+    AAMPEventListener* listener = PlayerInstanceAAMP::listener();
+    ASSERT_TRUE(listener != nullptr);
+
+    // AAMP reporting faster than the client takes it
+    for (int i = 1; i <= 100; i++) {
+        listener->Event(progress(i * 1000));
+        std::this_thread::sleep_for(std::chrono::milliseconds(1));
+    }
+    EXPECT_TRUE(waitFor(1, 100000));
+
+    {
+        std::lock_guard<std::mutex> guard(lock);
+        const std::vector<int>& delivered = positions[1];
+        EXPECT_LT(delivered.size(), 100u);
+        // In order, ending with the last
+        for (size_t i = 1; i < delivered.size(); i++) {
+            EXPECT_LT(delivered[i - 1], delivered[i]);
+        }
+    }
+
+    EXPECT_EQ(Core::ERROR_NONE, handler.Invoke(connection, _T("getPlaybackPosition"), _T("{\"id\":\"main\"}"), response));
+    EXPECT_TRUE(JsonObject(response)["success"].Boolean());
+    EXPECT_GE(JsonObject(response)["positionMiliseconds"].Number(), 100000);
+
+    EXPECT_EQ(Core::ERROR_DESTRUCTION_SUCCEEDED, proxy.Release());
+    handler.Unsubscribe(1, progressEvent, _T("client.events.1"), message);
+}
+
+TEST_F(FireboltMediaPlayerTestFixture, RateLimitPerClient)
+{
+    handler.Subscribe(1, progressEvent, _T("client.events.1"), message);
+    handler.Subscribe(2, progressEvent, _T("client.events.2"), message);
+    EXPECT_EQ(Core::ERROR_NONE, handler.Invoke(connection, _T("setProgressInterval"), _T("{\"client\":\"client.events.1\",\"intervalMs\":200}"), response));
+    EXPECT_EQ(response, string("{\"success\":true}"));
+
+    Exchange::IMediaPlayer::IMediaStream* stream = Core::Service<Plugin::AampMediaStream>::Create<Exchange::IMediaPlayer::IMediaStream>();
+    Plugin::FireboltMediaPlayer::MediaStreamProxy proxy(*plugin, streamId, stream);
+    AAMPEventListener* listener = PlayerInstanceAAMP::listener();
+    ASSERT_TRUE(listener != nullptr);
+
+    auto start = std::chrono::steady_clock::now();
+    for (int i = 1; i <= 10; i++) {
+        listener->Event(progress(i * 1000));
+        EXPECT_TRUE(waitFor(2, i * 1000));
+        std::this_thread::sleep_for(std::chrono::milliseconds(50));
+    }
+
+    // Delivered all by then
+    EXPECT_EQ(Core::ERROR_DESTRUCTION_SUCCEEDED, proxy.Release());
+    auto elapsedMs = std::chrono::duration_cast<std::chrono::milliseconds>(std::chrono::steady_clock::now() - start).count();
+
+    // Every progress without an interval, at most one every 200 ms with
+    EXPECT_EQ(10u, received(2));
+    EXPECT_GE(received(1), 1u);
+    EXPECT_LE(received(1), 1u + elapsedMs / 200);
+
+    handler.Unsubscribe(1, progressEvent, _T("client.events.1"), message);
+    handler.Unsubscribe(2, progressEvent, _T("client.events.2"), message);
+}
+
+TEST_F(FireboltMediaPlayerTestFixture, UnregisteredClientLosesItsInterval)
+{
+    handler.Subscribe(1, progressEvent, _T("client.events.1"), message);
+    handler.Subscribe(2, progressEvent, _T("client.events.2"), message);
+    EXPECT_EQ(Core::ERROR_NONE, handler.Invoke(connection, _T("setProgressInterval"), _T("{\"client\":\"client.events.1\",\"intervalMs\":60000}"), response));
+
+    Exchange::IMediaPlayer::IMediaStream* stream = Core::Service<Plugin::AampMediaStream>::Create<Exchange::IMediaPlayer::IMediaStream>();
+    Plugin::FireboltMediaPlayer::MediaStreamProxy proxy(*plugin, streamId, stream);
+    AAMPEventListener* listener = PlayerInstanceAAMP::listener();
+    ASSERT_TRUE(listener != nullptr);
+
+    listener->Event(progress(1000));
+    EXPECT_TRUE(waitFor(2, 1000));
+    listener->Event(progress(2000));
+    EXPECT_TRUE(waitFor(2, 2000));
+    EXPECT_EQ(1u, received(1));
+
+    handler.Unsubscribe(1, progressEvent, _T("client.events.1"), message);
+    listener->Event(progress(3000));
+    EXPECT_TRUE(waitFor(2, 3000));
+
+    // Registered again, without the interval
+    handler.Subscribe(1, progressEvent, _T("client.events.1"), message);
+    listener->Event(progress(4000));
+    EXPECT_TRUE(waitFor(2, 4000));
+    listener->Event(progress(5000));
+    EXPECT_TRUE(waitFor(2, 5000));
+
+    EXPECT_EQ(Core::ERROR_DESTRUCTION_SUCCEEDED, proxy.Release());
+    EXPECT_EQ(3u, received(1));
+    handler.Unsubscribe(1, progressEvent, _T("client.events.1"), message);
+    handler.Unsubscribe(2, progressEvent, _T("client.events.2"), message);
+}
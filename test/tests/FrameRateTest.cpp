@@ -74,6 +74,8 @@ TEST_F(FrameRateTestFixture, RegisteredMethods)
     EXPECT_EQ(Core::ERROR_NONE, handlerV2.Exists(_T("getFrmMode")));
     EXPECT_EQ(Core::ERROR_NONE, handlerV2.Exists(_T("getDisplayFrameRate")));
     EXPECT_EQ(Core::ERROR_NONE, handlerV2.Exists(_T("setDisplayFrameRate")));
+    EXPECT_EQ(Core::ERROR_NONE, handlerV2.Exists(_T("updateFrameTimes")));
+    EXPECT_EQ(Core::ERROR_NONE, handlerV2.Exists(_T("getFrameTimeStats")));
 }
 
 TEST_F(FrameRateTestFixture, Plugin)
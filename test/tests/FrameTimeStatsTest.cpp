@@ -0,0 +1,181 @@
+/*
+ * If not stated otherwise in this file or this component's LICENSE file the
+ * following copyright and licenses apply:
+ *
+ * Copyright 2022 RDK Management
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include <gtest/gtest.h>
+
+#include <chrono>
+#include <random>
+#include <vector>
+
+#include "FrameTimeStats.h"
+
+using namespace WPEFramework;
+
+namespace {
+const uint64_t vsyncUs = 16667;
+
+// Frames of a 60 Hz display: every frame on time, but for the given frames
+// that take the given number of refresh periods, with some jitter
+std::vector<uint64_t> syntheticLoad(size_t frames, const std::vector<std::pair<size_t, int>>& stalls, unsigned seed = 1)
+{
+    std::mt19937 random(seed);
+    std::uniform_int_distribution<int> jitter(-500, 500);
+    std::vector<uint64_t> timestamps;
+    uint64_t us = 1000000000ULL;
+    size_t next = 0;
+    for (size_t i = 0; i < frames; i++) {
+        int periods = 1;
+        if (next < stalls.size() && stalls[next].first == i) {
+            periods = stalls[next++].second;
+        }
+        us += periods * vsyncUs;
+        timestamps.push_back(us + jitter(random));
+    }
+    return timestamps;
+}
+}
+
+TEST(FrameTimeStatsTest, SteadyFramesHaveNoLows)
+{
+    Plugin::FrameTimeStats stats;
+    std::vector<uint64_t> timestamps = syntheticLoad(601, {});
+    EXPECT_EQ(600u, stats.addTimestamps(timestamps.data(), timestamps.size()));
+
+    Plugin::FrameTimeStats::Summary summary;
+    stats.summary(summary);
+    EXPECT_EQ(600u, summary.frames);
+    EXPECT_EQ(0u, summary.dropped);
+    EXPECT_NEAR(60.0, summary.averageFps, 0.5);
+    EXPECT_GT(summary.low1Fps, 50.0);
+    EXPECT_GT(summary.low01Fps, 50.0);
+    EXPECT_GE(summary.minIntervalMs, 15.6);
+    EXPECT_LE(summary.maxIntervalMs, 17.7);
+
+    uint32_t counted = 0;
+    for (const auto& bucket : summary.histogram) {
+        counted += bucket.second;
+    }
+    EXPECT_EQ(600u, counted);
+    EXPECT_LE(summary.histogram.size(), 3u);
+}
+
+TEST(FrameTimeStatsTest, StallsShowInLowsAndDroppedFrames)
+{
+    // 10 s at 60 Hz: 10 frames of 2 periods (1.7%) and one of 6
+    std::vector<std::pair<size_t, int>> stalls;
+    for (size_t i = 50; i < 550; i += 50) {
+        stalls.push_back(std::make_pair(i, 2));
+    }
+    stalls.push_back(std::make_pair(580, 6));
+    std::vector<uint64_t> timestamps = syntheticLoad(601, stalls);
+
+    // In batches, as a compositor would send them
+    Plugin::FrameTimeStats stats;
+    size_t recorded = 0;
+    for (size_t i = 0; i < timestamps.size(); i += 30) {
+        size_t count = std::min<size_t>(30, timestamps.size() - i);
+        recorded += stats.addTimestamps(&timestamps[i], count);
+    }
+    EXPECT_EQ(600u, recorded);
+
+    Plugin::FrameTimeStats::Summary summary;
+    stats.summary(summary);
+    EXPECT_EQ(600u, summary.frames);
+    EXPECT_EQ(10u + 5u, summary.dropped);
+    EXPECT_NEAR(60.0 * 600 / (600 + 15), summary.averageFps, 0.5);
+    // The slowest 1% are the stalls of two periods, the slowest 0.1% the one of six
+    EXPECT_NEAR(30.0, summary.low1Fps, 3.0);
+    EXPECT_NEAR(10.0, summary.low01Fps, 1.0);
+    EXPECT_NEAR(100.0, summary.maxIntervalMs, 1.0);
+}
+
+TEST(FrameTimeStatsTest, WindowsAndRestarts)
+{
+    Plugin::FrameTimeStats stats(50.0);
+    EXPECT_NEAR(50.0, stats.expectedFps(), 0.01);
+
+    uint64_t timestamps[] = { 1000000, 1020000, 1040000, 1060000 };
+    EXPECT_EQ(3u, stats.addTimestamps(timestamps, 4));
+
+    // The interval spanning the windows counts in the next one
+    stats.nextWindow();
+    EXPECT_EQ(0u, stats.frames());
+    uint64_t more[] = { 1100000 };
+    EXPECT_EQ(1u, stats.addTimestamps(more, 1));
+    Plugin::FrameTimeStats::Summary summary;
+    stats.summary(summary);
+    EXPECT_EQ(1u, summary.dropped);
+
+    // A timestamp going back starts over, as does a reset
+    uint64_t restarted[] = { 500000, 520000 };
+    EXPECT_EQ(1u, stats.addTimestamps(restarted, 2));
+    stats.reset();
+    uint64_t first[] = { 600000 };
+    EXPECT_EQ(0u, stats.addTimestamps(first, 1));
+
+    Plugin::FrameTimeStats empty;
+    empty.summary(summary);
+    EXPECT_EQ(0u, summary.frames);
+    EXPECT_EQ(0.0, summary.low1Fps);
+    EXPECT_TRUE(summary.histogram.empty());
+}
+
+TEST(FrameTimeStatsTest, HistogramBuckets)
+{
+    typedef Plugin::FrameTimeHistogram Histogram;
+    EXPECT_EQ(0, Histogram::bucketOf(999));
+    EXPECT_EQ(1, Histogram::bucketOf(1000));
+    EXPECT_EQ(1 + Histogram::STEPS_PER_OCTAVE, Histogram::bucketOf(2000));
+    EXPECT_EQ(Histogram::BUCKETS - 1, Histogram::bucketOf(60000000));
+
+    Histogram histogram;
+    for (uint64_t us = 1000; us < 5000000; us = us * 11 / 10) {
+        histogram.record(us);
+        int bucket = Histogram::bucketOf(us);
+        EXPECT_LE(histogram.lowerUs(bucket), (double)us);
+        if (bucket < Histogram::BUCKETS - 1) {
+            EXPECT_GT(histogram.upperUs(bucket), (double)us);
+        }
+    }
+}
+
+TEST(FrameTimeStatsTest, benchmarkSyntheticLoad)
+{
+    // An hour at 60 Hz with a stall every second
+    std::vector<std::pair<size_t, int>> stalls;
+    for (size_t i = 30; i < 216000; i += 60) {
+        stalls.push_back(std::make_pair(i, 3));
+    }
+    std::vector<uint64_t> timestamps = syntheticLoad(216001, stalls);
+
+    Plugin::FrameTimeStats stats;
+    auto start = std::chrono::steady_clock::now();
+    for (size_t i = 0; i < timestamps.size(); i += 60) {
+        stats.addTimestamps(&timestamps[i], std::min<size_t>(60, timestamps.size() - i));
+    }
+    Plugin::FrameTimeStats::Summary summary;
+    stats.summary(summary);
+    auto elapsed = std::chrono::duration_cast<std::chrono::microseconds>(std::chrono::steady_clock::now() - start).count();
+
+    EXPECT_EQ(216000u, summary.frames);
+    EXPECT_EQ(2u * stalls.size(), summary.dropped);
+    EXPECT_NEAR(20.0, summary.low1Fps, 2.0);
+    RecordProperty("frames", (int)summary.frames);
+    RecordProperty("nsPerFrame", (int)(elapsed * 1000 / summary.frames));
+}
@@ -0,0 +1,210 @@
+#include <gtest/gtest.h>
+
+#include <chrono>
+#include <iostream>
+#include <memory>
+#include <vector>
+
+#include "UtilsJsonRpcDirectLink.h"
+
+#include "FactoriesImplementation.h"
+#include "ServiceMock.h"
+
+using namespace WPEFramework;
+
+namespace {
+const string callSign = _T("org.rdk.Echo");
+const int kCalls = 1000;
+
+class EchoPlugin : public PluginHost::JSONRPC {
+public:
+    EchoPlugin()
+        : PluginHost::JSONRPC()
+    {
+        Register<JsonObject, JsonObject>(_T("echo"), &EchoPlugin::echo, this);
+        Register<JsonObject, Core::JSON::String>(_T("name"), &EchoPlugin::name, this);
+    }
+
+    BEGIN_INTERFACE_MAP(EchoPlugin)
+    INTERFACE_ENTRY(PluginHost::IDispatcher)
+    END_INTERFACE_MAP
+
+private:
+    uint32_t echo(const JsonObject& parameters, JsonObject& response)
+    {
+        response = parameters;
+        response["success"] = true;
+        return Core::ERROR_NONE;
+    }
+
+    uint32_t name(const JsonObject&, Core::JSON::String& response)
+    {
+        response = callSign;
+        return Core::ERROR_NONE;
+    }
+};
+
+// Stands in for the WebSocket link of a plugin not in process: echoes, and
+// fails anything else with an error of the plugin.
+class StandInLink {
+public:
+    explicit StandInLink(const string& designator)
+        : designator(designator)
+    {
+    }
+
+    template <typename PARAMETERS, typename RESPONSE>
+    uint32_t Invoke(const uint32_t, const string& method, const PARAMETERS& parameters, RESPONSE& response)
+    {
+        methods.push_back(method);
+        if (method != _T("echo")) {
+            return Core::ERROR_UNKNOWN_KEY;
+        }
+        response = parameters;
+        return Core::ERROR_NONE;
+    }
+
+    string designator;
+    std::vector<string> methods;
+};
+
+typedef Utils::LinkPool<StandInLink> StandInPool;
+}
+
+class JSONRPCDirectLinkTestFixture : public ::testing::Test {
+protected:
+    Core::ProxyType<EchoPlugin> plugin;
+    ServiceMock service;
+    FactoriesImplementation factoriesImplementation;
+
+    JSONRPCDirectLinkTestFixture()
+        : plugin(Core::ProxyType<EchoPlugin>::Create())
+    {
+        PluginHost::IFactories::Assign(&factoriesImplementation);
+    }
+    virtual ~JSONRPCDirectLinkTestFixture()
+    {
+        PluginHost::IFactories::Assign(nullptr);
+    }
+
+    virtual void SetUp()
+    {
+        ON_CALL(service, QueryInterfaceByCallsign(::testing::_, ::testing::_))
+            .WillByDefault(::testing::Invoke(
+                [&](const uint32_t id, const string& name) -> void* {
+                    if ((id == PluginHost::IDispatcher::ID) && (name == callSign)) {
+                        // the link releases what it queried
+                        plugin->AddRef();
+                        return static_cast<PluginHost::IDispatcher*>(&(*plugin));
+                    }
+                    return nullptr;
+                }));
+    }
+
+    virtual void TearDown()
+    {
+        plugin.Release();
+    }
+};
+
+TEST_F(JSONRPCDirectLinkTestFixture, InvokesPluginInProcess)
+{
+    Utils::JSONRPCDirectLink link(&service, callSign);
+    EXPECT_TRUE(link.IsDirect());
+
+    JsonObject params;
+    params["value"] = 42;
+    JsonObject result;
+    EXPECT_EQ(Core::ERROR_NONE, link.Invoke<JsonObject, JsonObject>(1000, _T("echo"), params, result));
+    EXPECT_EQ(42, result["value"].Number());
+    EXPECT_TRUE(result["success"].Boolean());
+
+    JsonObject empty;
+    EXPECT_EQ(Core::ERROR_NONE, link.Invoke<JsonObject, JsonObject>(1000, _T("name"), empty, result, true));
+    EXPECT_NE(Core::ERROR_NONE, link.Invoke<JsonObject, JsonObject>(1000, _T("missing"), empty, result));
+}
+
+TEST_F(JSONRPCDirectLinkTestFixture, FallsBackToLinkWhenNotInProcess)
+{
+    std::shared_ptr<StandInLink> standIn;
+    StandInPool pool(
+        [&standIn](const string& designator) {
+            standIn = std::make_shared<StandInLink>(designator);
+            return standIn;
+        },
+        [](uint32_t status) { return status == Core::ERROR_CONNECTION_CLOSED; },
+        Core::ERROR_UNAVAILABLE);
+
+    Utils::JSONRPCDirectLinkType<StandInLink> link(&service, _T("org.rdk.NotLoaded"), "", pool);
+    EXPECT_FALSE(link.IsDirect());
+
+    JsonObject params;
+    params["value"] = 42;
+    JsonObject result;
+    EXPECT_EQ(Core::ERROR_NONE, link.Invoke<JsonObject, JsonObject>(1000, _T("echo"), params, result));
+    EXPECT_EQ(42, result["value"].Number());
+    ASSERT_TRUE(standIn != nullptr);
+    EXPECT_EQ(_T("org.rdk.NotLoaded.1"), standIn->designator);
+
+    // The error of the plugin comes back as is, over the same link
+    JsonObject empty;
+    EXPECT_EQ(Core::ERROR_UNKNOWN_KEY, link.Invoke<JsonObject, JsonObject>(1000, _T("missing"), empty, result));
+    EXPECT_EQ(std::vector<string>({ _T("echo"), _T("missing") }), standIn->methods);
+    EXPECT_EQ(1u, pool.GetStatistics().front().connects);
+
+    Utils::JSONRPCDirectLinkType<StandInLink> noService(nullptr, callSign, "", pool);
+    EXPECT_FALSE(noService.IsDirect());
+}
+
+TEST_F(JSONRPCDirectLinkTestFixture, LinksArePooledPerPlugin)
+{
+    Utils::JsonRpcLinkPool& first = Utils::jsonRpcLinkPool(_T("org.rdk.First"), _T("first"));
+    Utils::JsonRpcLinkPool& second = Utils::jsonRpcLinkPool(_T("org.rdk.Second"), _T("second"));
+    EXPECT_NE(&first, &second);
+    EXPECT_EQ(&first, &Utils::jsonRpcLinkPool(_T("org.rdk.First")));
+
+    // No Thunder server needed, the calls only have to be counted
+    JsonObject empty;
+    JsonObject result;
+    first.Invoke(_T("Controller.1"), 10, _T("status"), empty, result);
+    second.Invoke(_T("Controller.1"), 10, _T("status"), empty, result);
+
+    // The Deinitialize of one plugin leaves the links of the others
+    Utils::releaseJsonRpcLinks(_T("org.rdk.First"));
+    EXPECT_TRUE(first.GetStatistics().empty());
+    ASSERT_EQ(1u, second.GetStatistics().size());
+    EXPECT_EQ(1u, second.GetStatistics().front().calls);
+    Utils::releaseJsonRpcLinks(_T("org.rdk.Second"));
+}
+
+TEST_F(JSONRPCDirectLinkTestFixture, CallLatency)
+{
+    Utils::JSONRPCDirectLink direct(&service, callSign);
+    ASSERT_TRUE(direct.IsDirect());
+
+    JsonObject params;
+    params["value"] = 42;
+    JsonObject result;
+    auto start = std::chrono::steady_clock::now();
+    for (int i = 0; i < kCalls; i++) {
+        ASSERT_EQ(Core::ERROR_NONE, direct.Invoke<JsonObject, JsonObject>(1000, _T("echo"), params, result));
+    }
+    auto directTime = std::chrono::duration_cast<std::chrono::microseconds>(std::chrono::steady_clock::now() - start);
+    std::cout << "in process: " << (double)directTime.count() / kCalls << "us per call" << std::endl;
+
+    // The WebSocket path needs a running Thunder; on a device this times
+    // a call of similar weight on its Controller.
+    Utils::JSONRPCDirectLink link(nullptr, _T("Controller"));
+    JsonArray subsystems;
+    if (link.Get(200, _T("subsystems"), subsystems) != Core::ERROR_NONE) {
+        std::cout << "no Thunder server reachable, WebSocket path not measured" << std::endl;
+        return;
+    }
+    start = std::chrono::steady_clock::now();
+    for (int i = 0; i < kCalls; i++) {
+        ASSERT_EQ(Core::ERROR_NONE, link.Get(1000, _T("subsystems"), subsystems));
+    }
+    auto linkTime = std::chrono::duration_cast<std::chrono::microseconds>(std::chrono::steady_clock::now() - start);
+    std::cout << "over WebSocket: " << (double)linkTime.count() / kCalls << "us per call" << std::endl;
+    EXPECT_LT(directTime, linkTime);
+}
@@ -0,0 +1,107 @@
+/*
+ * If not stated otherwise in this file or this component's LICENSE file the
+ * following copyright and licenses apply:
+ *
+ * Copyright 2022 RDK Management
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include <gtest/gtest.h>
+
+#include <sstream>
+
+#include "LaunchMetrics.h"
+
+using namespace WPEFramework;
+
+namespace {
+typedef Plugin::LaunchMetrics Metrics;
+typedef Plugin::LatencyHistogram Histogram;
+}
+
+TEST(LaunchMetricsTest, HistogramBucketsAndPercentiles)
+{
+    EXPECT_EQ(0, Histogram::bucketOf(999));
+    EXPECT_EQ(1, Histogram::bucketOf(1000));
+    EXPECT_EQ(2, Histogram::bucketOf(3999));
+    EXPECT_EQ(3, Histogram::bucketOf(4000));
+    EXPECT_EQ(Histogram::BUCKETS - 1, Histogram::bucketOf(UINT64_MAX));
+
+    Histogram histogram;
+    EXPECT_EQ(0u, histogram.percentileUs(50));
+    for (int i = 0; i < 90; i++)
+        histogram.record(5000);
+    for (int i = 0; i < 10; i++)
+        histogram.record(300000);
+
+    EXPECT_EQ(100u, histogram.count);
+    EXPECT_EQ(5000u, histogram.minUs);
+    EXPECT_EQ(300000u, histogram.maxUs);
+    EXPECT_EQ(8000u, histogram.percentileUs(50));
+    EXPECT_EQ(8000u, histogram.percentileUs(90));
+    EXPECT_EQ(300000u, histogram.percentileUs(99));
+}
+
+TEST(LaunchMetricsTest, DisabledRecordsNothing)
+{
+    Metrics metrics;
+    metrics.record("LightningApp", Metrics::LAUNCH, 0, 1000, "app");
+    EXPECT_TRUE(metrics.snapshot().empty());
+
+    metrics.enable(true);
+    metrics.record("LightningApp", Metrics::LAUNCH, 0, 1000, "app");
+    metrics.record("LightningApp", Metrics::ACTIVATE, 1000, 500, "app");
+    auto snapshot = metrics.snapshot();
+    ASSERT_EQ(1u, snapshot.size());
+    EXPECT_EQ("LightningApp", snapshot[0].type);
+    EXPECT_EQ(1u, snapshot[0].phases[Metrics::LAUNCH].count);
+    EXPECT_EQ(0u, snapshot[0].phases[Metrics::ACTIVATE].maxUs);
+
+    metrics.reset();
+    EXPECT_EQ(0u, metrics.snapshot()[0].phases[Metrics::LAUNCH].count);
+}
+
+TEST(LaunchMetricsTest, TypesBeyondLimitAreCountedAsOther)
+{
+    Metrics metrics;
+    metrics.enable(true);
+    for (int i = 0; i < Metrics::MAX_TYPES + 4; i++)
+        metrics.record("Type" + std::to_string(i), Metrics::DESTROY, 0, 1000, "app");
+    metrics.record("", Metrics::DESTROY, 0, 1000, "app");
+
+    auto snapshot = metrics.snapshot();
+    ASSERT_EQ((size_t)Metrics::MAX_TYPES, snapshot.size());
+    EXPECT_EQ("Type0", snapshot[0].type);
+    EXPECT_EQ("other", snapshot[Metrics::MAX_TYPES - 1].type);
+    EXPECT_EQ(6u, snapshot[Metrics::MAX_TYPES - 1].phases[Metrics::DESTROY].count);
+}
+
+TEST(LaunchMetricsTest, ChromeTraceKeepsLastEvents)
+{
+    Metrics metrics;
+    metrics.enable(true);
+    metrics.enableTrace(2);
+    metrics.record("HtmlApp", Metrics::CLONE, 100, 200, "first");
+    metrics.record("HtmlApp", Metrics::ACTIVATE, 200, 1200, "second");
+    metrics.record("HtmlApp", Metrics::URL, 1200, 1250, "th\"ird");
+
+    std::ostringstream out;
+    metrics.writeChromeTrace(out);
+    const std::string trace = out.str();
+    EXPECT_EQ(0u, trace.find("{\"displayTimeUnit\":\"ms\",\"traceEvents\":[{\"name\":\"activate\""));
+    EXPECT_EQ(std::string::npos, trace.find("first"));
+    EXPECT_NE(std::string::npos, trace.find("\"ts\":200,\"dur\":1000"));
+    EXPECT_NE(std::string::npos, trace.find("\"callsign\":\"th\\\"ird\""));
+    EXPECT_EQ("]}", trace.substr(trace.size() - 2));
+}
@@ -0,0 +1,240 @@
+/*
+ * If not stated otherwise in this file or this component's LICENSE file the
+ * following copyright and licenses apply:
+ *
+ * Copyright 2022 RDK Management
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include <gtest/gtest.h>
+
+#include <atomic>
+#include <chrono>
+#include <iostream>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "UtilsLinkPool.h"
+
+namespace {
+const uint32_t kNone = 0;
+const uint32_t kUnavailable = 2;
+const uint32_t kConnectionClosed = 36;
+const uint32_t kBadRequest = 30;
+
+const std::chrono::microseconds kHandshake(2000);
+const std::chrono::microseconds kRoundTrip(100);
+
+// Stands in for the Thunder server: a connection costs a handshake, a call
+// a round trip, and the server can be taken down and brought back.
+struct StandInServer {
+    StandInServer()
+        : up(true)
+        , connections(0)
+        , calls(0)
+    {
+    }
+
+    std::atomic<bool> up;
+    std::atomic<int> connections;
+    std::atomic<int> calls;
+};
+
+// The part of JSONRPC::LinkType the pool uses.
+class FakeLink {
+public:
+    explicit FakeLink(StandInServer& server)
+        : mServer(server)
+        , mOpen(server.up.load())
+    {
+        mServer.connections++;
+        std::this_thread::sleep_for(kHandshake);
+    }
+
+    template <typename PARAMETERS, typename RESPONSE>
+    uint32_t Invoke(const uint32_t, const std::string& method, const PARAMETERS& parameters, RESPONSE& response)
+    {
+        if (!mOpen || !mServer.up) {
+            mOpen = false;
+            return kConnectionClosed;
+        }
+        mServer.calls++;
+        std::this_thread::sleep_for(kRoundTrip);
+        if (method != "echo") {
+            return kBadRequest;
+        }
+        response = parameters;
+        return kNone;
+    }
+
+private:
+    StandInServer& mServer;
+    std::atomic<bool> mOpen;
+};
+
+typedef Utils::LinkPool<FakeLink> Pool;
+
+Pool::Statistics statisticsOf(Pool& pool, const std::string& designator)
+{
+    for (const auto& statistics : pool.GetStatistics()) {
+        if (statistics.designator == designator) {
+            return statistics;
+        }
+    }
+    return Pool::Statistics();
+}
+}
+
+class LinkPoolTestFixture : public ::testing::Test {
+protected:
+    StandInServer server;
+    Pool pool;
+
+    LinkPoolTestFixture()
+        : pool([this](const std::string&) { return std::make_shared<FakeLink>(server); },
+              [](uint32_t status) { return status == kConnectionClosed; },
+              kUnavailable, 20, 80)
+    {
+    }
+};
+
+TEST_F(LinkPoolTestFixture, ReusesTheLink)
+{
+    std::string response;
+    for (int i = 0; i < 10; i++) {
+        EXPECT_EQ(kNone, pool.Invoke("org.rdk.Echo.1", 1000, "echo", std::string("hi"), response));
+        EXPECT_EQ("hi", response);
+    }
+    // a failing call on a healthy link keeps it
+    EXPECT_EQ(kBadRequest, pool.Invoke("org.rdk.Echo.1", 1000, "missing", std::string("hi"), response));
+    EXPECT_EQ(kNone, pool.Invoke("org.rdk.Other.1", 1000, "echo", std::string("hi"), response));
+
+    EXPECT_EQ(2, server.connections);
+    Pool::Statistics echo = statisticsOf(pool, "org.rdk.Echo.1");
+    EXPECT_EQ(11u, echo.calls);
+    EXPECT_EQ(0u, echo.failures);
+    EXPECT_EQ(1u, echo.connects);
+    EXPECT_GE(echo.totalUs, 11u * kRoundTrip.count());
+    EXPECT_GE(echo.maxUs, (uint64_t)kRoundTrip.count());
+    EXPECT_EQ(1u, statisticsOf(pool, "org.rdk.Other.1").calls);
+}
+
+TEST_F(LinkPoolTestFixture, ConcurrentCallsShareTheLink)
+{
+    std::atomic<int> succeeded(0);
+    std::vector<std::thread> threads;
+    for (int i = 0; i < 8; i++) {
+        threads.emplace_back([&]() {
+            for (int j = 0; j < 25; j++) {
+                std::string response;
+                if (pool.Invoke("org.rdk.Echo.1", 1000, "echo", std::string("hi"), response) == kNone) {
+                    succeeded++;
+                }
+            }
+        });
+    }
+    for (auto& thread : threads)
+        thread.join();
+
+    EXPECT_EQ(200, succeeded);
+    EXPECT_EQ(1, server.connections);
+    EXPECT_EQ(200u, statisticsOf(pool, "org.rdk.Echo.1").calls);
+}
+
+TEST_F(LinkPoolTestFixture, ReconnectsWithBackoff)
+{
+    std::string response;
+    ASSERT_EQ(kNone, pool.Invoke("org.rdk.Echo.1", 1000, "echo", std::string("hi"), response));
+
+    server.up = false;
+    EXPECT_EQ(kConnectionClosed, pool.Invoke("org.rdk.Echo.1", 1000, "echo", std::string("hi"), response));
+    // backing off: no connection attempt at all
+    EXPECT_EQ(kUnavailable, pool.Invoke("org.rdk.Echo.1", 1000, "echo", std::string("hi"), response));
+    EXPECT_EQ(1, server.connections);
+
+    // every failed reconnect doubles the wait, up to the maximum
+    std::vector<int> waitsMs;
+    for (int i = 0; i < 4; i++) {
+        auto start = std::chrono::steady_clock::now();
+        while (pool.Invoke("org.rdk.Echo.1", 1000, "echo", std::string("hi"), response) == kUnavailable) {
+            std::this_thread::sleep_for(std::chrono::milliseconds(1));
+        }
+        waitsMs.push_back(std::chrono::duration_cast<std::chrono::milliseconds>(std::chrono::steady_clock::now() - start).count());
+    }
+    EXPECT_EQ(5, server.connections);
+    EXPECT_GE(waitsMs[0], 15);
+    EXPECT_GE(waitsMs[1], 35);
+    EXPECT_GE(waitsMs[2], 75);
+    EXPECT_GE(waitsMs[3], 75);
+    EXPECT_LT(waitsMs[3], 2 * 80 + 40);
+
+    server.up = true;
+    auto start = std::chrono::steady_clock::now();
+    uint32_t status;
+    while ((status = pool.Invoke("org.rdk.Echo.1", 1000, "echo", std::string("back"), response)) == kUnavailable) {
+        std::this_thread::sleep_for(std::chrono::milliseconds(1));
+    }
+    EXPECT_EQ(kNone, status);
+    EXPECT_EQ("back", response);
+    EXPECT_LT(std::chrono::steady_clock::now() - start, std::chrono::milliseconds(200));
+
+    // success resets the backoff: the next outage starts from the minimum again
+    server.up = false;
+    EXPECT_EQ(kConnectionClosed, pool.Invoke("org.rdk.Echo.1", 1000, "echo", std::string("hi"), response));
+    server.up = true;
+    start = std::chrono::steady_clock::now();
+    while (pool.Invoke("org.rdk.Echo.1", 1000, "echo", std::string("hi"), response) == kUnavailable) {
+        std::this_thread::sleep_for(std::chrono::milliseconds(1));
+    }
+    EXPECT_LT(std::chrono::steady_clock::now() - start, std::chrono::milliseconds(60));
+
+    Pool::Statistics statistics = statisticsOf(pool, "org.rdk.Echo.1");
+    EXPECT_EQ(7u, statistics.connects);
+    EXPECT_GE(statistics.failures, 6u);
+}
+
+TEST_F(LinkPoolTestFixture, ClearDropsTheLinks)
+{
+    std::string response;
+    ASSERT_EQ(kNone, pool.Invoke("org.rdk.Echo.1", 1000, "echo", std::string("hi"), response));
+    pool.Clear();
+    EXPECT_TRUE(pool.GetStatistics().empty());
+    ASSERT_EQ(kNone, pool.Invoke("org.rdk.Echo.1", 1000, "echo", std::string("hi"), response));
+    EXPECT_EQ(2, server.connections);
+}
+
+TEST_F(LinkPoolTestFixture, CallLatency)
+{
+    const int kCalls = 200;
+    std::string response;
+
+    auto start = std::chrono::steady_clock::now();
+    for (int i = 0; i < kCalls; i++) {
+        // what the plugins did before: a new link for every call
+        FakeLink link(server);
+        ASSERT_EQ(kNone, (link.Invoke<std::string, std::string>(1000, "echo", std::string("hi"), response)));
+    }
+    auto perCall = std::chrono::duration_cast<std::chrono::microseconds>(std::chrono::steady_clock::now() - start);
+
+    start = std::chrono::steady_clock::now();
+    for (int i = 0; i < kCalls; i++) {
+        ASSERT_EQ(kNone, pool.Invoke("org.rdk.Echo.1", 1000, "echo", std::string("hi"), response));
+    }
+    auto pooled = std::chrono::duration_cast<std::chrono::microseconds>(std::chrono::steady_clock::now() - start);
+
+    std::cout << "link per call: " << (double)perCall.count() / kCalls << "us per call" << std::endl
+              << "pooled link:   " << (double)pooled.count() / kCalls << "us per call" << std::endl;
+    EXPECT_LT(pooled, perCall);
+}
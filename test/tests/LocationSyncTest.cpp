@@ -42,6 +42,7 @@ protected:
     Core::JSONRPC::Connection connection;
     ServiceMock service;
     string response;
+    string persistentPath;
 
     LocationSyncTestFixture()
         : workerPool(Core::ProxyType<WorkerPoolImplementation>::Create(
@@ -60,6 +61,12 @@ protected:
         Core::IWorkerPool::Assign(&(*workerPool));
 
         workerPool->Run();
+
+        char path[] = "/tmp/locationSyncTestXXXXXX";
+        ASSERT_TRUE(mkdtemp(path) != nullptr);
+        persistentPath = string(path) + _T("/");
+        ON_CALL(service, PersistentPath())
+            .WillByDefault(::testing::Return(persistentPath));
     }
 
     virtual void TearDown()
@@ -68,6 +75,24 @@ protected:
 
         Core::IWorkerPool::Assign(nullptr);
         workerPool.Release();
+
+        Core::Directory(persistentPath.c_str()).Destroy(true);
+    }
+
+    static uint64_t now()
+    {
+        return Core::Time::Now().Ticks() / (Core::Time::TicksPerMillisecond * 1000);
+    }
+
+    // What a previous run stored, at the time in seconds
+    void store(const string& city, uint64_t timestamp)
+    {
+        Core::File file(persistentPath + _T("location.json"));
+        ASSERT_TRUE(file.Create());
+        const string stored = _T("{\"ip\":\"85.146.148.211\",\"timezone\":\"CET-1CEST,M3.5.0,M10.5.0/3\",\"region\":\"GE\",\"country\":\"NL\",\"city\":\"") + city + _T("\","
+                                 "\"source\":\"http://jsonip.metrological.com/?maf=true\",\"timestamp\":") + Core::NumberType<uint64_t>(timestamp).Text() + _T("}");
+        file.Write(reinterpret_cast<const uint8_t*>(stored.c_str()), stored.size());
+        file.Close();
     }
 };
 
@@ -128,3 +153,91 @@ TEST_F(LocationSyncTestFixture, probeTest)
 
     plugin->Deinitialize(&service);
 }
+
+TEST_F(LocationSyncTestFixture, provisionalLocationTest)
+{
+    // What a previous run stored an hour ago
+    store(_T("Elst"), now() - 3600);
+
+    EXPECT_CALL(service, ConfigLine())
+        .Times(1)
+        .WillOnce(::testing::Return("{\n"
+                                    "  \"interval\":10,\n"
+                                    "  \"retries\":20,\n"
+                                    "  \"source\":\"http://jsonip.metrological.com/?maf=true\"\n"
+                                    " }"));
+
+    EXPECT_CALL(service, WebPrefix())
+        .Times(1)
+        .WillOnce(::testing::Return(webPrefix));
+
+    EXPECT_CALL(service, SubSystems())
+        .Times(::testing::AtLeast(2))
+        .WillRepeatedly(::testing::Invoke(
+            [&]() {
+                PluginHost::ISubSystem* result = (&subSystem);
+                result->AddRef();
+                return result;
+            }));
+
+    ON_CALL(service, Version())
+        .WillByDefault(::testing::Return(string()));
+
+    EXPECT_EQ(string(""), plugin->Initialize(&service));
+
+    // Published before the probe had a chance to complete
+    EXPECT_TRUE(subSystem.Get(PluginHost::ISubSystem::LOCATION) != nullptr);
+    EXPECT_TRUE(subSystem.Get(PluginHost::ISubSystem::INTERNET) != nullptr);
+
+    EXPECT_EQ(Core::ERROR_NONE, handler.Invoke(connection, _T("location"), _T(""), response));
+
+    JsonObject params;
+
+    EXPECT_TRUE(params.FromString(response));
+    EXPECT_EQ(string("CET-1CEST,M3.5.0,M10.5.0/3"), params["timezone"].String());
+    EXPECT_EQ(string("Elst"), params["city"].String());
+    EXPECT_EQ(string("85.146.148.211"), params["publicip"].String());
+
+    plugin->Deinitialize(&service);
+}
+
+TEST_F(LocationSyncTestFixture, staleLocationTest)
+{
+    // Older than the maximum age of a day
+    store(_T("Nowhere"), now() - 2 * 86400);
+
+    EXPECT_CALL(service, ConfigLine())
+        .Times(1)
+        .WillOnce(::testing::Return("{\n"
+                                    "  \"interval\":10,\n"
+                                    "  \"retries\":20,\n"
+                                    "  \"source\":\"http://jsonip.metrological.com/?maf=true\",\n"
+                                    "  \"maxage\":86400\n"
+                                    " }"));
+
+    EXPECT_CALL(service, WebPrefix())
+        .Times(1)
+        .WillOnce(::testing::Return(webPrefix));
+
+    ON_CALL(service, SubSystems())
+        .WillByDefault(::testing::Invoke(
+            [&]() {
+                PluginHost::ISubSystem* result = (&subSystem);
+                result->AddRef();
+                return result;
+            }));
+
+    ON_CALL(service, Version())
+        .WillByDefault(::testing::Return(string()));
+
+    EXPECT_EQ(string(""), plugin->Initialize(&service));
+
+    // Only what the probe finds, if it found anything yet
+    handler.Invoke(connection, _T("location"), _T(""), response);
+
+    JsonObject params;
+    params.FromString(response);
+    EXPECT_NE(string("Nowhere"), params["city"].String());
+
+    plugin->Deinitialize(&service);
+}
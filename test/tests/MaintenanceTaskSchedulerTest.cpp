@@ -0,0 +1,267 @@
+/*
+ * If not stated otherwise in this file or this component's LICENSE file the
+ * following copyright and licenses apply:
+ *
+ * Copyright 2022 RDK Management
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include <gtest/gtest.h>
+
+#include <stdlib.h>
+#include <unistd.h>
+
+#include <algorithm>
+#include <chrono>
+#include <fstream>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+#include "MaintenanceTaskScheduler.h"
+
+using namespace WPEFramework;
+
+typedef Plugin::MaintenanceTaskScheduler Scheduler;
+
+namespace {
+// The tasks run their scripts with /bin/sh
+class MaintenanceTaskSchedulerTest : public ::testing::Test {
+protected:
+    Scheduler scheduler;
+    std::string directory;
+
+    std::mutex lock;
+    std::vector<std::pair<std::string, Scheduler::TaskState>> changes;
+    int running;
+    int maxRunning;
+
+    MaintenanceTaskSchedulerTest()
+        : running(0)
+        , maxRunning(0)
+    {
+    }
+
+    virtual void SetUp()
+    {
+        char name[] = "/tmp/maintenancetestXXXXXX";
+        ASSERT_TRUE(mkdtemp(name) != nullptr);
+        directory = name;
+
+        scheduler.setStateCallback([&](const std::string& task, Scheduler::TaskState state) {
+            std::lock_guard<std::mutex> guard(lock);
+            changes.push_back(std::make_pair(task, state));
+            if (Scheduler::TASK_RUNNING == state) {
+                running++;
+                maxRunning = std::max(maxRunning, running);
+            } else {
+                running--;
+            }
+        });
+    }
+
+    virtual void TearDown()
+    {
+        std::string command = "rm -rf " + directory;
+        EXPECT_EQ(0, system(command.c_str()));
+    }
+
+    Scheduler::Task task(const std::string& name, const std::string& commands, const std::vector<std::string>& dependencies = {})
+    {
+        Scheduler::Task task;
+        task.name = name;
+        task.dependencies = dependencies;
+        if (!commands.empty()) {
+            task.script = directory + "/" + name + ".sh";
+            std::ofstream(task.script) << commands << "\n";
+        }
+        return task;
+    }
+
+    Scheduler::TaskState state(const std::string& name)
+    {
+        std::vector<Scheduler::TaskReport> reports;
+        scheduler.getReports(reports);
+        for (const auto& report : reports) {
+            if (report.name == name) {
+                return report.state;
+            }
+        }
+        return Scheduler::TASK_PENDING;
+    }
+
+    // Where the change is in the order of the callbacks, -1 if it did not come
+    int position(const std::string& name, Scheduler::TaskState state)
+    {
+        std::lock_guard<std::mutex> guard(lock);
+        for (size_t i = 0; i < changes.size(); i++) {
+            if ((changes[i].first == name) && (changes[i].second == state)) {
+                return static_cast<int>(i);
+            }
+        }
+        return -1;
+    }
+
+    long long run()
+    {
+        auto start = std::chrono::steady_clock::now();
+        scheduler.run();
+        return std::chrono::duration_cast<std::chrono::milliseconds>(std::chrono::steady_clock::now() - start).count();
+    }
+};
+}
+
+TEST_F(MaintenanceTaskSchedulerTest, DependenciesOrderTheTasks)
+{
+    scheduler.setMaxConcurrency(3);
+    ASSERT_TRUE(scheduler.setTasks({
+        task("third", "/bin/true", { "second" }),
+        task("second", "exit 1", { "first" }),
+        task("first", "/bin/sleep 0.2"),
+    }));
+    run();
+
+    EXPECT_EQ(Scheduler::TASK_SUCCESS, state("first"));
+    EXPECT_EQ(Scheduler::TASK_ERROR, state("second"));
+    // A failed dependency still lets the next one run
+    EXPECT_EQ(Scheduler::TASK_SUCCESS, state("third"));
+
+    EXPECT_LT(position("first", Scheduler::TASK_SUCCESS), position("second", Scheduler::TASK_RUNNING));
+    EXPECT_LT(position("second", Scheduler::TASK_ERROR), position("third", Scheduler::TASK_RUNNING));
+    EXPECT_EQ(1, maxRunning);
+    EXPECT_FALSE(scheduler.isRunning());
+}
+
+TEST_F(MaintenanceTaskSchedulerTest, UnknownDependencyAndCycle)
+{
+    EXPECT_FALSE(scheduler.setTasks({ task("first", "/bin/true", { "missing" }) }));
+    EXPECT_FALSE(scheduler.setTasks({
+        task("first", "/bin/true", { "second" }),
+        task("second", "/bin/true", { "first" }),
+    }));
+    EXPECT_FALSE(scheduler.setTasks({ task("first", "/bin/true"), task("first", "/bin/true") }));
+}
+
+TEST_F(MaintenanceTaskSchedulerTest, ConcurrencyCap)
+{
+    scheduler.setMaxConcurrency(2);
+    ASSERT_TRUE(scheduler.setTasks({
+        task("a", "/bin/sleep 0.3"),
+        task("b", "/bin/sleep 0.3"),
+        task("c", "/bin/sleep 0.3"),
+        task("d", "/bin/sleep 0.3"),
+    }));
+    long long elapsedMs = run();
+
+    EXPECT_EQ(2, maxRunning);
+    EXPECT_GE(elapsedMs, 600);
+    for (const char* name : { "a", "b", "c", "d" }) {
+        EXPECT_EQ(Scheduler::TASK_SUCCESS, state(name));
+    }
+}
+
+TEST_F(MaintenanceTaskSchedulerTest, Timeout)
+{
+    Scheduler::Task slow = task("slow", "/bin/sleep 10");
+    slow.timeoutMs = 200;
+    ASSERT_TRUE(scheduler.setTasks({ slow, task("next", "/bin/true", { "slow" }) }));
+    long long elapsedMs = run();
+
+    EXPECT_EQ(Scheduler::TASK_TIMEDOUT, state("slow"));
+    EXPECT_EQ(Scheduler::TASK_SUCCESS, state("next"));
+    EXPECT_GE(elapsedMs, 200);
+    EXPECT_LT(elapsedMs, 5000);
+}
+
+TEST_F(MaintenanceTaskSchedulerTest, AbortSkipsThePendingTasks)
+{
+    ASSERT_TRUE(scheduler.setTasks({
+        task("slow", "/bin/sleep 10"),
+        task("next", "/bin/true", { "slow" }),
+    }));
+
+    auto start = std::chrono::steady_clock::now();
+    std::thread thread([&]() { scheduler.run(); });
+    while ((scheduler.getPid("slow") <= 0) && (std::chrono::steady_clock::now() - start < std::chrono::seconds(5))) {
+        std::this_thread::sleep_for(std::chrono::milliseconds(10));
+    }
+    EXPECT_GT(scheduler.getPid("slow"), 0);
+    scheduler.abort(true);
+    thread.join();
+
+    EXPECT_LT(std::chrono::steady_clock::now() - start, std::chrono::seconds(5));
+    EXPECT_EQ(Scheduler::TASK_ERROR, state("slow"));
+    EXPECT_EQ(Scheduler::TASK_SKIPPED, state("next"));
+    EXPECT_EQ(-1, position("next", Scheduler::TASK_RUNNING));
+}
+
+TEST_F(MaintenanceTaskSchedulerTest, CompleteBeforeStart)
+{
+    // Reported by the owner, e.g. from an event, before the scheduler got to it
+    Scheduler::Task reported = task("reported", "");
+    reported.completesOnExit = false;
+    reported.timeoutMs = 5000;
+    ASSERT_TRUE(scheduler.setTasks({ reported }));
+    EXPECT_TRUE(scheduler.complete("reported", true));
+    EXPECT_FALSE(scheduler.complete("unknown", true));
+    long long elapsedMs = run();
+
+    EXPECT_EQ(Scheduler::TASK_SUCCESS, state("reported"));
+    EXPECT_LT(elapsedMs, 5000);
+    // Settled already
+    EXPECT_FALSE(scheduler.complete("reported", false));
+}
+
+TEST_F(MaintenanceTaskSchedulerTest, CompletedThroughTheOwner)
+{
+    // The script hands the work over and exits, the outcome comes later
+    Scheduler::Task handedOver = task("handedOver", "/bin/true");
+    handedOver.completesOnExit = false;
+    ASSERT_TRUE(scheduler.setTasks({ handedOver }));
+
+    std::thread thread([&]() { scheduler.run(); });
+    std::this_thread::sleep_for(std::chrono::milliseconds(300));
+    EXPECT_EQ(Scheduler::TASK_RUNNING, state("handedOver"));
+    EXPECT_TRUE(scheduler.complete("handedOver", false));
+    thread.join();
+
+    EXPECT_EQ(Scheduler::TASK_ERROR, state("handedOver"));
+}
+
+TEST_F(MaintenanceTaskSchedulerTest, AbortSettlesEveryRunningTask)
+{
+    // A stop while tasks run side by side, one of them waiting for its event
+    scheduler.setMaxConcurrency(3);
+    Scheduler::Task handedOver = task("handedOver", "/bin/true");
+    handedOver.completesOnExit = false;
+    handedOver.timeoutMs = 60000;
+    ASSERT_TRUE(scheduler.setTasks({ task("first", "/bin/sleep 10"), task("second", "/bin/sleep 10"), handedOver }));
+
+    auto start = std::chrono::steady_clock::now();
+    std::thread thread([&]() { scheduler.run(); });
+    while (((scheduler.getPid("first") <= 0) || (scheduler.getPid("second") <= 0))
+        && (std::chrono::steady_clock::now() - start < std::chrono::seconds(5))) {
+        std::this_thread::sleep_for(std::chrono::milliseconds(10));
+    }
+    EXPECT_GT(scheduler.getPid("first"), 0);
+    EXPECT_GT(scheduler.getPid("second"), 0);
+    scheduler.abort(true);
+    thread.join();
+
+    EXPECT_LT(std::chrono::steady_clock::now() - start, std::chrono::seconds(5));
+    for (const char* name : { "first", "second", "handedOver" }) {
+        EXPECT_EQ(Scheduler::TASK_ERROR, state(name));
+    }
+    EXPECT_EQ(3, maxRunning);
+}
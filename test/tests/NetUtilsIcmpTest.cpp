@@ -0,0 +1,120 @@
+/*
+ * If not stated otherwise in this file or this component's LICENSE file the
+ * following copyright and licenses apply:
+ *
+ * Copyright 2022 RDK Management
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include <gtest/gtest.h>
+
+#include <chrono>
+
+#include "NetUtilsIcmp.h"
+
+using namespace WPEFramework;
+
+namespace {
+// Neither a datagram ICMP socket (ping_group_range) nor a raw one (CAP_NET_RAW) may be allowed
+#define OPEN_OR_SKIP(icmp, endpoint)                                      \
+    if (!icmp.open(endpoint)) {                                          \
+        if (icmp.error() == "Could not open ICMP socket") {              \
+            GTEST_SKIP() << "No ICMP socket for " << endpoint;           \
+        }                                                                \
+        FAIL() << icmp.error();                                          \
+    }
+}
+
+TEST(NetUtilsIcmpTest, PingLoopback)
+{
+    for (const char* endpoint : { "127.0.0.1", "::1" }) {
+        Plugin::Icmp icmp;
+        OPEN_OR_SKIP(icmp, endpoint);
+        EXPECT_EQ(std::string(endpoint) == "::1", icmp.isIPv6());
+
+        Plugin::IcmpPingStatistics statistics;
+        ASSERT_TRUE(icmp.ping(5, 10, 1000, statistics));
+        EXPECT_EQ(5, statistics.transmitted);
+        EXPECT_EQ(5, statistics.received);
+        EXPECT_LE(0, statistics.tripMin);
+        EXPECT_LE(statistics.tripMin, statistics.tripAvg);
+        EXPECT_LE(statistics.tripAvg, statistics.tripMax);
+        EXPECT_LE(0, statistics.tripStdDev);
+    }
+}
+
+TEST(NetUtilsIcmpTest, ProbesAreNotSentOneAfterTheOther)
+{
+    Plugin::Icmp icmp;
+    OPEN_OR_SKIP(icmp, "127.0.0.1");
+
+    // Ten probes 10ms apart, not ten round trips of up to a second each
+    Plugin::IcmpPingStatistics statistics;
+    auto start = std::chrono::steady_clock::now();
+    ASSERT_TRUE(icmp.ping(10, 10, 1000, statistics));
+    auto elapsed = std::chrono::duration_cast<std::chrono::milliseconds>(std::chrono::steady_clock::now() - start);
+    EXPECT_EQ(10, statistics.received);
+    EXPECT_LT(elapsed.count(), 500);
+}
+
+TEST(NetUtilsIcmpTest, TracerouteLoopback)
+{
+    Plugin::Icmp icmp;
+    OPEN_OR_SKIP(icmp, "127.0.0.1");
+
+    std::vector<Plugin::IcmpHop> hops;
+    ASSERT_TRUE(icmp.traceroute(6, 3, 1000, 52, hops));
+    ASSERT_EQ(1u, hops.size());
+    EXPECT_EQ(1, hops[0].ttl);
+    ASSERT_EQ(3u, hops[0].addresses.size());
+    ASSERT_EQ(3u, hops[0].trips.size());
+    for (size_t i = 0; i < hops[0].addresses.size(); i++) {
+        EXPECT_EQ("127.0.0.1", hops[0].addresses[i]);
+        EXPECT_LE(0, hops[0].trips[i]);
+    }
+}
+
+TEST(NetUtilsIcmpTest, TracerouteLoopbackUdp)
+{
+    for (const char* endpoint : { "127.0.0.1", "::1" }) {
+        // Unprivileged, as the traceroute command by default
+        Plugin::Icmp icmp;
+        ASSERT_TRUE(icmp.open(endpoint, "", Plugin::ICMP_PROBE_UDP));
+        EXPECT_TRUE(icmp.isUdp());
+
+        std::vector<Plugin::IcmpHop> hops;
+        ASSERT_TRUE(icmp.traceroute(6, 3, 1000, 52, hops));
+        ASSERT_EQ(1u, hops.size());
+        ASSERT_EQ(3u, hops[0].addresses.size());
+        for (size_t i = 0; i < hops[0].addresses.size(); i++) {
+            EXPECT_EQ(endpoint, hops[0].addresses[i]);
+            EXPECT_LE(0, hops[0].trips[i]);
+        }
+
+        // Nothing answers UDP probes but errors
+        Plugin::IcmpPingStatistics statistics;
+        EXPECT_FALSE(icmp.ping(1, 0, 100, statistics));
+    }
+}
+
+TEST(NetUtilsIcmpTest, BadAddress)
+{
+    Plugin::Icmp icmp;
+    EXPECT_FALSE(icmp.open("no-such-host.invalid"));
+    EXPECT_EQ("Bad Address", icmp.error());
+
+    Plugin::IcmpPingStatistics statistics;
+    EXPECT_FALSE(icmp.ping(1, 0, 100, statistics));
+    EXPECT_EQ(0, statistics.transmitted);
+}
@@ -0,0 +1,226 @@
+/*
+ * If not stated otherwise in this file or this component's LICENSE file the
+ * following copyright and licenses apply:
+ *
+ * Copyright 2022 RDK Management
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include <gtest/gtest.h>
+
+#include <fcntl.h>
+#include <net/if.h>
+#include <sched.h>
+#include <stdlib.h>
+#include <unistd.h>
+
+#include <atomic>
+#include <chrono>
+#include <functional>
+#include <thread>
+
+#include "NetUtilsNetlink.h"
+
+using namespace WPEFramework;
+
+namespace {
+const char* veth = "rdktest0";
+const char* vethPeer = "rdktest1";
+
+bool run(const std::string& command)
+{
+    return system((command + " >/dev/null 2>&1").c_str()) == 0;
+}
+
+// Waits for the monitor to publish a snapshot for which the condition holds
+bool waitFor(const Plugin::NetlinkMonitor& monitor, std::function<bool(const Plugin::NetlinkSnapshot&)> condition)
+{
+    for (int i = 0; i < 200; i++) {
+        Plugin::NetlinkSnapshotPtr snapshot = monitor.snapshot();
+        if (snapshot && condition(*snapshot)) {
+            return true;
+        }
+        std::this_thread::sleep_for(std::chrono::milliseconds(10));
+    }
+    return false;
+}
+}
+
+// Only reads the state of the host
+class NetlinkMonitorTest : public ::testing::Test {
+protected:
+    Plugin::NetlinkMonitor monitor;
+    std::atomic<int> changes{0};
+    // Whether every publication followed the one before it
+    std::atomic<bool> consecutive{true};
+
+    virtual void SetUp()
+    {
+        ASSERT_TRUE(monitor.start([this](const Plugin::NetlinkSnapshotPtr& previous, const Plugin::NetlinkSnapshotPtr& current) {
+            if (previous && current && (previous->generation + 1 != current->generation)) {
+                consecutive = false;
+            }
+            changes++;
+        }));
+        ASSERT_TRUE(waitFor(monitor, [](const Plugin::NetlinkSnapshot& snapshot) {
+            return snapshot.link("lo") != nullptr;
+        }));
+    }
+
+    virtual void TearDown()
+    {
+        monitor.stop();
+    }
+};
+
+// Changes the links, addresses and routes, in a network namespace of the test
+// thread so the host is not touched. Skipped without CAP_SYS_ADMIN/CAP_NET_ADMIN.
+class NetlinkMonitorNamespaceTest : public NetlinkMonitorTest {
+protected:
+    int hostNamespace = -1;
+
+    virtual void SetUp()
+    {
+        hostNamespace = open("/proc/thread-self/ns/net", O_RDONLY | O_CLOEXEC);
+        ASSERT_GE(hostNamespace, 0);
+        if (unshare(CLONE_NEWNET) != 0) {
+            GTEST_SKIP() << "Can't create a network namespace";
+        }
+        // The monitor thread and the ip commands start from this thread, in the new namespace
+        ASSERT_TRUE(run("ip link set lo up"));
+        NetlinkMonitorTest::SetUp();
+    }
+
+    virtual void TearDown()
+    {
+        NetlinkMonitorTest::TearDown();
+        if (hostNamespace >= 0) {
+            EXPECT_EQ(0, setns(hostNamespace, CLONE_NEWNET));
+            close(hostNamespace);
+        }
+    }
+
+    // A veth pair, up, with addresses and a default route
+    bool addVeth()
+    {
+        return run(std::string("ip link add ") + veth + " type veth peer name " + vethPeer
+            + " && ip addr add 10.254.1.1/24 dev " + veth
+            + " && ip -6 addr add fd00:254::1/64 dev " + veth + " nodad"
+            + " && ip link set " + vethPeer + " up"
+            + " && ip link set " + veth + " up"
+            + " && ip route add default via 10.254.1.2 dev " + veth + " metric 4242");
+    }
+};
+
+TEST_F(NetlinkMonitorTest, InitialDump)
+{
+    Plugin::NetlinkSnapshotPtr snapshot = monitor.snapshot();
+    const Plugin::NetlinkLink* lo = snapshot->link("lo");
+    ASSERT_NE(nullptr, lo);
+    EXPECT_NE(0u, lo->flags & IFF_LOOPBACK);
+    EXPECT_EQ(1, changes);
+
+    // Host scope addresses are not the address of an interface
+    std::string address;
+    EXPECT_FALSE(snapshot->address("lo", false, address));
+    EXPECT_FALSE(snapshot->address("nosuchif0", false, address));
+}
+
+TEST_F(NetlinkMonitorNamespaceTest, FollowsChanges)
+{
+    if (!addVeth()) {
+        GTEST_SKIP() << "Can't create a veth pair";
+    }
+
+    ASSERT_TRUE(waitFor(monitor, [](const Plugin::NetlinkSnapshot& snapshot) {
+        const Plugin::NetlinkLink* link = snapshot.link(veth);
+        std::string address;
+        return link && (link->flags & IFF_UP) && snapshot.address(veth, false, address) && snapshot.address(veth, true, address)
+            && !snapshot.defaultRoutes.empty();
+    }));
+
+    Plugin::NetlinkSnapshotPtr snapshot = monitor.snapshot();
+    const Plugin::NetlinkLink* link = snapshot->link(veth);
+    EXPECT_EQ(17u, link->macAddress.size());
+
+    std::string address;
+    EXPECT_TRUE(snapshot->address(veth, false, address));
+    EXPECT_EQ("10.254.1.1", address);
+    EXPECT_TRUE(snapshot->address(veth, true, address));
+    EXPECT_EQ("fd00:254::1", address);
+
+    bool found = false;
+    for (const auto& route : snapshot->defaultRoutes) {
+        if (route.index == link->index) {
+            EXPECT_EQ(AF_INET, route.family);
+            EXPECT_EQ("10.254.1.2", route.gateway);
+            EXPECT_EQ(4242u, route.metric);
+            found = true;
+        }
+    }
+    EXPECT_TRUE(found);
+
+    // The only default route of the namespace
+    std::string interface, gateway;
+    EXPECT_TRUE(snapshot->defaultRoute(false, interface, gateway));
+    EXPECT_EQ(veth, interface);
+    EXPECT_EQ("10.254.1.2", gateway);
+
+    unsigned index = link->index;
+    ASSERT_TRUE(run(std::string("ip link del ") + veth));
+    ASSERT_TRUE(waitFor(monitor, [index](const Plugin::NetlinkSnapshot& snapshot) {
+        return (snapshot.link(veth) == nullptr) && (snapshot.link(vethPeer) == nullptr);
+    }));
+    snapshot = monitor.snapshot();
+    for (const auto& route : snapshot->defaultRoutes) {
+        EXPECT_NE(index, route.index);
+    }
+    for (const auto& entry : snapshot->addresses) {
+        EXPECT_NE(index, entry.index);
+    }
+}
+
+TEST_F(NetlinkMonitorNamespaceTest, PublishedSnapshotsDoNotChange)
+{
+    if (!addVeth()) {
+        GTEST_SKIP() << "Can't create a veth pair";
+    }
+    ASSERT_TRUE(waitFor(monitor, [](const Plugin::NetlinkSnapshot& snapshot) {
+        return !snapshot.defaultRoutes.empty() && snapshot.link(veth);
+    }));
+
+    // A snapshot being read is not modified by later changes
+    Plugin::NetlinkSnapshotPtr before = monitor.snapshot();
+    unsigned long generation = before->generation;
+    ASSERT_TRUE(run(std::string("ip link del ") + veth));
+    ASSERT_TRUE(waitFor(monitor, [](const Plugin::NetlinkSnapshot& snapshot) {
+        return snapshot.link(veth) == nullptr;
+    }));
+    EXPECT_NE(nullptr, before->link(veth));
+    EXPECT_EQ(generation, before->generation);
+    EXPECT_LT(generation, monitor.snapshot()->generation);
+
+    // Every publication reported, in order
+    EXPECT_TRUE(consecutive);
+}
+
+TEST_F(NetlinkMonitorTest, StopDropsTheSnapshot)
+{
+    monitor.stop();
+    EXPECT_FALSE(monitor.snapshot());
+    ASSERT_TRUE(monitor.start());
+    EXPECT_TRUE(waitFor(monitor, [](const Plugin::NetlinkSnapshot& snapshot) {
+        return snapshot.link("lo") != nullptr;
+    }));
+}
@@ -0,0 +1,324 @@
+/*
+ * If not stated otherwise in this file or this component's LICENSE file the
+ * following copyright and licenses apply:
+ *
+ * Copyright 2022 RDK Management
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include <gtest/gtest.h>
+
+#include <dirent.h>
+#include <openssl/evp.h>
+
+#include <algorithm>
+#include <chrono>
+#include <condition_variable>
+#include <fstream>
+#include <functional>
+#include <map>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+#include <opkg.h>
+
+#include "PackagerImplementation.h"
+
+#include "ServiceMock.h"
+
+using namespace WPEFramework;
+
+using ::testing::NiceMock;
+using ::testing::Return;
+
+namespace {
+std::string md5(const std::string& content)
+{
+    unsigned char value[EVP_MAX_MD_SIZE];
+    unsigned int length = 0;
+    EVP_Digest(content.data(), content.size(), value, &length, EVP_md5(), nullptr);
+    std::string hex;
+    char byte[3];
+    for (unsigned int i = 0; i < length; i++) {
+        snprintf(byte, sizeof(byte), "%02x", value[i]);
+        hex += byte;
+    }
+    return hex;
+}
+
+bool eventually(const std::function<bool()>& condition)
+{
+    auto start = std::chrono::steady_clock::now();
+    while (condition() == false) {
+        if (std::chrono::steady_clock::now() - start > std::chrono::seconds(10)) {
+            return false;
+        }
+        std::this_thread::sleep_for(std::chrono::milliseconds(10));
+    }
+    return true;
+}
+}
+
+// The feed is in a local directory, read with file:// URLs; opkg is the stub of the headers
+class PackagerImplementationTest : public ::testing::Test {
+protected:
+    class Notification : public Exchange::IPackager::INotification {
+    public:
+        explicit Notification(PackagerImplementationTest& parent)
+            : _parent(parent)
+        {
+        }
+
+        void StateChange(Exchange::IPackager::IPackageInfo* package, Exchange::IPackager::IInstallationInfo* install) override
+        {
+            std::lock_guard<std::mutex> guard(_parent.lock);
+            _parent.states[package->Name()].push_back(install->State());
+            _parent.errors[package->Name()] = install->ErrorCode();
+            _parent.condition.notify_all();
+        }
+
+        void RepositorySynchronize(uint32_t) override
+        {
+        }
+
+        BEGIN_INTERFACE_MAP(Notification)
+            INTERFACE_ENTRY(Exchange::IPackager::INotification)
+        END_INTERFACE_MAP
+
+    private:
+        PackagerImplementationTest& _parent;
+    };
+
+    std::string directory;
+    std::string content;
+    std::string lists;
+    NiceMock<ServiceMock> service;
+    Core::Sink<Notification> notification;
+    Exchange::IPackager* packager;
+
+    std::mutex lock;
+    std::condition_variable condition;
+    std::map<std::string, std::vector<Exchange::IPackager::state>> states;
+    std::map<std::string, uint32_t> errors;
+
+    PackagerImplementationTest()
+        : notification(*this)
+        , packager(nullptr)
+    {
+    }
+
+    virtual void SetUp()
+    {
+        char name[] = "/tmp/packagertestXXXXXX";
+        ASSERT_TRUE(mkdtemp(name) != nullptr);
+        directory = name;
+        content = directory + "/cache/content/";
+        ASSERT_EQ(0, system(("mkdir -p " + directory + "/feed " + directory + "/lists").c_str()));
+        std::ofstream(directory + "/opkg.conf") << "\n";
+
+        // Empty, the feeds are read again for each lookup
+        OpkgStub::instance().reset();
+        lists = directory + "/lists";
+        opkg_config->lists_dir = &lists[0];
+
+        ON_CALL(service, ConfigLine())
+            .WillByDefault(Return("{\"config\":\"" + directory + "/opkg.conf\",\"temppath\":\"" + directory + "/tmp/\","
+                + "\"cachepath\":\"" + directory + "/cache/\",\"downloads\":2}"));
+
+        packager = Core::Service<Plugin::PackagerImplementation>::Create<Exchange::IPackager>();
+        ASSERT_EQ(Core::ERROR_NONE, packager->Configure(&service));
+        packager->Register(&notification);
+    }
+
+    virtual void TearDown()
+    {
+        if (packager != nullptr) {
+            packager->Unregister(&notification);
+            packager->Release();
+        }
+        EXPECT_EQ(0, system(("rm -rf " + directory).c_str()));
+    }
+
+    // A package of the feed, with the file of it when it has content
+    void package(const std::string& name, const std::string& data)
+    {
+        OpkgStub::Package package;
+        package.Name = name;
+        package.Version = "1.0";
+        package.Source = "file://" + directory + "/feed";
+        package.FileName = name + "_1.0_arm.ipk";
+        package.Md5 = md5(data);
+        if (data.empty() == false) {
+            std::ofstream(directory + "/feed/" + package.FileName, std::ios::binary) << data;
+        }
+        OpkgStub::instance().add(package);
+    }
+
+    bool reached(const std::string& name, Exchange::IPackager::state state)
+    {
+        std::unique_lock<std::mutex> guard(lock);
+        return condition.wait_for(guard, std::chrono::seconds(10), [&]() {
+            return std::find(states[name].begin(), states[name].end(), state) != states[name].end();
+        });
+    }
+
+    bool failed(const std::string& name)
+    {
+        std::unique_lock<std::mutex> guard(lock);
+        return condition.wait_for(guard, std::chrono::seconds(10), [&]() { return errors[name] != 0; });
+    }
+
+    uint32_t error(const std::string& name)
+    {
+        std::lock_guard<std::mutex> guard(lock);
+        return errors[name];
+    }
+
+    // The packages downloaded into the content cache
+    size_t cached()
+    {
+        size_t count = 0;
+        DIR* contentDirectory = opendir(content.c_str());
+        if (contentDirectory != nullptr) {
+            struct dirent* entry;
+            while ((entry = readdir(contentDirectory)) != nullptr) {
+                count += (strncmp(entry->d_name, "sha256-", 7) == 0) ? 1 : 0;
+            }
+            closedir(contentDirectory);
+        }
+        return count;
+    }
+
+    std::vector<std::string> installed(bool fromFile)
+    {
+        std::vector<std::string> targets;
+        for (const OpkgStub::Installation& installation : OpkgStub::instance().installed()) {
+            if (installation.Exists == fromFile) {
+                targets.push_back(installation.Target);
+            }
+        }
+        std::sort(targets.begin(), targets.end());
+        return targets;
+    }
+};
+
+TEST_F(PackagerImplementationTest, InstallsFromTheContentCache)
+{
+    package("first", std::string(100000, '1'));
+    package("second", std::string(100000, '2'));
+    package("third", std::string(100000, '3'));
+    for (const char* name : { "first", "second", "third" }) {
+        EXPECT_EQ(Core::ERROR_NONE, packager->Install(name, "1.0", "arm"));
+    }
+    for (const char* name : { "first", "second", "third" }) {
+        EXPECT_TRUE(reached(name, Exchange::IPackager::DOWNLOADING));
+        EXPECT_TRUE(reached(name, Exchange::IPackager::DOWNLOADED));
+        EXPECT_TRUE(reached(name, Exchange::IPackager::INSTALLED));
+    }
+
+    // Each installed from its file in the cache, under its name in the feed
+    EXPECT_EQ(std::vector<std::string>({ content + "staging/first_1.0_arm.ipk", content + "staging/second_1.0_arm.ipk",
+                  content + "staging/third_1.0_arm.ipk" }),
+        installed(true));
+    EXPECT_TRUE(installed(false).empty());
+
+    // Not kept once installed
+    EXPECT_TRUE(eventually([&]() { return cached() == 0; }));
+}
+
+TEST_F(PackagerImplementationTest, OpkgDownloadsWhatTheCacheDoesNot)
+{
+    // Not downloading from the feed, e.g. for the proxy of opkg.conf, and not in the feed at all
+    package("unreachable", "");
+    EXPECT_EQ(Core::ERROR_NONE, packager->Install("unreachable", "1.0", "arm"));
+    EXPECT_EQ(Core::ERROR_NONE, packager->Install("local", "1.0", "arm"));
+
+    EXPECT_TRUE(reached("unreachable", Exchange::IPackager::INSTALLED));
+    EXPECT_TRUE(reached("local", Exchange::IPackager::INSTALLED));
+    EXPECT_EQ(std::vector<std::string>({ "local", "unreachable" }), installed(false));
+    EXPECT_EQ(0u, error("unreachable"));
+}
+
+TEST_F(PackagerImplementationTest, QueuedOnce)
+{
+    std::mutex gate;
+    std::condition_variable opened;
+    bool installing = false;
+    bool open = false;
+    OpkgStub::instance().onInstall = [&](const std::string&) {
+        std::unique_lock<std::mutex> guard(gate);
+        installing = true;
+        opened.notify_all();
+        opened.wait(guard, [&]() { return open; });
+    };
+
+    package("first", std::string(1000, '1'));
+    package("second", std::string(1000, '2'));
+    EXPECT_EQ(Core::ERROR_NONE, packager->Install("first", "1.0", "arm"));
+    {
+        std::unique_lock<std::mutex> guard(gate);
+        ASSERT_TRUE(opened.wait_for(guard, std::chrono::seconds(10), [&]() { return installing; }));
+    }
+
+    // While it is installed
+    EXPECT_EQ(Core::ERROR_INPROGRESS, packager->Install("first", "1.0", "arm"));
+    EXPECT_EQ(Core::ERROR_NONE, packager->Install("second", "1.0", "arm"));
+    EXPECT_EQ(Core::ERROR_INPROGRESS, packager->Install("second", "1.0", "arm"));
+    EXPECT_EQ(Core::ERROR_INPROGRESS, packager->SynchronizeRepository());
+
+    {
+        std::lock_guard<std::mutex> guard(gate);
+        open = true;
+    }
+    opened.notify_all();
+    EXPECT_TRUE(reached("first", Exchange::IPackager::INSTALLED));
+    EXPECT_TRUE(reached("second", Exchange::IPackager::INSTALLED));
+    EXPECT_EQ(2u, OpkgStub::instance().installed().size());
+}
+
+TEST_F(PackagerImplementationTest, FailedInstallKeepsThePackage)
+{
+    {
+        std::lock_guard<std::mutex> guard(OpkgStub::instance().lock);
+        OpkgStub::instance().failing.push_back("failing");
+    }
+    package("failing", std::string(1000, 'f'));
+    EXPECT_EQ(Core::ERROR_NONE, packager->Install("failing", "1.0", "arm"));
+    EXPECT_TRUE(failed("failing"));
+    EXPECT_EQ(1u, cached());
+
+    // Tried again once out of the queue, from the cache
+    {
+        std::lock_guard<std::mutex> guard(OpkgStub::instance().lock);
+        OpkgStub::instance().failing.clear();
+    }
+    EXPECT_TRUE(eventually([&]() { return packager->Install("failing", "1.0", "arm") == Core::ERROR_NONE; }));
+    EXPECT_TRUE(reached("failing", Exchange::IPackager::INSTALLED));
+    EXPECT_EQ(std::vector<std::string>(2, content + "staging/failing_1.0_arm.ipk"), installed(true));
+    EXPECT_TRUE(eventually([&]() { return cached() == 0; }));
+}
+
+TEST_F(PackagerImplementationTest, OpkgNotInitialized)
+{
+    {
+        std::lock_guard<std::mutex> guard(OpkgStub::instance().lock);
+        OpkgStub::instance().initializationFails = true;
+    }
+    package("first", std::string(1000, '1'));
+    EXPECT_EQ(Core::ERROR_NONE, packager->Install("first", "1.0", "arm"));
+    EXPECT_TRUE(failed("first"));
+    EXPECT_EQ(static_cast<uint32_t>(Core::ERROR_GENERAL), error("first"));
+    EXPECT_TRUE(OpkgStub::instance().installed().empty());
+}
@@ -0,0 +1,135 @@
+/*
+ * If not stated otherwise in this file or this component's LICENSE file the
+ * following copyright and licenses apply:
+ *
+ * Copyright 2022 RDK Management
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include <gtest/gtest.h>
+
+#include <map>
+
+#include "PlaybackProgress.h"
+
+using namespace WPEFramework;
+
+TEST(PlaybackProgressTest, LatestProgress)
+{
+    Plugin::LatestProgress latest;
+    Plugin::PlaybackProgress progress = { 600000, 1000, 1, 0, 600000 };
+    EXPECT_FALSE(latest.Take(progress));
+
+    // A delivery to schedule for the first only
+    EXPECT_TRUE(latest.Post(progress));
+    progress.positionMiliseconds = 2000;
+    EXPECT_FALSE(latest.Post(progress));
+    progress.positionMiliseconds = 3000;
+    EXPECT_FALSE(latest.Post(progress));
+
+    Plugin::PlaybackProgress taken;
+    ASSERT_TRUE(latest.Take(taken));
+    EXPECT_EQ(3000, taken.positionMiliseconds);
+    EXPECT_FALSE(latest.Take(taken));
+    EXPECT_EQ(2u, latest.Coalesced());
+
+    EXPECT_TRUE(latest.Post(progress));
+}
+
+TEST(PlaybackProgressTest, RateLimitPerClient)
+{
+    Plugin::ProgressRateLimiter limiter;
+    limiter.SetInterval("ui", 1000);
+    limiter.SetInterval("analytics", 5000);
+    EXPECT_EQ(0u, limiter.Interval("overlay"));
+
+    // 10 s of progress every 250 ms, of two streams
+    std::map<std::string, int> events;
+    for (uint64_t now = 0; now < 10000; now += 250) {
+        for (const char* stream : { "main", "pip" }) {
+            for (const char* client : { "overlay", "ui", "analytics" }) {
+                if (limiter.Admit(client, stream, now)) {
+                    events[std::string(client) + "/" + stream]++;
+                }
+            }
+        }
+    }
+
+    EXPECT_EQ(40, events["overlay/main"]);
+    EXPECT_EQ(10, events["ui/main"]);
+    EXPECT_EQ(2, events["analytics/main"]);
+    EXPECT_EQ(10, events["ui/pip"]);
+
+    // A stream that comes back gets its progress at once
+    EXPECT_FALSE(limiter.Admit("analytics", "pip", 9999));
+    limiter.Forget("pip");
+    EXPECT_TRUE(limiter.Admit("analytics", "pip", 9999));
+
+    // Back to every progress
+    limiter.SetInterval("ui", 0);
+    EXPECT_TRUE(limiter.Admit("ui", "main", 10000));
+    EXPECT_TRUE(limiter.Admit("ui", "main", 10000));
+}
+
+TEST(PlaybackProgressTest, RateLimitOfUnregisteredClients)
+{
+    Plugin::ProgressRateLimiter limiter;
+    limiter.SetInterval("ui", 1000);
+    limiter.SetInterval("analytics", 5000);
+
+    // Kept until the progress event after the one it set its interval before
+    limiter.Prune();
+    EXPECT_EQ(1000u, limiter.Interval("ui"));
+    EXPECT_TRUE(limiter.Admit("ui", "main", 0));
+    limiter.Prune();
+    EXPECT_EQ(1000u, limiter.Interval("ui"));
+    EXPECT_EQ(0u, limiter.Interval("analytics"));
+
+    // Unregistered
+    limiter.Prune();
+    EXPECT_EQ(0u, limiter.Interval("ui"));
+    EXPECT_TRUE(limiter.Admit("ui", "main", 1));
+}
+
+TEST(PlaybackProgressTest, PositionClock)
+{
+    Plugin::PositionClock clock;
+    EXPECT_FALSE(clock.IsValid());
+
+    Plugin::PlaybackProgress progress = { 600000, 30000, 1, 0, 600000 };
+    clock.Update(progress, 1000);
+    ASSERT_TRUE(clock.IsValid());
+    EXPECT_EQ(30000, clock.PositionMiliseconds(1000));
+    EXPECT_EQ(30750, clock.PositionMiliseconds(1750));
+    EXPECT_EQ(750u, clock.AgeMiliseconds(1750));
+    // Not before the progress
+    EXPECT_EQ(30000, clock.PositionMiliseconds(500));
+
+    // Fast forward, up to the end only
+    progress.playbackSpeed = 4;
+    clock.Update(progress, 2000);
+    EXPECT_EQ(34000, clock.PositionMiliseconds(3000));
+    EXPECT_EQ(600000, clock.PositionMiliseconds(1000000));
+
+    // Rewind, down to the start only
+    progress.playbackSpeed = -2;
+    clock.Update(progress, 3000);
+    EXPECT_EQ(28000, clock.PositionMiliseconds(4000));
+    EXPECT_EQ(0, clock.PositionMiliseconds(100000));
+
+    // Paused
+    progress.playbackSpeed = 0;
+    clock.Update(progress, 4000);
+    EXPECT_EQ(30000, clock.PositionMiliseconds(60000));
+}
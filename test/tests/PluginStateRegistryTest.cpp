@@ -0,0 +1,198 @@
+/*
+ * If not stated otherwise in this file or this component's LICENSE file the
+ * following copyright and licenses apply:
+ *
+ * Copyright 2022 RDK Management
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include <gtest/gtest.h>
+
+#include <chrono>
+#include <functional>
+#include <iostream>
+#include <thread>
+
+#include "PluginStateRegistry.h"
+
+using namespace WPEFramework;
+
+namespace {
+typedef Plugin::PluginStateRegistry Registry;
+
+const int kPlugins = 120;
+const int kLaunches = 50;
+const std::chrono::microseconds kRoundTrip(500);
+
+// Stands in for the Controller: every "status" call costs a JSON-RPC round
+// trip and returns the whole plugin list.
+class MockController {
+public:
+    MockController()
+        : _calls(0)
+        , _fail(false)
+    {
+        for (int i = 0; i < kPlugins; i++) {
+            Registry::Entry entry;
+            entry.callsign = "Plugin" + std::to_string(i);
+            entry.state = Registry::DEACTIVATED;
+            entry.className = "Class" + std::to_string(i);
+            entry.clientIdentifier = (i % 4 == 0) ? entry.callsign : "";
+            _plugins.push_back(entry);
+        }
+    }
+
+    bool status(std::vector<Registry::Entry>& entries)
+    {
+        _calls++;
+        std::this_thread::sleep_for(kRoundTrip);
+        if (_duringCall)
+            _duringCall();
+        if (_fail)
+            return false;
+        entries = _plugins;
+        return true;
+    }
+
+    Registry::Loader loader()
+    {
+        return [this](std::vector<Registry::Entry>& entries) { return status(entries); };
+    }
+
+    std::vector<Registry::Entry> _plugins;
+    // Runs while a call is in flight, e.g. a notification
+    std::function<void()> _duringCall;
+    int _calls;
+    bool _fail;
+};
+
+// What launchWrapper did before: fetch the status and scan it.
+bool findByStatus(MockController& controller, const std::string& callsign, Registry::Entry& result)
+{
+    std::vector<Registry::Entry> entries;
+    if (!controller.status(entries))
+        return false;
+    for (const auto& entry : entries) {
+        if (entry.callsign == callsign) {
+            result = entry;
+            return true;
+        }
+    }
+    return false;
+}
+}
+
+TEST(PluginStateRegistryTest, FirstLookupLoadsStatusOnce)
+{
+    MockController controller;
+    Registry registry(controller.loader());
+
+    EXPECT_FALSE(registry.isLoaded());
+    Registry::Entry entry;
+    EXPECT_TRUE(registry.find("Plugin8", entry));
+    EXPECT_EQ("Class8", entry.className);
+    EXPECT_EQ("Plugin8", entry.clientIdentifier);
+    EXPECT_FALSE(registry.find("Missing", entry));
+    EXPECT_EQ(kPlugins, (int)registry.snapshot().size());
+    EXPECT_EQ(1, controller._calls);
+}
+
+TEST(PluginStateRegistryTest, FailedLoadIsRetried)
+{
+    MockController controller;
+    Registry registry(controller.loader());
+
+    controller._fail = true;
+    EXPECT_FALSE(registry.contains("Plugin1"));
+    EXPECT_FALSE(registry.isLoaded());
+
+    controller._fail = false;
+    EXPECT_TRUE(registry.contains("Plugin1"));
+    EXPECT_EQ(2, controller._calls);
+}
+
+TEST(PluginStateRegistryTest, NotificationsKeepStateCurrent)
+{
+    MockController controller;
+    Registry registry(controller.loader());
+    Registry::Entry entry;
+    ASSERT_TRUE(registry.find("Plugin4", entry));
+    EXPECT_EQ(Registry::DEACTIVATED, entry.state);
+
+    registry.update("Plugin4", Registry::ACTIVATION, "Class4", "Plugin4");
+    registry.update("Plugin4", Registry::ACTIVATED, "Class4", "Plugin4");
+    ASSERT_TRUE(registry.find("Plugin4", entry));
+    EXPECT_EQ(Registry::ACTIVATED, entry.state);
+    EXPECT_TRUE(Registry::isRunning(entry.state));
+
+    // a status fetched after the notification replaces it
+    registry.refresh();
+    ASSERT_TRUE(registry.find("Plugin4", entry));
+    EXPECT_EQ(Registry::DEACTIVATED, entry.state);
+
+    // a notification received while the status was fetched is newer
+    controller._duringCall = [&registry]() {
+        registry.update("Plugin4", Registry::ACTIVATED, "Class4", "Plugin4");
+    };
+    registry.refresh();
+    controller._duringCall = nullptr;
+    ASSERT_TRUE(registry.find("Plugin4", entry));
+    EXPECT_EQ(Registry::ACTIVATED, entry.state);
+
+    registry.update("Plugin4", Registry::DEACTIVATED, "Class4", "Plugin4");
+    ASSERT_TRUE(registry.find("Plugin4", entry));
+    EXPECT_FALSE(Registry::isRunning(entry.state));
+
+    registry.update("Clone", Registry::DEACTIVATED, "Class4", "Plugin4");
+    EXPECT_TRUE(registry.contains("Clone"));
+    registry.remove("Clone");
+    EXPECT_FALSE(registry.contains("Clone"));
+    registry.refresh();
+    EXPECT_FALSE(registry.contains("Clone"));
+    EXPECT_EQ(4, controller._calls);
+}
+
+TEST(PluginStateRegistryTest, LaunchLookupLatency)
+{
+    MockController before;
+    Registry::Entry entry;
+    auto start = std::chrono::steady_clock::now();
+    for (int i = 0; i < kLaunches; i++) {
+        // launchWrapper looked up the new callsign and its type
+        findByStatus(before, "App" + std::to_string(i), entry);
+        findByStatus(before, "Plugin" + std::to_string(i), entry);
+    }
+    auto statusTime = std::chrono::duration_cast<std::chrono::microseconds>(std::chrono::steady_clock::now() - start);
+
+    MockController after;
+    Registry registry(after.loader());
+    start = std::chrono::steady_clock::now();
+    for (int i = 0; i < kLaunches; i++) {
+        const std::string callsign = "App" + std::to_string(i);
+        if (!registry.contains(callsign)) {
+            EXPECT_TRUE(registry.find("Plugin" + std::to_string(i), entry));
+            registry.update(callsign, Registry::DEACTIVATED, entry.className, entry.clientIdentifier);
+        }
+        registry.update(callsign, Registry::ACTIVATED, entry.className, entry.clientIdentifier);
+    }
+    auto registryTime = std::chrono::duration_cast<std::chrono::microseconds>(std::chrono::steady_clock::now() - start);
+
+    std::cout << kLaunches << " launches: status scan " << statusTime.count() << "us, "
+              << before._calls << " round trips; registry " << registryTime.count() << "us, "
+              << after._calls << " round trips" << std::endl;
+
+    EXPECT_EQ(2 * kLaunches, before._calls);
+    EXPECT_EQ(1, after._calls);
+    EXPECT_LT(registryTime, statusTime);
+}
@@ -0,0 +1,137 @@
+/*
+ * If not stated otherwise in this file or this component's LICENSE file the
+ * following copyright and licenses apply:
+ *
+ * Copyright 2022 RDK Management
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include <gtest/gtest.h>
+
+#include <atomic>
+#include <chrono>
+#include <thread>
+
+#include "PrewarmPool.h"
+
+using namespace WPEFramework;
+
+namespace {
+typedef Plugin::PrewarmPool Pool;
+}
+
+TEST(PrewarmPoolTest, WarmSlotIsClaimedOnce)
+{
+    Pool pool(1000);
+    pool.add("LightningApp-1", "LightningApp");
+
+    std::string callsign;
+    std::string type;
+    ASSERT_TRUE(pool.nextToWarm(callsign, type));
+    EXPECT_EQ("LightningApp-1", callsign);
+    EXPECT_EQ("LightningApp", type);
+    pool.warmed(callsign, true);
+
+    EXPECT_FALSE(pool.claim("LightningApp-1", "HtmlApp", 0));
+    EXPECT_FALSE(pool.claim("Other", "LightningApp", 0));
+    EXPECT_TRUE(pool.claim("LightningApp-1", "LightningApp", 0));
+    EXPECT_EQ(Pool::CLAIMED, pool.state("LightningApp-1"));
+    EXPECT_FALSE(pool.claim("LightningApp-1", "", 0));
+}
+
+TEST(PrewarmPoolTest, ReleasedSlotIsWarmedAgainAfterDelay)
+{
+    Pool pool(50);
+    pool.add("HtmlApp-1", "HtmlApp");
+
+    std::string callsign;
+    std::string type;
+    ASSERT_TRUE(pool.nextToWarm(callsign, type));
+    pool.warmed(callsign, true);
+    ASSERT_TRUE(pool.claim("HtmlApp-1", "", 0));
+
+    auto released = Pool::Clock::now();
+    pool.released("HtmlApp-1");
+    EXPECT_EQ(Pool::IDLE, pool.state("HtmlApp-1"));
+    ASSERT_TRUE(pool.nextToWarm(callsign, type));
+    EXPECT_GE(Pool::Clock::now() - released, std::chrono::milliseconds(50));
+    EXPECT_EQ(Pool::WARMING, pool.state("HtmlApp-1"));
+}
+
+TEST(PrewarmPoolTest, EvictedSlotIsWarmedAgainOnceReleased)
+{
+    Pool pool(0);
+    pool.add("Netflix-1", "Netflix");
+
+    std::string callsign;
+    std::string type;
+    EXPECT_FALSE(pool.evict("Netflix-1", 0));
+    ASSERT_TRUE(pool.nextToWarm(callsign, type));
+    pool.warmed(callsign, true);
+    EXPECT_FALSE(pool.evict("Other", 0));
+    ASSERT_TRUE(pool.evict("Netflix-1", 0));
+    EXPECT_FALSE(pool.claim("Netflix-1", "Netflix", 0));
+
+    // The deactivation of the evicted instance, then the launched one
+    pool.released("Netflix-1");
+    EXPECT_EQ(Pool::EVICTING, pool.state("Netflix-1"));
+    pool.evicted("Netflix-1");
+    EXPECT_EQ(Pool::CLAIMED, pool.state("Netflix-1"));
+    EXPECT_FALSE(pool.evict("Netflix-1", 0));
+    pool.released("Netflix-1");
+    EXPECT_EQ(Pool::IDLE, pool.state("Netflix-1"));
+}
+
+TEST(PrewarmPoolTest, LaunchWaitsForSlotBeingWarmed)
+{
+    Pool pool(1000);
+    pool.add("LightningApp-1", "LightningApp");
+
+    std::string callsign;
+    std::string type;
+    ASSERT_TRUE(pool.nextToWarm(callsign, type));
+
+    std::thread worker([&pool]() {
+        std::this_thread::sleep_for(std::chrono::milliseconds(20));
+        pool.warmed("LightningApp-1", true);
+    });
+    EXPECT_TRUE(pool.claim("LightningApp-1", "LightningApp", 2000));
+    worker.join();
+}
+
+TEST(PrewarmPoolTest, FailingSlotIsGivenUp)
+{
+    Pool pool(0);
+    pool.add("Broken", "Missing");
+
+    std::string callsign;
+    std::string type;
+    for (uint32_t i = 0; i < Pool::MAX_ATTEMPTS; i++) {
+        ASSERT_TRUE(pool.nextToWarm(callsign, type));
+        pool.warmed(callsign, false);
+    }
+    EXPECT_FALSE(pool.claim("Broken", "", 0));
+
+    std::atomic<bool> done(false);
+    std::thread worker([&]() {
+        std::string c, t;
+        EXPECT_FALSE(pool.nextToWarm(c, t));
+        done = true;
+    });
+    std::this_thread::sleep_for(std::chrono::milliseconds(20));
+    EXPECT_FALSE(done);
+    pool.stop();
+    worker.join();
+    EXPECT_TRUE(done);
+}
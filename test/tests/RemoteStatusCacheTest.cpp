@@ -0,0 +1,197 @@
+/*
+ * If not stated otherwise in this file or this component's LICENSE file the
+ * following copyright and licenses apply:
+ *
+ * Copyright 2022 RDK Management
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include <gtest/gtest.h>
+
+#include <string.h>
+
+#include <chrono>
+#include <thread>
+
+#include "IarmBusMock.h"
+#include "RemoteStatusCache.h"
+
+using namespace WPEFramework;
+using ::testing::_;
+using ::testing::Invoke;
+using ::testing::StrEq;
+
+namespace {
+// Stand-ins for the ControlMgr call structures
+struct NetworkStatus {
+    int network_id;
+    int controller_qty;
+    int controllers[4];
+};
+
+struct ControllerStatus {
+    int network_id;
+    int controller_id;
+    int battery_level;
+};
+
+const char* ctrlmBusName = "Ctrlm";
+const char* networkStatusGet = "Network_Status_Get";
+const char* controllerStatus = "Controller_Status";
+
+typedef Plugin::RemoteStatusCache<NetworkStatus, ControllerStatus> StatusCache;
+}
+
+class RemoteStatusCacheTest : public ::testing::Test {
+protected:
+    IarmBusImplMock iarmBusImplMock;
+    StatusCache cache;
+    int batteryLevel;
+
+    RemoteStatusCacheTest()
+        : cache(
+            [](NetworkStatus& status) {
+                return IARM_Bus_Call(ctrlmBusName, networkStatusGet, &status, sizeof(status)) == IARM_RESULT_SUCCESS;
+            },
+            [](int, ControllerStatus& status) {
+                return IARM_Bus_Call(ctrlmBusName, controllerStatus, &status, sizeof(status)) == IARM_RESULT_SUCCESS;
+            },
+            std::chrono::seconds(60))
+        , batteryLevel(90)
+    {
+    }
+
+    virtual void SetUp()
+    {
+        IarmBus::getInstance().impl = &iarmBusImplMock;
+
+        ON_CALL(iarmBusImplMock, IARM_Bus_Call(StrEq(ctrlmBusName), StrEq(networkStatusGet), _, _))
+            .WillByDefault(Invoke([](const char*, const char*, void* arg, size_t) {
+                NetworkStatus* status = static_cast<NetworkStatus*>(arg);
+                status->network_id = 1;
+                status->controller_qty = 3;
+                for (int i = 0; i < 3; i++) {
+                    status->controllers[i] = i + 1;
+                }
+                return IARM_RESULT_SUCCESS;
+            }));
+        ON_CALL(iarmBusImplMock, IARM_Bus_Call(StrEq(ctrlmBusName), StrEq(controllerStatus), _, _))
+            .WillByDefault(Invoke([this](const char*, const char*, void* arg, size_t) {
+                ControllerStatus* status = static_cast<ControllerStatus*>(arg);
+                if (status->network_id != 1) {
+                    return IARM_RESULT_INVALID_PARAM;
+                }
+                status->battery_level = batteryLevel;
+                return IARM_RESULT_SUCCESS;
+            }));
+    }
+
+    virtual void TearDown()
+    {
+        IarmBus::getInstance().impl = nullptr;
+    }
+
+    // What getAllRemoteData does: the network status, then the status of every bound remote
+    void getAllRemoteData(std::vector<ControllerStatus>& remotes)
+    {
+        NetworkStatus netStatus;
+        remotes.clear();
+        ASSERT_TRUE(cache.network(netStatus));
+        for (int i = 0; i < netStatus.controller_qty; i++) {
+            ControllerStatus ctrlStatus;
+            memset(&ctrlStatus, 0, sizeof(ctrlStatus));
+            ctrlStatus.network_id = netStatus.network_id;
+            ctrlStatus.controller_id = netStatus.controllers[i];
+            ASSERT_TRUE(cache.controller(ctrlStatus.controller_id, ctrlStatus));
+            remotes.push_back(ctrlStatus);
+        }
+    }
+};
+
+TEST_F(RemoteStatusCacheTest, RepeatedRequestsAreServedFromTheCache)
+{
+    EXPECT_CALL(iarmBusImplMock, IARM_Bus_Call(_, StrEq(networkStatusGet), _, _)).Times(1);
+    EXPECT_CALL(iarmBusImplMock, IARM_Bus_Call(_, StrEq(controllerStatus), _, _)).Times(3);
+
+    std::vector<ControllerStatus> remotes;
+    for (int i = 0; i < 10; i++) {
+        getAllRemoteData(remotes);
+    }
+    ASSERT_EQ(3u, remotes.size());
+    EXPECT_EQ(3, remotes[2].controller_id);
+    EXPECT_EQ(90, remotes[2].battery_level);
+
+    StatusCache::Statistics statistics = cache.statistics();
+    EXPECT_EQ(4u, statistics.fetches);
+    EXPECT_EQ(36u, statistics.hits);
+}
+
+TEST_F(RemoteStatusCacheTest, EventsRefreshWhatTheyChange)
+{
+    EXPECT_CALL(iarmBusImplMock, IARM_Bus_Call(_, StrEq(networkStatusGet), _, _)).Times(2);
+    EXPECT_CALL(iarmBusImplMock, IARM_Bus_Call(_, StrEq(controllerStatus), _, _)).Times(3 + 1 + 3);
+
+    std::vector<ControllerStatus> remotes;
+    getAllRemoteData(remotes);
+
+    // A battery event of remote 2 only refreshes remote 2
+    batteryLevel = 40;
+    cache.invalidateController(2);
+    getAllRemoteData(remotes);
+    EXPECT_EQ(90, remotes[0].battery_level);
+    EXPECT_EQ(40, remotes[1].battery_level);
+
+    // Pairing refreshes everything
+    cache.invalidate();
+    getAllRemoteData(remotes);
+    EXPECT_EQ(40, remotes[0].battery_level);
+}
+
+TEST_F(RemoteStatusCacheTest, EntriesExpire)
+{
+    EXPECT_CALL(iarmBusImplMock, IARM_Bus_Call(_, StrEq(networkStatusGet), _, _)).Times(2);
+    EXPECT_CALL(iarmBusImplMock, IARM_Bus_Call(_, StrEq(controllerStatus), _, _)).Times(6);
+
+    cache.setMaxAge(std::chrono::milliseconds(20));
+    std::vector<ControllerStatus> remotes;
+    getAllRemoteData(remotes);
+    getAllRemoteData(remotes);
+    std::this_thread::sleep_for(std::chrono::milliseconds(30));
+    getAllRemoteData(remotes);
+}
+
+TEST_F(RemoteStatusCacheTest, FailuresAndOverlappingEventsAreNotCached)
+{
+    ControllerStatus ctrlStatus;
+    memset(&ctrlStatus, 0, sizeof(ctrlStatus));
+    ctrlStatus.network_id = 7;
+    ctrlStatus.controller_id = 1;
+    EXPECT_CALL(iarmBusImplMock, IARM_Bus_Call(_, StrEq(controllerStatus), _, _)).Times(4);
+    EXPECT_FALSE(cache.controller(1, ctrlStatus));
+    ctrlStatus.network_id = 1;
+    EXPECT_TRUE(cache.controller(1, ctrlStatus));
+    EXPECT_TRUE(cache.controller(1, ctrlStatus));
+
+    // An event while ControlMgr is being asked: the answer may be older than the event
+    cache.invalidateController(1);
+    ON_CALL(iarmBusImplMock, IARM_Bus_Call(StrEq(ctrlmBusName), StrEq(controllerStatus), _, _))
+        .WillByDefault(Invoke([this](const char*, const char*, void* arg, size_t) {
+            static_cast<ControllerStatus*>(arg)->battery_level = 10;
+            cache.invalidateController(1);
+            return IARM_RESULT_SUCCESS;
+        }));
+    EXPECT_TRUE(cache.controller(1, ctrlStatus));
+    EXPECT_EQ(10, ctrlStatus.battery_level);
+    EXPECT_TRUE(cache.controller(1, ctrlStatus));
+}
@@ -0,0 +1,191 @@
+/*
+ * If not stated otherwise in this file or this component's LICENSE file the
+ * following copyright and licenses apply:
+ *
+ * Copyright 2022 RDK Management
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include <gtest/gtest.h>
+
+#include <string.h>
+
+#include <map>
+#include <vector>
+
+#include "IarmBusMock.h"
+#include "RibTransaction.h"
+
+using namespace WPEFramework;
+using ::testing::_;
+using ::testing::Invoke;
+using ::testing::StrEq;
+
+namespace {
+// Stand-in for ctrlm_rcu_iarm_call_rib_request_t
+struct RibRequest {
+    int controller_id;
+    unsigned char attribute_id;
+    unsigned char attribute_index;
+    unsigned char length;
+    char data[92];
+};
+
+const char* ctrlmBusName = "Ctrlm";
+const char* ribRequestSet = "Rib_Request_Set";
+
+const unsigned char irRfDatabase = 0xDB;
+
+// IRRFDB entries of the 7 original keys and the separate device power slots
+const int keys[] = { 0x34, 0x41, 0x42, 0x43, 0x6B, 0x6C, 0x6D };
+const int powerSlots[] = { 0x40, 0x4D, 0x4E };
+
+RibRequest entry(int controllerId, int rfKey, unsigned char code)
+{
+    RibRequest request;
+    memset(&request, 0, sizeof(request));
+    request.controller_id = controllerId;
+    request.attribute_id = irRfDatabase;
+    request.attribute_index = (unsigned char)rfKey;
+    request.length = 12;
+    for (int i = 0; i < request.length; i++) {
+        request.data[i] = (char)(code + i);
+    }
+    return request;
+}
+
+bool writeRib(RibRequest& request)
+{
+    return IARM_Bus_Call(ctrlmBusName, ribRequestSet, &request, sizeof(request)) == IARM_RESULT_SUCCESS;
+}
+
+typedef Plugin::RibTransaction<RibRequest> Transaction;
+typedef Plugin::RibShadow<RibRequest> Shadow;
+}
+
+class RibTransactionTest : public ::testing::Test {
+protected:
+    IarmBusImplMock iarmBusImplMock;
+    std::map<int, std::vector<unsigned char>> rib;
+    Transaction transaction;
+    Shadow shadow;
+
+    virtual void SetUp()
+    {
+        IarmBus::getInstance().impl = &iarmBusImplMock;
+        ON_CALL(iarmBusImplMock, IARM_Bus_Call(StrEq(ctrlmBusName), StrEq(ribRequestSet), _, _))
+            .WillByDefault(Invoke([this](const char*, const char*, void* arg, size_t) {
+                RibRequest* request = static_cast<RibRequest*>(arg);
+                rib[request->attribute_index].assign(request->data, request->data + request->length);
+                return IARM_RESULT_SUCCESS;
+            }));
+        shadow.binding(1, 1000);
+    }
+
+    virtual void TearDown()
+    {
+        IarmBus::getInstance().impl = nullptr;
+    }
+
+    // What setKeyActionMapping queues for a TV codeset: every key, and the
+    // separate power slots cleared first and set again for the power keys
+    void queueKeyMap(unsigned char codeset)
+    {
+        for (int slot : powerSlots) {
+            transaction.set(entry(1, slot, 0));
+        }
+        for (int key : keys) {
+            transaction.set(entry(1, key, codeset + key));
+        }
+        for (int slot : powerSlots) {
+            transaction.set(entry(1, slot, codeset + slot));
+        }
+    }
+};
+
+TEST_F(RibTransactionTest, EachEntryIsWrittenOnceWithItsLastValue)
+{
+    EXPECT_CALL(iarmBusImplMock, IARM_Bus_Call(_, StrEq(ribRequestSet), _, _)).Times(10);
+
+    queueKeyMap(0x10);
+    EXPECT_EQ(10u, transaction.size());
+    int written = 0;
+    EXPECT_TRUE(transaction.commit(shadow, writeRib, &written));
+    EXPECT_EQ(10, written);
+    EXPECT_EQ(0u, transaction.size());
+
+    EXPECT_EQ(0x10 + 0x40, rib[0x40][0]);
+    EXPECT_EQ(0x10 + 0x6D, rib[0x6D][0]);
+}
+
+TEST_F(RibTransactionTest, UnchangedEntriesAreSkipped)
+{
+    // the codeset written twice, then a codeset with a new volume code
+    EXPECT_CALL(iarmBusImplMock, IARM_Bus_Call(_, StrEq(ribRequestSet), _, _)).Times(10 + 0 + 1);
+
+    queueKeyMap(0x10);
+    EXPECT_TRUE(transaction.commit(shadow, writeRib));
+
+    int written = -1;
+    queueKeyMap(0x10);
+    EXPECT_TRUE(transaction.commit(shadow, writeRib, &written));
+    EXPECT_EQ(0, written);
+
+    queueKeyMap(0x10);
+    transaction.set(entry(1, 0x41, 0x77));
+    EXPECT_TRUE(transaction.commit(shadow, writeRib, &written));
+    EXPECT_EQ(1, written);
+    EXPECT_EQ(0x77, rib[0x41][0]);
+}
+
+TEST_F(RibTransactionTest, ShadowIsDroppedWhenItCantBeTrusted)
+{
+    EXPECT_CALL(iarmBusImplMock, IARM_Bus_Call(_, StrEq(ribRequestSet), _, _)).Times(10 + 10 + 10 + 10);
+
+    queueKeyMap(0x10);
+    EXPECT_TRUE(transaction.commit(shadow, writeRib));
+
+    // the remote was paired again
+    shadow.binding(1, 2000);
+    queueKeyMap(0x10);
+    EXPECT_TRUE(transaction.commit(shadow, writeRib));
+
+    // the remote wrote to its RIB; not tracked until its binding is known again
+    shadow.forget(1);
+    queueKeyMap(0x10);
+    EXPECT_TRUE(transaction.commit(shadow, writeRib));
+    queueKeyMap(0x10);
+    EXPECT_TRUE(transaction.commit(shadow, writeRib));
+}
+
+TEST_F(RibTransactionTest, FailedWritesAreRetried)
+{
+    EXPECT_CALL(iarmBusImplMock, IARM_Bus_Call(_, StrEq(ribRequestSet), _, _)).Times(10 + 1);
+    ON_CALL(iarmBusImplMock, IARM_Bus_Call(StrEq(ctrlmBusName), StrEq(ribRequestSet), _, _))
+        .WillByDefault(Invoke([](const char*, const char*, void* arg, size_t) {
+            RibRequest* request = static_cast<RibRequest*>(arg);
+            return (request->attribute_index == 0x43) ? IARM_RESULT_IPCCORE_FAIL : IARM_RESULT_SUCCESS;
+        }));
+
+    // the other entries are still written
+    queueKeyMap(0x10);
+    EXPECT_FALSE(transaction.commit(shadow, writeRib));
+
+    ON_CALL(iarmBusImplMock, IARM_Bus_Call(StrEq(ctrlmBusName), StrEq(ribRequestSet), _, _))
+        .WillByDefault(::testing::Return(IARM_RESULT_SUCCESS));
+    int written = 0;
+    queueKeyMap(0x10);
+    EXPECT_TRUE(transaction.commit(shadow, writeRib, &written));
+    EXPECT_EQ(1, written);
+}
@@ -0,0 +1,330 @@
+/*
+ * If not stated otherwise in this file or this component's LICENSE file the
+ * following copyright and licenses apply:
+ *
+ * Copyright 2022 RDK Management
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include <gtest/gtest.h>
+
+#include <arpa/inet.h>
+#include <dirent.h>
+#include <netinet/in.h>
+#include <sys/socket.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+#include <atomic>
+#include <chrono>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "TTSAudioCache.h"
+
+using namespace TTS;
+
+namespace {
+const int synthesisDelayMs = 150;
+const int playbackMs = 300;
+
+// Stand-in for the TTS endpoint, HTTP/1.0 with one request per connection.
+// Answers with a second of canned MP3 or PCM after a synthesis delay.
+class StandInEndpoint {
+public:
+    explicit StandInEndpoint(int delayMs)
+        : _delayMs(delayMs)
+        , _requests(0)
+        , _running(true)
+    {
+        _socket = socket(AF_INET, SOCK_STREAM, 0);
+        int on = 1;
+        setsockopt(_socket, SOL_SOCKET, SO_REUSEADDR, &on, sizeof(on));
+        struct sockaddr_in addr = {};
+        addr.sin_family = AF_INET;
+        addr.sin_addr.s_addr = htonl(INADDR_LOOPBACK);
+        bind(_socket, (struct sockaddr*)&addr, sizeof(addr));
+        listen(_socket, 16);
+        socklen_t len = sizeof(addr);
+        getsockname(_socket, (struct sockaddr*)&addr, &len);
+        _port = ntohs(addr.sin_port);
+        _thread = std::thread(&StandInEndpoint::run, this);
+    }
+
+    ~StandInEndpoint()
+    {
+        _running = false;
+        shutdown(_socket, SHUT_RDWR);
+        close(_socket);
+        _thread.join();
+    }
+
+    std::string url(const std::string& text, bool pcm = false) const
+    {
+        std::string escaped;
+        for (char c : text)
+            escaped += (c == ' ') ? std::string("%20") : std::string(1, c);
+        return "http://127.0.0.1:" + std::to_string(_port) + "/" + (pcm ? "pcm" : "mp3") + "?voice=carol&language=en-US&rate=50&text=" + escaped;
+    }
+
+    int requests() const { return _requests; }
+
+private:
+    void run()
+    {
+        while (_running) {
+            int client = accept(_socket, NULL, NULL);
+            if (client < 0)
+                break;
+            std::thread(&StandInEndpoint::serve, this, client).detach();
+        }
+    }
+
+    void serve(int client)
+    {
+        char request[2048];
+        ssize_t n = recv(client, request, sizeof(request) - 1, 0);
+        request[n > 0 ? n : 0] = 0;
+        _requests++;
+        std::this_thread::sleep_for(std::chrono::milliseconds(_delayMs));
+
+        std::string path(request);
+        path = path.substr(0, path.find(" HTTP/"));
+        std::string header;
+        std::string body;
+        if (path.find("error") != std::string::npos) {
+            header = "HTTP/1.0 500 Internal Server Error\r\nContent-Length: 0\r\n\r\n";
+        } else {
+            bool pcm = path.find("/pcm") != std::string::npos;
+            size_t size = pcm ? 22050 * 2 : 16000;
+            for (size_t i = 0; i < size; i++)
+                body.push_back(pcm ? 0 : (i % 418 == 0 ? 0xff : (char)(path.size() + i)));
+            header = "HTTP/1.0 200 OK\r\nContent-Type: " + std::string(pcm ? "audio/x-wav" : "audio/mpeg") + "\r\nContent-Length: " + std::to_string(body.size()) + "\r\n\r\n";
+        }
+        std::string response = header + body;
+        send(client, response.data(), response.size(), MSG_NOSIGNAL);
+        close(client);
+    }
+
+    int _delayMs;
+    std::atomic<int> _requests;
+    std::atomic<bool> _running;
+    int _socket;
+    int _port;
+    std::thread _thread;
+};
+
+double msSince(std::chrono::steady_clock::time_point start)
+{
+    return std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count();
+}
+}
+
+class TTSAudioCacheTest : public ::testing::Test {
+protected:
+    StandInEndpoint endpoint;
+    std::string dir;
+
+    TTSAudioCacheTest()
+        : endpoint(synthesisDelayMs)
+    {
+        char dirTemplate[] = "/tmp/ttscacheXXXXXX";
+        dir = mkdtemp(dirTemplate);
+    }
+
+    ~TTSAudioCacheTest() override
+    {
+        std::system(("rm -rf " + dir).c_str());
+    }
+
+    // The one file of the disk cache
+    std::string cacheFile() const
+    {
+        std::string file;
+        DIR* directory = opendir(dir.c_str());
+        if (directory == nullptr)
+            return file;
+        struct dirent* entry;
+        while ((entry = readdir(directory)) != nullptr) {
+            if (entry->d_name[0] != '.')
+                file = file.empty() ? dir + "/" + entry->d_name : "more than one";
+        }
+        closedir(directory);
+        return file;
+    }
+
+    // Speaks the phrases one after the other as TTSSpeaker does, returns the
+    // time spent waiting for audio before playback could start
+    double speakAll(TTSAudioCache& cache, const std::vector<std::string>& phrases, size_t prefetchCount)
+    {
+        double stallMs = 0;
+        for (size_t i = 0; i < phrases.size(); i++) {
+            for (size_t j = i + 1; j < phrases.size() && j <= i + prefetchCount; j++)
+                cache.prefetch(endpoint.url(phrases[j]));
+
+            auto start = std::chrono::steady_clock::now();
+            AudioData audio;
+            EXPECT_TRUE(cache.get(endpoint.url(phrases[i]), audio));
+            stallMs += msSince(start);
+            std::this_thread::sleep_for(std::chrono::milliseconds(playbackMs));
+        }
+        return stallMs;
+    }
+};
+
+TEST_F(TTSAudioCacheTest, RepeatedPhrasesAreFetchedOnce)
+{
+    TTSAudioCache cache(1024 * 1024);
+    AudioData first, second;
+    EXPECT_TRUE(cache.get(endpoint.url("Settings"), first));
+    EXPECT_TRUE(cache.get(endpoint.url("Settings"), second));
+    EXPECT_EQ(first, second);
+    EXPECT_EQ(16000u, first.size());
+    EXPECT_EQ(1, endpoint.requests());
+
+    AudioData pcm;
+    EXPECT_TRUE(cache.get(endpoint.url("Settings", true), pcm));
+    EXPECT_EQ(22050u * 2, pcm.size());
+    EXPECT_EQ(2, endpoint.requests());
+
+    TTSAudioCache::Statistics statistics = cache.statistics();
+    EXPECT_EQ(1u, statistics.memoryHits);
+    EXPECT_EQ(2u, statistics.misses);
+}
+
+TEST_F(TTSAudioCacheTest, MemoryBoundEvictsLeastRecentlyUsed)
+{
+    TTSAudioCache cache(3 * 16000);
+    AudioData audio;
+    for (const char* phrase : { "One", "Two", "Three", "Four" })
+        EXPECT_TRUE(cache.get(endpoint.url(phrase), audio));
+    EXPECT_LE(cache.statistics().memoryBytes, 3u * 16000);
+
+    EXPECT_TRUE(cache.get(endpoint.url("Four"), audio));
+    EXPECT_EQ(4, endpoint.requests());
+    EXPECT_TRUE(cache.get(endpoint.url("One"), audio));
+    EXPECT_EQ(5, endpoint.requests());
+}
+
+TEST_F(TTSAudioCacheTest, DiskCacheSurvivesRestart)
+{
+    AudioData audio;
+    {
+        TTSAudioCache cache(1024 * 1024, dir, 1024 * 1024);
+        EXPECT_TRUE(cache.get(endpoint.url("Back"), audio));
+    }
+    std::string cached = cacheFile();
+    ASSERT_FALSE(cached.empty());
+    struct stat before;
+    ASSERT_EQ(0, stat(cached.c_str(), &before));
+
+    {
+        TTSAudioCache cache(1024 * 1024, dir, 1024 * 1024);
+        AudioData fromDisk;
+        EXPECT_TRUE(cache.get(endpoint.url("Back"), fromDisk));
+        EXPECT_EQ(audio, fromDisk);
+        EXPECT_EQ(1u, cache.statistics().diskHits);
+        EXPECT_EQ(1, endpoint.requests());
+    }
+
+    // A disk hit does not write the file again
+    struct stat after;
+    ASSERT_EQ(0, stat(cached.c_str(), &after));
+    EXPECT_EQ(before.st_ino, after.st_ino);
+    EXPECT_EQ(before.st_mtim.tv_sec, after.st_mtim.tv_sec);
+    EXPECT_EQ(before.st_mtim.tv_nsec, after.st_mtim.tv_nsec);
+
+    {
+        TTSAudioCache cache(1024 * 1024, dir, 40000);
+        EXPECT_LE(cache.statistics().diskBytes, 40000u);
+        EXPECT_TRUE(cache.get(endpoint.url("Home"), audio));
+        EXPECT_TRUE(cache.get(endpoint.url("Guide"), audio));
+        EXPECT_LE(cache.statistics().diskBytes, 40000u);
+        cache.clear();
+        EXPECT_EQ(0u, cache.statistics().diskBytes);
+    }
+}
+
+TEST_F(TTSAudioCacheTest, SecureSpeechesStayOffDisk)
+{
+    TTSAudioCache cache(1024 * 1024, dir, 1024 * 1024);
+    AudioData audio;
+    EXPECT_TRUE(cache.get(endpoint.url("Your PIN is 1234"), audio, false));
+    cache.prefetch(endpoint.url("Account 5678"), false);
+    EXPECT_TRUE(cache.get(endpoint.url("Account 5678"), audio, false));
+    EXPECT_TRUE(cacheFile().empty());
+    EXPECT_EQ(0u, cache.statistics().diskBytes);
+
+    // Still played again from memory
+    EXPECT_TRUE(cache.get(endpoint.url("Your PIN is 1234"), audio, false));
+    EXPECT_EQ(2, endpoint.requests());
+}
+
+TEST_F(TTSAudioCacheTest, ErrorsAreNotCached)
+{
+    TTSAudioCache cache(1024 * 1024);
+    AudioData audio;
+    EXPECT_FALSE(cache.get(endpoint.url("error"), audio));
+    EXPECT_FALSE(cache.get(endpoint.url("error"), audio));
+    EXPECT_EQ(2, endpoint.requests());
+    EXPECT_EQ(2u, cache.statistics().fetchErrors);
+}
+
+TEST_F(TTSAudioCacheTest, CancelledPrefetchesAreDropped)
+{
+    TTSAudioCache cache(1024 * 1024);
+    for (int i = 0; i < 5; i++)
+        cache.prefetch(endpoint.url("Cancelled" + std::to_string(i)));
+    cache.cancelPrefetch();
+
+    // The one taken already, if any, is all that is fetched
+    AudioData audio;
+    EXPECT_TRUE(cache.get(endpoint.url("After"), audio));
+    EXPECT_LE(cache.statistics().prefetches, 1u);
+    EXPECT_LE(endpoint.requests(), 2);
+}
+
+TEST_F(TTSAudioCacheTest, ClipDurations)
+{
+    AudioData pcm(22050 * 2, 0);
+    EXPECT_EQ(1000000000ULL, audioDuration(pcm, true));
+
+    // ID3v2 tag of 20 bytes, then 10 MPEG 1 layer III frames, 128 kbps at 44.1 kHz
+    AudioData mp3 = { 'I', 'D', '3', 4, 0, 0, 0, 0, 0, 10 };
+    mp3.resize(20, 0);
+    for (int i = 0; i < 10; i++) {
+        AudioData frame(417, 0);
+        frame[0] = 0xff;
+        frame[1] = 0xfb;
+        frame[2] = 0x90;
+        frame[3] = 0x00;
+        mp3.insert(mp3.end(), frame.begin(), frame.end());
+    }
+    EXPECT_EQ(20u, id3TagSize(mp3));
+    EXPECT_EQ(10 * (1152ULL * 1000000000ULL / 44100), audioDuration(mp3, false));
+}
+
+TEST_F(TTSAudioCacheTest, benchmarkPrefetchStall)
+{
+    TTSAudioCache plain(1024 * 1024);
+    double plainStallMs = speakAll(plain, { "Movies", "Recently added", "Continue watching", "Top picks", "Search" }, 0);
+
+    TTSAudioCache prefetching(1024 * 1024);
+    double prefetchStallMs = speakAll(prefetching, { "Sports", "News", "Kids", "Music", "Apps" }, 2);
+    EXPECT_EQ(4u, prefetching.statistics().prefetches);
+
+    RecordProperty("stallMsWithoutPrefetch", (int)plainStallMs);
+    RecordProperty("stallMsWithPrefetch", (int)prefetchStallMs);
+}
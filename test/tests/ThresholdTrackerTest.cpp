@@ -0,0 +1,172 @@
+/*
+ * If not stated otherwise in this file or this component's LICENSE file the
+ * following copyright and licenses apply:
+ *
+ * Copyright 2022 RDK Management
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include <gtest/gtest.h>
+
+#include <cmath>
+#include <vector>
+
+#include "ThresholdTracker.h"
+
+using namespace WPEFramework;
+
+namespace {
+// An hour of usage sampled every second: hovering around 100 with a little noise,
+// a spike well over it every ten minutes
+std::vector<unsigned int> oscillatingTrace()
+{
+    std::vector<unsigned int> trace;
+    for (int second = 0; second < 3600; second++) {
+        double usage = 100 + 3 * std::sin(second * 1.7) + ((second % 2) ? 1 : -2);
+        if (second % 600 >= 300 && second % 600 < 360)
+            usage = 160;
+        if (second % 600 >= 360 && second % 600 < 420)
+            usage = 50;
+        trace.push_back(static_cast<unsigned int>(usage));
+    }
+    return trace;
+}
+
+struct Replay {
+    unsigned int exceeded = 0;
+    unsigned int receded = 0;
+    bool alternating = true;
+    double minGapSeconds = 1e9;
+};
+
+Replay replay(Plugin::ThresholdTracker& tracker, const std::vector<unsigned int>& trace)
+{
+    Replay result;
+    Plugin::ThresholdTracker::Event last = Plugin::ThresholdTracker::EVENT_RECEDED;
+    double lastEvent = -1e9;
+    for (size_t second = 0; second < trace.size(); second++) {
+        Plugin::ThresholdTracker::Event event = tracker.sample(trace[second], second);
+        if (Plugin::ThresholdTracker::EVENT_NONE == event)
+            continue;
+        if (event == last)
+            result.alternating = false;
+        last = event;
+        if (second - lastEvent < result.minGapSeconds)
+            result.minGapSeconds = second - lastEvent;
+        lastEvent = second;
+        if (Plugin::ThresholdTracker::EVENT_EXCEEDED == event)
+            result.exceeded++;
+        else
+            result.receded++;
+    }
+    return result;
+}
+
+Plugin::ThresholdPolicy policy(unsigned int hysteresisPercent, double dwellSeconds, double minEventIntervalSeconds)
+{
+    Plugin::ThresholdPolicy policy;
+    policy.threshold = 100;
+    policy.hysteresisPercent = hysteresisPercent;
+    policy.dwellSeconds = dwellSeconds;
+    policy.minEventIntervalSeconds = minEventIntervalSeconds;
+    return policy;
+}
+}
+
+TEST(ThresholdTrackerTest, NoSuppressionStorms)
+{
+    Plugin::ThresholdTracker tracker;
+    tracker.setPolicy(policy(0, 0, 0));
+    Replay result = replay(tracker, oscillatingTrace());
+
+    Plugin::ThresholdTracker::Summary summary = tracker.takeSummary();
+    EXPECT_GT(result.exceeded, 500u);
+    EXPECT_EQ(summary.crossings, result.exceeded);
+    EXPECT_TRUE(result.alternating);
+}
+
+TEST(ThresholdTrackerTest, HysteresisBand)
+{
+    Plugin::ThresholdTracker tracker;
+    tracker.setPolicy(policy(10, 0, 0));
+    Replay result = replay(tracker, oscillatingTrace());
+
+    // Once for each spike and the fall after it, the noise stays inside the band
+    EXPECT_LE(result.exceeded, 7u);
+    EXPECT_EQ(6u, result.receded);
+    EXPECT_TRUE(result.alternating);
+}
+
+TEST(ThresholdTrackerTest, DwellTime)
+{
+    Plugin::ThresholdTracker tracker;
+    tracker.setPolicy(policy(0, 5, 0));
+    Replay result = replay(tracker, oscillatingTrace());
+
+    // Only the spikes last long enough
+    EXPECT_EQ(6u, result.exceeded);
+    EXPECT_EQ(6u, result.receded);
+    EXPECT_TRUE(result.alternating);
+    EXPECT_GE(result.minGapSeconds, 5);
+}
+
+TEST(ThresholdTrackerTest, RateLimit)
+{
+    Plugin::ThresholdTracker tracker;
+    tracker.setPolicy(policy(0, 0, 120));
+    Replay result = replay(tracker, oscillatingTrace());
+
+    EXPECT_LE(result.exceeded + result.receded, 3600u / 120 + 1);
+    EXPECT_GE(result.minGapSeconds, 120);
+    EXPECT_TRUE(result.alternating);
+    EXPECT_GT(tracker.takeSummary().held, 0u);
+}
+
+TEST(ThresholdTrackerTest, Summary)
+{
+    Plugin::ThresholdTracker tracker;
+    tracker.setPolicy(policy(5, 0, 0));
+
+    EXPECT_EQ(Plugin::ThresholdTracker::EVENT_NONE, tracker.sample(90, 0));
+    EXPECT_EQ(Plugin::ThresholdTracker::EVENT_EXCEEDED, tracker.sample(130, 1));
+    EXPECT_EQ(Plugin::ThresholdTracker::EVENT_NONE, tracker.sample(97, 2));
+    EXPECT_EQ(Plugin::ThresholdTracker::EVENT_NONE, tracker.sample(101, 3));
+    EXPECT_TRUE(tracker.exceeded());
+
+    Plugin::ThresholdTracker::Summary summary = tracker.takeSummary();
+    EXPECT_EQ(4u, summary.samples);
+    EXPECT_EQ(2u, summary.crossings);
+    EXPECT_EQ(1u, summary.events);
+    EXPECT_EQ(101u, summary.last);
+    EXPECT_EQ(130u, summary.peak);
+
+    // The next starts over
+    EXPECT_EQ(Plugin::ThresholdTracker::EVENT_RECEDED, tracker.sample(94, 4));
+    EXPECT_FALSE(tracker.exceeded());
+    summary = tracker.takeSummary();
+    EXPECT_EQ(1u, summary.samples);
+    EXPECT_EQ(0u, summary.crossings);
+    EXPECT_EQ(94u, summary.last);
+    EXPECT_EQ(94u, summary.peak);
+}
+
+TEST(ThresholdTrackerTest, FullHysteresisStillRecedes)
+{
+    Plugin::ThresholdTracker tracker;
+    tracker.setPolicy(policy(100, 0, 0));
+
+    EXPECT_EQ(Plugin::ThresholdTracker::EVENT_EXCEEDED, tracker.sample(130, 0));
+    EXPECT_EQ(Plugin::ThresholdTracker::EVENT_NONE, tracker.sample(1, 1));
+    EXPECT_EQ(Plugin::ThresholdTracker::EVENT_RECEDED, tracker.sample(0, 2));
+}
@@ -0,0 +1,351 @@
+/*
+ * If not stated otherwise in this file or this component's LICENSE file the
+ * following copyright and licenses apply:
+ *
+ * Copyright 2022 RDK Management
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include <gtest/gtest.h>
+
+#include <arpa/inet.h>
+#include <curl/curl.h>
+#include <netinet/in.h>
+#include <stdlib.h>
+#include <sys/socket.h>
+
+#include <fstream>
+#include <sstream>
+#include <thread>
+
+#include "UtilsTarGz.h"
+
+namespace {
+void writeFile(const std::string& path, const std::string& content, bool append = false)
+{
+    std::ofstream file(path, append ? std::ios::app : std::ios::trunc);
+    file << content;
+}
+
+std::string readFile(const std::string& path)
+{
+    std::ifstream file(path);
+    std::stringstream content;
+    content << file.rdbuf();
+    return content.str();
+}
+
+bool exists(const std::string& path)
+{
+    struct stat st;
+    return (stat(path.c_str(), &st) == 0);
+}
+
+std::string lines(const std::string& prefix, int count)
+{
+    std::string result;
+    for (int i = 0; i < count; i++) {
+        result += prefix + " line " + std::to_string(i) + "\n";
+    }
+    return result;
+}
+
+// Accepts one HTTP PUT and keeps its body, decoding chunked transfer encoding
+class HttpSink {
+public:
+    HttpSink()
+        : mFd(socket(AF_INET, SOCK_STREAM | SOCK_CLOEXEC, 0))
+        , mPort(0)
+        , mChunked(false)
+    {
+        struct sockaddr_in address = {};
+        address.sin_family = AF_INET;
+        address.sin_addr.s_addr = htonl(INADDR_LOOPBACK);
+        socklen_t length = sizeof(address);
+        if ((bind(mFd, (struct sockaddr*)&address, length) == 0) && (listen(mFd, 1) == 0)
+            && (getsockname(mFd, (struct sockaddr*)&address, &length) == 0)) {
+            mPort = ntohs(address.sin_port);
+        }
+        mThread = std::thread(&HttpSink::serve, this);
+    }
+
+    ~HttpSink()
+    {
+        shutdown(mFd, SHUT_RDWR);
+        mThread.join();
+        close(mFd);
+    }
+
+    std::string url() const { return "http://127.0.0.1:" + std::to_string(mPort) + "/logs.tgz"; }
+
+    // Once the upload completed
+    const std::string& body() const { return mBody; }
+    bool chunked() const { return mChunked; }
+
+private:
+    void serve()
+    {
+        int fd = accept(mFd, nullptr, nullptr);
+        if (fd < 0) {
+            return;
+        }
+
+        std::string request;
+        char buffer[4096];
+        ssize_t count;
+        size_t end;
+        while ((end = request.find("\r\n\r\n")) == std::string::npos) {
+            if ((count = recv(fd, buffer, sizeof(buffer), 0)) <= 0) {
+                close(fd);
+                return;
+            }
+            request.append(buffer, count);
+        }
+        std::string headers = request.substr(0, end);
+        std::string data = request.substr(end + 4);
+        mChunked = (headers.find("Transfer-Encoding: chunked") != std::string::npos);
+
+        if (headers.find("Expect: 100-continue") != std::string::npos) {
+            const char* proceed = "HTTP/1.1 100 Continue\r\n\r\n";
+            send(fd, proceed, strlen(proceed), MSG_NOSIGNAL);
+        }
+
+        // Chunks up to the zero length one
+        while (mChunked) {
+            size_t line = data.find("\r\n");
+            if (line != std::string::npos) {
+                size_t size = strtoul(data.c_str(), nullptr, 16);
+                if (data.size() >= line + 2 + size + 2) {
+                    mBody.append(data, line + 2, size);
+                    data.erase(0, line + 2 + size + 2);
+                    if (size == 0) {
+                        break;
+                    }
+                    continue;
+                }
+            }
+            if ((count = recv(fd, buffer, sizeof(buffer), 0)) <= 0) {
+                break;
+            }
+            data.append(buffer, count);
+        }
+
+        const char* response = "HTTP/1.1 200 OK\r\nContent-Length: 0\r\nConnection: close\r\n\r\n";
+        send(fd, response, strlen(response), MSG_NOSIGNAL);
+        close(fd);
+    }
+
+    int mFd;
+    int mPort;
+    bool mChunked;
+    std::string mBody;
+    std::thread mThread;
+};
+
+size_t uploadRead(char* data, size_t size, size_t nitems, void* userdata)
+{
+    Utils::TarGz::Writer* archive = static_cast<Utils::TarGz::Writer*>(userdata);
+    size_t length = archive->read(data, size * nitems);
+    return archive->failed() ? CURL_READFUNC_ABORT : length;
+}
+
+// As uploadlogs does it
+long upload(Utils::TarGz::Writer& archive, const std::string& url)
+{
+    long httpCode = 0;
+    CURL* curl = curl_easy_init();
+    curl_easy_setopt(curl, CURLOPT_READFUNCTION, uploadRead);
+    curl_easy_setopt(curl, CURLOPT_UPLOAD, 1L);
+    curl_easy_setopt(curl, CURLOPT_URL, url.c_str());
+    curl_easy_setopt(curl, CURLOPT_READDATA, (void*)&archive);
+    curl_easy_setopt(curl, CURLOPT_TIMEOUT, 10L);
+    if (curl_easy_perform(curl) == CURLE_OK) {
+        curl_easy_getinfo(curl, CURLINFO_RESPONSE_CODE, &httpCode);
+    }
+    curl_easy_cleanup(curl);
+    return httpCode;
+}
+}
+
+class UtilsTarGzTest : public ::testing::Test {
+protected:
+    std::string dir;
+    std::string logs;
+    std::string extracted;
+
+    virtual void SetUp()
+    {
+        char name[] = "/tmp/tarGzTestXXXXXX";
+        ASSERT_NE(nullptr, mkdtemp(name));
+        dir = name;
+        logs = dir + "/logs";
+        extracted = dir + "/extracted";
+        ASSERT_EQ(0, mkdir(logs.c_str(), 0755));
+        ASSERT_EQ(0, mkdir((logs + "/sub").c_str(), 0755));
+    }
+
+    virtual void TearDown()
+    {
+        system(("rm -rf " + dir).c_str());
+    }
+
+    // The archive read in pieces of the given size
+    std::string archiveOf(Utils::TarGz::Writer& archive, size_t piece)
+    {
+        std::string result;
+        std::vector<char> buffer(piece);
+        size_t length;
+        while ((length = archive.read(buffer.data(), buffer.size())) > 0) {
+            result.append(buffer.data(), length);
+        }
+        return result;
+    }
+
+    // Extracted by tar, so the archive is checked by something else than what made it
+    bool extract(const std::string& archive)
+    {
+        system(("rm -rf " + extracted).c_str());
+        mkdir(extracted.c_str(), 0755);
+        writeFile(dir + "/logs.tgz", archive);
+        return (system(("tar -xzf " + dir + "/logs.tgz -C " + extracted).c_str()) == 0);
+    }
+};
+
+TEST_F(UtilsTarGzTest, ArchiveHoldsTheFiles)
+{
+    std::string longName = "sub/" + std::string(150, 'n') + ".log";
+    std::string big;
+    for (int i = 0; i < 40000; i++) {
+        big += std::to_string(i * 7919 % 10007) + ((i % 13) ? " " : "\n");
+    }
+    writeFile(logs + "/messages.txt", lines("messages", 100));
+    writeFile(logs + "/empty.log", "");
+    writeFile(logs + "/big.log", big);
+    writeFile(logs + "/" + longName, lines("long", 3));
+    writeFile(logs + "/sub/wpeframework.log", lines("wpe", 1000));
+    ASSERT_EQ(0, symlink("messages.txt", (logs + "/link.txt").c_str()));
+
+    Utils::TarGz::Writer archive(4096);
+    ASSERT_TRUE(archive.open(logs + "/"));
+    EXPECT_EQ(5u, archive.files());
+    std::string tgz = archiveOf(archive, 1000);
+    EXPECT_TRUE(archive.finished());
+    EXPECT_FALSE(archive.failed());
+    EXPECT_EQ(tgz.size(), archive.bytesOut());
+    EXPECT_LT(tgz.size(), archive.bytesIn() / 2);
+    EXPECT_EQ(0u, archive.read(&tgz[0], 1));
+
+    ASSERT_TRUE(extract(tgz));
+    EXPECT_EQ(lines("messages", 100), readFile(extracted + "/messages.txt"));
+    EXPECT_TRUE(exists(extracted + "/empty.log"));
+    EXPECT_EQ(big, readFile(extracted + "/big.log"));
+    EXPECT_EQ(lines("long", 3), readFile(extracted + "/" + longName));
+    EXPECT_EQ(lines("wpe", 1000), readFile(extracted + "/sub/wpeframework.log"));
+    EXPECT_FALSE(exists(extracted + "/link.txt"));
+
+    ASSERT_EQ(5u, archive.offsets().size());
+    EXPECT_EQ(big.size(), archive.offsets().at("big.log").size);
+    EXPECT_EQ(0u, archive.offsets().at("empty.log").size);
+}
+
+TEST_F(UtilsTarGzTest, OnlyAppendedBytesAreArchived)
+{
+    writeFile(logs + "/messages.txt", lines("messages", 100));
+    writeFile(logs + "/sub/wpeframework.log", lines("wpe", 100));
+    writeFile(logs + "/quiet.log", lines("quiet", 10));
+
+    Utils::TarGz::Writer first;
+    ASSERT_TRUE(first.open(logs));
+    archiveOf(first, 65536);
+    ASSERT_TRUE(first.finished());
+    ASSERT_TRUE(Utils::TarGz::saveOffsets(dir + "/offsets", first.offsets()));
+
+    // Appended to, rotated, untouched and new
+    writeFile(logs + "/messages.txt", lines("more", 5), true);
+    writeFile(logs + "/sub/wpeframework.log", lines("rotated", 2));
+    writeFile(logs + "/new.log", lines("new", 1));
+
+    Utils::TarGz::Offsets since;
+    ASSERT_TRUE(Utils::TarGz::loadOffsets(dir + "/offsets", since));
+    EXPECT_EQ(3u, since.size());
+    Utils::TarGz::Writer second;
+    ASSERT_TRUE(second.open(logs, &since));
+    EXPECT_EQ(3u, second.files());
+
+    ASSERT_TRUE(extract(archiveOf(second, 333)));
+    EXPECT_EQ(lines("more", 5), readFile(extracted + "/messages.txt"));
+    EXPECT_EQ(lines("rotated", 2), readFile(extracted + "/sub/wpeframework.log"));
+    EXPECT_EQ(lines("new", 1), readFile(extracted + "/new.log"));
+    EXPECT_FALSE(exists(extracted + "/quiet.log"));
+
+    // Untouched files stay known
+    EXPECT_EQ(4u, second.offsets().size());
+    EXPECT_EQ(lines("messages", 100).size() + lines("more", 5).size(), second.offsets().at("messages.txt").size);
+    EXPECT_EQ(since.at("quiet.log").size, second.offsets().at("quiet.log").size);
+
+    // Nothing new: an empty, but valid, archive
+    Utils::TarGz::Writer third;
+    ASSERT_TRUE(third.open(logs, &second.offsets()));
+    EXPECT_EQ(0u, third.files());
+    ASSERT_TRUE(extract(archiveOf(third, 65536)));
+}
+
+TEST_F(UtilsTarGzTest, ReopenedArchiveStartsOver)
+{
+    writeFile(logs + "/messages.txt", lines("messages", 1000));
+
+    // Given up part way, as an upload that was refused
+    Utils::TarGz::Writer archive;
+    ASSERT_TRUE(archive.open(logs));
+    std::vector<char> buffer(100);
+    EXPECT_EQ(buffer.size(), archive.read(buffer.data(), buffer.size()));
+
+    writeFile(logs + "/messages.txt", lines("more", 5), true);
+    ASSERT_TRUE(archive.open(logs));
+    ASSERT_TRUE(extract(archiveOf(archive, 4096)));
+    EXPECT_FALSE(archive.failed());
+    EXPECT_EQ(lines("messages", 1000) + lines("more", 5), readFile(extracted + "/messages.txt"));
+}
+
+TEST_F(UtilsTarGzTest, MissingDirectoryFails)
+{
+    Utils::TarGz::Writer archive;
+    EXPECT_FALSE(archive.open(dir + "/missing"));
+    EXPECT_TRUE(archive.failed());
+    EXPECT_FALSE(archive.error().empty());
+    char data[16];
+    EXPECT_EQ(0u, archive.read(data, sizeof(data)));
+}
+
+TEST_F(UtilsTarGzTest, UploadStreamsTheArchive)
+{
+    std::string big;
+    while (big.size() < 2 * 1024 * 1024) {
+        big += lines("upload " + std::to_string(big.size()), 50);
+    }
+    writeFile(logs + "/messages.txt", big);
+    writeFile(logs + "/sub/wpeframework.log", lines("wpe", 1000));
+
+    HttpSink sink;
+    Utils::TarGz::Writer archive;
+    ASSERT_TRUE(archive.open(logs));
+    EXPECT_EQ(200, upload(archive, sink.url()));
+    EXPECT_TRUE(archive.finished());
+    EXPECT_TRUE(sink.chunked());
+    EXPECT_EQ(archive.bytesOut(), sink.body().size());
+
+    ASSERT_TRUE(extract(sink.body()));
+    EXPECT_EQ(big, readFile(extracted + "/messages.txt"));
+    EXPECT_EQ(lines("wpe", 1000), readFile(extracted + "/sub/wpeframework.log"));
+}
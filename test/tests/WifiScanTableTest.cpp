@@ -0,0 +1,203 @@
+/*
+ * If not stated otherwise in this file or this component's LICENSE file the
+ * following copyright and licenses apply:
+ *
+ * Copyright 2022 RDK Management
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include <gtest/gtest.h>
+
+#include <stdio.h>
+
+#include <chrono>
+
+#include "WifiScanTable.h"
+
+using namespace WPEFramework;
+
+namespace {
+typedef Plugin::WifiScanTable::Clock Clock;
+
+Plugin::WifiNetwork network(int id, double signal, const char* frequency = "2.412000")
+{
+    Plugin::WifiNetwork network;
+    char text[32];
+    snprintf(text, sizeof(text), "00:11:22:33:%02x:%02x", id / 256, id % 256);
+    network.bssid = text;
+    snprintf(text, sizeof(text), "Network-%03d", id);
+    network.ssid = text;
+    network.security = 6;
+    snprintf(text, sizeof(text), "%f", signal);
+    network.signalStrength = text;
+    network.frequency = frequency;
+    return network;
+}
+}
+
+TEST(WifiScanTableTest, MergeReportsAddedAndChanged)
+{
+    Plugin::WifiScanTable table;
+    Plugin::WifiScanTable::Delta delta;
+
+    table.merge({ network(1, -40), network(2, -60) }, delta);
+    EXPECT_EQ(2u, delta.added.size());
+    EXPECT_TRUE(delta.changed.empty());
+
+    // Signal jitter below the hysteresis is not a change, a new security mode is
+    delta = Plugin::WifiScanTable::Delta();
+    Plugin::WifiNetwork secured = network(2, -61);
+    secured.security = 7;
+    table.merge({ network(1, -42), secured }, delta);
+    EXPECT_TRUE(delta.added.empty());
+    ASSERT_EQ(1u, delta.changed.size());
+    EXPECT_EQ("Network-002", delta.changed[0].ssid);
+
+    // Small steps add up to a change
+    delta = Plugin::WifiScanTable::Delta();
+    table.merge({ network(1, -44) }, delta);
+    table.merge({ network(1, -46) }, delta);
+    ASSERT_EQ(1u, delta.changed.size());
+    EXPECT_EQ("-46.000000", delta.changed[0].signalStrength);
+    EXPECT_EQ(2u, table.size());
+}
+
+TEST(WifiScanTableTest, CompletedScanRemovesUnseen)
+{
+    Plugin::WifiScanTable table;
+    Plugin::WifiScanTable::Delta delta;
+
+    table.beginScan();
+    table.merge({ network(1, -40), network(2, -60), network(3, -70) }, delta);
+    table.endScan(delta);
+    EXPECT_TRUE(delta.removed.empty());
+
+    // An incremental scan in three batches that no longer sees network 2
+    delta = Plugin::WifiScanTable::Delta();
+    table.beginScan();
+    table.merge({ network(1, -40) }, delta);
+    table.merge({ network(3, -70) }, delta);
+    table.merge({ network(4, -75, "5.180000") }, delta);
+    EXPECT_TRUE(delta.removed.empty());
+    table.endScan(delta);
+    ASSERT_EQ(1u, delta.removed.size());
+    EXPECT_EQ("Network-002", delta.removed[0].ssid);
+    EXPECT_EQ(1u, delta.added.size());
+
+    // A stopped scan removes nothing
+    delta = Plugin::WifiScanTable::Delta();
+    table.beginScan();
+    table.merge({ network(1, -40) }, delta);
+    table.abortScan();
+    table.endScan(delta);
+    EXPECT_TRUE(delta.empty());
+    EXPECT_EQ(3u, table.size());
+}
+
+TEST(WifiScanTableTest, EntriesAgeOut)
+{
+    Plugin::WifiScanTable table(5.0, std::chrono::seconds(120));
+    Plugin::WifiScanTable::Delta delta;
+    Clock::time_point now = Clock::now();
+
+    table.merge({ network(1, -40) }, delta, now);
+    table.merge({ network(2, -40) }, delta, now + std::chrono::seconds(100));
+    delta = Plugin::WifiScanTable::Delta();
+
+    table.expire(delta, now + std::chrono::seconds(150));
+    ASSERT_EQ(1u, delta.removed.size());
+    EXPECT_EQ("Network-001", delta.removed[0].ssid);
+    EXPECT_EQ(1u, table.size());
+}
+
+TEST(WifiScanTableTest, QueryFiltersAndSorts)
+{
+    Plugin::WifiScanTable table;
+    Plugin::WifiScanTable::Delta delta;
+    table.merge({ network(1, -70), network(2, -40, "5.180000"), network(3, -55), network(10, -80) }, delta);
+
+    Plugin::WifiScanFilter all;
+    std::vector<Plugin::WifiNetwork> networks;
+    ASSERT_EQ(4u, table.query(all, networks));
+    EXPECT_EQ("Network-002", networks[0].ssid);
+    EXPECT_EQ("Network-003", networks[1].ssid);
+    EXPECT_EQ("Network-010", networks[3].ssid);
+
+    Plugin::WifiScanFilter filter;
+    EXPECT_TRUE(filter.setSsid("Network-00[0-9]"));
+    filter.setFrequency("2.412000");
+    filter.setMinSignal(-75);
+    ASSERT_EQ(2u, table.query(filter, networks));
+    EXPECT_EQ("Network-003", networks[0].ssid);
+    EXPECT_EQ("Network-001", networks[1].ssid);
+
+    // The whole SSID has to match
+    Plugin::WifiScanFilter partial;
+    EXPECT_TRUE(partial.setSsid("Network"));
+    EXPECT_EQ(0u, table.query(partial, networks));
+
+    Plugin::WifiScanFilter invalid;
+    EXPECT_FALSE(invalid.setSsid("Network-(["));
+    EXPECT_EQ(0u, table.query(invalid, networks));
+}
+
+TEST(WifiScanTableTest, benchmark200NetworkBursts)
+{
+    const int kNetworks = 200;
+    const int kScans = 100;
+
+    Plugin::WifiScanTable table;
+    Plugin::WifiScanFilter filter;
+    filter.setSsid("Network-1[0-9]*");
+    size_t added = 0, changed = 0, removed = 0;
+
+    auto start = std::chrono::steady_clock::now();
+    for (int scan = 0; scan < kScans; scan++) {
+        // Incremental scans: three bursts, the signal jittering by a couple of dB, and a network
+        // appearing or disappearing now and then
+        table.beginScan();
+        Plugin::WifiScanTable::Delta delta;
+        for (int burst = 0; burst < 3; burst++) {
+            std::vector<Plugin::WifiNetwork> batch;
+            for (int id = burst; id < kNetworks; id += 3) {
+                if ((id == scan % kNetworks) && (scan % 2))
+                    continue;
+                batch.push_back(network(id, -30 - (id % 60) - ((scan + id) % 3)));
+            }
+            table.merge(batch, delta);
+        }
+        table.endScan(delta);
+        added += delta.added.size();
+        changed += delta.changed.size();
+        removed += delta.removed.size();
+    }
+    auto merged = std::chrono::steady_clock::now();
+
+    const int kQueries = 1000;
+    std::vector<Plugin::WifiNetwork> networks;
+    for (int query = 0; query < kQueries; query++) {
+        table.query(filter, networks);
+    }
+    auto queried = std::chrono::steady_clock::now();
+
+    // Every odd scan misses a network that the next scan sees again, but for the last one
+    EXPECT_EQ(static_cast<size_t>(kNetworks - 1), table.size());
+    EXPECT_EQ(static_cast<size_t>(kScans / 2), removed);
+    EXPECT_EQ(static_cast<size_t>(kNetworks + kScans / 2 - 1), added);
+    EXPECT_EQ(0u, changed);
+    EXPECT_EQ(100u, networks.size());
+
+    RecordProperty("scanUs", static_cast<int>(std::chrono::duration_cast<std::chrono::microseconds>(merged - start).count() / kScans));
+    RecordProperty("queryUs", static_cast<int>(std::chrono::duration_cast<std::chrono::microseconds>(queried - merged).count() / kQueries));
+}